@@ -456,6 +456,17 @@
 #define CH_CFG_USE_PIPES                    TRUE
 #endif
 
+/**
+ * @brief   Message queues APIs.
+ * @details If enabled then the message queues APIs are included
+ *          in the kernel.
+ *
+ * @note    The default is @p TRUE.
+ */
+#if !defined(CH_CFG_USE_MSG_QUEUES)
+#define CH_CFG_USE_MSG_QUEUES               TRUE
+#endif
+
 /**
  * @brief   Objects Caches APIs.
  * @details If enabled then the objects caches APIs are included
@@ -717,7 +728,8 @@
  */
 #define CH_CFG_THREAD_EXTRA_FIELDS                                          \
   /* Add threads custom fields here.*/                                      \
-  void *osal_delete_handler;
+  void *osal_delete_handler;                                                \
+  struct osal_name *osal_name;
 
 /**
  * @brief   Threads initialization hook.
@@ -730,6 +742,7 @@
  */
 #define CH_CFG_THREAD_INIT_HOOK(tp) {                                       \
   /* Add threads initialization code here.*/                                \
+  (tp)->osal_name = NULL;                                                   \
 }
 
 /**
@@ -73,6 +73,27 @@
 #define SB_CFG_FD_NUM                       12
 #endif
 
+/**
+ * @brief   Enables the Posix submission/completion ring.
+ */
+#if !defined(SB_CFG_ENABLE_POSIX_RING) || defined(__DOXYGEN__)
+#define SB_CFG_ENABLE_POSIX_RING            TRUE
+#endif
+
+/**
+ * @brief   Enables batched VRQs delivery.
+ */
+#if !defined(SB_CFG_ENABLE_VRQ_BATCHING) || defined(__DOXYGEN__)
+#define SB_CFG_ENABLE_VRQ_BATCHING          TRUE
+#endif
+
+/**
+ * @brief   Enables VRQs statistics.
+ */
+#if !defined(SB_CFG_ENABLE_VRQ_STATS) || defined(__DOXYGEN__)
+#define SB_CFG_ENABLE_VRQ_STATS             TRUE
+#endif
+
 #endif  /* SBCONF_H */
 
 /** @} */
@@ -73,6 +73,27 @@
 #define SB_CFG_FD_NUM                       12
 #endif
 
+/**
+ * @brief   Enables the Posix submission/completion ring.
+ */
+#if !defined(SB_CFG_ENABLE_POSIX_RING) || defined(__DOXYGEN__)
+#define SB_CFG_ENABLE_POSIX_RING            FALSE
+#endif
+
+/**
+ * @brief   Enables batched VRQs delivery.
+ */
+#if !defined(SB_CFG_ENABLE_VRQ_BATCHING) || defined(__DOXYGEN__)
+#define SB_CFG_ENABLE_VRQ_BATCHING          FALSE
+#endif
+
+/**
+ * @brief   Enables VRQs statistics.
+ */
+#if !defined(SB_CFG_ENABLE_VRQ_STATS) || defined(__DOXYGEN__)
+#define SB_CFG_ENABLE_VRQ_STATS             FALSE
+#endif
+
 #endif  /* SBCONF_H */
 
 /** @} */
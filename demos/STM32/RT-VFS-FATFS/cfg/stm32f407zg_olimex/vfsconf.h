@@ -56,6 +56,34 @@
 #define VFS_CFG_PATHBUFS_NUM                1
 #endif
 
+/**
+ * @brief   Number of buffered file nodes.
+ * @details Buffered file nodes are returned by @p vfsOpenFileBuffered()
+ *          and used by the sandbox Posix layer for regular files, zero
+ *          disables the feature.
+ */
+#if !defined(VFS_CFG_FILEBUFS_NUM) || defined(__DOXYGEN__)
+#define VFS_CFG_FILEBUFS_NUM                0
+#endif
+
+/**
+ * @brief   Size of the buffer of buffered file nodes.
+ */
+#if !defined(VFS_CFG_FILEBUF_SIZE) || defined(__DOXYGEN__)
+#define VFS_CFG_FILEBUF_SIZE                512
+#endif
+
+/**
+ * @brief   Maximum size of gathered scatter-gather segments.
+ * @details Runs of adjacent small segments passed to the default
+ *          implementations of @p vfsFileReadV() and @p vfsFileWriteV()
+ *          are transferred through a stack buffer of this size with a
+ *          single call to the driver, zero disables the feature.
+ */
+#if !defined(VFS_CFG_IOV_GATHER_SIZE) || defined(__DOXYGEN__)
+#define VFS_CFG_IOV_GATHER_SIZE             64
+#endif
+
 /** @} */
 
 /*===========================================================================*/
@@ -109,6 +137,14 @@
 #define DRV_CFG_OVERLAY_DIR_NODES_NUM       1
 #endif
 
+/**
+ * @brief   Number of entries of the path-resolution cache.
+ * @note    It must be a power of two.
+ */
+#if !defined(DRV_CFG_OVERLAY_CACHE_SIZE) || defined(__DOXYGEN__)
+#define DRV_CFG_OVERLAY_CACHE_SIZE          8
+#endif
+
 /** @} */
 
 /*===========================================================================*/
@@ -132,6 +168,15 @@
 #define DRV_CFG_STREAMS_FILE_NODES_NUM      2
 #endif
 
+/**
+ * @brief   Size of the stack buffer used for vectored transfers.
+ * @note    Scatter-gather transfers not exceeding this size are performed
+ *          with a single stream call, zero disables the feature.
+ */
+#if !defined(DRV_CFG_STREAMS_IOV_BUFFER_SIZE) || defined(__DOXYGEN__)
+#define DRV_CFG_STREAMS_IOV_BUFFER_SIZE     256
+#endif
+
 /** @} */
 
 /*===========================================================================*/
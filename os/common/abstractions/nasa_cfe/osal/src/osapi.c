@@ -66,6 +66,10 @@
 #error "NASA OSAL requires CH_CFG_USE_HEAP"
 #endif
 
+#if CH_CFG_USE_MSG_QUEUES == FALSE
+#error "NASA OSAL requires CH_CFG_USE_MSG_QUEUES"
+#endif
+
 /*===========================================================================*/
 /* Module local definitions.                                                 */
 /*===========================================================================*/
@@ -79,6 +83,38 @@
 #define MIN_QUEUE_DEPTH     1
 #define MAX_QUEUE_DEPTH     16384
 
+/**
+ * @brief   Size of the objects names hash table.
+ * @note    It must be a power of two, it can be overridden in osconfig.h.
+ */
+#if !defined(OSAL_NAMES_HASH_SIZE) || defined(__DOXYGEN__)
+#define OSAL_NAMES_HASH_SIZE        64
+#endif
+
+#if (OSAL_NAMES_HASH_SIZE & (OSAL_NAMES_HASH_SIZE - 1)) != 0
+#error "OSAL_NAMES_HASH_SIZE is not a power of two"
+#endif
+
+/**
+ * @brief   Total number of named objects.
+ */
+#define OSAL_MAX_NAMES      (OS_MAX_TASKS + OS_MAX_QUEUES +                 \
+                             OS_MAX_BIN_SEMAPHORES +                        \
+                             OS_MAX_COUNT_SEMAPHORES + OS_MAX_MUTEXES +     \
+                             OS_MAX_TIMERS)
+
+/**
+ * @name    Named object classes
+ * @{
+ */
+#define NAME_TYPE_TASK      1U
+#define NAME_TYPE_QUEUE     2U
+#define NAME_TYPE_BINSEM    3U
+#define NAME_TYPE_COUNTSEM  4U
+#define NAME_TYPE_MUTEX     5U
+#define NAME_TYPE_TIMER     6U
+/** @} */
+
 /*===========================================================================*/
 /* Module exported variables.                                                */
 /*===========================================================================*/
@@ -92,12 +128,32 @@
  */
 typedef void (*funcptr_t)(void);
 
+/**
+ * @brief   Type of an object name entry.
+ */
+typedef struct osal_name osal_name_t;
+
+/**
+ * @brief   Structure of an object name entry.
+ * @details Entries are linked in the names hash table, the lookup key is
+ *          the pair object class and name. An entry with a zero id is
+ *          reserved by an object under creation.
+ */
+struct osal_name {
+  osal_name_t           *next;
+  uint32                hash;
+  uint32                type;
+  uint32                id;
+  char                  name[OS_MAX_API_NAME];
+};
+
 /**
  * @brief   Type of OSAL timer.
  */
 typedef struct {
   uint32                is_free;
   char                  name[OS_MAX_API_NAME];
+  osal_name_t           *np;
   OS_TimerCallback_t    callback_ptr;
   uint32                start_time;
   uint32                interval_time;
@@ -110,23 +166,13 @@ typedef struct {
 typedef struct {
   uint32                is_free;
   char                  name[OS_MAX_API_NAME];
-  semaphore_t           free_msgs;
-  memory_pool_t         messages;
-  mailbox_t             mb;
-  msg_t                 *mb_buffer;
-  void                  *q_buffer;
+  osal_name_t           *np;
+  msg_queue_t           mq;
+  void                  *mq_buffer;
   uint32                depth;
   uint32                size;
 } osal_queue_t;
 
-/**
- * @brief   Type of an osal message with minimum size.
- */
-typedef struct {
-  size_t                size;
-  char                  buf[4];
-} osal_message_t;
-
 /**
  * @brief   Type of OSAL main structure.
  */
@@ -140,11 +186,17 @@ typedef struct {
   memory_pool_t         binary_semaphores_pool;
   memory_pool_t         count_semaphores_pool;
   memory_pool_t         mutexes_pool;
+  memory_pool_t         names_pool;
   osal_timer_t          timers[OS_MAX_TIMERS];
   osal_queue_t          queues[OS_MAX_QUEUES];
   binary_semaphore_t    binary_semaphores[OS_MAX_BIN_SEMAPHORES];
   semaphore_t           count_semaphores[OS_MAX_COUNT_SEMAPHORES];
   mutex_t               mutexes[OS_MAX_MUTEXES];
+  osal_name_t           *binary_semaphores_names[OS_MAX_BIN_SEMAPHORES];
+  osal_name_t           *count_semaphores_names[OS_MAX_COUNT_SEMAPHORES];
+  osal_name_t           *mutexes_names[OS_MAX_MUTEXES];
+  osal_name_t           *names_hash[OSAL_NAMES_HASH_SIZE];
+  osal_name_t           names[OSAL_MAX_NAMES];
 } osal_t;
 
 /*===========================================================================*/
@@ -195,53 +247,153 @@ static void timer_handler(virtual_timer_t *vtp, void *p) {
 }
 
 /**
- * @brief   Finds a queue by name.
+ * @brief   Computes the hash of an object name.
+ * @note    FNV-1a over the significant characters of the name.
  */
-uint32 queue_find(const char *queue_name) {
-  osal_queue_t *oqp;
+static uint32 name_hash(const char *name) {
+  uint32 h = 2166136261U;
+  unsigned i;
+
+  for (i = 0; (i < OS_MAX_API_NAME - 1) && (name[i] != '\0'); i++) {
+    h = (h ^ (uint32)(uint8)name[i]) * 16777619U;
+  }
+
+  return h;
+}
 
-  /* Searching the queue in the table.*/
-  for (oqp = &osal.queues[0]; oqp < &osal.queues[OS_MAX_QUEUES]; oqp++) {
-    /* Entering a reentrant critical zone.*/
-    syssts_t sts = chSysGetStatusAndLockX();
+/**
+ * @brief   Searches a name entry.
+ * @note    Must be called from within a critical zone.
+ *
+ * @return                      The entry or @p NULL if not found.
+ */
+static osal_name_t *name_lookup(uint32 type, uint32 hash, const char *name) {
+  osal_name_t *np = osal.names_hash[hash & (OSAL_NAMES_HASH_SIZE - 1)];
 
-    if (!oqp->is_free &&
-        (strncmp(oqp->name, queue_name, OS_MAX_API_NAME - 1) == 0)) {
-      /* Leaving the critical zone.*/
-      chSysRestoreStatusX(sts);
-      return (uint32)oqp;
+  while (np != NULL) {
+    if ((np->hash == hash) && (np->type == type) &&
+        (strncmp(np->name, name, OS_MAX_API_NAME - 1) == 0)) {
+      return np;
     }
+    np = np->next;
+  }
 
-    /* Leaving the critical zone.*/
-    chSysRestoreStatusX(sts);
+  return NULL;
+}
+
+/**
+ * @brief   Reserves a name for an object under creation.
+ * @details The name check and the reservation are atomic, the object id
+ *          is set later using @p name_bind().
+ *
+ * @param[out] npp              pointer to the reserved entry
+ * @param[in] type              object class
+ * @param[in] name              object name
+ * @return                      An error code.
+ */
+static int32 name_reserve(osal_name_t **npp, uint32 type, const char *name) {
+  uint32 hash = name_hash(name);
+  osal_name_t *np;
+
+  chSysLock();
+
+  /* Checking if the name is already taken.*/
+  if (name_lookup(type, hash, name) != NULL) {
+    chSysUnlock();
+    return OS_ERR_NAME_TAKEN;
   }
 
-  return 0;
+  /* Getting an entry.*/
+  np = chPoolAllocI(&osal.names_pool);
+  if (np == NULL) {
+    chSysUnlock();
+    return OS_ERR_NO_FREE_IDS;
+  }
+
+  np->hash = hash;
+  np->type = type;
+  np->id   = 0;
+  strncpy(np->name, name, OS_MAX_API_NAME - 1);
+  np->name[OS_MAX_API_NAME - 1] = '\0';
+  np->next = osal.names_hash[hash & (OSAL_NAMES_HASH_SIZE - 1)];
+  osal.names_hash[hash & (OSAL_NAMES_HASH_SIZE - 1)] = np;
+
+  chSysUnlock();
+
+  *npp = np;
+
+  return OS_SUCCESS;
 }
 
 /**
- * @brief   Finds a timer by name.
+ * @brief   Associates an object id to a reserved name.
  */
-uint32 timer_find(const char *timer_name) {
-  osal_timer_t *otp;
+static void name_bind(osal_name_t *np, uint32 id) {
 
-  /* Searching the queue in the table.*/
-  for (otp = &osal.timers[0]; otp < &osal.timers[OS_MAX_TIMERS]; otp++) {
-    /* Entering a reentrant critical zone.*/
-    syssts_t sts = chSysGetStatusAndLockX();
+  chSysLock();
+  np->id = id;
+  chSysUnlock();
+}
 
-    if (!otp->is_free &&
-        (strncmp(otp->name, timer_name, OS_MAX_API_NAME - 1) == 0)) {
-      /* Leaving the critical zone.*/
-      chSysRestoreStatusX(sts);
-      return (uint32)otp;
+/**
+ * @brief   Removes a name entry.
+ * @note    Must be called from within a critical zone.
+ */
+static void name_remove(osal_name_t *np) {
+  osal_name_t **npp = &osal.names_hash[np->hash & (OSAL_NAMES_HASH_SIZE - 1)];
+
+  while (*npp != NULL) {
+    if (*npp == np) {
+      *npp = np->next;
+      chPoolFreeI(&osal.names_pool, (void *)np);
+      return;
     }
-
-    /* Leaving the critical zone.*/
-    chSysRestoreStatusX(sts);
+    npp = &(*npp)->next;
   }
+}
+
+/**
+ * @brief   Releases a reserved name after a failed object creation.
+ */
+static void name_release(osal_name_t *np) {
+
+  chSysLock();
+  name_remove(np);
+  chSysUnlock();
+}
+
+/**
+ * @brief   Finds an object by name.
+ *
+ * @return                      The object id or zero if not found.
+ */
+static uint32 name_find(uint32 type, const char *name) {
+  uint32 hash = name_hash(name);
+  osal_name_t *np;
+  uint32 id;
+
+  /* Entering a reentrant critical zone.*/
+  syssts_t sts = chSysGetStatusAndLockX();
 
-  return 0;
+  np = name_lookup(type, hash, name);
+  id = np != NULL ? np->id : 0;
+
+  /* Leaving the critical zone.*/
+  chSysRestoreStatusX(sts);
+
+  return id;
+}
+
+/**
+ * @brief   Tasks entry point.
+ * @details The task function is invoked then @p OS_TaskExit() is called,
+ *          this way the name entry of the task is removed on all the
+ *          possible termination paths.
+ */
+static void task_entry(void *p) {
+
+  ((osal_task_entry)(funcptr_t)p)();
+  OS_TaskExit();
 }
 
 /*===========================================================================*/
@@ -314,6 +466,15 @@ int32 OS_API_Init(void) {
                   &osal.mutexes[0],
                   OS_MAX_MUTEXES);
 
+  /* Names index initialization.*/
+  memset(osal.names_hash, 0, sizeof osal.names_hash);
+  chPoolObjectInit(&osal.names_pool,
+                   sizeof (osal_name_t),
+                   NULL);
+  chPoolLoadArray(&osal.names_pool,
+                  &osal.names[0],
+                  OSAL_MAX_NAMES);
+
   return OS_SUCCESS;
 }
 
@@ -452,6 +613,8 @@ int32 OS_Milli2Ticks(uint32 milli_seconds) {
 int32 OS_TimerCreate(uint32 *timer_id, const char *timer_name,
                      uint32 *clock_accuracy, OS_TimerCallback_t callback_ptr) {
   osal_timer_t *otp;
+  osal_name_t *np;
+  int32 err;
 
   /* NULL pointer checks.*/
   if ((timer_id == NULL) || (timer_name == NULL) ||
@@ -471,25 +634,29 @@ int32 OS_TimerCreate(uint32 *timer_id, const char *timer_name,
     return OS_ERR_NAME_TOO_LONG;
   }
 
-  /* Checking if the name is already taken.*/
-  if (timer_find(timer_name) > 0) {
+  /* Reserving the name, it fails if the name is already taken.*/
+  err = name_reserve(&np, NAME_TYPE_TIMER, timer_name);
+  if (err != OS_SUCCESS) {
     *timer_id = 0;
-    return OS_ERR_NAME_TAKEN;
+    return err;
   }
 
   /* Getting object.*/
   otp = chPoolAlloc(&osal.timers_pool);
   if (otp == NULL) {
+    name_release(np);
     *timer_id = 0;
     return OS_ERR_NO_FREE_IDS;
   }
 
   strncpy(otp->name, timer_name, OS_MAX_API_NAME - 1);
+  otp->np            = np;
   chVTObjectInit(&otp->vt);
   otp->start_time    = 0;
   otp->interval_time = 0;
   otp->callback_ptr  = callback_ptr;
   otp->is_free       = 0;   /* Note, last.*/
+  name_bind(np, (uint32)otp);
 
   *timer_id = (uint32)otp;
   *clock_accuracy = (uint32)(1000000 / CH_CFG_ST_FREQUENCY);
@@ -520,6 +687,9 @@ int32 OS_TimerDelete(uint32 timer_id) {
   /* Marking as no more free, will be overwritten by the pool pointer.*/
   otp->is_free = 1;
 
+  /* Removing the name from the index.*/
+  name_remove(otp->np);
+
   /* Resetting the timer.*/
   chVTResetI(&otp->vt);
   otp->start_time    = 0;
@@ -594,8 +764,8 @@ int32 OS_TimerGetIdByName(uint32 *timer_id, const char *timer_name) {
     return OS_ERR_NAME_TOO_LONG;
   }
 
-  /* Searching the queue.*/
-  *timer_id = timer_find(timer_name);
+  /* Searching the timer.*/
+  *timer_id = name_find(NAME_TYPE_TIMER, timer_name);
   if (*timer_id > 0) {
     return OS_SUCCESS;
   }
@@ -668,7 +838,8 @@ int32 OS_TimerGetInfo(uint32 timer_id, OS_timer_prop_t *timer_prop) {
 int32 OS_QueueCreate(uint32 *queue_id, const char *queue_name,
                      uint32 queue_depth, uint32 data_size, uint32 flags) {
   osal_queue_t *oqp;
-  size_t msgsize;
+  osal_name_t *np;
+  int32 err;
 
   (void)flags;
 
@@ -683,15 +854,17 @@ int32 OS_QueueCreate(uint32 *queue_id, const char *queue_name,
     return OS_ERR_NAME_TOO_LONG;
   }
 
-  /* Checking if the name is already taken.*/
-  if (queue_find(queue_name) > 0) {
+  /* Reserving the name, it fails if the name is already taken.*/
+  err = name_reserve(&np, NAME_TYPE_QUEUE, queue_name);
+  if (err != OS_SUCCESS) {
     *queue_id = 0;
-    return OS_ERR_NAME_TAKEN;
+    return err;
   }
 
   /* Checks on queue limits. There is no dedicated error code.*/
   if ((data_size < MIN_MESSAGE_SIZE) || (data_size > MAX_MESSAGE_SIZE) ||
       (queue_depth < MIN_QUEUE_DEPTH) || (queue_depth > MAX_QUEUE_DEPTH)) {
+    name_release(np);
     *queue_id = 0;
     return OS_ERROR;
   }
@@ -699,39 +872,31 @@ int32 OS_QueueCreate(uint32 *queue_id, const char *queue_name,
   /* Getting object.*/
   oqp = chPoolAlloc(&osal.queues_pool);
   if (oqp == NULL) {
+    name_release(np);
     *queue_id = 0;
     return OS_ERR_NO_FREE_IDS;
   }
 
   /* Attempting messages buffer allocation.*/
-  msgsize = MEM_ALIGN_NEXT(data_size + sizeof (size_t), PORT_NATURAL_ALIGN);
-  oqp->mb_buffer = chHeapAllocAligned(NULL,
-                                      msgsize * (size_t)queue_depth,
+  oqp->mq_buffer = chHeapAllocAligned(NULL,
+                                      CH_MQ_BUFFER_SIZE(data_size, queue_depth),
                                       PORT_NATURAL_ALIGN);
-  if (oqp->mb_buffer == NULL) {
-    *queue_id = 0;
-    return OS_ERROR;
-  }
-
-  /* Attempting queue buffer allocation.*/
-  oqp->q_buffer = chHeapAllocAligned(NULL,
-                                     sizeof (msg_t) * (size_t)queue_depth,
-                                     PORT_NATURAL_ALIGN);
-  if (oqp->q_buffer == NULL) {
+  if (oqp->mq_buffer == NULL) {
     *queue_id = 0;
-    chHeapFree(oqp->mb_buffer);
+    chPoolFree(&osal.queues_pool, (void *)oqp);
+    name_release(np);
     return OS_ERROR;
   }
 
   /* Initializing object static parts.*/
   strncpy(oqp->name, queue_name, OS_MAX_API_NAME - 1);
-  chMBObjectInit(&oqp->mb, oqp->q_buffer, (size_t)queue_depth);
-  chSemObjectInit(&oqp->free_msgs, (cnt_t)queue_depth);
-  chPoolObjectInit(&oqp->messages, msgsize, NULL);
-  chPoolLoadArray(&oqp->messages, oqp->mb_buffer, (size_t)queue_depth);
+  oqp->np      = np;
+  chMQObjectInit(&oqp->mq, oqp->mq_buffer,
+                 (size_t)data_size, (size_t)queue_depth);
   oqp->depth   = queue_depth;
   oqp->size    = data_size;
   oqp->is_free = 0;   /* Note, last.*/
+  name_bind(np, (uint32)oqp);
   *queue_id = (uint32)oqp;
 
   return OS_SUCCESS;
@@ -747,7 +912,7 @@ int32 OS_QueueCreate(uint32 *queue_id, const char *queue_name,
  */
 int32 OS_QueueDelete(uint32 queue_id) {
   osal_queue_t *oqp = (osal_queue_t *)queue_id;
-  void *q_buffer, *mb_buffer;
+  void *mq_buffer;
 
   /* Range check.*/
   if ((oqp < &osal.queues[0]) ||
@@ -762,13 +927,14 @@ int32 OS_QueueDelete(uint32 queue_id) {
   /* Marking as no more free, will be overwritten by the pool pointer.*/
   oqp->is_free = 1;
 
-  /* Pointers to areas to be freed.*/
-  q_buffer  = oqp->q_buffer;
-  mb_buffer = oqp->mb_buffer;
+  /* Removing the name from the index.*/
+  name_remove(oqp->np);
+
+  /* Pointer to the area to be freed.*/
+  mq_buffer = oqp->mq_buffer;
 
   /* Resetting the queue.*/
-  chMBResetI(&oqp->mb);
-  chSemResetI(&oqp->free_msgs, 0);
+  chMQResetI(&oqp->mq);
 
   /* Flagging it as unused and returning it to the pool.*/
   chPoolFreeI(&osal.queues_pool, (void *)oqp);
@@ -778,9 +944,8 @@ int32 OS_QueueDelete(uint32 queue_id) {
   /* Leaving critical zone.*/
   chSysUnlock();
 
-  /* Freeing buffers, outside critical zone, slow heap operation.*/
-  chHeapFree(q_buffer);
-  chHeapFree(mb_buffer);
+  /* Freeing buffer, outside critical zone, slow heap operation.*/
+  chHeapFree(mq_buffer);
 
   return OS_SUCCESS;
 }
@@ -801,8 +966,8 @@ int32 OS_QueueDelete(uint32 queue_id) {
 int32 OS_QueueGet(uint32 queue_id, void *data, uint32 size,
                   uint32 *size_copied, int32 timeout) {
   osal_queue_t *oqp = (osal_queue_t *)queue_id;
-  msg_t msg, msgsts;
-  void *body;
+  msg_t msgsts;
+  size_t n;
 
   /* NULL pointer checks.*/
   if ((data == NULL) || (size_copied == NULL)) {
@@ -821,39 +986,30 @@ int32 OS_QueueGet(uint32 queue_id, void *data, uint32 size,
     return OS_QUEUE_INVALID_SIZE;
   }
 
-  /* Special time handling.*/
+  /* Special time handling, the message is copied directly into the
+     caller buffer.*/
   if (timeout == OS_PEND) {
-    msgsts = chMBFetchTimeout(&oqp->mb, &msg, TIME_INFINITE);
+    msgsts = chMQFetchTimeout(&oqp->mq, data, &n, TIME_INFINITE);
     if (msgsts < MSG_OK) {
       *size_copied = 0;
       return OS_ERROR;
     }
   }
   else if (timeout == OS_CHECK) {
-    msgsts = chMBFetchTimeout(&oqp->mb, &msg, TIME_IMMEDIATE);
+    msgsts = chMQFetchTimeout(&oqp->mq, data, &n, TIME_IMMEDIATE);
     if (msgsts < MSG_OK) {
       *size_copied = 0;
       return OS_QUEUE_EMPTY;
     }
   }
   else {
-    msgsts = chMBFetchTimeout(&oqp->mb, &msg, (sysinterval_t)timeout);
+    msgsts = chMQFetchTimeout(&oqp->mq, data, &n, (sysinterval_t)timeout);
     if (msgsts < MSG_OK) {
       *size_copied = 0;
       return OS_QUEUE_TIMEOUT;
     }
   }
-
-  /* Message body and size.*/
-  *size_copied = ((osal_message_t *)msg)->size;
-  body  = (void *)((osal_message_t *)msg)->buf;
-
-  /* Copying the message body.*/
-  memcpy(data, body, *size_copied);
-
-  /* Freeing the message buffer.*/
-  chPoolFree(&oqp->messages, (void *)msg);
-  chSemSignal(&oqp->free_msgs);
+  *size_copied = (uint32)n;
 
   return OS_SUCCESS;
 }
@@ -872,7 +1028,6 @@ int32 OS_QueueGet(uint32 queue_id, void *data, uint32 size,
 int32 OS_QueuePut(uint32 queue_id, void *data, uint32 size, uint32 flags) {
   osal_queue_t *oqp = (osal_queue_t *)queue_id;
   msg_t msgsts;
-  osal_message_t *omsg;
 
   (void)flags;
 
@@ -893,19 +1048,9 @@ int32 OS_QueuePut(uint32 queue_id, void *data, uint32 size, uint32 flags) {
     return OS_QUEUE_INVALID_SIZE;
   }
 
-  /* Getting a message buffer from the pool.*/
-  msgsts = chSemWait(&oqp->free_msgs);
-  if (msgsts < MSG_OK) {
-    return OS_ERROR;
-  }
-  omsg = chPoolAlloc(&oqp->messages);
-
-  /* Filling message size and data.*/
-  omsg->size = (size_t)size;
-  memcpy(omsg->buf, data, size);
-
-  /* Posting the message.*/
-  msgsts = chMBPostTimeout(&oqp->mb, (msg_t)omsg, TIME_INFINITE);
+  /* Posting the message, it is copied into the queue or directly into the
+     buffer of a waiting reader.*/
+  msgsts = chMQPostTimeout(&oqp->mq, data, (size_t)size, TIME_INFINITE);
   if (msgsts < MSG_OK) {
     return OS_ERROR;
   }
@@ -935,7 +1080,7 @@ int32 OS_QueueGetIdByName(uint32 *queue_id, const char *queue_name) {
   }
 
   /* Searching the queue.*/
-  *queue_id = queue_find(queue_name);
+  *queue_id = name_find(NAME_TYPE_QUEUE, queue_name);
   if (*queue_id > 0) {
     return OS_SUCCESS;
   }
@@ -1006,6 +1151,8 @@ int32 OS_QueueGetInfo (uint32 queue_id, OS_queue_prop_t *queue_prop) {
 int32 OS_BinSemCreate(uint32 *sem_id, const char *sem_name,
                       uint32 sem_initial_value, uint32 options) {
   binary_semaphore_t *bsp;
+  osal_name_t *np;
+  int32 err;
 
   (void)options;
 
@@ -1024,14 +1171,23 @@ int32 OS_BinSemCreate(uint32 *sem_id, const char *sem_name,
     return OS_INVALID_INT_NUM;
   }
 
+  /* Reserving the name, it fails if the name is already taken.*/
+  err = name_reserve(&np, NAME_TYPE_BINSEM, sem_name);
+  if (err != OS_SUCCESS) {
+    return err;
+  }
+
   /* Getting object.*/
   bsp = chPoolAlloc(&osal.binary_semaphores_pool);
   if (bsp == NULL) {
+    name_release(np);
     return OS_ERR_NO_FREE_IDS;
   }
 
   /* Semaphore is initialized.*/
   chBSemObjectInit(bsp, sem_initial_value == 0 ? true : false);
+  osal.binary_semaphores_names[bsp - &osal.binary_semaphores[0]] = np;
+  name_bind(np, (uint32)bsp);
 
   *sem_id = (uint32)bsp;
 
@@ -1048,6 +1204,7 @@ int32 OS_BinSemCreate(uint32 *sem_id, const char *sem_name,
  */
 int32 OS_BinSemDelete(uint32 sem_id) {
   binary_semaphore_t *bsp = (binary_semaphore_t *)sem_id;
+  osal_name_t *np;
 
   /* Range check.*/
   if ((bsp < &osal.binary_semaphores[0]) ||
@@ -1060,6 +1217,13 @@ int32 OS_BinSemDelete(uint32 sem_id) {
   /* Resetting the semaphore, no threads in queue.*/
   chBSemResetI(bsp, true);
 
+  /* Removing the name from the index.*/
+  np = osal.binary_semaphores_names[bsp - &osal.binary_semaphores[0]];
+  if (np != NULL) {
+    osal.binary_semaphores_names[bsp - &osal.binary_semaphores[0]] = NULL;
+    name_remove(np);
+  }
+
   /* Flagging it as unused and returning it to the pool.*/
   bsp->sem.queue.prev = NULL;
   chPoolFreeI(&osal.binary_semaphores_pool, (void *)bsp);
@@ -1223,7 +1387,6 @@ int32 OS_BinSemTimedWait(uint32 sem_id, uint32 msecs) {
 
 /**
  * @brief   Retrieves a binary semaphore id by name.
- * @note    It is not currently implemented.
  *
  * @param[out] sem_id           pointer to a binary semaphore id variable
  * @param[in] sem_name          the binary semaphore name
@@ -1243,7 +1406,13 @@ int32 OS_BinSemGetIdByName(uint32 *sem_id, const char *sem_name) {
     return OS_ERR_NAME_TOO_LONG;
   }
 
-  return OS_ERR_NOT_IMPLEMENTED;
+  /* Searching the semaphore.*/
+  *sem_id = name_find(NAME_TYPE_BINSEM, sem_name);
+  if (*sem_id > 0) {
+    return OS_SUCCESS;
+  }
+
+  return OS_ERR_NAME_NOT_FOUND;
 }
 
 /**
@@ -1304,6 +1473,8 @@ int32 OS_BinSemGetInfo(uint32 sem_id, OS_bin_sem_prop_t *bin_prop) {
 int32 OS_CountSemCreate(uint32 *sem_id, const char *sem_name,
                         uint32 sem_initial_value, uint32 options) {
   semaphore_t *sp;
+  osal_name_t *np;
+  int32 err;
 
   (void)options;
 
@@ -1322,14 +1493,23 @@ int32 OS_CountSemCreate(uint32 *sem_id, const char *sem_name,
     return OS_INVALID_INT_NUM;
   }
 
+  /* Reserving the name, it fails if the name is already taken.*/
+  err = name_reserve(&np, NAME_TYPE_COUNTSEM, sem_name);
+  if (err != OS_SUCCESS) {
+    return err;
+  }
+
   /* Getting object.*/
   sp = chPoolAlloc(&osal.count_semaphores_pool);
   if (sp == NULL) {
+    name_release(np);
     return OS_ERR_NO_FREE_IDS;
   }
 
   /* Semaphore is initialized.*/
   chSemObjectInit(sp, (cnt_t)sem_initial_value);
+  osal.count_semaphores_names[sp - &osal.count_semaphores[0]] = np;
+  name_bind(np, (uint32)sp);
 
   *sem_id = (uint32)sp;
 
@@ -1346,6 +1526,7 @@ int32 OS_CountSemCreate(uint32 *sem_id, const char *sem_name,
  */
 int32 OS_CountSemDelete(uint32 sem_id) {
   semaphore_t *sp = (semaphore_t *)sem_id;
+  osal_name_t *np;
 
   /* Range check.*/
   if ((sp < &osal.count_semaphores[0]) ||
@@ -1358,6 +1539,13 @@ int32 OS_CountSemDelete(uint32 sem_id) {
   /* Resetting the semaphore, no threads in queue.*/
   chSemResetI(sp, 0);
 
+  /* Removing the name from the index.*/
+  np = osal.count_semaphores_names[sp - &osal.count_semaphores[0]];
+  if (np != NULL) {
+    osal.count_semaphores_names[sp - &osal.count_semaphores[0]] = NULL;
+    name_remove(np);
+  }
+
   /* Flagging it as unused and returning it to the pool.*/
   sp->queue.prev = NULL;
   chPoolFreeI(&osal.count_semaphores_pool, (void *)sp);
@@ -1480,7 +1668,6 @@ int32 OS_CountSemTimedWait(uint32 sem_id, uint32 msecs) {
 
 /**
  * @brief   Retrieves a counter semaphore id by name.
- * @note    It is not currently implemented.
  *
  * @param[out] sem_id           pointer to a counter semaphore id variable
  * @param[in] sem_name          the counter semaphore name
@@ -1500,7 +1687,13 @@ int32 OS_CountSemGetIdByName(uint32 *sem_id, const char *sem_name) {
     return OS_ERR_NAME_TOO_LONG;
   }
 
-  return OS_ERR_NOT_IMPLEMENTED;
+  /* Searching the semaphore.*/
+  *sem_id = name_find(NAME_TYPE_COUNTSEM, sem_name);
+  if (*sem_id > 0) {
+    return OS_SUCCESS;
+  }
+
+  return OS_ERR_NAME_NOT_FOUND;
 }
 
 /**
@@ -1559,6 +1752,8 @@ int32 OS_CountSemGetInfo(uint32 sem_id, OS_count_sem_prop_t *sem_prop) {
  */
 int32 OS_MutSemCreate(uint32 *sem_id, const char *sem_name, uint32 options) {
   mutex_t *mp;
+  osal_name_t *np;
+  int32 err;
 
   (void)options;
 
@@ -1572,14 +1767,23 @@ int32 OS_MutSemCreate(uint32 *sem_id, const char *sem_name, uint32 options) {
     return OS_ERR_NAME_TOO_LONG;
   }
 
+  /* Reserving the name, it fails if the name is already taken.*/
+  err = name_reserve(&np, NAME_TYPE_MUTEX, sem_name);
+  if (err != OS_SUCCESS) {
+    return err;
+  }
+
   /* Getting object.*/
   mp = chPoolAlloc(&osal.mutexes_pool);
   if (mp == NULL) {
+    name_release(np);
     return OS_ERR_NO_FREE_IDS;
   }
 
   /* Semaphore is initialized.*/
   chMtxObjectInit(mp);
+  osal.mutexes_names[mp - &osal.mutexes[0]] = np;
+  name_bind(np, (uint32)mp);
 
   *sem_id = (uint32)mp;
 
@@ -1596,6 +1800,7 @@ int32 OS_MutSemCreate(uint32 *sem_id, const char *sem_name, uint32 options) {
  */
 int32 OS_MutSemDelete(uint32 sem_id) {
   mutex_t *mp = (mutex_t *)sem_id;
+  osal_name_t *np;
 
   /* Range check.*/
   if ((mp < &osal.mutexes[0]) ||
@@ -1608,6 +1813,13 @@ int32 OS_MutSemDelete(uint32 sem_id) {
   /* Resetting the mutex, no threads in queue.*/
   chMtxUnlockAllS();
 
+  /* Removing the name from the index.*/
+  np = osal.mutexes_names[mp - &osal.mutexes[0]];
+  if (np != NULL) {
+    osal.mutexes_names[mp - &osal.mutexes[0]] = NULL;
+    name_remove(np);
+  }
+
   /* Flagging it as unused and returning it to the pool.*/
   mp->queue.prev = NULL;
   chPoolFreeI(&osal.mutexes_pool, (void *)mp);
@@ -1687,7 +1899,6 @@ int32 OS_MutSemTake(uint32 sem_id) {
 
 /**
  * @brief   Retrieves a mutex id by name.
- * @note    It is not currently implemented.
  *
  * @param[out] sem_id           pointer to a mutex id variable
  * @param[in] sem_name          the mutex name
@@ -1707,7 +1918,13 @@ int32 OS_MutSemGetIdByName(uint32 *sem_id, const char *sem_name) {
     return OS_ERR_NAME_TOO_LONG;
   }
 
-  return OS_ERR_NOT_IMPLEMENTED;
+  /* Searching the mutex.*/
+  *sem_id = name_find(NAME_TYPE_MUTEX, sem_name);
+  if (*sem_id > 0) {
+    return OS_SUCCESS;
+  }
+
+  return OS_ERR_NAME_NOT_FOUND;
 }
 
 /**
@@ -1780,6 +1997,8 @@ int32 OS_TaskCreate(uint32 *task_id,
                     uint32 flags) {
   tprio_t rt_prio;
   thread_t *tp;
+  osal_name_t *np;
+  int32 err;
 
   (void)flags;
 
@@ -1821,11 +2040,10 @@ int32 OS_TaskCreate(uint32 *task_id,
     return OS_ERR_NO_FREE_IDS;
   }
 
-  /* Checking if the name is already in use.*/
-  if ((tp = chRegFindThreadByName(task_name)) != NULL) {
-    /* Releasing the thread reference.*/
-    chThdRelease(tp);
-    return OS_ERR_NAME_TAKEN;
+  /* Reserving the name, it fails if the name is already in use.*/
+  err = name_reserve(&np, NAME_TYPE_TASK, task_name);
+  if (err != OS_SUCCESS) {
+    return err;
   }
 
   /* Converting priority to RT type.*/
@@ -1839,18 +2057,25 @@ int32 OS_TaskCreate(uint32 *task_id,
     (stkalign_t *)stack_pointer,
     (stkalign_t *)((uint8_t *)stack_pointer + stack_size),
     rt_prio,
-    (tfunc_t)(void *)function_pointer,
-    NULL
+    task_entry,
+    (void *)(funcptr_t)function_pointer
   };
 
-  /* Creating the task and detaching it, other APIs will have to gain a
-     reference using the registry API.*/
-  tp = chThdCreate(&td);
-  chThdRelease(tp);
+  /* Creating the task suspended, the name entry must be bound before the
+     task can run because a task with higher priority could exit before
+     returning here.*/
+  tp = chThdCreateSuspended(&td);
+  tp->osal_name = np;
+  name_bind(np, (uint32)tp);
 
   /* Storing the task id.*/
   *task_id = (uint32)tp;
 
+  /* Starting the task and detaching it, other APIs will have to gain a
+     reference using the registry API.*/
+  (void) chThdStart(tp);
+  chThdRelease(tp);
+
   return OS_SUCCESS;
 }
 
@@ -1912,7 +2137,8 @@ int32 OS_TaskDelete(uint32 task_id) {
   /* Getting the delete handler while the thread is still referenced.*/
   fp = (funcptr_t)tp->osal_delete_handler;
 
-  /* Waiting for termination, releasing the reference.*/
+  /* Waiting for termination, releasing the reference. The name entry has
+     already been removed by the task in OS_TaskExit().*/
   chThdWait(tp);
 
   /* Calling the delete handler, if defined.*/
@@ -1925,12 +2151,25 @@ int32 OS_TaskDelete(uint32 task_id) {
 
 /**
  * @brief   Task exit.
+ * @details The name entry of the task is removed, a task returning from its
+ *          function implicitly calls this function.
+ * @note    The entry is reached through the @p osal_name thread field,
+ *          the field is added and cleared by hooks in chconf.h.
  *
  * @api
  */
 void OS_TaskExit(void) {
+  thread_t *tp = chThdGetSelfX();
+
+  chSysLock();
+
+  /* Tasks not created by OS_TaskCreate() have no name entry.*/
+  if (tp->osal_name != NULL) {
+    name_remove(tp->osal_name);
+    tp->osal_name = NULL;
+  }
 
-  chThdExit(MSG_OK);
+  chThdExitS(MSG_OK);
 }
 
 /**
@@ -2077,6 +2316,7 @@ uint32 OS_TaskGetId(void) {
 
 /**
  * @brief   Retrieves a task id by name.
+ * @note    Only tasks created using @p OS_TaskCreate() can be found.
  *
  * @param[out] task_id          pointer to a task id variable
  * @param[in] task_name         the task name
@@ -2085,7 +2325,6 @@ uint32 OS_TaskGetId(void) {
  * @api
  */
 int32 OS_TaskGetIdByName(uint32 *task_id, const char *task_name) {
-  thread_t *tp;
 
   /* NULL pointer checks.*/
   if ((task_id == NULL) || (task_name == NULL)) {
@@ -2097,18 +2336,13 @@ int32 OS_TaskGetIdByName(uint32 *task_id, const char *task_name) {
     return OS_ERR_NAME_TOO_LONG;
   }
 
-  /* Searching in the registry.*/
-  tp = chRegFindThreadByName(task_name);
-  if (tp == NULL) {
-    return OS_ERR_NAME_NOT_FOUND;
+  /* Searching the task.*/
+  *task_id = name_find(NAME_TYPE_TASK, task_name);
+  if (*task_id > 0) {
+    return OS_SUCCESS;
   }
 
-  *task_id = (uint32)tp;
-
-  /* Releasing the thread reference.*/
-  chThdRelease(tp);
-
-  return OS_SUCCESS;
+  return OS_ERR_NAME_NOT_FOUND;
 }
 
 /**
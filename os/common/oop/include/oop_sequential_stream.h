@@ -90,6 +90,26 @@
 /* Module data structures and types.                                         */
 /*===========================================================================*/
 
+/**
+ * @brief       Type of a scatter-gather segment.
+ */
+typedef struct stm_iovec stm_iovec_t;
+
+/**
+ * @brief       Structure representing a scatter-gather segment.
+ * @note        It has the same layout of the Posix @p iovec structure.
+ */
+struct stm_iovec {
+  /**
+   * @brief       Segment address.
+   */
+  void                      *base;
+  /**
+   * @brief       Segment size in bytes.
+   */
+  size_t                    len;
+};
+
 /**
  * @interface   sequential_stream_i
  * @extends     base_interface_i.
@@ -269,6 +289,93 @@ static inline int stmUnget(void *ip, int b) {
 }
 /** @} */
 
+/**
+ * @name        Inline methods of sequential_stream_i
+ * @{
+ */
+/**
+ * @memberof    sequential_stream_i
+ * @public
+ *
+ * @brief       Sequential Stream gather write.
+ * @details     This function writes data from an array of segments to a
+ *              stream, the segments are written in order.
+ * @note        This is not a virtual method because legacy HAL streams are
+ *              also accessed through this interface and their VMTs cannot be
+ *              extended, the segments are written one at time.
+ *
+ * @param[in,out] ip            Pointer to a @p sequential_stream_i instance.
+ * @param[in]     iov           Pointer to the array of segments.
+ * @param[in]     iovcnt        Number of segments in the array.
+ * @return                      The number of bytes transferred. The returned
+ *                              value can be less than the total size of the
+ *                              segments if an end-of-file condition has been
+ *                              met.
+ */
+CC_FORCE_INLINE
+static inline size_t stmWriteV(void *ip, const stm_iovec_t *iov,
+                               unsigned iovcnt) {
+  sequential_stream_i *self = (sequential_stream_i *)ip;
+  size_t total = (size_t)0;
+  unsigned i;
+
+  for (i = 0U; i < iovcnt; i++) {
+    size_t n = iov[i].len;
+
+    if (n > (size_t)0) {
+      size_t done = self->vmt->write(ip, (const uint8_t *)iov[i].base, n);
+      total += done;
+      if (done < n) {
+        break;
+      }
+    }
+  }
+
+  return total;
+}
+
+/**
+ * @memberof    sequential_stream_i
+ * @public
+ *
+ * @brief       Sequential Stream scatter read.
+ * @details     This function reads data from a stream into an array of
+ *              segments, the segments are filled in order.
+ * @note        This is not a virtual method because legacy HAL streams are
+ *              also accessed through this interface and their VMTs cannot be
+ *              extended, the segments are read one at time.
+ *
+ * @param[in,out] ip            Pointer to a @p sequential_stream_i instance.
+ * @param[in]     iov           Pointer to the array of segments.
+ * @param[in]     iovcnt        Number of segments in the array.
+ * @return                      The number of bytes transferred. The returned
+ *                              value can be less than the total size of the
+ *                              segments if an end-of-file condition has been
+ *                              met.
+ */
+CC_FORCE_INLINE
+static inline size_t stmReadV(void *ip, const stm_iovec_t *iov,
+                              unsigned iovcnt) {
+  sequential_stream_i *self = (sequential_stream_i *)ip;
+  size_t total = (size_t)0;
+  unsigned i;
+
+  for (i = 0U; i < iovcnt; i++) {
+    size_t n = iov[i].len;
+
+    if (n > (size_t)0) {
+      size_t done = self->vmt->read(ip, (uint8_t *)iov[i].base, n);
+      total += done;
+      if (done < n) {
+        break;
+      }
+    }
+  }
+
+  return total;
+}
+/** @} */
+
 #endif /* OOP_SEQUENTIAL_STREAM_H */
 
 /** @} */
@@ -27,8 +27,6 @@
 
 #if defined(WIN32)
 #include <windows.h>
-#else
-#include <sys/time.h>
 #endif
 
 #include "ch.h"
@@ -134,10 +132,8 @@ rtcnt_t port_rt_get_counter_value(void) {
 
   return (rtcnt_t)(n.QuadPart / 1000LL);
 #else
-  struct timeval tv;
-
-  gettimeofday(&tv, NULL);
-  return ((rtcnt_t)tv.tv_sec * (rtcnt_t)1000000) + (rtcnt_t)tv.tv_usec;
+  /* Provided by the simulator HAL, it can be virtual time.*/
+  return (rtcnt_t)_sim_get_rt_counter();
 #endif
 }
 
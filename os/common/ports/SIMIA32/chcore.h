@@ -90,6 +90,13 @@
 #define PORT_INFO                       "No preemption"
 /** @} */
 
+/**
+ * @brief   Realtime counter frequency.
+ * @details The realtime counter is the host clock in microseconds.
+ * @note    The simulator HAL can replace it with simulated CPU cycles.
+ */
+#define PORT_SIM_RT_FREQUENCY           1000000U
+
 /*===========================================================================*/
 /* Module pre-compile time settings.                                         */
 /*===========================================================================*/
@@ -304,6 +311,10 @@ extern "C" {
   /*lint -restore*/
   rtcnt_t port_rt_get_counter_value(void);
   void _sim_check_for_interrupts(void);
+  void _sim_wait_for_interrupts(void);
+#if !defined(WIN32)
+  uint64_t _sim_get_rt_counter(void);
+#endif
 #ifdef __cplusplus
 }
 #endif
@@ -433,11 +444,12 @@ static inline void port_enable(void) {
  *          The simplest implementation is an empty function or macro but this
  *          would not take advantage of architecture-specific power saving
  *          modes.
- * @note    Implemented as an inlined @p WFI instruction.
+ * @note    The simulator HAL suspends the host process until the next
+ *          simulated interrupt, if supported.
  */
 static inline void port_wait_for_interrupt(void) {
 
-  _sim_check_for_interrupts();
+  _sim_wait_for_interrupts();
 }
 
 #endif /* !defined(_FROM_ASM_) */
@@ -800,6 +800,33 @@ static msg_t gyro_set_full_scale(LSM6DSLDriver *devp, lsm6dsl_gyro_fs_t fs) {
   return msg;
 }
 
+#if (LSM6DSL_USE_FIFO) || defined(__DOXYGEN__)
+/**
+ * @brief   Sets the FIFO operating mode.
+ * @note    Switching the FIFO to bypass mode discards its content.
+ *
+ * @param[in] devp      pointer to @p LSM6DSLDriver interface.
+ * @param[in] mode      new FIFO mode.
+ *
+ * @return              The operation status.
+ * @retval MSG_OK       if the function succeeded.
+ * @retval MSG_RESET    if one or more I2C errors occurred, the errors can
+ *                      be retrieved using @p i2cGetErrors().
+ * @retval MSG_TIMEOUT  if a timeout occurred before operation end.
+ */
+static msg_t fifo_set_mode(LSM6DSLDriver *devp, uint8_t mode) {
+  uint8_t cr[2];
+
+  /* The FIFO ODR field uses the same encoding of the sensors ODR fields.*/
+  cr[0] = LSM6DSL_AD_FIFO_CTRL5;
+  cr[1] = (uint8_t)((devp->config->accodr >> 1) &
+                    LSMDSL_FIFO_CTRL5_ODR_FIFO_MASK) | mode;
+
+  return lsm6dslI2CWriteRegister(devp->config->i2cp,
+                                 devp->config->slaveaddress, cr, 1);
+}
+#endif /* LSM6DSL_USE_FIFO */
+
 static const struct LSM6DSLVMT vmt_device = {
   (size_t)0,
   acc_set_full_scale, gyro_set_full_scale
@@ -839,6 +866,11 @@ void lsm6dslObjectInit(LSM6DSLDriver *devp) {
   devp->accaxes = LSM6DSL_ACC_NUMBER_OF_AXES;
   devp->gyroaxes = LSM6DSL_GYRO_NUMBER_OF_AXES;
 
+#if LSM6DSL_USE_FIFO
+  sensorStreamObjectInit(&devp->stream, NULL, 0,
+                         LSM6DSL_FIFO_NUMBER_OF_CHANNELS);
+#endif /* LSM6DSL_USE_FIFO */
+
   devp->state = LSM6DSL_STOP;
 }
 
@@ -1085,7 +1117,7 @@ void lsm6dslStart(LSM6DSLDriver *devp, const LSM6DSLConfig *config) {
  * @api
  */
 void lsm6dslStop(LSM6DSLDriver *devp) {
-  uint8_t cr[2];
+  uint8_t cr[3];
 
   osalDbgCheck(devp != NULL);
 
@@ -1114,6 +1146,253 @@ void lsm6dslStop(LSM6DSLDriver *devp) {
 #endif /* LSM6DSL_SHARED_I2C */
 #endif /* LSM6DSL_USE_I2C */
   }
+#if LSM6DSL_USE_FIFO
+  devp->stream.buffer = NULL;
+#endif /* LSM6DSL_USE_FIFO */
   devp->state = LSM6DSL_STOP;
 }
+
+#if (LSM6DSL_USE_FIFO) || defined(__DOXYGEN__)
+/**
+ * @brief   Starts the FIFO streaming mode.
+ * @details The device FIFO is configured in continuous mode collecting
+ *          both gyroscope and accelerometer samples, samples are then
+ *          moved into the specified buffer by @p lsm6dslFIFOFetch().
+ * @pre     Accelerometer and gyroscope must be configured with the same
+ *          output data rate.
+ * @note    The buffer is the target of I2C transfers, it must satisfy the
+ *          DMA alignment requirements of the platform, if any.
+ *
+ * @param[in] devp      pointer to @p LSM6DSLDriver.
+ * @param[in] buf       pointer to the samples buffer, it must have size
+ *                      @p SENSOR_STREAM_BUFFER_SIZE(
+ *                      LSM6DSL_FIFO_NUMBER_OF_CHANNELS, n)
+ * @param[in] n         buffer size as number of samples
+ *
+ * @return              The operation status.
+ * @retval MSG_OK       if the function succeeded.
+ * @retval MSG_RESET    if one or more I2C errors occurred, the errors can
+ *                      be retrieved using @p i2cGetErrors().
+ * @retval MSG_TIMEOUT  if a timeout occurred before operation end.
+ *
+ * @api
+ */
+msg_t lsm6dslFIFOStart(LSM6DSLDriver *devp, void *buf, size_t n) {
+  uint8_t cr[4];
+  msg_t msg;
+
+  osalDbgCheck((devp != NULL) && (buf != NULL) && (n > 0U));
+
+  osalDbgAssert((devp->state == LSM6DSL_READY),
+                "lsm6dslFIFOStart(), invalid state");
+  osalDbgAssert(((uint8_t)devp->config->accodr ==
+                 (uint8_t)devp->config->gyroodr) &&
+                (devp->config->accodr != LSM6DSL_ACC_ODR_PD),
+                "lsm6dslFIFOStart(), unsupported ODR configuration");
+#if LSM6DSL_USE_ADVANCED
+  osalDbgAssert((devp->config->endianness == LSM6DSL_END_LITTLE),
+                "lsm6dslFIFOStart(), unsupported endianness");
+#endif
+
+  sensorStreamObjectInit(&devp->stream, buf, n,
+                         LSM6DSL_FIFO_NUMBER_OF_CHANNELS);
+
+  /* Both sensors stored without decimation, FIFO in bypass mode.*/
+  cr[0] = LSM6DSL_AD_FIFO_CTRL3;
+  cr[1] = LSMDSL_FIFO_CTRL3_DEC_FIFO_G0 | LSMDSL_FIFO_CTRL3_DEC_FIFO_XL0;
+  cr[2] = 0;
+  cr[3] = LSMDSL_FIFO_CTRL5_FIFO_MODE_BYPASS;
+
+#if LSM6DSL_USE_I2C
+#if LSM6DSL_SHARED_I2C
+  i2cAcquireBus(devp->config->i2cp);
+  i2cStart(devp->config->i2cp, devp->config->i2ccfg);
+#endif /* LSM6DSL_SHARED_I2C */
+
+  msg = lsm6dslI2CWriteRegister(devp->config->i2cp,
+                                devp->config->slaveaddress, cr, 3);
+  if (msg == MSG_OK) {
+    msg = fifo_set_mode(devp, LSMDSL_FIFO_CTRL5_FIFO_MODE_CONT);
+  }
+
+#if LSM6DSL_SHARED_I2C
+  i2cReleaseBus(devp->config->i2cp);
+#endif /* LSM6DSL_SHARED_I2C */
+#endif /* LSM6DSL_USE_I2C */
+
+  if (msg != MSG_OK) {
+    devp->stream.buffer = NULL;
+  }
+  return msg;
+}
+
+/**
+ * @brief   Stops the FIFO streaming mode.
+ * @note    Samples still in the stream buffer are discarded.
+ *
+ * @param[in] devp      pointer to @p LSM6DSLDriver.
+ *
+ * @return              The operation status.
+ * @retval MSG_OK       if the function succeeded.
+ * @retval MSG_RESET    if one or more I2C errors occurred, the errors can
+ *                      be retrieved using @p i2cGetErrors().
+ * @retval MSG_TIMEOUT  if a timeout occurred before operation end.
+ *
+ * @api
+ */
+msg_t lsm6dslFIFOStop(LSM6DSLDriver *devp) {
+  msg_t msg;
+
+  osalDbgCheck(devp != NULL);
+
+  osalDbgAssert((devp->state == LSM6DSL_READY),
+                "lsm6dslFIFOStop(), invalid state");
+
+#if LSM6DSL_USE_I2C
+#if LSM6DSL_SHARED_I2C
+  i2cAcquireBus(devp->config->i2cp);
+  i2cStart(devp->config->i2cp, devp->config->i2ccfg);
+#endif /* LSM6DSL_SHARED_I2C */
+
+  msg = fifo_set_mode(devp, LSMDSL_FIFO_CTRL5_FIFO_MODE_BYPASS);
+
+#if LSM6DSL_SHARED_I2C
+  i2cReleaseBus(devp->config->i2cp);
+#endif /* LSM6DSL_SHARED_I2C */
+#endif /* LSM6DSL_USE_I2C */
+
+  devp->stream.buffer = NULL;
+  sensorStreamReset(&devp->stream);
+
+  return msg;
+}
+
+/**
+ * @brief   Moves the samples collected by the device FIFO into the stream.
+ * @details The FIFO status is read then all the complete samples that fit
+ *          the stream buffer are drained using burst transfers, at most
+ *          two transfers are performed when the buffer wraps around.
+ *          Samples not fitting the buffer are left in the device FIFO.
+ * @note    On a device FIFO overrun the FIFO content is discarded and the
+ *          FIFO restarted, the event is counted and can be retrieved
+ *          using @p lsm6dslFIFOGetOverruns().
+ *
+ * @param[in] devp      pointer to @p LSM6DSLDriver.
+ *
+ * @return              The operation status.
+ * @retval MSG_OK       if the function succeeded.
+ * @retval MSG_RESET    if one or more I2C errors occurred, the errors can
+ *                      be retrieved using @p i2cGetErrors().
+ * @retval MSG_TIMEOUT  if a timeout occurred before operation end.
+ *
+ * @api
+ */
+msg_t lsm6dslFIFOFetch(LSM6DSLDriver *devp) {
+  uint8_t status[4], *wp;
+  size_t n, free;
+  unsigned i;
+  msg_t msg;
+
+  osalDbgCheck(devp != NULL);
+
+  osalDbgAssert((devp->state == LSM6DSL_READY) &&
+                (devp->stream.buffer != NULL),
+                "lsm6dslFIFOFetch(), invalid state");
+
+#if LSM6DSL_USE_I2C
+#if LSM6DSL_SHARED_I2C
+  i2cAcquireBus(devp->config->i2cp);
+  i2cStart(devp->config->i2cp, devp->config->i2ccfg);
+#endif /* LSM6DSL_SHARED_I2C */
+
+  msg = lsm6dslI2CReadRegister(devp->config->i2cp, devp->config->slaveaddress,
+                               LSM6DSL_AD_FIFO_STATUS1, status, 4);
+  if (msg == MSG_OK) {
+    if (((status[1] & LSMDSL_FIFO_STATUS2_OVER_RUN) != 0U) ||
+        (status[2] != 0U) ||
+        ((status[3] & LSMDSL_FIFO_STATUS4_PATTERN_MASK) != 0U)) {
+      /* Overrun or misaligned pattern, restarting the FIFO.*/
+      devp->stream.overruns++;
+      msg = fifo_set_mode(devp, LSMDSL_FIFO_CTRL5_FIFO_MODE_BYPASS);
+      if (msg == MSG_OK) {
+        msg = fifo_set_mode(devp, LSMDSL_FIFO_CTRL5_FIFO_MODE_CONT);
+      }
+    }
+    else {
+      /* Number of complete samples in the FIFO.*/
+      n = ((((size_t)status[1] & LSMDSL_FIFO_STATUS2_DIFF_FIFO_MASK) << 8) |
+           (size_t)status[0]) / LSM6DSL_FIFO_NUMBER_OF_CHANNELS;
+
+      /* The FIFO output address rolls back automatically, the whole
+         contiguous space is filled with a single transfer.*/
+      for (i = 0U; (i < 2U) && (n > 0U) && (msg == MSG_OK); i++) {
+        wp = sensorStreamGetWriteBuffer(&devp->stream, &free);
+        if (free == 0U) {
+          break;
+        }
+        if (free > n) {
+          free = n;
+        }
+        msg = lsm6dslI2CReadRegister(devp->config->i2cp,
+                                     devp->config->slaveaddress,
+                                     LSM6DSL_AD_FIFO_DATA_OUT_L, wp,
+                                     free * LSM6DSL_FIFO_NUMBER_OF_CHANNELS *
+                                     2U);
+        if (msg == MSG_OK) {
+          sensorStreamCommit(&devp->stream, free);
+          n -= free;
+        }
+      }
+    }
+  }
+
+#if LSM6DSL_SHARED_I2C
+  i2cReleaseBus(devp->config->i2cp);
+#endif /* LSM6DSL_SHARED_I2C */
+#endif /* LSM6DSL_USE_I2C */
+
+  return msg;
+}
+
+/**
+ * @brief   Reads cooked samples from the FIFO stream.
+ * @details Samples are converted in batch according to the formula
+ *          cooked = (raw * sensitivity) - bias. Each output sample is made
+ *          of the gyroscope axes, expressed as DPS, followed by the
+ *          accelerometer axes, expressed as milli-G.
+ * @note    This function does not access the device, samples must have
+ *          been moved into the stream using @p lsm6dslFIFOFetch().
+ *
+ * @param[in] devp      pointer to @p LSM6DSLDriver.
+ * @param[out] dp       output buffer, it must have space for
+ *                      @p n * @p LSM6DSL_FIFO_NUMBER_OF_CHANNELS elements
+ * @param[in] n         maximum number of samples to be read
+ *
+ * @return              The number of samples read.
+ *
+ * @api
+ */
+size_t lsm6dslFIFOReadCooked(LSM6DSLDriver *devp, float *dp, size_t n) {
+  float sensitivity[LSM6DSL_FIFO_NUMBER_OF_CHANNELS];
+  float bias[LSM6DSL_FIFO_NUMBER_OF_CHANNELS];
+  unsigned i;
+
+  osalDbgCheck((devp != NULL) && (dp != NULL));
+
+  osalDbgAssert((devp->state == LSM6DSL_READY) &&
+                (devp->stream.buffer != NULL),
+                "lsm6dslFIFOReadCooked(), invalid state");
+
+  for (i = 0U; i < LSM6DSL_GYRO_NUMBER_OF_AXES; i++) {
+    sensitivity[i] = devp->gyrosensitivity[i];
+    bias[i]        = devp->gyrobias[i];
+  }
+  for (i = 0U; i < LSM6DSL_ACC_NUMBER_OF_AXES; i++) {
+    sensitivity[LSM6DSL_GYRO_NUMBER_OF_AXES + i] = devp->accsensitivity[i];
+    bias[LSM6DSL_GYRO_NUMBER_OF_AXES + i]        = devp->accbias[i];
+  }
+
+  return sensorStreamReadCooked(&devp->stream, dp, n, sensitivity, bias);
+}
+#endif /* LSM6DSL_USE_FIFO */
 /** @} */
@@ -43,7 +43,7 @@
 /**
  * @brief   LSM6DSL driver version string.
  */
-#define EX_LSM6DSL_VERSION                  "1.0.2"
+#define EX_LSM6DSL_VERSION                  "1.1.0"
 
 /**
  * @brief   LSM6DSL driver version major number.
@@ -53,12 +53,12 @@
 /**
  * @brief   LSM6DSL driver version minor number.
  */
-#define EX_LSM6DSL_MINOR                    0
+#define EX_LSM6DSL_MINOR                    1
 
 /**
  * @brief   LSM6DSL driver version patch number.
  */
-#define EX_LSM6DSL_PATCH                    2
+#define EX_LSM6DSL_PATCH                    0
 /** @} */
 
 /**
@@ -109,6 +109,17 @@
 #define LSM6DSL_GYRO_BIAS                   0.0f
 /** @} */
 
+/**
+ * @brief   LSM6DSL FIFO characteristics.
+ * @note    Each FIFO sample is made of the gyroscope axes followed by
+ *          the accelerometer axes.
+ *
+ * @{
+ */
+#define LSM6DSL_FIFO_NUMBER_OF_CHANNELS     (LSM6DSL_GYRO_NUMBER_OF_AXES +  \
+                                             LSM6DSL_ACC_NUMBER_OF_AXES)
+/** @} */
+
 /**
  * @name   LSM6DSL communication interfaces related bit masks
  * @{
@@ -352,6 +363,46 @@
 #define LSMDSL_CTRL10_C_WRIST_TILT          (1 << 7)
 /** @} */
 
+/**
+ * @name    LSM6DSL_AD_FIFO_CTRL3 register bits definitions
+ * @{
+ */
+#define LSMDSL_FIFO_CTRL3_DEC_FIFO_XL0      (1 << 0)
+#define LSMDSL_FIFO_CTRL3_DEC_FIFO_XL1      (1 << 1)
+#define LSMDSL_FIFO_CTRL3_DEC_FIFO_XL2      (1 << 2)
+#define LSMDSL_FIFO_CTRL3_DEC_FIFO_G0       (1 << 3)
+#define LSMDSL_FIFO_CTRL3_DEC_FIFO_G1       (1 << 4)
+#define LSMDSL_FIFO_CTRL3_DEC_FIFO_G2       (1 << 5)
+/** @} */
+
+/**
+ * @name    LSM6DSL_AD_FIFO_CTRL5 register bits definitions
+ * @{
+ */
+#define LSMDSL_FIFO_CTRL5_FIFO_MODE_MASK    0x07
+#define LSMDSL_FIFO_CTRL5_FIFO_MODE_BYPASS  0x00
+#define LSMDSL_FIFO_CTRL5_FIFO_MODE_CONT    0x06
+#define LSMDSL_FIFO_CTRL5_ODR_FIFO_MASK     0x78
+/** @} */
+
+/**
+ * @name    LSM6DSL_AD_FIFO_STATUS2 register bits definitions
+ * @{
+ */
+#define LSMDSL_FIFO_STATUS2_DIFF_FIFO_MASK  0x07
+#define LSMDSL_FIFO_STATUS2_FIFO_EMPTY      (1 << 4)
+#define LSMDSL_FIFO_STATUS2_FIFO_FULL_SMART (1 << 5)
+#define LSMDSL_FIFO_STATUS2_OVER_RUN        (1 << 6)
+#define LSMDSL_FIFO_STATUS2_WATERM          (1 << 7)
+/** @} */
+
+/**
+ * @name    LSM6DSL_AD_FIFO_STATUS4 register bits definitions
+ * @{
+ */
+#define LSMDSL_FIFO_STATUS4_PATTERN_MASK    0x03
+/** @} */
+
 /*===========================================================================*/
 /* Driver pre-compile time settings.                                         */
 /*===========================================================================*/
@@ -407,6 +458,15 @@
 #define LSM6DSL_USE_ADVANCED                FALSE
 #endif
 
+/**
+ * @brief   LSM6DSL FIFO streaming switch.
+ * @details If set to @p TRUE the FIFO streaming API is included.
+ * @note    The default is @p FALSE.
+ */
+#if !defined(LSM6DSL_USE_FIFO) || defined(__DOXYGEN__)
+#define LSM6DSL_USE_FIFO                    FALSE
+#endif
+
 /**
  * @brief   Number of acquisitions for gyroscope bias removal.
  * @details This is the number of acquisitions performed to compute the
@@ -698,6 +758,17 @@ struct LSM6DSLVMT {
   _lsm6dsl_methods
 };
 
+#if (LSM6DSL_USE_FIFO) || defined(__DOXYGEN__)
+/**
+ * @brief   @p LSM6DSLDriver FIFO streaming data.
+ */
+#define _lsm6dsl_fifo_data                                                  \
+  /* Samples stream.*/                                                      \
+  sensor_stream_t           stream;
+#else
+#define _lsm6dsl_fifo_data
+#endif /* LSM6DSL_USE_FIFO */
+
 /**
  * @brief   @p LSM6DSLDriver specific data.
  */
@@ -722,7 +793,8 @@ struct LSM6DSLVMT {
   /* Gyroscope subsystem current Bias.*/                                    \
   float                     gyrobias[LSM6DSL_GYRO_NUMBER_OF_AXES];          \
   /* Gyroscope subsystem current full scale value.*/                        \
-  float                     gyrofullscale;
+  float                     gyrofullscale;                                  \
+  _lsm6dsl_fifo_data
 
 /**
  * @brief LSM6DSL 6-axis accelerometer/gyroscope class.
@@ -1036,6 +1108,32 @@ struct LSM6DSLDriver {
 #define lsm6dslGyroscopeSetFullScale(devp, fs)                              \
         (devp)->vmt->acc_set_full_scale(devp, fs)
 
+#if (LSM6DSL_USE_FIFO) || defined(__DOXYGEN__)
+/**
+ * @brief   Returns the number of samples buffered in the FIFO stream.
+ *
+ * @param[in] devp      pointer to @p LSM6DSLDriver.
+ *
+ * @return              The number of buffered samples.
+ *
+ * @api
+ */
+#define lsm6dslFIFOGetUsedCount(devp)                                       \
+        sensorStreamGetUsedCount(&((devp)->stream))
+
+/**
+ * @brief   Returns the number of device FIFO overruns.
+ *
+ * @param[in] devp      pointer to @p LSM6DSLDriver.
+ *
+ * @return              The number of overruns since @p lsm6dslFIFOStart().
+ *
+ * @api
+ */
+#define lsm6dslFIFOGetOverruns(devp)                                        \
+        sensorStreamGetOverruns(&((devp)->stream))
+#endif /* LSM6DSL_USE_FIFO */
+
 /*===========================================================================*/
 /* External declarations.                                                    */
 /*===========================================================================*/
@@ -1046,6 +1144,12 @@ extern "C" {
   void lsm6dslObjectInit(LSM6DSLDriver *devp);
   void lsm6dslStart(LSM6DSLDriver *devp, const LSM6DSLConfig *config);
   void lsm6dslStop(LSM6DSLDriver *devp);
+#if (LSM6DSL_USE_FIFO) || defined(__DOXYGEN__)
+  msg_t lsm6dslFIFOStart(LSM6DSLDriver *devp, void *buf, size_t n);
+  msg_t lsm6dslFIFOStop(LSM6DSLDriver *devp);
+  msg_t lsm6dslFIFOFetch(LSM6DSLDriver *devp);
+  size_t lsm6dslFIFOReadCooked(LSM6DSLDriver *devp, float *dp, size_t n);
+#endif /* LSM6DSL_USE_FIFO */
 #ifdef __cplusplus
 }
 #endif
@@ -87,6 +87,33 @@ typedef struct {
   _base_sensor_data
 } BaseSensor;
 
+/**
+ * @brief   Sensor samples stream.
+ * @details Ring buffer of raw samples used by drivers able to drain the
+ *          device hardware FIFO in a single burst transfer. Each sample
+ *          is made of @p channels 16 bits little endian words, the format
+ *          produced by MEMS FIFOs, so bursts can be transferred directly
+ *          into the buffer, using DMA when available.
+ * @note    Streams are not thread safe, filling and consuming a stream
+ *          must be serialized by the caller.
+ */
+typedef struct {
+  /** @brief Samples buffer.*/
+  uint8_t                   *buffer;
+  /** @brief Buffer size as number of samples.*/
+  size_t                    size;
+  /** @brief Number of channels of each sample.*/
+  size_t                    channels;
+  /** @brief Read index.*/
+  size_t                    rdidx;
+  /** @brief Write index.*/
+  size_t                    wridx;
+  /** @brief Number of samples into the buffer.*/
+  size_t                    cnt;
+  /** @brief Number of device FIFO overruns.*/
+  uint32_t                  overruns;
+} sensor_stream_t;
+
 /*===========================================================================*/
 /* Driver macros.                                                            */
 /*===========================================================================*/
@@ -134,6 +161,50 @@ typedef struct {
 #define sensorReadCooked(ip, dp) (ip)->vmt->read_cooked(ip, dp)
 /** @} */
 
+/**
+ * @name    Macro Functions (sensor_stream_t)
+ * @{
+ */
+/**
+ * @brief   Size of a sensor stream buffer.
+ *
+ * @param[in] channels  number of channels of each sample
+ * @param[in] n         number of samples
+ */
+#define SENSOR_STREAM_BUFFER_SIZE(channels, n)                              \
+  ((size_t)(channels) * (size_t)(n) * (size_t)2)
+
+/**
+ * @brief   Returns the number of samples into a stream.
+ *
+ * @param[in] ssp       pointer to a @p sensor_stream_t object
+ * @return              The number of buffered samples.
+ *
+ * @api
+ */
+#define sensorStreamGetUsedCount(ssp) ((ssp)->cnt)
+
+/**
+ * @brief   Returns the number of free sample slots into a stream.
+ *
+ * @param[in] ssp       pointer to a @p sensor_stream_t object
+ * @return              The number of free samples slots.
+ *
+ * @api
+ */
+#define sensorStreamGetFreeCount(ssp) ((ssp)->size - (ssp)->cnt)
+
+/**
+ * @brief   Returns the number of device FIFO overruns.
+ *
+ * @param[in] ssp       pointer to a @p sensor_stream_t object
+ * @return              The number of overruns since initialization.
+ *
+ * @api
+ */
+#define sensorStreamGetOverruns(ssp) ((ssp)->overruns)
+/** @} */
+
 /*===========================================================================*/
 /* External declarations.                                                    */
 /*===========================================================================*/
@@ -146,6 +217,177 @@ extern "C" {
 }
 #endif
 
+/*===========================================================================*/
+/* Driver inline functions.                                                  */
+/*===========================================================================*/
+
+/**
+ * @brief   Converts a batch of raw samples to cooked data.
+ * @details Each channel is converted according to the formula
+ *          cooked = (raw * sensitivity) - bias.
+ * @note    The function is meant to be inlined with a constant number
+ *          of channels, the inner loop is then unrolled and the whole
+ *          batch is processed by a branch-free, vectorizable loop.
+ *
+ * @param[out] dp           output buffer, @p n * @p channels elements
+ * @param[in] rp            raw samples as 16 bits little endian words
+ * @param[in] n             number of samples
+ * @param[in] channels      number of channels of each sample
+ * @param[in] sensitivity   per-channel sensitivities
+ * @param[in] bias          per-channel biases
+ *
+ * @xclass
+ */
+static inline void sensorCookSamples(float *dp, const uint8_t *rp, size_t n,
+                                     size_t channels,
+                                     const float sensitivity[],
+                                     const float bias[]) {
+  size_t i, c;
+
+  for (i = 0U; i < n; i++) {
+    for (c = 0U; c < channels; c++) {
+      int16_t raw = (int16_t)((uint16_t)rp[c * 2U] |
+                              ((uint16_t)rp[(c * 2U) + 1U] << 8));
+      dp[c] = ((float)raw * sensitivity[c]) - bias[c];
+    }
+    dp += channels;
+    rp += channels * 2U;
+  }
+}
+
+/**
+ * @brief   Initializes a sensor stream.
+ *
+ * @param[out] ssp      pointer to a @p sensor_stream_t object
+ * @param[in] buf       pointer to the samples buffer, it must have size
+ *                      @p SENSOR_STREAM_BUFFER_SIZE(channels, n)
+ * @param[in] n         number of samples in the buffer
+ * @param[in] channels  number of channels of each sample
+ *
+ * @init
+ */
+static inline void sensorStreamObjectInit(sensor_stream_t *ssp, void *buf,
+                                          size_t n, size_t channels) {
+
+  ssp->buffer   = (uint8_t *)buf;
+  ssp->size     = n;
+  ssp->channels = channels;
+  ssp->rdidx    = 0U;
+  ssp->wridx    = 0U;
+  ssp->cnt      = 0U;
+  ssp->overruns = 0U;
+}
+
+/**
+ * @brief   Discards all the samples in a sensor stream.
+ *
+ * @param[in] ssp       pointer to a @p sensor_stream_t object
+ *
+ * @api
+ */
+static inline void sensorStreamReset(sensor_stream_t *ssp) {
+
+  ssp->rdidx = 0U;
+  ssp->wridx = 0U;
+  ssp->cnt   = 0U;
+}
+
+/**
+ * @brief   Returns the contiguous free space of a sensor stream.
+ * @details Drivers transfer samples directly at the returned location
+ *          then call @p sensorStreamCommit().
+ *
+ * @param[in] ssp       pointer to a @p sensor_stream_t object
+ * @param[out] np       number of samples that can be written at the
+ *                      returned location
+ * @return              Pointer to the free space.
+ *
+ * @api
+ */
+static inline uint8_t *sensorStreamGetWriteBuffer(sensor_stream_t *ssp,
+                                                  size_t *np) {
+  size_t n;
+
+  n = ssp->size - ssp->wridx;
+  if (n > ssp->size - ssp->cnt) {
+    n = ssp->size - ssp->cnt;
+  }
+  *np = n;
+
+  return ssp->buffer + (ssp->wridx * ssp->channels * 2U);
+}
+
+/**
+ * @brief   Commits samples written in the stream free space.
+ *
+ * @param[in] ssp       pointer to a @p sensor_stream_t object
+ * @param[in] n         number of samples written
+ *
+ * @api
+ */
+static inline void sensorStreamCommit(sensor_stream_t *ssp, size_t n) {
+
+  ssp->wridx += n;
+  if (ssp->wridx >= ssp->size) {
+    ssp->wridx -= ssp->size;
+  }
+  ssp->cnt += n;
+}
+
+/**
+ * @brief   Reads and converts samples from a sensor stream.
+ * @details Each channel is converted according to the formula
+ *          cooked = (raw * sensitivity) - bias.
+ *
+ * @param[in] ssp           pointer to a @p sensor_stream_t object
+ * @param[out] dp           output buffer, @p n * channels elements
+ * @param[in] n             maximum number of samples to be read
+ * @param[in] sensitivity   per-channel sensitivities
+ * @param[in] bias          per-channel biases
+ * @return                  The number of samples read.
+ *
+ * @api
+ */
+static inline size_t sensorStreamReadCooked(sensor_stream_t *ssp, float *dp,
+                                            size_t n,
+                                            const float sensitivity[],
+                                            const float bias[]) {
+  size_t done, chunk;
+  const uint8_t *rp;
+
+  if (n > ssp->cnt) {
+    n = ssp->cnt;
+  }
+
+  for (done = 0U; done < n; done += chunk) {
+    chunk = ssp->size - ssp->rdidx;
+    if (chunk > n - done) {
+      chunk = n - done;
+    }
+    rp = ssp->buffer + (ssp->rdidx * ssp->channels * 2U);
+
+    /* Specializing the kernel for the common layouts.*/
+    if (ssp->channels == 3U) {
+      sensorCookSamples(dp, rp, chunk, 3U, sensitivity, bias);
+    }
+    else if (ssp->channels == 6U) {
+      sensorCookSamples(dp, rp, chunk, 6U, sensitivity, bias);
+    }
+    else {
+      sensorCookSamples(dp, rp, chunk, ssp->channels, sensitivity, bias);
+    }
+    dp += chunk * ssp->channels;
+
+    ssp->rdidx += chunk;
+    if (ssp->rdidx >= ssp->size) {
+      ssp->rdidx = 0U;
+    }
+  }
+  ssp->cnt -= n;
+
+  return n;
+}
+
 #endif /* EX_SENSORS_H */
 
 /** @} */
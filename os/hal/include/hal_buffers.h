@@ -121,6 +121,11 @@ struct io_buffers_queue {
    * @brief   Boundary for R/W sequential access.
    */
   uint8_t               *top;
+  /**
+   * @brief   The current buffer is being accessed in place.
+   * @note    A buffer being accessed in place is not flushed.
+   */
+  bool                  inplace;
   /**
    * @brief   Data notification callback.
    */
@@ -318,6 +323,9 @@ extern "C" {
   msg_t ibqGetTimeout(input_buffers_queue_t *ibqp, sysinterval_t timeout);
   size_t ibqReadTimeout(input_buffers_queue_t *ibqp, uint8_t *bp,
                         size_t n, sysinterval_t timeout);
+  uint8_t *ibqGetReadAreaTimeout(input_buffers_queue_t *ibqp, size_t *sizep,
+                                 sysinterval_t timeout);
+  void ibqReleaseReadArea(input_buffers_queue_t *ibqp, size_t n);
   void obqObjectInit(output_buffers_queue_t *obqp, bool suspended, uint8_t *bp,
                      size_t size, size_t n, bqnotify_t onfy, void *link);
   void obqResetI(output_buffers_queue_t *obqp);
@@ -334,6 +342,9 @@ extern "C" {
                       sysinterval_t timeout);
   size_t obqWriteTimeout(output_buffers_queue_t *obqp, const uint8_t *bp,
                          size_t n, sysinterval_t timeout);
+  uint8_t *obqGetWriteAreaTimeout(output_buffers_queue_t *obqp,
+                                  size_t *sizep, sysinterval_t timeout);
+  void obqCommitWriteArea(output_buffers_queue_t *obqp, size_t n);
   bool obqTryFlushI(output_buffers_queue_t *obqp);
   void obqFlush(output_buffers_queue_t *obqp);
 #ifdef __cplusplus
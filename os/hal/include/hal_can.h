@@ -62,6 +62,11 @@
  */
 #define CAN_ANY_MAILBOX             0U
 
+/**
+ * @brief   Extended identifier flag in software filter identifiers.
+ */
+#define CAN_ID_EXT                  0x80000000U
+
 /*===========================================================================*/
 /* Driver pre-compile time settings.                                         */
 /*===========================================================================*/
@@ -86,12 +91,38 @@
 #if !defined(CAN_ENFORCE_USE_CALLBACKS) || defined(__DOXYGEN__)
 #define CAN_ENFORCE_USE_CALLBACKS   FALSE
 #endif
+
+/**
+ * @brief   Software RX ring related APIs inclusion switch.
+ * @details If enabled the receive ISR can move the received frames from the
+ *          hardware mailboxes into a software ring, see @p canRxRingStart().
+ * @note    This option can only be enabled if the CAN implementation
+ *          exports the @p can_lld_get_rx_id() macro.
+ */
+#if !defined(CAN_USE_RX_RING) || defined(__DOXYGEN__)
+#define CAN_USE_RX_RING             FALSE
+#endif
+
+/**
+ * @brief   Size of the software acceptance filter hash table.
+ * @details Up to 3/4 of this number of identifiers can be accepted by the
+ *          software filter.
+ * @note    Must be a power of two.
+ */
+#if !defined(CAN_RX_FILTER_SIZE) || defined(__DOXYGEN__)
+#define CAN_RX_FILTER_SIZE          64U
+#endif
 /** @} */
 
 /*===========================================================================*/
 /* Derived constants and error checks.                                       */
 /*===========================================================================*/
 
+#if (CAN_RX_FILTER_SIZE < 2U) || (CAN_RX_FILTER_SIZE > 65536U) ||           \
+    ((CAN_RX_FILTER_SIZE & (CAN_RX_FILTER_SIZE - 1U)) != 0U)
+#error "CAN_RX_FILTER_SIZE must be a power of two between 2 and 65536"
+#endif
+
 /*===========================================================================*/
 /* Driver data structures and types.                                         */
 /*===========================================================================*/
@@ -108,8 +139,60 @@ typedef enum {
   CAN_SLEEP = 5                             /**< Sleep state.               */
 } canstate_t;
 
+#if (CAN_USE_RX_RING == TRUE) || defined(__DOXYGEN__)
+/**
+ * @brief   Type of a time stamped received frame.
+ */
+typedef struct hal_can_rx_stamped_frame CANRxStampedFrame;
+
+/**
+ * @brief   @p CANDriver fields related to the software RX ring.
+ * @note    Low level drivers must include this macro in their driver
+ *          structure, before the end of the mandatory fields.
+ */
+#define _can_rx_ring_data                                                   \
+  /* Ring buffer, @p NULL if the ring is not active.*/                      \
+  CANRxStampedFrame         *rxring;                                        \
+  /* Ring size minus one.*/                                                 \
+  size_t                    rxring_mask;                                    \
+  /* Free running write index, only written by the ISR.*/                   \
+  volatile size_t           rxring_wridx;                                   \
+  /* Free running read index, only written by readers.*/                    \
+  volatile size_t           rxring_rdidx;                                   \
+  /* Frames lost because the ring was full.*/                               \
+  uint32_t                  rxring_overruns;                                \
+  /* Frames discarded by the software acceptance filter.*/                  \
+  uint32_t                  rxfilter_rejects;                               \
+  /* Number of identifiers in the software acceptance filter.*/             \
+  size_t                    rxfilter_count;                                 \
+  /* Software acceptance filter hash table.*/                               \
+  uint32_t                  rxfilter[CAN_RX_FILTER_SIZE];
+#else
+#define _can_rx_ring_data
+#endif
+
 #include "hal_can_lld.h"
 
+#if (CAN_USE_RX_RING == TRUE) || defined(__DOXYGEN__)
+#if !defined(can_lld_get_rx_id)
+#error "CAN_USE_RX_RING not supported by the CAN low level driver"
+#endif
+
+/**
+ * @brief   Time stamped received frame.
+ */
+struct hal_can_rx_stamped_frame {
+  /**
+   * @brief   System time of the frame transfer into the ring.
+   */
+  systime_t                 timestamp;
+  /**
+   * @brief   Received frame.
+   */
+  CANRxFrame                frame;
+};
+#endif
+
 /*===========================================================================*/
 /* Driver macros.                                                            */
 /*===========================================================================*/
@@ -144,6 +227,19 @@ typedef enum {
  * @name    Low level driver helper macros
  * @{
  */
+#if (CAN_USE_RX_RING == TRUE) || defined(__DOXYGEN__)
+/**
+ * @brief   Moves the received frames into the RX ring, if active.
+ *
+ * @return              The notification status.
+ * @retval false        if the received frames have been discarded.
+ * @retval true         if waiting threads must be notified.
+ */
+#define _can_rx_ring_isr(canp) _can_rx_ring_serve_isr(canp)
+#else
+#define _can_rx_ring_isr(canp) true
+#endif
+
 #if (CAN_ENFORCE_USE_CALLBACKS == FALSE) || defined(__DOXYGEN__)
 /**
  * @brief   TX mailbox empty event.
@@ -159,10 +255,12 @@ typedef enum {
  * @brief   RX mailbox empty full event.
  */
 #define _can_rx_full_isr(canp, flags) {                                     \
-  osalSysLockFromISR();                                                     \
-  osalThreadDequeueAllI(&(canp)->rxqueue, MSG_OK);                          \
-  osalEventBroadcastFlagsI(&(canp)->rxfull_event, flags);                   \
-  osalSysUnlockFromISR();                                                   \
+  if (_can_rx_ring_isr(canp)) {                                             \
+    osalSysLockFromISR();                                                   \
+    osalThreadDequeueAllI(&(canp)->rxqueue, MSG_OK);                        \
+    osalEventBroadcastFlagsI(&(canp)->rxfull_event, flags);                 \
+    osalSysUnlockFromISR();                                                 \
+  }                                                                         \
 }
 
 /**
@@ -193,12 +291,14 @@ typedef enum {
 }
 
 #define _can_rx_full_isr(canp, flags) {                                     \
-  if ((canp)->rxfull_cb != NULL) {                                          \
-    (canp)->rxfull_cb(canp, flags);                                         \
+  if (_can_rx_ring_isr(canp)) {                                             \
+    if ((canp)->rxfull_cb != NULL) {                                        \
+      (canp)->rxfull_cb(canp, flags);                                       \
+    }                                                                       \
+    osalSysLockFromISR();                                                   \
+    osalThreadDequeueAllI(&(canp)->rxqueue, MSG_OK);                        \
+    osalSysUnlockFromISR();                                                 \
   }                                                                         \
-  osalSysLockFromISR();                                                     \
-  osalThreadDequeueAllI(&(canp)->rxqueue, MSG_OK);                          \
-  osalSysUnlockFromISR();                                                   \
 }
 
 #define _can_wakeup_isr(canp) {                                             \
@@ -246,6 +346,17 @@ extern "C" {
   void canSleep(CANDriver *canp);
   void canWakeup(CANDriver *canp);
 #endif
+#if CAN_USE_RX_RING == TRUE
+  void canRxRingStart(CANDriver *canp, CANRxStampedFrame *buf, size_t n);
+  void canRxRingStop(CANDriver *canp);
+  bool canRxFilterAdd(CANDriver *canp, uint32_t id);
+  void canRxFilterClear(CANDriver *canp);
+  size_t canReceiveMany(CANDriver *canp,
+                        CANRxStampedFrame *csfp,
+                        size_t n,
+                        sysinterval_t timeout);
+  bool _can_rx_ring_serve_isr(CANDriver *canp);
+#endif
 #ifdef __cplusplus
 }
 #endif
@@ -65,6 +65,27 @@
 #if !defined(MMC_USE_MUTUAL_EXCLUSION) || defined(__DOXYGEN__)
 #define MMC_USE_MUTUAL_EXCLUSION        TRUE
 #endif
+
+/**
+ * @brief   Data blocks CRC.
+ * @details If enabled the CRC checking is activated on the card, the
+ *          CRC-16 of data blocks is sent on writes and verified on reads.
+ */
+#if !defined(MMC_USE_DATA_CRC) || defined(__DOXYGEN__)
+#define MMC_USE_DATA_CRC                FALSE
+#endif
+
+/**
+ * @brief   Pipelined multi-block transfers.
+ * @details If enabled the multi-block transfers performed through the
+ *          block device interface overlap the data transfer of a block
+ *          with the CRC handling of the adjacent block, the CRC and the
+ *          following token or response are also exchanged in a single
+ *          SPI transfer.
+ */
+#if !defined(MMC_USE_PIPELINING) || defined(__DOXYGEN__)
+#define MMC_USE_PIPELINING              FALSE
+#endif
 /** @} */
 
 /*===========================================================================*/
@@ -44,7 +44,13 @@
 /**
  * @brief   Serial over USB buffers size.
  * @details Configuration parameter, the buffer size must be a multiple of
- *          the USB data endpoint maximum packet size.
+ *          the USB data endpoints maximum packet size.<br>
+ *          Each buffer is moved by a single multi-packet transfer, a
+ *          transfer ending with a full packet is followed by a zero
+ *          length packet. Buffers spanning several packets reduce the
+ *          number of transfers restarted by the driver, which limits the
+ *          throughput on high speed ports, 2048 or 4096 bytes are
+ *          suggested for 512 bytes endpoints.
  * @note    The default is 256 bytes for both the transmission and receive
  *          buffers.
  */
@@ -166,6 +172,67 @@ struct SerialUSBDriver {
 /* Driver macros.                                                            */
 /*===========================================================================*/
 
+/**
+ * @name    Zero-copy access macros
+ * @{
+ */
+/**
+ * @brief   Gets a transmit area in place.
+ * @details The free space of the current output buffer is returned, data
+ *          written there is transmitted after @p sduCommitTransmitArea().
+ *
+ * @param[in] sdup      pointer to a @p SerialUSBDriver object
+ * @param[out] sizep    pointer to the size of the returned area
+ * @param[in] timeout   the number of ticks before the operation timeouts
+ * @return              A pointer to the free area.
+ * @retval NULL         if the specified time expired or the driver has
+ *                      been disconnected.
+ *
+ * @api
+ */
+#define sduGetTransmitAreaTimeout(sdup, sizep, timeout)                     \
+  obqGetWriteAreaTimeout(&(sdup)->obqueue, sizep, timeout)
+
+/**
+ * @brief   Commits data written in a transmit area.
+ *
+ * @param[in] sdup      pointer to a @p SerialUSBDriver object
+ * @param[in] n         number of bytes written
+ *
+ * @api
+ */
+#define sduCommitTransmitArea(sdup, n)                                      \
+  obqCommitWriteArea(&(sdup)->obqueue, n)
+
+/**
+ * @brief   Gets a receive area in place.
+ * @details The unread data of the current input buffer is returned, the
+ *          area is returned to the driver using @p sduReleaseReceiveArea().
+ *
+ * @param[in] sdup      pointer to a @p SerialUSBDriver object
+ * @param[out] sizep    pointer to the size of the returned area
+ * @param[in] timeout   the number of ticks before the operation timeouts
+ * @return              A pointer to the data area.
+ * @retval NULL         if the specified time expired or the driver has
+ *                      been disconnected.
+ *
+ * @api
+ */
+#define sduGetReceiveAreaTimeout(sdup, sizep, timeout)                      \
+  ibqGetReadAreaTimeout(&(sdup)->ibqueue, sizep, timeout)
+
+/**
+ * @brief   Releases data consumed from a receive area.
+ *
+ * @param[in] sdup      pointer to a @p SerialUSBDriver object
+ * @param[in] n         number of bytes consumed
+ *
+ * @api
+ */
+#define sduReleaseReceiveArea(sdup, n)                                      \
+  ibqReleaseReadArea(&(sdup)->ibqueue, n)
+/** @} */
+
 /*===========================================================================*/
 /* External declarations.                                                    */
 /*===========================================================================*/
@@ -0,0 +1,158 @@
+/*
+    ChibiOS - Copyright (C) 2006..2018 Giovanni Di Sirio
+
+    Licensed under the Apache License, Version 2.0 (the "License");
+    you may not use this file except in compliance with the License.
+    You may obtain a copy of the License at
+
+        http://www.apache.org/licenses/LICENSE-2.0
+
+    Unless required by applicable law or agreed to in writing, software
+    distributed under the License is distributed on an "AS IS" BASIS,
+    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+    See the License for the specific language governing permissions and
+    limitations under the License.
+*/
+
+/**
+ * @file    hal_spsc.h
+ * @brief   Lock-free SPSC rings macros and structures.
+ *
+ * @addtogroup HAL_SPSC
+ * @{
+ */
+
+#ifndef HAL_SPSC_H
+#define HAL_SPSC_H
+
+/*===========================================================================*/
+/* Driver constants.                                                         */
+/*===========================================================================*/
+
+/*===========================================================================*/
+/* Driver pre-compile time settings.                                         */
+/*===========================================================================*/
+
+/*===========================================================================*/
+/* Derived constants and error checks.                                       */
+/*===========================================================================*/
+
+/*===========================================================================*/
+/* Driver data structures and types.                                         */
+/*===========================================================================*/
+
+/**
+ * @brief   Type of a lock-free single-producer single-consumer ring.
+ * @details The ring transfers fixed size elements between exactly one
+ *          producer and one consumer, each one can be a thread or an
+ *          interrupt handler. Each side owns one index and only reads the
+ *          other side index so the non-blocking operations do not enter
+ *          critical zones.<br>
+ *          The kernel is involved only when a thread has to wait because
+ *          the ring is empty or full.
+ */
+typedef struct {
+  /**
+   * @brief   Pointer to the ring buffer.
+   */
+  uint8_t                   *buffer;
+  /**
+   * @brief   Size of an element in bytes.
+   */
+  size_t                    esize;
+  /**
+   * @brief   Number of slots minus one, the number is a power of two.
+   */
+  size_t                    mask;
+  /**
+   * @brief   Free running write index, written by the producer only.
+   */
+  volatile size_t           wridx;
+  /**
+   * @brief   Free running read index, written by the consumer only.
+   */
+  volatile size_t           rdidx;
+  /**
+   * @brief   Elements awaited by the consumer, zero if not waiting.
+   */
+  volatile size_t           rdwanted;
+  /**
+   * @brief   Free slots awaited by the producer, zero if not waiting.
+   */
+  volatile size_t           wrwanted;
+  /**
+   * @brief   Waiting consumer thread.
+   */
+  thread_reference_t        rdthread;
+  /**
+   * @brief   Waiting producer thread.
+   */
+  thread_reference_t        wrthread;
+} spsc_ring_t;
+
+/*===========================================================================*/
+/* Driver macros.                                                            */
+/*===========================================================================*/
+
+/**
+ * @name    Macro Functions
+ * @{
+ */
+/**
+ * @brief   Returns the ring size in elements.
+ *
+ * @param[in] rp        pointer to a @p spsc_ring_t structure
+ * @return              The ring size.
+ *
+ * @xclass
+ */
+#define spscGetSizeX(rp) ((rp)->mask + 1U)
+
+/**
+ * @brief   Returns the number of elements in the ring.
+ * @note    The value is exact only if called by the consumer or by the
+ *          producer, else it is a snapshot.
+ *
+ * @param[in] rp        pointer to a @p spsc_ring_t structure
+ * @return              The number of elements in the ring.
+ *
+ * @xclass
+ */
+#define spscGetUsedX(rp) ((size_t)((rp)->wridx - (rp)->rdidx))
+
+/**
+ * @brief   Returns the number of free slots in the ring.
+ * @note    The value is exact only if called by the consumer or by the
+ *          producer, else it is a snapshot.
+ *
+ * @param[in] rp        pointer to a @p spsc_ring_t structure
+ * @return              The number of free slots in the ring.
+ *
+ * @xclass
+ */
+#define spscGetFreeX(rp) (spscGetSizeX(rp) - spscGetUsedX(rp))
+/** @} */
+
+/*===========================================================================*/
+/* External declarations.                                                    */
+/*===========================================================================*/
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+  void spscObjectInit(spsc_ring_t *rp, void *buffer, size_t esize, size_t n);
+  size_t spscWriteX(spsc_ring_t *rp, const void *bp, size_t n);
+  size_t spscReadX(spsc_ring_t *rp, void *bp, size_t n);
+  msg_t spscPutX(spsc_ring_t *rp, uint8_t b);
+  msg_t spscGetX(spsc_ring_t *rp);
+  size_t spscWriteTimeout(spsc_ring_t *rp, const void *bp,
+                          size_t n, sysinterval_t timeout);
+  size_t spscReadTimeout(spsc_ring_t *rp, void *bp,
+                         size_t n, sysinterval_t timeout);
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* HAL_SPSC_H */
+
+/** @} */
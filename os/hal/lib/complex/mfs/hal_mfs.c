@@ -28,7 +28,11 @@
  *          divided in writable pages.<br>
  *          The module handles flash wear leveling and recovery of damaged
  *          banks (where possible) caused by power loss during operations.
- *          Both operations are transparent to the user.
+ *          Both operations are transparent to the user.<br>
+ *          Optionally the partition can be composed of more than two banks,
+ *          see @p MFS_CFG_BANKS_NUM, then it is handled as a log and the
+ *          garbage collection only copies the live records of the bank
+ *          chosen as victim instead of the whole storage content.
  *
  * @addtogroup HAL_MFS
  * @{
@@ -147,15 +151,134 @@ static void mfs_state_reset(MFSDriver *mfsp) {
     mfsp->descriptors[i].offset = 0U;
     mfsp->descriptors[i].size   = 0U;
   }
+
+#if MFS_CFG_BANKS_NUM > 2
+  if (mfsp->config != NULL) {
+    for (i = 0; i < MFS_CFG_BANKS_NUM; i++) {
+      mfsp->banks[i].offset  = flashGetSectorOffset(mfsp->config->flashp,
+                                                    mfsp->config->banks_start +
+                                                    ((flash_sector_t)i *
+                                                     mfsp->config->bank_sectors));
+      mfsp->banks[i].counter = 0U;
+      mfsp->banks[i].live    = 0U;
+      mfsp->banks[i].damaged = false;
+    }
+  }
+  mfsp->erased_banks = 0U;
+  for (i = 0; i < MFS_CFG_MAX_RECORDS; i++) {
+    mfsp->stale[i] = 0U;
+  }
+#endif
+}
+
+/**
+ * @brief   Returns the sectors range of a bank.
+ *
+ * @param[in] mfsp      pointer to the @p MFSDriver object
+ * @param[in] bank      the bank identifier
+ * @param[out] startp   first sector of the bank
+ * @param[out] np       number of sectors of the bank
+ *
+ * @notapi
+ */
+static void mfs_bank_get_sectors(MFSDriver *mfsp, mfs_bank_t bank,
+                                 flash_sector_t *startp,
+                                 flash_sector_t *np) {
+
+#if MFS_CFG_BANKS_NUM == 2
+  if (bank == MFS_BANK_0) {
+    *startp = mfsp->config->bank0_start;
+    *np     = mfsp->config->bank0_sectors;
+  }
+  else {
+    *startp = mfsp->config->bank1_start;
+    *np     = mfsp->config->bank1_sectors;
+  }
+#else
+  *startp = mfsp->config->banks_start +
+            ((flash_sector_t)bank * mfsp->config->bank_sectors);
+  *np     = mfsp->config->bank_sectors;
+#endif
 }
 
 static flash_offset_t mfs_flash_get_bank_offset(MFSDriver *mfsp,
                                                 mfs_bank_t bank) {
 
+#if MFS_CFG_BANKS_NUM == 2
   return bank == MFS_BANK_0 ? flashGetSectorOffset(mfsp->config->flashp,
                                                    mfsp->config->bank0_start) :
                               flashGetSectorOffset(mfsp->config->flashp,
                                                    mfsp->config->bank1_start);
+#else
+  return mfsp->banks[bank].offset;
+#endif
+}
+
+#if (MFS_CFG_BANKS_NUM > 2) || defined(__DOXYGEN__)
+/**
+ * @brief   Returns the bank containing a flash offset.
+ *
+ * @param[in] mfsp      pointer to the @p MFSDriver object
+ * @param[in] offset    flash offset within the partition
+ * @return              The bank index.
+ *
+ * @notapi
+ */
+static unsigned mfs_bank_of(MFSDriver *mfsp, flash_offset_t offset) {
+  unsigned i;
+
+  for (i = 0U; i < MFS_CFG_BANKS_NUM - 1U; i++) {
+    if (offset - mfsp->banks[i].offset < mfsp->config->bank_size) {
+      break;
+    }
+  }
+
+  return i;
+}
+#endif
+
+/**
+ * @brief   Updates the descriptor of a record with a new instance.
+ * @details The space accounting is updated, a zero size means that the new
+ *          instance is an erase marker.
+ *
+ * @param[in] mfsp      pointer to the @p MFSDriver object
+ * @param[in] id        record numeric identifier
+ * @param[in] offset    offset of the new instance header
+ * @param[in] size      size of the new instance data
+ *
+ * @notapi
+ */
+static void mfs_record_update(MFSDriver *mfsp, mfs_id_t id,
+                              flash_offset_t offset, uint32_t size) {
+  mfs_record_descriptor_t *dp = &mfsp->descriptors[id - 1U];
+
+  /* The size of the old record instance, if present, must be subtracted
+     to the total used size.*/
+  if (dp->offset != 0U) {
+    mfsp->used_space -= ALIGNED_REC_SIZE(dp->size);
+#if MFS_CFG_BANKS_NUM > 2
+    mfsp->banks[mfs_bank_of(mfsp, dp->offset)].live -= ALIGNED_REC_SIZE(dp->size);
+    mfsp->stale[id - 1U]++;
+#endif
+  }
+
+#if MFS_CFG_BANKS_NUM == 2
+  /* Erase markers are not tracked, the record simply disappears.*/
+  if (size == 0U) {
+    dp->offset = 0U;
+    dp->size   = 0U;
+    return;
+  }
+#else
+  /* Erase markers are tracked because older instances could still be
+     present in other banks.*/
+  mfsp->banks[mfs_bank_of(mfsp, offset)].live += ALIGNED_REC_SIZE(size);
+#endif
+
+  dp->offset = offset;
+  dp->size   = size;
+  mfsp->used_space += ALIGNED_REC_SIZE(size);
 }
 
 /**
@@ -279,14 +402,8 @@ static mfs_error_t mfs_flash_copy(MFSDriver *mfsp,
 static mfs_error_t mfs_bank_erase(MFSDriver *mfsp, mfs_bank_t bank) {
   flash_sector_t sector, end;
 
-  if (bank == MFS_BANK_0) {
-    sector = mfsp->config->bank0_start;
-    end    = mfsp->config->bank0_start + mfsp->config->bank0_sectors;
-  }
-  else {
-    sector = mfsp->config->bank1_start;
-    end    = mfsp->config->bank1_start + mfsp->config->bank1_sectors;
-  }
+  mfs_bank_get_sectors(mfsp, bank, &sector, &end);
+  end += sector;
 
   while (sector < end) {
     flash_error_t ferr;
@@ -325,14 +442,8 @@ static mfs_error_t mfs_bank_erase(MFSDriver *mfsp, mfs_bank_t bank) {
 static mfs_error_t mfs_bank_verify_erase(MFSDriver *mfsp, mfs_bank_t bank) {
   flash_sector_t sector, end;
 
-  if (bank == MFS_BANK_0) {
-    sector = mfsp->config->bank0_start;
-    end    = mfsp->config->bank0_start + mfsp->config->bank0_sectors;
-  }
-  else {
-    sector = mfsp->config->bank1_start;
-    end    = mfsp->config->bank1_start + mfsp->config->bank1_sectors;
-  }
+  mfs_bank_get_sectors(mfsp, bank, &sector, &end);
+  end += sector;
 
   while (sector < end) {
     flash_error_t ferr;
@@ -365,15 +476,6 @@ static mfs_error_t mfs_bank_verify_erase(MFSDriver *mfsp, mfs_bank_t bank) {
 static mfs_error_t mfs_bank_write_header(MFSDriver *mfsp,
                                          mfs_bank_t bank,
                                          uint32_t cnt) {
-  flash_sector_t sector;
-
-  if (bank == MFS_BANK_0) {
-    sector = mfsp->config->bank0_start;
-  }
-  else {
-    sector = mfsp->config->bank1_start;
-  }
-
   mfsp->ncbuf->bhdr.fields.magic1    = MFS_BANK_MAGIC_1;
   mfsp->ncbuf->bhdr.fields.magic2    = MFS_BANK_MAGIC_2;
   mfsp->ncbuf->bhdr.fields.counter   = cnt;
@@ -383,7 +485,7 @@ static mfs_error_t mfs_bank_write_header(MFSDriver *mfsp,
                                              sizeof (mfs_bank_header_t) - sizeof (uint16_t));
 
   return mfs_flash_write(mfsp,
-                         flashGetSectorOffset(mfsp->config->flashp, sector),
+                         mfs_flash_get_bank_offset(mfsp, bank),
                          sizeof (mfs_bank_header_t),
                          mfsp->ncbuf->bhdr.hdr8);
 }
@@ -424,6 +526,44 @@ static mfs_bank_state_t mfs_bank_check_header(MFSDriver *mfsp) {
   return MFS_BANK_OK;
 }
 
+/**
+ * @brief   Calculates the CRC of the data of a record.
+ * @note    The shared buffer is overwritten.
+ *
+ * @param[in] mfsp      pointer to the @p MFSDriver object
+ * @param[in] hdr_offset offset of the record header
+ * @param[in] size      size of the record data
+ * @param[out] crcp     the calculated CRC
+ * @return              The operation status.
+ *
+ * @notapi
+ */
+static mfs_error_t mfs_record_get_crc(MFSDriver *mfsp,
+                                      flash_offset_t hdr_offset,
+                                      uint32_t size,
+                                      uint16_t *crcp) {
+  flash_offset_t data = hdr_offset + sizeof (mfs_data_header_t);
+  uint16_t crc = 0xFFFFU;
+
+  /* We need to perform it in chunks because we have a limited buffer.*/
+  while (size > 0U) {
+    uint32_t chunk = size > MFS_CFG_BUFFER_SIZE ? MFS_CFG_BUFFER_SIZE : size;
+
+    /* Reading the data chunk.*/
+    RET_ON_ERROR(mfs_flash_read(mfsp, data, chunk, mfsp->ncbuf->data8));
+
+    /* CRC on the read data chunk.*/
+    crc = crc16(crc, &mfsp->ncbuf->data8[0], chunk);
+
+    /* Next chunk.*/
+    data += chunk;
+    size -= chunk;
+  }
+  *crcp = crc;
+
+  return MFS_NO_ERROR;
+}
+
 /**
  * @brief   Scans blocks searching for records.
  * @note    The block integrity is strongly checked.
@@ -451,7 +591,7 @@ static mfs_error_t mfs_bank_scan_records(MFSDriver *mfsp,
 
   /* Scanning records until there is there is not enough space left for an
      header.*/
-  while (hdr_offset < end_offset - ALIGNED_DHDR_SIZE) {
+  while (hdr_offset <= end_offset - ALIGNED_DHDR_SIZE) {
     mfs_data_header_t dhdr;
     uint16_t crc;
 
@@ -480,28 +620,8 @@ static mfs_error_t mfs_bank_scan_records(MFSDriver *mfsp,
     /* Copying the non-cached buffer locally.*/
     dhdr = mfsp->ncbuf->dhdr;
 
-    /* Finally checking the CRC, we need to perform it in chunks because
-       we have a limited buffer.*/
-    crc = 0xFFFFU;
-    if (dhdr.fields.size > 0U) {
-      flash_offset_t data = hdr_offset + sizeof (mfs_data_header_t);
-      uint32_t total = dhdr.fields.size;
-
-      while (total > 0U) {
-        uint32_t chunk = total > MFS_CFG_BUFFER_SIZE ? MFS_CFG_BUFFER_SIZE :
-                                                       total;
-
-        /* Reading the data chunk.*/
-        RET_ON_ERROR(mfs_flash_read(mfsp, data, chunk, mfsp->ncbuf->data8));
-
-        /* CRC on the read data chunk.*/
-        crc = crc16(crc, &mfsp->ncbuf->data8[0], chunk);
-
-        /* Next chunk.*/
-        data  += chunk;
-        total -= chunk;
-      }
-    }
+    /* Finally checking the CRC.*/
+    RET_ON_ERROR(mfs_record_get_crc(mfsp, hdr_offset, dhdr.fields.size, &crc));
     if (crc != dhdr.fields.crc) {
       /* If the CRC is invalid then this record is ignored but scanning
          continues because there could be more valid records afterward.*/
@@ -509,14 +629,7 @@ static mfs_error_t mfs_bank_scan_records(MFSDriver *mfsp,
     }
     else {
       /* Zero-sized records are erase markers.*/
-      if (dhdr.fields.size == 0U) {
-        mfsp->descriptors[dhdr.fields.id - 1U].offset = 0U;
-        mfsp->descriptors[dhdr.fields.id - 1U].size   = 0U;
-      }
-      else {
-        mfsp->descriptors[dhdr.fields.id - 1U].offset = hdr_offset;
-        mfsp->descriptors[dhdr.fields.id - 1U].size   = dhdr.fields.size;
-      }
+      mfs_record_update(mfsp, dhdr.fields.id, hdr_offset, dhdr.fields.size);
     }
 
     /* On the next header.*/
@@ -575,6 +688,7 @@ static mfs_error_t mfs_bank_get_state(MFSDriver *mfsp,
   return MFS_NO_ERROR;
 }
 
+#if (MFS_CFG_BANKS_NUM == 2) || defined(__DOXYGEN__)
 /**
  * @brief   Enforces a garbage collection.
  * @details Storage data is compacted into a single bank.
@@ -765,6 +879,455 @@ static mfs_error_t mfs_try_mount(MFSDriver *mfsp) {
 
   return (w1 || w2) ? MFS_WARN_REPAIR : MFS_NO_ERROR;
 }
+#else /* MFS_CFG_BANKS_NUM > 2 */
+/**
+ * @brief   Searches for an erased bank.
+ * @details Banks are used in circular order starting after the current
+ *          bank, this spreads wearing over all banks.
+ *
+ * @param[in] mfsp      pointer to the @p MFSDriver object
+ * @return              The bank index.
+ * @retval MFS_CFG_BANKS_NUM if there are no erased banks.
+ *
+ * @notapi
+ */
+static unsigned mfs_bank_find_erased(MFSDriver *mfsp) {
+  unsigned i, bank;
+
+  bank = (unsigned)mfsp->current_bank;
+  for (i = 0U; i < MFS_CFG_BANKS_NUM; i++) {
+    bank = (bank + 1U) % MFS_CFG_BANKS_NUM;
+    if (mfsp->banks[bank].counter == 0U) {
+      return bank;
+    }
+  }
+
+  return MFS_CFG_BANKS_NUM;
+}
+
+/**
+ * @brief   Makes an erased bank the current bank.
+ *
+ * @param[in] mfsp      pointer to the @p MFSDriver object
+ * @param[in] bank      the erased bank index
+ * @param[in] offset    next free position in the bank, records could have
+ *                      already been written in the bank
+ * @return              The operation status.
+ *
+ * @notapi
+ */
+static mfs_error_t mfs_bank_open(MFSDriver *mfsp, unsigned bank,
+                                 flash_offset_t offset) {
+
+  mfsp->current_counter += 1U;
+  RET_ON_ERROR(mfs_bank_write_header(mfsp, (mfs_bank_t)bank,
+                                     mfsp->current_counter));
+
+  mfsp->banks[bank].counter = mfsp->current_counter;
+  mfsp->erased_banks--;
+  mfsp->current_bank = (mfs_bank_t)bank;
+  mfsp->next_offset  = offset;
+
+  return MFS_NO_ERROR;
+}
+
+/**
+ * @brief   Selects the bank to be reclaimed.
+ * @details Damaged banks are always reclaimed first, the current bank is
+ *          never selected.
+ *
+ * @param[in] mfsp      pointer to the @p MFSDriver object
+ * @return              The bank index.
+ * @retval MFS_CFG_BANKS_NUM if there is nothing to be reclaimed.
+ *
+ * @notapi
+ */
+static unsigned mfs_bank_select_victim(MFSDriver *mfsp) {
+  flash_offset_t dsize;
+  uint64_t best_score;
+  unsigned i, best;
+
+  /* Bank data area size.*/
+  dsize = mfsp->config->bank_size -
+          (flash_offset_t)ALIGNED_SIZEOF(mfs_bank_header_t);
+
+  best       = MFS_CFG_BANKS_NUM;
+  best_score = 0U;
+  for (i = 0U; i < MFS_CFG_BANKS_NUM; i++) {
+    mfs_bank_status_t *bsp = &mfsp->banks[i];
+    uint64_t score;
+
+    if ((i == (unsigned)mfsp->current_bank) || (bsp->counter == 0U)) {
+      continue;
+    }
+    if (bsp->damaged) {
+      return i;
+    }
+    if (bsp->live >= dsize) {
+      continue;
+    }
+
+#if MFS_CFG_GC_POLICY == MFS_GC_GREEDY
+    score = (uint64_t)(dsize - bsp->live);
+#else
+    {
+      /* Cost-benefit, the reclaimed space is weighted by the age of the
+         bank and divided by the cost of reading and copying the live data.
+         The age is saturated in order to not overflow.*/
+      uint32_t age = (mfsp->current_counter - bsp->counter) + 1U;
+
+      if (age > 0xFFFFU) {
+        age = 0xFFFFU;
+      }
+      score = ((uint64_t)(dsize - bsp->live) * age * 256U) /
+              ((uint64_t)dsize + bsp->live);
+    }
+#endif
+    if (score > best_score) {
+      best       = i;
+      best_score = score;
+    }
+  }
+
+  return best;
+}
+
+/**
+ * @brief   Reclaims a bank.
+ * @details The live records in the victim bank are copied in the
+ *          destination bank then the victim bank is erased. Erase markers
+ *          are dropped if there are no older instances left in flash.<br>
+ *          If the destination bank is erased then its header is written
+ *          after the data and it becomes the current bank, an interrupted
+ *          operation leaves a bank without a valid header that is simply
+ *          erased on the next mount. If the destination is the current bank
+ *          then there is always an erased bank available for repair.
+ *
+ * @param[in] mfsp      pointer to the @p MFSDriver object
+ * @param[in] victim    the bank to be reclaimed
+ * @param[in] dest      the destination bank, erased or the current bank
+ * @return              The operation status.
+ *
+ * @notapi
+ */
+static mfs_error_t mfs_bank_reclaim(MFSDriver *mfsp, unsigned victim,
+                                    unsigned dest) {
+  uint16_t vstale[MFS_CFG_MAX_RECORDS];
+  flash_offset_t start_offset, hdr_offset, end_offset, dest_offset;
+  unsigned i;
+
+  start_offset = mfsp->banks[victim].offset;
+  end_offset   = start_offset + mfsp->config->bank_size;
+  if (mfsp->banks[dest].counter == 0U) {
+    dest_offset = mfsp->banks[dest].offset +
+                  (flash_offset_t)ALIGNED_SIZEOF(mfs_bank_header_t);
+  }
+  else {
+    dest_offset = mfsp->next_offset;
+  }
+
+  /* Counting the obsolete instances in the victim bank, the records
+     integrity has already been verified on mount.*/
+  for (i = 0U; i < MFS_CFG_MAX_RECORDS; i++) {
+    vstale[i] = 0U;
+  }
+  hdr_offset = start_offset + (flash_offset_t)ALIGNED_SIZEOF(mfs_bank_header_t);
+  while (hdr_offset <= end_offset - ALIGNED_DHDR_SIZE) {
+    mfs_data_header_t dhdr;
+
+    RET_ON_ERROR(mfs_flash_read(mfsp, hdr_offset,
+                                sizeof (mfs_data_header_t),
+                                mfsp->ncbuf->data8));
+
+    /* Stopping on erased or unfinished headers.*/
+    dhdr = mfsp->ncbuf->dhdr;
+    if ((dhdr.fields.magic1 != MFS_HEADER_MAGIC_1) ||
+        (dhdr.fields.magic2 != MFS_HEADER_MAGIC_2) ||
+        (dhdr.fields.id < 1U) ||
+        (dhdr.fields.id > (uint32_t)MFS_CFG_MAX_RECORDS) ||
+        (dhdr.fields.size > end_offset - hdr_offset)) {
+      break;
+    }
+
+    if (mfsp->descriptors[dhdr.fields.id - 1U].offset != hdr_offset) {
+      bool valid = true;
+
+      /* Records with invalid CRC have been ignored by the mount scan, those
+         are not accounted as obsolete instances.*/
+      if (mfsp->banks[victim].damaged) {
+        uint16_t crc;
+
+        RET_ON_ERROR(mfs_record_get_crc(mfsp, hdr_offset, dhdr.fields.size,
+                                        &crc));
+        valid = crc == dhdr.fields.crc;
+      }
+      if (valid) {
+        vstale[dhdr.fields.id - 1U]++;
+      }
+    }
+
+    hdr_offset += ALIGNED_REC_SIZE(dhdr.fields.size);
+  }
+
+  /* Copying the most recent record instances only.*/
+  for (i = 0U; i < MFS_CFG_MAX_RECORDS; i++) {
+    flash_offset_t offset = mfsp->descriptors[i].offset;
+    uint32_t totsize = ALIGNED_REC_SIZE(mfsp->descriptors[i].size);
+
+    if ((offset == 0U) || (offset - start_offset >= mfsp->config->bank_size)) {
+      continue;
+    }
+
+    mfsp->banks[victim].live -= totsize;
+    if ((mfsp->descriptors[i].size == 0U) && (mfsp->stale[i] == vstale[i])) {
+      /* Erase marker with no older instances left, dropped.*/
+      mfsp->used_space -= totsize;
+      mfsp->descriptors[i].offset = 0U;
+    }
+    else {
+      RET_ON_ERROR(mfs_flash_copy(mfsp, dest_offset, offset, totsize));
+      mfsp->banks[dest].live     += totsize;
+      mfsp->descriptors[i].offset = dest_offset;
+      dest_offset += totsize;
+    }
+    mfsp->stale[i] -= vstale[i];
+  }
+
+  /* The header is written after the data.*/
+  if (mfsp->banks[dest].counter == 0U) {
+    RET_ON_ERROR(mfs_bank_open(mfsp, dest, dest_offset));
+  }
+  else {
+    mfsp->next_offset = dest_offset;
+  }
+
+  /* The victim bank is erased last.*/
+  RET_ON_ERROR(mfs_bank_erase(mfsp, (mfs_bank_t)victim));
+  mfsp->banks[victim].counter = 0U;
+  mfsp->banks[victim].live    = 0U;
+  mfsp->banks[victim].damaged = false;
+  mfsp->erased_banks++;
+
+  return MFS_NO_ERROR;
+}
+
+/**
+ * @brief   Enforces a garbage collection.
+ * @details The bank selected by the policy is reclaimed. Its live data is
+ *          appended to the current bank if it fits, else it is moved in an
+ *          erased bank which becomes the current bank.
+ *
+ * @param[out] mfsp     pointer to the @p MFSDriver object
+ * @return              The operation status.
+ *
+ * @notapi
+ */
+static mfs_error_t mfs_garbage_collect(MFSDriver *mfsp) {
+  flash_offset_t free;
+  unsigned victim, dest;
+
+  victim = mfs_bank_select_victim(mfsp);
+  if (victim >= MFS_CFG_BANKS_NUM) {
+    return MFS_NO_ERROR;
+  }
+
+  free = (mfsp->banks[mfsp->current_bank].offset + mfsp->config->bank_size) -
+         mfsp->next_offset;
+  if (mfsp->banks[victim].live <= free) {
+    dest = (unsigned)mfsp->current_bank;
+  }
+  else {
+    dest = mfs_bank_find_erased(mfsp);
+    if (dest >= MFS_CFG_BANKS_NUM) {
+      return MFS_ERR_INTERNAL;
+    }
+  }
+
+  return mfs_bank_reclaim(mfsp, victim, dest);
+}
+
+/**
+ * @brief   Performs a flash partition mount attempt.
+ *
+ * @param[in] mfsp      pointer to the @p MFSDriver object
+ * @return              The operation status.
+ *
+ * @api
+ */
+static mfs_error_t mfs_try_mount(MFSDriver *mfsp) {
+  unsigned order[MFS_CFG_BANKS_NUM];
+  unsigned i, j, n;
+  bool w = false;
+
+  /* Resetting the banks state.*/
+  mfs_state_reset(mfsp);
+
+  /* Assessing the state of all banks, unreadable banks are erased.*/
+  n = 0U;
+  for (i = 0U; i < MFS_CFG_BANKS_NUM; i++) {
+    mfs_bank_state_t sts;
+    uint32_t cnt;
+
+    RET_ON_ERROR(mfs_bank_get_state(mfsp, (mfs_bank_t)i, &sts, &cnt));
+    if (sts == MFS_BANK_GARBAGE) {
+      RET_ON_ERROR(mfs_bank_erase(mfsp, (mfs_bank_t)i));
+      w = true;
+    }
+    else if (sts == MFS_BANK_OK) {
+      /* Ordering valid banks by counter, oldest first.*/
+      j = n++;
+      while ((j > 0U) && (mfsp->banks[order[j - 1U]].counter > cnt)) {
+        order[j] = order[j - 1U];
+        j--;
+      }
+      order[j] = i;
+      mfsp->banks[i].counter = cnt;
+      if (cnt > mfsp->current_counter) {
+        mfsp->current_counter = cnt;
+      }
+      continue;
+    }
+    mfsp->erased_banks++;
+  }
+
+  /* All banks erased, first initialization.*/
+  if (n == 0U) {
+    RET_ON_ERROR(mfs_bank_open(mfsp, 0U,
+                               mfsp->banks[0].offset +
+                               (flash_offset_t)ALIGNED_SIZEOF(mfs_bank_header_t)));
+    return w ? MFS_WARN_REPAIR : MFS_NO_ERROR;
+  }
+
+  /* Scanning for the most recent instance of all records, the newest bank
+     is scanned last and becomes the current bank.*/
+  for (i = 0U; i < n; i++) {
+    bool wscan;
+
+    RET_ON_ERROR(mfs_bank_scan_records(mfsp, (mfs_bank_t)order[i], &wscan));
+    if (wscan) {
+      mfsp->banks[order[i]].damaged = true;
+      w = true;
+    }
+  }
+  mfsp->current_bank = (mfs_bank_t)order[n - 1U];
+
+  /* Banks without live records are erased, this also completes reclaims
+     interrupted after writing the destination header.*/
+  for (i = 0U; i < n - 1U; i++) {
+    if (mfsp->banks[order[i]].live == 0U) {
+      RET_ON_ERROR(mfs_bank_reclaim(mfsp, order[i],
+                                    (unsigned)mfsp->current_bank));
+    }
+  }
+
+  /* Nothing can be appended after anomalies in the current bank, it is
+     moved in an erased bank.*/
+  if (mfsp->banks[mfsp->current_bank].damaged) {
+    unsigned dest = mfs_bank_find_erased(mfsp);
+
+    mfsp->next_offset = mfsp->banks[mfsp->current_bank].offset +
+                        mfsp->config->bank_size;
+    if (dest < MFS_CFG_BANKS_NUM) {
+      RET_ON_ERROR(mfs_bank_reclaim(mfsp, (unsigned)mfsp->current_bank,
+                                    dest));
+    }
+  }
+
+  return w ? MFS_WARN_REPAIR : MFS_NO_ERROR;
+}
+#endif /* MFS_CFG_BANKS_NUM > 2 */
+
+/**
+ * @brief   Returns the space available for records.
+ *
+ * @param[in] mfsp      pointer to the @p MFSDriver object
+ * @return              The free space without considering fragmentation.
+ *
+ * @notapi
+ */
+static flash_offset_t mfs_get_free_space(MFSDriver *mfsp) {
+
+#if MFS_CFG_BANKS_NUM == 2
+  return mfsp->config->bank_size - mfsp->used_space;
+#else
+  /* One bank is always kept erased for garbage collection and one is
+     accounted for the space lost at the end of the banks.*/
+  return ((MFS_CFG_BANKS_NUM - 2U) *
+          (mfsp->config->bank_size -
+           (flash_offset_t)ALIGNED_SIZEOF(mfs_bank_header_t))) -
+         mfsp->used_space;
+#endif
+}
+
+/**
+ * @brief   Makes contiguous space available in the current bank.
+ * @details A garbage collection is performed if the space is available but
+ *          it has to be freed.
+ *
+ * @param[in] mfsp      pointer to the @p MFSDriver object
+ * @param[in] rspace    required contiguous space
+ * @param[out] gcp      set to @p true if a garbage collection has been
+ *                      performed
+ * @return              The operation status.
+ *
+ * @notapi
+ */
+static mfs_error_t mfs_make_space(MFSDriver *mfsp, flash_offset_t rspace,
+                                  bool *gcp) {
+  flash_offset_t free;
+#if MFS_CFG_BANKS_NUM > 2
+  unsigned i;
+
+  /* Records larger than a bank cannot be stored.*/
+  if (rspace > mfsp->config->bank_size -
+               (flash_offset_t)ALIGNED_SIZEOF(mfs_bank_header_t)) {
+    return MFS_ERR_OUT_OF_MEM;
+  }
+
+  for (i = 0U; i < MFS_CFG_BANKS_NUM * 2U; i++) {
+    unsigned bank;
+
+    /* Checking for immediately available space.*/
+    free = (mfsp->banks[mfsp->current_bank].offset +
+            mfsp->config->bank_size) - mfsp->next_offset;
+    if (rspace <= free) {
+      return MFS_NO_ERROR;
+    }
+
+    /* Opening a new bank as long as one erased bank is left for garbage
+       collection, the remaining space in the current bank is lost until
+       the bank is reclaimed.*/
+    if (mfsp->erased_banks > 1U) {
+      bank = mfs_bank_find_erased(mfsp);
+      RET_ON_ERROR(mfs_bank_open(mfsp, bank,
+                                 mfsp->banks[bank].offset +
+                                 (flash_offset_t)ALIGNED_SIZEOF(mfs_bank_header_t)));
+      continue;
+    }
+
+    /* We need to perform a garbage collection.*/
+    *gcp = true;
+    if (mfs_bank_select_victim(mfsp) >= MFS_CFG_BANKS_NUM) {
+      break;
+    }
+    RET_ON_ERROR(mfs_garbage_collect(mfsp));
+  }
+
+  return MFS_ERR_OUT_OF_MEM;
+#else
+  /* Checking for immediately (not compacted) available space.*/
+  free = (mfs_flash_get_bank_offset(mfsp, mfsp->current_bank) +
+          mfsp->config->bank_size) - mfsp->next_offset;
+  if (rspace > free) {
+    /* We need to perform a garbage collection, there is enough space
+       but it has to be freed.*/
+    *gcp = true;
+    RET_ON_ERROR(mfs_garbage_collect(mfsp));
+  }
+
+  return MFS_NO_ERROR;
+#endif
+}
 
 /**
  * @brief   Configures and activates a MFS driver.
@@ -894,6 +1457,7 @@ void mfsStop(MFSDriver *mfsp) {
  * @api
  */
 mfs_error_t mfsErase(MFSDriver *mfsp) {
+  unsigned i;
 
   osalDbgCheck(mfsp != NULL);
 
@@ -901,8 +1465,9 @@ mfs_error_t mfsErase(MFSDriver *mfsp) {
     return MFS_ERR_INV_STATE;
   }
 
-  RET_ON_ERROR(mfs_bank_erase(mfsp, MFS_BANK_0));
-  RET_ON_ERROR(mfs_bank_erase(mfsp, MFS_BANK_1));
+  for (i = 0U; i < MFS_CFG_BANKS_NUM; i++) {
+    RET_ON_ERROR(mfs_bank_erase(mfsp, (mfs_bank_t)i));
+  }
 
   return mfs_mount(mfsp);
 }
@@ -944,7 +1509,7 @@ mfs_error_t mfsReadRecord(MFSDriver *mfsp, mfs_id_t id,
   }
 
   /* Checking if the requested record actually exists.*/
-  if (mfsp->descriptors[id - 1U].offset == 0U) {
+  if (mfsp->descriptors[id - 1U].size == 0U) {
     return MFS_ERR_NOT_FOUND;
   }
 
@@ -1006,7 +1571,7 @@ mfs_error_t mfsReadRecord(MFSDriver *mfsp, mfs_id_t id,
  */
 mfs_error_t mfsWriteRecord(MFSDriver *mfsp, mfs_id_t id,
                            size_t n, const uint8_t *buffer) {
-  flash_offset_t free, asize, rspace;
+  flash_offset_t asize, rspace;
 
   osalDbgCheck((mfsp != NULL) &&
                (id >= 1U) && (id <= (mfs_id_t)MFS_CFG_MAX_RECORDS) &&
@@ -1024,19 +1589,12 @@ mfs_error_t mfsWriteRecord(MFSDriver *mfsp, mfs_id_t id,
        NOTE: The space for one extra header is reserved in order to allow
        for an erase operation after the space has been fully allocated.*/
     rspace = ALIGNED_DHDR_SIZE + asize;
-    if (rspace > mfsp->config->bank_size - mfsp->used_space) {
+    if (rspace > mfs_get_free_space(mfsp)) {
       return MFS_ERR_OUT_OF_MEM;
     }
 
-    /* Checking for immediately (not compacted) available space.*/
-    free = (mfs_flash_get_bank_offset(mfsp, mfsp->current_bank) +
-            mfsp->config->bank_size) - mfsp->next_offset;
-    if (rspace > free) {
-      /* We need to perform a garbage collection, there is enough space
-         but it has to be freed.*/
-      warning = true;
-      RET_ON_ERROR(mfs_garbage_collect(mfsp));
-    }
+    /* Making the space immediately (not compacted) available.*/
+    RET_ON_ERROR(mfs_make_space(mfsp, rspace, &warning));
 
     /* Writing the data header without the magic, it will be written last.*/
     mfsp->ncbuf->dhdr.fields.id     = (uint16_t)id;
@@ -1061,17 +1619,9 @@ mfs_error_t mfsWriteRecord(MFSDriver *mfsp, mfs_id_t id,
                                  sizeof (uint32_t) * 2U,
                                  mfsp->ncbuf->data8));
 
-    /* The size of the old record instance, if present, must be subtracted
-       to the total used size.*/
-    if (mfsp->descriptors[id - 1U].offset != 0U) {
-      mfsp->used_space -= ALIGNED_REC_SIZE(mfsp->descriptors[id - 1U].size);
-    }
-
     /* Adjusting bank-related metadata.*/
-    mfsp->descriptors[id - 1U].offset = mfsp->next_offset;
-    mfsp->descriptors[id - 1U].size   = (uint32_t)n;
+    mfs_record_update(mfsp, id, mfsp->next_offset, (uint32_t)n);
     mfsp->next_offset += asize;
-    mfsp->used_space  += asize;
 
     return warning ? MFS_WARN_GC : MFS_NO_ERROR;
   }
@@ -1154,7 +1704,7 @@ mfs_error_t mfsWriteRecord(MFSDriver *mfsp, mfs_id_t id,
  * @api
  */
 mfs_error_t mfsEraseRecord(MFSDriver *mfsp, mfs_id_t id) {
-  flash_offset_t free, asize, rspace;
+  flash_offset_t asize, rspace;
 
   osalDbgCheck((mfsp != NULL) &&
                (id >= 1U) && (id <= (mfs_id_t)MFS_CFG_MAX_RECORDS));
@@ -1167,26 +1717,19 @@ mfs_error_t mfsEraseRecord(MFSDriver *mfsp, mfs_id_t id) {
     bool warning = false;
 
     /* Checking if the requested record actually exists.*/
-    if (mfsp->descriptors[id - 1U].offset == 0U) {
+    if (mfsp->descriptors[id - 1U].size == 0U) {
       return MFS_ERR_NOT_FOUND;
     }
 
     /* If the required space is beyond the available (compacted) block
        size then an internal error is returned, it should never happen.*/
     rspace = asize;
-    if (rspace > mfsp->config->bank_size - mfsp->used_space) {
+    if (rspace > mfs_get_free_space(mfsp)) {
       return MFS_ERR_INTERNAL;
     }
 
-    /* Checking for immediately (not compacted) available space.*/
-    free = (mfs_flash_get_bank_offset(mfsp, mfsp->current_bank) +
-            mfsp->config->bank_size) - mfsp->next_offset;
-    if (rspace > free) {
-      /* We need to perform a garbage collection, there is enough space
-         but it has to be freed.*/
-      warning = true;
-      RET_ON_ERROR(mfs_garbage_collect(mfsp));
-    }
+    /* Making the space immediately (not compacted) available.*/
+    RET_ON_ERROR(mfs_make_space(mfsp, rspace, &warning));
 
     /* Writing the data header with size set to zero, it means that the
        record is logically erased.*/
@@ -1201,10 +1744,8 @@ mfs_error_t mfsEraseRecord(MFSDriver *mfsp, mfs_id_t id) {
                                  mfsp->ncbuf->data8));
 
     /* Adjusting bank-related metadata.*/
-    mfsp->used_space  -= ALIGNED_REC_SIZE(mfsp->descriptors[id - 1U].size);
+    mfs_record_update(mfsp, id, mfsp->next_offset, 0U);
     mfsp->next_offset += sizeof (mfs_data_header_t);
-    mfsp->descriptors[id - 1U].offset = 0U;
-    mfsp->descriptors[id - 1U].size   = 0U;
 
     return warning ? MFS_WARN_GC : MFS_NO_ERROR;
   }
@@ -1215,7 +1756,7 @@ mfs_error_t mfsEraseRecord(MFSDriver *mfsp, mfs_id_t id) {
     mfs_transaction_op_t *top;
 
     /* Checking if the requested record actually exists.*/
-    if (mfsp->descriptors[id - 1U].offset == 0U) {
+    if (mfsp->descriptors[id - 1U].size == 0U) {
       return MFS_ERR_NOT_FOUND;
     }
 
@@ -1320,7 +1861,8 @@ mfs_error_t mfsPerformGarbageCollection(MFSDriver *mfsp) {
  * @api
  */
 mfs_error_t mfsStartTransaction(MFSDriver *mfsp, size_t size) {
-  flash_offset_t free, tspace, rspace;
+  flash_offset_t tspace, rspace;
+  bool warning = false;
 
   osalDbgCheck((mfsp != NULL) && (size > ALIGNED_DHDR_SIZE));
 
@@ -1335,18 +1877,12 @@ mfs_error_t mfsStartTransaction(MFSDriver *mfsp, size_t size) {
 
   /* If the required space is beyond the available (compacted) block
      size then an error is returned.*/
-  if (rspace > mfsp->config->bank_size - mfsp->used_space) {
+  if (rspace > mfs_get_free_space(mfsp)) {
     return MFS_ERR_OUT_OF_MEM;
   }
 
-  /* Checking for immediately (not compacted) available space.*/
-  free = (mfs_flash_get_bank_offset(mfsp, mfsp->current_bank) +
-          mfsp->config->bank_size) - mfsp->next_offset;
-  if (rspace > free) {
-    /* We need to perform a garbage collection, there is enough space
-       but it has to be freed.*/
-    RET_ON_ERROR(mfs_garbage_collect(mfsp));
-  }
+  /* Making the space immediately (not compacted) available.*/
+  RET_ON_ERROR(mfs_make_space(mfsp, rspace, &warning));
 
   /* Entering transaction mode.*/
   mfsp->state = MFS_TRANSACTION;
@@ -1404,29 +1940,9 @@ mfs_error_t mfsCommitTransaction(MFSDriver *mfsp) {
      magic number, now updating the internal state using the buffered data.*/
   mfsp->next_offset = mfsp->tr_next_offset;
   while (top < &mfsp->tr_ops[mfsp->tr_nops]) {
-    unsigned i = (unsigned)top->id - 1U;
 
-    /* The calculation is a bit different depending on write or erase record
-       operations.*/
-    if (top->size > 0U) {
-      /* It is a write.*/
-      if (mfsp->descriptors[i].offset != 0U) {
-        /* The size of the old record instance, if present, must be subtracted
-           to the total used size.*/
-        mfsp->used_space -= ALIGNED_REC_SIZE(mfsp->descriptors[i].size);
-      }
-
-      /* Adjusting bank-related metadata.*/
-      mfsp->used_space           += ALIGNED_REC_SIZE(top->size);
-      mfsp->descriptors[i].offset = top->offset;
-      mfsp->descriptors[i].size   = top->size;
-    }
-    else {
-      /* It is an erase.*/
-      mfsp->used_space           -= ALIGNED_REC_SIZE(mfsp->descriptors[i].size);
-      mfsp->descriptors[i].offset = 0U;
-      mfsp->descriptors[i].size   = 0U;
-    }
+    /* Adjusting bank-related metadata, a zero size is an erase.*/
+    mfs_record_update(mfsp, top->id, top->offset, (uint32_t)top->size);
 
     /* On the next element.*/
     top++;
@@ -1471,7 +1987,20 @@ mfs_error_t mfsRollbackTransaction(MFSDriver *mfsp) {
   /* If no operations have been performed then there is no need to perform
      a garbage collection.*/
   if (mfsp->tr_nops > 0U) {
+#if MFS_CFG_BANKS_NUM == 2
     err = mfs_garbage_collect(mfsp);
+#else
+    /* The current bank is moved in an erased bank, unfinished records are
+       left behind.*/
+    unsigned dest = mfs_bank_find_erased(mfsp);
+
+    if (dest < MFS_CFG_BANKS_NUM) {
+      err = mfs_bank_reclaim(mfsp, (unsigned)mfsp->current_bank, dest);
+    }
+    else {
+      err = MFS_ERR_INTERNAL;
+    }
+#endif
   }
   else {
     err = MFS_NO_ERROR;
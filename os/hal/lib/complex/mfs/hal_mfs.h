@@ -39,6 +39,22 @@
 #define MFS_HEADER_MAGIC_1                  0x5FAE45F0U
 #define MFS_HEADER_MAGIC_2                  0xF045AE5FU
 
+/**
+ * @name    Garbage collection policies
+ * @{
+ */
+/**
+ * @brief   The bank with most reclaimable space is compacted first.
+ */
+#define MFS_GC_GREEDY                       0
+/**
+ * @brief   Reclaimable space is weighted by the bank age.
+ * @details Banks holding cold data are preferred over banks holding data
+ *          that is likely to be invalidated soon anyway.
+ */
+#define MFS_GC_COST_BENEFIT                 1
+/** @} */
+
 /*===========================================================================*/
 /* Driver pre-compile time settings.                                         */
 /*===========================================================================*/
@@ -107,6 +123,28 @@
 #if !defined(MFS_CFG_TRANSACTION_MAX) || defined(__DOXYGEN__)
 #define MFS_CFG_TRANSACTION_MAX             16
 #endif
+
+/**
+ * @brief   Number of banks in the managed partition.
+ * @details With two banks all records are kept in a single bank and a
+ *          garbage collection copies all of them into the other bank.<br>
+ *          With more banks the partition is handled as a log: records are
+ *          appended to the current bank and, when space is required, only
+ *          the bank selected by @p MFS_CFG_GC_POLICY is compacted, banks
+ *          holding mostly obsolete data are reclaimed with little or no
+ *          copying. Two banks worth of space are reserved for this.
+ */
+#if !defined(MFS_CFG_BANKS_NUM) || defined(__DOXYGEN__)
+#define MFS_CFG_BANKS_NUM                   2
+#endif
+
+/**
+ * @brief   Garbage collection victim selection policy.
+ * @note    Only used when @p MFS_CFG_BANKS_NUM is greater than two.
+ */
+#if !defined(MFS_CFG_GC_POLICY) || defined(__DOXYGEN__)
+#define MFS_CFG_GC_POLICY                   MFS_GC_COST_BENEFIT
+#endif
 /** @} */
 
 /*===========================================================================*/
@@ -144,6 +182,15 @@
 #error "invalid MFS_CFG_TRANSACTION_MAX value"
 #endif
 
+#if (MFS_CFG_BANKS_NUM < 2) || (MFS_CFG_BANKS_NUM > 32)
+#error "invalid MFS_CFG_BANKS_NUM value"
+#endif
+
+#if (MFS_CFG_GC_POLICY != MFS_GC_GREEDY) &&                                 \
+    (MFS_CFG_GC_POLICY != MFS_GC_COST_BENEFIT)
+#error "invalid MFS_CFG_GC_POLICY value"
+#endif
+
 /*===========================================================================*/
 /* Driver data structures and types.                                         */
 /*===========================================================================*/
@@ -293,6 +340,7 @@ typedef struct {
    * @brief   Banks size.
    */
   flash_offset_t            bank_size;
+#if (MFS_CFG_BANKS_NUM == 2) || defined(__DOXYGEN__)
   /**
    * @brief   Base sector index for bank 0.
    */
@@ -313,8 +361,48 @@ typedef struct {
    *          @p bank_size.
    */
   flash_sector_t            bank1_sectors;
+#endif
+#if (MFS_CFG_BANKS_NUM > 2) || defined(__DOXYGEN__)
+  /**
+   * @brief   Base sector index for the first bank.
+   * @note    Banks are contiguous, bank @p i starts at sector
+   *          @p banks_start + @p i * @p bank_sectors.
+   */
+  flash_sector_t            banks_start;
+  /**
+   * @brief   Number of sectors for each bank.
+   * @note    The total size of the sectors of a bank must be greater or
+   *          equal to @p bank_size.
+   */
+  flash_sector_t            bank_sectors;
+#endif
 } MFSConfig;
 
+#if (MFS_CFG_BANKS_NUM > 2) || defined(__DOXYGEN__)
+/**
+ * @brief   Type of a bank status in a multi-bank partition.
+ */
+typedef struct {
+  /**
+   * @brief   Offset of the bank in the flash array.
+   */
+  flash_offset_t            offset;
+  /**
+   * @brief   Sequence counter of the bank.
+   * @note    Zero means that the bank is erased.
+   */
+  uint32_t                  counter;
+  /**
+   * @brief   Space taken by the records instances still in use.
+   */
+  flash_offset_t            live;
+  /**
+   * @brief   Anomalies have been found in the bank on mount.
+   */
+  bool                      damaged;
+} mfs_bank_status_t;
+#endif
+
 /**
  * @brief   Type of a buffered write/erase operation within a transaction.
  */
@@ -358,6 +446,8 @@ typedef struct {
   const MFSConfig           *config;
   /**
    * @brief   Bank currently in use.
+   * @note    In a multi-bank partition this is the index of the bank where
+   *          records are appended.
    */
   mfs_bank_t                current_bank;
   /**
@@ -370,13 +460,33 @@ typedef struct {
   flash_offset_t            next_offset;
   /**
    * @brief   Used space in the current bank without considering erased records.
+   * @note    In a multi-bank partition this is the space used in all banks,
+   *          the banks headers are not accounted.
    */
   flash_offset_t            used_space;
   /**
    * @brief   Offsets of the most recent instance of the records.
    * @note    Zero means that there is not a record with that id.
+   * @note    In a multi-bank partition erase markers are also tracked, those
+   *          have a non-zero offset and a zero size.
    */
   mfs_record_descriptor_t   descriptors[MFS_CFG_MAX_RECORDS];
+#if (MFS_CFG_BANKS_NUM > 2) || defined(__DOXYGEN__)
+  /**
+   * @brief   Banks status.
+   */
+  mfs_bank_status_t         banks[MFS_CFG_BANKS_NUM];
+  /**
+   * @brief   Number of banks in erased state.
+   */
+  unsigned                  erased_banks;
+  /**
+   * @brief   Number of obsolete instances of each record still in flash.
+   * @details An erase marker can only be dropped when there are no older
+   *          instances of the same record left.
+   */
+  uint16_t                  stale[MFS_CFG_MAX_RECORDS];
+#endif
 #if (MFS_CFG_TRANSACTION_MAX > 0) || defined(__DOXYGEN__)
   /**
    * @brief   Next write offset for current transaction.
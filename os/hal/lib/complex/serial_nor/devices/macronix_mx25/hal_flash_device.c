@@ -135,14 +135,17 @@ static bool mx25_find_id(const uint8_t *set, size_t size, uint8_t element) {
 }
 
 static flash_error_t mx25_poll_status(SNORDriver *devp) {
+#if MX25_NICE_WAITING == TRUE
+  uint32_t interval = 0U;
+#endif
 
   do {
 #if MX25_NICE_WAITING == TRUE
-    osalThreadSleepMilliseconds(1);
+    interval = snor_poll_delay(interval);
 #endif
     /* Read status command.*/
 #if MX25_BUS_MODE == MX25_BUS_MODE_SPI
-    bus_cmd_receive(devp->config->busp, MX25_CMD_SPI_RDSR, 1U, devp->nocache->buf1);
+    bus_cmd_receive(devp->config->busp, MX25_CMD_SPI_RDSR, 1U, devp->nocache->buf);
 #else
     bus_cmd_addr_dummy_receive(devp->config->busp, MX25_CMD_OPI_RDSR,
                                0U, 4U, 2U,
@@ -153,7 +156,7 @@ static flash_error_t mx25_poll_status(SNORDriver *devp) {
   /* Reading security register and checking for errors.*/
 #if MX25_BUS_MODE == MX25_BUS_MODE_SPI
   bus_cmd_receive(devp->config->busp, MX25_CMD_SPI_RDSCUR,
-                  1U, devp->nocache->buf1);
+                  1U, devp->nocache->buf);
 #else
   bus_cmd_addr_dummy_receive(devp->config->busp, MX25_CMD_OPI_RDSCUR,
                              0U, 4U, 2U,
@@ -666,4 +669,50 @@ flash_error_t snor_device_read_sfdp(SNORDriver *devp, flash_offset_t offset,
   return FLASH_NO_ERROR;
 }
 
+/**
+ * @brief   Suspends an erase in progress.
+ * @note    The erase could terminate before the suspend takes effect.
+ *
+ * @param[in] devp      pointer to a @p SNORDriver instance
+ */
+flash_error_t snor_device_suspend_erase(SNORDriver *devp) {
+
+  /* Suspend command.*/
+#if MX25_BUS_MODE == MX25_BUS_MODE_SPI
+  bus_cmd(devp->config->busp, MX25_CMD_SPI_PE_SUSPEND);
+#else
+  bus_cmd(devp->config->busp, MX25_CMD_OPI_PE_SUSPEND);
+#endif
+
+  /* Waiting for the WIP bit to go to zero, the suspend latency is short so
+     there is no sleep between polls.*/
+  do {
+#if MX25_BUS_MODE == MX25_BUS_MODE_SPI
+    bus_cmd_receive(devp->config->busp, MX25_CMD_SPI_RDSR, 1U,
+                    &devp->nocache->buf[0]);
+#else
+    bus_cmd_addr_dummy_receive(devp->config->busp, MX25_CMD_OPI_RDSR,
+                               0U, 4U, 2U,
+                               &devp->nocache->buf[0]); /* Note: always 4 dummies.*/
+#endif
+  } while ((devp->nocache->buf[0] & 1U) != 0U);
+
+  return FLASH_NO_ERROR;
+}
+
+/**
+ * @brief   Resumes a suspended erase.
+ * @note    The command is ignored if the erase already terminated.
+ *
+ * @param[in] devp      pointer to a @p SNORDriver instance
+ */
+void snor_device_resume_erase(SNORDriver *devp) {
+
+#if MX25_BUS_MODE == MX25_BUS_MODE_SPI
+  bus_cmd(devp->config->busp, MX25_CMD_SPI_PE_RESUME);
+#else
+  bus_cmd(devp->config->busp, MX25_CMD_OPI_PE_RESUME);
+#endif
+}
+
 /** @} */
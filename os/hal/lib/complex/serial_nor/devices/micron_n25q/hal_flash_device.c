@@ -198,11 +198,14 @@ static bool n25q_find_id(const uint8_t *set, size_t size, uint8_t element) {
 }
 
 static flash_error_t n25q_poll_status(SNORDriver *devp) {
+#if N25Q_NICE_WAITING == TRUE
+  uint32_t interval = 0U;
+#endif
   uint8_t sts;
 
   do {
 #if N25Q_NICE_WAITING == TRUE
-    osalThreadSleepMilliseconds(1);
+    interval = snor_poll_delay(interval);
 #endif
     /* Read status command.*/
     bus_cmd_receive(devp->config->busp, N25Q_CMD_READ_FLAG_STATUS_REGISTER,
@@ -443,7 +446,7 @@ flash_error_t snor_device_start_erase_sector(SNORDriver *devp,
   bus_cmd(devp->config->busp, N25Q_CMD_WRITE_ENABLE);
 
   /* Sector erase command.*/
-  bus_cmd_addr(devp->config->busp, N25Q_CMD_SECTOR_ERASE, offset);
+  bus_cmd_addr(devp->config->busp, CMD_SECTOR_ERASE, offset);
 
   return FLASH_NO_ERROR;
 }
@@ -529,6 +532,29 @@ flash_error_t snor_device_read_sfdp(SNORDriver *devp, flash_offset_t offset,
   return FLASH_NO_ERROR;
 }
 
+flash_error_t snor_device_suspend_erase(SNORDriver *devp) {
+  uint8_t sts;
+
+  /* Suspend command.*/
+  bus_cmd(devp->config->busp, N25Q_CMD_PROGRAM_ERASE_SUSPEND);
+
+  /* Waiting for the P/E controller to become ready, the erase could also
+     terminate in the meantime. The suspend latency is short so there is
+     no sleep between polls.*/
+  do {
+    bus_cmd_receive(devp->config->busp, N25Q_CMD_READ_FLAG_STATUS_REGISTER,
+                    1, &sts);
+  } while ((sts & N25Q_FLAGS_PROGRAM_ERASE) == 0U);
+
+  return FLASH_NO_ERROR;
+}
+
+void snor_device_resume_erase(SNORDriver *devp) {
+
+  /* Resume command, it is ignored if the erase already terminated.*/
+  bus_cmd(devp->config->busp, N25Q_CMD_PROGRAM_ERASE_RESUME);
+}
+
 #if (SNOR_BUS_DRIVER == SNOR_BUS_DRIVER_WSPI) || defined(__DOXYGEN__)
 void snor_activate_xip(SNORDriver *devp) {
   static const uint8_t flash_status_xip[1] = {
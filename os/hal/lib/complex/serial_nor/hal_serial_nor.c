@@ -29,6 +29,14 @@
 /* Driver local definitions.                                                 */
 /*===========================================================================*/
 
+/* Erase suspend is used only if the device supports it.*/
+#if (SNOR_USE_ERASE_SUSPEND == TRUE) &&                                     \
+    (SNOR_DEVICE_SUPPORTS_ERASE_SUSPEND == TRUE)
+#define SNOR_SUSPEND_ERASE                  TRUE
+#else
+#define SNOR_SUSPEND_ERASE                  FALSE
+#endif
+
 /*===========================================================================*/
 /* Driver exported variables.                                                */
 /*===========================================================================*/
@@ -68,6 +76,57 @@ static const struct SNORDriverVMT snor_vmt = {
 /* Driver local functions.                                                   */
 /*===========================================================================*/
 
+#if (SNOR_SUSPEND_ERASE == TRUE) || defined(__DOXYGEN__)
+/**
+ * @brief   Suspends an erase in progress.
+ * @details The erase is not suspended if the operation involves the sector
+ *          being erased or if the whole device is being erased.
+ *
+ * @param[in] devp      pointer to the @p SNORDriver object
+ * @param[in] offset    offset of the operation
+ * @param[in] n         size of the operation
+ * @return              An error code.
+ * @retval FLASH_NO_ERROR       if the erase has been suspended.
+ * @retval FLASH_BUSY_ERASING   if the erase cannot be suspended.
+ */
+static flash_error_t snor_suspend_erase(SNORDriver *devp,
+                                        flash_offset_t offset,
+                                        size_t n) {
+  flash_offset_t start;
+  sysinterval_t elapsed;
+
+  if (devp->erase_sector == SNOR_ERASE_ALL) {
+    return FLASH_BUSY_ERASING;
+  }
+
+  start = flashGetSectorOffset((BaseFlash *)devp, devp->erase_sector);
+  if ((offset < start + flashGetSectorSize((BaseFlash *)devp,
+                                           devp->erase_sector)) &&
+      (offset + n > start)) {
+    return FLASH_BUSY_ERASING;
+  }
+
+  /* Letting the erase progress since the last resume.*/
+  elapsed = osalTimeDiffX(devp->erase_time, osalOsGetSystemTimeX());
+  if (elapsed < OSAL_US2I(SNOR_ERASE_RESUME_TIME)) {
+    osalThreadSleep(OSAL_US2I(SNOR_ERASE_RESUME_TIME) - elapsed);
+  }
+
+  return snor_device_suspend_erase(devp);
+}
+
+/**
+ * @brief   Resumes a suspended erase.
+ *
+ * @param[in] devp      pointer to the @p SNORDriver object
+ */
+static void snor_resume_erase(SNORDriver *devp) {
+
+  snor_device_resume_erase(devp);
+  devp->erase_time = osalOsGetSystemTimeX();
+}
+#endif /* SNOR_SUSPEND_ERASE == TRUE */
+
 /**
  * @brief   Returns a pointer to the device descriptor.
  *
@@ -96,7 +155,24 @@ static flash_error_t snor_read(void *instance, flash_offset_t offset,
                 "invalid state");
 
   if (devp->state == FLASH_ERASE) {
+#if SNOR_SUSPEND_ERASE == TRUE
+    /* Bus acquired.*/
+    bus_acquire(devp->config->busp, devp->config->buscfg);
+
+    /* Reading while the erase is suspended, the state is not changed.*/
+    err = snor_suspend_erase(devp, offset, n);
+    if (err == FLASH_NO_ERROR) {
+      err = snor_device_read(devp, offset, n, rp);
+      snor_resume_erase(devp);
+    }
+
+    /* Bus released.*/
+    bus_release(devp->config->busp);
+
+    return err;
+#else
     return FLASH_BUSY_ERASING;
+#endif
   }
 
   /* Bus acquired.*/
@@ -129,7 +205,24 @@ static flash_error_t snor_program(void *instance, flash_offset_t offset,
                 "invalid state");
 
   if (devp->state == FLASH_ERASE) {
+#if SNOR_SUSPEND_ERASE == TRUE
+    /* Bus acquired.*/
+    bus_acquire(devp->config->busp, devp->config->buscfg);
+
+    /* Programming while the erase is suspended, the state is not changed.*/
+    err = snor_suspend_erase(devp, offset, n);
+    if (err == FLASH_NO_ERROR) {
+      err = snor_device_program(devp, offset, n, pp);
+      snor_resume_erase(devp);
+    }
+
+    /* Bus released.*/
+    bus_release(devp->config->busp);
+
+    return err;
+#else
     return FLASH_BUSY_ERASING;
+#endif
   }
 
   /* Bus acquired.*/
@@ -167,6 +260,10 @@ static flash_error_t snor_start_erase_all(void *instance) {
 
   /* FLASH_ERASE state while the operation is performed.*/
   devp->state = FLASH_ERASE;
+#if SNOR_USE_ERASE_SUSPEND == TRUE
+  devp->erase_sector = SNOR_ERASE_ALL;
+  devp->erase_time   = osalOsGetSystemTimeX();
+#endif
 
   /* Actual erase implementation.*/
   err = snor_device_start_erase_all(devp);
@@ -196,6 +293,10 @@ static flash_error_t snor_start_erase_sector(void *instance,
 
   /* FLASH_ERASE state while the operation is performed.*/
   devp->state = FLASH_ERASE;
+#if SNOR_USE_ERASE_SUSPEND == TRUE
+  devp->erase_sector = sector;
+  devp->erase_time   = osalOsGetSystemTimeX();
+#endif
 
   /* Actual erase implementation.*/
   err = snor_device_start_erase_sector(devp, sector);
@@ -688,6 +789,34 @@ void bus_cmd_addr_dummy_receive(BUSDriver *busp,
 #endif
 }
 
+/**
+ * @brief   Waits before the next device status poll.
+ * @details The calling thread sleeps for the specified interval, clamped
+ *          between @p SNOR_POLL_INTERVAL_MIN and @p SNOR_POLL_INTERVAL_MAX
+ *          microseconds. The returned interval is doubled so that short
+ *          operations are detected early while long operations do not
+ *          flood the bus with status reads.
+ *
+ * @param[in] interval  current polling interval in microseconds, zero
+ *                      on the first poll
+ * @return              The next polling interval.
+ *
+ * @notapi
+ */
+uint32_t snor_poll_delay(uint32_t interval) {
+
+  if (interval < (uint32_t)SNOR_POLL_INTERVAL_MIN) {
+    interval = (uint32_t)SNOR_POLL_INTERVAL_MIN;
+  }
+  else if (interval > (uint32_t)SNOR_POLL_INTERVAL_MAX) {
+    interval = (uint32_t)SNOR_POLL_INTERVAL_MAX;
+  }
+
+  osalThreadSleep(OSAL_US2I(interval));
+
+  return interval * 2U;
+}
+
 /**
  * @brief   Initializes an instance.
  *
@@ -704,6 +833,10 @@ void snorObjectInit(SNORDriver *devp, snor_nocache_buffer_t *nocache) {
   devp->state       = FLASH_STOP;
   devp->config      = NULL;
   devp->nocache     = nocache;
+#if SNOR_USE_ERASE_SUSPEND == TRUE
+  devp->erase_sector = SNOR_ERASE_ALL;
+  devp->erase_time   = (systime_t)0;
+#endif
 #if SNOR_USE_MUTUAL_EXCLUSION == TRUE
   osalMutexObjectInit(&devp->mutex);
 #endif
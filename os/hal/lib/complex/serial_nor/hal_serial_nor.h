@@ -44,6 +44,11 @@
  */
 #define SNOR_BUFFER_SIZE                    32
 
+/**
+ * @brief   Erased sector marker for a whole device erase.
+ */
+#define SNOR_ERASE_ALL                      ((flash_sector_t)-1)
+
 /*===========================================================================*/
 /* Driver pre-compile time settings.                                         */
 /*===========================================================================*/
@@ -87,6 +92,48 @@
 #if !defined(SNOR_SPI_4BYTES_ADDRESS) || defined(__DOXYGEN__)
 #define SNOR_SPI_4BYTES_ADDRESS             FALSE
 #endif
+
+/**
+ * @brief   Erase suspend switch.
+ * @details If set to @p TRUE then read and program operations suspend
+ *          a sector erase in progress instead of failing with
+ *          @p FLASH_BUSY_ERASING, the erase is resumed at the end of the
+ *          operation.
+ * @note    Operations involving the sector being erased, or performed
+ *          during a whole device erase, still fail with
+ *          @p FLASH_BUSY_ERASING.
+ * @note    It is only effective if the device supports erase suspend.
+ */
+#if !defined(SNOR_USE_ERASE_SUSPEND) || defined(__DOXYGEN__)
+#define SNOR_USE_ERASE_SUSPEND              TRUE
+#endif
+
+/**
+ * @brief   Minimum erase time between a resume and the next suspend.
+ * @details Time, in microseconds, an erase is guaranteed to progress
+ *          after being resumed, back-to-back operations cannot starve
+ *          the erase.
+ */
+#if !defined(SNOR_ERASE_RESUME_TIME) || defined(__DOXYGEN__)
+#define SNOR_ERASE_RESUME_TIME              1000
+#endif
+
+/**
+ * @brief   Initial status polling interval.
+ * @details Devices sleeping between status polls start with this interval,
+ *          in microseconds, and double it at each poll.
+ */
+#if !defined(SNOR_POLL_INTERVAL_MIN) || defined(__DOXYGEN__)
+#define SNOR_POLL_INTERVAL_MIN              100
+#endif
+
+/**
+ * @brief   Maximum status polling interval.
+ * @details Upper limit, in microseconds, of the status polling interval.
+ */
+#if !defined(SNOR_POLL_INTERVAL_MAX) || defined(__DOXYGEN__)
+#define SNOR_POLL_INTERVAL_MAX              2000
+#endif
 /** @} */
 
 /*===========================================================================*/
@@ -103,6 +150,11 @@
 #error "invalid SNOR_BUS_DRIVER setting"
 #endif
 
+#if (SNOR_POLL_INTERVAL_MIN <= 0) ||                                        \
+    (SNOR_POLL_INTERVAL_MAX < SNOR_POLL_INTERVAL_MIN)
+#error "invalid SNOR_POLL_INTERVAL_MIN/SNOR_POLL_INTERVAL_MAX settings"
+#endif
+
 /*===========================================================================*/
 /* Driver data structures and types.                                         */
 /*===========================================================================*/
@@ -179,6 +231,16 @@ typedef struct {
    */
   mutex_t                       mutex;
 #endif /* EFL_USE_MUTUAL_EXCLUSION == TRUE */
+#if (SNOR_USE_ERASE_SUSPEND == TRUE) || defined(__DOXYGEN__)
+  /**
+   * @brief   Sector being erased or @p SNOR_ERASE_ALL.
+   */
+  flash_sector_t                erase_sector;
+  /**
+   * @brief   System time of the erase start or of the last resume.
+   */
+  systime_t                     erase_time;
+#endif
 } SNORDriver;
 
 /*===========================================================================*/
@@ -229,6 +291,7 @@ extern "C" {
                                   uint32_t dummy,
                                   size_t n,
                                   uint8_t *p);
+  uint32_t snor_poll_delay(uint32_t interval);
   void snorObjectInit(SNORDriver *devp, snor_nocache_buffer_t *nocache);
   void snorStart(SNORDriver *devp, const SNORConfig *config);
   void snorStop(SNORDriver *devp);
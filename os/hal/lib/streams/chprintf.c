@@ -32,16 +32,17 @@
 #include "chprintf.h"
 #include "memstreams.h"
 
-#define MAX_FILLER 11
+/* Digits of an unsigned long in octal, 11 with a 32 bits long.*/
+#define MAX_FILLER ((((sizeof (long)) * 8U) + 2U) / 3U)
 #define FLOAT_PRECISION 9
 
 static char *long_to_string_with_divisor(char *p,
-                                         long num,
+                                         unsigned long num,
                                          unsigned radix,
-                                         long divisor) {
+                                         unsigned long divisor) {
   int i;
   char *q;
-  long l, ll;
+  unsigned long l, ll;
 
   l = num;
   if (divisor == 0) {
@@ -69,7 +70,7 @@ static char *long_to_string_with_divisor(char *p,
   return p;
 }
 
-static char *ch_ltoa(char *p, long num, unsigned radix) {
+static char *ch_ltoa(char *p, unsigned long num, unsigned radix) {
 
   return long_to_string_with_divisor(p, num, radix, 0);
 }
@@ -88,11 +89,11 @@ static char *ftoa(char *p, double num, unsigned long precision) {
   precision = pow10[precision - 1];
 
   l = (long)num;
-  p = long_to_string_with_divisor(p, l, 10, 0);
+  p = long_to_string_with_divisor(p, (unsigned long)l, 10, 0);
   *p++ = '.';
   l = (long)((num - l) * precision);
 
-  return long_to_string_with_divisor(p, l, 10, precision / 10);
+  return long_to_string_with_divisor(p, (unsigned long)l, 10, precision / 10);
 }
 #endif
 
@@ -264,7 +265,7 @@ int chvprintf(BaseSequentialStream *chp, const char *fmt, va_list ap) {
         if (do_sign) {
           *p++ = '+';
         }
-      p = ch_ltoa(p, l, 10);
+      p = ch_ltoa(p, (unsigned long)l, 10);
       break;
 #if CHPRINTF_USE_FLOAT
     case 'f':
@@ -301,7 +302,7 @@ unsigned_common:
       else {
         l = va_arg(ap, unsigned int);
       }
-      p = ch_ltoa(p, l, c);
+      p = ch_ltoa(p, (unsigned long)l, c);
       break;
     default:
       *p++ = c;
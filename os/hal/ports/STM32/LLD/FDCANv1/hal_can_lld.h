@@ -436,6 +436,7 @@ struct hal_can_driver {
   can_callback_t            wakeup_cb;
 #endif
 #endif
+  _can_rx_ring_data
   /* End of the mandatory fields.*/
   /**
    * @brief   Pointer to the CAN registers.
@@ -451,6 +452,19 @@ struct hal_can_driver {
 /* Driver macros.                                                            */
 /*===========================================================================*/
 
+/**
+ * @brief   Returns the identifier of a received frame.
+ * @details Extended identifiers are or-ed with @p CAN_ID_EXT.
+ *
+ * @param[in] crfp      pointer to the @p CANRxFrame object
+ * @return              The frame identifier.
+ *
+ * @notapi
+ */
+#define can_lld_get_rx_id(crfp)                                             \
+  ((crfp)->common.XTD != 0U ? ((uint32_t)(crfp)->ext.EID | CAN_ID_EXT) :    \
+                              (uint32_t)(crfp)->std.SID)
+
 /*===========================================================================*/
 /* External declarations.                                                    */
 /*===========================================================================*/
@@ -0,0 +1,413 @@
+/*
+    ChibiOS - Copyright (C) 2006..2018 Giovanni Di Sirio
+
+    Licensed under the Apache License, Version 2.0 (the "License");
+    you may not use this file except in compliance with the License.
+    You may obtain a copy of the License at
+
+        http://www.apache.org/licenses/LICENSE-2.0
+
+    Unless required by applicable law or agreed to in writing, software
+    distributed under the License is distributed on an "AS IS" BASIS,
+    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+    See the License for the specific language governing permissions and
+    limitations under the License.
+*/
+
+/**
+ * @file    simulator/posix/hal_can_lld.c
+ * @brief   Posix simulator low level CAN driver code.
+ * @details The simulated node is in loopback mode: transmitted frames are
+ *          received back. The traffic of the other nodes on the bus comes
+ *          from an optional source function, the bus is kept busy
+ *          back-to-back as long as there are frames to be transferred.
+ *          Frames completing on the bus are stored in a small receive FIFO
+ *          which overflows if it is not emptied in time, as it would
+ *          happen with a real CAN controller.
+ *
+ * @addtogroup POSIX_CAN
+ * @{
+ */
+
+#include "hal.h"
+
+#if (HAL_USE_CAN == TRUE) || defined(__DOXYGEN__)
+
+/*===========================================================================*/
+/* Driver local definitions.                                                 */
+/*===========================================================================*/
+
+/**
+ * @brief   Bits of a standard frame without data, stuffing excluded and
+ *          inter-frame space included.
+ */
+#define CAN_STD_FRAME_BITS          47U
+
+/**
+ * @brief   Additional bits of an extended frame.
+ */
+#define CAN_EXT_FRAME_BITS          20U
+
+/*===========================================================================*/
+/* Driver exported variables.                                                */
+/*===========================================================================*/
+
+/**
+ * @brief   CAN1 driver identifier.
+ */
+#if (USE_SIM_CAN1 == TRUE) || defined(__DOXYGEN__)
+CANDriver CAND1;
+#endif
+
+/*===========================================================================*/
+/* Driver local variables and types.                                         */
+/*===========================================================================*/
+
+/*===========================================================================*/
+/* Driver local functions.                                                   */
+/*===========================================================================*/
+
+/**
+ * @brief   Puts the next frame on the bus.
+ * @details Pending transmissions have precedence over the other nodes
+ *          traffic, the bus becomes idle if there is nothing to transfer.
+ *
+ * @param[in] canp      pointer to the @p CANDriver object
+ * @param[in] t         start time of the frame in nanoseconds
+ */
+static void can_sim_next(CANDriver *canp, uint64_t t) {
+  const CANConfig *cfgp = canp->config;
+  uint32_t bits;
+
+  if (canp->txcnt > 0U) {
+    const CANTxFrame *ctfp = &canp->txfifo[canp->txrd];
+
+    canp->bus.DLC       = ctfp->DLC;
+    canp->bus.RTR       = ctfp->RTR;
+    canp->bus.IDE       = ctfp->IDE;
+    canp->bus.EID       = ctfp->IDE == CAN_IDE_EXT ? ctfp->EID : ctfp->SID;
+    canp->bus.data64[0] = ctfp->data64[0];
+    canp->bus_tx        = true;
+  }
+  else if ((cfgp->bitrate > 0U) && (cfgp->source != NULL) &&
+           cfgp->source(cfgp->arg, &canp->bus)) {
+    canp->bus_tx        = false;
+  }
+  else {
+    canp->deadline = 0U;
+    return;
+  }
+
+  bits = CAN_STD_FRAME_BITS;
+  if (canp->bus.IDE == CAN_IDE_EXT) {
+    bits += CAN_EXT_FRAME_BITS;
+  }
+  if ((canp->bus.RTR == CAN_RTR_DATA) && (canp->bus.DLC > 0U)) {
+    bits += 8U * (canp->bus.DLC > 8U ? 8U : (uint32_t)canp->bus.DLC);
+  }
+  if (cfgp->bitrate > 0U) {
+    t += ((uint64_t)bits * 1000000000U) / cfgp->bitrate;
+  }
+  canp->deadline = t;
+}
+
+/**
+ * @brief   Completes the frame on the bus.
+ *
+ * @param[in] canp      pointer to the @p CANDriver object
+ * @return              The receive FIFO status.
+ * @retval false        if the frame has been stored.
+ * @retval true         if the frame has been lost.
+ */
+static bool can_sim_complete(CANDriver *canp) {
+
+  if (canp->bus_tx) {
+    canp->txrd = (canp->txrd + 1U) % CAN_TX_MAILBOXES;
+    canp->txcnt--;
+  }
+
+  canp->frames++;
+  if (canp->rxcnt >= SIM_CAN_RX_FIFO_SIZE) {
+    canp->overruns++;
+    return true;
+  }
+
+  canp->bus.FMI  = 0U;
+  canp->bus.TIME = (uint16_t)(canp->deadline / 1000U);
+  canp->rxfifo[(canp->rxrd + canp->rxcnt) % SIM_CAN_RX_FIFO_SIZE] = canp->bus;
+  canp->rxcnt++;
+
+  return false;
+}
+
+/*===========================================================================*/
+/* Driver interrupt handlers.                                                */
+/*===========================================================================*/
+
+/*===========================================================================*/
+/* Driver exported functions.                                                */
+/*===========================================================================*/
+
+/**
+ * @brief   Low level CAN driver initialization.
+ *
+ * @notapi
+ */
+void can_lld_init(void) {
+
+#if USE_SIM_CAN1 == TRUE
+  canObjectInit(&CAND1);
+  CAND1.deadline = 0U;
+  CAND1.frames   = 0U;
+  CAND1.overruns = 0U;
+#endif
+}
+
+/**
+ * @brief   Configures and activates the CAN peripheral.
+ *
+ * @param[in] canp      pointer to the @p CANDriver object
+ *
+ * @notapi
+ */
+void can_lld_start(CANDriver *canp) {
+
+  canp->rxrd  = 0U;
+  canp->rxcnt = 0U;
+  canp->rxie  = true;
+  canp->txrd  = 0U;
+  canp->txcnt = 0U;
+
+  /* The other nodes start transmitting as soon as the bus is joined.*/
+  can_sim_next(canp, _sim_get_time());
+}
+
+/**
+ * @brief   Deactivates the CAN peripheral.
+ *
+ * @param[in] canp      pointer to the @p CANDriver object
+ *
+ * @notapi
+ */
+void can_lld_stop(CANDriver *canp) {
+
+  canp->deadline = 0U;
+  canp->rxcnt    = 0U;
+  canp->txcnt    = 0U;
+}
+
+/**
+ * @brief   Determines whether a frame can be transmitted.
+ *
+ * @param[in] canp      pointer to the @p CANDriver object
+ * @param[in] mailbox   mailbox number, @p CAN_ANY_MAILBOX for any mailbox
+ *
+ * @return              The queue space availability.
+ * @retval false        no space in the transmit queue.
+ * @retval true         transmit slot available.
+ *
+ * @notapi
+ */
+bool can_lld_is_tx_empty(CANDriver *canp, canmbx_t mailbox) {
+
+  (void)mailbox;
+
+  return canp->txcnt < (unsigned)CAN_TX_MAILBOXES;
+}
+
+/**
+ * @brief   Inserts a frame into the transmit queue.
+ * @note    Mailboxes are served in FIFO order, the mailbox number is
+ *          ignored.
+ *
+ * @param[in] canp      pointer to the @p CANDriver object
+ * @param[in] ctfp      pointer to the CAN frame to be transmitted
+ * @param[in] mailbox   mailbox number,  @p CAN_ANY_MAILBOX for any mailbox
+ *
+ * @notapi
+ */
+void can_lld_transmit(CANDriver *canp,
+                      canmbx_t mailbox,
+                      const CANTxFrame *ctfp) {
+
+  (void)mailbox;
+
+  canp->txfifo[(canp->txrd + canp->txcnt) % CAN_TX_MAILBOXES] = *ctfp;
+  canp->txcnt++;
+
+  /* If the bus is idle then the transmission starts immediately.*/
+  if (canp->deadline == 0U) {
+    can_sim_next(canp, _sim_get_time());
+  }
+}
+
+/**
+ * @brief   Determines whether a frame has been received.
+ *
+ * @param[in] canp      pointer to the @p CANDriver object
+ * @param[in] mailbox   mailbox number, @p CAN_ANY_MAILBOX for any mailbox
+ *
+ * @return              The queue space availability.
+ * @retval false        no space in the transmit queue.
+ * @retval true         transmit slot available.
+ *
+ * @notapi
+ */
+bool can_lld_is_rx_nonempty(CANDriver *canp, canmbx_t mailbox) {
+
+  (void)mailbox;
+
+  return canp->rxcnt > 0U;
+}
+
+/**
+ * @brief   Receives a frame from the input queue.
+ *
+ * @param[in] canp      pointer to the @p CANDriver object
+ * @param[in] mailbox   mailbox number, @p CAN_ANY_MAILBOX for any mailbox
+ * @param[out] crfp     pointer to the buffer where the CAN frame is copied
+ *
+ * @notapi
+ */
+void can_lld_receive(CANDriver *canp,
+                     canmbx_t mailbox,
+                     CANRxFrame *crfp) {
+
+  (void)mailbox;
+
+  if (canp->rxcnt == 0U) {
+    /* Should not happen, do nothing.*/
+    return;
+  }
+
+  *crfp = canp->rxfifo[canp->rxrd];
+  canp->rxrd = (canp->rxrd + 1U) % SIM_CAN_RX_FIFO_SIZE;
+  canp->rxcnt--;
+
+  /* If the queue is empty re-enables the interrupt in order to generate
+     events again.*/
+  if (canp->rxcnt == 0U) {
+    canp->rxie = true;
+  }
+}
+
+/**
+ * @brief   Tries to abort an ongoing transmission.
+ * @note    Not supported, frames are put on the bus as soon as the bus
+ *          becomes idle.
+ *
+ * @param[in] canp      pointer to the @p CANDriver object
+ * @param[in] mailbox   mailbox number
+ *
+ * @notapi
+ */
+void can_lld_abort(CANDriver *canp,
+                   canmbx_t mailbox) {
+
+  (void)canp;
+  (void)mailbox;
+}
+
+#if (CAN_USE_SLEEP_MODE == TRUE) || defined(__DOXYGEN__)
+/**
+ * @brief   Enters the sleep mode.
+ *
+ * @param[in] canp      pointer to the @p CANDriver object
+ *
+ * @notapi
+ */
+void can_lld_sleep(CANDriver *canp) {
+
+  (void)canp;
+}
+
+/**
+ * @brief   Enforces leaving the sleep mode.
+ *
+ * @param[in] canp      pointer to the @p CANDriver object
+ *
+ * @notapi
+ */
+void can_lld_wakeup(CANDriver *canp) {
+
+  (void)canp;
+}
+#endif /* CAN_USE_SLEEP_MODE == TRUE */
+
+/**
+ * @brief   Bus activity simulation.
+ * @details All the frames completed on the bus since the previous call are
+ *          moved into the receive FIFO, then the interrupts are generated.
+ *
+ * @return              The interrupt status.
+ * @retval false        if no interrupt has been generated.
+ * @retval true         if an interrupt has been served.
+ *
+ * @notapi
+ */
+bool can_lld_interrupt_pending(void) {
+  bool b = false;
+
+#if USE_SIM_CAN1 == TRUE
+  CANDriver *canp = &CAND1;
+  uint64_t now = _sim_get_time();
+  eventflags_t txflags = 0U;
+  bool ovf = false, rx;
+
+  while ((canp->deadline != 0U) && (now >= canp->deadline)) {
+    if (canp->bus_tx) {
+      txflags |= CAN_MAILBOX_TO_MASK(1U);
+    }
+    if (can_sim_complete(canp)) {
+      ovf = true;
+    }
+    can_sim_next(canp, canp->deadline);
+  }
+
+  rx = canp->rxie && (canp->rxcnt > 0U);
+  if (ovf || rx || (txflags != 0U)) {
+
+    OSAL_IRQ_PROLOGUE();
+
+    if (ovf) {
+      _can_error_isr(canp, CAN_OVERFLOW_ERROR);
+    }
+    if (txflags != 0U) {
+      _can_tx_empty_isr(canp, txflags);
+    }
+    if (rx) {
+      /* No more receive events until the FIFO has been emptied.*/
+      canp->rxie = false;
+      _can_rx_full_isr(canp, CAN_MAILBOX_TO_MASK(1U));
+    }
+
+    OSAL_IRQ_EPILOGUE();
+
+    b = true;
+  }
+#endif
+
+  return b;
+}
+
+/**
+ * @brief   Returns the completion time of the frame on the bus.
+ *
+ * @return              The simulator time of the completion in
+ *                      nanoseconds.
+ * @retval 0            if the bus is idle.
+ *
+ * @notapi
+ */
+uint64_t can_lld_get_deadline(void) {
+
+#if USE_SIM_CAN1 == TRUE
+  return CAND1.deadline;
+#else
+  return 0U;
+#endif
+}
+
+#endif /* HAL_USE_CAN == TRUE */
+
+/** @} */
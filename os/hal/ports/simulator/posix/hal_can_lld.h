@@ -0,0 +1,390 @@
+/*
+    ChibiOS - Copyright (C) 2006..2018 Giovanni Di Sirio
+
+    Licensed under the Apache License, Version 2.0 (the "License");
+    you may not use this file except in compliance with the License.
+    You may obtain a copy of the License at
+
+        http://www.apache.org/licenses/LICENSE-2.0
+
+    Unless required by applicable law or agreed to in writing, software
+    distributed under the License is distributed on an "AS IS" BASIS,
+    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+    See the License for the specific language governing permissions and
+    limitations under the License.
+*/
+
+/**
+ * @file    simulator/posix/hal_can_lld.h
+ * @brief   Posix simulator low level CAN driver header.
+ *
+ * @addtogroup POSIX_CAN
+ * @{
+ */
+
+#ifndef HAL_CAN_LLD_H
+#define HAL_CAN_LLD_H
+
+#if (HAL_USE_CAN == TRUE) || defined(__DOXYGEN__)
+
+/*===========================================================================*/
+/* Driver constants.                                                         */
+/*===========================================================================*/
+
+/**
+ * @brief   This switch defines whether the driver implementation supports
+ *          a low power switch mode with automatic an wakeup feature.
+ */
+#define CAN_SUPPORTS_SLEEP          TRUE
+
+/**
+ * @brief   Number of transmit mailboxes.
+ */
+#define CAN_TX_MAILBOXES            3
+
+/**
+ * @brief   Number of receive mailboxes.
+ */
+#define CAN_RX_MAILBOXES            1
+
+/**
+ * @name    CAN registers helper macros
+ * @{
+ */
+#define CAN_IDE_STD                 0           /**< @brief Standard id.    */
+#define CAN_IDE_EXT                 1           /**< @brief Extended id.    */
+#define CAN_RTR_DATA                0           /**< @brief Data frame.     */
+#define CAN_RTR_REMOTE              1           /**< @brief Remote frame.   */
+/** @} */
+
+/*===========================================================================*/
+/* Driver pre-compile time settings.                                         */
+/*===========================================================================*/
+
+/**
+ * @brief   CAND1 driver enable switch.
+ * @details If set to @p TRUE the support for CAND1 is included.
+ * @note    The default is @p TRUE.
+ */
+#if !defined(USE_SIM_CAN1) || defined(__DOXYGEN__)
+#define USE_SIM_CAN1                TRUE
+#endif
+
+/**
+ * @brief   Depth of the simulated hardware receive FIFO.
+ * @note    The default is the same as the STM32 bxCAN FIFOs.
+ */
+#if !defined(SIM_CAN_RX_FIFO_SIZE) || defined(__DOXYGEN__)
+#define SIM_CAN_RX_FIFO_SIZE        3
+#endif
+
+/*===========================================================================*/
+/* Derived constants and error checks.                                       */
+/*===========================================================================*/
+
+#if CAN_USE_SLEEP_MODE && !CAN_SUPPORTS_SLEEP
+#error "CAN sleep mode not supported in this architecture"
+#endif
+
+#if SIM_CAN_RX_FIFO_SIZE < 1
+#error "invalid SIM_CAN_RX_FIFO_SIZE value"
+#endif
+
+/*===========================================================================*/
+/* Driver data structures and types.                                         */
+/*===========================================================================*/
+
+/**
+ * @brief   Type of a structure representing an CAN driver.
+ */
+typedef struct hal_can_driver CANDriver;
+
+/**
+ * @brief   Type of a transmission mailbox index.
+ */
+typedef uint32_t canmbx_t;
+
+#if (CAN_ENFORCE_USE_CALLBACKS == TRUE) || defined(__DOXYGEN__)
+/**
+ * @brief   Type of a CAN notification callback.
+ *
+ * @param[in] canp      pointer to the @p CANDriver object triggering the
+ *                      callback
+ * @param[in] flags     flags associated to the mailbox callback
+ */
+typedef void (*can_callback_t)(CANDriver *canp, uint32_t flags);
+#endif
+
+/**
+ * @brief   CAN transmission frame.
+ * @note    Accessing the frame data as word16 or word32 is not portable because
+ *          machine data endianness, it can be still useful for a quick filling.
+ */
+typedef struct {
+  struct {
+    uint8_t                 DLC:4;          /**< @brief Data length.        */
+    uint8_t                 RTR:1;          /**< @brief Frame type.         */
+    uint8_t                 IDE:1;          /**< @brief Identifier type.    */
+  };
+  union {
+    struct {
+      uint32_t              SID:11;         /**< @brief Standard identifier.*/
+    };
+    struct {
+      uint32_t              EID:29;         /**< @brief Extended identifier.*/
+    };
+  };
+  union {
+    uint8_t                 data8[8];       /**< @brief Frame data.         */
+    uint16_t                data16[4];      /**< @brief Frame data.         */
+    uint32_t                data32[2];      /**< @brief Frame data.         */
+    uint64_t                data64[1];      /**< @brief Frame data.         */
+  };
+} CANTxFrame;
+
+/**
+ * @brief   CAN received frame.
+ * @note    Accessing the frame data as word16 or word32 is not portable because
+ *          machine data endianness, it can be still useful for a quick filling.
+ */
+typedef struct {
+  struct {
+    uint8_t                 FMI;            /**< @brief Filter id.          */
+    uint16_t                TIME;           /**< @brief Time stamp.         */
+  };
+  struct {
+    uint8_t                 DLC:4;          /**< @brief Data length.        */
+    uint8_t                 RTR:1;          /**< @brief Frame type.         */
+    uint8_t                 IDE:1;          /**< @brief Identifier type.    */
+  };
+  union {
+    struct {
+      uint32_t              SID:11;         /**< @brief Standard identifier.*/
+    };
+    struct {
+      uint32_t              EID:29;         /**< @brief Extended identifier.*/
+    };
+  };
+  union {
+    uint8_t                 data8[8];       /**< @brief Frame data.         */
+    uint16_t                data16[4];      /**< @brief Frame data.         */
+    uint32_t                data32[2];      /**< @brief Frame data.         */
+    uint64_t                data64[1];      /**< @brief Frame data.         */
+  };
+} CANRxFrame;
+
+/**
+ * @brief   Simulated bus traffic source.
+ * @details Frames transmitted by the other nodes on the bus, the source is
+ *          polled each time the bus becomes idle.
+ *
+ * @param[in] arg       argument specified in the configuration
+ * @param[out] crfp     pointer to the frame to be filled
+ * @return              The source status.
+ * @retval false        if there is no frame to be transmitted, the bus
+ *                      stays idle until the next transmission.
+ * @retval true         if a frame has been returned.
+ */
+typedef bool (*sim_can_source_t)(void *arg, CANRxFrame *crfp);
+
+/**
+ * @brief   Type of a CAN configuration structure.
+ */
+typedef struct hal_can_config {
+  /**
+   * @brief   Simulated bit rate in bits per second, zero for no transfer
+   *          time.
+   * @note    The other nodes traffic is only simulated with a non-zero
+   *          bit rate.
+   */
+  uint32_t                  bitrate;
+  /**
+   * @brief   Other nodes traffic source or @p NULL.
+   */
+  sim_can_source_t          source;
+  /**
+   * @brief   Argument passed to the source function.
+   */
+  void                      *arg;
+} CANConfig;
+
+/**
+ * @brief   Structure representing an CAN driver.
+ */
+struct hal_can_driver {
+  /**
+   * @brief   Driver state.
+   */
+  canstate_t                state;
+  /**
+   * @brief   Current configuration data.
+   */
+  const CANConfig           *config;
+  /**
+   * @brief   Transmission threads queue.
+   */
+  threads_queue_t           txqueue;
+  /**
+   * @brief   Receive threads queue.
+   */
+  threads_queue_t           rxqueue;
+#if (CAN_ENFORCE_USE_CALLBACKS == FALSE) || defined(__DOXYGEN__)
+  /**
+   * @brief   One or more frames become available.
+   * @note    After broadcasting this event it will not be broadcasted again
+   *          until the received frames queue has been completely emptied. It
+   *          is <b>not</b> broadcasted for each received frame. It is
+   *          responsibility of the application to empty the queue by
+   *          repeatedly invoking @p canReceive() when listening to this event.
+   *          This behavior minimizes the interrupt served by the system
+   *          because CAN traffic.
+   */
+  event_source_t            rxfull_event;
+  /**
+   * @brief   One or more transmission mailbox become available.
+   */
+  event_source_t            txempty_event;
+  /**
+   * @brief   A CAN bus error happened.
+   */
+  event_source_t            error_event;
+#if (CAN_USE_SLEEP_MODE == TRUE) || defined (__DOXYGEN__)
+  /**
+   * @brief   Entering sleep state event.
+   */
+  event_source_t            sleep_event;
+  /**
+   * @brief   Exiting sleep state event.
+   */
+  event_source_t            wakeup_event;
+#endif
+#else /* CAN_ENFORCE_USE_CALLBACKS == TRUE */
+  /**
+   * @brief   One or more frames become available.
+   */
+  can_callback_t            rxfull_cb;
+  /**
+   * @brief   One or more transmission mailbox become available.
+   */
+  can_callback_t            txempty_cb;
+  /**
+   * @brief   A CAN bus error happened.
+   */
+  can_callback_t            error_cb;
+#if (CAN_USE_SLEEP_MODE == TRUE) || defined (__DOXYGEN__)
+  /**
+   * @brief   Exiting sleep state.
+   */
+  can_callback_t            wakeup_cb;
+#endif
+#endif
+  _can_rx_ring_data
+  /* End of the mandatory fields.*/
+  /**
+   * @brief   Simulated hardware receive FIFO.
+   */
+  CANRxFrame                rxfifo[SIM_CAN_RX_FIFO_SIZE];
+  /**
+   * @brief   Receive FIFO read index.
+   */
+  unsigned                  rxrd;
+  /**
+   * @brief   Number of frames in the receive FIFO.
+   */
+  unsigned                  rxcnt;
+  /**
+   * @brief   Receive interrupt enable, disabled after each receive
+   *          interrupt until the FIFO is emptied.
+   */
+  bool                      rxie;
+  /**
+   * @brief   Simulated transmit mailboxes, served in FIFO order.
+   */
+  CANTxFrame                txfifo[CAN_TX_MAILBOXES];
+  /**
+   * @brief   Transmit FIFO read index.
+   */
+  unsigned                  txrd;
+  /**
+   * @brief   Number of frames in the transmit FIFO.
+   */
+  unsigned                  txcnt;
+  /**
+   * @brief   Frame currently on the bus.
+   */
+  CANRxFrame                bus;
+  /**
+   * @brief   The frame on the bus comes from the transmit FIFO.
+   */
+  bool                      bus_tx;
+  /**
+   * @brief   End of the frame on the bus in nanoseconds, zero if the bus
+   *          is idle.
+   */
+  uint64_t                  deadline;
+  /**
+   * @brief   Number of frames received from the bus, loopback included.
+   */
+  uint32_t                  frames;
+  /**
+   * @brief   Number of frames lost because the receive FIFO was full.
+   */
+  uint32_t                  overruns;
+};
+
+/*===========================================================================*/
+/* Driver macros.                                                            */
+/*===========================================================================*/
+
+/**
+ * @brief   Returns the identifier of a received frame.
+ * @details Extended identifiers are or-ed with @p CAN_ID_EXT.
+ *
+ * @param[in] crfp      pointer to the @p CANRxFrame object
+ * @return              The frame identifier.
+ *
+ * @notapi
+ */
+#define can_lld_get_rx_id(crfp)                                             \
+  ((crfp)->IDE == CAN_IDE_EXT ? ((uint32_t)(crfp)->EID | CAN_ID_EXT) :      \
+                                (uint32_t)(crfp)->SID)
+
+/*===========================================================================*/
+/* External declarations.                                                    */
+/*===========================================================================*/
+
+#if (USE_SIM_CAN1 == TRUE) && !defined(__DOXYGEN__)
+extern CANDriver CAND1;
+#endif
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+  void can_lld_init(void);
+  void can_lld_start(CANDriver *canp);
+  void can_lld_stop(CANDriver *canp);
+  bool can_lld_is_tx_empty(CANDriver *canp, canmbx_t mailbox);
+  void can_lld_transmit(CANDriver *canp,
+                        canmbx_t mailbox,
+                        const CANTxFrame *ctfp);
+  bool can_lld_is_rx_nonempty(CANDriver *canp, canmbx_t mailbox);
+  void can_lld_receive(CANDriver *canp,
+                       canmbx_t mailbox,
+                       CANRxFrame *crfp);
+  void can_lld_abort(CANDriver *canp,
+                     canmbx_t mailbox);
+#if CAN_USE_SLEEP_MODE == TRUE
+  void can_lld_sleep(CANDriver *canp);
+  void can_lld_wakeup(CANDriver *canp);
+#endif
+  bool can_lld_interrupt_pending(void);
+  uint64_t can_lld_get_deadline(void);
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* HAL_USE_CAN == TRUE */
+
+#endif /* HAL_CAN_LLD_H */
+
+/** @} */
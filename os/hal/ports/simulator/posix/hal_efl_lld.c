@@ -0,0 +1,349 @@
+/*
+    ChibiOS - Copyright (C) 2006..2018 Giovanni Di Sirio
+
+    Licensed under the Apache License, Version 2.0 (the "License");
+    you may not use this file except in compliance with the License.
+    You may obtain a copy of the License at
+
+        http://www.apache.org/licenses/LICENSE-2.0
+
+    Unless required by applicable law or agreed to in writing, software
+    distributed under the License is distributed on an "AS IS" BASIS,
+    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+    See the License for the specific language governing permissions and
+    limitations under the License.
+*/
+
+
+/**
+ * @file    simulator/posix/hal_efl_lld.c
+ * @brief   Posix simulator Embedded Flash subsystem low level driver source.
+ * @details The flash array is kept in RAM, it behaves as a NOR flash: erased
+ *          bytes are 0xFF and programming can only clear bits. Erase
+ *          operations complete immediately. The driver counts the bytes
+ *          read and programmed and the erase cycles of each sector, this
+ *          allows to measure the flash usage of higher level modules.
+ *
+ * @addtogroup POSIX_EFL
+ * @{
+ */
+
+#include <string.h>
+
+#include "hal.h"
+
+#if (HAL_USE_EFL == TRUE) || defined(__DOXYGEN__)
+
+/*===========================================================================*/
+/* Driver local definitions.                                                 */
+/*===========================================================================*/
+
+#define SIM_EFL_SIZE                (SIM_EFL_SECTORS_NUM * SIM_EFL_SECTOR_SIZE)
+
+/*===========================================================================*/
+/* Driver exported variables.                                                */
+/*===========================================================================*/
+
+/**
+ * @brief   EFL1 driver identifier.
+ */
+#if (SIM_EFL_USE_EFL1 == TRUE) || defined(__DOXYGEN__)
+EFlashDriver EFLD1;
+#endif
+
+/*===========================================================================*/
+/* Driver local variables and types.                                         */
+/*===========================================================================*/
+
+static const flash_descriptor_t efl_lld_descriptor = {
+ .attributes        = FLASH_ATTR_ERASED_IS_ONE |
+                      FLASH_ATTR_REWRITABLE,
+ .page_size         = 8U,
+ .sectors_count     = SIM_EFL_SECTORS_NUM,
+ .sectors           = NULL,
+ .sectors_size      = SIM_EFL_SECTOR_SIZE,
+ .address           = NULL,
+ .size              = SIM_EFL_SIZE
+};
+
+/*===========================================================================*/
+/* Driver local functions.                                                   */
+/*===========================================================================*/
+
+static void efl_sim_erase(EFlashDriver *devp, flash_sector_t sector) {
+
+  memset(&devp->array[sector * SIM_EFL_SECTOR_SIZE], 0xFF,
+         SIM_EFL_SECTOR_SIZE);
+  devp->sectors_erased++;
+  devp->erase_cycles[sector]++;
+}
+
+/*===========================================================================*/
+/* Driver interrupt handlers.                                                */
+/*===========================================================================*/
+
+/*===========================================================================*/
+/* Driver exported functions.                                                */
+/*===========================================================================*/
+
+/**
+ * @brief   Low level Embedded Flash driver initialization.
+ * @note    The simulated flash starts erased.
+ *
+ * @notapi
+ */
+void efl_lld_init(void) {
+
+#if SIM_EFL_USE_EFL1 == TRUE
+  /* Driver initialization.*/
+  eflObjectInit(&EFLD1);
+  memset(EFLD1.array, 0xFF, sizeof (EFLD1.array));
+  EFLD1.bytes_read       = 0U;
+  EFLD1.bytes_programmed = 0U;
+  EFLD1.sectors_erased   = 0U;
+  memset(EFLD1.erase_cycles, 0, sizeof (EFLD1.erase_cycles));
+#endif
+}
+
+/**
+ * @brief   Configures and activates the Embedded Flash peripheral.
+ * @note    The flash content is retained across stop and start.
+ *
+ * @param[in] eflp      pointer to a @p EFlashDriver structure
+ *
+ * @notapi
+ */
+void efl_lld_start(EFlashDriver *eflp) {
+
+  (void)eflp;
+}
+
+/**
+ * @brief   Deactivates the Embedded Flash peripheral.
+ *
+ * @param[in] eflp      pointer to a @p EFlashDriver structure
+ *
+ * @notapi
+ */
+void efl_lld_stop(EFlashDriver *eflp) {
+
+  (void)eflp;
+}
+
+/**
+ * @brief   Gets the flash descriptor structure.
+ *
+ * @param[in] instance              pointer to a @p EFlashDriver instance
+ * @return                          A flash device descriptor.
+ *
+ * @notapi
+ */
+const flash_descriptor_t *efl_lld_get_descriptor(void *instance) {
+
+  (void)instance;
+
+  return &efl_lld_descriptor;
+}
+
+/**
+ * @brief   Read operation.
+ *
+ * @param[in] instance              pointer to a @p EFlashDriver instance
+ * @param[in] offset                flash offset
+ * @param[in] n                     number of bytes to be read
+ * @param[out] rp                   pointer to the data buffer
+ * @return                          An error code.
+ * @retval FLASH_NO_ERROR           if there is no erase operation in progress.
+ * @retval FLASH_BUSY_ERASING       if there is an erase operation in progress.
+ *
+ * @notapi
+ */
+flash_error_t efl_lld_read(void *instance, flash_offset_t offset,
+                           size_t n, uint8_t *rp) {
+  EFlashDriver *devp = (EFlashDriver *)instance;
+
+  osalDbgCheck((instance != NULL) && (rp != NULL) && (n > 0U));
+  osalDbgCheck(((size_t)offset + n) <= (size_t)efl_lld_descriptor.size);
+  osalDbgAssert((devp->state == FLASH_READY) || (devp->state == FLASH_ERASE),
+                "invalid state");
+
+  /* No reading while erasing.*/
+  if (devp->state == FLASH_ERASE) {
+    return FLASH_BUSY_ERASING;
+  }
+
+  memcpy(rp, &devp->array[offset], n);
+  devp->bytes_read += n;
+
+  return FLASH_NO_ERROR;
+}
+
+/**
+ * @brief   Program operation.
+ * @note    Programming clears the bits which are zero in the data, bits
+ *          cannot be set back to one without erasing.
+ *
+ * @param[in] instance              pointer to a @p EFlashDriver instance
+ * @param[in] offset                flash offset
+ * @param[in] n                     number of bytes to be programmed
+ * @param[in] pp                    pointer to the data buffer
+ * @return                          An error code.
+ * @retval FLASH_NO_ERROR           if there is no erase operation in progress.
+ * @retval FLASH_BUSY_ERASING       if there is an erase operation in progress.
+ *
+ * @notapi
+ */
+flash_error_t efl_lld_program(void *instance, flash_offset_t offset,
+                              size_t n, const uint8_t *pp) {
+  EFlashDriver *devp = (EFlashDriver *)instance;
+  size_t i;
+
+  osalDbgCheck((instance != NULL) && (pp != NULL) && (n > 0U));
+  osalDbgCheck(((size_t)offset + n) <= (size_t)efl_lld_descriptor.size);
+  osalDbgAssert((devp->state == FLASH_READY) || (devp->state == FLASH_ERASE),
+                "invalid state");
+
+  /* No programming while erasing.*/
+  if (devp->state == FLASH_ERASE) {
+    return FLASH_BUSY_ERASING;
+  }
+
+  for (i = 0U; i < n; i++) {
+    devp->array[offset + i] &= pp[i];
+  }
+  devp->bytes_programmed += n;
+
+  return FLASH_NO_ERROR;
+}
+
+/**
+ * @brief   Starts a whole-device erase operation.
+ *
+ * @param[in] instance              pointer to a @p EFlashDriver instance
+ * @return                          An error code.
+ * @retval FLASH_NO_ERROR           if there is no erase operation in progress.
+ * @retval FLASH_BUSY_ERASING       if there is an erase operation in progress.
+ *
+ * @notapi
+ */
+flash_error_t efl_lld_start_erase_all(void *instance) {
+  EFlashDriver *devp = (EFlashDriver *)instance;
+  flash_sector_t sector;
+
+  osalDbgCheck(instance != NULL);
+  osalDbgAssert((devp->state == FLASH_READY) || (devp->state == FLASH_ERASE),
+                "invalid state");
+
+  /* No erasing while erasing.*/
+  if (devp->state == FLASH_ERASE) {
+    return FLASH_BUSY_ERASING;
+  }
+
+  /* The erase is completed on the next query.*/
+  devp->state = FLASH_ERASE;
+  for (sector = 0U; sector < SIM_EFL_SECTORS_NUM; sector++) {
+    efl_sim_erase(devp, sector);
+  }
+
+  return FLASH_NO_ERROR;
+}
+
+/**
+ * @brief   Starts an sector erase operation.
+ *
+ * @param[in] instance              pointer to a @p EFlashDriver instance
+ * @param[in] sector                sector to be erased
+ * @return                          An error code.
+ * @retval FLASH_NO_ERROR           if there is no erase operation in progress.
+ * @retval FLASH_BUSY_ERASING       if there is an erase operation in progress.
+ *
+ * @notapi
+ */
+flash_error_t efl_lld_start_erase_sector(void *instance,
+                                         flash_sector_t sector) {
+  EFlashDriver *devp = (EFlashDriver *)instance;
+
+  osalDbgCheck(instance != NULL);
+  osalDbgCheck(sector < efl_lld_descriptor.sectors_count);
+  osalDbgAssert((devp->state == FLASH_READY) || (devp->state == FLASH_ERASE),
+                "invalid state");
+
+  /* No erasing while erasing.*/
+  if (devp->state == FLASH_ERASE) {
+    return FLASH_BUSY_ERASING;
+  }
+
+  /* The erase is completed on the next query.*/
+  devp->state = FLASH_ERASE;
+  efl_sim_erase(devp, sector);
+
+  return FLASH_NO_ERROR;
+}
+
+/**
+ * @brief   Queries the driver for erase operation progress.
+ *
+ * @param[in] instance              pointer to a @p EFlashDriver instance
+ * @param[out] msec                 recommended time, in milliseconds, that
+ *                                  should be spent before calling this
+ *                                  function again, can be @p NULL
+ * @return                          An error code.
+ * @retval FLASH_NO_ERROR           if there is no erase operation in progress.
+ *
+ * @api
+ */
+flash_error_t efl_lld_query_erase(void *instance, uint32_t *msec) {
+  EFlashDriver *devp = (EFlashDriver *)instance;
+
+  if (msec != NULL) {
+    *msec = 0U;
+  }
+
+  /* Simulated erase operations are always complete.*/
+  if (devp->state == FLASH_ERASE) {
+    devp->state = FLASH_READY;
+  }
+
+  return FLASH_NO_ERROR;
+}
+
+/**
+ * @brief   Returns the erase state of a sector.
+ *
+ * @param[in] instance              pointer to a @p EFlashDriver instance
+ * @param[in] sector                sector to be verified
+ * @return                          An error code.
+ * @retval FLASH_NO_ERROR           if the sector is erased.
+ * @retval FLASH_BUSY_ERASING       if there is an erase operation in progress.
+ * @retval FLASH_ERROR_VERIFY       if the verify operation failed.
+ *
+ * @notapi
+ */
+flash_error_t efl_lld_verify_erase(void *instance, flash_sector_t sector) {
+  EFlashDriver *devp = (EFlashDriver *)instance;
+  const uint8_t *p;
+  size_t i;
+
+  osalDbgCheck(instance != NULL);
+  osalDbgCheck(sector < efl_lld_descriptor.sectors_count);
+  osalDbgAssert((devp->state == FLASH_READY) || (devp->state == FLASH_ERASE),
+                "invalid state");
+
+  /* No verifying while erasing.*/
+  if (devp->state == FLASH_ERASE) {
+    return FLASH_BUSY_ERASING;
+  }
+
+  p = &devp->array[sector * SIM_EFL_SECTOR_SIZE];
+  for (i = 0U; i < SIM_EFL_SECTOR_SIZE; i++) {
+    if (p[i] != 0xFFU) {
+      return FLASH_ERROR_VERIFY;
+    }
+  }
+
+  return FLASH_NO_ERROR;
+}
+
+#endif /* HAL_USE_EFL == TRUE */
+
+/** @} */
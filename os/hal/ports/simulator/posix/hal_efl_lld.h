@@ -0,0 +1,142 @@
+/*
+    ChibiOS - Copyright (C) 2006..2018 Giovanni Di Sirio
+
+    Licensed under the Apache License, Version 2.0 (the "License");
+    you may not use this file except in compliance with the License.
+    You may obtain a copy of the License at
+
+        http://www.apache.org/licenses/LICENSE-2.0
+
+    Unless required by applicable law or agreed to in writing, software
+    distributed under the License is distributed on an "AS IS" BASIS,
+    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+    See the License for the specific language governing permissions and
+    limitations under the License.
+*/
+
+
+/**
+ * @file    simulator/posix/hal_efl_lld.h
+ * @brief   Posix simulator Embedded Flash subsystem low level driver header.
+ *
+ * @addtogroup POSIX_EFL
+ * @{
+ */
+
+#ifndef HAL_EFL_LLD_H
+#define HAL_EFL_LLD_H
+
+#if (HAL_USE_EFL == TRUE) || defined(__DOXYGEN__)
+
+/*===========================================================================*/
+/* Driver constants.                                                         */
+/*===========================================================================*/
+
+/*===========================================================================*/
+/* Driver pre-compile time settings.                                         */
+/*===========================================================================*/
+
+/**
+ * @name    PLATFORM configuration options
+ * @{
+ */
+/**
+ * @brief   EFL1 driver enable switch.
+ * @details If set to @p TRUE the support for EFL1 is included.
+ * @note    The default is @p TRUE.
+ */
+#if !defined(SIM_EFL_USE_EFL1) || defined(__DOXYGEN__)
+#define SIM_EFL_USE_EFL1                    TRUE
+#endif
+
+/**
+ * @brief   Size of the simulated flash sectors.
+ */
+#if !defined(SIM_EFL_SECTOR_SIZE) || defined(__DOXYGEN__)
+#define SIM_EFL_SECTOR_SIZE                 4096U
+#endif
+
+/**
+ * @brief   Number of simulated flash sectors.
+ */
+#if !defined(SIM_EFL_SECTORS_NUM) || defined(__DOXYGEN__)
+#define SIM_EFL_SECTORS_NUM                 64U
+#endif
+/** @} */
+
+/*===========================================================================*/
+/* Derived constants and error checks.                                       */
+/*===========================================================================*/
+
+#if (SIM_EFL_SECTOR_SIZE & (SIM_EFL_SECTOR_SIZE - 1U)) != 0U
+#error "SIM_EFL_SECTOR_SIZE is not a power of two"
+#endif
+
+#if SIM_EFL_SECTORS_NUM < 1U
+#error "invalid SIM_EFL_SECTORS_NUM value"
+#endif
+
+/*===========================================================================*/
+/* Driver data structures and types.                                         */
+/*===========================================================================*/
+
+/*===========================================================================*/
+/* Driver macros.                                                            */
+/*===========================================================================*/
+
+/**
+ * @brief   Low level fields of the embedded flash driver structure.
+ */
+#define efl_lld_driver_fields                                               \
+  /* Flash array, programming can only clear bits as in a NOR flash.*/      \
+  uint8_t                   array[SIM_EFL_SECTORS_NUM *                     \
+                                  SIM_EFL_SECTOR_SIZE];                     \
+  /* Number of bytes read.*/                                                \
+  uint64_t                  bytes_read;                                     \
+  /* Number of bytes programmed.*/                                          \
+  uint64_t                  bytes_programmed;                               \
+  /* Number of sectors erased.*/                                            \
+  uint32_t                  sectors_erased;                                 \
+  /* Erase cycles of each sector.*/                                         \
+  uint32_t                  erase_cycles[SIM_EFL_SECTORS_NUM]
+
+/**
+ * @brief   Low level fields of the embedded flash configuration structure.
+ */
+#define efl_lld_config_fields                                               \
+  /* Dummy configuration, it is not needed.*/                               \
+  uint32_t                  dummy
+
+/*===========================================================================*/
+/* External declarations.                                                    */
+/*===========================================================================*/
+
+#if (SIM_EFL_USE_EFL1 == TRUE) && !defined(__DOXYGEN__)
+extern EFlashDriver EFLD1;
+#endif
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+  void efl_lld_init(void);
+  void efl_lld_start(EFlashDriver *eflp);
+  void efl_lld_stop(EFlashDriver *eflp);
+  const flash_descriptor_t *efl_lld_get_descriptor(void *instance);
+  flash_error_t efl_lld_read(void *instance, flash_offset_t offset,
+                             size_t n, uint8_t *rp);
+  flash_error_t efl_lld_program(void *instance, flash_offset_t offset,
+                                size_t n, const uint8_t *pp);
+  flash_error_t efl_lld_start_erase_all(void *instance);
+  flash_error_t efl_lld_start_erase_sector(void *instance,
+                                           flash_sector_t sector);
+  flash_error_t efl_lld_query_erase(void *instance, uint32_t *msec);
+  flash_error_t efl_lld_verify_erase(void *instance, flash_sector_t sector);
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* HAL_USE_EFL == TRUE */
+
+#endif /* HAL_EFL_LLD_H */
+
+/** @} */
@@ -0,0 +1,280 @@
+/*
+    ChibiOS - Copyright (C) 2006..2018 Giovanni Di Sirio
+
+    Licensed under the Apache License, Version 2.0 (the "License");
+    you may not use this file except in compliance with the License.
+    You may obtain a copy of the License at
+
+        http://www.apache.org/licenses/LICENSE-2.0
+
+    Unless required by applicable law or agreed to in writing, software
+    distributed under the License is distributed on an "AS IS" BASIS,
+    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+    See the License for the specific language governing permissions and
+    limitations under the License.
+*/
+
+/**
+ * @file    simulator/posix/hal_i2c_lld.c
+ * @brief   Posix simulator low level I2C driver code.
+ * @details The transaction is performed by the simulated device when it is
+ *          started, the calling thread is then suspended for the time
+ *          required by the configured bit rate, meanwhile the CPU can
+ *          perform other activities as it would with a DMA transfer.
+ *
+ * @addtogroup POSIX_I2C
+ * @{
+ */
+
+#include "hal.h"
+
+#if (HAL_USE_I2C == TRUE) || defined(__DOXYGEN__)
+
+/*===========================================================================*/
+/* Driver local definitions.                                                 */
+/*===========================================================================*/
+
+/**
+ * @brief   Bits on the bus for each byte, acknowledge included.
+ */
+#define I2C_BITS_PER_BYTE               9U
+
+/*===========================================================================*/
+/* Driver exported variables.                                                */
+/*===========================================================================*/
+
+/**
+ * @brief   I2C1 driver identifier.
+ */
+#if (USE_SIM_I2C1 == TRUE) || defined(__DOXYGEN__)
+I2CDriver I2CD1;
+#endif
+
+/*===========================================================================*/
+/* Driver local variables and types.                                         */
+/*===========================================================================*/
+
+/*===========================================================================*/
+/* Driver local functions.                                                   */
+/*===========================================================================*/
+
+/**
+ * @brief   Performs a transaction and waits for its completion.
+ *
+ * @param[in] i2cp      pointer to the @p I2CDriver object
+ * @param[in] addr      slave device address
+ * @param[in] txbuf     pointer to the transmit buffer
+ * @param[in] txbytes   number of bytes to be transmitted
+ * @param[out] rxbuf    pointer to the receive buffer
+ * @param[in] rxbytes   number of bytes to be received
+ * @param[in] timeout   the number of ticks before the operation timeouts
+ * @return              The operation status.
+ */
+static msg_t i2c_lld_transfer(I2CDriver *i2cp, i2caddr_t addr,
+                              const uint8_t *txbuf, size_t txbytes,
+                              uint8_t *rxbuf, size_t rxbytes,
+                              sysinterval_t timeout) {
+  const SimI2CDevice *devp = NULL;
+  size_t i, n;
+  uint64_t t;
+
+  for (i = 0U; i < i2cp->config->ndevices; i++) {
+    if (i2cp->config->devices[i].addr == addr) {
+      devp = &i2cp->config->devices[i];
+      break;
+    }
+  }
+
+  /* Bytes on the bus, the transaction stops at the address byte if it
+     is not acknowledged.*/
+  if ((devp == NULL) ||
+      !devp->transfer(devp->arg, txbuf, txbytes, rxbuf, rxbytes)) {
+    i2cp->errors |= I2C_ACK_FAILURE;
+    n = 1U;
+  }
+  else {
+    n = 0U;
+    if (txbytes > 0U) {
+      n += 1U + txbytes;
+    }
+    if (rxbytes > 0U) {
+      n += 1U + rxbytes;
+    }
+  }
+  i2cp->transfers += 1U;
+  i2cp->bytes     += (uint32_t)n;
+
+  t = (uint64_t)i2cp->config->setup_time;
+  if (i2cp->config->bitrate > 0U) {
+    t += ((uint64_t)n * I2C_BITS_PER_BYTE * 1000000000U) /
+         i2cp->config->bitrate;
+  }
+  if (t == 0U) {
+    return i2cp->errors == I2C_NO_ERROR ? MSG_OK : MSG_RESET;
+  }
+
+  i2cp->deadline = _sim_get_time() + t;
+  return osalThreadSuspendTimeoutS(&i2cp->thread, timeout);
+}
+
+/*===========================================================================*/
+/* Driver interrupt handlers.                                                */
+/*===========================================================================*/
+
+/*===========================================================================*/
+/* Driver exported functions.                                                */
+/*===========================================================================*/
+
+/**
+ * @brief   Low level I2C driver initialization.
+ *
+ * @notapi
+ */
+void i2c_lld_init(void) {
+
+#if USE_SIM_I2C1 == TRUE
+  i2cObjectInit(&I2CD1);
+  I2CD1.thread    = NULL;
+  I2CD1.deadline  = 0U;
+  I2CD1.transfers = 0U;
+  I2CD1.bytes     = 0U;
+#endif
+}
+
+/**
+ * @brief   Configures and activates the I2C peripheral.
+ *
+ * @param[in] i2cp      pointer to the @p I2CDriver object
+ *
+ * @notapi
+ */
+void i2c_lld_start(I2CDriver *i2cp) {
+
+  (void)i2cp;
+}
+
+/**
+ * @brief   Deactivates the I2C peripheral.
+ *
+ * @param[in] i2cp      pointer to the @p I2CDriver object
+ *
+ * @notapi
+ */
+void i2c_lld_stop(I2CDriver *i2cp) {
+
+  (void)i2cp;
+}
+
+/**
+ * @brief   Transmits data via the I2C bus as master.
+ *
+ * @param[in] i2cp      pointer to the @p I2CDriver object
+ * @param[in] addr      slave device address
+ * @param[in] txbuf     pointer to the transmit buffer
+ * @param[in] txbytes   number of bytes to be transmitted
+ * @param[out] rxbuf    pointer to the receive buffer
+ * @param[in] rxbytes   number of bytes to be received
+ * @param[in] timeout   the number of ticks before the operation timeouts,
+ *                      the following special values are allowed:
+ *                      - @a TIME_INFINITE no timeout.
+ *                      .
+ * @return              The operation status.
+ * @retval MSG_OK       if the function succeeded.
+ * @retval MSG_RESET    if one or more I2C errors occurred, the errors can
+ *                      be retrieved using @p i2cGetErrors().
+ * @retval MSG_TIMEOUT  if a timeout occurred before operation end.
+ *
+ * @notapi
+ */
+msg_t i2c_lld_master_transmit_timeout(I2CDriver *i2cp, i2caddr_t addr,
+                                      const uint8_t *txbuf, size_t txbytes,
+                                      uint8_t *rxbuf, size_t rxbytes,
+                                      sysinterval_t timeout) {
+
+  return i2c_lld_transfer(i2cp, addr, txbuf, txbytes,
+                          rxbuf, rxbytes, timeout);
+}
+
+/**
+ * @brief   Receives data via the I2C bus as master.
+ *
+ * @param[in] i2cp      pointer to the @p I2CDriver object
+ * @param[in] addr      slave device address
+ * @param[out] rxbuf    pointer to the receive buffer
+ * @param[in] rxbytes   number of bytes to be received
+ * @param[in] timeout   the number of ticks before the operation timeouts,
+ *                      the following special values are allowed:
+ *                      - @a TIME_INFINITE no timeout.
+ *                      .
+ * @return              The operation status.
+ * @retval MSG_OK       if the function succeeded.
+ * @retval MSG_RESET    if one or more I2C errors occurred, the errors can
+ *                      be retrieved using @p i2cGetErrors().
+ * @retval MSG_TIMEOUT  if a timeout occurred before operation end.
+ *
+ * @notapi
+ */
+msg_t i2c_lld_master_receive_timeout(I2CDriver *i2cp, i2caddr_t addr,
+                                     uint8_t *rxbuf, size_t rxbytes,
+                                     sysinterval_t timeout) {
+
+  return i2c_lld_transfer(i2cp, addr, NULL, 0U, rxbuf, rxbytes, timeout);
+}
+
+/**
+ * @brief   Transactions completion simulation.
+ *
+ * @return              The interrupt status.
+ * @retval false        if no transaction has been completed.
+ * @retval true         if a transaction completion has been signaled.
+ *
+ * @notapi
+ */
+bool i2c_lld_interrupt_pending(void) {
+  bool b = false;
+
+#if USE_SIM_I2C1 == TRUE
+  if ((I2CD1.thread != NULL) && (_sim_get_time() >= I2CD1.deadline)) {
+
+    OSAL_IRQ_PROLOGUE();
+
+    if (I2CD1.errors == I2C_NO_ERROR) {
+      _i2c_wakeup_isr(&I2CD1);
+    }
+    else {
+      _i2c_wakeup_error_isr(&I2CD1);
+    }
+
+    OSAL_IRQ_EPILOGUE();
+
+    b = true;
+  }
+#endif
+
+  return b;
+}
+
+/**
+ * @brief   Returns the completion time of the ongoing transaction.
+ *
+ * @return              The simulator time of the completion in
+ *                      nanoseconds.
+ * @retval 0            if there is no ongoing transaction.
+ *
+ * @notapi
+ */
+uint64_t i2c_lld_get_deadline(void) {
+  uint64_t deadline = 0U;
+
+#if USE_SIM_I2C1 == TRUE
+  if (I2CD1.thread != NULL) {
+    deadline = I2CD1.deadline;
+  }
+#endif
+
+  return deadline;
+}
+
+#endif /* HAL_USE_I2C == TRUE */
+
+/** @} */
@@ -0,0 +1,206 @@
+/*
+    ChibiOS - Copyright (C) 2006..2018 Giovanni Di Sirio
+
+    Licensed under the Apache License, Version 2.0 (the "License");
+    you may not use this file except in compliance with the License.
+    You may obtain a copy of the License at
+
+        http://www.apache.org/licenses/LICENSE-2.0
+
+    Unless required by applicable law or agreed to in writing, software
+    distributed under the License is distributed on an "AS IS" BASIS,
+    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+    See the License for the specific language governing permissions and
+    limitations under the License.
+*/
+
+/**
+ * @file    simulator/posix/hal_i2c_lld.h
+ * @brief   Posix simulator low level I2C driver header.
+ *
+ * @addtogroup POSIX_I2C
+ * @{
+ */
+
+#ifndef HAL_I2C_LLD_H
+#define HAL_I2C_LLD_H
+
+#if (HAL_USE_I2C == TRUE) || defined(__DOXYGEN__)
+
+/*===========================================================================*/
+/* Driver constants.                                                         */
+/*===========================================================================*/
+
+/*===========================================================================*/
+/* Driver pre-compile time settings.                                         */
+/*===========================================================================*/
+
+/**
+ * @brief   I2CD1 driver enable switch.
+ * @details If set to @p TRUE the support for I2CD1 is included.
+ * @note    The default is @p TRUE.
+ */
+#if !defined(USE_SIM_I2C1) || defined(__DOXYGEN__)
+#define USE_SIM_I2C1                    TRUE
+#endif
+
+/*===========================================================================*/
+/* Derived constants and error checks.                                       */
+/*===========================================================================*/
+
+/*===========================================================================*/
+/* Driver data structures and types.                                         */
+/*===========================================================================*/
+
+/**
+ * @brief   Type of a 7 bits I2C address.
+ */
+typedef uint16_t i2caddr_t;
+
+/**
+ * @brief   Type of I2C Driver condition flags.
+ */
+typedef uint32_t i2cflags_t;
+
+/**
+ * @brief   Simulated I2C slave device.
+ * @details Devices are connected to the bus by the I2C configuration, a
+ *          whole transaction is performed by the device at once.
+ */
+typedef struct {
+  /**
+   * @brief   Device address.
+   */
+  i2caddr_t                 addr;
+  /**
+   * @brief   Performs a transaction, the write phase, if any, is followed
+   *          by the read phase, if any. Returns @p false on acknowledge
+   *          failure.
+   */
+  bool                      (*transfer)(void *arg,
+                                        const uint8_t *txbuf, size_t txbytes,
+                                        uint8_t *rxbuf, size_t rxbytes);
+  /**
+   * @brief   Argument passed to the device functions.
+   */
+  void                      *arg;
+} SimI2CDevice;
+
+/**
+ * @brief   Type of I2C driver configuration structure.
+ */
+typedef struct hal_i2c_config {
+  /**
+   * @brief   Array of simulated slave devices.
+   */
+  const SimI2CDevice        *devices;
+  /**
+   * @brief   Number of simulated slave devices.
+   */
+  size_t                    ndevices;
+  /**
+   * @brief   Simulated bit rate in bits per second, zero for no transfer
+   *          time.
+   */
+  uint32_t                  bitrate;
+  /**
+   * @brief   Simulated setup time of each transaction in nanoseconds.
+   */
+  uint32_t                  setup_time;
+} I2CConfig;
+
+/**
+ * @brief   Type of a structure representing an I2C driver.
+ */
+typedef struct hal_i2c_driver I2CDriver;
+
+/**
+ * @brief   Structure representing an I2C driver.
+ */
+struct hal_i2c_driver {
+  /**
+   * @brief   Driver state.
+   */
+  i2cstate_t                state;
+  /**
+   * @brief   Current configuration data.
+   */
+  const I2CConfig           *config;
+  /**
+   * @brief   Error flags.
+   */
+  i2cflags_t                errors;
+#if (I2C_USE_MUTUAL_EXCLUSION == TRUE) || defined(__DOXYGEN__)
+  /**
+   * @brief   Mutex protecting the bus.
+   */
+  mutex_t                   mutex;
+#endif
+#if defined(I2C_DRIVER_EXT_FIELDS)
+  I2C_DRIVER_EXT_FIELDS
+#endif
+  /* End of the mandatory fields.*/
+  /**
+   * @brief   Thread waiting for the transaction completion.
+   */
+  thread_reference_t        thread;
+  /**
+   * @brief   Completion time of the transaction in progress, in
+   *          nanoseconds.
+   */
+  uint64_t                  deadline;
+  /**
+   * @brief   Number of transactions performed.
+   */
+  uint32_t                  transfers;
+  /**
+   * @brief   Number of bytes transferred, addresses included.
+   */
+  uint32_t                  bytes;
+};
+
+/*===========================================================================*/
+/* Driver macros.                                                            */
+/*===========================================================================*/
+
+/**
+ * @brief   Get errors from I2C driver.
+ *
+ * @param[in] i2cp      pointer to the @p I2CDriver object
+ *
+ * @notapi
+ */
+#define i2c_lld_get_errors(i2cp) ((i2cp)->errors)
+
+/*===========================================================================*/
+/* External declarations.                                                    */
+/*===========================================================================*/
+
+#if (USE_SIM_I2C1 == TRUE) && !defined(__DOXYGEN__)
+extern I2CDriver I2CD1;
+#endif
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+  void i2c_lld_init(void);
+  void i2c_lld_start(I2CDriver *i2cp);
+  void i2c_lld_stop(I2CDriver *i2cp);
+  msg_t i2c_lld_master_transmit_timeout(I2CDriver *i2cp, i2caddr_t addr,
+                                        const uint8_t *txbuf, size_t txbytes,
+                                        uint8_t *rxbuf, size_t rxbytes,
+                                        sysinterval_t timeout);
+  msg_t i2c_lld_master_receive_timeout(I2CDriver *i2cp, i2caddr_t addr,
+                                       uint8_t *rxbuf, size_t rxbytes,
+                                       sysinterval_t timeout);
+  bool i2c_lld_interrupt_pending(void);
+  uint64_t i2c_lld_get_deadline(void);
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* HAL_USE_I2C == TRUE */
+
+#endif /* HAL_I2C_LLD_H */
+
+/** @} */
@@ -33,6 +33,7 @@
 #include <netdb.h>
 #include <unistd.h>
 #include <fcntl.h>
+#include <poll.h>
 #endif
 #include <stdio.h>
 
@@ -53,10 +54,76 @@
 /* Driver pre-compile time settings.                                         */
 /*===========================================================================*/
 
+/**
+ * @brief   Event-driven simulation switch.
+ * @details If set to @p TRUE the idle loop suspends the host process until
+ *          the next timer deadline or until activity is detected on the
+ *          simulated peripherals, else the idle loop keeps polling for
+ *          simulated interrupts.
+ * @note    The default is @p TRUE on Linux hosts.
+ */
+#if !defined(SIM_EVENT_DRIVEN) || defined(__DOXYGEN__)
+#if defined(__linux__) || defined(__DOXYGEN__)
+#define SIM_EVENT_DRIVEN                    TRUE
+#else
+#define SIM_EVENT_DRIVEN                    FALSE
+#endif
+#endif
+
+/**
+ * @brief   Maximum number of host descriptors watched while idle.
+ */
+#if !defined(SIM_WAIT_FDS_MAX) || defined(__DOXYGEN__)
+#define SIM_WAIT_FDS_MAX                    8
+#endif
+
+/**
+ * @brief   Virtual time switch.
+ * @details If set to @p TRUE the simulator time is decoupled from the host
+ *          clock: it advances by @p SIM_VT_POLL_CYCLES on each interrupts
+ *          check performed by a running thread and, when all threads are
+ *          idle, it jumps straight to the next peripheral deadline. The
+ *          realtime counter counts simulated CPU cycles.
+ * @note    Execution becomes deterministic as long as the simulated
+ *          serial ports are not used.
+ * @note    Busy loops must call @p _sim_check_for_interrupts() or time
+ *          does not advance.
+ * @note    The default is @p FALSE.
+ */
+#if !defined(SIM_VIRTUAL_TIME) || defined(__DOXYGEN__)
+#define SIM_VIRTUAL_TIME                    FALSE
+#endif
+
+/**
+ * @brief   Simulated CPU clock frequency in virtual time mode.
+ */
+#if !defined(SIM_VT_FREQUENCY) || defined(__DOXYGEN__)
+#define SIM_VT_FREQUENCY                    100000000U
+#endif
+
+/**
+ * @brief   Simulated CPU cycles consumed by each interrupts check.
+ */
+#if !defined(SIM_VT_POLL_CYCLES) || defined(__DOXYGEN__)
+#define SIM_VT_POLL_CYCLES                  100U
+#endif
+
 /*===========================================================================*/
 /* Derived constants and error checks.                                       */
 /*===========================================================================*/
 
+#if (SIM_EVENT_DRIVEN == TRUE) && !defined(__linux__)
+#error "SIM_EVENT_DRIVEN requires a Linux host"
+#endif
+
+#if (SIM_VT_FREQUENCY < 1000000U) || (SIM_VT_FREQUENCY > 1000000000U)
+#error "SIM_VT_FREQUENCY out of range"
+#endif
+
+#if SIM_VT_POLL_CYCLES < 1U
+#error "invalid SIM_VT_POLL_CYCLES value"
+#endif
+
 /*===========================================================================*/
 /* Driver data structures and types.                                         */
 /*===========================================================================*/
@@ -70,6 +137,9 @@ extern "C" {
 #endif
   void hal_lld_init(void);
   void _sim_check_for_interrupts(void);
+  void _sim_wait_for_interrupts(void);
+  uint64_t _sim_get_time(void);
+  uint64_t _sim_get_rt_counter(void);
 #ifdef __cplusplus
 }
 #endif
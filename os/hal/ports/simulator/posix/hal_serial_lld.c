@@ -25,6 +25,7 @@
 #include <stdlib.h>
 #include <string.h>
 #include <errno.h>
+#include <sys/uio.h>
 
 #include "hal.h"
 
@@ -52,6 +53,13 @@ SerialDriver SD2;
 static const SerialConfig default_config = {
 };
 
+/**
+ * @brief   Receive buffer shared by all drivers.
+ * @note    Interrupt sources are served one at time so a single buffer is
+ *          enough.
+ */
+static uint8_t sim_rx_buffer[SERIAL_BUFFERS_SIZE];
+
 /*===========================================================================*/
 /* Driver local functions.                                                   */
 /*===========================================================================*/
@@ -147,13 +155,21 @@ abort:
 static bool inint(SerialDriver *sdp) {
 
   if (sdp->com_data != -1) {
-    int i;
-    uint8_t data[32];
+    size_t space;
+    ssize_t n;
+
+    /* Only the data fitting in the input queue is taken from the socket,
+       the rest is left to the host TCP flow control.*/
+    osalSysLockFromISR();
+    space = iqGetEmptyI(&sdp->iqueue);
+    osalSysUnlockFromISR();
+    if (space == (size_t)0)
+      return false;
 
     /*
      * Input.
      */
-    int n = recv(sdp->com_data, data, sizeof(data), 0);
+    n = recv(sdp->com_data, sim_rx_buffer, space, 0);
     switch (n) {
     case 0:
       close(sdp->com_data);
@@ -169,11 +185,9 @@ static bool inint(SerialDriver *sdp) {
       sdp->com_data = -1;
       return false;
     }
-    for (i = 0; i < n; i++) {
-      osalSysLockFromISR();
-      sdIncomingDataI(sdp, data[i]);
-      osalSysUnlockFromISR();
-    }
+    osalSysLockFromISR();
+    sdIncomingDataBufferI(sdp, sim_rx_buffer, (size_t)n);
+    osalSysUnlockFromISR();
     return true;
   }
   return false;
@@ -182,19 +196,30 @@ static bool inint(SerialDriver *sdp) {
 static bool outint(SerialDriver *sdp) {
 
   if (sdp->com_data != -1) {
-    int n;
-    uint8_t data[1];
+    output_queue_t *oqp = &sdp->oqueue;
+    struct iovec iov[2];
+    size_t full;
+    ssize_t n;
 
     /*
-     * Input.
+     * Output, the queue content is sent in place as up to two segments.
      */
     osalSysLockFromISR();
-    n = sdRequestDataI(sdp);
+    full = oqGetFullI(oqp);
     osalSysUnlockFromISR();
-    if (n < 0)
+    if (full == (size_t)0)
       return false;
-    data[0] = (uint8_t)n;
-    n = send(sdp->com_data, data, sizeof(data), 0);
+    iov[0].iov_base = oqp->q_rdptr;
+    iov[0].iov_len  = (size_t)(oqp->q_top - oqp->q_rdptr);
+    if (iov[0].iov_len >= full) {
+      iov[0].iov_len = full;
+      iov[1].iov_len = 0;
+    }
+    else {
+      iov[1].iov_base = oqp->q_buffer;
+      iov[1].iov_len  = full - iov[0].iov_len;
+    }
+    n = writev(sdp->com_data, iov, iov[1].iov_len > 0U ? 2 : 1);
     switch (n) {
     case 0:
       close(sdp->com_data);
@@ -210,11 +235,49 @@ static bool outint(SerialDriver *sdp) {
       sdp->com_data = -1;
       return false;
     }
+    osalSysLockFromISR();
+    oqConsumeI(oqp, (size_t)n);
+    if (oqIsEmptyI(oqp))
+      chnAddFlagsI(sdp, CHN_OUTPUT_EMPTY);
+    osalSysUnlockFromISR();
     return true;
   }
   return false;
 }
 
+#if (SIM_EVENT_DRIVEN == TRUE) || defined(__DOXYGEN__)
+static unsigned wait_fds(SerialDriver *sdp, struct pollfd *fds, unsigned n) {
+
+  if (n == 0U) {
+    return 0U;
+  }
+
+  if (sdp->com_data != -1) {
+    fds->fd      = sdp->com_data;
+    fds->events  = 0;
+    fds->revents = 0;
+    osalSysLock();
+    if (!iqIsFullI(&sdp->iqueue)) {
+      fds->events |= POLLIN;
+    }
+    if (!oqIsEmptyI(&sdp->oqueue)) {
+      fds->events |= POLLOUT;
+    }
+    osalSysUnlock();
+    return 1U;
+  }
+
+  if (sdp->com_listen != -1) {
+    fds->fd      = sdp->com_listen;
+    fds->events  = POLLIN;
+    fds->revents = 0;
+    return 1U;
+  }
+
+  return 0U;
+}
+#endif /* SIM_EVENT_DRIVEN == TRUE */
+
 /*===========================================================================*/
 /* Driver interrupt handlers.                                                */
 /*===========================================================================*/
@@ -293,6 +356,34 @@ bool sd_lld_interrupt_pending(void) {
   return b;
 }
 
+#if (SIM_EVENT_DRIVEN == TRUE) || defined(__DOXYGEN__)
+/**
+ * @brief   Returns the host descriptors to be watched while idle.
+ * @details Data sockets are watched for input if there is space in the
+ *          input queue and for output space if there is data in the output
+ *          queue. Listen sockets are watched for incoming connections while
+ *          there is no connection.
+ *
+ * @param[out] fds      array of @p pollfd structures to be filled
+ * @param[in] n         number of elements in the array
+ * @return              The number of filled elements.
+ *
+ * @notapi
+ */
+unsigned sd_lld_get_wait_fds(struct pollfd *fds, unsigned n) {
+  unsigned i = 0U;
+
+#if USE_SIM_SERIAL1
+  i += wait_fds(&SD1, &fds[i], n - i);
+#endif
+#if USE_SIM_SERIAL2
+  i += wait_fds(&SD2, &fds[i], n - i);
+#endif
+
+  return i;
+}
+#endif /* SIM_EVENT_DRIVEN == TRUE */
+
 #endif /* HAL_USE_SERIAL */
 
 /** @} */
@@ -132,6 +132,9 @@ extern "C" {
   void sd_lld_start(SerialDriver *sdp, const SerialConfig *config);
   void sd_lld_stop(SerialDriver *sdp);
   bool sd_lld_interrupt_pending(void);
+#if SIM_EVENT_DRIVEN == TRUE
+  unsigned sd_lld_get_wait_fds(struct pollfd *fds, unsigned n);
+#endif
 #ifdef __cplusplus
 }
 #endif
@@ -0,0 +1,311 @@
+/*
+    ChibiOS - Copyright (C) 2006..2018 Giovanni Di Sirio
+
+    Licensed under the Apache License, Version 2.0 (the "License");
+    you may not use this file except in compliance with the License.
+    You may obtain a copy of the License at
+
+        http://www.apache.org/licenses/LICENSE-2.0
+
+    Unless required by applicable law or agreed to in writing, software
+    distributed under the License is distributed on an "AS IS" BASIS,
+    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+    See the License for the specific language governing permissions and
+    limitations under the License.
+*/
+
+/**
+ * @file    simulator/posix/hal_spi_lld.c
+ * @brief   Posix simulator low level SPI driver code.
+ * @details The data is exchanged with the simulated device when a transfer
+ *          is started, the transfer completion is signaled after the time
+ *          required by the configured bit rate, meanwhile the CPU can
+ *          perform other activities as it would with a DMA transfer.
+ *
+ * @addtogroup POSIX_SPI
+ * @{
+ */
+
+#include "hal.h"
+
+#if (HAL_USE_SPI == TRUE) || defined(__DOXYGEN__)
+
+/*===========================================================================*/
+/* Driver local definitions.                                                 */
+/*===========================================================================*/
+
+/*===========================================================================*/
+/* Driver exported variables.                                                */
+/*===========================================================================*/
+
+/**
+ * @brief   SPI1 driver identifier.
+ */
+#if (USE_SIM_SPI1 == TRUE) || defined(__DOXYGEN__)
+SPIDriver SPID1;
+#endif
+
+/*===========================================================================*/
+/* Driver local variables and types.                                         */
+/*===========================================================================*/
+
+/*===========================================================================*/
+/* Driver local functions.                                                   */
+/*===========================================================================*/
+
+/**
+ * @brief   Exchanges frames with the device and schedules the completion.
+ *
+ * @param[in] spip      pointer to the @p SPIDriver object
+ * @param[in] n         number of frames to be exchanged
+ * @param[in] txbuf     the pointer to the transmit buffer or @p NULL
+ * @param[out] rxbuf    the pointer to the receive buffer or @p NULL
+ */
+static void spi_lld_transfer(SPIDriver *spip, size_t n,
+                             const uint8_t *txbuf, uint8_t *rxbuf) {
+  const SimSPIDevice *devp = spip->config->device;
+  uint64_t t;
+  size_t i;
+
+  for (i = 0U; i < n; i++) {
+    uint8_t frame = txbuf != NULL ? txbuf[i] : 0xFFU;
+
+    if (devp != NULL) {
+      frame = devp->exchange(devp->arg, frame);
+    }
+    else {
+      frame = 0xFFU;
+    }
+    if (rxbuf != NULL) {
+      rxbuf[i] = frame;
+    }
+  }
+
+  t = (uint64_t)spip->config->setup_time;
+  if (spip->config->bitrate > 0U) {
+    t += ((uint64_t)n * 8U * 1000000000U) / spip->config->bitrate;
+  }
+
+  spip->deadline   = _sim_get_time() + t;
+  spip->transfers += 1U;
+  spip->frames    += (uint32_t)n;
+}
+
+/*===========================================================================*/
+/* Driver interrupt handlers.                                                */
+/*===========================================================================*/
+
+/*===========================================================================*/
+/* Driver exported functions.                                                */
+/*===========================================================================*/
+
+/**
+ * @brief   Low level SPI driver initialization.
+ *
+ * @notapi
+ */
+void spi_lld_init(void) {
+
+#if USE_SIM_SPI1 == TRUE
+  spiObjectInit(&SPID1);
+  SPID1.deadline  = 0U;
+  SPID1.transfers = 0U;
+  SPID1.frames    = 0U;
+#endif
+}
+
+/**
+ * @brief   Configures and activates the SPI peripheral.
+ *
+ * @param[in] spip      pointer to the @p SPIDriver object
+ *
+ * @notapi
+ */
+void spi_lld_start(SPIDriver *spip) {
+
+  (void)spip;
+}
+
+/**
+ * @brief   Deactivates the SPI peripheral.
+ *
+ * @param[in] spip      pointer to the @p SPIDriver object
+ *
+ * @notapi
+ */
+void spi_lld_stop(SPIDriver *spip) {
+
+  (void)spip;
+}
+
+/**
+ * @brief   Asserts the slave select signal and prepares for transfers.
+ *
+ * @param[in] spip      pointer to the @p SPIDriver object
+ *
+ * @notapi
+ */
+void spi_lld_select(SPIDriver *spip) {
+  const SimSPIDevice *devp = spip->config->device;
+
+  if (devp != NULL) {
+    devp->select(devp->arg, true);
+  }
+}
+
+/**
+ * @brief   Deasserts the slave select signal.
+ * @details The previously selected peripheral is unselected.
+ *
+ * @param[in] spip      pointer to the @p SPIDriver object
+ *
+ * @notapi
+ */
+void spi_lld_unselect(SPIDriver *spip) {
+  const SimSPIDevice *devp = spip->config->device;
+
+  if (devp != NULL) {
+    devp->select(devp->arg, false);
+  }
+}
+
+/**
+ * @brief   Ignores data on the SPI bus.
+ * @details This asynchronous function starts the transmission of a series of
+ *          idle words on the SPI bus and ignores the received data.
+ * @post    At the end of the operation the configured callback is invoked.
+ *
+ * @param[in] spip      pointer to the @p SPIDriver object
+ * @param[in] n         number of words to be ignored
+ *
+ * @notapi
+ */
+void spi_lld_ignore(SPIDriver *spip, size_t n) {
+
+  spi_lld_transfer(spip, n, NULL, NULL);
+}
+
+/**
+ * @brief   Exchanges data on the SPI bus.
+ * @details This asynchronous function starts a simultaneous transmit/receive
+ *          operation.
+ * @post    At the end of the operation the configured callback is invoked.
+ *
+ * @param[in] spip      pointer to the @p SPIDriver object
+ * @param[in] n         number of words to be exchanged
+ * @param[in] txbuf     the pointer to the transmit buffer
+ * @param[out] rxbuf    the pointer to the receive buffer
+ *
+ * @notapi
+ */
+void spi_lld_exchange(SPIDriver *spip, size_t n,
+                      const void *txbuf, void *rxbuf) {
+
+  spi_lld_transfer(spip, n, (const uint8_t *)txbuf, (uint8_t *)rxbuf);
+}
+
+/**
+ * @brief   Sends data over the SPI bus.
+ * @details This asynchronous function starts a transmit operation.
+ * @post    At the end of the operation the configured callback is invoked.
+ *
+ * @param[in] spip      pointer to the @p SPIDriver object
+ * @param[in] n         number of words to send
+ * @param[in] txbuf     the pointer to the transmit buffer
+ *
+ * @notapi
+ */
+void spi_lld_send(SPIDriver *spip, size_t n, const void *txbuf) {
+
+  spi_lld_transfer(spip, n, (const uint8_t *)txbuf, NULL);
+}
+
+/**
+ * @brief   Receives data from the SPI bus.
+ * @details This asynchronous function starts a receive operation.
+ * @post    At the end of the operation the configured callback is invoked.
+ *
+ * @param[in] spip      pointer to the @p SPIDriver object
+ * @param[in] n         number of words to receive
+ * @param[out] rxbuf    the pointer to the receive buffer
+ *
+ * @notapi
+ */
+void spi_lld_receive(SPIDriver *spip, size_t n, void *rxbuf) {
+
+  spi_lld_transfer(spip, n, NULL, (uint8_t *)rxbuf);
+}
+
+/**
+ * @brief   Exchanges one frame using a polled wait.
+ * @details This synchronous function exchanges one frame using a polled
+ *          synchronization method.
+ *
+ * @param[in] spip      pointer to the @p SPIDriver object
+ * @param[in] frame     the data frame to send over the SPI bus
+ * @return              The received data frame from the SPI bus.
+ *
+ * @notapi
+ */
+uint16_t spi_lld_polled_exchange(SPIDriver *spip, uint16_t frame) {
+  const SimSPIDevice *devp = spip->config->device;
+
+  spip->frames += 1U;
+  if (devp != NULL) {
+    return (uint16_t)devp->exchange(devp->arg, (uint8_t)frame);
+  }
+  return 0xFFU;
+}
+
+/**
+ * @brief   Transfers completion simulation.
+ *
+ * @return              The interrupt status.
+ * @retval false        if no transfer has been completed.
+ * @retval true         if a transfer completion has been signaled.
+ *
+ * @notapi
+ */
+bool spi_lld_interrupt_pending(void) {
+  bool b = false;
+
+#if USE_SIM_SPI1 == TRUE
+  if ((SPID1.state == SPI_ACTIVE) && (_sim_get_time() >= SPID1.deadline)) {
+
+    OSAL_IRQ_PROLOGUE();
+
+    _spi_isr_code(&SPID1);
+
+    OSAL_IRQ_EPILOGUE();
+
+    b = true;
+  }
+#endif
+
+  return b;
+}
+
+/**
+ * @brief   Returns the completion time of the ongoing transfer.
+ *
+ * @return              The simulator time of the completion in
+ *                      nanoseconds.
+ * @retval 0            if there is no ongoing transfer.
+ *
+ * @notapi
+ */
+uint64_t spi_lld_get_deadline(void) {
+  uint64_t deadline = 0U;
+
+#if USE_SIM_SPI1 == TRUE
+  if (SPID1.state == SPI_ACTIVE) {
+    deadline = SPID1.deadline;
+  }
+#endif
+
+  return deadline;
+}
+
+#endif /* HAL_USE_SPI == TRUE */
+
+/** @} */
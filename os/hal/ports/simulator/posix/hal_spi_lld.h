@@ -0,0 +1,142 @@
+/*
+    ChibiOS - Copyright (C) 2006..2018 Giovanni Di Sirio
+
+    Licensed under the Apache License, Version 2.0 (the "License");
+    you may not use this file except in compliance with the License.
+    You may obtain a copy of the License at
+
+        http://www.apache.org/licenses/LICENSE-2.0
+
+    Unless required by applicable law or agreed to in writing, software
+    distributed under the License is distributed on an "AS IS" BASIS,
+    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+    See the License for the specific language governing permissions and
+    limitations under the License.
+*/
+
+/**
+ * @file    simulator/posix/hal_spi_lld.h
+ * @brief   Posix simulator low level SPI driver header.
+ *
+ * @addtogroup POSIX_SPI
+ * @{
+ */
+
+#ifndef HAL_SPI_LLD_H
+#define HAL_SPI_LLD_H
+
+#if (HAL_USE_SPI == TRUE) || defined(__DOXYGEN__)
+
+/*===========================================================================*/
+/* Driver constants.                                                         */
+/*===========================================================================*/
+
+/**
+ * @brief   Circular mode support flag.
+ */
+#define SPI_SUPPORTS_CIRCULAR           FALSE
+
+/*===========================================================================*/
+/* Driver pre-compile time settings.                                         */
+/*===========================================================================*/
+
+/**
+ * @brief   SPID1 driver enable switch.
+ * @details If set to @p TRUE the support for SPID1 is included.
+ * @note    The default is @p TRUE.
+ */
+#if !defined(USE_SIM_SPI1) || defined(__DOXYGEN__)
+#define USE_SIM_SPI1                    TRUE
+#endif
+
+/*===========================================================================*/
+/* Derived constants and error checks.                                       */
+/*===========================================================================*/
+
+#if SPI_SELECT_MODE != SPI_SELECT_MODE_LLD
+#error "the simulator SPI driver requires SPI_SELECT_MODE_LLD"
+#endif
+
+/*===========================================================================*/
+/* Driver data structures and types.                                         */
+/*===========================================================================*/
+
+/**
+ * @brief   Simulated SPI slave device.
+ * @details The device is connected to the bus by the SPI configuration,
+ *          frames are exchanged with the device one at time.
+ */
+typedef struct {
+  /**
+   * @brief   Slave select line change.
+   */
+  void                      (*select)(void *arg, bool selected);
+  /**
+   * @brief   Exchanges a frame, returns the frame sent by the device.
+   */
+  uint8_t                   (*exchange)(void *arg, uint8_t frame);
+  /**
+   * @brief   Argument passed to the device functions.
+   */
+  void                      *arg;
+} SimSPIDevice;
+
+/*===========================================================================*/
+/* Driver macros.                                                            */
+/*===========================================================================*/
+
+/**
+ * @brief   Low level fields of the SPI driver structure.
+ */
+#define spi_lld_driver_fields                                               \
+  /* Completion time of the transfer in progress, in nanoseconds.*/         \
+  uint64_t                  deadline;                                       \
+  /* Number of transfers performed.*/                                       \
+  uint32_t                  transfers;                                      \
+  /* Number of frames exchanged.*/                                          \
+  uint32_t                  frames
+
+/**
+ * @brief   Low level fields of the SPI configuration structure.
+ */
+#define spi_lld_config_fields                                               \
+  /* Simulated slave device.*/                                              \
+  const SimSPIDevice        *device;                                        \
+  /* Simulated bit rate in bits per second, zero for no transfer time.*/    \
+  uint32_t                  bitrate;                                        \
+  /* Simulated setup time of each transfer in nanoseconds.*/                \
+  uint32_t                  setup_time
+
+/*===========================================================================*/
+/* External declarations.                                                    */
+/*===========================================================================*/
+
+#if (USE_SIM_SPI1 == TRUE) && !defined(__DOXYGEN__)
+extern SPIDriver SPID1;
+#endif
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+  void spi_lld_init(void);
+  void spi_lld_start(SPIDriver *spip);
+  void spi_lld_stop(SPIDriver *spip);
+  void spi_lld_select(SPIDriver *spip);
+  void spi_lld_unselect(SPIDriver *spip);
+  void spi_lld_ignore(SPIDriver *spip, size_t n);
+  void spi_lld_exchange(SPIDriver *spip, size_t n,
+                        const void *txbuf, void *rxbuf);
+  void spi_lld_send(SPIDriver *spip, size_t n, const void *txbuf);
+  void spi_lld_receive(SPIDriver *spip, size_t n, void *rxbuf);
+  uint16_t spi_lld_polled_exchange(SPIDriver *spip, uint16_t frame);
+  bool spi_lld_interrupt_pending(void);
+  uint64_t spi_lld_get_deadline(void);
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* HAL_USE_SPI == TRUE */
+
+#endif /* HAL_SPI_LLD_H */
+
+/** @} */
@@ -0,0 +1,711 @@
+/*
+    ChibiOS - Copyright (C) 2006..2018 Giovanni Di Sirio
+
+    Licensed under the Apache License, Version 2.0 (the "License");
+    you may not use this file except in compliance with the License.
+    You may obtain a copy of the License at
+
+        http://www.apache.org/licenses/LICENSE-2.0
+
+    Unless required by applicable law or agreed to in writing, software
+    distributed under the License is distributed on an "AS IS" BASIS,
+    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+    See the License for the specific language governing permissions and
+    limitations under the License.
+*/
+
+/**
+ * @file    simulator/posix/hal_usb_lld.c
+ * @brief   Posix simulator low level USB driver code.
+ * @details The simulated device is attached to a loopback host: after
+ *          connection the host resets the bus and selects configuration
+ *          one, then packets transmitted on an IN endpoint are sent back
+ *          to the OUT endpoint with the same number.<br>
+ *          The bus transfers one packet at time, the packet time depends
+ *          on the simulated speed. The packets of a transfer are back to
+ *          back while restarting an endpoint costs @p SIM_USB_NAK_TIME,
+ *          so the throughput depends on the transfers size as it would
+ *          happen with a real host.
+ *
+ * @addtogroup POSIX_USB
+ * @{
+ */
+
+#include <string.h>
+
+#include "hal.h"
+
+#if (HAL_USE_USB == TRUE) || defined(__DOXYGEN__)
+
+/*===========================================================================*/
+/* Driver local definitions.                                                 */
+/*===========================================================================*/
+
+/**
+ * @brief   Delay of the host enumeration steps in nanoseconds.
+ */
+#define USB_HOST_STEP_TIME          1000000U
+
+/**
+ * @name    Simulated events
+ * @{
+ */
+#define USB_SIM_NONE                0U
+#define USB_SIM_HOST                1U
+#define USB_SIM_SOF                 2U
+#define USB_SIM_IN                  3U
+#define USB_SIM_OUT                 4U
+/** @} */
+
+/*===========================================================================*/
+/* Driver exported variables.                                                */
+/*===========================================================================*/
+
+/**
+ * @brief   USB1 driver identifier.
+ */
+#if (USE_SIM_USB1 == TRUE) || defined(__DOXYGEN__)
+USBDriver USBD1;
+#endif
+
+/*===========================================================================*/
+/* Driver local variables and types.                                         */
+/*===========================================================================*/
+
+/**
+ * @brief   EP0 state.
+ * @note    It is an union because IN and OUT endpoints are never used at the
+ *          same time for EP0.
+ */
+static union {
+  /**
+   * @brief   IN EP0 state.
+   */
+  USBInEndpointState in;
+  /**
+   * @brief   OUT EP0 state.
+   */
+  USBOutEndpointState out;
+} ep0_state;
+
+/**
+ * @brief   EP0 initialization structure.
+ */
+static const USBEndpointConfig ep0config = {
+  USB_EP_MODE_TYPE_CTRL,
+  _usb_ep0setup,
+  _usb_ep0in,
+  _usb_ep0out,
+  0x40,
+  0x40,
+  &ep0_state.in,
+  &ep0_state.out
+};
+
+/*===========================================================================*/
+/* Driver local functions.                                                   */
+/*===========================================================================*/
+
+/**
+ * @brief   Time of a packet on the bus.
+ *
+ * @param[in] n         packet size
+ * @return              The packet time in nanoseconds.
+ */
+static uint64_t usb_sim_packet_time(size_t n) {
+
+  return (((uint64_t)n + SIM_USB_PACKET_OVERHEAD) * 8U * 1000000000U) /
+         SIM_USB_BITRATE;
+}
+
+/**
+ * @brief   Current time for the simulated bus.
+ * @details Endpoints restarted by the callbacks are restarted at the time
+ *          of the event being served.
+ *
+ * @param[in] usbp      pointer to the @p USBDriver object
+ * @return              The time in nanoseconds.
+ */
+static uint64_t usb_sim_time(USBDriver *usbp) {
+
+  return usbp->serving ? usbp->now : _sim_get_time();
+}
+
+/**
+ * @brief   Size of the next packet of an IN endpoint.
+ *
+ * @param[in] usbp      pointer to the @p USBDriver object
+ * @param[in] ep        endpoint number
+ * @return              The packet size.
+ */
+static size_t usb_sim_in_size(USBDriver *usbp, usbep_t ep) {
+  USBInEndpointState *isp = usbp->epc[ep]->in_state;
+  size_t n = isp->txsize - isp->txcnt;
+
+  if (n > (size_t)usbp->epc[ep]->in_maxsize) {
+    n = (size_t)usbp->epc[ep]->in_maxsize;
+  }
+
+  return n;
+}
+
+/**
+ * @brief   Finds the next simulated event.
+ * @details The bus serves the endpoint able to complete a packet first,
+ *          IN endpoints need space in the host loopback FIFO and OUT
+ *          endpoints need packets in it.
+ *
+ * @param[in] usbp      pointer to the @p USBDriver object
+ * @param[out] epp      endpoint of the next packet
+ * @param[out] timep    time of the event
+ * @return              The event type.
+ */
+static unsigned usb_sim_next(USBDriver *usbp, usbep_t *epp,
+                             uint64_t *timep) {
+  unsigned event = USB_SIM_NONE;
+  uint64_t t = 0U;
+  usbep_t ep;
+
+  if (!usbp->connected) {
+    return USB_SIM_NONE;
+  }
+
+  if (usbp->host_time != 0U) {
+    event = USB_SIM_HOST;
+    t     = usbp->host_time;
+  }
+
+  if ((usbp->sof_time != 0U) &&
+      ((event == USB_SIM_NONE) || (usbp->sof_time < t))) {
+    event = USB_SIM_SOF;
+    t     = usbp->sof_time;
+  }
+
+  for (ep = 0U; ep <= (usbep_t)USB_MAX_ENDPOINTS; ep++) {
+    uint16_t mask = (uint16_t)(1U << ep);
+    uint64_t end;
+
+    if (usbp->epc[ep] == NULL) {
+      continue;
+    }
+
+    if (((usbp->transmitting & mask) != 0U) &&
+        ((usbp->in_stalled & mask) == 0U) &&
+        ((ep == 0U) || (usbp->loopback[ep - 1U].cnt <
+                        (unsigned)SIM_USB_LOOPBACK_PACKETS))) {
+      end = usbp->in_ready[ep] > usbp->bus_time ?
+            usbp->in_ready[ep] : usbp->bus_time;
+      end += usb_sim_packet_time(usb_sim_in_size(usbp, ep));
+      if ((event == USB_SIM_NONE) || (end < t)) {
+        event = USB_SIM_IN;
+        t     = end;
+        *epp  = ep;
+      }
+    }
+
+    if (((usbp->receiving & mask) != 0U) &&
+        ((usbp->out_stalled & mask) == 0U) &&
+        (ep > 0U) && (usbp->loopback[ep - 1U].cnt > 0U)) {
+      sim_usb_loopback_t *lbp = &usbp->loopback[ep - 1U];
+
+      end = usbp->out_ready[ep] > usbp->bus_time ?
+            usbp->out_ready[ep] : usbp->bus_time;
+      end += usb_sim_packet_time(lbp->packets[lbp->rd].size);
+      if ((event == USB_SIM_NONE) || (end < t)) {
+        event = USB_SIM_OUT;
+        t     = end;
+        *epp  = ep;
+      }
+    }
+  }
+
+  *timep = t;
+
+  return event;
+}
+
+/**
+ * @brief   Performs the next enumeration step.
+ *
+ * @param[in] usbp      pointer to the @p USBDriver object
+ */
+static void usb_sim_host_step(USBDriver *usbp) {
+
+  switch (usbp->host_step) {
+  case 0:
+    /* Bus reset, SOFs start after it.*/
+    memset(usbp->loopback, 0, sizeof (usbp->loopback));
+    usbp->sof_time   = usbp->now + SIM_USB_FRAME_TIME;
+    usbp->host_time  = usbp->now + USB_HOST_STEP_TIME;
+    usbp->host_step  = 1U;
+    _usb_reset(usbp);
+    break;
+  default:
+    /* SET_CONFIGURATION(1), the enumeration is over.*/
+    usbp->host_setup[0] = USB_RTYPE_DIR_HOST2DEV | USB_RTYPE_TYPE_STD |
+                          USB_RTYPE_RECIPIENT_DEVICE;
+    usbp->host_setup[1] = USB_REQ_SET_CONFIGURATION;
+    usbp->host_setup[2] = 1U;
+    usbp->host_setup[3] = 0U;
+    usbp->host_setup[4] = 0U;
+    usbp->host_setup[5] = 0U;
+    usbp->host_setup[6] = 0U;
+    usbp->host_setup[7] = 0U;
+    usbp->host_time     = 0U;
+    _usb_isr_invoke_setup_cb(usbp, 0U);
+    break;
+  }
+}
+
+/**
+ * @brief   Transfers a packet from an IN endpoint to the host.
+ *
+ * @param[in] usbp      pointer to the @p USBDriver object
+ * @param[in] ep        endpoint number
+ */
+static void usb_sim_in_packet(USBDriver *usbp, usbep_t ep) {
+  USBInEndpointState *isp = usbp->epc[ep]->in_state;
+  size_t n = usb_sim_in_size(usbp, ep);
+
+  if (ep > 0U) {
+    sim_usb_loopback_t *lbp = &usbp->loopback[ep - 1U];
+    unsigned wr = (lbp->rd + lbp->cnt) % (unsigned)SIM_USB_LOOPBACK_PACKETS;
+
+    lbp->packets[wr].size = n;
+    if (n > 0U) {
+      memcpy(lbp->packets[wr].data, isp->txbuf + isp->txcnt, n);
+    }
+    lbp->cnt++;
+  }
+
+  isp->txcnt += n;
+  usbp->bus_time     = usbp->now;
+  usbp->in_ready[ep] = usbp->now;
+  usbp->packets++;
+
+  /* A short packet or the last one terminates the transfer.*/
+  if ((n < (size_t)usbp->epc[ep]->in_maxsize) || (isp->txcnt >= isp->txsize)) {
+    usbp->transfers++;
+    _usb_isr_invoke_in_cb(usbp, ep);
+  }
+}
+
+/**
+ * @brief   Transfers a packet from the host to an OUT endpoint.
+ *
+ * @param[in] usbp      pointer to the @p USBDriver object
+ * @param[in] ep        endpoint number
+ */
+static void usb_sim_out_packet(USBDriver *usbp, usbep_t ep) {
+  USBOutEndpointState *osp = usbp->epc[ep]->out_state;
+  sim_usb_loopback_t *lbp = &usbp->loopback[ep - 1U];
+  size_t size = lbp->packets[lbp->rd].size, n = size;
+
+  /* Data exceeding the transfer size is lost as it would happen on a
+     babble condition.*/
+  if (n > osp->rxsize - osp->rxcnt) {
+    n = osp->rxsize - osp->rxcnt;
+  }
+  if (n > 0U) {
+    memcpy(osp->rxbuf + osp->rxcnt, lbp->packets[lbp->rd].data, n);
+  }
+  lbp->rd = (lbp->rd + 1U) % (unsigned)SIM_USB_LOOPBACK_PACKETS;
+  lbp->cnt--;
+
+  osp->rxcnt += n;
+  usbp->bus_time      = usbp->now;
+  usbp->out_ready[ep] = usbp->now;
+  usbp->packets++;
+
+  /* A short packet or a full buffer terminates the transfer.*/
+  if ((size < (size_t)usbp->epc[ep]->out_maxsize) ||
+      (osp->rxcnt >= osp->rxsize)) {
+    usbp->transfers++;
+    _usb_isr_invoke_out_cb(usbp, ep);
+  }
+}
+
+/*===========================================================================*/
+/* Driver interrupt handlers.                                                */
+/*===========================================================================*/
+
+/*===========================================================================*/
+/* Driver exported functions.                                                */
+/*===========================================================================*/
+
+/**
+ * @brief   Low level USB driver initialization.
+ *
+ * @notapi
+ */
+void usb_lld_init(void) {
+
+#if USE_SIM_USB1 == TRUE
+  /* Driver initialization.*/
+  usbObjectInit(&USBD1);
+  USBD1.connected = false;
+  USBD1.serving   = false;
+#endif
+}
+
+/**
+ * @brief   Configures and activates the USB peripheral.
+ *
+ * @param[in] usbp      pointer to the @p USBDriver object
+ *
+ * @notapi
+ */
+void usb_lld_start(USBDriver *usbp) {
+
+  usbp->connected = false;
+  usbp->host_time = 0U;
+  usbp->sof_time  = 0U;
+  usbp->frame     = 0U;
+  usbp->bus_time  = 0U;
+  usbp->packets   = 0U;
+  usbp->transfers = 0U;
+}
+
+/**
+ * @brief   Deactivates the USB peripheral.
+ *
+ * @param[in] usbp      pointer to the @p USBDriver object
+ *
+ * @notapi
+ */
+void usb_lld_stop(USBDriver *usbp) {
+
+  usbp->connected = false;
+}
+
+/**
+ * @brief   Connects the USB device.
+ * @details The host starts the enumeration.
+ *
+ * @param[in] usbp      pointer to the @p USBDriver object
+ *
+ * @notapi
+ */
+void usb_lld_connect_bus(USBDriver *usbp) {
+
+  usbp->connected = true;
+  usbp->host_step = 0U;
+  usbp->host_time = usb_sim_time(usbp) + USB_HOST_STEP_TIME;
+  usbp->sof_time  = 0U;
+}
+
+/**
+ * @brief   Disconnects the USB device.
+ *
+ * @param[in] usbp      pointer to the @p USBDriver object
+ *
+ * @notapi
+ */
+void usb_lld_disconnect_bus(USBDriver *usbp) {
+
+  usbp->connected = false;
+  usbp->host_time = 0U;
+  usbp->sof_time  = 0U;
+}
+
+/**
+ * @brief   USB low level reset routine.
+ *
+ * @param[in] usbp      pointer to the @p USBDriver object
+ *
+ * @notapi
+ */
+void usb_lld_reset(USBDriver *usbp) {
+
+  usbp->in_stalled  = 0U;
+  usbp->out_stalled = 0U;
+
+  /* EP0 initialization.*/
+  usbp->epc[0] = &ep0config;
+  usb_lld_init_endpoint(usbp, 0U);
+}
+
+/**
+ * @brief   Sets the USB address.
+ *
+ * @param[in] usbp      pointer to the @p USBDriver object
+ *
+ * @notapi
+ */
+void usb_lld_set_address(USBDriver *usbp) {
+
+  (void)usbp;
+}
+
+/**
+ * @brief   Enables an endpoint.
+ *
+ * @param[in] usbp      pointer to the @p USBDriver object
+ * @param[in] ep        endpoint number
+ *
+ * @notapi
+ */
+void usb_lld_init_endpoint(USBDriver *usbp, usbep_t ep) {
+  uint16_t mask = (uint16_t)(1U << ep);
+
+  osalDbgAssert((usbp->epc[ep]->in_maxsize <= SIM_USB_MAX_PACKET_SIZE) &&
+                (usbp->epc[ep]->out_maxsize <= SIM_USB_MAX_PACKET_SIZE),
+                "packet size not supported");
+
+  usbp->in_stalled    &= (uint16_t)~mask;
+  usbp->out_stalled   &= (uint16_t)~mask;
+  usbp->in_ready[ep]   = 0U;
+  usbp->out_ready[ep]  = 0U;
+}
+
+/**
+ * @brief   Disables all the active endpoints except the endpoint zero.
+ *
+ * @param[in] usbp      pointer to the @p USBDriver object
+ *
+ * @notapi
+ */
+void usb_lld_disable_endpoints(USBDriver *usbp) {
+
+  usbp->in_stalled  &= 1U;
+  usbp->out_stalled &= 1U;
+}
+
+/**
+ * @brief   Returns the status of an OUT endpoint.
+ *
+ * @param[in] usbp      pointer to the @p USBDriver object
+ * @param[in] ep        endpoint number
+ * @return              The endpoint status.
+ * @retval EP_STATUS_DISABLED The endpoint is not active.
+ * @retval EP_STATUS_STALLED  The endpoint is stalled.
+ * @retval EP_STATUS_ACTIVE   The endpoint is active.
+ *
+ * @notapi
+ */
+usbepstatus_t usb_lld_get_status_out(USBDriver *usbp, usbep_t ep) {
+
+  if ((usbp->epc[ep] == NULL) || (usbp->epc[ep]->out_state == NULL)) {
+    return EP_STATUS_DISABLED;
+  }
+  if ((usbp->out_stalled & (1U << ep)) != 0U) {
+    return EP_STATUS_STALLED;
+  }
+  return EP_STATUS_ACTIVE;
+}
+
+/**
+ * @brief   Returns the status of an IN endpoint.
+ *
+ * @param[in] usbp      pointer to the @p USBDriver object
+ * @param[in] ep        endpoint number
+ * @return              The endpoint status.
+ * @retval EP_STATUS_DISABLED The endpoint is not active.
+ * @retval EP_STATUS_STALLED  The endpoint is stalled.
+ * @retval EP_STATUS_ACTIVE   The endpoint is active.
+ *
+ * @notapi
+ */
+usbepstatus_t usb_lld_get_status_in(USBDriver *usbp, usbep_t ep) {
+
+  if ((usbp->epc[ep] == NULL) || (usbp->epc[ep]->in_state == NULL)) {
+    return EP_STATUS_DISABLED;
+  }
+  if ((usbp->in_stalled & (1U << ep)) != 0U) {
+    return EP_STATUS_STALLED;
+  }
+  return EP_STATUS_ACTIVE;
+}
+
+/**
+ * @brief   Reads a setup packet from the dedicated packet buffer.
+ * @details This function must be invoked in the context of the @p setup_cb
+ *          callback in order to read the received setup packet.
+ * @pre     In order to use this function the endpoint must have been
+ *          initialized as a control endpoint.
+ * @post    The endpoint is ready to accept another packet.
+ *
+ * @param[in] usbp      pointer to the @p USBDriver object
+ * @param[in] ep        endpoint number
+ * @param[out] buf      buffer where to copy the packet data
+ *
+ * @notapi
+ */
+void usb_lld_read_setup(USBDriver *usbp, usbep_t ep, uint8_t *buf) {
+
+  (void)ep;
+
+  /* A setup packet clears the EP0 stall condition.*/
+  usbp->in_stalled  &= (uint16_t)~1U;
+  usbp->out_stalled &= (uint16_t)~1U;
+  memcpy(buf, usbp->host_setup, 8U);
+}
+
+/**
+ * @brief   Starts a receive operation on an OUT endpoint.
+ *
+ * @param[in] usbp      pointer to the @p USBDriver object
+ * @param[in] ep        endpoint number
+ *
+ * @notapi
+ */
+void usb_lld_start_out(USBDriver *usbp, usbep_t ep) {
+
+  usbp->out_ready[ep] = usb_sim_time(usbp) + SIM_USB_NAK_TIME;
+}
+
+/**
+ * @brief   Starts a transmit operation on an IN endpoint.
+ *
+ * @param[in] usbp      pointer to the @p USBDriver object
+ * @param[in] ep        endpoint number
+ *
+ * @notapi
+ */
+void usb_lld_start_in(USBDriver *usbp, usbep_t ep) {
+
+  usbp->in_ready[ep] = usb_sim_time(usbp) + SIM_USB_NAK_TIME;
+}
+
+/**
+ * @brief   Brings an OUT endpoint in the stalled state.
+ *
+ * @param[in] usbp      pointer to the @p USBDriver object
+ * @param[in] ep        endpoint number
+ *
+ * @notapi
+ */
+void usb_lld_stall_out(USBDriver *usbp, usbep_t ep) {
+
+  usbp->out_stalled |= (uint16_t)(1U << ep);
+}
+
+/**
+ * @brief   Brings an IN endpoint in the stalled state.
+ *
+ * @param[in] usbp      pointer to the @p USBDriver object
+ * @param[in] ep        endpoint number
+ *
+ * @notapi
+ */
+void usb_lld_stall_in(USBDriver *usbp, usbep_t ep) {
+
+  usbp->in_stalled |= (uint16_t)(1U << ep);
+}
+
+/**
+ * @brief   Brings an OUT endpoint in the active state.
+ *
+ * @param[in] usbp      pointer to the @p USBDriver object
+ * @param[in] ep        endpoint number
+ *
+ * @notapi
+ */
+void usb_lld_clear_out(USBDriver *usbp, usbep_t ep) {
+
+  usbp->out_stalled &= (uint16_t)~(1U << ep);
+}
+
+/**
+ * @brief   Brings an IN endpoint in the active state.
+ *
+ * @param[in] usbp      pointer to the @p USBDriver object
+ * @param[in] ep        endpoint number
+ *
+ * @notapi
+ */
+void usb_lld_clear_in(USBDriver *usbp, usbep_t ep) {
+
+  usbp->in_stalled &= (uint16_t)~(1U << ep);
+}
+
+/**
+ * @brief   Bus activity simulation.
+ * @details All the events happened on the bus since the previous call are
+ *          served in order, the callbacks are invoked at the time of each
+ *          event so endpoints restarted by them are restarted at that
+ *          time.
+ * @note    SOFs lost while the simulator was not running are not replayed.
+ *
+ * @return              The interrupt status.
+ * @retval false        if no interrupt has been generated.
+ * @retval true         if an interrupt has been served.
+ *
+ * @notapi
+ */
+bool usb_lld_interrupt_pending(void) {
+  bool b = false;
+
+#if USE_SIM_USB1 == TRUE
+  USBDriver *usbp = &USBD1;
+  uint64_t now = _sim_get_time(), t;
+  unsigned event;
+  usbep_t ep = 0U;
+
+  event = usb_sim_next(usbp, &ep, &t);
+  if ((event == USB_SIM_NONE) || (t > now)) {
+    return false;
+  }
+
+  OSAL_IRQ_PROLOGUE();
+
+  usbp->serving = true;
+  do {
+    usbp->now = t;
+    switch (event) {
+    case USB_SIM_HOST:
+      usb_sim_host_step(usbp);
+      break;
+    case USB_SIM_SOF:
+      usbp->frame = (uint16_t)((usbp->frame + 1U) & 0x7FFU);
+      usbp->sof_time += SIM_USB_FRAME_TIME;
+      if (usbp->sof_time <= now) {
+        usbp->sof_time = now + SIM_USB_FRAME_TIME;
+      }
+      _usb_isr_invoke_sof_cb(usbp);
+      break;
+    case USB_SIM_IN:
+      usb_sim_in_packet(usbp, ep);
+      break;
+    default:
+      usb_sim_out_packet(usbp, ep);
+      break;
+    }
+    event = usb_sim_next(usbp, &ep, &t);
+  } while ((event != USB_SIM_NONE) && (t <= now));
+  usbp->serving = false;
+
+  OSAL_IRQ_EPILOGUE();
+
+  b = true;
+#endif
+
+  return b;
+}
+
+/**
+ * @brief   Returns the time of the next event on the bus.
+ *
+ * @return              The simulator time of the event in nanoseconds.
+ * @retval 0            if the bus is idle.
+ *
+ * @notapi
+ */
+uint64_t usb_lld_get_deadline(void) {
+
+#if USE_SIM_USB1 == TRUE
+  usbep_t ep;
+  uint64_t t;
+
+  if (usb_sim_next(&USBD1, &ep, &t) == USB_SIM_NONE) {
+    return 0U;
+  }
+  return t;
+#else
+  return 0U;
+#endif
+}
+
+#endif /* HAL_USE_USB == TRUE */
+
+/** @} */
@@ -0,0 +1,527 @@
+/*
+    ChibiOS - Copyright (C) 2006..2018 Giovanni Di Sirio
+
+    Licensed under the Apache License, Version 2.0 (the "License");
+    you may not use this file except in compliance with the License.
+    You may obtain a copy of the License at
+
+        http://www.apache.org/licenses/LICENSE-2.0
+
+    Unless required by applicable law or agreed to in writing, software
+    distributed under the License is distributed on an "AS IS" BASIS,
+    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+    See the License for the specific language governing permissions and
+    limitations under the License.
+*/
+
+/**
+ * @file    simulator/posix/hal_usb_lld.h
+ * @brief   Posix simulator low level USB driver header.
+ *
+ * @addtogroup POSIX_USB
+ * @{
+ */
+
+#ifndef HAL_USB_LLD_H
+#define HAL_USB_LLD_H
+
+#if (HAL_USE_USB == TRUE) || defined(__DOXYGEN__)
+
+/*===========================================================================*/
+/* Driver constants.                                                         */
+/*===========================================================================*/
+
+/**
+ * @brief   Maximum endpoint address.
+ */
+#define USB_MAX_ENDPOINTS                   4
+
+/**
+ * @brief   Status stage handling method.
+ */
+#define USB_EP0_STATUS_STAGE                USB_EP0_STATUS_STAGE_SW
+
+/**
+ * @brief   The address can be changed immediately upon packet reception.
+ */
+#define USB_SET_ADDRESS_MODE                USB_LATE_SET_ADDRESS
+
+/**
+ * @brief   Method for set address acknowledge.
+ */
+#define USB_SET_ADDRESS_ACK_HANDLING        USB_SET_ADDRESS_ACK_SW
+
+/*===========================================================================*/
+/* Driver pre-compile time settings.                                         */
+/*===========================================================================*/
+
+/**
+ * @name    Simulator USB configuration options
+ * @{
+ */
+/**
+ * @brief   USBD1 driver enable switch.
+ * @details If set to @p TRUE the support for USBD1 is included.
+ * @note    The default is @p TRUE.
+ */
+#if !defined(USE_SIM_USB1) || defined(__DOXYGEN__)
+#define USE_SIM_USB1                        TRUE
+#endif
+
+/**
+ * @brief   Simulated bus speed.
+ * @details If set to @p TRUE a high speed bus is simulated, 512 bytes bulk
+ *          packets and 125us micro-frames. If set to @p FALSE a full speed
+ *          bus is simulated, 64 bytes bulk packets and 1ms frames.
+ */
+#if !defined(SIM_USB_HIGH_SPEED) || defined(__DOXYGEN__)
+#define SIM_USB_HIGH_SPEED                  TRUE
+#endif
+
+/**
+ * @brief   Host reaction time to a restarted endpoint in nanoseconds.
+ * @details The host finds an endpoint not ready right after a transfer
+ *          and retries it after this time, the time is spent once per
+ *          transfer, the packets of a transfer are back to back.
+ */
+#if !defined(SIM_USB_NAK_TIME) || defined(__DOXYGEN__)
+#define SIM_USB_NAK_TIME                    20000
+#endif
+
+/**
+ * @brief   Depth, in packets, of the host loopback FIFOs.
+ */
+#if !defined(SIM_USB_LOOPBACK_PACKETS) || defined(__DOXYGEN__)
+#define SIM_USB_LOOPBACK_PACKETS            32
+#endif
+/** @} */
+
+/*===========================================================================*/
+/* Derived constants and error checks.                                       */
+/*===========================================================================*/
+
+#if (SIM_USB_HIGH_SPEED == TRUE) || defined(__DOXYGEN__)
+/**
+ * @brief   Largest bulk packet on the simulated bus.
+ */
+#define SIM_USB_MAX_PACKET_SIZE             512U
+
+/**
+ * @brief   Bit rate of the simulated bus.
+ */
+#define SIM_USB_BITRATE                     480000000U
+
+/**
+ * @brief   Per packet protocol overhead in bytes.
+ * @details Token, handshake, CRC, bit stuffing and inter-packet delays,
+ *          chosen to match the packets per (micro) frame allowed by the
+ *          specification.
+ */
+#define SIM_USB_PACKET_OVERHEAD             65U
+
+/**
+ * @brief   Period of SOF packets in nanoseconds.
+ */
+#define SIM_USB_FRAME_TIME                  125000U
+
+#else
+#define SIM_USB_MAX_PACKET_SIZE             64U
+#define SIM_USB_BITRATE                     12000000U
+#define SIM_USB_PACKET_OVERHEAD             15U
+#define SIM_USB_FRAME_TIME                  1000000U
+#endif
+
+#if SIM_USB_LOOPBACK_PACKETS < 1
+#error "invalid SIM_USB_LOOPBACK_PACKETS value"
+#endif
+
+/*===========================================================================*/
+/* Driver data structures and types.                                         */
+/*===========================================================================*/
+
+/**
+ * @brief   Type of an IN endpoint state structure.
+ */
+typedef struct {
+  /**
+   * @brief   Requested transmit transfer size.
+   */
+  size_t                        txsize;
+  /**
+   * @brief   Transmitted bytes so far.
+   */
+  size_t                        txcnt;
+  /**
+   * @brief   Pointer to the transmission linear buffer.
+   */
+  const uint8_t                 *txbuf;
+#if (USB_USE_WAIT == TRUE) || defined(__DOXYGEN__)
+  /**
+   * @brief   Waiting thread.
+   */
+  thread_reference_t            thread;
+#endif
+  /* End of the mandatory fields.*/
+} USBInEndpointState;
+
+/**
+ * @brief   Type of an OUT endpoint state structure.
+ */
+typedef struct {
+  /**
+   * @brief   Requested receive transfer size.
+   */
+  size_t                        rxsize;
+  /**
+   * @brief   Received bytes so far.
+   */
+  size_t                        rxcnt;
+  /**
+   * @brief   Pointer to the receive linear buffer.
+   */
+  uint8_t                       *rxbuf;
+#if (USB_USE_WAIT == TRUE) || defined(__DOXYGEN__)
+  /**
+   * @brief   Waiting thread.
+   */
+  thread_reference_t            thread;
+#endif
+  /* End of the mandatory fields.*/
+} USBOutEndpointState;
+
+/**
+ * @brief   Type of an USB endpoint configuration structure.
+ * @note    Platform specific restrictions may apply to endpoints.
+ */
+typedef struct {
+  /**
+   * @brief   Type and mode of the endpoint.
+   */
+  uint32_t                      ep_mode;
+  /**
+   * @brief   Setup packet notification callback.
+   * @details This callback is invoked when a setup packet has been
+   *          received.
+   * @post    The application must immediately call @p usbReadPacket() in
+   *          order to access the received packet.
+   * @note    This field is only valid for @p USB_EP_MODE_TYPE_CTRL
+   *          endpoints, it should be set to @p NULL for other endpoint
+   *          types.
+   */
+  usbepcallback_t               setup_cb;
+  /**
+   * @brief   IN endpoint notification callback.
+   * @details This field must be set to @p NULL if the IN endpoint is not
+   *          used.
+   */
+  usbepcallback_t               in_cb;
+  /**
+   * @brief   OUT endpoint notification callback.
+   * @details This field must be set to @p NULL if the OUT endpoint is not
+   *          used.
+   */
+  usbepcallback_t               out_cb;
+  /**
+   * @brief   IN endpoint maximum packet size.
+   * @details This field must be set to zero if the IN endpoint is not
+   *          used.
+   */
+  uint16_t                      in_maxsize;
+  /**
+   * @brief   OUT endpoint maximum packet size.
+   * @details This field must be set to zero if the OUT endpoint is not
+   *          used.
+   */
+  uint16_t                      out_maxsize;
+  /**
+   * @brief   @p USBEndpointState associated to the IN endpoint.
+   * @details This structure maintains the state of the IN endpoint.
+   */
+  USBInEndpointState            *in_state;
+  /**
+   * @brief   @p USBEndpointState associated to the OUT endpoint.
+   * @details This structure maintains the state of the OUT endpoint.
+   */
+  USBOutEndpointState           *out_state;
+  /* End of the mandatory fields.*/
+} USBEndpointConfig;
+
+/**
+ * @brief   Type of an USB driver configuration structure.
+ */
+typedef struct {
+  /**
+   * @brief   USB events callback.
+   * @details This callback is invoked when an USB driver event is registered.
+   */
+  usbeventcb_t                  event_cb;
+  /**
+   * @brief   Device GET_DESCRIPTOR request callback.
+   * @note    This callback is mandatory and cannot be set to @p NULL.
+   */
+  usbgetdescriptor_t            get_descriptor_cb;
+  /**
+   * @brief   Requests hook callback.
+   * @details This hook allows to be notified of standard requests or to
+   *          handle non standard requests.
+   */
+  usbreqhandler_t               requests_hook_cb;
+  /**
+   * @brief   Start Of Frame callback.
+   */
+  usbcallback_t                 sof_cb;
+  /* End of the mandatory fields.*/
+} USBConfig;
+
+/**
+ * @brief   Host side loopback FIFO of an endpoint.
+ * @details Packets transmitted on an IN endpoint are sent back, with the
+ *          same sizes, to the OUT endpoint with the same number.
+ */
+typedef struct {
+  /**
+   * @brief   Packets buffer.
+   */
+  struct {
+    /**
+     * @brief   Packet size, zero for a zero length packet.
+     */
+    size_t                      size;
+    /**
+     * @brief   Packet data.
+     */
+    uint8_t                     data[SIM_USB_MAX_PACKET_SIZE];
+  }                             packets[SIM_USB_LOOPBACK_PACKETS];
+  /**
+   * @brief   Read index.
+   */
+  unsigned                      rd;
+  /**
+   * @brief   Number of packets in the FIFO.
+   */
+  unsigned                      cnt;
+} sim_usb_loopback_t;
+
+/**
+ * @brief   Structure representing an USB driver.
+ */
+struct USBDriver {
+  /**
+   * @brief   Driver state.
+   */
+  usbstate_t                    state;
+  /**
+   * @brief   Current configuration data.
+   */
+  const USBConfig               *config;
+  /**
+   * @brief   Bit map of the transmitting IN endpoints.
+   */
+  uint16_t                      transmitting;
+  /**
+   * @brief   Bit map of the receiving OUT endpoints.
+   */
+  uint16_t                      receiving;
+  /**
+   * @brief   Active endpoints configurations.
+   */
+  const USBEndpointConfig       *epc[USB_MAX_ENDPOINTS + 1];
+  /**
+   * @brief   Fields available to user, it can be used to associate an
+   *          application-defined handler to an IN endpoint.
+   * @note    The base index is one, the endpoint zero does not have a
+   *          reserved element in this array.
+   */
+  void                          *in_params[USB_MAX_ENDPOINTS];
+  /**
+   * @brief   Fields available to user, it can be used to associate an
+   *          application-defined handler to an OUT endpoint.
+   * @note    The base index is one, the endpoint zero does not have a
+   *          reserved element in this array.
+   */
+  void                          *out_params[USB_MAX_ENDPOINTS];
+  /**
+   * @brief   Endpoint 0 state.
+   */
+  usbep0state_t                 ep0state;
+  /**
+   * @brief   Next position in the buffer to be transferred through endpoint 0.
+   */
+  uint8_t                       *ep0next;
+  /**
+   * @brief   Number of bytes yet to be transferred through endpoint 0.
+   */
+  size_t                        ep0n;
+  /**
+   * @brief   Endpoint 0 end transaction callback.
+   */
+  usbcallback_t                 ep0endcb;
+  /**
+   * @brief   Setup packet buffer.
+   */
+  uint8_t                       setup[8];
+  /**
+   * @brief   Current USB device status.
+   */
+  uint16_t                      status;
+  /**
+   * @brief   Assigned USB address.
+   */
+  uint8_t                       address;
+  /**
+   * @brief   Current USB device configuration.
+   */
+  uint8_t                       configuration;
+  /**
+   * @brief   State of the driver when a suspend happened.
+   */
+  usbstate_t                    saved_state;
+#if defined(USB_DRIVER_EXT_FIELDS)
+  USB_DRIVER_EXT_FIELDS
+#endif
+  /* End of the mandatory fields.*/
+  /**
+   * @brief   Device connected to the bus.
+   */
+  bool                          connected;
+  /**
+   * @brief   Next enumeration step performed by the host.
+   */
+  unsigned                      host_step;
+  /**
+   * @brief   Time of the next enumeration step, zero if enumeration is
+   *          over.
+   */
+  uint64_t                      host_time;
+  /**
+   * @brief   Setup packet sent by the host.
+   */
+  uint8_t                       host_setup[8];
+  /**
+   * @brief   Time of the next SOF, zero before the bus reset.
+   */
+  uint64_t                      sof_time;
+  /**
+   * @brief   Current frame number.
+   */
+  uint16_t                      frame;
+  /**
+   * @brief   End of the last packet on the bus.
+   */
+  uint64_t                      bus_time;
+  /**
+   * @brief   Time of the event being served, meaningful while serving.
+   */
+  uint64_t                      now;
+  /**
+   * @brief   Simulated events being served.
+   */
+  bool                          serving;
+  /**
+   * @brief   Bit map of the stalled IN endpoints.
+   */
+  uint16_t                      in_stalled;
+  /**
+   * @brief   Bit map of the stalled OUT endpoints.
+   */
+  uint16_t                      out_stalled;
+  /**
+   * @brief   Time the host polls each IN endpoint again.
+   */
+  uint64_t                      in_ready[USB_MAX_ENDPOINTS + 1];
+  /**
+   * @brief   Time the host polls each OUT endpoint again.
+   */
+  uint64_t                      out_ready[USB_MAX_ENDPOINTS + 1];
+  /**
+   * @brief   Host loopback FIFOs, the base index is one.
+   */
+  sim_usb_loopback_t            loopback[USB_MAX_ENDPOINTS];
+  /**
+   * @brief   Number of data packets transferred on the bus.
+   */
+  uint32_t                      packets;
+  /**
+   * @brief   Number of transfers completed on the bus.
+   */
+  uint32_t                      transfers;
+};
+
+/*===========================================================================*/
+/* Driver macros.                                                            */
+/*===========================================================================*/
+
+/**
+ * @brief   Returns the current frame number.
+ *
+ * @param[in] usbp      pointer to the @p USBDriver object
+ * @return              The current frame number.
+ *
+ * @notapi
+ */
+#define usb_lld_get_frame_number(usbp) ((usbp)->frame)
+
+/**
+ * @brief   Returns the exact size of a receive transaction.
+ * @details The received size can be different from the size specified in
+ *          @p usbStartReceiveI() because the last packet could have a size
+ *          different from the expected one.
+ * @pre     The OUT endpoint must have been configured in transaction mode
+ *          in order to use this function.
+ *
+ * @param[in] usbp      pointer to the @p USBDriver object
+ * @param[in] ep        endpoint number
+ * @return              Received data size.
+ *
+ * @notapi
+ */
+#define usb_lld_get_transaction_size(usbp, ep)                              \
+  ((usbp)->epc[ep]->out_state->rxcnt)
+
+/**
+ * @brief   Start of host wake-up procedure.
+ *
+ * @notapi
+ */
+#define usb_lld_wakeup_host(usbp)
+
+/*===========================================================================*/
+/* External declarations.                                                    */
+/*===========================================================================*/
+
+#if (USE_SIM_USB1 == TRUE) && !defined(__DOXYGEN__)
+extern USBDriver USBD1;
+#endif
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+  void usb_lld_init(void);
+  void usb_lld_start(USBDriver *usbp);
+  void usb_lld_stop(USBDriver *usbp);
+  void usb_lld_connect_bus(USBDriver *usbp);
+  void usb_lld_disconnect_bus(USBDriver *usbp);
+  void usb_lld_reset(USBDriver *usbp);
+  void usb_lld_set_address(USBDriver *usbp);
+  void usb_lld_init_endpoint(USBDriver *usbp, usbep_t ep);
+  void usb_lld_disable_endpoints(USBDriver *usbp);
+  usbepstatus_t usb_lld_get_status_in(USBDriver *usbp, usbep_t ep);
+  usbepstatus_t usb_lld_get_status_out(USBDriver *usbp, usbep_t ep);
+  void usb_lld_read_setup(USBDriver *usbp, usbep_t ep, uint8_t *buf);
+  void usb_lld_start_out(USBDriver *usbp, usbep_t ep);
+  void usb_lld_start_in(USBDriver *usbp, usbep_t ep);
+  void usb_lld_stall_out(USBDriver *usbp, usbep_t ep);
+  void usb_lld_stall_in(USBDriver *usbp, usbep_t ep);
+  void usb_lld_clear_out(USBDriver *usbp, usbep_t ep);
+  void usb_lld_clear_in(USBDriver *usbp, usbep_t ep);
+  bool usb_lld_interrupt_pending(void);
+  uint64_t usb_lld_get_deadline(void);
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* HAL_USE_USB == TRUE */
+
+#endif /* HAL_USB_LLD_H */
+
+/** @} */
@@ -0,0 +1,361 @@
+/*
+    ChibiOS - Copyright (C) 2006..2018 Giovanni Di Sirio
+
+    Licensed under the Apache License, Version 2.0 (the "License");
+    you may not use this file except in compliance with the License.
+    You may obtain a copy of the License at
+
+        http://www.apache.org/licenses/LICENSE-2.0
+
+    Unless required by applicable law or agreed to in writing, software
+    distributed under the License is distributed on an "AS IS" BASIS,
+    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+    See the License for the specific language governing permissions and
+    limitations under the License.
+*/
+
+/**
+ * @file    simulator/posix/simblk.c
+ * @brief   Simulator block device driver code.
+ *
+ * @addtogroup POSIX_SIMBLK
+ * @{
+ */
+
+#include <string.h>
+#include <errno.h>
+#include <time.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+#include "hal.h"
+#include "simblk.h"
+
+/*===========================================================================*/
+/* Driver local definitions.                                                 */
+/*===========================================================================*/
+
+/*===========================================================================*/
+/* Driver exported variables.                                                */
+/*===========================================================================*/
+
+/*===========================================================================*/
+/* Driver local variables and types.                                         */
+/*===========================================================================*/
+
+/*===========================================================================*/
+/* Driver local functions.                                                   */
+/*===========================================================================*/
+
+/**
+ * @brief   Simulates the device latency for a command.
+ * @note    The host thread is suspended for the whole time, the simulated
+ *          CPU is stalled as it would be with a polled transfer.
+ *
+ * @param[in] sbdp      pointer to the @p SimBlockDevice object
+ * @param[in] n         number of transferred sectors
+ */
+static void sblk_delay(SimBlockDevice *sbdp, uint32_t n) {
+  uint64_t us;
+  struct timespec ts;
+
+  us = (uint64_t)sbdp->config->cmd_latency +
+       ((uint64_t)sbdp->config->blk_latency * (uint64_t)n);
+  sbdp->stats.busy_time += us;
+  if (us == 0U) {
+    return;
+  }
+
+  ts.tv_sec  = (time_t)(us / 1000000U);
+  ts.tv_nsec = (long)((us % 1000000U) * 1000U);
+  while ((nanosleep(&ts, &ts) != 0) && (errno == EINTR)) {
+  }
+}
+
+static bool sblk_check_range(SimBlockDevice *sbdp,
+                             uint32_t startblk, uint32_t n) {
+
+  return (startblk >= sbdp->blknum) || (n > sbdp->blknum - startblk);
+}
+
+static bool sblk_is_inserted(void *instance) {
+
+  return ((SimBlockDevice *)instance)->storage != NULL;
+}
+
+static bool sblk_is_protected(void *instance) {
+  SimBlockDevice *sbdp = (SimBlockDevice *)instance;
+
+  return (sbdp->config != NULL) && sbdp->config->readonly;
+}
+
+static bool sblk_connect(void *instance) {
+  SimBlockDevice *sbdp = (SimBlockDevice *)instance;
+
+  osalDbgAssert((sbdp->state == BLK_ACTIVE) || (sbdp->state == BLK_READY),
+                "invalid state");
+
+  sbdp->state = BLK_READY;
+  return HAL_SUCCESS;
+}
+
+static bool sblk_disconnect(void *instance) {
+  SimBlockDevice *sbdp = (SimBlockDevice *)instance;
+
+  osalDbgAssert((sbdp->state == BLK_ACTIVE) || (sbdp->state == BLK_READY),
+                "invalid state");
+
+  sbdp->state = BLK_ACTIVE;
+  return HAL_SUCCESS;
+}
+
+static bool sblk_read(void *instance, uint32_t startblk,
+                      uint8_t *buffer, uint32_t n) {
+  SimBlockDevice *sbdp = (SimBlockDevice *)instance;
+
+  osalDbgAssert(sbdp->state == BLK_READY, "not ready");
+
+  if (sblk_check_range(sbdp, startblk, n)) {
+    return HAL_FAILED;
+  }
+
+  sbdp->state = BLK_READING;
+  memcpy(buffer,
+         &sbdp->storage[(size_t)startblk * sbdp->config->blk_size],
+         (size_t)n * sbdp->config->blk_size);
+  sbdp->stats.reads++;
+  sbdp->stats.blocks_read += n;
+  sblk_delay(sbdp, n);
+  sbdp->state = BLK_READY;
+
+  return HAL_SUCCESS;
+}
+
+static bool sblk_write(void *instance, uint32_t startblk,
+                       const uint8_t *buffer, uint32_t n) {
+  SimBlockDevice *sbdp = (SimBlockDevice *)instance;
+
+  osalDbgAssert(sbdp->state == BLK_READY, "not ready");
+
+  if (sbdp->config->readonly || sblk_check_range(sbdp, startblk, n)) {
+    return HAL_FAILED;
+  }
+
+  sbdp->state = BLK_WRITING;
+  memcpy(&sbdp->storage[(size_t)startblk * sbdp->config->blk_size],
+         buffer,
+         (size_t)n * sbdp->config->blk_size);
+  sbdp->stats.writes++;
+  sbdp->stats.blocks_written += n;
+  sblk_delay(sbdp, n);
+  sbdp->state = BLK_READY;
+
+  return HAL_SUCCESS;
+}
+
+static bool sblk_sync(void *instance) {
+  SimBlockDevice *sbdp = (SimBlockDevice *)instance;
+
+  if (sbdp->state != BLK_READY) {
+    return HAL_FAILED;
+  }
+
+  sbdp->stats.syncs++;
+  if (sbdp->fd >= 0) {
+    if (msync(sbdp->storage,
+              (size_t)sbdp->blknum * sbdp->config->blk_size,
+              MS_SYNC) != 0) {
+      return HAL_FAILED;
+    }
+  }
+
+  return HAL_SUCCESS;
+}
+
+static bool sblk_get_info(void *instance, BlockDeviceInfo *bdip) {
+  SimBlockDevice *sbdp = (SimBlockDevice *)instance;
+
+  if (sbdp->state != BLK_READY) {
+    return HAL_FAILED;
+  }
+
+  bdip->blk_size = sbdp->config->blk_size;
+  bdip->blk_num  = sbdp->blknum;
+
+  return HAL_SUCCESS;
+}
+
+static const struct SimBlockDeviceVMT vmt = {
+  (size_t)0,
+  sblk_is_inserted,
+  sblk_is_protected,
+  sblk_connect,
+  sblk_disconnect,
+  sblk_read,
+  sblk_write,
+  sblk_sync,
+  sblk_get_info
+};
+
+/*===========================================================================*/
+/* Driver interrupt handlers.                                                */
+/*===========================================================================*/
+
+/*===========================================================================*/
+/* Driver exported functions.                                                */
+/*===========================================================================*/
+
+/**
+ * @brief   Initializes an instance.
+ *
+ * @param[out] sbdp     pointer to the @p SimBlockDevice object
+ *
+ * @init
+ */
+void sblkObjectInit(SimBlockDevice *sbdp) {
+
+  sbdp->vmt     = &vmt;
+  sbdp->state   = BLK_STOP;
+  sbdp->config  = NULL;
+  sbdp->fd      = -1;
+  sbdp->storage = NULL;
+  sbdp->blknum  = 0U;
+  sblkResetStats(sbdp);
+}
+
+/**
+ * @brief   Configures and activates the simulated device.
+ * @details The host file, if specified, is opened and mapped in memory,
+ *          else an anonymous zero-filled memory area is allocated.
+ *
+ * @param[in] sbdp      pointer to the @p SimBlockDevice object
+ * @param[in] config    pointer to the @p SimBlockConfig object
+ * @return              The operation status.
+ * @retval HAL_RET_SUCCESS      if the device has been started.
+ * @retval HAL_RET_CONFIG_ERROR if the device size is zero.
+ * @retval HAL_RET_HW_FAILURE   if the host storage cannot be prepared.
+ *
+ * @api
+ */
+msg_t sblkStart(SimBlockDevice *sbdp, const SimBlockConfig *config) {
+  uint32_t blknum;
+  size_t size;
+  void *p;
+  int fd = -1;
+
+  osalDbgCheck((sbdp != NULL) && (config != NULL) &&
+               (config->blk_size > 0U));
+  osalDbgAssert((sbdp->state == BLK_STOP) || (sbdp->state == BLK_ACTIVE),
+                "invalid state");
+
+  if (sbdp->state == BLK_ACTIVE) {
+    sblkStop(sbdp);
+  }
+
+  blknum = config->blk_num;
+  if (config->path != NULL) {
+    struct stat st;
+
+    fd = open(config->path,
+              config->readonly ? O_RDONLY : (O_RDWR | O_CREAT), 0644);
+    if (fd < 0) {
+      return HAL_RET_HW_FAILURE;
+    }
+    if (fstat(fd, &st) != 0) {
+      (void) close(fd);
+      return HAL_RET_HW_FAILURE;
+    }
+    if (blknum == 0U) {
+      blknum = (uint32_t)((uint64_t)st.st_size / config->blk_size);
+    }
+    size = (size_t)blknum * config->blk_size;
+    if ((size > 0U) && ((uint64_t)st.st_size < (uint64_t)size)) {
+      if (config->readonly || (ftruncate(fd, (off_t)size) != 0)) {
+        (void) close(fd);
+        return HAL_RET_HW_FAILURE;
+      }
+    }
+  }
+  else {
+    size = (size_t)blknum * config->blk_size;
+  }
+
+  if (size == 0U) {
+    if (fd >= 0) {
+      (void) close(fd);
+    }
+    return HAL_RET_CONFIG_ERROR;
+  }
+
+  if (fd >= 0) {
+    p = mmap(NULL, size,
+             config->readonly ? PROT_READ : (PROT_READ | PROT_WRITE),
+             MAP_SHARED, fd, 0);
+  }
+  else {
+    p = mmap(NULL, size, PROT_READ | PROT_WRITE,
+             MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+  }
+  if (p == MAP_FAILED) {
+    if (fd >= 0) {
+      (void) close(fd);
+    }
+    return HAL_RET_HW_FAILURE;
+  }
+
+  sbdp->config  = config;
+  sbdp->fd      = fd;
+  sbdp->storage = (uint8_t *)p;
+  sbdp->blknum  = blknum;
+  sbdp->state   = BLK_ACTIVE;
+
+  return HAL_RET_SUCCESS;
+}
+
+/**
+ * @brief   Deactivates the simulated device.
+ * @details The host file content is synchronized and the mapping released.
+ *
+ * @param[in] sbdp      pointer to the @p SimBlockDevice object
+ *
+ * @api
+ */
+void sblkStop(SimBlockDevice *sbdp) {
+
+  osalDbgCheck(sbdp != NULL);
+  osalDbgAssert((sbdp->state == BLK_STOP) || (sbdp->state == BLK_ACTIVE) ||
+                (sbdp->state == BLK_READY), "invalid state");
+
+  if (sbdp->storage != NULL) {
+    size_t size = (size_t)sbdp->blknum * sbdp->config->blk_size;
+
+    if (sbdp->fd >= 0) {
+      (void) msync(sbdp->storage, size, MS_SYNC);
+    }
+    (void) munmap(sbdp->storage, size);
+  }
+  if (sbdp->fd >= 0) {
+    (void) close(sbdp->fd);
+  }
+
+  sbdp->fd      = -1;
+  sbdp->storage = NULL;
+  sbdp->blknum  = 0U;
+  sbdp->state   = BLK_STOP;
+}
+
+/**
+ * @brief   Clears the device I/O statistics.
+ *
+ * @param[in] sbdp      pointer to the @p SimBlockDevice object
+ *
+ * @api
+ */
+void sblkResetStats(SimBlockDevice *sbdp) {
+
+  osalDbgCheck(sbdp != NULL);
+
+  memset(&sbdp->stats, 0, sizeof (SimBlockStats));
+}
+
+/** @} */
@@ -0,0 +1,190 @@
+/*
+    ChibiOS - Copyright (C) 2006..2018 Giovanni Di Sirio
+
+    Licensed under the Apache License, Version 2.0 (the "License");
+    you may not use this file except in compliance with the License.
+    You may obtain a copy of the License at
+
+        http://www.apache.org/licenses/LICENSE-2.0
+
+    Unless required by applicable law or agreed to in writing, software
+    distributed under the License is distributed on an "AS IS" BASIS,
+    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+    See the License for the specific language governing permissions and
+    limitations under the License.
+*/
+
+/**
+ * @file    simulator/posix/simblk.h
+ * @brief   Simulator block device driver header.
+ *
+ * @addtogroup POSIX_SIMBLK
+ * @{
+ */
+
+#ifndef SIMBLK_H
+#define SIMBLK_H
+
+/*===========================================================================*/
+/* Driver constants.                                                         */
+/*===========================================================================*/
+
+/*===========================================================================*/
+/* Driver pre-compile time settings.                                         */
+/*===========================================================================*/
+
+/*===========================================================================*/
+/* Derived constants and error checks.                                       */
+/*===========================================================================*/
+
+/*===========================================================================*/
+/* Driver data structures and types.                                         */
+/*===========================================================================*/
+
+/**
+ * @brief   Simulator block device configuration structure.
+ */
+typedef struct {
+  /**
+   * @brief   Path of the host file backing the device.
+   * @note    If @p NULL then the device is backed by anonymous memory and
+   *          its content is lost when the device is stopped.
+   * @note    The file is created if not existing and resized to the
+   *          device size.
+   */
+  const char                *path;
+  /**
+   * @brief   Sector size in bytes.
+   */
+  uint32_t                  blk_size;
+  /**
+   * @brief   Number of sectors.
+   * @note    If zero and a host file is specified then the number of
+   *          sectors is derived from the file size.
+   */
+  uint32_t                  blk_num;
+  /**
+   * @brief   Simulated latency of each read or write command in
+   *          microseconds.
+   */
+  uint32_t                  cmd_latency;
+  /**
+   * @brief   Simulated transfer time of each sector in microseconds.
+   */
+  uint32_t                  blk_latency;
+  /**
+   * @brief   Reports the device as write protected.
+   */
+  bool                      readonly;
+} SimBlockConfig;
+
+/**
+ * @brief   Simulator block device I/O statistics.
+ */
+typedef struct {
+  /**
+   * @brief   Number of read commands.
+   */
+  uint32_t                  reads;
+  /**
+   * @brief   Number of write commands.
+   */
+  uint32_t                  writes;
+  /**
+   * @brief   Number of sync commands.
+   */
+  uint32_t                  syncs;
+  /**
+   * @brief   Number of sectors read.
+   */
+  uint32_t                  blocks_read;
+  /**
+   * @brief   Number of sectors written.
+   */
+  uint32_t                  blocks_written;
+  /**
+   * @brief   Total simulated latency in microseconds.
+   */
+  uint64_t                  busy_time;
+} SimBlockStats;
+
+/**
+ * @brief   @p SimBlockDevice specific methods.
+ */
+#define _sim_block_device_methods                                           \
+  _base_block_device_methods
+
+/**
+ * @extends BaseBlockDeviceVMT
+ *
+ * @brief   @p SimBlockDevice virtual methods table.
+ */
+struct SimBlockDeviceVMT {
+  _sim_block_device_methods
+};
+
+/**
+ * @extends BaseBlockDevice
+ *
+ * @brief   Simulator block device class.
+ * @details This class implements a block device on top of a memory mapped
+ *          host file or of an anonymous memory mapping.
+ */
+typedef struct {
+  /** @brief Virtual Methods Table.*/
+  const struct SimBlockDeviceVMT    *vmt;
+  _base_block_device_data
+  /**
+   * @brief   Current configuration data.
+   */
+  const SimBlockConfig      *config;
+  /**
+   * @brief   Host file descriptor or -1.
+   */
+  int                       fd;
+  /**
+   * @brief   Mapped device storage.
+   */
+  uint8_t                   *storage;
+  /**
+   * @brief   Number of sectors.
+   */
+  uint32_t                  blknum;
+  /**
+   * @brief   I/O statistics.
+   */
+  SimBlockStats             stats;
+} SimBlockDevice;
+
+/*===========================================================================*/
+/* Driver macros.                                                            */
+/*===========================================================================*/
+
+/**
+ * @brief   Returns a pointer to the device I/O statistics.
+ *
+ * @param[in] sbdp      pointer to the @p SimBlockDevice object
+ * @return              Pointer to the @p SimBlockStats structure.
+ *
+ * @api
+ */
+#define sblkGetStats(sbdp) (&(sbdp)->stats)
+
+/*===========================================================================*/
+/* External declarations.                                                    */
+/*===========================================================================*/
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+  void sblkObjectInit(SimBlockDevice *sbdp);
+  msg_t sblkStart(SimBlockDevice *sbdp, const SimBlockConfig *config);
+  void sblkStop(SimBlockDevice *sbdp);
+  void sblkResetStats(SimBlockDevice *sbdp);
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* SIMBLK_H */
+
+/** @} */
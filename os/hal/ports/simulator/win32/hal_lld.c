@@ -107,4 +107,13 @@ void _sim_check_for_interrupts(void) {
   }
 }
 
+/**
+ * @brief   Interrupt simulation while idle.
+ * @note    The Win32 simulator keeps polling.
+ */
+void _sim_wait_for_interrupts(void) {
+
+  _sim_check_for_interrupts();
+}
+
 /** @} */
@@ -58,6 +58,7 @@ extern "C" {
 #endif
   void hal_lld_init(void);
   void _sim_check_for_interrupts(void);
+  void _sim_wait_for_interrupts(void);
 #ifdef __cplusplus
 }
 #endif
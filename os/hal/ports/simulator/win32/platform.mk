@@ -1,9 +1,9 @@
 # List of all the Win32 platform files.
 PLATFORMSRC = ${CHIBIOS}/os/hal/ports/simulator/win32/hal_lld.c \
               ${CHIBIOS}/os/hal/ports/simulator/win32/hal_serial_lld.c \
+              ${CHIBIOS}/os/hal/ports/simulator/win32/hal_st_lld.c \
               ${CHIBIOS}/os/hal/ports/simulator/console.c \
-              ${CHIBIOS}/os/hal/ports/simulator/hal_pal_lld.c \
-              ${CHIBIOS}/os/hal/ports/simulator/hal_st_lld.c
+              ${CHIBIOS}/os/hal/ports/simulator/hal_pal_lld.c
 
 # Required include directories
 PLATFORMINC = ${CHIBIOS}/os/hal/ports/simulator/win32 \
@@ -89,6 +89,7 @@ void ibqObjectInit(input_buffers_queue_t *ibqp, bool suspended, uint8_t *bp,
   ibqp->buffers   = bp;
   ibqp->ptr       = NULL;
   ibqp->top       = NULL;
+  ibqp->inplace   = false;
   ibqp->notify    = infy;
   ibqp->link      = link;
 }
@@ -113,6 +114,7 @@ void ibqResetI(input_buffers_queue_t *ibqp) {
   ibqp->bwrptr    = ibqp->buffers;
   ibqp->ptr       = NULL;
   ibqp->top       = NULL;
+  ibqp->inplace   = false;
   osalThreadDequeueAllI(&ibqp->waiting, MSG_RESET);
 }
 
@@ -416,6 +418,83 @@ size_t ibqReadTimeout(input_buffers_queue_t *ibqp, uint8_t *bp,
   }
 }
 
+/**
+ * @brief   Gets the unread data of the current input buffer in place.
+ * @details The data is accessed directly in the buffer, without copies,
+ *          the area is returned to the queue using
+ *          @p ibqReleaseReadArea(). If there is no current buffer then the
+ *          next filled buffer is acquired, waiting for it if necessary.
+ * @note    The area is at most a buffer, the data in the following buffers
+ *          is accessed by calling the function again after the release.
+ * @note    The function must not be mixed with the other read functions
+ *          while the area is in use.
+ *
+ * @param[in] ibqp      pointer to the @p input_buffers_queue_t object
+ * @param[out] sizep    pointer to the size of the returned area
+ * @param[in] timeout   the number of ticks before the operation timeouts,
+ *                      the following special values are allowed:
+ *                      - @a TIME_IMMEDIATE immediate timeout.
+ *                      - @a TIME_INFINITE no timeout.
+ *                      .
+ * @return              A pointer to the data area.
+ * @retval NULL         if the specified time expired or the queue has been
+ *                      reset or suspended.
+ *
+ * @api
+ */
+uint8_t *ibqGetReadAreaTimeout(input_buffers_queue_t *ibqp, size_t *sizep,
+                               sysinterval_t timeout) {
+  uint8_t *bp = NULL;
+
+  osalDbgCheck(sizep != NULL);
+
+  *sizep = 0U;
+
+  osalSysLock();
+
+  /* Acquiring a new buffer if there is no current one.*/
+  if ((ibqp->ptr != NULL) ||
+      (ibqGetFullBufferTimeoutS(ibqp, timeout) == MSG_OK)) {
+    bp     = ibqp->ptr;
+    *sizep = (size_t)ibqp->top - (size_t)ibqp->ptr;
+  }
+
+  osalSysUnlock();
+
+  return bp;
+}
+
+/**
+ * @brief   Releases data read in place.
+ * @details The first @p n bytes of the area returned by
+ *          @p ibqGetReadAreaTimeout() are consumed, the buffer is returned
+ *          to the queue when all its data has been consumed.
+ * @note    The operation is ignored if the queue has been reset while the
+ *          area was in use.
+ *
+ * @param[in] ibqp      pointer to the @p input_buffers_queue_t object
+ * @param[in] n         number of bytes consumed, it can be zero
+ *
+ * @api
+ */
+void ibqReleaseReadArea(input_buffers_queue_t *ibqp, size_t n) {
+
+  osalSysLock();
+
+  if (ibqp->ptr != NULL) {
+    osalDbgCheck(n <= ((size_t)ibqp->top - (size_t)ibqp->ptr));
+
+    ibqp->ptr += n;
+
+    /* Has the current data buffer been finished? if so then release it.*/
+    if (ibqp->ptr >= ibqp->top) {
+      ibqReleaseEmptyBufferS(ibqp);
+    }
+  }
+
+  osalSysUnlock();
+}
+
 /**
  * @brief   Initializes an output buffers queue object.
  *
@@ -445,6 +524,7 @@ void obqObjectInit(output_buffers_queue_t *obqp, bool suspended, uint8_t *bp,
   obqp->buffers   = bp;
   obqp->ptr       = NULL;
   obqp->top       = NULL;
+  obqp->inplace   = false;
   obqp->notify    = onfy;
   obqp->link      = link;
 }
@@ -469,6 +549,7 @@ void obqResetI(output_buffers_queue_t *obqp) {
   obqp->bwrptr    = obqp->buffers;
   obqp->ptr       = NULL;
   obqp->top       = NULL;
+  obqp->inplace   = false;
   osalThreadDequeueAllI(&obqp->waiting, MSG_RESET);
 }
 
@@ -780,6 +861,86 @@ size_t obqWriteTimeout(output_buffers_queue_t *obqp, const uint8_t *bp,
   }
 }
 
+/**
+ * @brief   Gets the free space of the current output buffer in place.
+ * @details The data is written directly in the buffer, without copies,
+ *          then the written amount is committed using
+ *          @p obqCommitWriteArea(). If there is no current buffer then the
+ *          next empty buffer is acquired, waiting for it if necessary.
+ * @note    The area is at most a buffer, the current buffer is not
+ *          flushed by @p obqTryFlushI() while the area is in use.
+ * @note    The function must not be mixed with the other write functions
+ *          while the area is in use.
+ *
+ * @param[in] obqp      pointer to the @p output_buffers_queue_t object
+ * @param[out] sizep    pointer to the size of the returned area
+ * @param[in] timeout   the number of ticks before the operation timeouts,
+ *                      the following special values are allowed:
+ *                      - @a TIME_IMMEDIATE immediate timeout.
+ *                      - @a TIME_INFINITE no timeout.
+ *                      .
+ * @return              A pointer to the free area.
+ * @retval NULL         if the specified time expired or the queue has been
+ *                      reset or suspended.
+ *
+ * @api
+ */
+uint8_t *obqGetWriteAreaTimeout(output_buffers_queue_t *obqp,
+                                size_t *sizep, sysinterval_t timeout) {
+  uint8_t *bp = NULL;
+
+  osalDbgCheck(sizep != NULL);
+
+  *sizep = 0U;
+
+  osalSysLock();
+
+  /* Acquiring a new buffer if there is no current one.*/
+  if ((obqp->ptr != NULL) ||
+      (obqGetEmptyBufferTimeoutS(obqp, timeout) == MSG_OK)) {
+    obqp->inplace = true;
+    bp     = obqp->ptr;
+    *sizep = (size_t)obqp->top - (size_t)obqp->ptr;
+  }
+
+  osalSysUnlock();
+
+  return bp;
+}
+
+/**
+ * @brief   Commits data written in place.
+ * @details The first @p n bytes of the area returned by
+ *          @p obqGetWriteAreaTimeout() are added to the current buffer,
+ *          the buffer is posted to the queue when it is full. A partially
+ *          filled buffer can be flushed again after the commit.
+ * @note    The operation is ignored if the queue has been reset while the
+ *          area was in use.
+ *
+ * @param[in] obqp      pointer to the @p output_buffers_queue_t object
+ * @param[in] n         number of bytes written, it can be zero
+ *
+ * @api
+ */
+void obqCommitWriteArea(output_buffers_queue_t *obqp, size_t n) {
+
+  osalSysLock();
+
+  obqp->inplace = false;
+  if (obqp->ptr != NULL) {
+    osalDbgCheck(n <= ((size_t)obqp->top - (size_t)obqp->ptr));
+
+    obqp->ptr += n;
+
+    /* Has the current data buffer been finished? if so then post it.*/
+    if (obqp->ptr >= obqp->top) {
+      obqPostFullBufferS(obqp, obqp->bsize - sizeof (size_t));
+    }
+  }
+
+  osalSysUnlock();
+}
+
 /**
  * @brief   Flushes the current, partially filled, buffer to the queue.
  * @note    The notification callback is not invoked because the function
@@ -799,7 +960,7 @@ bool obqTryFlushI(output_buffers_queue_t *obqp) {
 
   /* If queue is empty and there is a buffer partially filled and
      it is not being written.*/
-  if (obqIsEmptyI(obqp) && (obqp->ptr != NULL)) {
+  if (obqIsEmptyI(obqp) && (obqp->ptr != NULL) && !obqp->inplace) {
     size_t size = (size_t)obqp->ptr - ((size_t)obqp->bwrptr + sizeof (size_t));
 
     if (size > 0U) {
@@ -22,6 +22,8 @@
  * @{
  */
 
+#include <string.h>
+
 #include "hal.h"
 
 #if (HAL_USE_CAN == TRUE) || defined(__DOXYGEN__)
@@ -30,6 +32,11 @@
 /* Driver local definitions.                                                 */
 /*===========================================================================*/
 
+/**
+ * @brief   Free slot marker in the software filter hash table.
+ */
+#define CAN_RX_FILTER_FREE          0xFFFFFFFFU
+
 /*===========================================================================*/
 /* Driver exported variables.                                                */
 /*===========================================================================*/
@@ -42,6 +49,134 @@
 /* Driver local functions.                                                   */
 /*===========================================================================*/
 
+#if (CAN_USE_RX_RING == TRUE) || defined(__DOXYGEN__)
+/**
+ * @brief   Home slot of an identifier in the software filter hash table.
+ *
+ * @param[in] id        frame identifier, @p CAN_ID_EXT for extended ones
+ * @return              The slot index.
+ */
+static inline size_t can_rx_filter_hash(uint32_t id) {
+
+  /* Fibonacci hashing, the upper bits are the well mixed ones.*/
+  return (size_t)(((id * 0x9E3779B1U) >> 16) & (CAN_RX_FILTER_SIZE - 1U));
+}
+
+/**
+ * @brief   Software acceptance filter check.
+ * @note    An empty filter accepts all frames.
+ *
+ * @param[in] canp      pointer to the @p CANDriver object
+ * @param[in] id        frame identifier, @p CAN_ID_EXT for extended ones
+ * @return              The filter result.
+ * @retval false        if the frame must be discarded.
+ * @retval true         if the frame is accepted.
+ */
+static bool can_rx_filter_match(CANDriver *canp, uint32_t id) {
+  size_t i;
+
+  if (canp->rxfilter_count == 0U) {
+    return true;
+  }
+
+  /* Linear probing, the table is never full so the loop terminates.*/
+  i = can_rx_filter_hash(id);
+  while (canp->rxfilter[i] != CAN_RX_FILTER_FREE) {
+    if (canp->rxfilter[i] == id) {
+      return true;
+    }
+    i = (i + 1U) & (CAN_RX_FILTER_SIZE - 1U);
+  }
+
+  return false;
+}
+
+/**
+ * @brief   Moves all the frames from the hardware mailboxes into the ring.
+ * @details Accepted frames are written directly into the ring slot after
+ *          the write index, the index is not updated here.
+ *
+ * @param[in] canp      pointer to the @p CANDriver object
+ * @param[in,out] wrp   pointer to the ring write index to be advanced
+ * @return              The overflow status.
+ * @retval false        if all accepted frames have been stored.
+ * @retval true         if one or more frames have been lost.
+ */
+static bool can_rx_ring_fill(CANDriver *canp, size_t *wrp) {
+  size_t wr = *wrp;
+  bool ovf = false;
+
+  while (can_lld_is_rx_nonempty(canp, CAN_ANY_MAILBOX)) {
+    CANRxStampedFrame *csfp;
+
+    if ((wr - canp->rxring_rdidx) > canp->rxring_mask) {
+      CANRxFrame dummy;
+
+      /* Ring full, the frame is fetched anyway in order to free the
+         mailbox and keep the receive interrupt enabled.*/
+      can_lld_receive(canp, CAN_ANY_MAILBOX, &dummy);
+      canp->rxring_overruns++;
+      ovf = true;
+      continue;
+    }
+
+    csfp = &canp->rxring[wr & canp->rxring_mask];
+    can_lld_receive(canp, CAN_ANY_MAILBOX, &csfp->frame);
+    if (!can_rx_filter_match(canp, can_lld_get_rx_id(&csfp->frame))) {
+      canp->rxfilter_rejects++;
+      continue;
+    }
+    csfp->timestamp = osalOsGetSystemTimeX();
+    wr++;
+  }
+
+  *wrp = wr;
+  return ovf;
+}
+#endif /* CAN_USE_RX_RING == TRUE */
+
+/**
+ * @brief   Checks for received frames.
+ *
+ * @param[in] canp      pointer to the @p CANDriver object
+ * @param[in] mailbox   mailbox number, ignored if the RX ring is active
+ * @return              The receive status.
+ */
+static inline bool can_rx_is_nonempty(CANDriver *canp, canmbx_t mailbox) {
+
+#if CAN_USE_RX_RING == TRUE
+  if (canp->rxring != NULL) {
+    return canp->rxring_wridx != canp->rxring_rdidx;
+  }
+#endif
+
+  return can_lld_is_rx_nonempty(canp, mailbox);
+}
+
+/**
+ * @brief   Fetches a received frame.
+ *
+ * @param[in] canp      pointer to the @p CANDriver object
+ * @param[in] mailbox   mailbox number, ignored if the RX ring is active
+ * @param[out] crfp     pointer to the buffer where the CAN frame is copied
+ */
+static inline void can_rx_fetch(CANDriver *canp,
+                                canmbx_t mailbox,
+                                CANRxFrame *crfp) {
+
+#if CAN_USE_RX_RING == TRUE
+  if (canp->rxring != NULL) {
+    size_t rd = canp->rxring_rdidx;
+
+    *crfp = canp->rxring[rd & canp->rxring_mask].frame;
+    canp->rxring_rdidx = rd + 1U;
+    return;
+  }
+#endif
+
+  can_lld_receive(canp, mailbox, crfp);
+}
+
 /*===========================================================================*/
 /* Driver exported functions.                                                */
 /*===========================================================================*/
@@ -87,6 +222,16 @@ void canObjectInit(CANDriver *canp) {
   canp->wakeup_cb   = NULL;
 #endif
 #endif /* CAN_ENFORCE_USE_CALLBACKS == TRUE */
+#if CAN_USE_RX_RING == TRUE
+  canp->rxring           = NULL;
+  canp->rxring_mask      = 0U;
+  canp->rxring_wridx     = 0U;
+  canp->rxring_rdidx     = 0U;
+  canp->rxring_overruns  = 0U;
+  canp->rxfilter_rejects = 0U;
+  canp->rxfilter_count   = 0U;
+  memset(canp->rxfilter, 0xFF, sizeof (canp->rxfilter));
+#endif
 }
 
 /**
@@ -151,6 +296,9 @@ void canStop(CANDriver *canp) {
   can_lld_stop(canp);
   canp->config = NULL;
   canp->state  = CAN_STOP;
+#if CAN_USE_RX_RING == TRUE
+  canp->rxring = NULL;
+#endif
 
   /* Threads waiting on CAN APIs are notified that the driver has been
      stopped in order to not have stuck threads.*/
@@ -198,6 +346,8 @@ bool canTryTransmitI(CANDriver *canp,
 /**
  * @brief   Can frame receive attempt.
  * @details The function tries to fetch a frame from a mailbox.
+ * @note    If the RX ring is active then frames are fetched from the ring
+ *          and the mailbox number is ignored.
  *
  * @param[in] canp      pointer to the @p CANDriver object
  * @param[in] mailbox   mailbox number, @p CAN_ANY_MAILBOX for any mailbox
@@ -219,12 +369,12 @@ bool canTryReceiveI(CANDriver *canp,
                 "invalid state");
 
   /* If the RX mailbox is empty then the function fails.*/
-  if (!can_lld_is_rx_nonempty(canp, mailbox)) {
+  if (!can_rx_is_nonempty(canp, mailbox)) {
     return true;
   }
 
   /* Fetching the frame.*/
-  can_lld_receive(canp, mailbox, crfp);
+  can_rx_fetch(canp, mailbox, crfp);
 
   return false;
 }
@@ -298,6 +448,8 @@ msg_t canTransmitTimeout(CANDriver *canp,
  * @brief   Can frame receive.
  * @details The function waits until a frame is received.
  * @note    Trying to receive while in sleep mode simply enqueues the thread.
+ * @note    If the RX ring is active then frames are fetched from the ring
+ *          and the mailbox number is ignored.
  *
  * @param[in] canp      pointer to the @p CANDriver object
  * @param[in] mailbox   mailbox number, @p CAN_ANY_MAILBOX for any mailbox
@@ -329,7 +481,7 @@ msg_t canReceiveTimeout(CANDriver *canp,
                 "invalid state");
 
   /*lint -save -e9007 [13.5] Right side is supposed to be pure.*/
-  while ((canp->state == CAN_SLEEP) || !can_lld_is_rx_nonempty(canp, mailbox)) {
+  while ((canp->state == CAN_SLEEP) || !can_rx_is_nonempty(canp, mailbox)) {
   /*lint -restore*/
     msg_t msg = osalThreadEnqueueTimeoutS(&canp->rxqueue, timeout);
     if (msg != MSG_OK) {
@@ -337,7 +489,7 @@ msg_t canReceiveTimeout(CANDriver *canp,
       return msg;
     }
   }
-  can_lld_receive(canp, mailbox, crfp);
+  can_rx_fetch(canp, mailbox, crfp);
   osalSysUnlock();
   return MSG_OK;
 }
@@ -399,6 +551,245 @@ void canWakeup(CANDriver *canp) {
 }
 #endif /* CAN_USE_SLEEP_MODE == TRUE */
 
+#if (CAN_USE_RX_RING == TRUE) || defined(__DOXYGEN__)
+/**
+ * @brief   Activates the software RX ring.
+ * @details From now on the receive ISR moves all the frames from the
+ *          hardware mailboxes into the ring, the frames are time stamped
+ *          and checked against the software acceptance filter. Frames
+ *          can then be fetched in batches using @p canReceiveMany(), the
+ *          single frame APIs fetch from the ring too.
+ * @note    Frames already waiting in the mailboxes are moved into the ring.
+ * @note    The ring is deactivated by @p canStop().
+ *
+ * @param[in] canp      pointer to the @p CANDriver object
+ * @param[in] buf       pointer to the ring buffer
+ * @param[in] n         number of frames in the ring buffer, must be a
+ *                      power of two
+ *
+ * @api
+ */
+void canRxRingStart(CANDriver *canp, CANRxStampedFrame *buf, size_t n) {
+  size_t wr;
+
+  osalDbgCheck((canp != NULL) && (buf != NULL) &&
+               (n > 0U) && ((n & (n - 1U)) == 0U));
+
+  osalSysLock();
+  osalDbgAssert((canp->state == CAN_READY) || (canp->state == CAN_SLEEP),
+                "invalid state");
+
+  canp->rxring       = buf;
+  canp->rxring_mask  = n - 1U;
+  canp->rxring_wridx = 0U;
+  canp->rxring_rdidx = 0U;
+
+  /* The receive interrupt is not generated again until the mailboxes are
+     emptied, pending frames are moved now.*/
+  wr = 0U;
+  (void) can_rx_ring_fill(canp, &wr);
+  canp->rxring_wridx = wr;
+  if (wr > 0U) {
+    osalThreadDequeueAllI(&canp->rxqueue, MSG_OK);
+    osalOsRescheduleS();
+  }
+  osalSysUnlock();
+}
+
+/**
+ * @brief   Deactivates the software RX ring.
+ * @details Frames still in the ring are discarded, threads waiting in
+ *          @p canReceiveMany() are released with @p MSG_RESET.
+ *
+ * @param[in] canp      pointer to the @p CANDriver object
+ *
+ * @api
+ */
+void canRxRingStop(CANDriver *canp) {
+
+  osalDbgCheck(canp != NULL);
+
+  osalSysLock();
+  canp->rxring = NULL;
+  osalThreadDequeueAllI(&canp->rxqueue, MSG_RESET);
+  osalOsRescheduleS();
+  osalSysUnlock();
+}
+
+/**
+ * @brief   Adds an identifier to the software acceptance filter.
+ * @details While the filter is empty all frames are accepted, after adding
+ *          the first identifier only frames matching one of the added
+ *          identifiers are stored in the RX ring.
+ * @note    The software filter complements the hardware filters, it is
+ *          only applied to frames passing the hardware filters.
+ *
+ * @param[in] canp      pointer to the @p CANDriver object
+ * @param[in] id        frame identifier, standard identifiers are specified
+ *                      as-is, extended identifiers must be or-ed with
+ *                      @p CAN_ID_EXT
+ * @return              The operation result.
+ * @retval false        if the identifier has been added or was already
+ *                      present.
+ * @retval true         if the filter table is full.
+ *
+ * @api
+ */
+bool canRxFilterAdd(CANDriver *canp, uint32_t id) {
+  size_t i;
+
+  osalDbgCheck((canp != NULL) && ((id & ~CAN_ID_EXT) <= 0x1FFFFFFFU));
+
+  osalSysLock();
+  i = can_rx_filter_hash(id);
+  while (canp->rxfilter[i] != CAN_RX_FILTER_FREE) {
+    if (canp->rxfilter[i] == id) {
+      osalSysUnlock();
+      return false;
+    }
+    i = (i + 1U) & (CAN_RX_FILTER_SIZE - 1U);
+  }
+
+  /* Keeping the load factor at or below 3/4 for short probe chains.*/
+  if (canp->rxfilter_count >= ((CAN_RX_FILTER_SIZE * 3U) / 4U)) {
+    osalSysUnlock();
+    return true;
+  }
+  canp->rxfilter[i] = id;
+  canp->rxfilter_count++;
+  osalSysUnlock();
+
+  return false;
+}
+
+/**
+ * @brief   Empties the software acceptance filter.
+ * @details After this call all frames are accepted again.
+ *
+ * @param[in] canp      pointer to the @p CANDriver object
+ *
+ * @api
+ */
+void canRxFilterClear(CANDriver *canp) {
+
+  osalDbgCheck(canp != NULL);
+
+  osalSysLock();
+  canp->rxfilter_count = 0U;
+  memset(canp->rxfilter, 0xFF, sizeof (canp->rxfilter));
+  osalSysUnlock();
+}
+
+/**
+ * @brief   Receives multiple frames from the RX ring.
+ * @details The function waits until at least one frame is in the ring then
+ *          fetches all the available frames up to the specified number.
+ * @pre     The RX ring must be active, see @p canRxRingStart().
+ * @note    Frames are copied outside the critical zone, only one thread
+ *          at time can fetch frames from the ring using this function.
+ *
+ * @param[in] canp      pointer to the @p CANDriver object
+ * @param[out] csfp     pointer to the array receiving the frames
+ * @param[in] n         maximum number of frames to be received
+ * @param[in] timeout   the number of ticks before the operation timeouts,
+ *                      the following special values are allowed:
+ *                      - @a TIME_IMMEDIATE immediate timeout.
+ *                      - @a TIME_INFINITE no timeout.
+ *                      .
+ * @return              The number of received frames, zero if the
+ *                      operation timed out or the ring has been stopped.
+ *
+ * @api
+ */
+size_t canReceiveMany(CANDriver *canp,
+                      CANRxStampedFrame *csfp,
+                      size_t n,
+                      sysinterval_t timeout) {
+  size_t rd, avail, first;
+  CANRxStampedFrame *ring;
+
+  osalDbgCheck((canp != NULL) && (csfp != NULL) && (n > 0U));
+
+  osalSysLock();
+  osalDbgAssert((canp->state == CAN_READY) || (canp->state == CAN_SLEEP),
+                "invalid state");
+  osalDbgAssert(canp->rxring != NULL, "RX ring not active");
+
+  /*lint -save -e9007 [13.5] Right side is supposed to be pure.*/
+  while ((canp->state == CAN_SLEEP) ||
+         (canp->rxring_wridx == canp->rxring_rdidx)) {
+  /*lint -restore*/
+    msg_t msg = osalThreadEnqueueTimeoutS(&canp->rxqueue, timeout);
+    if ((msg != MSG_OK) || (canp->rxring == NULL)) {
+      osalSysUnlock();
+      return (size_t)0;
+    }
+  }
+  ring  = canp->rxring;
+  rd    = canp->rxring_rdidx;
+  avail = canp->rxring_wridx - rd;
+  osalSysUnlock();
+
+  /* The ISR does not touch the slots between the two indexes, copying
+     outside the critical zone in at most two chunks.*/
+  if (n > avail) {
+    n = avail;
+  }
+  first = (canp->rxring_mask + 1U) - (rd & canp->rxring_mask);
+  if (first > n) {
+    first = n;
+  }
+  memcpy(csfp, &ring[rd & canp->rxring_mask], first * sizeof (*csfp));
+  if (n > first) {
+    memcpy(&csfp[first], ring, (n - first) * sizeof (*csfp));
+  }
+
+  osalSysLock();
+  canp->rxring_rdidx = rd + n;
+  osalSysUnlock();
+
+  return n;
+}
+
+/**
+ * @brief   RX ring service from the receive ISR.
+ * @details If the ring is active then all the frames are moved from the
+ *          hardware mailboxes into the ring, a @p CAN_OVERFLOW_ERROR is
+ *          signaled if the ring is full.
+ * @note    Not an API, this function is invoked by @p _can_rx_full_isr().
+ *
+ * @param[in] canp      pointer to the @p CANDriver object
+ * @return              The notification status.
+ * @retval false        if no frame has been stored.
+ * @retval true         if waiting threads must be notified.
+ *
+ * @notapi
+ */
+bool _can_rx_ring_serve_isr(CANDriver *canp) {
+  size_t wr;
+
+  if (canp->rxring == NULL) {
+    return true;
+  }
+
+  wr = canp->rxring_wridx;
+  if (can_rx_ring_fill(canp, &wr)) {
+    _can_error_isr(canp, CAN_OVERFLOW_ERROR);
+  }
+  if (wr == canp->rxring_wridx) {
+    return false;
+  }
+
+  /* Publishing the new frames, the lock orders the slots writes before
+     the index update.*/
+  osalSysLockFromISR();
+  canp->rxring_wridx = wr;
+  osalSysUnlockFromISR();
+
+  return true;
+}
+#endif /* CAN_USE_RX_RING == TRUE */
+
 #endif /* HAL_USE_CAN == TRUE */
 
 /** @} */
@@ -55,6 +55,11 @@ static bool mmc_write(void *instance, uint32_t startblk,
                         const uint8_t *buffer, uint32_t n);
 static bool mmc_sync(void *instance);
 static bool mmc_get_info(void *instance, BlockDeviceInfo *bdip);
+#if MMC_USE_PIPELINING == TRUE
+static bool mmc_read_pipelined(MMCDriver *mmcp, uint8_t *buffer, uint32_t n);
+static bool mmc_write_pipelined(MMCDriver *mmcp, const uint8_t *buffer,
+                                uint32_t n);
+#endif
 
 /**
  * @brief   Virtual methods table.
@@ -99,6 +104,46 @@ static const uint8_t mmc_crc7_lookup_table[256] = {
   0x62, 0x6b, 0x70, 0x79
 };
 
+#if (MMC_USE_DATA_CRC == TRUE) || defined(__DOXYGEN__)
+/**
+ * @brief   Lookup table for CRC-16 ( based on polynomial x^16 + x^12 + x^5 + 1).
+ */
+static const uint16_t mmc_crc16_lookup_table[256] = {
+  0x0000, 0x1021, 0x2042, 0x3063, 0x4084, 0x50a5, 0x60c6, 0x70e7,
+  0x8108, 0x9129, 0xa14a, 0xb16b, 0xc18c, 0xd1ad, 0xe1ce, 0xf1ef,
+  0x1231, 0x0210, 0x3273, 0x2252, 0x52b5, 0x4294, 0x72f7, 0x62d6,
+  0x9339, 0x8318, 0xb37b, 0xa35a, 0xd3bd, 0xc39c, 0xf3ff, 0xe3de,
+  0x2462, 0x3443, 0x0420, 0x1401, 0x64e6, 0x74c7, 0x44a4, 0x5485,
+  0xa56a, 0xb54b, 0x8528, 0x9509, 0xe5ee, 0xf5cf, 0xc5ac, 0xd58d,
+  0x3653, 0x2672, 0x1611, 0x0630, 0x76d7, 0x66f6, 0x5695, 0x46b4,
+  0xb75b, 0xa77a, 0x9719, 0x8738, 0xf7df, 0xe7fe, 0xd79d, 0xc7bc,
+  0x48c4, 0x58e5, 0x6886, 0x78a7, 0x0840, 0x1861, 0x2802, 0x3823,
+  0xc9cc, 0xd9ed, 0xe98e, 0xf9af, 0x8948, 0x9969, 0xa90a, 0xb92b,
+  0x5af5, 0x4ad4, 0x7ab7, 0x6a96, 0x1a71, 0x0a50, 0x3a33, 0x2a12,
+  0xdbfd, 0xcbdc, 0xfbbf, 0xeb9e, 0x9b79, 0x8b58, 0xbb3b, 0xab1a,
+  0x6ca6, 0x7c87, 0x4ce4, 0x5cc5, 0x2c22, 0x3c03, 0x0c60, 0x1c41,
+  0xedae, 0xfd8f, 0xcdec, 0xddcd, 0xad2a, 0xbd0b, 0x8d68, 0x9d49,
+  0x7e97, 0x6eb6, 0x5ed5, 0x4ef4, 0x3e13, 0x2e32, 0x1e51, 0x0e70,
+  0xff9f, 0xefbe, 0xdfdd, 0xcffc, 0xbf1b, 0xaf3a, 0x9f59, 0x8f78,
+  0x9188, 0x81a9, 0xb1ca, 0xa1eb, 0xd10c, 0xc12d, 0xf14e, 0xe16f,
+  0x1080, 0x00a1, 0x30c2, 0x20e3, 0x5004, 0x4025, 0x7046, 0x6067,
+  0x83b9, 0x9398, 0xa3fb, 0xb3da, 0xc33d, 0xd31c, 0xe37f, 0xf35e,
+  0x02b1, 0x1290, 0x22f3, 0x32d2, 0x4235, 0x5214, 0x6277, 0x7256,
+  0xb5ea, 0xa5cb, 0x95a8, 0x8589, 0xf56e, 0xe54f, 0xd52c, 0xc50d,
+  0x34e2, 0x24c3, 0x14a0, 0x0481, 0x7466, 0x6447, 0x5424, 0x4405,
+  0xa7db, 0xb7fa, 0x8799, 0x97b8, 0xe75f, 0xf77e, 0xc71d, 0xd73c,
+  0x26d3, 0x36f2, 0x0691, 0x16b0, 0x6657, 0x7676, 0x4615, 0x5634,
+  0xd94c, 0xc96d, 0xf90e, 0xe92f, 0x99c8, 0x89e9, 0xb98a, 0xa9ab,
+  0x5844, 0x4865, 0x7806, 0x6827, 0x18c0, 0x08e1, 0x3882, 0x28a3,
+  0xcb7d, 0xdb5c, 0xeb3f, 0xfb1e, 0x8bf9, 0x9bd8, 0xabbb, 0xbb9a,
+  0x4a75, 0x5a54, 0x6a37, 0x7a16, 0x0af1, 0x1ad0, 0x2ab3, 0x3a92,
+  0xfd2e, 0xed0f, 0xdd6c, 0xcd4d, 0xbdaa, 0xad8b, 0x9de8, 0x8dc9,
+  0x7c26, 0x6c07, 0x5c64, 0x4c45, 0x3ca2, 0x2c83, 0x1ce0, 0x0cc1,
+  0xef1f, 0xff3e, 0xcf5d, 0xdf7c, 0xaf9b, 0xbfba, 0x8fd9, 0x9ff8,
+  0x6e17, 0x7e36, 0x4e55, 0x5e74, 0x2e93, 0x3eb2, 0x0ed1, 0x1ef0
+};
+#endif
+
 /*===========================================================================*/
 /* Driver local functions.                                                   */
 /*===========================================================================*/
@@ -169,6 +214,12 @@ static bool mmc_read(void *instance, uint32_t startblk,
       break;
     }
 
+#if MMC_USE_PIPELINING == TRUE
+    if (mmc_read_pipelined(mmcp, buffer, n)) {
+      (void) mmcStopSequentialRead(mmcp);
+      break;
+    }
+#else
     while (n > 0U) {
       if (mmcSequentialRead(mmcp, buffer)) {
         break;
@@ -176,6 +227,7 @@ static bool mmc_read(void *instance, uint32_t startblk,
       buffer += MMCSD_BLOCK_SIZE;
       n--;
     }
+#endif
 
     if (mmcStopSequentialRead(mmcp)) {
       break;
@@ -205,6 +257,12 @@ static bool mmc_write(void *instance, uint32_t startblk,
       break;
     }
 
+#if MMC_USE_PIPELINING == TRUE
+    if (mmc_write_pipelined(mmcp, buffer, n)) {
+      (void) mmcStopSequentialWrite(mmcp);
+      break;
+    }
+#else
     while (n > 0U) {
       if (mmcSequentialWrite(mmcp, buffer)) {
         break;
@@ -212,6 +270,7 @@ static bool mmc_write(void *instance, uint32_t startblk,
       buffer += MMCSD_BLOCK_SIZE;
       n--;
     }
+#endif
 
     if (mmcStopSequentialWrite(mmcp)) {
       break;
@@ -270,6 +329,78 @@ static uint8_t mmc_crc7(uint8_t crc, const uint8_t *buffer, size_t len) {
   return crc;
 }
 
+#if (MMC_USE_DATA_CRC == TRUE) || defined(__DOXYGEN__)
+/**
+ * @brief Calculate the MMC standard CRC-16 based on a lookup table.
+ *
+ * @param[in] buffer    pointer to data buffer
+ * @param[in] len       length of data
+ * @return              Calculated CRC
+ */
+static uint16_t mmc_crc16(const uint8_t *buffer, size_t len) {
+  uint16_t crc = 0U;
+
+  while (len > 0U) {
+    crc = (uint16_t)(crc << 8U) ^
+          mmc_crc16_lookup_table[(crc >> 8U) ^ (uint16_t)*buffer++];
+    len--;
+  }
+  return crc;
+}
+#endif
+
+#if (MMC_USE_PIPELINING == TRUE) || defined(__DOXYGEN__)
+/**
+ * @brief   Starts an asynchronous receive operation.
+ *
+ * @param[in] mmcp      pointer to the @p MMCDriver object
+ * @param[in] n         number of bytes to receive
+ * @param[out] rxbuf    pointer to the receive buffer
+ *
+ * @notapi
+ */
+static void mmc_start_receive(MMCDriver *mmcp, size_t n, uint8_t *rxbuf) {
+
+  (void) spiStartReceive(mmcp->config->spip, n, rxbuf);
+}
+
+/**
+ * @brief   Starts an asynchronous send operation.
+ *
+ * @param[in] mmcp      pointer to the @p MMCDriver object
+ * @param[in] n         number of bytes to send
+ * @param[in] txbuf     pointer to the transmit buffer
+ *
+ * @notapi
+ */
+static void mmc_start_send(MMCDriver *mmcp, size_t n, const uint8_t *txbuf) {
+
+  (void) spiStartSend(mmcp->config->spip, n, txbuf);
+}
+
+/**
+ * @brief   Waits for the asynchronous operation to complete.
+ *
+ * @param[in] mmcp      pointer to the @p MMCDriver object
+ *
+ * @notapi
+ */
+static void mmc_wait_transfer(MMCDriver *mmcp) {
+#if defined(HAL_LLD_SELECT_SPI_V2)
+
+  (void) spiSynchronize(mmcp->config->spip, TIME_INFINITE);
+#else
+  SPIDriver *spip = mmcp->config->spip;
+
+  osalSysLock();
+  if (spip->state == SPI_ACTIVE) {
+    (void) osalThreadSuspendS(&spip->thread);
+  }
+  osalSysUnlock();
+#endif
+}
+#endif
+
 /**
  * @brief   Waits an idle condition.
  *
@@ -305,6 +436,29 @@ static bool mmc_wait_idle(MMCDriver *mmcp) {
   return HAL_FAILED;
 }
 
+/**
+ * @brief   Waits for a data start token.
+ *
+ * @param[in] mmcp      pointer to the @p MMCDriver object
+ * @return              The operation status.
+ * @retval HAL_SUCCESS  if the token has been received.
+ * @retval HAL_FAILED   if the operation timed out.
+ *
+ * @notapi
+ */
+static bool mmc_wait_token(MMCDriver *mmcp) {
+  unsigned i;
+
+  for (i = 0U; i < MMC_WAIT_DATA; i++) {
+    spiReceive(mmcp->config->spip, 1U, mmcp->buffer);
+    if (mmcp->buffer[0] == 0xFEU) {
+      return HAL_SUCCESS;
+    }
+  }
+
+  return HAL_FAILED;
+}
+
 /**
  * @brief   Sends a command header.
  *
@@ -491,6 +645,134 @@ static bool mmc_read_CxD(MMCDriver *mmcp, uint8_t cmd, uint32_t cxd[4]) {
   return HAL_FAILED;
 }
 
+#if (MMC_USE_PIPELINING == TRUE) || defined(__DOXYGEN__)
+/**
+ * @brief   Pipelined read of multiple blocks.
+ * @details The CRC of a block is verified while the following block is
+ *          being received, the CRC bytes and the first byte of the next
+ *          token wait are received in a single transfer.
+ * @pre     A sequential read operation must have been started.
+ *
+ * @param[in] mmcp      pointer to the @p MMCDriver object
+ * @param[out] buffer   pointer to the read buffer
+ * @param[in] n         number of blocks to read
+ * @return              The operation status.
+ * @retval HAL_SUCCESS  if the operation succeeded.
+ * @retval HAL_FAILED   if the operation failed.
+ *
+ * @notapi
+ */
+static bool mmc_read_pipelined(MMCDriver *mmcp, uint8_t *buffer, uint32_t n) {
+  bool token = false;
+#if MMC_USE_DATA_CRC == TRUE
+  const uint8_t *prevbuf = NULL;
+  uint16_t prevcrc = 0U;
+#endif
+
+  while (n > 0U) {
+
+    /* The token could have been already received with the previous CRC.*/
+    if (!token && (mmc_wait_token(mmcp) == HAL_FAILED)) {
+      return HAL_FAILED;
+    }
+
+    /* Block data transfer, the previous block is checked meanwhile.*/
+    mmc_start_receive(mmcp, MMCSD_BLOCK_SIZE, buffer);
+#if MMC_USE_DATA_CRC == TRUE
+    if ((prevbuf != NULL) &&
+        (mmc_crc16(prevbuf, MMCSD_BLOCK_SIZE) != prevcrc)) {
+      mmc_wait_transfer(mmcp);
+      return HAL_FAILED;
+    }
+#endif
+    mmc_wait_transfer(mmcp);
+
+    /* CRC and first byte of the next token.*/
+    spiReceive(mmcp->config->spip, 3U, mmcp->buffer);
+    token = (bool)(mmcp->buffer[2] == 0xFEU);
+#if MMC_USE_DATA_CRC == TRUE
+    prevcrc = (uint16_t)(((uint16_t)mmcp->buffer[0] << 8U) |
+                         (uint16_t)mmcp->buffer[1]);
+    prevbuf = buffer;
+#endif
+
+    buffer += MMCSD_BLOCK_SIZE;
+    n--;
+  }
+
+#if MMC_USE_DATA_CRC == TRUE
+  /* Last block check.*/
+  if ((prevbuf != NULL) &&
+      (mmc_crc16(prevbuf, MMCSD_BLOCK_SIZE) != prevcrc)) {
+    return HAL_FAILED;
+  }
+#endif
+
+  return HAL_SUCCESS;
+}
+
+/**
+ * @brief   Pipelined write of multiple blocks.
+ * @details The CRC of a block is calculated while the previous block is
+ *          being sent, the CRC bytes and the data response are exchanged
+ *          in a single transfer.
+ * @pre     A sequential write operation must have been started.
+ *
+ * @param[in] mmcp      pointer to the @p MMCDriver object
+ * @param[in] buffer    pointer to the write buffer
+ * @param[in] n         number of blocks to write
+ * @return              The operation status.
+ * @retval HAL_SUCCESS  if the operation succeeded.
+ * @retval HAL_FAILED   if the operation failed.
+ *
+ * @notapi
+ */
+static bool mmc_write_pipelined(MMCDriver *mmcp, const uint8_t *buffer,
+                                uint32_t n) {
+  static const uint8_t start[] = {0xFF, 0xFC};
+#if MMC_USE_DATA_CRC == TRUE
+  uint16_t crc, nextcrc;
+
+  crc = (n > 0U) ? mmc_crc16(buffer, MMCSD_BLOCK_SIZE) : 0U;
+#endif
+
+  while (n > 0U) {
+
+    /* Block data transfer, the next block CRC is calculated meanwhile.*/
+    spiSend(mmcp->config->spip, sizeof(start), start);
+    mmc_start_send(mmcp, MMCSD_BLOCK_SIZE, buffer);
+#if MMC_USE_DATA_CRC == TRUE
+    nextcrc = (n > 1U) ? mmc_crc16(buffer + MMCSD_BLOCK_SIZE,
+                                   MMCSD_BLOCK_SIZE) : 0U;
+    mmcp->buffer[0] = (uint8_t)(crc >> 8U);
+    mmcp->buffer[1] = (uint8_t)crc;
+    crc = nextcrc;
+#else
+    mmcp->buffer[0] = 0xFFU;
+    mmcp->buffer[1] = 0xFFU;
+#endif
+    mmcp->buffer[2] = 0xFFU;
+    mmc_wait_transfer(mmcp);
+
+    /* CRC and data response.*/
+    spiExchange(mmcp->config->spip, 3U, &mmcp->buffer[0], &mmcp->buffer[4]);
+    if ((mmcp->buffer[6] & 0x1FU) != 0x05U) {
+      spiUnselect(mmcp->config->spip);
+      mmcp->state = BLK_READY;
+      return HAL_FAILED;
+    }
+    if (mmc_wait_idle(mmcp) == HAL_FAILED) {
+      return HAL_FAILED;
+    }
+
+    buffer += MMCSD_BLOCK_SIZE;
+    n--;
+  }
+
+  return HAL_SUCCESS;
+}
+#endif /* MMC_USE_PIPELINING == TRUE */
+
 /*===========================================================================*/
 /* Driver exported functions.                                                */
 /*===========================================================================*/
@@ -676,6 +958,14 @@ bool mmcConnect(MMCDriver *mmcp) {
     goto failed;
   }
 
+#if MMC_USE_DATA_CRC == TRUE
+  /* Enabling the CRC checking on the card side.*/
+  if ((mmc_send_command_R1(mmcp, MMCSD_CMD_CRC_ON_OFF, 1U, &r1) == HAL_FAILED) ||
+      (r1 != 0x00U)) {
+    goto failed;
+  }
+#endif
+
   /* Determine capacity.*/
   if (mmc_read_CxD(mmcp, MMCSD_CMD_SEND_CSD, mmcp->csd) == HAL_FAILED) {
     goto failed;
@@ -813,7 +1103,6 @@ failed:
  * @api
  */
 bool mmcSequentialRead(MMCDriver *mmcp, uint8_t *buffer) {
-  unsigned i;
 
   osalDbgCheck((mmcp != NULL) && (buffer != NULL));
 
@@ -821,14 +1110,22 @@ bool mmcSequentialRead(MMCDriver *mmcp, uint8_t *buffer) {
     return HAL_FAILED;
   }
 
-  for (i = 0; i < MMC_WAIT_DATA; i++) {
-    spiReceive(mmcp->config->spip, 1, mmcp->buffer);
-    if (mmcp->buffer[0] == 0xFEU) {
-      spiReceive(mmcp->config->spip, MMCSD_BLOCK_SIZE, buffer);
-      /* CRC ignored. */
-      spiIgnore(mmcp->config->spip, 2);
-      return HAL_SUCCESS;
+  if (mmc_wait_token(mmcp) == HAL_SUCCESS) {
+    spiReceive(mmcp->config->spip, MMCSD_BLOCK_SIZE, buffer);
+#if MMC_USE_DATA_CRC == TRUE
+    spiReceive(mmcp->config->spip, 2, mmcp->buffer);
+    if (mmc_crc16(buffer, MMCSD_BLOCK_SIZE) !=
+        (uint16_t)(((uint16_t)mmcp->buffer[0] << 8U) |
+                   (uint16_t)mmcp->buffer[1])) {
+      /* CRC error, the read operation is terminated.*/
+      (void) mmcStopSequentialRead(mmcp);
+      return HAL_FAILED;
     }
+#else
+    /* CRC ignored. */
+    spiIgnore(mmcp->config->spip, 2);
+#endif
+    return HAL_SUCCESS;
   }
 
   /* Timeout.*/
@@ -853,7 +1150,7 @@ bool mmcSequentialRead(MMCDriver *mmcp, uint8_t *buffer) {
 bool mmcStopSequentialRead(MMCDriver *mmcp) {
   uint8_t r1;
   static const uint8_t stopcmd[] = {
-    (uint8_t)(0x40U | MMCSD_CMD_STOP_TRANSMISSION), 0, 0, 0, 0, 1, 0xFF
+    (uint8_t)(0x40U | MMCSD_CMD_STOP_TRANSMISSION), 0, 0, 0, 0, 0x61, 0xFF
   };
 
   osalDbgCheck(mmcp != NULL);
@@ -940,6 +1237,9 @@ failed:
  */
 bool mmcSequentialWrite(MMCDriver *mmcp, const uint8_t *buffer) {
   static const uint8_t start[] = {0xFF, 0xFC};
+#if MMC_USE_DATA_CRC == TRUE
+  uint16_t crc;
+#endif
 
   osalDbgCheck((mmcp != NULL) && (buffer != NULL));
 
@@ -949,7 +1249,14 @@ bool mmcSequentialWrite(MMCDriver *mmcp, const uint8_t *buffer) {
 
   spiSend(mmcp->config->spip, sizeof(start), start);    /* Data prologue.   */
   spiSend(mmcp->config->spip, MMCSD_BLOCK_SIZE, buffer);/* Data.            */
+#if MMC_USE_DATA_CRC == TRUE
+  crc = mmc_crc16(buffer, MMCSD_BLOCK_SIZE);
+  mmcp->buffer[0] = (uint8_t)(crc >> 8U);
+  mmcp->buffer[1] = (uint8_t)crc;
+  spiSend(mmcp->config->spip, 2, mmcp->buffer);         /* CRC.             */
+#else
   spiIgnore(mmcp->config->spip, 2);                     /* CRC ignored.     */
+#endif
   spiReceive(mmcp->config->spip, 1, mmcp->buffer);
   if ((mmcp->buffer[0] & 0x1FU) == 0x05U) {
     return mmc_wait_idle(mmcp);
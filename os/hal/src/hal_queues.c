@@ -241,6 +241,57 @@ msg_t iqPutI(input_queue_t *iqp, uint8_t b) {
   return MSG_TIMEOUT;
 }
 
+/**
+ * @brief   Input queue non-blocking write.
+ * @details The function writes data from a buffer to an input queue. The
+ *          operation completes immediately, data exceeding the queue free
+ *          space is not written.
+ * @note    This function is meant for low level drivers receiving data in
+ *          blocks, it is equivalent to calling @p iqPutI() for each byte
+ *          but the waiting threads are woken up only once.
+ *
+ * @param[in] iqp       pointer to an @p input_queue_t structure
+ * @param[in] bp        pointer to the data buffer
+ * @param[in] n         the maximum amount of data to be transferred
+ * @return              The number of bytes effectively transferred.
+ *
+ * @iclass
+ */
+size_t iqWriteI(input_queue_t *iqp, const uint8_t *bp, size_t n) {
+  size_t s1;
+
+  osalDbgCheckClassI();
+
+  /* Number of bytes that can be written in a single atomic operation.*/
+  if (n > iqGetEmptyI(iqp)) {
+    n = iqGetEmptyI(iqp);
+  }
+  if (n == (size_t)0) {
+    return (size_t)0;
+  }
+
+  /* Number of bytes before buffer limit.*/
+  /*lint -save -e9033 [10.8] Checked to be safe.*/
+  s1 = (size_t)(iqp->q_top - iqp->q_wrptr);
+  /*lint -restore*/
+  if (n < s1) {
+    memcpy((void *)iqp->q_wrptr, (const void *)bp, n);
+    iqp->q_wrptr += n;
+  }
+  else {
+    memcpy((void *)iqp->q_wrptr, (const void *)bp, s1);
+    memcpy((void *)iqp->q_buffer, (const void *)(bp + s1), n - s1);
+    iqp->q_wrptr = iqp->q_buffer + (n - s1);
+  }
+
+  iqp->q_counter += n;
+
+  /* Readers re-check the queue state after wakeup.*/
+  osalThreadDequeueAllI(&iqp->q_waiting, MSG_OK);
+
+  return n;
+}
+
 /**
  * @brief   Input queue non-blocking read.
  * @details This function reads a byte value from an input queue. The
@@ -600,6 +651,39 @@ msg_t oqGetI(output_queue_t *oqp) {
   return MSG_TIMEOUT;
 }
 
+/**
+ * @brief   Output queue non-blocking consume.
+ * @details The function removes data from an output queue without copying
+ *          it, the data is meant to have been already transmitted by
+ *          accessing the queue buffer in place starting from the read
+ *          pointer.
+ * @note    This function is meant for low level drivers transmitting data
+ *          in blocks, it is equivalent to calling @p oqGetI() for each byte
+ *          but the waiting threads are woken up only once.
+ *
+ * @param[in] oqp       pointer to an @p output_queue_t structure
+ * @param[in] n         the amount of data to be removed, it must not exceed
+ *                      the filled space in the queue
+ *
+ * @iclass
+ */
+void oqConsumeI(output_queue_t *oqp, size_t n) {
+
+  osalDbgCheckClassI();
+  osalDbgCheck(n <= oqGetFullI(oqp));
+
+  if (n > (size_t)0) {
+    oqp->q_counter += n;
+    oqp->q_rdptr   += n;
+    if (oqp->q_rdptr >= oqp->q_top) {
+      oqp->q_rdptr -= qSizeX(oqp);
+    }
+
+    /* Writers re-check the queue state after wakeup.*/
+    osalThreadDequeueAllI(&oqp->q_waiting, MSG_OK);
+  }
+}
+
 /**
  * @brief   Output queue non-blocking write.
  * @details The function writes data from a buffer to an output queue. The
@@ -263,6 +263,35 @@ void sdIncomingDataI(SerialDriver *sdp, uint8_t b) {
     chnAddFlagsI(sdp, SD_QUEUE_FULL_ERROR);
 }
 
+/**
+ * @brief   Handles a block of incoming data.
+ * @details This function can be called from the input interrupt service
+ *          routine of drivers able to receive data in blocks, it is
+ *          equivalent to calling @p sdIncomingDataI() for each byte.
+ * @note    The incoming data event is only generated when the input queue
+ *          becomes non-empty.
+ *
+ * @param[in] sdp       pointer to a @p SerialDriver structure
+ * @param[in] bp        pointer to the received data
+ * @param[in] n         number of bytes to be written in the driver's Input
+ *                      Queue
+ *
+ * @iclass
+ */
+void sdIncomingDataBufferI(SerialDriver *sdp, const uint8_t *bp, size_t n) {
+
+  osalDbgCheckClassI();
+  osalDbgCheck((sdp != NULL) && (bp != NULL));
+
+  if (n == (size_t)0)
+    return;
+
+  if (iqIsEmptyI(&sdp->iqueue))
+    chnAddFlagsI(sdp, CHN_INPUT_AVAILABLE);
+  if (iqWriteI(&sdp->iqueue, bp, n) < n)
+    chnAddFlagsI(sdp, SD_QUEUE_FULL_ERROR);
+}
+
 /**
  * @brief   Handles outgoing data.
  * @details Must be called from the output interrupt service routine in order
@@ -350,6 +350,21 @@ void sduWakeupHookI(SerialUSBDriver *sdup) {
  * @iclass
  */
 void sduConfigureHookI(SerialUSBDriver *sdup) {
+  const USBEndpointConfig *inepcp, *outepcp;
+
+  /* Buffers are moved by multi-packet transfers, a buffer not ending on a
+     packet boundary would terminate each transmission with a short packet
+     and would be overflown by the last received packet.*/
+  inepcp  = sdup->config->usbp->epc[sdup->config->bulk_in];
+  outepcp = sdup->config->usbp->epc[sdup->config->bulk_out];
+  osalDbgAssert((inepcp == NULL) ||
+                ((SERIAL_USB_BUFFERS_SIZE % inepcp->in_maxsize) == 0U),
+                "buffers size not multiple of IN packet size");
+  osalDbgAssert((outepcp == NULL) ||
+                ((SERIAL_USB_BUFFERS_SIZE % outepcp->out_maxsize) == 0U),
+                "buffers size not multiple of OUT packet size");
+  (void)inepcp;
+  (void)outepcp;
 
   ibqResetI(&sdup->ibqueue);
   bqResumeX(&sdup->ibqueue);
@@ -0,0 +1,497 @@
+/*
+    ChibiOS - Copyright (C) 2006..2018 Giovanni Di Sirio
+
+    Licensed under the Apache License, Version 2.0 (the "License");
+    you may not use this file except in compliance with the License.
+    You may obtain a copy of the License at
+
+        http://www.apache.org/licenses/LICENSE-2.0
+
+    Unless required by applicable law or agreed to in writing, software
+    distributed under the License is distributed on an "AS IS" BASIS,
+    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+    See the License for the specific language governing permissions and
+    limitations under the License.
+*/
+
+/**
+ * @file    hal_spsc.c
+ * @brief   Lock-free SPSC rings code.
+ *
+ * @addtogroup HAL_SPSC
+ * @details Rings are meant for the common case where data flows from
+ *          exactly one producer to exactly one consumer, for example from
+ *          a driver interrupt handler to a processing thread.<br>
+ *          The producer publishes elements by advancing the write index
+ *          with release semantic after copying them, the consumer
+ *          releases slots by advancing the read index after copying the
+ *          elements out. The non-blocking @p spscWriteX() and
+ *          @p spscReadX() functions never enter a critical zone unless the
+ *          other side is a thread waiting on the ring and the awaited
+ *          condition has been reached.<br>
+ *          A waiting thread declares how many elements, or free slots,
+ *          it needs before suspending, the other side wakes it only when
+ *          the condition is satisfied so a reader waiting for a block is
+ *          not awakened for every single element.
+ * @{
+ */
+
+#include <string.h>
+
+#include "hal.h"
+
+/*===========================================================================*/
+/* Driver local definitions.                                                 */
+/*===========================================================================*/
+
+/**
+ * @name    Memory ordering primitives
+ * @{
+ */
+#if defined(__GNUC__) || defined(__DOXYGEN__)
+#if (defined(PORT_CORES_NUMBER) && (PORT_CORES_NUMBER > 1)) ||              \
+    defined(__DOXYGEN__)
+/**
+ * @brief   Orders previous loads before following loads and stores.
+ */
+#define SPSC_ACQUIRE()      __atomic_thread_fence(__ATOMIC_ACQUIRE)
+
+/**
+ * @brief   Orders previous loads and stores before following stores.
+ */
+#define SPSC_RELEASE()      __atomic_thread_fence(__ATOMIC_RELEASE)
+
+/**
+ * @brief   Orders previous stores before following loads.
+ */
+#define SPSC_FENCE()        __atomic_thread_fence(__ATOMIC_SEQ_CST)
+#else
+/* On a single core the other side is an ISR or a thread running on the
+   same core, it is enough to prevent the compiler from reordering.*/
+#define SPSC_ACQUIRE()      __atomic_signal_fence(__ATOMIC_ACQUIRE)
+#define SPSC_RELEASE()      __atomic_signal_fence(__ATOMIC_RELEASE)
+#define SPSC_FENCE()        __atomic_signal_fence(__ATOMIC_SEQ_CST)
+#endif
+#else
+/* Compilers without atomic builtins, an empty critical zone is used as
+   full barrier.*/
+#define SPSC_ACQUIRE()      spsc_barrier()
+#define SPSC_RELEASE()      spsc_barrier()
+#define SPSC_FENCE()        spsc_barrier()
+#endif
+/** @} */
+
+/*===========================================================================*/
+/* Driver exported variables.                                                */
+/*===========================================================================*/
+
+/*===========================================================================*/
+/* Driver local variables and types.                                         */
+/*===========================================================================*/
+
+/*===========================================================================*/
+/* Driver local functions.                                                   */
+/*===========================================================================*/
+
+#if !defined(__GNUC__)
+static void spsc_barrier(void) {
+  syssts_t sts;
+
+  sts = osalSysGetStatusAndLockX();
+  osalSysRestoreStatusX(sts);
+}
+#endif
+
+/**
+ * @brief   Copies elements into the ring.
+ *
+ * @param[in] rp        pointer to a @p spsc_ring_t structure
+ * @param[in] bp        pointer to the elements
+ * @param[in] idx       index of the first slot
+ * @param[in] n         number of elements
+ */
+static void spsc_copy_in(spsc_ring_t *rp, const uint8_t *bp,
+                         size_t idx, size_t n) {
+  size_t first, slot = idx & rp->mask;
+
+  first = spscGetSizeX(rp) - slot;
+  if (first > n) {
+    first = n;
+  }
+  memcpy(rp->buffer + (slot * rp->esize), bp, first * rp->esize);
+  if (n > first) {
+    memcpy(rp->buffer, bp + (first * rp->esize), (n - first) * rp->esize);
+  }
+}
+
+/**
+ * @brief   Copies elements out of the ring.
+ *
+ * @param[in] rp        pointer to a @p spsc_ring_t structure
+ * @param[out] bp       pointer to the elements buffer
+ * @param[in] idx       index of the first slot
+ * @param[in] n         number of elements
+ */
+static void spsc_copy_out(spsc_ring_t *rp, uint8_t *bp,
+                          size_t idx, size_t n) {
+  size_t first, slot = idx & rp->mask;
+
+  first = spscGetSizeX(rp) - slot;
+  if (first > n) {
+    first = n;
+  }
+  memcpy(bp, rp->buffer + (slot * rp->esize), first * rp->esize);
+  if (n > first) {
+    memcpy(bp + (first * rp->esize), rp->buffer, (n - first) * rp->esize);
+  }
+}
+
+/**
+ * @brief   Wakes up the other side if its condition is satisfied.
+ * @note    The awaited amount is read after a full barrier, a thread
+ *          declaring it concurrently either sees the moved index or is
+ *          seen here.
+ *
+ * @param[in] rp        pointer to a @p spsc_ring_t structure
+ * @param[in] reader    @p true if notifying the consumer, @p false if
+ *                      notifying the producer
+ */
+static void spsc_notify(spsc_ring_t *rp, bool reader) {
+  size_t wanted, avail;
+
+  SPSC_FENCE();
+  if (reader) {
+    wanted = rp->rdwanted;
+    avail  = spscGetUsedX(rp);
+  }
+  else {
+    wanted = rp->wrwanted;
+    avail  = spscGetFreeX(rp);
+  }
+  if ((wanted > 0U) && (avail >= wanted)) {
+    syssts_t sts;
+
+    sts = osalSysGetStatusAndLockX();
+    osalThreadResumeI(reader ? &rp->rdthread : &rp->wrthread, MSG_OK);
+    osalSysRestoreStatusX(sts);
+  }
+}
+
+/**
+ * @brief   Waits for an amount to become available.
+ * @details The awaited amount is declared before checking the
+ *          condition, the other side checks it after moving its index.
+ *
+ * @param[in] rp        pointer to a @p spsc_ring_t structure
+ * @param[in] wanted    awaited amount
+ * @param[in] reader    @p true if waiting for elements, @p false if
+ *                      waiting for free slots
+ * @param[in] timeout   the number of ticks before the operation timeouts
+ * @return              The wakeup message.
+ */
+static msg_t spsc_wait(spsc_ring_t *rp, size_t wanted,
+                       bool reader, sysinterval_t timeout) {
+  msg_t msg = MSG_OK;
+
+  osalSysLock();
+  if (reader) {
+    rp->rdwanted = wanted;
+    SPSC_FENCE();
+    if (spscGetUsedX(rp) < wanted) {
+      msg = osalThreadSuspendTimeoutS(&rp->rdthread, timeout);
+    }
+    rp->rdwanted = 0U;
+  }
+  else {
+    rp->wrwanted = wanted;
+    SPSC_FENCE();
+    if (spscGetFreeX(rp) < wanted) {
+      msg = osalThreadSuspendTimeoutS(&rp->wrthread, timeout);
+    }
+    rp->wrwanted = 0U;
+  }
+  osalSysUnlock();
+
+  return msg;
+}
+
+/*===========================================================================*/
+/* Driver exported functions.                                                */
+/*===========================================================================*/
+
+/**
+ * @brief   Initializes a ring.
+ *
+ * @param[out] rp       pointer to a @p spsc_ring_t structure
+ * @param[in] buffer    pointer to a buffer of @p n elements
+ * @param[in] esize     size of an element in bytes
+ * @param[in] n         number of elements in the buffer, it must be a
+ *                      power of two
+ *
+ * @init
+ */
+void spscObjectInit(spsc_ring_t *rp, void *buffer, size_t esize, size_t n) {
+
+  osalDbgCheck((rp != NULL) && (buffer != NULL) && (esize > 0U) &&
+               (n > 0U) && ((n & (n - 1U)) == 0U));
+
+  rp->buffer   = (uint8_t *)buffer;
+  rp->esize    = esize;
+  rp->mask     = n - 1U;
+  rp->wridx    = 0U;
+  rp->rdidx    = 0U;
+  rp->rdwanted = 0U;
+  rp->wrwanted = 0U;
+  rp->rdthread = NULL;
+  rp->wrthread = NULL;
+}
+
+/**
+ * @brief   Non-blocking ring write.
+ * @details Writes as many elements as the free slots allow.
+ * @note    This function must be called by the producer only, it can be
+ *          called from threads, from interrupt handlers and from within
+ *          critical zones.
+ *
+ * @param[in] rp        pointer to a @p spsc_ring_t structure
+ * @param[in] bp        pointer to the elements to be written
+ * @param[in] n         maximum number of elements to be written
+ * @return              The number of elements written.
+ *
+ * @xclass
+ */
+size_t spscWriteX(spsc_ring_t *rp, const void *bp, size_t n) {
+  size_t wr, rd, free;
+
+  wr = rp->wridx;
+  rd = rp->rdidx;
+  SPSC_ACQUIRE();
+
+  free = spscGetSizeX(rp) - (wr - rd);
+  if (n > free) {
+    n = free;
+  }
+  if (n > 0U) {
+    spsc_copy_in(rp, (const uint8_t *)bp, wr, n);
+    SPSC_RELEASE();
+    rp->wridx = wr + n;
+
+    spsc_notify(rp, true);
+  }
+
+  return n;
+}
+
+/**
+ * @brief   Non-blocking ring read.
+ * @details Reads as many elements as available.
+ * @note    This function must be called by the consumer only, it can be
+ *          called from threads, from interrupt handlers and from within
+ *          critical zones.
+ *
+ * @param[in] rp        pointer to a @p spsc_ring_t structure
+ * @param[out] bp       pointer to the elements buffer
+ * @param[in] n         maximum number of elements to be read
+ * @return              The number of elements read.
+ *
+ * @xclass
+ */
+size_t spscReadX(spsc_ring_t *rp, void *bp, size_t n) {
+  size_t wr, rd, used;
+
+  rd = rp->rdidx;
+  wr = rp->wridx;
+  SPSC_ACQUIRE();
+
+  used = wr - rd;
+  if (n > used) {
+    n = used;
+  }
+  if (n > 0U) {
+    spsc_copy_out(rp, (uint8_t *)bp, rd, n);
+    SPSC_RELEASE();
+    rp->rdidx = rd + n;
+
+    spsc_notify(rp, false);
+  }
+
+  return n;
+}
+
+/**
+ * @brief   Non-blocking byte write.
+ * @note    This function must be called by the producer only, it can be
+ *          called from threads, from interrupt handlers and from within
+ *          critical zones.
+ * @note    The ring must have been initialized with an element size of
+ *          one byte.
+ *
+ * @param[in] rp        pointer to a @p spsc_ring_t structure
+ * @param[in] b         the byte value to be written
+ * @return              The operation status.
+ * @retval MSG_OK       if the operation succeeded.
+ * @retval MSG_TIMEOUT  if the ring is full.
+ *
+ * @xclass
+ */
+msg_t spscPutX(spsc_ring_t *rp, uint8_t b) {
+  size_t wr;
+
+  osalDbgCheck(rp->esize == 1U);
+
+  wr = rp->wridx;
+  if ((wr - rp->rdidx) > rp->mask) {
+    return MSG_TIMEOUT;
+  }
+  SPSC_ACQUIRE();
+
+  rp->buffer[wr & rp->mask] = b;
+  SPSC_RELEASE();
+  rp->wridx = wr + 1U;
+
+  spsc_notify(rp, true);
+
+  return MSG_OK;
+}
+
+/**
+ * @brief   Non-blocking byte read.
+ * @note    This function must be called by the consumer only, it can be
+ *          called from threads, from interrupt handlers and from within
+ *          critical zones.
+ * @note    The ring must have been initialized with an element size of
+ *          one byte.
+ *
+ * @param[in] rp        pointer to a @p spsc_ring_t structure
+ * @return              A byte value from the ring.
+ * @retval MSG_TIMEOUT  if the ring is empty.
+ *
+ * @xclass
+ */
+msg_t spscGetX(spsc_ring_t *rp) {
+  size_t rd;
+  uint8_t b;
+
+  osalDbgCheck(rp->esize == 1U);
+
+  rd = rp->rdidx;
+  if (rd == rp->wridx) {
+    return MSG_TIMEOUT;
+  }
+  SPSC_ACQUIRE();
+
+  b = rp->buffer[rd & rp->mask];
+  SPSC_RELEASE();
+  rp->rdidx = rd + 1U;
+
+  spsc_notify(rp, false);
+
+  return (msg_t)b;
+}
+
+/**
+ * @brief   Ring write with timeout.
+ * @details The function writes elements into the ring, if the ring is full
+ *          then the calling thread waits until there are enough free slots
+ *          for the remaining elements, or for the whole ring if smaller.
+ *          The operation completes when all the elements have been written
+ *          or after the specified timeout.
+ * @note    This function must be called by the producer only.
+ *
+ * @param[in] rp        pointer to a @p spsc_ring_t structure
+ * @param[in] bp        pointer to the elements to be written
+ * @param[in] n         the number of elements to be written, the value 0
+ *                      is reserved
+ * @param[in] timeout   the number of ticks before the operation timeouts,
+ *                      the following special values are allowed:
+ *                      - @a TIME_IMMEDIATE immediate timeout.
+ *                      - @a TIME_INFINITE no timeout.
+ *                      .
+ * @return              The number of elements effectively written.
+ *
+ * @api
+ */
+size_t spscWriteTimeout(spsc_ring_t *rp, const void *bp,
+                        size_t n, sysinterval_t timeout) {
+  const uint8_t *p = (const uint8_t *)bp;
+  size_t max = n;
+
+  osalDbgCheck(n > 0U);
+
+  while (n > 0U) {
+    size_t done;
+
+    done = spscWriteX(rp, p, n);
+    if (done > 0U) {
+      n -= done;
+      p += done * rp->esize;
+    }
+    else {
+      size_t wanted = n < spscGetSizeX(rp) ? n : spscGetSizeX(rp);
+
+      /* Anything except MSG_OK causes the operation to stop, whatever
+         fits is written before returning.*/
+      if (spsc_wait(rp, wanted, false, timeout) != MSG_OK) {
+        n -= spscWriteX(rp, p, n);
+        break;
+      }
+    }
+  }
+
+  return max - n;
+}
+
+/**
+ * @brief   Ring read with timeout.
+ * @details The function reads elements from the ring, if the ring is empty
+ *          then the calling thread waits until there are enough elements
+ *          to complete the operation, or a whole ring if smaller, this
+ *          avoids waking up the thread for every single element.
+ *          The operation completes when all the elements have been read
+ *          or after the specified timeout.
+ * @note    This function must be called by the consumer only.
+ *
+ * @param[in] rp        pointer to a @p spsc_ring_t structure
+ * @param[out] bp       pointer to the elements buffer
+ * @param[in] n         the number of elements to be read, the value 0
+ *                      is reserved
+ * @param[in] timeout   the number of ticks before the operation timeouts,
+ *                      the following special values are allowed:
+ *                      - @a TIME_IMMEDIATE immediate timeout.
+ *                      - @a TIME_INFINITE no timeout.
+ *                      .
+ * @return              The number of elements effectively read.
+ *
+ * @api
+ */
+size_t spscReadTimeout(spsc_ring_t *rp, void *bp,
+                       size_t n, sysinterval_t timeout) {
+  uint8_t *p = (uint8_t *)bp;
+  size_t max = n;
+
+  osalDbgCheck(n > 0U);
+
+  while (n > 0U) {
+    size_t done;
+
+    done = spscReadX(rp, p, n);
+    if (done > 0U) {
+      n -= done;
+      p += done * rp->esize;
+    }
+    else {
+      size_t wanted = n < spscGetSizeX(rp) ? n : spscGetSizeX(rp);
+
+      /* Anything except MSG_OK causes the operation to stop, whatever
+         arrived is read before returning.*/
+      if (spsc_wait(rp, wanted, true, timeout) != MSG_OK) {
+        n -= spscReadX(rp, p, n);
+        break;
+      }
+    }
+  }
+
+  return max - n;
+}
+
+/** @} */
@@ -229,6 +229,7 @@ struct hal_can_driver {
   can_callback_t            wakeup_cb;
 #endif
 #endif
+  _can_rx_ring_data
   /* End of the mandatory fields.*/
 };
 
@@ -236,6 +237,19 @@ struct hal_can_driver {
 /* Driver macros.                                                            */
 /*===========================================================================*/
 
+/**
+ * @brief   Returns the identifier of a received frame.
+ * @details Extended identifiers are or-ed with @p CAN_ID_EXT.
+ *
+ * @param[in] crfp      pointer to the @p CANRxFrame object
+ * @return              The frame identifier.
+ *
+ * @notapi
+ */
+#define can_lld_get_rx_id(crfp)                                             \
+  ((crfp)->IDE != 0U ? ((uint32_t)(crfp)->EID | CAN_ID_EXT) :               \
+                       (uint32_t)(crfp)->SID)
+
 /*===========================================================================*/
 /* External declarations.                                                    */
 /*===========================================================================*/
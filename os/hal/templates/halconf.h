@@ -259,6 +259,21 @@
 #define CAN_ENFORCE_USE_CALLBACKS           FALSE
 #endif
 
+/**
+ * @brief   Software RX ring related APIs inclusion switch.
+ */
+#if !defined(CAN_USE_RX_RING) || defined(__DOXYGEN__)
+#define CAN_USE_RX_RING                     FALSE
+#endif
+
+/**
+ * @brief   Size of the software acceptance filter hash table.
+ * @note    Must be a power of two.
+ */
+#if !defined(CAN_RX_FILTER_SIZE) || defined(__DOXYGEN__)
+#define CAN_RX_FILTER_SIZE                  64
+#endif
+
 /*===========================================================================*/
 /* CRY driver related settings.                                              */
 /*===========================================================================*/
@@ -349,6 +364,24 @@
 #define MMC_USE_MUTUAL_EXCLUSION            TRUE
 #endif
 
+/**
+ * @brief   Data blocks CRC.
+ * @details If enabled the CRC checking is activated on the card, the
+ *          CRC-16 of data blocks is sent on writes and verified on reads.
+ */
+#if !defined(MMC_USE_DATA_CRC) || defined(__DOXYGEN__)
+#define MMC_USE_DATA_CRC                    FALSE
+#endif
+
+/**
+ * @brief   Pipelined multi-block transfers.
+ * @details If enabled the multi-block transfers overlap the data transfer
+ *          of a block with the CRC handling of the adjacent block.
+ */
+#if !defined(MMC_USE_PIPELINING) || defined(__DOXYGEN__)
+#define MMC_USE_PIPELINING                  FALSE
+#endif
+
 /*===========================================================================*/
 /* SDC driver related settings.                                              */
 /*===========================================================================*/
@@ -112,6 +112,10 @@
 #error "CH_CFG_USE_PIPES not defined in chconf.h"
 #endif
 
+#if !defined(CH_CFG_USE_MSG_QUEUES)
+#error "CH_CFG_USE_MSG_QUEUES not defined in chconf.h"
+#endif
+
 #if !defined(CH_CFG_USE_OBJ_CACHES)
 #error "CH_CFG_USE_OBJ_CACHES not defined in chconf.h"
 #endif
@@ -187,6 +191,7 @@
 #undef CH_CFG_USE_MEMPOOLS
 #undef CH_CFG_USE_OBJ_FIFOS
 #undef CH_CFG_USE_PIPES
+#undef CH_CFG_USE_MSG_QUEUES
 #undef CH_CFG_USE_OBJ_CACHES
 #undef CH_CFG_USE_DELEGATES
 #undef CH_CFG_USE_JOBS
@@ -195,6 +200,7 @@
 #define CH_CFG_USE_MEMPOOLS                 FALSE
 #define CH_CFG_USE_OBJ_FIFOS                FALSE
 #define CH_CFG_USE_PIPES                    FALSE
+#define CH_CFG_USE_MSG_QUEUES               FALSE
 #define CH_CFG_USE_OBJ_CACHES               FALSE
 #define CH_CFG_USE_DELEGATES                FALSE
 #define CH_CFG_USE_JOBS                     FALSE
@@ -239,6 +245,7 @@
 #include "chmempools.h"
 #include "chobjfifos.h"
 #include "chpipes.h"
+#include "chmsgqueues.h"
 #include "chobjcaches.h"
 #include "chdelegates.h"
 #include "chjobs.h"
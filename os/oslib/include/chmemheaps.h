@@ -40,6 +40,8 @@
  */
 #if (SIZEOF_PTR == 4) || defined(__DOXYGEN__)
 #define CH_HEAP_ALIGNMENT   8U
+#elif (SIZEOF_PTR == 8)
+#define CH_HEAP_ALIGNMENT   16U
 #elif (SIZEOF_PTR == 2)
 #define CH_HEAP_ALIGNMENT   4U
 #else
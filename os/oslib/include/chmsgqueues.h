@@ -0,0 +1,249 @@
+/*
+    ChibiOS - Copyright (C) 2006,2007,2008,2009,2010,2011,2012,2013,2014,
+              2015,2016,2017,2018,2019,2020,2021 Giovanni Di Sirio.
+
+    This file is part of ChibiOS.
+
+    ChibiOS is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation version 3 of the License.
+
+    ChibiOS is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+/**
+ * @file    oslib/include/chmsgqueues.h
+ * @brief   Message queues macros and structures.
+ *
+ * @addtogroup oslib_msgqueues
+ * @{
+ */
+
+#ifndef CHMSGQUEUES_H
+#define CHMSGQUEUES_H
+
+#if (CH_CFG_USE_MSG_QUEUES == TRUE) || defined(__DOXYGEN__)
+
+/*===========================================================================*/
+/* Module constants.                                                         */
+/*===========================================================================*/
+
+/*===========================================================================*/
+/* Module pre-compile time settings.                                         */
+/*===========================================================================*/
+
+/*===========================================================================*/
+/* Derived constants and error checks.                                       */
+/*===========================================================================*/
+
+/*===========================================================================*/
+/* Module data structures and types.                                         */
+/*===========================================================================*/
+
+/**
+ * @brief   Type of a message queue waiter.
+ */
+typedef struct ch_mq_waiter mq_waiter_t;
+
+/**
+ * @brief   Structure representing a thread waiting on a message queue.
+ * @note    Waiters are allocated on the stack of the waiting thread, the
+ *          message is copied directly from or to the waiter buffer.
+ */
+struct ch_mq_waiter {
+  mq_waiter_t           *next;          /**< @brief Next waiter in list.    */
+  thread_reference_t    tr;             /**< @brief Waiting thread.         */
+  void                  *buf;           /**< @brief Message buffer.         */
+  size_t                size;           /**< @brief Message size.           */
+};
+
+/**
+ * @brief   Structure representing a message queue object.
+ */
+typedef struct {
+  uint8_t               *buffer;        /**< @brief Pointer to the slots
+                                                    buffer.                 */
+  uint8_t               *top;           /**< @brief Pointer to the location
+                                                    after the buffer.       */
+  uint8_t               *wrptr;         /**< @brief Write pointer.          */
+  uint8_t               *rdptr;         /**< @brief Read pointer.           */
+  size_t                msgsize;        /**< @brief Maximum message size.   */
+  size_t                slotsize;       /**< @brief Size of a slot.         */
+  size_t                size;           /**< @brief Number of slots.        */
+  size_t                cnt;            /**< @brief Messages in queue.      */
+  bool                  reset;          /**< @brief True in reset state.    */
+  mq_waiter_t           *qw;            /**< @brief Waiting writers.        */
+  mq_waiter_t           *qr;            /**< @brief Waiting readers.        */
+} msg_queue_t;
+
+/*===========================================================================*/
+/* Module macros.                                                            */
+/*===========================================================================*/
+
+/**
+ * @brief   Size of a message slot.
+ * @details Each slot contains the message size followed by the message
+ *          body, slots are aligned to @p PORT_NATURAL_ALIGN.
+ *
+ * @param[in] msgsize   maximum message size
+ */
+#define CH_MQ_SLOT_SIZE(msgsize)                                            \
+  MEM_ALIGN_NEXT(sizeof (size_t) + (size_t)(msgsize), PORT_NATURAL_ALIGN)
+
+/**
+ * @brief   Size of a message queue buffer.
+ *
+ * @param[in] msgsize   maximum message size
+ * @param[in] n         number of message slots
+ */
+#define CH_MQ_BUFFER_SIZE(msgsize, n)                                       \
+  (CH_MQ_SLOT_SIZE(msgsize) * (size_t)(n))
+
+/**
+ * @brief   Data part of a static message queue initializer.
+ * @details This macro should be used when statically initializing a
+ *          message queue that is part of a bigger structure.
+ *
+ * @param[in] name      the name of the message queue variable
+ * @param[in] buffer    pointer to the message queue buffer, it must be
+ *                      aligned to @p PORT_NATURAL_ALIGN and have size
+ *                      @p CH_MQ_BUFFER_SIZE(msgsize, n)
+ * @param[in] msgsize   maximum message size
+ * @param[in] n         number of message slots
+ */
+#define __MSG_QUEUE_DATA(name, buffer, msgsize, n) {                        \
+  (uint8_t *)(buffer),                                                      \
+  (uint8_t *)(buffer) + CH_MQ_BUFFER_SIZE(msgsize, n),                      \
+  (uint8_t *)(buffer),                                                      \
+  (uint8_t *)(buffer),                                                      \
+  (size_t)(msgsize),                                                        \
+  CH_MQ_SLOT_SIZE(msgsize),                                                 \
+  (size_t)(n),                                                              \
+  (size_t)0,                                                                \
+  false,                                                                    \
+  NULL,                                                                     \
+  NULL                                                                      \
+}
+
+/**
+ * @brief   Static message queue initializer.
+ * @details Statically initialized message queues require no explicit
+ *          initialization using @p chMQObjectInit().
+ *
+ * @param[in] name      the name of the message queue variable
+ * @param[in] buffer    pointer to the message queue buffer, it must be
+ *                      aligned to @p PORT_NATURAL_ALIGN and have size
+ *                      @p CH_MQ_BUFFER_SIZE(msgsize, n)
+ * @param[in] msgsize   maximum message size
+ * @param[in] n         number of message slots
+ */
+#define MSG_QUEUE_DECL(name, buffer, msgsize, n)                            \
+  msg_queue_t name = __MSG_QUEUE_DATA(name, buffer, msgsize, n)
+
+/*===========================================================================*/
+/* External declarations.                                                    */
+/*===========================================================================*/
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+  void chMQObjectInit(msg_queue_t *mqp, void *buf, size_t msgsize, size_t n);
+  void chMQReset(msg_queue_t *mqp);
+  void chMQResetI(msg_queue_t *mqp);
+  msg_t chMQPostTimeout(msg_queue_t *mqp, const void *p, size_t n,
+                        sysinterval_t timeout);
+  msg_t chMQPostTimeoutS(msg_queue_t *mqp, const void *p, size_t n,
+                         sysinterval_t timeout);
+  msg_t chMQPostI(msg_queue_t *mqp, const void *p, size_t n);
+  msg_t chMQFetchTimeout(msg_queue_t *mqp, void *p, size_t *np,
+                         sysinterval_t timeout);
+  msg_t chMQFetchTimeoutS(msg_queue_t *mqp, void *p, size_t *np,
+                          sysinterval_t timeout);
+  msg_t chMQFetchI(msg_queue_t *mqp, void *p, size_t *np);
+#ifdef __cplusplus
+}
+#endif
+
+/*===========================================================================*/
+/* Module inline functions.                                                  */
+/*===========================================================================*/
+
+/**
+ * @brief   Returns the message queue size as number of messages.
+ *
+ * @param[in] mqp       the pointer to an initialized @p msg_queue_t object
+ * @return              The size of the message queue.
+ *
+ * @iclass
+ */
+static inline size_t chMQGetSizeI(const msg_queue_t *mqp) {
+
+  return mqp->size;
+}
+
+/**
+ * @brief   Returns the maximum size of a message.
+ *
+ * @param[in] mqp       the pointer to an initialized @p msg_queue_t object
+ * @return              The maximum message size.
+ *
+ * @xclass
+ */
+static inline size_t chMQGetMessageSizeX(const msg_queue_t *mqp) {
+
+  return mqp->msgsize;
+}
+
+/**
+ * @brief   Returns the number of used message slots into a message queue.
+ *
+ * @param[in] mqp       the pointer to an initialized @p msg_queue_t object
+ * @return              The number of queued messages.
+ *
+ * @iclass
+ */
+static inline size_t chMQGetUsedCountI(const msg_queue_t *mqp) {
+
+  chDbgCheckClassI();
+
+  return mqp->cnt;
+}
+
+/**
+ * @brief   Returns the number of free message slots into a message queue.
+ *
+ * @param[in] mqp       the pointer to an initialized @p msg_queue_t object
+ * @return              The number of empty message slots.
+ *
+ * @iclass
+ */
+static inline size_t chMQGetFreeCountI(const msg_queue_t *mqp) {
+
+  chDbgCheckClassI();
+
+  return chMQGetSizeI(mqp) - chMQGetUsedCountI(mqp);
+}
+
+/**
+ * @brief   Terminates the reset state.
+ *
+ * @param[in] mqp       the pointer to an initialized @p msg_queue_t object
+ *
+ * @xclass
+ */
+static inline void chMQResumeX(msg_queue_t *mqp) {
+
+  mqp->reset = false;
+}
+
+#endif /* CH_CFG_USE_MSG_QUEUES == TRUE */
+
+#endif /* CHMSGQUEUES_H */
+
+/** @} */
@@ -28,6 +28,9 @@ endif
 ifneq ($(findstring CH_CFG_USE_PIPES TRUE,$(CHLIBCONF)),)
 OSLIBSRC += $(CHIBIOS)/os/oslib/src/chpipes.c
 endif
+ifneq ($(findstring CH_CFG_USE_MSG_QUEUES TRUE,$(CHLIBCONF)),)
+OSLIBSRC += $(CHIBIOS)/os/oslib/src/chmsgqueues.c
+endif
 ifneq ($(findstring CH_CFG_USE_OBJ_CACHES TRUE,$(CHLIBCONF)),)
 OSLIBSRC += $(CHIBIOS)/os/oslib/src/chobjcaches.c
 endif
@@ -44,6 +47,7 @@ OSLIBSRC := $(CHIBIOS)/os/oslib/src/chmemchecks.c \
             $(CHIBIOS)/os/oslib/src/chmemheaps.c \
             $(CHIBIOS)/os/oslib/src/chmempools.c \
             $(CHIBIOS)/os/oslib/src/chpipes.c \
+            $(CHIBIOS)/os/oslib/src/chmsgqueues.c \
             $(CHIBIOS)/os/oslib/src/chobjcaches.c \
             $(CHIBIOS)/os/oslib/src/chdelegates.c \
             $(CHIBIOS)/os/oslib/src/chfactory.c
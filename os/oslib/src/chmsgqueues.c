@@ -0,0 +1,516 @@
+/*
+    ChibiOS - Copyright (C) 2006,2007,2008,2009,2010,2011,2012,2013,2014,
+              2015,2016,2017,2018,2019,2020,2021 Giovanni Di Sirio.
+
+    This file is part of ChibiOS.
+
+    ChibiOS is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation version 3 of the License.
+
+    ChibiOS is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+/**
+ * @file    oslib/src/chmsgqueues.c
+ * @brief   Message queues code.
+ *
+ * @addtogroup oslib_msgqueues
+ * @details Asynchronous messages queues.
+ *          <h2>Operation mode</h2>
+ *          A message queue is a ring of fixed size slots, messages of any
+ *          size up to the slot size are copied into and out of the queue.
+ *          Operations defined for message queues:
+ *          - <b>Post</b>: Copies a message into the queue in FIFO order.
+ *          - <b>Fetch</b>: Copies a message out of the queue and removes
+ *            it.
+ *          - <b>Reset</b>: The queue is emptied and all the stored
+ *            messages are lost.
+ *          .
+ *          Each operation is performed within a single critical zone,
+ *          copy included. If a reader is waiting on an empty queue then
+ *          a posted message is copied directly into the reader buffer,
+ *          if a writer is waiting on a full queue then its message is
+ *          moved into the slot freed by a fetch.<br>
+ *          Because copies are performed inside the critical zone this
+ *          mechanism is meant for small messages, large messages should
+ *          be exchanged by reference using mailboxes or objects FIFOs.
+ * @pre     In order to use the message queues APIs the
+ *          @p CH_CFG_USE_MSG_QUEUES option must be enabled in
+ *          @p chconf.h.
+ * @note    Compatible with RT and NIL.
+ * @{
+ */
+
+#include <string.h>
+
+#include "ch.h"
+
+#if (CH_CFG_USE_MSG_QUEUES == TRUE) || defined(__DOXYGEN__)
+
+/*===========================================================================*/
+/* Module exported variables.                                                */
+/*===========================================================================*/
+
+/*===========================================================================*/
+/* Module local types.                                                       */
+/*===========================================================================*/
+
+/*===========================================================================*/
+/* Module local variables.                                                   */
+/*===========================================================================*/
+
+/*===========================================================================*/
+/* Module local functions.                                                   */
+/*===========================================================================*/
+
+/**
+ * @brief   Appends a waiter to a waiters list.
+ *
+ * @param[in] wlp       pointer to the list head
+ * @param[in] wp        pointer to the waiter
+ */
+static void mq_waiter_insert(mq_waiter_t **wlp, mq_waiter_t *wp) {
+
+  while (*wlp != NULL) {
+    wlp = &(*wlp)->next;
+  }
+  wp->next = NULL;
+  wp->tr   = NULL;
+  *wlp     = wp;
+}
+
+/**
+ * @brief   Removes a waiter from a waiters list.
+ * @note    The waiter could have already been removed.
+ *
+ * @param[in] wlp       pointer to the list head
+ * @param[in] wp        pointer to the waiter
+ */
+static void mq_waiter_remove(mq_waiter_t **wlp, mq_waiter_t *wp) {
+
+  while (*wlp != NULL) {
+    if (*wlp == wp) {
+      *wlp = wp->next;
+      return;
+    }
+    wlp = &(*wlp)->next;
+  }
+}
+
+/**
+ * @brief   Resumes all waiters in a waiters list.
+ *
+ * @param[in] wlp       pointer to the list head
+ * @param[in] msg       the wakeup message
+ */
+static void mq_waiter_resume_all(mq_waiter_t **wlp, msg_t msg) {
+
+  while (*wlp != NULL) {
+    mq_waiter_t *wp = *wlp;
+
+    *wlp = wp->next;
+    chThdResumeI(&wp->tr, msg);
+  }
+}
+
+/**
+ * @brief   Copies a message into the slot at the write pointer.
+ *
+ * @param[in] mqp       the pointer to an initialized @p msg_queue_t object
+ * @param[in] p         pointer to the message body
+ * @param[in] n         message size
+ */
+static void mq_write_slot(msg_queue_t *mqp, const void *p, size_t n) {
+
+  *(size_t *)(void *)mqp->wrptr = n;
+  memcpy((void *)(mqp->wrptr + sizeof (size_t)), p, n);
+  mqp->wrptr += mqp->slotsize;
+  if (mqp->wrptr >= mqp->top) {
+    mqp->wrptr = mqp->buffer;
+  }
+  mqp->cnt++;
+}
+
+/**
+ * @brief   Copies a message out of the slot at the read pointer.
+ *
+ * @param[in] mqp       the pointer to an initialized @p msg_queue_t object
+ * @param[out] p        pointer to the message buffer
+ * @return              The message size.
+ */
+static size_t mq_read_slot(msg_queue_t *mqp, void *p) {
+  size_t n;
+
+  n = *(const size_t *)(const void *)mqp->rdptr;
+  memcpy(p, (const void *)(mqp->rdptr + sizeof (size_t)), n);
+  mqp->rdptr += mqp->slotsize;
+  if (mqp->rdptr >= mqp->top) {
+    mqp->rdptr = mqp->buffer;
+  }
+  mqp->cnt--;
+
+  return n;
+}
+
+/*===========================================================================*/
+/* Module exported functions.                                                */
+/*===========================================================================*/
+
+/**
+ * @brief   Initializes a @p msg_queue_t object.
+ *
+ * @param[out] mqp      the pointer to the @p msg_queue_t structure to be
+ *                      initialized
+ * @param[in] buf       pointer to the slots buffer, it must be aligned to
+ *                      @p PORT_NATURAL_ALIGN and have size
+ *                      @p CH_MQ_BUFFER_SIZE(msgsize, n)
+ * @param[in] msgsize   maximum message size
+ * @param[in] n         number of message slots
+ *
+ * @init
+ */
+void chMQObjectInit(msg_queue_t *mqp, void *buf, size_t msgsize, size_t n) {
+
+  chDbgCheck((mqp != NULL) && (buf != NULL) &&
+             MEM_IS_ALIGNED(buf, PORT_NATURAL_ALIGN) &&
+             (msgsize > (size_t)0) && (n > (size_t)0));
+
+  mqp->buffer   = (uint8_t *)buf;
+  mqp->rdptr    = (uint8_t *)buf;
+  mqp->wrptr    = (uint8_t *)buf;
+  mqp->top      = (uint8_t *)buf + CH_MQ_BUFFER_SIZE(msgsize, n);
+  mqp->msgsize  = msgsize;
+  mqp->slotsize = CH_MQ_SLOT_SIZE(msgsize);
+  mqp->size     = n;
+  mqp->cnt      = (size_t)0;
+  mqp->reset    = false;
+  mqp->qw       = NULL;
+  mqp->qr       = NULL;
+}
+
+/**
+ * @brief   Resets a @p msg_queue_t object.
+ * @details All the waiting threads are resumed with status @p MSG_RESET and
+ *          the queued messages are lost.
+ * @post    The message queue is in reset state, all operations will fail
+ *          and return @p MSG_RESET until the queue is enabled again using
+ *          @p chMQResumeX().
+ *
+ * @param[in] mqp       the pointer to an initialized @p msg_queue_t object
+ *
+ * @api
+ */
+void chMQReset(msg_queue_t *mqp) {
+
+  chSysLock();
+  chMQResetI(mqp);
+  chSchRescheduleS();
+  chSysUnlock();
+}
+
+/**
+ * @brief   Resets a @p msg_queue_t object.
+ * @details All the waiting threads are resumed with status @p MSG_RESET and
+ *          the queued messages are lost.
+ * @post    The message queue is in reset state, all operations will fail
+ *          and return @p MSG_RESET until the queue is enabled again using
+ *          @p chMQResumeX().
+ *
+ * @param[in] mqp       the pointer to an initialized @p msg_queue_t object
+ *
+ * @iclass
+ */
+void chMQResetI(msg_queue_t *mqp) {
+
+  chDbgCheckClassI();
+  chDbgCheck(mqp != NULL);
+
+  mqp->wrptr = mqp->buffer;
+  mqp->rdptr = mqp->buffer;
+  mqp->cnt   = (size_t)0;
+  mqp->reset = true;
+  mq_waiter_resume_all(&mqp->qw, MSG_RESET);
+  mq_waiter_resume_all(&mqp->qr, MSG_RESET);
+}
+
+/**
+ * @brief   Posts a message into a message queue.
+ * @details The invoking thread waits until a empty slot in the message
+ *          queue becomes available or the specified time runs out.
+ *
+ * @param[in] mqp       the pointer to an initialized @p msg_queue_t object
+ * @param[in] p         pointer to the message body
+ * @param[in] n         size of the message, it must not exceed the
+ *                      maximum message size of the queue
+ * @param[in] timeout   the number of ticks before the operation timeouts,
+ *                      the following special values are allowed:
+ *                      - @a TIME_IMMEDIATE immediate timeout.
+ *                      - @a TIME_INFINITE no timeout.
+ *                      .
+ * @return              The operation status.
+ * @retval MSG_OK       if a message has been correctly posted.
+ * @retval MSG_RESET    if the message queue has been reset.
+ * @retval MSG_TIMEOUT  if the operation has timed out.
+ *
+ * @api
+ */
+msg_t chMQPostTimeout(msg_queue_t *mqp, const void *p, size_t n,
+                      sysinterval_t timeout) {
+  msg_t rdymsg;
+
+  chSysLock();
+  rdymsg = chMQPostTimeoutS(mqp, p, n, timeout);
+  chSysUnlock();
+
+  return rdymsg;
+}
+
+/**
+ * @brief   Posts a message into a message queue.
+ * @details The invoking thread waits until a empty slot in the message
+ *          queue becomes available or the specified time runs out.
+ *
+ * @param[in] mqp       the pointer to an initialized @p msg_queue_t object
+ * @param[in] p         pointer to the message body
+ * @param[in] n         size of the message, it must not exceed the
+ *                      maximum message size of the queue
+ * @param[in] timeout   the number of ticks before the operation timeouts,
+ *                      the following special values are allowed:
+ *                      - @a TIME_IMMEDIATE immediate timeout.
+ *                      - @a TIME_INFINITE no timeout.
+ *                      .
+ * @return              The operation status.
+ * @retval MSG_OK       if a message has been correctly posted.
+ * @retval MSG_RESET    if the message queue has been reset.
+ * @retval MSG_TIMEOUT  if the operation has timed out.
+ *
+ * @sclass
+ */
+msg_t chMQPostTimeoutS(msg_queue_t *mqp, const void *p, size_t n,
+                       sysinterval_t timeout) {
+  mq_waiter_t w;
+  msg_t rdymsg;
+
+  chDbgCheckClassS();
+
+  rdymsg = chMQPostI(mqp, p, n);
+  if (rdymsg == MSG_OK) {
+    /* A reader could have been made ready.*/
+    chSchRescheduleS();
+    return MSG_OK;
+  }
+  if ((rdymsg == MSG_RESET) || (timeout == TIME_IMMEDIATE)) {
+    return rdymsg;
+  }
+
+  /* No space in the queue, waiting for a reader to move the message into
+     a freed slot.*/
+  w.buf  = (void *)p;
+  w.size = n;
+  mq_waiter_insert(&mqp->qw, &w);
+  rdymsg = chThdSuspendTimeoutS(&w.tr, timeout);
+  if (rdymsg == MSG_TIMEOUT) {
+    mq_waiter_remove(&mqp->qw, &w);
+  }
+
+  return rdymsg;
+}
+
+/**
+ * @brief   Posts a message into a message queue.
+ * @details This variant is non-blocking, the function returns a timeout
+ *          condition if the queue is full.
+ *
+ * @param[in] mqp       the pointer to an initialized @p msg_queue_t object
+ * @param[in] p         pointer to the message body
+ * @param[in] n         size of the message, it must not exceed the
+ *                      maximum message size of the queue
+ * @return              The operation status.
+ * @retval MSG_OK       if a message has been correctly posted.
+ * @retval MSG_RESET    if the message queue has been reset.
+ * @retval MSG_TIMEOUT  if the message queue is full and the message cannot
+ *                      be posted.
+ *
+ * @iclass
+ */
+msg_t chMQPostI(msg_queue_t *mqp, const void *p, size_t n) {
+  mq_waiter_t *wp;
+
+  chDbgCheckClassI();
+  chDbgCheck((mqp != NULL) && (p != NULL) && (n <= mqp->msgsize));
+
+  /* If the message queue is in reset state then returns immediately.*/
+  if (mqp->reset) {
+    return MSG_RESET;
+  }
+
+  /* If there is a reader waiting then the message is handed off directly,
+     the queue is empty in this case.*/
+  wp = mqp->qr;
+  if (wp != NULL) {
+    mqp->qr = wp->next;
+    memcpy(wp->buf, p, n);
+    wp->size = n;
+    chThdResumeI(&wp->tr, MSG_OK);
+
+    return MSG_OK;
+  }
+
+  /* Is there a free message slot in queue? if so then post.*/
+  if (chMQGetFreeCountI(mqp) > (size_t)0) {
+    mq_write_slot(mqp, p, n);
+
+    return MSG_OK;
+  }
+
+  /* No space in the queue.*/
+  return MSG_TIMEOUT;
+}
+
+/**
+ * @brief   Retrieves a message from a message queue.
+ * @details The invoking thread waits until a message is posted in the
+ *          message queue or the specified time runs out.
+ *
+ * @param[in] mqp       the pointer to an initialized @p msg_queue_t object
+ * @param[out] p        pointer to the message buffer, it must be large
+ *                      enough for the maximum message size of the queue
+ * @param[out] np       pointer to a variable for the received message size
+ * @param[in] timeout   the number of ticks before the operation timeouts,
+ *                      the following special values are allowed:
+ *                      - @a TIME_IMMEDIATE immediate timeout.
+ *                      - @a TIME_INFINITE no timeout.
+ *                      .
+ * @return              The operation status.
+ * @retval MSG_OK       if a message has been correctly fetched.
+ * @retval MSG_RESET    if the message queue has been reset.
+ * @retval MSG_TIMEOUT  if the operation has timed out.
+ *
+ * @api
+ */
+msg_t chMQFetchTimeout(msg_queue_t *mqp, void *p, size_t *np,
+                       sysinterval_t timeout) {
+  msg_t rdymsg;
+
+  chSysLock();
+  rdymsg = chMQFetchTimeoutS(mqp, p, np, timeout);
+  chSysUnlock();
+
+  return rdymsg;
+}
+
+/**
+ * @brief   Retrieves a message from a message queue.
+ * @details The invoking thread waits until a message is posted in the
+ *          message queue or the specified time runs out.
+ *
+ * @param[in] mqp       the pointer to an initialized @p msg_queue_t object
+ * @param[out] p        pointer to the message buffer, it must be large
+ *                      enough for the maximum message size of the queue
+ * @param[out] np       pointer to a variable for the received message size
+ * @param[in] timeout   the number of ticks before the operation timeouts,
+ *                      the following special values are allowed:
+ *                      - @a TIME_IMMEDIATE immediate timeout.
+ *                      - @a TIME_INFINITE no timeout.
+ *                      .
+ * @return              The operation status.
+ * @retval MSG_OK       if a message has been correctly fetched.
+ * @retval MSG_RESET    if the message queue has been reset.
+ * @retval MSG_TIMEOUT  if the operation has timed out.
+ *
+ * @sclass
+ */
+msg_t chMQFetchTimeoutS(msg_queue_t *mqp, void *p, size_t *np,
+                        sysinterval_t timeout) {
+  mq_waiter_t w;
+  msg_t rdymsg;
+
+  chDbgCheckClassS();
+
+  rdymsg = chMQFetchI(mqp, p, np);
+  if (rdymsg == MSG_OK) {
+    /* A writer could have been made ready.*/
+    chSchRescheduleS();
+    return MSG_OK;
+  }
+  if ((rdymsg == MSG_RESET) || (timeout == TIME_IMMEDIATE)) {
+    return rdymsg;
+  }
+
+  /* Empty queue, waiting for a writer to copy a message directly into
+     the buffer.*/
+  w.buf  = p;
+  w.size = (size_t)0;
+  mq_waiter_insert(&mqp->qr, &w);
+  rdymsg = chThdSuspendTimeoutS(&w.tr, timeout);
+  if (rdymsg == MSG_OK) {
+    *np = w.size;
+  }
+  else if (rdymsg == MSG_TIMEOUT) {
+    mq_waiter_remove(&mqp->qr, &w);
+  }
+  else {
+    /* Reset, already removed.*/
+  }
+
+  return rdymsg;
+}
+
+/**
+ * @brief   Retrieves a message from a message queue.
+ * @details This variant is non-blocking, the function returns a timeout
+ *          condition if the queue is empty.
+ *
+ * @param[in] mqp       the pointer to an initialized @p msg_queue_t object
+ * @param[out] p        pointer to the message buffer, it must be large
+ *                      enough for the maximum message size of the queue
+ * @param[out] np       pointer to a variable for the received message size
+ * @return              The operation status.
+ * @retval MSG_OK       if a message has been correctly fetched.
+ * @retval MSG_RESET    if the message queue has been reset.
+ * @retval MSG_TIMEOUT  if the message queue is empty and a message cannot
+ *                      be fetched.
+ *
+ * @iclass
+ */
+msg_t chMQFetchI(msg_queue_t *mqp, void *p, size_t *np) {
+  mq_waiter_t *wp;
+
+  chDbgCheckClassI();
+  chDbgCheck((mqp != NULL) && (p != NULL) && (np != NULL));
+
+  /* If the message queue is in reset state then returns immediately.*/
+  if (mqp->reset) {
+    return MSG_RESET;
+  }
+
+  /* Is there a message in queue? if so then fetch.*/
+  if (chMQGetUsedCountI(mqp) > (size_t)0) {
+    *np = mq_read_slot(mqp, p);
+
+    /* If there is a writer waiting then its message is moved into the
+       freed slot, the queue was full in this case.*/
+    wp = mqp->qw;
+    if (wp != NULL) {
+      mqp->qw = wp->next;
+      mq_write_slot(mqp, wp->buf, wp->size);
+      chThdResumeI(&wp->tr, MSG_OK);
+    }
+
+    return MSG_OK;
+  }
+
+  /* No message in the queue.*/
+  return MSG_TIMEOUT;
+}
+
+#endif /* CH_CFG_USE_MSG_QUEUES == TRUE */
+
+/** @} */
@@ -0,0 +1,192 @@
+/*
+    ChibiOS - Copyright (C) 2006..2022 Giovanni Di Sirio
+
+    Licensed under the Apache License, Version 2.0 (the "License");
+    you may not use this file except in compliance with the License.
+    You may obtain a copy of the License at
+
+        http://www.apache.org/licenses/LICENSE-2.0
+
+    Unless required by applicable law or agreed to in writing, software
+    distributed under the License is distributed on an "AS IS" BASIS,
+    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+    See the License for the specific language governing permissions and
+    limitations under the License.
+*/
+
+#include <stdbool.h>
+#include <string.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <fcntl.h>
+
+#include "sbuser.h"
+
+#define NEWLINE_STR         "\r\n"
+
+/* Test file layout, each block is filled with its own index.*/
+#define BLOCK_SIZE          64U
+#define BLOCKS_NUM          64U
+
+/* Size of each small read and number of seek+read pairs per run.*/
+#define READ_SIZE           16U
+#define PAIRS_NUM           4096U
+
+/* Ring entries, each seek+read pair takes two entries.*/
+#define RING_ENTRIES        32U
+
+static uint32_t ring_buffer[SB_RING_BUFFER_SIZE(RING_ENTRIES) /
+                            sizeof (uint32_t)];
+static uint8_t block_buffer[BLOCK_SIZE];
+static uint8_t read_buffers[RING_ENTRIES / 2U][READ_SIZE];
+
+static void usage(void) {
+  fprintf(stderr, "Usage: ringbench [<file>]" NEWLINE_STR);
+}
+
+static void error(const char *s) {
+
+  fprintf(stderr, "ringbench: %s" NEWLINE_STR, s);
+  exit(1);
+}
+
+static bool check(const uint8_t *p, uint32_t pair) {
+  unsigned i;
+
+  for (i = 0U; i < READ_SIZE; i++) {
+    if (p[i] != (uint8_t)(pair % BLOCKS_NUM)) {
+      return true;
+    }
+  }
+
+  return false;
+}
+
+static void report(const char *name, sysinterval_t interval, int syscalls) {
+  uint32_t ops = PAIRS_NUM * 2U;
+
+  if (interval == (sysinterval_t)0) {
+    interval = (sysinterval_t)1;
+  }
+
+  printf("%-5s: %8lu ops/s, %5d syscalls" NEWLINE_STR, name,
+         (unsigned long)(((uint64_t)ops * sbGetFrequency()) / interval),
+         syscalls);
+}
+
+static void prepare(int fd) {
+  unsigned i;
+
+  for (i = 0U; i < BLOCKS_NUM; i++) {
+    memset(block_buffer, (int)i, BLOCK_SIZE);
+    if (sbWrite(fd, block_buffer, BLOCK_SIZE) != (ssize_t)BLOCK_SIZE) {
+      error("write failed");
+    }
+  }
+}
+
+static void bench_trap(int fd) {
+  systime_t start;
+  uint32_t pair;
+
+  start = sbGetSystemTime();
+  for (pair = 0U; pair < PAIRS_NUM; pair++) {
+    off_t offset = (off_t)((pair % BLOCKS_NUM) * BLOCK_SIZE);
+
+    if ((sbSeek(fd, offset, SEEK_SET) != offset) ||
+        (sbRead(fd, read_buffers[0], READ_SIZE) != (ssize_t)READ_SIZE) ||
+        check(read_buffers[0], pair)) {
+      error("trap path failed");
+    }
+  }
+  report("trap", sbTimeDiffX(start, sbGetSystemTime()), (int)PAIRS_NUM * 2);
+}
+
+static void bench_ring(int fd) {
+  sb_ring_t *rp = (sb_ring_t *)ring_buffer;
+  sb_ring_cqe_t cqe;
+  systime_t start;
+  uint32_t pair, batch, i;
+  int syscalls;
+
+  sbRingObjectInit(rp, RING_ENTRIES);
+  if (sbRingSetup(rp) < 0) {
+    error("Posix ring not supported by the host");
+  }
+
+  syscalls = 0;
+  start = sbGetSystemTime();
+  for (pair = 0U; pair < PAIRS_NUM; pair += batch) {
+    batch = RING_ENTRIES / 2U;
+    if (batch > PAIRS_NUM - pair) {
+      batch = PAIRS_NUM - pair;
+    }
+
+    /* Queuing a batch of seek+read pairs, tags are the entry index.*/
+    for (i = 0U; i < batch; i++) {
+      (void)sbRingSubmit(rp, SB_POSIX_LSEEK, fd,
+                         ((pair + i) % BLOCKS_NUM) * BLOCK_SIZE,
+                         SEEK_SET, i * 2U);
+      (void)sbRingSubmit(rp, SB_POSIX_READ, fd,
+                         (uint32_t)read_buffers[i], READ_SIZE,
+                         (i * 2U) + 1U);
+    }
+
+    /* Single doorbell for the whole batch.*/
+    if (sbRingEnter() != (int)(batch * 2U)) {
+      error("ring enter failed");
+    }
+    syscalls++;
+
+    /* Reaping completions.*/
+    while (!sbRingComplete(rp, &cqe)) {
+      if ((cqe.tag & 1U) == 0U) {
+        if (cqe.result != (int32_t)((((pair + (cqe.tag / 2U)) % BLOCKS_NUM) *
+                                     BLOCK_SIZE))) {
+          error("ring seek failed");
+        }
+      }
+      else {
+        if ((cqe.result != (int32_t)READ_SIZE) ||
+            check(read_buffers[cqe.tag / 2U], pair + (cqe.tag / 2U))) {
+          error("ring read failed");
+        }
+      }
+    }
+  }
+  report("ring", sbTimeDiffX(start, sbGetSystemTime()), syscalls);
+
+  (void)sbRingSetup(NULL);
+}
+
+int main(int argc, char *argv[], char *envp[]) {
+  const char *fname = "ringbench.dat";
+  int fd;
+
+  (void)envp;
+
+  if (argc > 2) {
+    usage();
+    return 1;
+  }
+  if (argc == 2) {
+    fname = argv[1];
+  }
+
+  fd = sbOpen(fname, O_RDWR | O_CREAT);
+  if (fd < 0) {
+    error("cannot create the test file");
+  }
+
+  printf("Posix ring benchmark, %u seek+read pairs of %u bytes" NEWLINE_STR,
+         (unsigned)PAIRS_NUM, (unsigned)READ_SIZE);
+
+  prepare(fd);
+  bench_trap(fd);
+  bench_ring(fd);
+
+  (void)sbClose(fd);
+  (void)sbUnlink(fname);
+
+  return 0;
+}
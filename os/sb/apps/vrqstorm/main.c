@@ -0,0 +1,136 @@
+/*
+    ChibiOS - Copyright (C) 2006..2022 Giovanni Di Sirio
+
+    Licensed under the Apache License, Version 2.0 (the "License");
+    you may not use this file except in compliance with the License.
+    You may obtain a copy of the License at
+
+        http://www.apache.org/licenses/LICENSE-2.0
+
+    Unless required by applicable law or agreed to in writing, software
+    distributed under the License is distributed on an "AS IS" BASIS,
+    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+    See the License for the specific language governing permissions and
+    limitations under the License.
+*/
+
+/*
+ * VRQ storm, modeled on the IRQ_STORM test.
+ *
+ * A periodic alarm keeps VRQ 0 firing while the storm VRQs are triggered
+ * in bursts, each burst raises all of them twice with VRQs disabled so
+ * the second round is coalesced by the host. Each storm handler must be
+ * invoked exactly once per burst. With SB_CFG_ENABLE_VRQ_BATCHING the
+ * whole burst is served within a single VRQ context, the host statistics
+ * report delivered VRQs against the contexts pushed.
+ */
+
+#include <stdbool.h>
+#include <stdio.h>
+
+#include "sbuser.h"
+
+#define NEWLINE_STR         "\r\n"
+
+/* VRQ used by the host for alarms, SB_CFG_ALARM_VRQ in the host sbconf.h.*/
+#define ALARM_VRQ           0U
+
+/* Storm VRQs, VRQ 8 is left to the UART VIO of the host demos.*/
+#define STORM_FIRST_VRQ     1U
+#define STORM_VRQS_NUM      7U
+#define STORM_MASK          (((1U << STORM_VRQS_NUM) - 1U) << STORM_FIRST_VRQ)
+
+/* Bursts performed by each run and number of runs.*/
+#define BURSTS_NUM          10000U
+#define RUNS_NUM            4U
+
+static volatile uint32_t alarms;
+static volatile uint32_t served[STORM_VRQS_NUM];
+
+void __sb_vector0(void) {
+
+  alarms++;
+}
+
+#define STORM_HANDLER(n)                                                    \
+void __sb_vector##n(void) {                                                 \
+                                                                            \
+  served[(n) - STORM_FIRST_VRQ]++;                                          \
+}
+
+STORM_HANDLER(1)
+STORM_HANDLER(2)
+STORM_HANDLER(3)
+STORM_HANDLER(4)
+STORM_HANDLER(5)
+STORM_HANDLER(6)
+STORM_HANDLER(7)
+
+static bool run(unsigned n) {
+  systime_t start;
+  sysinterval_t interval;
+  uint32_t burst, a;
+  unsigned i;
+
+  for (i = 0U; i < STORM_VRQS_NUM; i++) {
+    served[i] = 0U;
+  }
+
+  a = alarms;
+  start = sbGetSystemTime();
+  for (burst = 0U; burst < BURSTS_NUM; burst++) {
+    __sb_vrq_disable();
+    (void)__sb_vrq_setwt(STORM_MASK);
+    (void)__sb_vrq_setwt(STORM_MASK);
+    __sb_vrq_enable();
+  }
+  interval = sbTimeDiffX(start, sbGetSystemTime());
+  a = alarms - a;
+
+  for (i = 0U; i < STORM_VRQS_NUM; i++) {
+    if (served[i] != BURSTS_NUM) {
+      printf("Run %u: VRQ %u served %lu times, expected %lu" NEWLINE_STR,
+             n, i + STORM_FIRST_VRQ, (unsigned long)served[i],
+             (unsigned long)BURSTS_NUM);
+      return true;
+    }
+  }
+
+  if (interval == (sysinterval_t)0) {
+    interval = (sysinterval_t)1;
+  }
+
+  printf("Run %u: %8lu VRQs/s, %lu alarms in %lu ticks" NEWLINE_STR, n,
+         (unsigned long)(((uint64_t)BURSTS_NUM * STORM_VRQS_NUM *
+                          sbGetFrequency()) / interval),
+         (unsigned long)a, (unsigned long)interval);
+
+  return false;
+}
+
+int main(int argc, char *argv[], char *envp[]) {
+  unsigned n;
+  bool failed = false;
+
+  (void)argc;
+  (void)argv;
+  (void)envp;
+
+  printf("VRQ storm, %u VRQs raised twice per burst, %u bursts per run"
+         NEWLINE_STR, (unsigned)STORM_VRQS_NUM, (unsigned)BURSTS_NUM);
+
+  /* Enabling the alarm and storm VRQs, the alarm fires on each tick.*/
+  (void)__sb_vrq_seten((1U << ALARM_VRQ) | STORM_MASK);
+  sbSetAlarm((sysinterval_t)1, true);
+
+  for (n = 1U; !failed && (n <= RUNS_NUM); n++) {
+    failed = run(n);
+  }
+
+  sbResetAlarm();
+  (void)__sb_vrq_clren((1U << ALARM_VRQ) | STORM_MASK);
+
+  printf("Storm test: %s" NEWLINE_STR, failed ? "FAILED" : "OK");
+
+  return failed ? 1 : 0;
+}
@@ -91,8 +91,22 @@
 #define SB_POSIX_MKDIR          14
 #define SB_POSIX_RMDIR          15
 #define SB_POSIX_STAT           16
+#define SB_POSIX_RINGSETUP      17
+#define SB_POSIX_RINGENTER      18
+#define SB_POSIX_READV          19
+#define SB_POSIX_WRITEV         20
 /** @} */
 
+/**
+ * @brief   Maximum number of segments in a Posix scatter-gather operation.
+ */
+#define SB_POSIX_IOV_MAX        16U
+
+/**
+ * @brief   Maximum number of entries in a Posix ring.
+ */
+#define SB_RING_MAX_SIZE        256U
+
 /**
  * @name    Virtual GPIO syscall sub-codes
  * @{
@@ -150,10 +164,126 @@
 /* Module data structures and types.                                         */
 /*===========================================================================*/
 
+/**
+ * @brief   Type of a Posix scatter-gather segment.
+ * @note    It has the same layout of the Posix @p iovec structure.
+ */
+typedef struct {
+  /**
+   * @brief   Segment address in sandbox memory.
+   */
+  void                          *base;
+  /**
+   * @brief   Segment size in bytes.
+   */
+  size_t                        len;
+} sb_iovec_t;
+
+/**
+ * @brief   Type of a Posix ring submission entry.
+ * @note    Supported operations are @p SB_POSIX_READ, @p SB_POSIX_WRITE,
+ *          @p SB_POSIX_READV, @p SB_POSIX_WRITEV and @p SB_POSIX_LSEEK,
+ *          parameters have the same meaning they have in the equivalent
+ *          syscall.
+ */
+typedef struct {
+  /**
+   * @brief   Operation code, one of the Posix syscall sub-codes.
+   */
+  uint32_t                      opcode;
+  /**
+   * @brief   File descriptor.
+   */
+  int32_t                       fd;
+  /**
+   * @brief   Buffer pointer, segments array pointer or file offset.
+   */
+  uint32_t                      arg1;
+  /**
+   * @brief   Number of bytes, number of segments or seek mode.
+   */
+  uint32_t                      arg2;
+  /**
+   * @brief   Opaque tag copied in the completion entry.
+   */
+  uint32_t                      tag;
+} sb_ring_sqe_t;
+
+/**
+ * @brief   Type of a Posix ring completion entry.
+ */
+typedef struct {
+  /**
+   * @brief   Tag of the completed submission entry.
+   */
+  uint32_t                      tag;
+  /**
+   * @brief   Operation result, same encoding of the equivalent syscall.
+   */
+  int32_t                       result;
+} sb_ring_cqe_t;
+
+/**
+ * @brief   Type of a Posix ring header.
+ * @details The ring is allocated in sandbox memory, the header is followed
+ *          by @p size submission entries and by @p size completion entries.
+ *          Indexes are free-running counters, the sandbox writes
+ *          @p sq_tail and @p cq_head, the host writes @p sq_head and
+ *          @p cq_tail.
+ */
+typedef struct {
+  /**
+   * @brief   Submission queue head, next entry to be consumed by the host.
+   */
+  volatile uint32_t             sq_head;
+  /**
+   * @brief   Submission queue tail, next entry to be filled by the sandbox.
+   */
+  volatile uint32_t             sq_tail;
+  /**
+   * @brief   Completion queue head, next entry to be consumed by the sandbox.
+   */
+  volatile uint32_t             cq_head;
+  /**
+   * @brief   Completion queue tail, next entry to be filled by the host.
+   */
+  volatile uint32_t             cq_tail;
+  /**
+   * @brief   Number of entries, it must be a power of two.
+   */
+  uint32_t                      size;
+} sb_ring_t;
+
 /*===========================================================================*/
 /* Module macros.                                                            */
 /*===========================================================================*/
 
+/**
+ * @brief   Size of a Posix ring buffer.
+ *
+ * @param[in] n         number of entries
+ */
+#define SB_RING_BUFFER_SIZE(n)                                              \
+  (sizeof (sb_ring_t) +                                                     \
+   ((size_t)(n) * (sizeof (sb_ring_sqe_t) + sizeof (sb_ring_cqe_t))))
+
+/**
+ * @brief   Pointer to the submission entries of a Posix ring.
+ *
+ * @param[in] rp        pointer to the ring header
+ */
+#define SB_RING_SQES(rp)                                                    \
+  ((sb_ring_sqe_t *)(void *)((uint8_t *)(rp) + sizeof (sb_ring_t)))
+
+/**
+ * @brief   Pointer to the completion entries of a Posix ring.
+ *
+ * @param[in] rp        pointer to the ring header
+ * @param[in] n         number of entries
+ */
+#define SB_RING_CQES(rp, n)                                                 \
+  ((sb_ring_cqe_t *)(void *)(SB_RING_SQES(rp) + (n)))
+
 /*===========================================================================*/
 /* External declarations.                                                    */
 /*===========================================================================*/
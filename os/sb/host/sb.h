@@ -79,6 +79,37 @@
 /* Module pre-compile time settings.                                         */
 /*===========================================================================*/
 
+/**
+ * @brief   Enables the Posix submission/completion ring.
+ * @details The ring allows a sandbox to queue multiple read, write and
+ *          seek operations in its own memory and submit all of them using
+ *          a single syscall.
+ */
+#if !defined(SB_CFG_ENABLE_POSIX_RING) || defined(__DOXYGEN__)
+#define SB_CFG_ENABLE_POSIX_RING            FALSE
+#endif
+
+/**
+ * @brief   Enables batched VRQs delivery.
+ * @details All the pending and enabled VRQs are taken at once and served
+ *          by the sandbox within a single return context, the context is
+ *          not rebuilt after each VRQ handler.
+ * @note    Sandboxes must be built with a runtime serving the VRQs mask
+ *          passed in R1 on VRQ entry.
+ */
+#if !defined(SB_CFG_ENABLE_VRQ_BATCHING) || defined(__DOXYGEN__)
+#define SB_CFG_ENABLE_VRQ_BATCHING          FALSE
+#endif
+
+/**
+ * @brief   Enables VRQs statistics.
+ * @details Per-VRQ counters of triggered and coalesced events are kept
+ *          together with counters of delivered VRQs and return contexts.
+ */
+#if !defined(SB_CFG_ENABLE_VRQ_STATS) || defined(__DOXYGEN__)
+#define SB_CFG_ENABLE_VRQ_STATS             FALSE
+#endif
+
 /*===========================================================================*/
 /* Derived constants and error checks.                                       */
 /*===========================================================================*/
@@ -116,6 +147,18 @@
 #error "SB_CFG_FD_NUM not defined in sbconf.h"
 #endif
 
+#if (SB_CFG_ENABLE_POSIX_RING == TRUE) && (SB_CFG_ENABLE_VFS == FALSE)
+#error "SB_CFG_ENABLE_POSIX_RING requires SB_CFG_ENABLE_VFS"
+#endif
+
+#if (SB_CFG_ENABLE_VRQ_BATCHING == TRUE) && (SB_CFG_ENABLE_VRQ == FALSE)
+#error "SB_CFG_ENABLE_VRQ_BATCHING requires SB_CFG_ENABLE_VRQ"
+#endif
+
+#if (SB_CFG_ENABLE_VRQ_STATS == TRUE) && (SB_CFG_ENABLE_VRQ == FALSE)
+#error "SB_CFG_ENABLE_VRQ_STATS requires SB_CFG_ENABLE_VRQ"
+#endif
+
 /* License checks.*/
 #if !defined(CH_CUSTOMER_LIC_SB) || !defined(CH_LICENSE_FEATURES)
 #error "malformed chlicense.h"
@@ -231,6 +274,26 @@ typedef struct {
    * @brief   VFS nodes associated to file descriptors.
    */
   vfs_node_c                    *vfs_nodes[SB_CFG_FD_NUM];
+#if (SB_CFG_ENABLE_POSIX_RING == TRUE) || defined(__DOXYGEN__)
+  /**
+   * @brief   Posix ring in sandbox memory or @p NULL.
+   */
+  sb_ring_t                     *ring;
+  /**
+   * @brief   Number of entries in the Posix ring.
+   */
+  uint32_t                      ring_size;
+  /**
+   * @brief   Host copy of the submission queue head.
+   * @note    The shared indexes are written by the sandbox, the host
+   *          never relies on them for its own state.
+   */
+  uint32_t                      sq_head;
+  /**
+   * @brief   Host copy of the completion queue tail.
+   */
+  uint32_t                      cq_tail;
+#endif
 } sb_ioblock_t;
 #endif
 
@@ -350,6 +413,12 @@ struct sb_class {
    * @brief   Reference to sh SB thread while waiting for VRQs.
    */
   thread_reference_t            vrq_trp;
+#if (SB_CFG_ENABLE_VRQ_STATS == TRUE) || defined(__DOXYGEN__)
+  /**
+   * @brief   VRQs statistics.
+   */
+  sb_vrq_stats_t                vrq_stats;
+#endif
 #endif
 #if (SB_CFG_ENABLE_VFS == TRUE) || defined(__DOXYGEN__)
   /**
@@ -975,6 +975,11 @@ static void sb_cleanup(void) {
       sbp->io.vfs_nodes[fd] = NULL;
     }
   }
+
+#if SB_CFG_ENABLE_POSIX_RING == TRUE
+  /* Detaching the Posix ring.*/
+  sbp->io.ring = NULL;
+#endif
 #endif
 }
 
@@ -1036,6 +1041,18 @@ static void sb_sysc_stdio(struct port_extctx *ectxp) {
                                          (const void *)ectxp->r2,
                                          (size_t)ectxp->r3);
     break;
+  case SB_POSIX_READV:
+    ectxp->r0 = (uint32_t)sb_posix_readv(sbp,
+                                         (int)ectxp->r1,
+                                         (const sb_iovec_t *)ectxp->r2,
+                                         (int)ectxp->r3);
+    break;
+  case SB_POSIX_WRITEV:
+    ectxp->r0 = (uint32_t)sb_posix_writev(sbp,
+                                          (int)ectxp->r1,
+                                          (const sb_iovec_t *)ectxp->r2,
+                                          (int)ectxp->r3);
+    break;
   case SB_POSIX_LSEEK:
     ectxp->r0 = (uint32_t)sb_posix_lseek(sbp,
                                          (int)ectxp->r1,
@@ -1080,6 +1097,15 @@ static void sb_sysc_stdio(struct port_extctx *ectxp) {
                                         (const char *)ectxp->r1,
                                         (struct stat *)ectxp->r2);
     break;
+#if SB_CFG_ENABLE_POSIX_RING == TRUE
+  case SB_POSIX_RINGSETUP:
+    ectxp->r0 = (uint32_t)sb_posix_ring_setup(sbp,
+                                              (sb_ring_t *)ectxp->r1);
+    break;
+  case SB_POSIX_RINGENTER:
+    ectxp->r0 = (uint32_t)sb_posix_ring_enter(sbp);
+    break;
+#endif
   default:
     ectxp->r0 = (uint32_t)CH_RET_ENOSYS;
     break;
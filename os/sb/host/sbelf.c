@@ -28,7 +28,13 @@
 #include <string.h>
 
 #include "ch.h"
+#if defined(SB_ELF_STANDALONE)
+#include "vfs.h"
+#include "errcodes.h"
+#include "sbelf.h"
+#else
 #include "sb.h"
+#endif
 
 #if (SB_CFG_ENABLE_VFS == TRUE) || defined(__DOXYGEN__)
 
@@ -65,6 +71,13 @@
 #define ELF32_R_SYM(v)          ((v) >> 8)
 #define ELF32_R_TYPE(v)         ((v) & 0xFFU)
 
+/* Fast loader buffering.*/
+#define ELF_HEADERS_PER_BUFFER  (VFS_BUFFER_SIZE / sizeof (elf32_section_header_t))
+#define ELF_RELS_PER_BUFFER     (VFS_BUFFER_SIZE / sizeof (elf32_rel_t))
+
+/* Maximum padding between sections loaded with a single read.*/
+#define ELF_LOAD_GAP_MAX        64U
+
 /*===========================================================================*/
 /* Module exported variables.                                                */
 /*===========================================================================*/
@@ -91,6 +104,9 @@ typedef struct {
   memory_area_t             area;
   size_t                    rel_size;
   vfs_offset_t              rel_off;
+#if (SB_CFG_ELF_FAST_LOAD == TRUE) || defined(__DOXYGEN__)
+  vfs_offset_t              data_off;
+#endif
 } elf_section_info_t;
 
 /**
@@ -104,9 +120,13 @@ typedef struct elf_load_context {
   vfs_offset_t              sections_off;
   bool                      rel_movw_found;
   uint32_t                  rel_movw_symbol;
-  uint32_t                  rel_movw_address;
+  uintptr_t                 rel_movw_address;
   elf_section_info_t        *next;
   elf_section_info_t        allocated[SB_CFG_ELF_MAX_ALLOCATED];
+#if (SB_CFG_ELF_FAST_LOAD == TRUE) || defined(__DOXYGEN__)
+  vfs_offset_t              position;
+  uint8_t                   secmap[SB_CFG_ELF_MAX_SECTIONS];
+#endif
 } elf_load_context_t;
 
 /**
@@ -204,11 +224,24 @@ static msg_t allocate_section(elf_load_context_t *ctxp,
     return CH_RET_ENOEXEC;
   }
 
+#if SB_CFG_ELF_FAST_LOAD == TRUE
+  /* Data is loaded later, for PROGBITS sections only.*/
+  if (shp->sh_type == SHT_PROGBITS) {
+    esip->data_off = (vfs_offset_t)shp->sh_offset;
+  }
+
+  /* Section number to allocated section map.*/
+  if (section < SB_CFG_ELF_MAX_SECTIONS) {
+    ctxp->secmap[section] = (uint8_t)(esip - &ctxp->allocated[0]) + 1U;
+  }
+#endif
+
   ctxp->next++;
 
   return CH_RET_SUCCESS;
 }
 
+#if (SB_CFG_ELF_FAST_LOAD == FALSE) || defined(__DOXYGEN__)
 static msg_t allocate_load_section(elf_load_context_t *ctxp,
                                    elf_secnum_t section,
                                    const elf32_section_header_t *shp) {
@@ -246,11 +279,21 @@ static msg_t allocate_load_section(elf_load_context_t *ctxp,
 
   return ret;
 }
+#endif
 
 static elf_section_info_t *find_allocated_section(elf_load_context_t *ctxp,
                                                   elf_secnum_t section) {
   elf_section_info_t *esip;
 
+#if SB_CFG_ELF_FAST_LOAD == TRUE
+  /* Direct lookup for sections covered by the map.*/
+  if (section < SB_CFG_ELF_MAX_SECTIONS) {
+    unsigned idx = (unsigned)ctxp->secmap[section];
+
+    return idx > 0U ? &ctxp->allocated[idx - 1U] : NULL;
+  }
+#endif
+
   /* Scanning allocated sections.*/
   for (esip = &ctxp->allocated[0]; esip < ctxp->next; esip++) {
     if (esip->section == section) {
@@ -261,7 +304,7 @@ static elf_section_info_t *find_allocated_section(elf_load_context_t *ctxp,
   return NULL;
 }
 
-static uint32_t get_const16(uint32_t address) {
+static uint32_t get_const16(uintptr_t address) {
   uint32_t ins  = ((uint32_t)(((uint16_t *)address)[0]) << 16) |
                   ((uint32_t)(((uint16_t *)address)[1]) << 0);
 
@@ -271,7 +314,7 @@ static uint32_t get_const16(uint32_t address) {
          ((ins & 0x04000000U) >> 14);
 }
 
-static void set_const16(uint32_t address, uint32_t val16) {
+static void set_const16(uintptr_t address, uint32_t val16) {
   uint32_t ins  = ((uint32_t)(((uint16_t *)address)[0]) << 16) |
                   ((uint32_t)(((uint16_t *)address)[1]) << 0);
 
@@ -288,10 +331,11 @@ static void set_const16(uint32_t address, uint32_t val16) {
 static msg_t reloc_entry(elf_load_context_t *ctxp,
                          elf_section_info_t *esip,
                          elf32_rel_t *rp) {
-  uint32_t relocation_address, offset;
+  uintptr_t relocation_address;
+  uint32_t offset;
 
   /* Relocation point address.*/
-  relocation_address = (uint32_t)ctxp->map->base + rp->r_offset;
+  relocation_address = (uintptr_t)ctxp->map->base + (uintptr_t)rp->r_offset;
   if (!chMemIsSpaceWithinX(&esip->area,
                            (const void *)relocation_address,
                            sizeof (uint32_t))) {
@@ -301,7 +345,7 @@ static msg_t reloc_entry(elf_load_context_t *ctxp,
   /* Handling the various relocation point types.*/
   switch (ELF32_R_TYPE(rp->r_info)) {
   case R_ARM_ABS32:
-    *((uint32_t *)relocation_address) += (uint32_t)ctxp->map->base;
+    *((uint32_t *)relocation_address) += (uint32_t)(uintptr_t)ctxp->map->base;
     break;
   case R_ARM_THM_MOVW_ABS_NC:
     /* Checking for consecutive "movw" relocations without a "movt", we
@@ -330,7 +374,7 @@ static msg_t reloc_entry(elf_load_context_t *ctxp,
     /* Relocating both the "movw" and the "movt" instructions.*/
     offset  = (get_const16(relocation_address) << 16) |
               (get_const16(ctxp->rel_movw_address) << 0);
-    offset += (uint32_t)ctxp->map->base;
+    offset += (uint32_t)(uintptr_t)ctxp->map->base;
     set_const16(relocation_address, offset >> 16);
     set_const16(ctxp->rel_movw_address, offset & 0xFFFFU);
 
@@ -349,12 +393,13 @@ static msg_t reloc_entry(elf_load_context_t *ctxp,
   return CH_RET_SUCCESS;
 }
 
+#if (SB_CFG_ELF_FAST_LOAD == FALSE) || defined(__DOXYGEN__)
 static msg_t reloc_section(elf_load_context_t *ctxp,
                            elf_section_info_t *esip) {
   vfs_shared_buffer_t *shbuf;
   elf32_rel_t *rbuf;
   size_t size, done_size, remaining_size;
-  msg_t ret;
+  msg_t ret = CH_RET_SUCCESS;
 
   shbuf = vfs_buffer_take_wait();
   rbuf = (elf32_rel_t *)(void *)shbuf->buf;
@@ -398,23 +443,273 @@ static msg_t reloc_section(elf_load_context_t *ctxp,
 
   return ret;
 }
+#endif /* SB_CFG_ELF_FAST_LOAD == FALSE */
+
+#if (SB_CFG_ELF_FAST_LOAD == TRUE) || defined(__DOXYGEN__)
+static msg_t read_at(elf_load_context_t *ctxp, vfs_offset_t offset,
+                     void *buf, size_t size) {
+  msg_t ret;
+
+  /* Seeking only if required, sequential reads leave the file position
+     untouched.*/
+  if (offset != ctxp->position) {
+    ret = vfsSetFilePosition(ctxp->fnp, offset, VFS_SEEK_SET);
+    CH_RETURN_ON_ERROR(ret);
+    ctxp->position = offset;
+  }
+
+  ret = (msg_t)vfsReadFile(ctxp->fnp, (uint8_t *)buf, size);
+  CH_RETURN_ON_ERROR(ret);
+  ctxp->position += (vfs_offset_t)ret;
+
+  /* A truncated file is not a valid executable.*/
+  if ((size_t)ret != size) {
+    return CH_RET_ENOEXEC;
+  }
+
+  return CH_RET_SUCCESS;
+}
+
+static vfs_offset_t get_offset(const elf_section_info_t *esip, bool rel) {
+
+  return rel ? esip->rel_off : esip->data_off;
+}
+
+static unsigned sort_sections(elf_load_context_t *ctxp,
+                              elf_section_info_t **order,
+                              bool rel) {
+  elf_section_info_t *esip;
+  vfs_offset_t offset;
+  unsigned i, n;
+
+  /* Insertion sort by file offset of the section data or of the associated
+     relocation table, sections without one are skipped.*/
+  n = 0U;
+  for (esip = &ctxp->allocated[0]; esip < ctxp->next; esip++) {
+    offset = get_offset(esip, rel);
+    if (offset == (vfs_offset_t)0) {
+      continue;
+    }
+    for (i = n; (i > 0U) && (get_offset(order[i - 1U], rel) > offset); i--) {
+      order[i] = order[i - 1U];
+    }
+    order[i] = esip;
+    n++;
+  }
+
+  return n;
+}
+
+static msg_t load_sections(elf_load_context_t *ctxp) {
+  elf_section_info_t *order[SB_CFG_ELF_MAX_ALLOCATED];
+  unsigned i, j, n;
+  msg_t ret;
+
+  n = sort_sections(ctxp, order, false);
+  for (i = 0U; i < n; i = j) {
+    uint8_t *base = order[i]->area.base;
+    size_t size = order[i]->area.size;
+
+    /* Sections laid out identically in the file and in memory are loaded
+       with a single read, small padding gaps not belonging to any other
+       section are loaded too.*/
+    for (j = i + 1U; j < n; j++) {
+      memory_area_t gap;
+      size_t delta;
+
+      delta    = (size_t)(order[j]->data_off - order[i]->data_off);
+      gap.base = base + size;
+      if ((order[j]->area.base < gap.base) ||
+          ((size_t)(order[j]->area.base - base) != delta)) {
+        break;
+      }
+      gap.size = (size_t)(order[j]->area.base - gap.base);
+      if ((gap.size > ELF_LOAD_GAP_MAX) ||
+          ((gap.size > 0U) && area_is_intersecting(ctxp, &gap))) {
+        break;
+      }
+      size = delta + order[j]->area.size;
+    }
+
+    ret = read_at(ctxp, order[i]->data_off, (void *)base, size);
+    CH_RETURN_ON_ERROR(ret);
+  }
+
+  return CH_RET_SUCCESS;
+}
+
+static msg_t reloc_sections(elf_load_context_t *ctxp) {
+  elf_section_info_t *order[SB_CFG_ELF_MAX_ALLOCATED];
+  vfs_shared_buffer_t *shbuf;
+  elf32_rel_t *rbuf;
+  unsigned i, n;
+  msg_t ret;
+
+  /* Relocation tables are processed in file order.*/
+  n = sort_sections(ctxp, order, true);
+  if (n == 0U) {
+    return CH_RET_SUCCESS;
+  }
+
+  shbuf = vfs_buffer_take_wait();
+  rbuf = (elf32_rel_t *)(void *)shbuf->buf;
+
+  ret = CH_RET_SUCCESS;
+  for (i = 0U; i < n; i++) {
+    vfs_offset_t offset = order[i]->rel_off;
+    size_t remaining = order[i]->rel_size;
+
+    while (remaining >= sizeof (elf32_rel_t)) {
+      unsigned j, k;
+
+      k = (unsigned)(remaining / sizeof (elf32_rel_t));
+      if (k > ELF_RELS_PER_BUFFER) {
+        k = ELF_RELS_PER_BUFFER;
+      }
+
+      /* Reading a buffer-worth of relocation data, no seek is performed
+         after the first chunk.*/
+      ret = read_at(ctxp, offset, (void *)rbuf,
+                    (size_t)k * sizeof (elf32_rel_t));
+      CH_BREAK_ON_ERROR(ret);
+
+      for (j = 0U; j < k; j++) {
+        ret = reloc_entry(ctxp, order[i], &rbuf[j]);
+        CH_BREAK_ON_ERROR(ret);
+      }
+      CH_BREAK_ON_ERROR(ret);
+
+      offset    += (vfs_offset_t)(k * sizeof (elf32_rel_t));
+      remaining -= (size_t)k * sizeof (elf32_rel_t);
+    }
+    CH_BREAK_ON_ERROR(ret);
+  }
+
+  vfs_buffer_release(shbuf);
+
+  return ret;
+}
+#endif /* SB_CFG_ELF_FAST_LOAD == TRUE */
+
+static msg_t process_section(elf_load_context_t *ctxp,
+                             elf_secnum_t section,
+                             const elf32_section_header_t *shp) {
+  elf_section_info_t *esip;
+
+  /* Empty sections are not processed.*/
+  if (shp->sh_size == 0U) {
+    return CH_RET_SUCCESS;
+  }
+
+  /* Deciding what to do with the section depending on type.*/
+  switch (shp->sh_type) {
+  case SHT_PROGBITS:
+    /* Allocatable section type, needs to be loaded.*/
+    if ((shp->sh_flags & SHF_ALLOC) != 0U) {
+
+#if SB_CFG_ELF_FAST_LOAD == TRUE
+      /* Allocating only, data is loaded after scanning all headers.*/
+      return allocate_section(ctxp, section, shp);
+#else
+      /* Allocating and loading, could fail.*/
+      return allocate_load_section(ctxp, section, shp);
+#endif
+    }
+    break;
+
+  case SHT_NOBITS:
+    /* Uninitialized data section, we can have more than one, just checking
+       address ranges.*/
+    if ((shp->sh_flags & SHF_ALLOC) != 0U) {
+      return allocate_section(ctxp, section, shp);
+    }
+    break;
+
+  case SHT_REL:
+    if ((shp->sh_flags & SHF_INFO_LINK) != 0U) {
+
+      esip = find_allocated_section(ctxp, (elf_secnum_t)shp->sh_info);
+      if (esip == NULL) {
+        /* Ignoring other relocation sections.*/
+        break;
+      }
+
+      /* Multiple relocation sections associated to the same section.*/
+      if (esip->rel_size != 0U) {
+        return CH_RET_ENOEXEC;
+      }
+
+      esip->rel_size = shp->sh_size;
+      esip->rel_off  = (vfs_offset_t)shp->sh_offset;
+    }
+    break;
+
+  default:
+    /* Ignoring other section types.*/
+    break;
+  }
+
+  return CH_RET_SUCCESS;
+}
+
+#if (SB_CFG_ELF_FAST_LOAD == TRUE) || defined(__DOXYGEN__)
+static msg_t scan_sections(elf_load_context_t *ctxp) {
+  vfs_shared_buffer_t *shbuf;
+  elf32_section_header_t *shp;
+  elf_secnum_t i, j, n;
+  msg_t ret;
+
+  shbuf = vfs_buffer_take_wait();
+  shp = (elf32_section_header_t *)(void *)shbuf->buf;
+
+  /* The section headers table is read in a single operation when it fits
+     the shared buffer, larger tables are read in sequential chunks.*/
+  ret = CH_RET_SUCCESS;
+  for (i = 0U; i < ctxp->sections_num; i += n) {
+    n = ctxp->sections_num - i;
+    if (n > ELF_HEADERS_PER_BUFFER) {
+      n = ELF_HEADERS_PER_BUFFER;
+    }
+
+    ret = read_at(ctxp,
+                  ctxp->sections_off + ((vfs_offset_t)i *
+                                        (vfs_offset_t)sizeof (elf32_section_header_t)),
+                  (void *)shp, (size_t)n * sizeof (elf32_section_header_t));
+    CH_BREAK_ON_ERROR(ret);
+
+    for (j = 0U; j < n; j++) {
+      ret = process_section(ctxp, i + j, &shp[j]);
+      CH_BREAK_ON_ERROR(ret);
+    }
+    CH_BREAK_ON_ERROR(ret);
+  }
+
+  vfs_buffer_release(shbuf);
+
+  return ret;
+}
+#endif /* SB_CFG_ELF_FAST_LOAD == TRUE */
 
 /*===========================================================================*/
 /* Module exported functions.                                                */
 /*===========================================================================*/
 
+/**
+ * @brief   Loads an ELF file into a memory area.
+ * @details The executable is loaded and relocated for execution at the
+ *          base of the memory area.
+ * @note    When @p SB_CFG_ELF_FAST_LOAD is enabled the section headers
+ *          table is read in one pass, sections data is loaded in file
+ *          order using the minimum number of reads and relocation tables
+ *          are streamed sequentially.
+ *
+ * @param[in] fnp       pointer to the ELF file node
+ * @param[in] map       memory area for the executable
+ * @return              The operation result.
+ */
 msg_t sbElfLoad(vfs_file_node_c *fnp, const memory_area_t *map) {
   msg_t ret;
   elf_load_context_t ctx;
-  elf_section_info_t *esip;
-
-  /* Large structures not used at same time, the compiler could optimize it
-     but it is still a problem when running the code without optimizations for
-     debug.*/
-  union {
-    elf32_header_t h;
-    elf32_section_header_t sh;
-  } u;
 
   /* Load context initialization.*/
   {
@@ -422,6 +717,7 @@ msg_t sbElfLoad(vfs_file_node_c *fnp, const memory_area_t *map) {
       0x7f, 0x45, 0x4c, 0x46, 0x01, 0x01, 0x01, 0x00,
       0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00
     };
+    elf32_header_t h;
 
     /* Context fully cleared.*/
     memset((void *)&ctx, 0, sizeof (elf_load_context_t));
@@ -434,29 +730,52 @@ msg_t sbElfLoad(vfs_file_node_c *fnp, const memory_area_t *map) {
     /* Reading the main ELF header.*/
     ret = vfsSetFilePosition(ctx.fnp, (vfs_offset_t)0, VFS_SEEK_SET);
     CH_RETURN_ON_ERROR(ret);
-    ret = vfsReadFile(ctx.fnp, (void *)&u.h, sizeof (elf32_header_t));
+    ret = vfsReadFile(ctx.fnp, (void *)&h, sizeof (elf32_header_t));
     CH_RETURN_ON_ERROR(ret);
+#if SB_CFG_ELF_FAST_LOAD == TRUE
+    ctx.position = (vfs_offset_t)ret;
+#endif
 
     /* Checking for the expected header.*/
-    if (memcmp(u.h.e_ident, elf32_header, 16) != 0) {
+    if (memcmp(h.e_ident, elf32_header, 16) != 0) {
       return CH_RET_ENOEXEC;
     }
 
     /* Accepting executable files only.*/
-    if (u.h.e_type != ET_EXEC) {
+    if (h.e_type != ET_EXEC) {
+      return CH_RET_ENOEXEC;
+    }
+
+    /* Section headers must match the expected layout.*/
+    if ((h.e_shnum > 0U) &&
+        (h.e_shentsize != (uint16_t)sizeof (elf32_section_header_t))) {
       return CH_RET_ENOEXEC;
     }
 
     /* TODO more consistency checks.*/
 
     /* Storing info required later.*/
-//    ctx.entry        = u.h.e_entry;
-    ctx.sections_num = (unsigned)u.h.e_shnum;
-    ctx.sections_off = (vfs_offset_t)u.h.e_shoff;
+//    ctx.entry        = h.e_entry;
+    ctx.sections_num = (unsigned)h.e_shnum;
+    ctx.sections_off = (vfs_offset_t)h.e_shoff;
   }
 
+#if SB_CFG_ELF_FAST_LOAD == TRUE
+  /* Scanning phase, all sections are allocated.*/
+  ret = scan_sections(&ctx);
+  CH_RETURN_ON_ERROR(ret);
+
+  /* Loading phase, sections data is read in file order.*/
+  ret = load_sections(&ctx);
+  CH_RETURN_ON_ERROR(ret);
+
+  /* Relocating all sections with an associated relocation table.*/
+  return reloc_sections(&ctx);
+#else
   /* Loading phase, scanning section headers.*/
   {
+    elf32_section_header_t sh;
+    elf_section_info_t *esip;
     elf_secnum_t i;
 
     for (i = 0U; i < ctx.sections_num; i++) {
@@ -467,72 +786,34 @@ msg_t sbElfLoad(vfs_file_node_c *fnp, const memory_area_t *map) {
                                                    (vfs_offset_t)sizeof (elf32_section_header_t)),
                                VFS_SEEK_SET);
       CH_RETURN_ON_ERROR(ret);
-      ret = vfsReadFile(ctx.fnp, (void *)&u.sh, sizeof (elf32_section_header_t));
+      ret = vfsReadFile(ctx.fnp, (void *)&sh, sizeof (elf32_section_header_t));
       CH_RETURN_ON_ERROR(ret);
 
-      /* Empty sections are not processed.*/
-      if (u.sh.sh_size == 0U) {
-        continue;
-      }
-
-      /* Deciding what to do with the section depending on type.*/
-      switch (u.sh.sh_type) {
-      case SHT_PROGBITS:
-        /* Allocatable section type, needs to be loaded.*/
-        if ((u.sh.sh_flags & SHF_ALLOC) != 0U) {
-
-          /* Allocating and loading, could fail.*/
-          ret = allocate_load_section(&ctx, i, &u.sh);
-          CH_RETURN_ON_ERROR(ret);
-        }
-        break;
-
-      case SHT_NOBITS:
-        /* Uninitialized data section, we can have more than one, just checking
-           address ranges.*/
-        if ((u.sh.sh_flags & SHF_ALLOC) != 0U) {
-          ret = allocate_section(&ctx, i, &u.sh);
-          CH_RETURN_ON_ERROR(ret);
-        }
-        break;
-
-      case SHT_REL:
-        if ((u.sh.sh_flags & SHF_INFO_LINK) != 0U) {
-
-          esip = find_allocated_section(&ctx, (elf_secnum_t)u.sh.sh_info);
-          if (esip == NULL) {
-            /* Ignoring other relocation sections.*/
-            break;
-          }
-
-          /* Multiple relocation sections associated to the same section.*/
-          if (esip->rel_size != 0U) {
-            return CH_RET_ENOEXEC;
-          }
-
-          esip->rel_size = u.sh.sh_size;
-          esip->rel_off  = (vfs_offset_t)u.sh.sh_offset;
-        }
-        break;
-
-      default:
-        /* Ignoring other section types.*/
-        break;
-      }
+      ret = process_section(&ctx, i, &sh);
+      CH_RETURN_ON_ERROR(ret);
     }
-  }
 
-  /* Relocating all sections with an associated relocation table.*/
-  for (esip = &ctx.allocated[0]; esip < ctx.next; esip++) {
-    if (esip->rel_off != (vfs_offset_t)0) {
-      ret = reloc_section(&ctx, esip);
-      CH_RETURN_ON_ERROR(ret);
+    /* Relocating all sections with an associated relocation table.*/
+    for (esip = &ctx.allocated[0]; esip < ctx.next; esip++) {
+      if (esip->rel_off != (vfs_offset_t)0) {
+        ret = reloc_section(&ctx, esip);
+        CH_RETURN_ON_ERROR(ret);
+      }
     }
   }
 
   return ret;
+#endif
 }
 
+/**
+ * @brief   Loads an ELF file into a memory area.
+ *
+ * @param[in] drvp      pointer to the VFS driver containing the file
+ * @param[in] path      path of the ELF file
+ * @param[in] map       memory area for the executable
+ * @return              The operation result.
+ */
 msg_t sbElfLoadFile(vfs_driver_c *drvp,
                     const char *path,
                     const memory_area_t *map) {
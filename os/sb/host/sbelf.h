@@ -28,6 +28,11 @@
 #ifndef SBELF_H
 #define SBELF_H
 
+/* The stand-alone loader only depends on the VFS.*/
+#if defined(SB_ELF_STANDALONE) && !defined(SB_CFG_ENABLE_VFS)
+#define SB_CFG_ENABLE_VFS               TRUE
+#endif
+
 #if (SB_CFG_ENABLE_VFS == TRUE) || defined(__DOXYGEN__)
 
 /*===========================================================================*/
@@ -45,6 +50,28 @@
 #define SB_CFG_ELF_MAX_ALLOCATED        6
 #endif
 
+/**
+ * @brief   Enables the fast ELF loading mode.
+ * @details The section headers table is read in a single pass, sections
+ *          data is then loaded in file order merging adjacent sections
+ *          into single reads and relocation tables are streamed without
+ *          seeking between chunks.
+ * @note    The legacy mode reads each section header separately and
+ *          requires less stack.
+ */
+#if !defined(SB_CFG_ELF_FAST_LOAD) || defined(__DOXYGEN__)
+#define SB_CFG_ELF_FAST_LOAD            TRUE
+#endif
+
+/**
+ * @brief   Number of sections covered by the fast loader sections map.
+ * @details Relocation tables associated to sections above this number are
+ *          resolved using a linear search.
+ */
+#if !defined(SB_CFG_ELF_MAX_SECTIONS) || defined(__DOXYGEN__)
+#define SB_CFG_ELF_MAX_SECTIONS         64
+#endif
+
 /*===========================================================================*/
 /* Derived constants and error checks.                                       */
 /*===========================================================================*/
@@ -53,6 +80,14 @@
 #error "invalid SB_CFG_ELF_MAX_ALLOCATED value"
 #endif
 
+#if (SB_CFG_ELF_MAX_SECTIONS < 1) || (SB_CFG_ELF_MAX_SECTIONS > 256)
+#error "invalid SB_CFG_ELF_MAX_SECTIONS value"
+#endif
+
+#if (SB_CFG_ELF_FAST_LOAD == TRUE) && (VFS_BUFFER_SIZE < 64)
+#error "SB_CFG_ELF_FAST_LOAD requires VFS_BUFFER_SIZE >= 64"
+#endif
+
 /*===========================================================================*/
 /* Module data structures and types.                                         */
 /*===========================================================================*/
@@ -0,0 +1,10 @@
+# ChibiOS sandbox ELF loader as a stand-alone library, it only requires
+# the VFS and can be built for any port, including the simulator.
+SBELFSRC = $(CHIBIOS)/os/sb/host/sbelf.c
+
+SBELFINC = $(CHIBIOS)/os/sb/host
+
+# Shared variables
+ALLCSRC += $(SBELFSRC)
+ALLINC  += $(SBELFINC)
+DDEFS   += -DSB_ELF_STANDALONE
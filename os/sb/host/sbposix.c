@@ -66,6 +66,84 @@ static msg_t create_descriptor(sb_ioblock_t *iop,
   return CH_RET_EMFILE;
 }
 
+/* The segments array is copied before validating the segments, the sandbox
+   cannot change them after the check.*/
+static msg_t load_iovec(sb_class_t *sbp, const sb_iovec_t *iov, int iovcnt,
+                        stm_iovec_t *viov, bool writable) {
+  size_t total = (size_t)0;
+  int i;
+
+  if ((iovcnt < 0) || (iovcnt > (int)SB_POSIX_IOV_MAX)) {
+    return CH_RET_EINVAL;
+  }
+
+  if (!sb_is_valid_read_range(sbp, (const void *)iov,
+                              (size_t)iovcnt * sizeof (sb_iovec_t))) {
+    return CH_RET_EFAULT;
+  }
+
+  for (i = 0; i < iovcnt; i++) {
+    viov[i].base = iov[i].base;
+    viov[i].len  = iov[i].len;
+
+    /* The total must be representable in the returned value.*/
+    if (viov[i].len > (size_t)INT32_MAX - total) {
+      return CH_RET_EINVAL;
+    }
+    total += viov[i].len;
+
+    if (viov[i].len > (size_t)0) {
+      if (writable) {
+        if (!sb_is_valid_write_range(sbp, viov[i].base, viov[i].len)) {
+          return CH_RET_EFAULT;
+        }
+      }
+      else {
+        if (!sb_is_valid_read_range(sbp, viov[i].base, viov[i].len)) {
+          return CH_RET_EFAULT;
+        }
+      }
+    }
+  }
+
+  return CH_RET_SUCCESS;
+}
+
+#if (SB_CFG_ENABLE_POSIX_RING == TRUE) || defined(__DOXYGEN__)
+static int32_t ring_execute(sb_class_t *sbp, const sb_ring_sqe_t *sqep) {
+
+  switch (sqep->opcode) {
+  case SB_POSIX_READ:
+    return (int32_t)sb_posix_read(sbp,
+                                  (int)sqep->fd,
+                                  (void *)sqep->arg1,
+                                  (size_t)sqep->arg2);
+  case SB_POSIX_WRITE:
+    return (int32_t)sb_posix_write(sbp,
+                                   (int)sqep->fd,
+                                   (const void *)sqep->arg1,
+                                   (size_t)sqep->arg2);
+  case SB_POSIX_READV:
+    return (int32_t)sb_posix_readv(sbp,
+                                   (int)sqep->fd,
+                                   (const sb_iovec_t *)sqep->arg1,
+                                   (int)sqep->arg2);
+  case SB_POSIX_WRITEV:
+    return (int32_t)sb_posix_writev(sbp,
+                                    (int)sqep->fd,
+                                    (const sb_iovec_t *)sqep->arg1,
+                                    (int)sqep->arg2);
+  case SB_POSIX_LSEEK:
+    return (int32_t)sb_posix_lseek(sbp,
+                                   (int)sqep->fd,
+                                   (off_t)(int32_t)sqep->arg1,
+                                   (int)sqep->arg2);
+  default:
+    return (int32_t)CH_RET_ENOSYS;
+  }
+}
+#endif
+
 /*===========================================================================*/
 /* Module exported functions.                                                */
 /*===========================================================================*/
@@ -105,6 +183,14 @@ int sb_posix_open(sb_class_t *sbp, const char *path, int flags) {
     ret = vfsDrvOpen(sbp->config->vfs_driver, path, (unsigned)flags, &np);
     CH_BREAK_ON_ERROR(ret);
 
+#if VFS_CFG_FILEBUFS_NUM > 0
+    /* Regular files are buffered if possible, small reads and writes are
+       common in sandboxed code.*/
+    if (VFS_MODE_S_ISREG(np->mode)) {
+      np = (vfs_node_c *)vfs_filebuf_wrap((vfs_file_node_c *)np, flags);
+    }
+#endif
+
     ret = create_descriptor(&sbp->io, np);
     CH_BREAK_ON_ERROR(ret);
 
@@ -240,9 +326,61 @@ ssize_t sb_posix_write(sb_class_t *sbp, int fd, const void *buf, size_t count) {
   return vfsWriteFile((vfs_file_node_c *)sbp->io.vfs_nodes[fd], buf, count);
 }
 
+ssize_t sb_posix_readv(sb_class_t *sbp, int fd,
+                       const sb_iovec_t *iov, int iovcnt) {
+  stm_iovec_t viov[SB_POSIX_IOV_MAX];
+  msg_t ret;
+
+  if (!sb_is_existing_descriptor(&sbp->io, fd)) {
+    return CH_RET_EBADF;
+  }
+
+  if (VFS_MODE_S_ISDIR(sbp->io.vfs_nodes[fd]->mode)) {
+    return CH_RET_EISDIR;
+  }
+
+  ret = load_iovec(sbp, iov, iovcnt, viov, true);
+  if (CH_RET_IS_ERROR(ret)) {
+    return (ssize_t)ret;
+  }
+
+  if (iovcnt == 0) {
+    return 0;
+  }
+
+  return vfsReadFileV((vfs_file_node_c *)sbp->io.vfs_nodes[fd],
+                      viov, (unsigned)iovcnt);
+}
+
+ssize_t sb_posix_writev(sb_class_t *sbp, int fd,
+                        const sb_iovec_t *iov, int iovcnt) {
+  stm_iovec_t viov[SB_POSIX_IOV_MAX];
+  msg_t ret;
+
+  if (!sb_is_existing_descriptor(&sbp->io, fd)) {
+    return CH_RET_EBADF;
+  }
+
+  if (VFS_MODE_S_ISDIR(sbp->io.vfs_nodes[fd]->mode)) {
+    return CH_RET_EISDIR;
+  }
+
+  ret = load_iovec(sbp, iov, iovcnt, viov, false);
+  if (CH_RET_IS_ERROR(ret)) {
+    return (ssize_t)ret;
+  }
+
+  if (iovcnt == 0) {
+    return 0;
+  }
+
+  return vfsWriteFileV((vfs_file_node_c *)sbp->io.vfs_nodes[fd],
+                       viov, (unsigned)iovcnt);
+}
+
 off_t sb_posix_lseek(sb_class_t *sbp, int fd, off_t offset, int whence) {
 
-  if ((whence != SEEK_SET) || (whence == SEEK_CUR) || (whence != SEEK_END)) {
+  if ((whence != SEEK_SET) && (whence != SEEK_CUR) && (whence != SEEK_END)) {
     return CH_RET_EINVAL;
   }
 
@@ -260,7 +398,7 @@ off_t sb_posix_lseek(sb_class_t *sbp, int fd, off_t offset, int whence) {
 
   return vfsSetFilePosition((struct vfs_file_node *)sbp->io.vfs_nodes[fd],
                             offset,
-                            whence);;
+                            whence);
 }
 
 ssize_t sb_posix_getdents(sb_class_t *sbp, int fd, void *buf, size_t count) {
@@ -374,6 +512,111 @@ int sb_posix_rmdir(sb_class_t *sbp, const char *path) {
   return (int)vfsDrvRmdir(sbp->config->vfs_driver, path);
 }
 
+#if (SB_CFG_ENABLE_POSIX_RING == TRUE) || defined(__DOXYGEN__)
+/**
+ * @brief   Associates a Posix ring to a sandbox.
+ * @details The ring header and entries are validated against the sandbox
+ *          memory regions, all indexes are reset to zero. Passing @p NULL
+ *          detaches the current ring.
+ *
+ * @param[in] sbp       pointer to a @p sb_class_t structure
+ * @param[in] rp        pointer to the ring in sandbox memory or @p NULL
+ * @return              The operation result.
+ */
+int sb_posix_ring_setup(sb_class_t *sbp, sb_ring_t *rp) {
+  sb_ioblock_t *iop = &sbp->io;
+  uint32_t size;
+
+  iop->ring = NULL;
+
+  if (rp == NULL) {
+    return CH_RET_SUCCESS;
+  }
+
+  if (!MEM_IS_ALIGNED(rp, sizeof (uint32_t)) ||
+      !sb_is_valid_write_range(sbp, (void *)rp, sizeof (sb_ring_t))) {
+    return CH_RET_EFAULT;
+  }
+
+  size = rp->size;
+  if ((size == 0U) || (size > SB_RING_MAX_SIZE) ||
+      ((size & (size - 1U)) != 0U)) {
+    return CH_RET_EINVAL;
+  }
+
+  if (!sb_is_valid_write_range(sbp, (void *)rp, SB_RING_BUFFER_SIZE(size))) {
+    return CH_RET_EFAULT;
+  }
+
+  rp->sq_head    = 0U;
+  rp->sq_tail    = 0U;
+  rp->cq_head    = 0U;
+  rp->cq_tail    = 0U;
+  iop->ring      = rp;
+  iop->ring_size = size;
+  iop->sq_head   = 0U;
+  iop->cq_tail   = 0U;
+
+  return CH_RET_SUCCESS;
+}
+
+/**
+ * @brief   Processes the pending entries of the Posix ring.
+ * @details Submission entries are processed in order, a completion entry
+ *          is posted for each one. Processing stops when the submission
+ *          queue is empty or the completion queue is full, remaining
+ *          entries are processed by the next call.
+ * @note    Shared indexes are sampled once and each entry is copied before
+ *          use, the sandbox cannot alter an operation after its validation.
+ *
+ * @param[in] sbp       pointer to a @p sb_class_t structure
+ * @return              The number of processed entries or an error.
+ */
+int sb_posix_ring_enter(sb_class_t *sbp) {
+  sb_ioblock_t *iop = &sbp->io;
+  sb_ring_t *rp = iop->ring;
+  sb_ring_sqe_t *sqes;
+  sb_ring_cqe_t *cqes;
+  uint32_t mask, sq_tail, cq_head;
+  int n;
+
+  if (rp == NULL) {
+    return CH_RET_EINVAL;
+  }
+
+  mask    = iop->ring_size - 1U;
+  sqes    = SB_RING_SQES(rp);
+  cqes    = SB_RING_CQES(rp, iop->ring_size);
+  sq_tail = rp->sq_tail;
+  cq_head = rp->cq_head;
+
+  /* Inconsistent indexes are rejected without processing anything.*/
+  if (((sq_tail - iop->sq_head) > iop->ring_size) ||
+      ((iop->cq_tail - cq_head) > iop->ring_size)) {
+    return CH_RET_EINVAL;
+  }
+
+  n = 0;
+  while ((iop->sq_head != sq_tail) &&
+         ((iop->cq_tail - cq_head) < iop->ring_size)) {
+    sb_ring_sqe_t sqe = sqes[iop->sq_head & mask];
+    sb_ring_cqe_t *cqep = &cqes[iop->cq_tail & mask];
+
+    cqep->result = ring_execute(sbp, &sqe);
+    cqep->tag    = sqe.tag;
+    iop->sq_head++;
+    iop->cq_tail++;
+    n++;
+  }
+
+  /* Publishing the new indexes, entries are already in memory.*/
+  rp->sq_head = iop->sq_head;
+  rp->cq_tail = iop->cq_tail;
+
+  return n;
+}
+#endif
+
 #endif
 
 /** @} */
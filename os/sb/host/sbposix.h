@@ -66,6 +66,10 @@ extern "C" {
   int sb_posix_fstat(sb_class_t *sbp, int fd, struct stat *statbuf);
   ssize_t sb_posix_read(sb_class_t *sbp, int fd, void *buf, size_t count);
   ssize_t sb_posix_write(sb_class_t *sbp, int fd, const void *buf, size_t count);
+  ssize_t sb_posix_readv(sb_class_t *sbp, int fd,
+                         const sb_iovec_t *iov, int iovcnt);
+  ssize_t sb_posix_writev(sb_class_t *sbp, int fd,
+                          const sb_iovec_t *iov, int iovcnt);
   off_t sb_posix_lseek(sb_class_t *sbp, int fd, off_t offset, int whence);
   ssize_t sb_posix_getdents(sb_class_t *sbp, int fd, void *buf, size_t count);
   int sb_posix_chdir(sb_class_t *sbp, const char *path);
@@ -75,6 +79,10 @@ extern "C" {
   int sb_posix_mkdir(sb_class_t *sbp, const char *path, mode_t mode);
   int sb_posix_rmdir(sb_class_t *sbp, const char *path);
   int sb_posix_stat(sb_class_t *sbp, const char *path, struct stat *statbuf);
+#if SB_CFG_ENABLE_POSIX_RING == TRUE
+  int sb_posix_ring_setup(sb_class_t *sbp, sb_ring_t *rp);
+  int sb_posix_ring_enter(sb_class_t *sbp);
+#endif
 #ifdef __cplusplus
 }
 #endif
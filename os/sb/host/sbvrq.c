@@ -58,18 +58,60 @@ static void vrq_privileged_code(void) {
   }
 }
 
+#if (SB_CFG_ENABLE_VRQ_STATS == TRUE) || defined(__DOXYGEN__)
+/**
+ * @brief   Accounts an event triggered on a VRQ.
+ */
+CC_FORCE_INLINE
+static inline void vrq_count_event(sb_class_t *sbp, sb_vrqnum_t nvrq) {
+
+  sbp->vrq_stats.triggered[nvrq]++;
+  if ((sbp->vrq_wtmask & (sb_vrqmask_t)(1U << nvrq)) != 0U) {
+    sbp->vrq_stats.coalesced[nvrq]++;
+  }
+}
+
+/**
+ * @brief   Accounts events triggered on a mask of VRQs.
+ */
+static void vrq_count_events(sb_class_t *sbp, sb_vrqmask_t m) {
+
+  while (m != 0U) {
+    sb_vrqnum_t nvrq = (sb_vrqnum_t)__CLZ(__RBIT(m));
+
+    m &= ~(sb_vrqmask_t)(1U << nvrq);
+    vrq_count_event(sbp, nvrq);
+  }
+}
+#endif
+
+/* The VRQ number in R0 is the lowest pending one, R1 is the mask of the
+   VRQs taken by this context, the sandbox runtime invokes the handlers of
+   all of them before returning.*/
 CC_FORCE_INLINE
 static inline void vrq_makectx(struct port_extctx *newctxp,
                                sb_class_t *sbp,
                                sb_vrqmask_t active_mask) {
   uint32_t irqn = __CLZ(__RBIT(active_mask));
-  sbp->vrq_wtmask &= ~(1U << irqn);
+
+#if SB_CFG_ENABLE_VRQ_BATCHING == FALSE
+  /* Taking the lowest pending VRQ only, the others are served by
+     following contexts.*/
+  active_mask = (sb_vrqmask_t)(1U << irqn);
+#endif
+  sbp->vrq_wtmask &= ~active_mask;
+
+#if SB_CFG_ENABLE_VRQ_STATS == TRUE
+  sbp->vrq_stats.delivered += (uint32_t)__builtin_popcount(active_mask);
+  sbp->vrq_stats.contexts++;
+#endif
 
   /* Disabling VRQs globally during processing.*/
   sbp->vrq_isr = SB_VRQ_ISR_DISABLED;
 
   /* Building the return context.*/
   newctxp->r0     = irqn;
+  newctxp->r1     = active_mask;
   newctxp->pc     = sbp->sbhp->hdr_vrq;
   newctxp->xpsr   = 0x01000000U;
 #if CORTEX_USE_FPU == TRUE
@@ -149,7 +191,12 @@ void sbVRQTriggerS(sb_class_t *sbp, sb_vrqnum_t nvrq) {
 
   chDbgAssert(sbp->tp->state != CH_STATE_CURRENT, "it is current");
 
-  /* Adding VRQ mask to the pending mask.*/
+#if SB_CFG_ENABLE_VRQ_STATS == TRUE
+  vrq_count_event(sbp, nvrq);
+#endif
+
+  /* Adding VRQ mask to the pending mask, an event on an already pending
+     VRQ is coalesced with it.*/
   sbp->vrq_wtmask |= (sb_vrqmask_t)(1U << nvrq);
 
   /* Triggering the VRQ if enabled.*/
@@ -190,7 +237,12 @@ void sbVRQTriggerI(sb_class_t *sbp, sb_vrqnum_t nvrq) {
 
   chSysLockFromISR();
 
-  /* Adding VRQ mask to the pending mask.*/
+#if SB_CFG_ENABLE_VRQ_STATS == TRUE
+  vrq_count_event(sbp, nvrq);
+#endif
+
+  /* Adding VRQ mask to the pending mask, an event on an already pending
+     VRQ is coalesced with it.*/
   sbp->vrq_wtmask |= (sb_vrqmask_t)(1U << nvrq);
 
   /* Only doing the following if VRQs are globally enabled.*/
@@ -246,6 +298,37 @@ void sbVRQTriggerI(sb_class_t *sbp, sb_vrqnum_t nvrq) {
   chSysUnlockFromISR();
 }
 
+#if (SB_CFG_ENABLE_VRQ_STATS == TRUE) || defined(__DOXYGEN__)
+/**
+ * @brief   Returns the VRQs statistics of the specified sandbox.
+ *
+ * @param[in] sbp       pointer to a @p sb_class_t structure
+ * @param[out] statsp   pointer to a @p sb_vrq_stats_t structure
+ *
+ * @api
+ */
+void sbVRQGetStats(sb_class_t *sbp, sb_vrq_stats_t *statsp) {
+
+  chSysLock();
+  *statsp = sbp->vrq_stats;
+  chSysUnlock();
+}
+
+/**
+ * @brief   Resets the VRQs statistics of the specified sandbox.
+ *
+ * @param[in] sbp       pointer to a @p sb_class_t structure
+ *
+ * @api
+ */
+void sbVRQResetStats(sb_class_t *sbp) {
+
+  chSysLock();
+  memset((void *)&sbp->vrq_stats, 0, sizeof (sb_vrq_stats_t));
+  chSysUnlock();
+}
+#endif
+
 void sb_sysc_vrq_set_alarm(struct port_extctx *ectxp) {
   sb_class_t *sbp = (sb_class_t *)chThdGetSelfX()->ctx.syscall.p;
   sysinterval_t interval = (sysinterval_t )ectxp->r0;
@@ -289,6 +372,9 @@ void sb_fastc_vrq_setwt(struct port_extctx *ectxp) {
 
   m = ectxp->r0;
   ectxp->r0 = sbp->vrq_wtmask;
+#if SB_CFG_ENABLE_VRQ_STATS == TRUE
+  vrq_count_events(sbp, m);
+#endif
   sbp->vrq_wtmask |= m;
 
   __sb_vrq_check_pending(ectxp, sbp);
@@ -34,6 +34,11 @@
 /* Module constants.                                                         */
 /*===========================================================================*/
 
+/**
+ * @brief   Number of VRQs of a sandbox.
+ */
+#define SB_VRQ_NUM              32U
+
 /**
  * @name    Virtual ISR register bit definitions
  * @{
@@ -73,6 +78,32 @@
 /* Module data structures and types.                                         */
 /*===========================================================================*/
 
+#if (SB_CFG_ENABLE_VRQ_STATS == TRUE) || defined(__DOXYGEN__)
+/**
+ * @brief   Type of a VRQs statistics structure.
+ * @note    An event triggered on a VRQ already pending is coalesced with
+ *          it, the handler is invoked once for all of them.
+ */
+typedef struct {
+  /**
+   * @brief   Events triggered on each VRQ.
+   */
+  uint32_t                      triggered[SB_VRQ_NUM];
+  /**
+   * @brief   Events coalesced on each VRQ.
+   */
+  uint32_t                      coalesced[SB_VRQ_NUM];
+  /**
+   * @brief   VRQs delivered to the sandbox.
+   */
+  uint32_t                      delivered;
+  /**
+   * @brief   Return contexts built for VRQs delivery.
+   */
+  uint32_t                      contexts;
+} sb_vrq_stats_t;
+#endif
+
 /*===========================================================================*/
 /* Module macros.                                                            */
 /*===========================================================================*/
@@ -86,6 +117,10 @@ extern "C" {
 #endif
   void sbVRQTriggerS(sb_class_t *sbp, sb_vrqnum_t nvrq);
   void sbVRQTriggerI(sb_class_t *sbp, sb_vrqnum_t nvrq);
+#if (SB_CFG_ENABLE_VRQ_STATS == TRUE) || defined(__DOXYGEN__)
+  void sbVRQGetStats(sb_class_t *sbp, sb_vrq_stats_t *statsp);
+  void sbVRQResetStats(sb_class_t *sbp);
+#endif
   void sb_sysc_vrq_set_alarm(struct port_extctx *ectxp);
   void sb_sysc_vrq_reset_alarm(struct port_extctx *ectxp);
   void sb_sysc_vrq_wait(struct port_extctx *ectxp);
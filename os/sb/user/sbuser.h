@@ -360,6 +360,34 @@ static inline ssize_t sbWrite(int fd, const void *buf, size_t count) {
   return (ssize_t)r0;
 }
 
+/**
+ * @brief   Posix-style file scatter read.
+ *
+ * @param[in] fd        file descriptor
+ * @param[in] iov       pointer to an array of segments
+ * @param[in] iovcnt    number of segments, up to @p SB_POSIX_IOV_MAX
+ * @return              The number of bytes really transferred or an error.
+ */
+static inline ssize_t sbReadV(int fd, const sb_iovec_t *iov, int iovcnt) {
+
+  __syscall4r(128, SB_POSIX_READV, fd, iov, iovcnt);
+  return (ssize_t)r0;
+}
+
+/**
+ * @brief   Posix-style file gather write.
+ *
+ * @param[in] fd        file descriptor
+ * @param[in] iov       pointer to an array of segments
+ * @param[in] iovcnt    number of segments, up to @p SB_POSIX_IOV_MAX
+ * @return              The number of bytes really transferred or an error.
+ */
+static inline ssize_t sbWriteV(int fd, const sb_iovec_t *iov, int iovcnt) {
+
+  __syscall4r(128, SB_POSIX_WRITEV, fd, iov, iovcnt);
+  return (ssize_t)r0;
+}
+
 /**
  * @brief   Posix-style file seek.
  *
@@ -462,6 +490,108 @@ static inline int sbRmdir(const char *path) {
   return (int)r0;
 }
 
+/**
+ * @brief   Initializes a Posix ring buffer.
+ * @note    The buffer must be aligned to 32 bits and have size
+ *          @p SB_RING_BUFFER_SIZE(n).
+ *
+ * @param[out] rp       pointer to the ring buffer
+ * @param[in] n         number of entries, it must be a power of two not
+ *                      greater than @p SB_RING_MAX_SIZE
+ */
+static inline void sbRingObjectInit(sb_ring_t *rp, uint32_t n) {
+
+  rp->sq_head = 0U;
+  rp->sq_tail = 0U;
+  rp->cq_head = 0U;
+  rp->cq_tail = 0U;
+  rp->size    = n;
+}
+
+/**
+ * @brief   Associates a Posix ring to the sandbox.
+ *
+ * @param[in] rp        pointer to an initialized ring or @p NULL for
+ *                      detaching the current ring
+ * @return              Operation result.
+ */
+static inline int sbRingSetup(sb_ring_t *rp) {
+
+  __syscall2r(128, SB_POSIX_RINGSETUP, rp);
+  return (int)r0;
+}
+
+/**
+ * @brief   Submits all queued Posix ring entries.
+ * @details The host processes the entries in order and posts their
+ *          completions before returning.
+ *
+ * @return              The number of processed entries or an error.
+ */
+static inline int sbRingEnter(void) {
+
+  __syscall1r(128, SB_POSIX_RINGENTER);
+  return (int)r0;
+}
+
+/**
+ * @brief   Queues an operation in a Posix ring.
+ * @note    Nothing is executed until @p sbRingEnter() is called.
+ *
+ * @param[in] rp        pointer to the ring
+ * @param[in] opcode    one of @p SB_POSIX_READ, @p SB_POSIX_WRITE,
+ *                      @p SB_POSIX_READV, @p SB_POSIX_WRITEV or
+ *                      @p SB_POSIX_LSEEK
+ * @param[in] fd        file descriptor
+ * @param[in] arg1      buffer pointer, segments array pointer or file offset
+ * @param[in] arg2      number of bytes, number of segments or seek mode
+ * @param[in] tag       tag returned in the completion entry
+ * @return              The operation result.
+ * @retval false        if the entry has been queued.
+ * @retval true         if the submission queue is full.
+ */
+static inline bool sbRingSubmit(sb_ring_t *rp, uint32_t opcode, int fd,
+                                uint32_t arg1, uint32_t arg2, uint32_t tag) {
+  sb_ring_sqe_t *sqep;
+  uint32_t tail = rp->sq_tail;
+
+  if ((tail - rp->sq_head) >= rp->size) {
+    return true;
+  }
+
+  sqep = &SB_RING_SQES(rp)[tail & (rp->size - 1U)];
+  sqep->opcode = opcode;
+  sqep->fd     = (int32_t)fd;
+  sqep->arg1   = arg1;
+  sqep->arg2   = arg2;
+  sqep->tag    = tag;
+  rp->sq_tail  = tail + 1U;
+
+  return false;
+}
+
+/**
+ * @brief   Fetches a completion from a Posix ring.
+ *
+ * @param[in] rp        pointer to the ring
+ * @param[out] cqep     pointer to the completion entry to be filled
+ * @return              The operation result.
+ * @retval false        if a completion has been fetched.
+ * @retval true         if the completion queue is empty.
+ */
+static inline bool sbRingComplete(sb_ring_t *rp, sb_ring_cqe_t *cqep) {
+  uint32_t head = rp->cq_head;
+
+  if (head == rp->cq_tail) {
+    return true;
+  }
+
+  *cqep = SB_RING_CQES(rp, rp->size)[head & (rp->size - 1U)];
+  rp->cq_head = head + 1U;
+
+  return false;
+}
+
 /**
  * @brief   Returns the system time.
  *
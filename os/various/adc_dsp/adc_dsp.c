@@ -0,0 +1,745 @@
+/*
+    ChibiOS - Copyright (C) 2006..2018 Giovanni Di Sirio
+
+    Licensed under the Apache License, Version 2.0 (the "License");
+    you may not use this file except in compliance with the License.
+    You may obtain a copy of the License at
+
+        http://www.apache.org/licenses/LICENSE-2.0
+
+    Unless required by applicable law or agreed to in writing, software
+    distributed under the License is distributed on an "AS IS" BASIS,
+    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+    See the License for the specific language governing permissions and
+    limitations under the License.
+*/
+
+/**
+ * @file    adc_dsp.c
+ * @brief   ADC streaming DSP pipeline code.
+ * @details This module processes the samples produced by an ADC in
+ *          circular mode through a chain of stages.<br>
+ *          The ADC callback only posts the completed half buffer to a jobs
+ *          queue, the raw samples are converted to Q15 and processed by the
+ *          jobs thread, one block at time, while the ADC fills the other
+ *          half. The half buffer is released as soon as it has been
+ *          converted.<br>
+ *          Stages process the block in place: decimators shrink it, the
+ *          other stages observe it and pass it unchanged to the next
+ *          stage. Results are notified using callbacks invoked from the
+ *          jobs thread.
+ *
+ * @addtogroup ADC_DSP
+ * @{
+ */
+
+#include <string.h>
+
+#include "adc_dsp.h"
+
+#if ADC_DSP_SIMD_SSE2 == TRUE
+#include <emmintrin.h>
+#endif
+
+/*===========================================================================*/
+/* Module local definitions.                                                 */
+/*===========================================================================*/
+
+/*===========================================================================*/
+/* Module exported variables.                                                */
+/*===========================================================================*/
+
+/*===========================================================================*/
+/* Module local types.                                                       */
+/*===========================================================================*/
+
+/*===========================================================================*/
+/* Module local variables.                                                   */
+/*===========================================================================*/
+
+/*===========================================================================*/
+/* Module local functions.                                                   */
+/*===========================================================================*/
+
+static inline int16_t dsp_sat16(int32_t x) {
+
+  if (x > INT16_MAX) {
+    return INT16_MAX;
+  }
+  if (x < INT16_MIN) {
+    return INT16_MIN;
+  }
+  return (int16_t)x;
+}
+
+#if ADC_DSP_SIMD_ARM == TRUE
+/* Loads two samples at once, unaligned accesses are allowed.*/
+static inline uint32_t dsp_ld2(const int16_t *p) {
+  uint32_t w;
+
+  memcpy(&w, p, sizeof (w));
+  return w;
+}
+#endif
+
+static uint32_t dsp_isqrt64(uint64_t x) {
+  uint64_t r = 0U, bit = (uint64_t)1U << 62;
+
+  while (bit > x) {
+    bit >>= 2;
+  }
+  while (bit != 0U) {
+    if (x >= r + bit) {
+      x -= r + bit;
+      r = (r >> 1) + bit;
+    }
+    else {
+      r >>= 1;
+    }
+    bit >>= 2;
+  }
+  return (uint32_t)r;
+}
+
+static void dsp_pipeline_job(void *arg) {
+  dsp_block_t *bp = (dsp_block_t *)arg;
+  dsp_pipeline_t *pp = bp->pp;
+  const dsp_pipeline_config_t *config = pp->config;
+  const dsp_adcsample_t *src = bp->samples + config->channel;
+  int16_t *buf = config->work;
+  dsp_stage_t *sp;
+  size_t i, n = bp->n;
+
+  /* Conversion of the selected channel, after this the ADC is free to
+     overwrite the half buffer.*/
+  for (i = 0U; i < n; i++) {
+    buf[i] = dsp_sat16(((int32_t)*src - config->offset) *
+                       (int32_t)(1U << config->shift));
+    src += config->channels;
+  }
+  bp->pending = false;
+
+  for (sp = pp->first; (sp != NULL) && (n > 0U); sp = sp->next) {
+    n = sp->process(sp, buf, n);
+  }
+  pp->processed++;
+}
+
+static size_t dsp_cic_process(dsp_stage_t *sp, int16_t *buf, size_t n) {
+  dsp_cic_t *cicp = (dsp_cic_t *)sp;
+  unsigned k, order = cicp->order;
+  size_t i, o = 0U;
+
+  /* Integrators and combs work in modular arithmetic, the wraparounds
+     cancel out as long as the registers can hold the filter gain.*/
+  for (i = 0U; i < n; i++) {
+    uint32_t v = (uint32_t)(int32_t)buf[i];
+
+    for (k = 0U; k < order; k++) {
+      cicp->integ[k] += v;
+      v = cicp->integ[k];
+    }
+    if (--cicp->phase == 0U) {
+      cicp->phase = cicp->ratio;
+      for (k = 0U; k < order; k++) {
+        uint32_t t = v;
+
+        v -= cicp->comb[k];
+        cicp->comb[k] = t;
+      }
+      buf[o++] = dsp_sat16((int32_t)v >> cicp->shift);
+    }
+  }
+
+  return o;
+}
+
+static size_t dsp_fir_process(dsp_stage_t *sp, int16_t *buf, size_t n) {
+  dsp_fir_t *firp = (dsp_fir_t *)sp;
+  size_t past = firp->taps - 1U;
+  size_t chunk = firp->histsize - past;
+  size_t done = 0U, o = 0U;
+
+  while (done < n) {
+    size_t p, m = n - done;
+
+    if (m > chunk) {
+      m = chunk;
+    }
+
+    /* The chunk is appended to the past samples before writing any output,
+       outputs never overtake the inputs so the processing can be done in
+       place.*/
+    memcpy(&firp->history[past], &buf[done], m * sizeof (int16_t));
+    for (p = firp->phase; p < m; p += firp->ratio) {
+      int32_t acc = dsp_dot_q15(&firp->history[p], firp->coeffs, firp->taps);
+
+      buf[o++] = dsp_sat16((acc + 0x4000) >> 15);
+    }
+    firp->phase = p - m;
+    memmove(&firp->history[0], &firp->history[m], past * sizeof (int16_t));
+    done += m;
+  }
+
+  return o;
+}
+
+static size_t dsp_rms_process(dsp_stage_t *sp, int16_t *buf, size_t n) {
+  dsp_rms_t *rmsp = (dsp_rms_t *)sp;
+  size_t done = 0U;
+
+  while (done < n) {
+    size_t m = rmsp->hop - rmsp->count;
+
+    if (m > n - done) {
+      m = n - done;
+    }
+    rmsp->partial += dsp_sum_squares(&buf[done], m);
+    rmsp->count   += m;
+    done          += m;
+
+    if (rmsp->count >= rmsp->hop) {
+      /* End of hop, the oldest hop leaves the window.*/
+      rmsp->total += rmsp->partial - rmsp->sums[rmsp->index];
+      rmsp->sums[rmsp->index] = rmsp->partial;
+      if (++rmsp->index >= rmsp->hops) {
+        rmsp->index = 0U;
+      }
+      if (rmsp->filled < rmsp->hops) {
+        rmsp->filled++;
+      }
+      rmsp->partial = 0U;
+      rmsp->count   = 0U;
+      rmsp->rms     = dsp_isqrt64(rmsp->total /
+                                  ((uint64_t)rmsp->hop * rmsp->filled));
+      if (sp->cb != NULL) {
+        sp->cb(sp);
+      }
+    }
+  }
+
+  return n;
+}
+
+static size_t dsp_minmax_process(dsp_stage_t *sp, int16_t *buf, size_t n) {
+  dsp_minmax_t *mmp = (dsp_minmax_t *)sp;
+  size_t done = 0U;
+
+  while (done < n) {
+    size_t m = mmp->window - mmp->count;
+    int16_t mn, mx;
+
+    if (m > n - done) {
+      m = n - done;
+    }
+    dsp_min_max(&buf[done], m, &mn, &mx);
+    if (mn < mmp->curmin) {
+      mmp->curmin = mn;
+    }
+    if (mx > mmp->curmax) {
+      mmp->curmax = mx;
+    }
+    mmp->count += m;
+    done       += m;
+
+    if (mmp->count >= mmp->window) {
+      mmp->min    = mmp->curmin;
+      mmp->max    = mmp->curmax;
+      mmp->curmin = INT16_MAX;
+      mmp->curmax = INT16_MIN;
+      mmp->count  = 0U;
+      if (sp->cb != NULL) {
+        sp->cb(sp);
+      }
+    }
+  }
+
+  return n;
+}
+
+static size_t dsp_threshold_process(dsp_stage_t *sp, int16_t *buf, size_t n) {
+  dsp_threshold_t *thp = (dsp_threshold_t *)sp;
+  int16_t mn, mx;
+  size_t i;
+
+  /* Most blocks cannot contain a crossing, those are skipped using the
+     min/max kernel.*/
+  dsp_min_max(buf, n, &mn, &mx);
+  if (thp->above ? (mn > thp->low) : (mx < thp->high)) {
+    thp->position += n;
+    return n;
+  }
+
+  for (i = 0U; i < n; i++) {
+    bool crossed;
+
+    if (thp->above) {
+      crossed = buf[i] <= thp->low;
+    }
+    else {
+      crossed = buf[i] >= thp->high;
+    }
+    if (crossed) {
+      thp->above    = !thp->above;
+      thp->crossing = thp->position + i;
+      thp->crossings++;
+      if (sp->cb != NULL) {
+        sp->cb(sp);
+      }
+    }
+  }
+  thp->position += n;
+
+  return n;
+}
+
+static void dsp_stage_init(dsp_stage_t *sp, dsp_process_t process) {
+
+  sp->next    = NULL;
+  sp->process = process;
+  sp->cb      = NULL;
+  sp->arg     = NULL;
+}
+
+/*===========================================================================*/
+/* Module exported functions.                                                */
+/*===========================================================================*/
+
+/**
+ * @brief   Dot product of Q15 vectors.
+ * @note    The sum of the absolute values of @p h must not exceed one in
+ *          Q15, this guarantees that the accumulator cannot overflow.
+ *
+ * @param[in] x         pointer to the first vector
+ * @param[in] h         pointer to the second vector
+ * @param[in] n         vectors length
+ * @return              The dot product in Q30.
+ *
+ * @notapi
+ */
+int32_t dsp_dot_q15(const int16_t *x, const int16_t *h, size_t n) {
+  int32_t acc = 0;
+  size_t i = 0U;
+
+#if ADC_DSP_SIMD_ARM == TRUE
+  for (; i + 4U <= n; i += 4U) {
+    acc = (int32_t)__SMLAD(dsp_ld2(&x[i]), dsp_ld2(&h[i]), (uint32_t)acc);
+    acc = (int32_t)__SMLAD(dsp_ld2(&x[i + 2U]), dsp_ld2(&h[i + 2U]),
+                           (uint32_t)acc);
+  }
+#elif ADC_DSP_SIMD_SSE2 == TRUE
+  __m128i vacc = _mm_setzero_si128();
+
+  for (; i + 8U <= n; i += 8U) {
+    __m128i vx = _mm_loadu_si128((const __m128i *)(const void *)&x[i]);
+    __m128i vh = _mm_loadu_si128((const __m128i *)(const void *)&h[i]);
+
+    vacc = _mm_add_epi32(vacc, _mm_madd_epi16(vx, vh));
+  }
+  vacc = _mm_add_epi32(vacc, _mm_shuffle_epi32(vacc, 0x4E));
+  vacc = _mm_add_epi32(vacc, _mm_shuffle_epi32(vacc, 0xB1));
+  acc = _mm_cvtsi128_si32(vacc);
+#endif
+
+  for (; i < n; i++) {
+    acc += (int32_t)x[i] * (int32_t)h[i];
+  }
+
+  return acc;
+}
+
+/**
+ * @brief   Sum of the squares of a vector.
+ *
+ * @param[in] x         pointer to the vector
+ * @param[in] n         vector length
+ * @return              The sum of the squares.
+ *
+ * @notapi
+ */
+uint64_t dsp_sum_squares(const int16_t *x, size_t n) {
+  uint64_t acc = 0U;
+  size_t i = 0U;
+
+#if ADC_DSP_SIMD_ARM == TRUE
+  for (; i + 4U <= n; i += 4U) {
+    uint32_t w0 = dsp_ld2(&x[i]), w1 = dsp_ld2(&x[i + 2U]);
+
+    acc = __SMLALD(w0, w0, acc);
+    acc = __SMLALD(w1, w1, acc);
+  }
+#elif ADC_DSP_SIMD_SSE2 == TRUE
+  __m128i vacc = _mm_setzero_si128();
+  const __m128i zero = _mm_setzero_si128();
+  uint64_t lanes[2];
+
+  for (; i + 8U <= n; i += 8U) {
+    __m128i vx = _mm_loadu_si128((const __m128i *)(const void *)&x[i]);
+    /* A pair of squares fits 32 bits only as unsigned, it is widened
+       before accumulating.*/
+    __m128i sq = _mm_madd_epi16(vx, vx);
+
+    vacc = _mm_add_epi64(vacc, _mm_unpacklo_epi32(sq, zero));
+    vacc = _mm_add_epi64(vacc, _mm_unpackhi_epi32(sq, zero));
+  }
+  _mm_storeu_si128((__m128i *)(void *)lanes, vacc);
+  acc = lanes[0] + lanes[1];
+#endif
+
+  for (; i < n; i++) {
+    acc += (uint64_t)((int32_t)x[i] * (int32_t)x[i]);
+  }
+
+  return acc;
+}
+
+/**
+ * @brief   Minimum and maximum of a vector.
+ *
+ * @param[in] x         pointer to the vector
+ * @param[in] n         vector length
+ * @param[out] minp     pointer to the minimum, @p INT16_MAX if @p n is zero
+ * @param[out] maxp     pointer to the maximum, @p INT16_MIN if @p n is zero
+ *
+ * @notapi
+ */
+void dsp_min_max(const int16_t *x, size_t n, int16_t *minp, int16_t *maxp) {
+  int16_t mn = INT16_MAX, mx = INT16_MIN;
+  size_t i = 0U;
+
+#if ADC_DSP_SIMD_ARM == TRUE
+  if (n >= 2U) {
+    uint32_t vmn = dsp_ld2(&x[0]), vmx = vmn;
+
+    for (i = 2U; i + 2U <= n; i += 2U) {
+      uint32_t w = dsp_ld2(&x[i]);
+
+      /* SSUB16 sets the GE flags of each lane, SEL picks the lanes.*/
+      (void)__SSUB16(w, vmx);
+      vmx = __SEL(w, vmx);
+      (void)__SSUB16(vmn, w);
+      vmn = __SEL(w, vmn);
+    }
+    mn = (int16_t)vmn;
+    if ((int16_t)(vmn >> 16) < mn) {
+      mn = (int16_t)(vmn >> 16);
+    }
+    mx = (int16_t)vmx;
+    if ((int16_t)(vmx >> 16) > mx) {
+      mx = (int16_t)(vmx >> 16);
+    }
+  }
+#elif ADC_DSP_SIMD_SSE2 == TRUE
+  if (n >= 8U) {
+    __m128i vmn = _mm_loadu_si128((const __m128i *)(const void *)&x[0]);
+    __m128i vmx = vmn;
+
+    for (i = 8U; i + 8U <= n; i += 8U) {
+      __m128i vx = _mm_loadu_si128((const __m128i *)(const void *)&x[i]);
+
+      vmn = _mm_min_epi16(vmn, vx);
+      vmx = _mm_max_epi16(vmx, vx);
+    }
+    vmn = _mm_min_epi16(vmn, _mm_shuffle_epi32(vmn, 0x4E));
+    vmn = _mm_min_epi16(vmn, _mm_shuffle_epi32(vmn, 0xB1));
+    vmn = _mm_min_epi16(vmn, _mm_srli_epi32(vmn, 16));
+    vmx = _mm_max_epi16(vmx, _mm_shuffle_epi32(vmx, 0x4E));
+    vmx = _mm_max_epi16(vmx, _mm_shuffle_epi32(vmx, 0xB1));
+    vmx = _mm_max_epi16(vmx, _mm_srli_epi32(vmx, 16));
+    mn = (int16_t)_mm_cvtsi128_si32(vmn);
+    mx = (int16_t)_mm_cvtsi128_si32(vmx);
+  }
+#endif
+
+  for (; i < n; i++) {
+    if (x[i] < mn) {
+      mn = x[i];
+    }
+    if (x[i] > mx) {
+      mx = x[i];
+    }
+  }
+
+  *minp = mn;
+  *maxp = mx;
+}
+
+/**
+ * @brief   Initializes a pipeline object.
+ *
+ * @param[out] pp       pointer to a @p dsp_pipeline_t object
+ * @param[in] config    pointer to the configuration
+ *
+ * @init
+ */
+void dspPipelineObjectInit(dsp_pipeline_t *pp,
+                           const dsp_pipeline_config_t *config) {
+  unsigned i;
+
+  chDbgCheck((pp != NULL) && (config != NULL) &&
+             (config->jqp != NULL) && (config->work != NULL) &&
+             (config->channel < config->channels) && (config->shift < 16U));
+
+  pp->config    = config;
+  pp->first     = NULL;
+  pp->next      = 0U;
+  pp->processed = 0U;
+  pp->overruns  = 0U;
+  for (i = 0U; i < 2U; i++) {
+    pp->blocks[i].pp      = pp;
+    pp->blocks[i].samples = NULL;
+    pp->blocks[i].n       = 0U;
+    pp->blocks[i].pending = false;
+  }
+}
+
+/**
+ * @brief   Appends a stage to a pipeline.
+ * @note    Stages must be added before posting the first block.
+ *
+ * @param[in] pp        pointer to a @p dsp_pipeline_t object
+ * @param[in] sp        pointer to an initialized stage
+ *
+ * @api
+ */
+void dspPipelineAddStage(dsp_pipeline_t *pp, dsp_stage_t *sp) {
+  dsp_stage_t **spp;
+
+  chDbgCheck((pp != NULL) && (sp != NULL) && (sp->process != NULL));
+
+  spp = &pp->first;
+  while (*spp != NULL) {
+    spp = &(*spp)->next;
+  }
+  sp->next = NULL;
+  *spp = sp;
+}
+
+/**
+ * @brief   Posts a block of raw samples for processing.
+ * @details The block is processed asynchronously by the jobs thread, the
+ *          buffer must not be overwritten until it has been converted.
+ *          A block is dropped if the previous block posted in the same slot
+ *          is still pending or if there are no free jobs.
+ * @note    Consecutive calls are assumed to alternate between the two
+ *          halves of a circular buffer.
+ *
+ * @param[in] pp        pointer to a @p dsp_pipeline_t object
+ * @param[in] samples   pointer to the interleaved raw samples
+ * @param[in] n         samples per channel in the block, not greater than
+ *                      the work buffer size
+ * @return              The operation status.
+ * @retval false        if the block has been posted.
+ * @retval true         if the block has been dropped.
+ *
+ * @iclass
+ */
+bool dspPipelinePostI(dsp_pipeline_t *pp,
+                      const dsp_adcsample_t *samples,
+                      size_t n) {
+  dsp_block_t *bp;
+  job_descriptor_t *jp;
+
+  chDbgCheckClassI();
+  chDbgCheck((pp != NULL) && (samples != NULL) &&
+             (n <= pp->config->worksize));
+
+  bp = &pp->blocks[pp->next];
+  if (bp->pending) {
+    pp->overruns++;
+    return true;
+  }
+  jp = chJobGetI(pp->config->jqp);
+  if (jp == NULL) {
+    pp->overruns++;
+    return true;
+  }
+
+  pp->next ^= 1U;
+  bp->samples = samples;
+  bp->n       = n;
+  bp->pending = true;
+  jp->jobfunc = dsp_pipeline_job;
+  jp->jobarg  = (void *)bp;
+  chJobPostI(pp->config->jqp, jp);
+
+  return false;
+}
+
+#if (HAL_USE_ADC == TRUE) || defined(__DOXYGEN__)
+/**
+ * @brief   Posts the last completed half of an ADC circular buffer.
+ * @note    To be called from the end callback of a circular conversion
+ *          group, for both the half and the full buffer notifications.
+ *
+ * @param[in] pp        pointer to a @p dsp_pipeline_t object
+ * @param[in] adcp      pointer to the @p ADCDriver object
+ * @return              The operation status.
+ * @retval false        if the block has been posted.
+ * @retval true         if the block has been dropped.
+ *
+ * @iclass
+ */
+bool dspPipelinePostFromADCI(dsp_pipeline_t *pp, ADCDriver *adcp) {
+  size_t half = adcp->depth / 2U;
+  const dsp_adcsample_t *samples = adcp->samples;
+
+  chDbgCheck(pp->config->channels == (size_t)adcp->grpp->num_channels);
+
+  if (adcIsBufferComplete(adcp)) {
+    samples += half * (size_t)adcp->grpp->num_channels;
+  }
+
+  return dspPipelinePostI(pp, samples, half);
+}
+#endif
+
+/**
+ * @brief   Initializes a CIC decimator stage.
+ * @details The filter gain is <tt>ratio^order</tt>, it must fit 16 bits
+ *          in addition to the samples. A @p shift of
+ *          <tt>order*log2(ratio)</tt> gives unity gain.
+ *
+ * @param[out] cicp     pointer to a @p dsp_cic_t object
+ * @param[in] order     filter order, from 1 to @p ADC_DSP_CIC_MAX_ORDER
+ * @param[in] ratio     decimation ratio
+ * @param[in] shift     output right shift
+ *
+ * @init
+ */
+void dspCICObjectInit(dsp_cic_t *cicp, unsigned order,
+                      unsigned ratio, unsigned shift) {
+  unsigned k;
+
+  chDbgCheck((cicp != NULL) && (order >= 1U) &&
+             (order <= ADC_DSP_CIC_MAX_ORDER) && (ratio >= 1U) &&
+             (shift < 32U));
+
+  dsp_stage_init(&cicp->stage, dsp_cic_process);
+  cicp->order = order;
+  cicp->ratio = ratio;
+  cicp->shift = shift;
+  cicp->phase = ratio;
+  for (k = 0U; k < ADC_DSP_CIC_MAX_ORDER; k++) {
+    cicp->integ[k] = 0U;
+    cicp->comb[k]  = 0U;
+  }
+}
+
+/**
+ * @brief   Initializes a FIR decimator stage.
+ * @note    Linear phase filters are symmetric, the reversed order of the
+ *          coefficients does not matter for them.
+ *
+ * @param[out] firp     pointer to a @p dsp_fir_t object
+ * @param[in] coeffs    Q15 coefficients in reversed time order, the sum
+ *                      of their absolute values must not exceed one
+ * @param[in] taps      number of coefficients
+ * @param[in] ratio     decimation ratio, one for no decimation
+ * @param[in] history   history buffer
+ * @param[in] histsize  size of the history buffer in samples, see
+ *                      @p DSP_FIR_HISTORY_SIZE()
+ *
+ * @init
+ */
+void dspFIRObjectInit(dsp_fir_t *firp, const int16_t *coeffs,
+                      size_t taps, unsigned ratio,
+                      int16_t *history, size_t histsize) {
+
+  chDbgCheck((firp != NULL) && (coeffs != NULL) && (taps >= 1U) &&
+             (ratio >= 1U) && (history != NULL) && (histsize >= taps));
+
+  dsp_stage_init(&firp->stage, dsp_fir_process);
+  firp->coeffs   = coeffs;
+  firp->taps     = taps;
+  firp->ratio    = ratio;
+  firp->phase    = 0U;
+  firp->history  = history;
+  firp->histsize = histsize;
+  memset(history, 0, histsize * sizeof (int16_t));
+}
+
+/**
+ * @brief   Initializes a moving RMS stage.
+ * @details The window is @p hop * @p hops samples long, the callback is
+ *          invoked at the end of each hop with the updated value in the
+ *          @p rms field.
+ *
+ * @param[out] rmsp     pointer to a @p dsp_rms_t object
+ * @param[in] hop       samples in a hop
+ * @param[in] hops      hops in the window, from 1 to
+ *                      @p ADC_DSP_CFG_RMS_HOPS_MAX
+ *
+ * @init
+ */
+void dspRMSObjectInit(dsp_rms_t *rmsp, size_t hop, unsigned hops) {
+  unsigned i;
+
+  chDbgCheck((rmsp != NULL) && (hop >= 1U) && (hops >= 1U) &&
+             (hops <= ADC_DSP_CFG_RMS_HOPS_MAX));
+
+  dsp_stage_init(&rmsp->stage, dsp_rms_process);
+  rmsp->hop     = hop;
+  rmsp->hops    = hops;
+  rmsp->count   = 0U;
+  rmsp->partial = 0U;
+  rmsp->total   = 0U;
+  rmsp->index   = 0U;
+  rmsp->filled  = 0U;
+  rmsp->rms     = 0U;
+  for (i = 0U; i < ADC_DSP_CFG_RMS_HOPS_MAX; i++) {
+    rmsp->sums[i] = 0U;
+  }
+}
+
+/**
+ * @brief   Initializes a windowed min/max stage.
+ * @details The callback is invoked at the end of each window with the
+ *          results in the @p min and @p max fields.
+ *
+ * @param[out] mmp      pointer to a @p dsp_minmax_t object
+ * @param[in] window    samples in a window
+ *
+ * @init
+ */
+void dspMinMaxObjectInit(dsp_minmax_t *mmp, size_t window) {
+
+  chDbgCheck((mmp != NULL) && (window >= 1U));
+
+  dsp_stage_init(&mmp->stage, dsp_minmax_process);
+  mmp->window = window;
+  mmp->count  = 0U;
+  mmp->curmin = INT16_MAX;
+  mmp->curmax = INT16_MIN;
+  mmp->min    = 0;
+  mmp->max    = 0;
+}
+
+/**
+ * @brief   Initializes a threshold detector stage.
+ * @details The detector goes above when a sample reaches @p high and goes
+ *          back below when a sample reaches @p low, the callback is invoked
+ *          on each transition with the sample position in the
+ *          @p crossing field.
+ *
+ * @param[out] thp      pointer to a @p dsp_threshold_t object
+ * @param[in] high      rising threshold
+ * @param[in] low       falling threshold, lower than @p high
+ *
+ * @init
+ */
+void dspThresholdObjectInit(dsp_threshold_t *thp,
+                            int16_t high, int16_t low) {
+
+  chDbgCheck((thp != NULL) && (low < high));
+
+  dsp_stage_init(&thp->stage, dsp_threshold_process);
+  thp->high      = high;
+  thp->low       = low;
+  thp->above     = false;
+  thp->position  = 0U;
+  thp->crossing  = 0U;
+  thp->crossings = 0U;
+}
+
+/** @} */
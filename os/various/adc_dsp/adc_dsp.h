@@ -0,0 +1,496 @@
+/*
+    ChibiOS - Copyright (C) 2006..2018 Giovanni Di Sirio
+
+    Licensed under the Apache License, Version 2.0 (the "License");
+    you may not use this file except in compliance with the License.
+    You may obtain a copy of the License at
+
+        http://www.apache.org/licenses/LICENSE-2.0
+
+    Unless required by applicable law or agreed to in writing, software
+    distributed under the License is distributed on an "AS IS" BASIS,
+    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+    See the License for the specific language governing permissions and
+    limitations under the License.
+*/
+
+/**
+ * @file    adc_dsp.h
+ * @brief   ADC streaming DSP pipeline macros and structures.
+ *
+ * @addtogroup ADC_DSP
+ * @{
+ */
+
+#ifndef ADC_DSP_H
+#define ADC_DSP_H
+
+#include "ch.h"
+#include "hal.h"
+
+/*===========================================================================*/
+/* Module constants.                                                         */
+/*===========================================================================*/
+
+/**
+ * @brief   Maximum order of a CIC decimator.
+ */
+#define ADC_DSP_CIC_MAX_ORDER               4U
+
+/*===========================================================================*/
+/* Module pre-compile time settings.                                         */
+/*===========================================================================*/
+
+/**
+ * @name    ADC DSP configuration options
+ * @{
+ */
+/**
+ * @brief   Enables the SIMD kernels.
+ * @details If enabled the block kernels use the Cortex-M DSP extension
+ *          instructions or the SSE2 instructions, when available, else
+ *          portable C code is used.
+ */
+#if !defined(ADC_DSP_CFG_USE_SIMD) || defined(__DOXYGEN__)
+#define ADC_DSP_CFG_USE_SIMD                TRUE
+#endif
+
+/**
+ * @brief   Maximum number of hops in a moving RMS window.
+ */
+#if !defined(ADC_DSP_CFG_RMS_HOPS_MAX) || defined(__DOXYGEN__)
+#define ADC_DSP_CFG_RMS_HOPS_MAX            8U
+#endif
+/** @} */
+
+/*===========================================================================*/
+/* Derived constants and error checks.                                       */
+/*===========================================================================*/
+
+#if CH_CFG_USE_JOBS == FALSE
+#error "ADC_DSP requires CH_CFG_USE_JOBS"
+#endif
+
+#if ADC_DSP_CFG_RMS_HOPS_MAX < 1U
+#error "invalid ADC_DSP_CFG_RMS_HOPS_MAX value"
+#endif
+
+/**
+ * @brief   Kernels implementation selector.
+ */
+#if (ADC_DSP_CFG_USE_SIMD == TRUE) && defined(__ARM_FEATURE_DSP) &&        \
+    (__ARM_FEATURE_DSP == 1)
+#define ADC_DSP_SIMD_ARM                    TRUE
+#define ADC_DSP_SIMD_SSE2                   FALSE
+#elif (ADC_DSP_CFG_USE_SIMD == TRUE) && defined(__SSE2__)
+#define ADC_DSP_SIMD_ARM                    FALSE
+#define ADC_DSP_SIMD_SSE2                   TRUE
+#else
+#define ADC_DSP_SIMD_ARM                    FALSE
+#define ADC_DSP_SIMD_SSE2                   FALSE
+#endif
+
+/*===========================================================================*/
+/* Module data structures and types.                                         */
+/*===========================================================================*/
+
+/**
+ * @brief   Type of a raw sample fed to a pipeline.
+ */
+#if (HAL_USE_ADC == TRUE) || defined(__DOXYGEN__)
+typedef adcsample_t dsp_adcsample_t;
+#else
+typedef uint16_t dsp_adcsample_t;
+#endif
+
+/**
+ * @brief   Type of a processing stage.
+ */
+typedef struct dsp_stage dsp_stage_t;
+
+/**
+ * @brief   Type of a stage processing function.
+ * @details The function processes a block of samples in place, the
+ *          returned samples are passed to the next stage.
+ *
+ * @param[in] sp        pointer to the stage
+ * @param[in,out] buf   pointer to the samples block
+ * @param[in] n         number of samples in the block
+ * @return              The number of samples passed to the next stage,
+ *                      not greater than @p n.
+ */
+typedef size_t (*dsp_process_t)(dsp_stage_t *sp, int16_t *buf, size_t n);
+
+/**
+ * @brief   Type of a stage event callback.
+ * @note    Callbacks are invoked from the jobs thread, not from the ISR.
+ *
+ * @param[in] sp        pointer to the stage
+ */
+typedef void (*dsp_callback_t)(dsp_stage_t *sp);
+
+/**
+ * @brief   Structure representing a processing stage.
+ * @note    This structure is the first field of all the stages.
+ */
+struct dsp_stage {
+  /**
+   * @brief   Next stage in the pipeline or @p NULL.
+   */
+  dsp_stage_t               *next;
+  /**
+   * @brief   Processing function.
+   */
+  dsp_process_t             process;
+  /**
+   * @brief   Event callback or @p NULL.
+   */
+  dsp_callback_t            cb;
+  /**
+   * @brief   Application argument.
+   */
+  void                      *arg;
+};
+
+/**
+ * @brief   CIC decimator stage.
+ */
+typedef struct {
+  /**
+   * @brief   Base stage.
+   */
+  dsp_stage_t               stage;
+  /**
+   * @brief   Filter order.
+   */
+  unsigned                  order;
+  /**
+   * @brief   Decimation ratio.
+   */
+  unsigned                  ratio;
+  /**
+   * @brief   Right shift compensating the filter gain.
+   */
+  unsigned                  shift;
+  /**
+   * @brief   Input samples to the next output.
+   */
+  unsigned                  phase;
+  /**
+   * @brief   Integrators state.
+   */
+  uint32_t                  integ[ADC_DSP_CIC_MAX_ORDER];
+  /**
+   * @brief   Combs state.
+   */
+  uint32_t                  comb[ADC_DSP_CIC_MAX_ORDER];
+} dsp_cic_t;
+
+/**
+ * @brief   FIR decimator stage.
+ */
+typedef struct {
+  /**
+   * @brief   Base stage.
+   */
+  dsp_stage_t               stage;
+  /**
+   * @brief   Q15 coefficients in reversed time order.
+   */
+  const int16_t             *coeffs;
+  /**
+   * @brief   Number of coefficients.
+   */
+  size_t                    taps;
+  /**
+   * @brief   Decimation ratio.
+   */
+  unsigned                  ratio;
+  /**
+   * @brief   Input samples to the next output.
+   */
+  size_t                    phase;
+  /**
+   * @brief   History buffer, past samples followed by the current block.
+   */
+  int16_t                   *history;
+  /**
+   * @brief   Size of the history buffer in samples.
+   */
+  size_t                    histsize;
+} dsp_fir_t;
+
+/**
+ * @brief   Moving RMS stage.
+ * @details The RMS is computed over the last @p hops blocks of @p hop
+ *          samples and updated at the end of each hop.
+ */
+typedef struct {
+  /**
+   * @brief   Base stage.
+   */
+  dsp_stage_t               stage;
+  /**
+   * @brief   Samples in a hop.
+   */
+  size_t                    hop;
+  /**
+   * @brief   Hops in the window.
+   */
+  unsigned                  hops;
+  /**
+   * @brief   Samples accumulated in the current hop.
+   */
+  size_t                    count;
+  /**
+   * @brief   Squares sum of the current hop.
+   */
+  uint64_t                  partial;
+  /**
+   * @brief   Squares sums of the last hops.
+   */
+  uint64_t                  sums[ADC_DSP_CFG_RMS_HOPS_MAX];
+  /**
+   * @brief   Sum of @p sums.
+   */
+  uint64_t                  total;
+  /**
+   * @brief   Oldest hop index.
+   */
+  unsigned                  index;
+  /**
+   * @brief   Number of valid hops.
+   */
+  unsigned                  filled;
+  /**
+   * @brief   Last computed RMS value.
+   */
+  uint32_t                  rms;
+} dsp_rms_t;
+
+/**
+ * @brief   Windowed min/max stage.
+ */
+typedef struct {
+  /**
+   * @brief   Base stage.
+   */
+  dsp_stage_t               stage;
+  /**
+   * @brief   Samples in a window.
+   */
+  size_t                    window;
+  /**
+   * @brief   Samples accumulated in the current window.
+   */
+  size_t                    count;
+  /**
+   * @brief   Minimum in the current window.
+   */
+  int16_t                   curmin;
+  /**
+   * @brief   Maximum in the current window.
+   */
+  int16_t                   curmax;
+  /**
+   * @brief   Minimum of the last complete window.
+   */
+  int16_t                   min;
+  /**
+   * @brief   Maximum of the last complete window.
+   */
+  int16_t                   max;
+} dsp_minmax_t;
+
+/**
+ * @brief   Threshold detector stage with hysteresis.
+ */
+typedef struct {
+  /**
+   * @brief   Base stage.
+   */
+  dsp_stage_t               stage;
+  /**
+   * @brief   Rising threshold.
+   */
+  int16_t                   high;
+  /**
+   * @brief   Falling threshold.
+   */
+  int16_t                   low;
+  /**
+   * @brief   Current detector state.
+   */
+  bool                      above;
+  /**
+   * @brief   Samples processed so far.
+   */
+  uint64_t                  position;
+  /**
+   * @brief   Position of the last crossing.
+   */
+  uint64_t                  crossing;
+  /**
+   * @brief   Number of crossings.
+   */
+  uint32_t                  crossings;
+} dsp_threshold_t;
+
+/**
+ * @brief   Pipeline configuration structure.
+ */
+typedef struct {
+  /**
+   * @brief   Jobs queue executing the pipeline.
+   * @note    The queue must be served by a single thread, blocks of the
+   *          same pipeline must not be processed in parallel.
+   */
+  jobs_queue_t              *jqp;
+  /**
+   * @brief   Number of interleaved channels in the raw buffers.
+   */
+  size_t                    channels;
+  /**
+   * @brief   Processed channel.
+   */
+  size_t                    channel;
+  /**
+   * @brief   Offset subtracted from the raw samples.
+   */
+  int32_t                   offset;
+  /**
+   * @brief   Left shift applied after the offset, the result is saturated
+   *          to 16 bits.
+   */
+  unsigned                  shift;
+  /**
+   * @brief   Work buffer.
+   */
+  int16_t                   *work;
+  /**
+   * @brief   Size of the work buffer in samples.
+   * @note    Must not be lower than the samples per channel in a block.
+   */
+  size_t                    worksize;
+} dsp_pipeline_config_t;
+
+/**
+ * @brief   Type of a pipeline.
+ */
+typedef struct dsp_pipeline dsp_pipeline_t;
+
+/**
+ * @brief   Block of raw samples waiting for processing.
+ */
+typedef struct {
+  /**
+   * @brief   Owner pipeline.
+   */
+  dsp_pipeline_t            *pp;
+  /**
+   * @brief   Raw samples.
+   */
+  const dsp_adcsample_t     *samples;
+  /**
+   * @brief   Samples per channel.
+   */
+  size_t                    n;
+  /**
+   * @brief   The raw samples have not been consumed yet.
+   */
+  volatile bool             pending;
+} dsp_block_t;
+
+/**
+ * @brief   Structure representing a pipeline.
+ */
+struct dsp_pipeline {
+  /**
+   * @brief   Current configuration data.
+   */
+  const dsp_pipeline_config_t *config;
+  /**
+   * @brief   First stage or @p NULL.
+   */
+  dsp_stage_t               *first;
+  /**
+   * @brief   Blocks descriptors, one for each half of a circular buffer.
+   */
+  dsp_block_t               blocks[2];
+  /**
+   * @brief   Next block descriptor to be used.
+   */
+  unsigned                  next;
+  /**
+   * @brief   Number of processed blocks.
+   */
+  uint32_t                  processed;
+  /**
+   * @brief   Number of blocks dropped because the previous processing
+   *          was still ongoing or no job was available.
+   */
+  uint32_t                  overruns;
+};
+
+/*===========================================================================*/
+/* Module macros.                                                            */
+/*===========================================================================*/
+
+/**
+ * @brief   Size of a FIR history buffer.
+ *
+ * @param[in] taps      number of coefficients
+ * @param[in] n         maximum samples processed at once, larger blocks
+ *                      are processed in chunks
+ */
+#define DSP_FIR_HISTORY_SIZE(taps, n)       ((size_t)(taps) - 1U + (size_t)(n))
+
+/**
+ * @brief   Sets the event callback of a stage.
+ *
+ * @param[in] sp        pointer to a stage
+ * @param[in] callback  event callback or @p NULL
+ * @param[in] param     application argument
+ *
+ * @api
+ */
+#define dspStageSetCallback(sp, callback, param) do {                       \
+  ((dsp_stage_t *)(sp))->cb  = (callback);                                  \
+  ((dsp_stage_t *)(sp))->arg = (param);                                     \
+} while (false)
+
+/*===========================================================================*/
+/* External declarations.                                                    */
+/*===========================================================================*/
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+  void dspPipelineObjectInit(dsp_pipeline_t *pp,
+                             const dsp_pipeline_config_t *config);
+  void dspPipelineAddStage(dsp_pipeline_t *pp, dsp_stage_t *sp);
+  bool dspPipelinePostI(dsp_pipeline_t *pp,
+                        const dsp_adcsample_t *samples,
+                        size_t n);
+#if (HAL_USE_ADC == TRUE) || defined(__DOXYGEN__)
+  bool dspPipelinePostFromADCI(dsp_pipeline_t *pp, ADCDriver *adcp);
+#endif
+  void dspCICObjectInit(dsp_cic_t *cicp, unsigned order,
+                        unsigned ratio, unsigned shift);
+  void dspFIRObjectInit(dsp_fir_t *firp, const int16_t *coeffs,
+                        size_t taps, unsigned ratio,
+                        int16_t *history, size_t histsize);
+  void dspRMSObjectInit(dsp_rms_t *rmsp, size_t hop, unsigned hops);
+  void dspMinMaxObjectInit(dsp_minmax_t *mmp, size_t window);
+  void dspThresholdObjectInit(dsp_threshold_t *thp,
+                              int16_t high, int16_t low);
+  int32_t dsp_dot_q15(const int16_t *x, const int16_t *h, size_t n);
+  uint64_t dsp_sum_squares(const int16_t *x, size_t n);
+  void dsp_min_max(const int16_t *x, size_t n, int16_t *minp, int16_t *maxp);
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* ADC_DSP_H */
+
+/** @} */
@@ -0,0 +1,8 @@
+# ADC DSP pipeline files.
+ADCDSPSRC = $(CHIBIOS)/os/various/adc_dsp/adc_dsp.c
+
+ADCDSPINC = $(CHIBIOS)/os/various/adc_dsp
+
+# Shared variables
+ALLCSRC += $(ADCDSPSRC)
+ALLINC  += $(ADCDSPINC)
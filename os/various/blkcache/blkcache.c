@@ -0,0 +1,887 @@
+/*
+    ChibiOS - Copyright (C) 2006..2018 Giovanni Di Sirio
+
+    Licensed under the Apache License, Version 2.0 (the "License");
+    you may not use this file except in compliance with the License.
+    You may obtain a copy of the License at
+
+        http://www.apache.org/licenses/LICENSE-2.0
+
+    Unless required by applicable law or agreed to in writing, software
+    distributed under the License is distributed on an "AS IS" BASIS,
+    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+    See the License for the specific language governing permissions and
+    limitations under the License.
+*/
+
+/**
+ * @file    blkcache.c
+ * @brief   Block devices cache code.
+ * @details This module implements a @p BaseBlockDevice layered on top of
+ *          another block device and caching its blocks in RAM.<br>
+ *          Blocks are kept in an objects cache (see @p chobjcaches.c),
+ *          the least recently used blocks are recycled first.<br>
+ *          Writes are performed in write-back mode, modified blocks are
+ *          written on the underlying device when recycled or when a
+ *          synchronization is requested using @p blkSync(), contiguous
+ *          modified blocks are written using a single transfer.<br>
+ *          Read misses on sequential accesses fetch multiple blocks from
+ *          the underlying device using a single transfer (read-ahead),
+ *          multiple interleaved sequential streams are detected.<br>
+ *          Large transfers can bypass the cache in order to not pollute it
+ *          with data unlikely to be accessed again.
+ *
+ * @addtogroup BLKCACHE
+ * @{
+ */
+
+#include <string.h>
+
+#include "blkcache.h"
+
+/*===========================================================================*/
+/* Module local definitions.                                                 */
+/*===========================================================================*/
+
+/* Objects group used for all blocks.*/
+#define BLKCACHE_GROUP                      0U
+
+/* Returns the driver owning an objects cache.*/
+#define bcache_from_cache(ocp)                                              \
+  ((BlockCacheDriver *)(void *)((uint8_t *)(ocp) -                          \
+                                offsetof(BlockCacheDriver, cache)))
+
+/*===========================================================================*/
+/* Module exported variables.                                                */
+/*===========================================================================*/
+
+/*===========================================================================*/
+/* Module local types.                                                       */
+/*===========================================================================*/
+
+/*===========================================================================*/
+/* Module local variables.                                                   */
+/*===========================================================================*/
+
+/* Forward declarations required by bcache_vmt.*/
+static bool bcache_is_inserted(void *instance);
+static bool bcache_is_protected(void *instance);
+static bool bcache_connect(void *instance);
+static bool bcache_disconnect(void *instance);
+static bool bcache_read(void *instance, uint32_t startblk,
+                        uint8_t *buffer, uint32_t n);
+static bool bcache_write(void *instance, uint32_t startblk,
+                         const uint8_t *buffer, uint32_t n);
+static bool bcache_sync(void *instance);
+static bool bcache_get_info(void *instance, BlockDeviceInfo *bdip);
+
+/**
+ * @brief   Virtual methods table.
+ */
+static const struct BlockCacheDriverVMT bcache_vmt = {
+  (size_t)0,
+  bcache_is_inserted,
+  bcache_is_protected,
+  bcache_connect,
+  bcache_disconnect,
+  bcache_read,
+  bcache_write,
+  bcache_sync,
+  bcache_get_info
+};
+
+/*===========================================================================*/
+/* Module local functions.                                                   */
+/*===========================================================================*/
+
+/**
+ * @brief   Returns the modified cached block having the specified key.
+ * @note    Objects flags can be inspected without locking because all
+ *          cache operations are serialized by the driver mutex.
+ *
+ * @param[in] bcdp      pointer to the @p BlockCacheDriver object
+ * @param[in] key       block number
+ * @return              The object or @p NULL if the block is not cached
+ *                      or not modified.
+ *
+ * @notapi
+ */
+static oc_object_t *bcache_find_modified(BlockCacheDriver *bcdp,
+                                         uint32_t key) {
+  const BlockCacheConfig *config = bcdp->config;
+  ucnt_t i;
+
+  for (i = (ucnt_t)0; i < config->objn; i++) {
+    oc_object_t *objp = &config->objp[i];
+
+    if (((objp->obj_flags & OC_FLAG_LAZYWRITE) != 0U) &&
+        (objp->obj_key == key)) {
+      return objp;
+    }
+  }
+
+  return NULL;
+}
+
+/**
+ * @brief   Writes a block together with the following modified blocks.
+ * @details The modified blocks contiguous to @p objp are gathered in the
+ *          staging buffer and written using a single transfer, those are
+ *          marked as clean and queued for early recycling.
+ * @note    The staging buffer is not used while a read-ahead is in
+ *          progress, the block is written alone.
+ *
+ * @param[in] bcdp      pointer to the @p BlockCacheDriver object
+ * @param[in] objp      pointer to the block object, owned by the caller
+ * @param[in] max       maximum number of blocks to be written
+ * @param[out] np       number of blocks in the transfer
+ * @return              The operation status.
+ * @retval HAL_SUCCESS  if the operation succeeded.
+ * @retval HAL_FAILED   if the operation failed, the following blocks are
+ *                      kept as modified.
+ *
+ * @notapi
+ */
+static bool bcache_write_cluster(BlockCacheDriver *bcdp,
+                                 oc_object_t *objp,
+                                 uint32_t max,
+                                 uint32_t *np) {
+  const BlockCacheConfig *config = bcdp->config;
+  uint32_t key = objp->obj_key;
+  uint32_t i, n;
+  bool err;
+
+  if ((config->rablocks <= 1U) || bcdp->rabusy) {
+    max = 1U;
+  }
+  else if (max > config->rablocks) {
+    max = config->rablocks;
+  }
+
+  /* Gathering the following modified blocks.*/
+  for (n = 1U; n < max; n++) {
+    oc_object_t *nextp = bcache_find_modified(bcdp, key + n);
+
+    if (nextp == NULL) {
+      break;
+    }
+    if (n == 1U) {
+      memcpy((void *)config->rabufp, objp->dptr, bcdp->blksize);
+    }
+    memcpy((void *)&config->rabufp[n * bcdp->blksize],
+           nextp->dptr, bcdp->blksize);
+  }
+
+  if (n == 1U) {
+    err = blkWrite(config->bdp, key, (const uint8_t *)objp->dptr, 1U);
+  }
+  else {
+    err = blkWrite(config->bdp, key, config->rabufp, n);
+  }
+  *np = n;
+
+  if (err != HAL_SUCCESS) {
+    bcdp->stats.errors++;
+    return HAL_FAILED;
+  }
+
+  bcdp->stats.writebacks += n;
+  bcdp->stats.transfers++;
+
+  /* The gathered blocks are clean now, cache hits for sure.*/
+  for (i = 1U; i < n; i++) {
+    oc_object_t *nextp;
+
+    nextp = chCacheGetObject(&bcdp->cache, BLKCACHE_GROUP, key + i);
+    nextp->obj_flags &= ~OC_FLAG_LAZYWRITE;
+    nextp->obj_flags |= OC_FLAG_FORGET;
+    chCacheReleaseObject(&bcdp->cache, nextp);
+  }
+
+  return HAL_SUCCESS;
+}
+
+/**
+ * @brief   Cached block reader function.
+ *
+ * @param[in] ocp       pointer to the @p objects_cache_t structure
+ * @param[in] objp      pointer to the @p oc_object_t structure
+ * @param[in] async     the object is released after the operation
+ * @return              The operation status.
+ *
+ * @notapi
+ */
+static bool bcache_readf(objects_cache_t *ocp,
+                         oc_object_t *objp,
+                         bool async) {
+  BlockCacheDriver *bcdp = bcache_from_cache(ocp);
+  bool err;
+
+  err = blkRead(bcdp->config->bdp, objp->obj_key, (uint8_t *)objp->dptr, 1U);
+  if (err == HAL_SUCCESS) {
+    objp->obj_flags &= ~OC_FLAG_NOTSYNC;
+  }
+  else {
+    bcdp->stats.errors++;
+  }
+
+  if (async) {
+    chCacheReleaseObject(ocp, objp);
+    return HAL_SUCCESS;
+  }
+
+  return err;
+}
+
+/**
+ * @brief   Cached block writer function.
+ * @note    Errors happening during asynchronous writes (blocks recycling)
+ *          cannot be reported to the caller, those are latched and
+ *          reported by the next synchronization.
+ *
+ * @param[in] ocp       pointer to the @p objects_cache_t structure
+ * @param[in] objp      pointer to the @p oc_object_t structure
+ * @param[in] async     the object is released after the operation
+ * @return              The operation status.
+ *
+ * @notapi
+ */
+static bool bcache_writef(objects_cache_t *ocp,
+                          oc_object_t *objp,
+                          bool async) {
+  BlockCacheDriver *bcdp = bcache_from_cache(ocp);
+  uint32_t n;
+  bool err;
+
+  err = bcache_write_cluster(bcdp, objp, bcdp->blknum - objp->obj_key, &n);
+
+  if (async) {
+    if (err != HAL_SUCCESS) {
+      bcdp->wbfailed = true;
+    }
+    chCacheReleaseObject(ocp, objp);
+    return HAL_SUCCESS;
+  }
+
+  return err;
+}
+
+/**
+ * @brief   Returns the tracked stream continued by a read operation.
+ *
+ * @param[in] bcdp      pointer to the @p BlockCacheDriver object
+ * @param[in] startblk  first block of the read operation
+ * @return              The stream index.
+ * @retval -1           if the operation does not continue a stream.
+ *
+ * @notapi
+ */
+static int bcache_find_stream(BlockCacheDriver *bcdp, uint32_t startblk) {
+  unsigned i;
+
+  for (i = 0U; i < BLKCACHE_CFG_STREAMS; i++) {
+    if (bcdp->nextblk[i] == startblk) {
+      return (int)i;
+    }
+  }
+
+  return -1;
+}
+
+/**
+ * @brief   Updates the tracked streams after a read operation.
+ * @note    Reads not continuing a stream replace the oldest one.
+ *
+ * @param[in] bcdp      pointer to the @p BlockCacheDriver object
+ * @param[in] stream    stream continued by the operation or -1
+ * @param[in] nextblk   block following the read operation
+ *
+ * @notapi
+ */
+static void bcache_update_stream(BlockCacheDriver *bcdp,
+                                 int stream, uint32_t nextblk) {
+
+  if (stream < 0) {
+    stream = (int)bcdp->nextstream;
+    bcdp->nextstream = (bcdp->nextstream + 1U) % BLKCACHE_CFG_STREAMS;
+  }
+  bcdp->nextblk[stream] = nextblk;
+}
+
+/**
+ * @brief   Resets the cache content.
+ * @note    Modified blocks are discarded.
+ *
+ * @param[in] bcdp      pointer to the @p BlockCacheDriver object
+ *
+ * @notapi
+ */
+static void bcache_reset(BlockCacheDriver *bcdp) {
+  const BlockCacheConfig *config = bcdp->config;
+  ucnt_t i;
+
+  chCacheObjectInit(&bcdp->cache,
+                    config->hashn, config->hashp,
+                    config->objn, sizeof (oc_object_t), config->objp,
+                    bcache_readf, bcache_writef);
+
+  /* Associating a block buffer to each object.*/
+  for (i = (ucnt_t)0; i < config->objn; i++) {
+    config->objp[i].dptr = (void *)&config->bufp[i * BLKCACHE_CFG_BLOCK_SIZE];
+  }
+
+  /* Forgetting the tracked streams.*/
+  for (i = (ucnt_t)0; i < (ucnt_t)BLKCACHE_CFG_STREAMS; i++) {
+    bcdp->nextblk[i] = 0U;
+  }
+  bcdp->nextstream = 0U;
+  bcdp->rabusy     = false;
+  bcdp->wbfailed   = false;
+}
+
+/**
+ * @brief   Writes back the modified blocks within a range.
+ * @details Contiguous modified blocks are written using a single transfer.
+ *
+ * @param[in] bcdp      pointer to the @p BlockCacheDriver object
+ * @param[in] startblk  first block of the range
+ * @param[in] n         number of blocks in the range
+ * @return              The operation status.
+ * @retval HAL_SUCCESS  if the operation succeeded.
+ * @retval HAL_FAILED   if one or more write operations failed, the
+ *                      blocks are kept as modified.
+ *
+ * @notapi
+ */
+static bool bcache_writeback_range(BlockCacheDriver *bcdp,
+                                   uint32_t startblk, uint32_t n) {
+  const BlockCacheConfig *config = bcdp->config;
+  bool err = HAL_SUCCESS;
+
+  while (n > 0U) {
+    oc_object_t *objp = NULL;
+    uint32_t key, done;
+    ucnt_t i;
+
+    /* Searching the first modified block within the range.*/
+    for (i = (ucnt_t)0; i < config->objn; i++) {
+      oc_object_t *p = &config->objp[i];
+
+      if (((p->obj_flags & OC_FLAG_LAZYWRITE) != 0U) &&
+          ((p->obj_key - startblk) < n) &&
+          ((objp == NULL) || (p->obj_key < objp->obj_key))) {
+        objp = p;
+      }
+    }
+    if (objp == NULL) {
+      break;
+    }
+
+    /* Cache hit for sure, the object is the same.*/
+    key  = objp->obj_key;
+    objp = chCacheGetObject(&bcdp->cache, BLKCACHE_GROUP, key);
+    objp->obj_flags &= ~OC_FLAG_LAZYWRITE;
+    if (bcache_write_cluster(bcdp, objp, n - (key - startblk),
+                             &done) != HAL_SUCCESS) {
+      objp->obj_flags |= OC_FLAG_LAZYWRITE;
+      err = HAL_FAILED;
+    }
+    chCacheReleaseObject(&bcdp->cache, objp);
+
+    /* Continuing after the written blocks.*/
+    n       -= (key - startblk) + done;
+    startblk = key + done;
+  }
+
+  return err;
+}
+
+/**
+ * @brief   Writes back all the modified blocks.
+ * @note    A write-back failure latched while recycling blocks is reported
+ *          and cleared.
+ *
+ * @param[in] bcdp      pointer to the @p BlockCacheDriver object
+ * @return              The operation status.
+ * @retval HAL_SUCCESS  if the operation succeeded.
+ * @retval HAL_FAILED   if one or more write operations failed.
+ *
+ * @notapi
+ */
+static bool bcache_writeback_all(BlockCacheDriver *bcdp) {
+  bool err;
+
+  err = bcache_writeback_range(bcdp, 0U, bcdp->blknum);
+  if (bcdp->wbfailed) {
+    bcdp->wbfailed = false;
+    err = HAL_FAILED;
+  }
+
+  return err;
+}
+
+/**
+ * @brief   Invalidates the cached blocks within a range.
+ * @note    Modified blocks are discarded.
+ *
+ * @param[in] bcdp      pointer to the @p BlockCacheDriver object
+ * @param[in] startblk  first block of the range
+ * @param[in] n         number of blocks in the range
+ *
+ * @notapi
+ */
+static void bcache_invalidate_range(BlockCacheDriver *bcdp,
+                                    uint32_t startblk, uint32_t n) {
+  const BlockCacheConfig *config = bcdp->config;
+  ucnt_t i;
+
+  for (i = (ucnt_t)0; i < config->objn; i++) {
+    oc_object_t *objp = &config->objp[i];
+
+    if (((objp->obj_flags & OC_FLAG_INHASH) != 0U) &&
+        ((objp->obj_key - startblk) < n)) {
+
+      /* Releasing it as not in sync removes it from the cache.*/
+      objp = chCacheGetObject(&bcdp->cache, BLKCACHE_GROUP, objp->obj_key);
+      objp->obj_flags = OC_FLAG_INHASH | OC_FLAG_NOTSYNC;
+      chCacheReleaseObject(&bcdp->cache, objp);
+    }
+  }
+}
+
+/**
+ * @brief   Fills a missing block using a read-ahead transfer.
+ * @details The missing block and the following ones are read using a
+ *          single transfer, the following blocks are inserted in cache
+ *          unless already present.
+ *
+ * @param[in] bcdp      pointer to the @p BlockCacheDriver object
+ * @param[in] objp      pointer to the missing block object, owned by
+ *                      the caller
+ * @return              The operation status.
+ * @retval HAL_SUCCESS  if the operation succeeded.
+ * @retval HAL_FAILED   if the operation failed.
+ *
+ * @notapi
+ */
+static bool bcache_readahead(BlockCacheDriver *bcdp, oc_object_t *objp) {
+  const BlockCacheConfig *config = bcdp->config;
+  uint32_t startblk = objp->obj_key;
+  uint32_t i, n;
+
+  /* Not crossing the device end and not recycling the whole cache, note,
+     one object is owned by the caller.*/
+  n = config->rablocks;
+  if (n > (uint32_t)config->objn - 1U) {
+    n = (uint32_t)config->objn - 1U;
+  }
+  if (n > bcdp->blknum - startblk) {
+    n = bcdp->blknum - startblk;
+  }
+
+  if (blkRead(config->bdp, startblk, config->rabufp, n) != HAL_SUCCESS) {
+    bcdp->stats.errors++;
+    return HAL_FAILED;
+  }
+
+  /* The staging buffer is in use until the end of the operation, blocks
+     recycled meanwhile are written alone.*/
+  bcdp->rabusy = true;
+
+  /* The requested block.*/
+  memcpy(objp->dptr, (const void *)config->rabufp, bcdp->blksize);
+  objp->obj_flags &= ~OC_FLAG_NOTSYNC;
+
+  /* Following blocks, cached copies are not replaced because those could
+     have been modified.*/
+  for (i = 1U; i < n; i++) {
+    oc_object_t *raobjp;
+
+    raobjp = chCacheGetObject(&bcdp->cache, BLKCACHE_GROUP, startblk + i);
+    if ((raobjp->obj_flags & OC_FLAG_NOTSYNC) != 0U) {
+      memcpy(raobjp->dptr,
+             (const void *)&config->rabufp[i * bcdp->blksize],
+             bcdp->blksize);
+      raobjp->obj_flags &= ~OC_FLAG_NOTSYNC;
+      bcdp->stats.prefetched++;
+    }
+    chCacheReleaseObject(&bcdp->cache, raobjp);
+  }
+  bcdp->rabusy = false;
+
+  return HAL_SUCCESS;
+}
+
+static bool bcache_is_inserted(void *instance) {
+  BlockCacheDriver *bcdp = (BlockCacheDriver *)instance;
+
+  return blkIsInserted(bcdp->config->bdp);
+}
+
+static bool bcache_is_protected(void *instance) {
+  BlockCacheDriver *bcdp = (BlockCacheDriver *)instance;
+
+  return blkIsWriteProtected(bcdp->config->bdp);
+}
+
+static bool bcache_connect(void *instance) {
+  BlockCacheDriver *bcdp = (BlockCacheDriver *)instance;
+  BaseBlockDevice *bdp = bcdp->config->bdp;
+  BlockDeviceInfo bdi;
+  bool err = HAL_FAILED;
+
+  chMtxLock(&bcdp->mtx);
+
+  osalDbgAssert((bcdp->state == BLK_ACTIVE) || (bcdp->state == BLK_READY),
+                "invalid state");
+
+  bcdp->state = BLK_CONNECTING;
+
+  do {
+    if ((blkGetDriverState(bdp) != BLK_READY) &&
+        (blkConnect(bdp) != HAL_SUCCESS)) {
+      break;
+    }
+
+    if ((blkGetInfo(bdp, &bdi) != HAL_SUCCESS) ||
+        (bdi.blk_size > BLKCACHE_CFG_BLOCK_SIZE)) {
+      break;
+    }
+
+    /* The media could have been replaced, starting with an empty cache.*/
+    bcdp->blksize = bdi.blk_size;
+    bcdp->blknum  = bdi.blk_num;
+    bcache_reset(bcdp);
+
+    err = HAL_SUCCESS;
+  } while (false);
+
+  bcdp->state = err == HAL_SUCCESS ? BLK_READY : BLK_ACTIVE;
+
+  chMtxUnlock(&bcdp->mtx);
+
+  return err;
+}
+
+static bool bcache_disconnect(void *instance) {
+  BlockCacheDriver *bcdp = (BlockCacheDriver *)instance;
+  bool err;
+
+  chMtxLock(&bcdp->mtx);
+
+  osalDbgAssert((bcdp->state == BLK_ACTIVE) || (bcdp->state == BLK_READY),
+                "invalid state");
+
+  if (bcdp->state == BLK_ACTIVE) {
+    chMtxUnlock(&bcdp->mtx);
+    return HAL_SUCCESS;
+  }
+
+  bcdp->state = BLK_DISCONNECTING;
+
+  /* Modified blocks must reach the media before disconnecting.*/
+  err = bcache_writeback_all(bcdp);
+  if (blkDisconnect(bcdp->config->bdp) != HAL_SUCCESS) {
+    err = HAL_FAILED;
+  }
+
+  bcdp->state = BLK_ACTIVE;
+
+  chMtxUnlock(&bcdp->mtx);
+
+  return err;
+}
+
+static bool bcache_read(void *instance, uint32_t startblk,
+                        uint8_t *buffer, uint32_t n) {
+  BlockCacheDriver *bcdp = (BlockCacheDriver *)instance;
+  const BlockCacheConfig *config = bcdp->config;
+  bool err = HAL_SUCCESS;
+  int stream;
+
+  chMtxLock(&bcdp->mtx);
+
+  if (bcdp->state != BLK_READY) {
+    chMtxUnlock(&bcdp->mtx);
+    return HAL_FAILED;
+  }
+
+  bcdp->state = BLK_READING;
+  stream = bcache_find_stream(bcdp, startblk);
+
+  if ((config->bypass > 0U) && (n >= config->bypass)) {
+    /* Large transfer, modified blocks in the range are written back then
+       data is read directly into the caller buffer.*/
+    err = bcache_writeback_range(bcdp, startblk, n);
+    if (err == HAL_SUCCESS) {
+      err = blkRead(config->bdp, startblk, buffer, n);
+      if (err == HAL_SUCCESS) {
+        bcdp->stats.bypassed += n;
+      }
+      else {
+        bcdp->stats.errors++;
+      }
+    }
+    startblk += n;
+  }
+  else {
+    while (n > 0U) {
+      oc_object_t *objp;
+
+      objp = chCacheGetObject(&bcdp->cache, BLKCACHE_GROUP, startblk);
+      if ((objp->obj_flags & OC_FLAG_NOTSYNC) == 0U) {
+        bcdp->stats.hits++;
+      }
+      else {
+        bcdp->stats.misses++;
+
+        /* Read-ahead is triggered by sequential accesses and by multi-block
+           transfers.*/
+        if ((config->rablocks > 1U) && ((stream >= 0) || (n > 1U))) {
+          err = bcache_readahead(bcdp, objp);
+        }
+        else {
+          err = chCacheReadObject(&bcdp->cache, objp, false);
+        }
+
+        if (err != HAL_SUCCESS) {
+          /* Still marked as not in sync, releasing it discards it.*/
+          chCacheReleaseObject(&bcdp->cache, objp);
+          break;
+        }
+      }
+
+      memcpy((void *)buffer, objp->dptr, bcdp->blksize);
+      chCacheReleaseObject(&bcdp->cache, objp);
+
+      buffer += bcdp->blksize;
+      startblk++;
+      n--;
+    }
+  }
+
+  bcache_update_stream(bcdp, stream, startblk);
+  bcdp->state = BLK_READY;
+
+  chMtxUnlock(&bcdp->mtx);
+
+  return err;
+}
+
+static bool bcache_write(void *instance, uint32_t startblk,
+                         const uint8_t *buffer, uint32_t n) {
+  BlockCacheDriver *bcdp = (BlockCacheDriver *)instance;
+  const BlockCacheConfig *config = bcdp->config;
+  bool err = HAL_SUCCESS;
+
+  chMtxLock(&bcdp->mtx);
+
+  if (bcdp->state != BLK_READY) {
+    chMtxUnlock(&bcdp->mtx);
+    return HAL_FAILED;
+  }
+
+  bcdp->state = BLK_WRITING;
+
+  if ((config->bypass > 0U) && (n >= config->bypass)) {
+    /* Large transfer, data is written directly then the cached copies
+       are discarded because stale.*/
+    err = blkWrite(config->bdp, startblk, buffer, n);
+    if (err == HAL_SUCCESS) {
+      bcdp->stats.bypassed += n;
+    }
+    else {
+      bcdp->stats.errors++;
+    }
+    bcache_invalidate_range(bcdp, startblk, n);
+  }
+  else {
+    while (n > 0U) {
+      oc_object_t *objp;
+
+      /* Whole blocks are written, there is no need to read the block
+         if missing.*/
+      objp = chCacheGetObject(&bcdp->cache, BLKCACHE_GROUP, startblk);
+      memcpy(objp->dptr, (const void *)buffer, bcdp->blksize);
+      objp->obj_flags &= ~OC_FLAG_NOTSYNC;
+      objp->obj_flags |= OC_FLAG_LAZYWRITE;
+      chCacheReleaseObject(&bcdp->cache, objp);
+
+      buffer += bcdp->blksize;
+      startblk++;
+      n--;
+    }
+  }
+
+  bcdp->state = BLK_READY;
+
+  chMtxUnlock(&bcdp->mtx);
+
+  return err;
+}
+
+static bool bcache_sync(void *instance) {
+  BlockCacheDriver *bcdp = (BlockCacheDriver *)instance;
+  bool err;
+
+  chMtxLock(&bcdp->mtx);
+
+  if (bcdp->state != BLK_READY) {
+    chMtxUnlock(&bcdp->mtx);
+    return HAL_FAILED;
+  }
+
+  bcdp->state = BLK_SYNCING;
+
+  err = bcache_writeback_all(bcdp);
+  if (blkSync(bcdp->config->bdp) != HAL_SUCCESS) {
+    err = HAL_FAILED;
+  }
+
+  bcdp->state = BLK_READY;
+
+  chMtxUnlock(&bcdp->mtx);
+
+  return err;
+}
+
+static bool bcache_get_info(void *instance, BlockDeviceInfo *bdip) {
+  BlockCacheDriver *bcdp = (BlockCacheDriver *)instance;
+
+  if (bcdp->state != BLK_READY) {
+    return HAL_FAILED;
+  }
+
+  bdip->blk_size = bcdp->blksize;
+  bdip->blk_num  = bcdp->blknum;
+
+  return HAL_SUCCESS;
+}
+
+/*===========================================================================*/
+/* Module exported functions.                                                */
+/*===========================================================================*/
+
+/**
+ * @brief   Initializes an instance.
+ *
+ * @param[out] bcdp     pointer to the @p BlockCacheDriver object
+ *
+ * @init
+ */
+void bcacheObjectInit(BlockCacheDriver *bcdp) {
+
+  bcdp->vmt     = &bcache_vmt;
+  bcdp->state   = BLK_STOP;
+  bcdp->config  = NULL;
+  bcdp->blksize = 0U;
+  bcdp->blknum  = 0U;
+  chMtxObjectInit(&bcdp->mtx);
+  bcacheResetStats(bcdp);
+}
+
+/**
+ * @brief   Configures and activates the block cache.
+ * @note    The underlying block device must have been started, the
+ *          connection is performed by @p blkConnect() on the cache.
+ *
+ * @param[in] bcdp      pointer to the @p BlockCacheDriver object
+ * @param[in] config    pointer to the @p BlockCacheConfig object
+ * @return              The operation status.
+ *
+ * @api
+ */
+msg_t bcacheStart(BlockCacheDriver *bcdp, const BlockCacheConfig *config) {
+
+  osalDbgCheck((bcdp != NULL) && (config != NULL) &&
+               (config->bdp != NULL) && (config->bufp != NULL) &&
+               (config->objn >= (ucnt_t)2) &&
+               ((config->rablocks <= 1U) || (config->rabufp != NULL)));
+  osalDbgAssert((bcdp->state == BLK_STOP) || (bcdp->state == BLK_ACTIVE),
+                "invalid state");
+
+  chMtxLock(&bcdp->mtx);
+
+  bcdp->config = config;
+  bcache_reset(bcdp);
+  bcdp->state  = BLK_ACTIVE;
+
+  chMtxUnlock(&bcdp->mtx);
+
+  return HAL_RET_SUCCESS;
+}
+
+/**
+ * @brief   Deactivates the block cache.
+ * @note    The cache must be disconnected, modified blocks are written
+ *          back by @p blkDisconnect().
+ *
+ * @param[in] bcdp      pointer to the @p BlockCacheDriver object
+ *
+ * @api
+ */
+void bcacheStop(BlockCacheDriver *bcdp) {
+
+  osalDbgCheck(bcdp != NULL);
+  osalDbgAssert((bcdp->state == BLK_STOP) || (bcdp->state == BLK_ACTIVE),
+                "invalid state");
+
+  chMtxLock(&bcdp->mtx);
+
+  bcdp->config = NULL;
+  bcdp->state  = BLK_STOP;
+
+  chMtxUnlock(&bcdp->mtx);
+}
+
+/**
+ * @brief   Writes back all the modified blocks.
+ * @note    Unlike @p blkSync() the underlying device is not synchronized.
+ *
+ * @param[in] bcdp      pointer to the @p BlockCacheDriver object
+ * @return              The operation status.
+ * @retval HAL_SUCCESS  if the operation succeeded.
+ * @retval HAL_FAILED   if the operation failed.
+ *
+ * @api
+ */
+bool bcacheFlush(BlockCacheDriver *bcdp) {
+  bool err;
+
+  osalDbgCheck(bcdp != NULL);
+
+  chMtxLock(&bcdp->mtx);
+
+  if (bcdp->state != BLK_READY) {
+    chMtxUnlock(&bcdp->mtx);
+    return HAL_FAILED;
+  }
+
+  err = bcache_writeback_all(bcdp);
+
+  chMtxUnlock(&bcdp->mtx);
+
+  return err;
+}
+
+/**
+ * @brief   Resets the driver statistics.
+ *
+ * @param[in] bcdp      pointer to the @p BlockCacheDriver object
+ *
+ * @api
+ */
+void bcacheResetStats(BlockCacheDriver *bcdp) {
+
+  osalDbgCheck(bcdp != NULL);
+
+  bcdp->stats.hits       = 0U;
+  bcdp->stats.misses     = 0U;
+  bcdp->stats.prefetched = 0U;
+  bcdp->stats.writebacks = 0U;
+  bcdp->stats.transfers  = 0U;
+  bcdp->stats.bypassed   = 0U;
+  bcdp->stats.errors     = 0U;
+}
+
+/** @} */
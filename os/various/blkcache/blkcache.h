@@ -0,0 +1,292 @@
+/*
+    ChibiOS - Copyright (C) 2006..2018 Giovanni Di Sirio
+
+    Licensed under the Apache License, Version 2.0 (the "License");
+    you may not use this file except in compliance with the License.
+    You may obtain a copy of the License at
+
+        http://www.apache.org/licenses/LICENSE-2.0
+
+    Unless required by applicable law or agreed to in writing, software
+    distributed under the License is distributed on an "AS IS" BASIS,
+    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+    See the License for the specific language governing permissions and
+    limitations under the License.
+*/
+
+/**
+ * @file    blkcache.h
+ * @brief   Block devices cache macros and structures.
+ *
+ * @addtogroup BLKCACHE
+ * @{
+ */
+
+#ifndef BLKCACHE_H
+#define BLKCACHE_H
+
+#include "ch.h"
+#include "hal.h"
+
+/*===========================================================================*/
+/* Module constants.                                                         */
+/*===========================================================================*/
+
+/*===========================================================================*/
+/* Module pre-compile time settings.                                         */
+/*===========================================================================*/
+
+/**
+ * @name    Block cache configuration options
+ * @{
+ */
+/**
+ * @brief   Maximum size of a cached block.
+ * @note    Must be a power of two.
+ * @note    The underlying block device must have a block size not greater
+ *          than this value.
+ */
+#if !defined(BLKCACHE_CFG_BLOCK_SIZE) || defined(__DOXYGEN__)
+#define BLKCACHE_CFG_BLOCK_SIZE             512U
+#endif
+
+/**
+ * @brief   Number of tracked sequential read streams.
+ * @details Read misses continuing one of the tracked streams trigger a
+ *          read-ahead, multiple streams allow to detect sequential accesses
+ *          interleaved with other accesses, FAT lookups for example.
+ */
+#if !defined(BLKCACHE_CFG_STREAMS) || defined(__DOXYGEN__)
+#define BLKCACHE_CFG_STREAMS                4U
+#endif
+/** @} */
+
+/*===========================================================================*/
+/* Derived constants and error checks.                                       */
+/*===========================================================================*/
+
+#if CH_CFG_USE_OBJ_CACHES == FALSE
+#error "BLKCACHE requires CH_CFG_USE_OBJ_CACHES"
+#endif
+
+#if CH_CFG_USE_MUTEXES == FALSE
+#error "BLKCACHE requires CH_CFG_USE_MUTEXES"
+#endif
+
+#if (BLKCACHE_CFG_BLOCK_SIZE & (BLKCACHE_CFG_BLOCK_SIZE - 1U)) != 0U
+#error "BLKCACHE_CFG_BLOCK_SIZE must be a power of two"
+#endif
+
+#if BLKCACHE_CFG_STREAMS < 1U
+#error "invalid BLKCACHE_CFG_STREAMS value"
+#endif
+
+/*===========================================================================*/
+/* Module data structures and types.                                         */
+/*===========================================================================*/
+
+/**
+ * @brief   Block cache configuration structure.
+ * @note    All the buffers are statically allocated by the application,
+ *          the macros @p BLKCACHE_BUFFER_SIZE() and
+ *          @p BLKCACHE_RA_BUFFER_SIZE() help dimensioning them.
+ */
+typedef struct {
+  /**
+   * @brief   Underlying block device.
+   */
+  BaseBlockDevice           *bdp;
+  /**
+   * @brief   Number of elements in the hash table, must be a power of two
+   *          and not lower than @p objn.
+   */
+  ucnt_t                    hashn;
+  /**
+   * @brief   Pointer to the hash table.
+   */
+  oc_hash_header_t          *hashp;
+  /**
+   * @brief   Number of cached blocks.
+   */
+  ucnt_t                    objn;
+  /**
+   * @brief   Pointer to an array of @p objn cache objects.
+   */
+  oc_object_t               *objp;
+  /**
+   * @brief   Pointer to the blocks buffer.
+   * @note    Must be @p BLKCACHE_BUFFER_SIZE(objn) bytes large.
+   */
+  uint8_t                   *bufp;
+  /**
+   * @brief   Number of blocks fetched on sequential read misses.
+   * @note    Zero disables the read-ahead.
+   */
+  uint32_t                  rablocks;
+  /**
+   * @brief   Pointer to the read-ahead staging buffer.
+   * @details The buffer is also used to gather contiguous modified blocks
+   *          written back using a single transfer.
+   * @note    Must be @p BLKCACHE_RA_BUFFER_SIZE(rablocks) bytes large,
+   *          can be @p NULL if @p rablocks is zero.
+   */
+  uint8_t                   *rabufp;
+  /**
+   * @brief   Transfers spanning this number of blocks or more bypass
+   *          the cache.
+   * @note    Zero disables the bypass.
+   */
+  uint32_t                  bypass;
+} BlockCacheConfig;
+
+/**
+ * @brief   Block cache statistics.
+ */
+typedef struct {
+  /**
+   * @brief   Blocks found in cache.
+   */
+  uint32_t                  hits;
+  /**
+   * @brief   Blocks not found in cache.
+   */
+  uint32_t                  misses;
+  /**
+   * @brief   Blocks loaded in cache by read-ahead operations.
+   */
+  uint32_t                  prefetched;
+  /**
+   * @brief   Dirty blocks written back to the underlying device.
+   */
+  uint32_t                  writebacks;
+  /**
+   * @brief   Write transfers performed for written back blocks.
+   */
+  uint32_t                  transfers;
+  /**
+   * @brief   Blocks transferred bypassing the cache.
+   */
+  uint32_t                  bypassed;
+  /**
+   * @brief   Read or write failures of the underlying device.
+   */
+  uint32_t                  errors;
+} BlockCacheStats;
+
+/**
+ * @brief   @p BlockCacheDriver specific methods.
+ */
+#define _blkcache_driver_methods                                            \
+  _base_block_device_methods
+
+/**
+ * @extends BaseBlockDeviceVMT
+ *
+ * @brief   @p BlockCacheDriver virtual methods table.
+ */
+struct BlockCacheDriverVMT {
+  _blkcache_driver_methods
+};
+
+/**
+ * @extends BaseBlockDevice
+ *
+ * @brief   Block cache driver class.
+ * @details This class implements a write-back cache of blocks layered on
+ *          top of another @p BaseBlockDevice.
+ */
+typedef struct {
+  /** @brief Virtual Methods Table.*/
+  const struct BlockCacheDriverVMT  *vmt;
+  _base_block_device_data
+  /**
+   * @brief   Current configuration data.
+   */
+  const BlockCacheConfig    *config;
+  /**
+   * @brief   Objects cache holding the blocks.
+   */
+  objects_cache_t           cache;
+  /**
+   * @brief   Driver mutex.
+   */
+  mutex_t                   mtx;
+  /**
+   * @brief   Block size of the underlying device.
+   */
+  uint32_t                  blksize;
+  /**
+   * @brief   Number of blocks of the underlying device.
+   */
+  uint32_t                  blknum;
+  /**
+   * @brief   Blocks following the last read operations of the tracked
+   *          streams.
+   */
+  uint32_t                  nextblk[BLKCACHE_CFG_STREAMS];
+  /**
+   * @brief   Next stream slot to be recycled.
+   */
+  unsigned                  nextstream;
+  /**
+   * @brief   Staging buffer in use by a read-ahead operation.
+   */
+  bool                      rabusy;
+  /**
+   * @brief   Latched failure of a write-back performed while recycling
+   *          blocks.
+   */
+  bool                      wbfailed;
+  /**
+   * @brief   Driver statistics.
+   */
+  BlockCacheStats           stats;
+} BlockCacheDriver;
+
+/*===========================================================================*/
+/* Module macros.                                                            */
+/*===========================================================================*/
+
+/**
+ * @brief   Size of the blocks buffer for @p n cached blocks.
+ *
+ * @param[in] n         number of cached blocks
+ */
+#define BLKCACHE_BUFFER_SIZE(n)     ((size_t)(n) * BLKCACHE_CFG_BLOCK_SIZE)
+
+/**
+ * @brief   Size of the read-ahead buffer for @p n blocks.
+ *
+ * @param[in] n         number of read-ahead blocks
+ */
+#define BLKCACHE_RA_BUFFER_SIZE(n)  ((size_t)(n) * BLKCACHE_CFG_BLOCK_SIZE)
+
+/**
+ * @brief   Returns a pointer to the driver statistics.
+ *
+ * @param[in] bcdp      pointer to the @p BlockCacheDriver object
+ * @return              Pointer to the @p BlockCacheStats structure.
+ *
+ * @api
+ */
+#define bcacheGetStats(bcdp) (&(bcdp)->stats)
+
+/*===========================================================================*/
+/* External declarations.                                                    */
+/*===========================================================================*/
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+  void bcacheObjectInit(BlockCacheDriver *bcdp);
+  msg_t bcacheStart(BlockCacheDriver *bcdp, const BlockCacheConfig *config);
+  void bcacheStop(BlockCacheDriver *bcdp);
+  bool bcacheFlush(BlockCacheDriver *bcdp);
+  void bcacheResetStats(BlockCacheDriver *bcdp);
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* BLKCACHE_H */
+
+/** @} */
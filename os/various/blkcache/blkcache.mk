@@ -0,0 +1,8 @@
+# Block cache files.
+BLKCACHESRC = $(CHIBIOS)/os/various/blkcache/blkcache.c
+
+BLKCACHEINC = $(CHIBIOS)/os/various/blkcache
+
+# Shared variables
+ALLCSRC += $(BLKCACHESRC)
+ALLINC  += $(BLKCACHEINC)
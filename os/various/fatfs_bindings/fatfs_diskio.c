@@ -10,15 +10,39 @@
 #include "ff.h"
 #include "diskio.h"
 
+/* Set to TRUE in order to access FATFS_HAL_DEVICE as a block cache.*/
+#if !defined(FATFS_USE_BLKCACHE)
+#define FATFS_USE_BLKCACHE FALSE
+#endif
+
+/* Set to TRUE in order to access a simulator block device.*/
+#if !defined(FATFS_USE_SIMBLK)
+#define FATFS_USE_SIMBLK FALSE
+#endif
+
+#if FATFS_USE_BLKCACHE
+#include "blkcache.h"
+#elif FATFS_USE_SIMBLK
+#include "simblk.h"
+#endif
+
 #if !defined(FATFS_HAL_DEVICE)
-#if HAL_USE_SDC
+#if FATFS_USE_BLKCACHE
+#error "FATFS_USE_BLKCACHE requires FATFS_HAL_DEVICE"
+#elif FATFS_USE_SIMBLK
+#define FATFS_HAL_DEVICE SBD1
+#elif HAL_USE_SDC
 #define FATFS_HAL_DEVICE SDCD1
 #else
 #define FATFS_HAL_DEVICE MMCD1
 #endif
 #endif
 
-#if HAL_USE_MMC_SPI
+#if FATFS_USE_BLKCACHE
+extern BlockCacheDriver FATFS_HAL_DEVICE;
+#elif FATFS_USE_SIMBLK
+extern SimBlockDevice FATFS_HAL_DEVICE;
+#elif HAL_USE_MMC_SPI
 extern MMCDriver FATFS_HAL_DEVICE;
 #elif HAL_USE_SDC
 extern SDCDriver FATFS_HAL_DEVICE;
@@ -147,6 +171,12 @@ DRESULT disk_ioctl (
   case 0:
     switch (cmd) {
     case CTRL_SYNC:
+#if FATFS_USE_BLKCACHE || FATFS_USE_SIMBLK
+      /* Modified blocks are flushed to the media.*/
+      if (blkSync(&FATFS_HAL_DEVICE)) {
+        return RES_ERROR;
+      }
+#endif
       return RES_OK;
     case GET_SECTOR_COUNT:
       if (blkGetInfo(&FATFS_HAL_DEVICE, &bdi)) {
@@ -35,6 +35,10 @@
 #include "vfs.h"
 #endif
 
+#if (SHELL_CMD_STACK_ENABLED == TRUE) || defined(__DOXYGEN__)
+#include "stkmon.h"
+#endif
+
 #if (SHELL_CMD_TEST_ENABLED == TRUE) || defined(__DOXYGEN__)
 #include "rt_test_root.h"
 #include "oslib_test_root.h"
@@ -172,17 +176,18 @@ static void cmd_threads(BaseSequentialStream *chp, int argc, char *argv[]) {
     core_id = 0U;
 #endif
 #if (CH_DBG_ENABLE_STACK_CHECK == TRUE) || (CH_CFG_USE_DYNAMIC == TRUE)
-    uint32_t stklimit = (uint32_t)tp->wabase;
+    uintptr_t stklimit = (uintptr_t)tp->wabase;
 #else
-    uint32_t stklimit = 0U;
+    uintptr_t stklimit = (uintptr_t)0;
 #endif
+    /* Unsigned long is as wide as a pointer on both ILP32 and LP64.*/
     chprintf(chp, "%4lu %08lx %08lx %08lx %4lu %4lu %9s %12s" SHELL_NEWLINE_STR,
-             core_id,
-             stklimit,
-             (uint32_t)tp->ctx.sp,
-             (uint32_t)tp,
-             (uint32_t)tp->refs - 1,
-             (uint32_t)tp->hdr.pqueue.prio,
+             (unsigned long)core_id,
+             (unsigned long)stklimit,
+             (unsigned long)(uintptr_t)tp->ctx.sp,
+             (unsigned long)(uintptr_t)tp,
+             (unsigned long)tp->refs - 1UL,
+             (unsigned long)tp->hdr.pqueue.prio,
              states[tp->state],
              tp->name == NULL ? "" : tp->name);
     tp = chRegNextThread(tp);
@@ -190,6 +195,38 @@ static void cmd_threads(BaseSequentialStream *chp, int argc, char *argv[]) {
 }
 #endif
 
+#if (SHELL_CMD_STACK_ENABLED == TRUE) || defined(__DOXYGEN__)
+static void cmd_stack(BaseSequentialStream *chp, int argc, char *argv[]) {
+  stkmon_thread_t threads[STKMON_CFG_MAX_THREADS];
+  stkmon_stats_t stats;
+  unsigned i, n;
+
+  (void)argv;
+  if (argc > 0) {
+    shellUsage(chp, "stack");
+    return;
+  }
+  n = stkmonGetReport(threads, STKMON_CFG_MAX_THREADS);
+  stkmonGetStats(&stats);
+  chprintf(chp, "    size     used   margin         name" SHELL_NEWLINE_STR);
+  for (i = 0U; i < n; i++) {
+    chprintf(chp, "%8lu %8lu %8lu %12s" SHELL_NEWLINE_STR,
+             (unsigned long)threads[i].size,
+             (unsigned long)threads[i].used,
+             (unsigned long)(threads[i].size - threads[i].used),
+             threads[i].name == NULL ? "" : threads[i].name);
+  }
+  chprintf(chp, "passes: %lu, scanned: %lu bytes, not monitored: %lu" SHELL_NEWLINE_STR,
+           (unsigned long)stats.passes,
+           (unsigned long)stats.scanned,
+           (unsigned long)stats.dropped);
+  if (stats.min_name != NULL) {
+    chprintf(chp, "min margin: %lu bytes (%s)" SHELL_NEWLINE_STR,
+             (unsigned long)stats.min_margin, stats.min_name);
+  }
+}
+#endif
+
 #if (SHELL_CMD_TEST_ENABLED == TRUE) || defined(__DOXYGEN__)
 static THD_FUNCTION(test_rt, arg) {
   BaseSequentialStream *chp = (BaseSequentialStream *)arg;
@@ -528,6 +565,9 @@ const ShellCommand shell_local_commands[] = {
 #if SHELL_CMD_THREADS_ENABLED == TRUE
   {"threads",   cmd_threads},
 #endif
+#if SHELL_CMD_STACK_ENABLED == TRUE
+  {"stack",     cmd_stack},
+#endif
 #if SHELL_CMD_FILES_ENABLED == TRUE
   {"cat",       cmd_cat},
   {"cd",        cmd_cd},
@@ -57,6 +57,10 @@
 #define SHELL_CMD_THREADS_ENABLED           TRUE
 #endif
 
+#if !defined(SHELL_CMD_STACK_ENABLED) || defined(__DOXYGEN__)
+#define SHELL_CMD_STACK_ENABLED             FALSE
+#endif
+
 #if !defined(SHELL_CMD_TEST_ENABLED) || defined(__DOXYGEN__)
 #define SHELL_CMD_TEST_ENABLED              TRUE
 #endif
@@ -0,0 +1,299 @@
+/*
+    ChibiOS - Copyright (C) 2006..2018 Giovanni Di Sirio
+
+    Licensed under the Apache License, Version 2.0 (the "License");
+    you may not use this file except in compliance with the License.
+    You may obtain a copy of the License at
+
+        http://www.apache.org/licenses/LICENSE-2.0
+
+    Unless required by applicable law or agreed to in writing, software
+    distributed under the License is distributed on an "AS IS" BASIS,
+    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+    See the License for the specific language governing permissions and
+    limitations under the License.
+*/
+
+/**
+ * @file    stkmon.c
+ * @brief   Stack high-water mark monitor code.
+ * @details This module measures the stack usage of all the threads in the
+ *          registry. Working areas are filled with
+ *          @p CH_DBG_STACK_FILL_VALUE on creation, the lowest byte no
+ *          more matching the fill value is the stack high-water mark.<br>
+ *          Stacks are scanned from the working area base upward in chunks
+ *          of @p STKMON_CFG_SCAN_CHUNK bytes, each chunk in its own
+ *          critical zone. The scan stops at the mark found by the previous
+ *          pass because the stack above it is already known to be used,
+ *          so, after the first pass, only the unused part of a stack is
+ *          examined.
+ *
+ * @addtogroup STKMON
+ * @{
+ */
+
+#include "stkmon.h"
+
+/*===========================================================================*/
+/* Module local definitions.                                                 */
+/*===========================================================================*/
+
+/*===========================================================================*/
+/* Module exported variables.                                                */
+/*===========================================================================*/
+
+/*===========================================================================*/
+/* Module local types.                                                       */
+/*===========================================================================*/
+
+/*===========================================================================*/
+/* Module local variables.                                                   */
+/*===========================================================================*/
+
+/**
+ * @brief   Monitor state.
+ * @note    Entries and statistics are written in critical zones so that
+ *          readers always see consistent values.
+ */
+static struct {
+  stkmon_thread_t           threads[STKMON_CFG_MAX_THREADS];
+  stkmon_stats_t            stats;
+} stkmon;
+
+static THD_WORKING_AREA(stkmon_wa, STKMON_CFG_THREAD_STACK_SIZE);
+
+/*===========================================================================*/
+/* Module local functions.                                                   */
+/*===========================================================================*/
+
+/**
+ * @brief   Finds or allocates the entry of a thread.
+ * @note    A thread created, between two passes, in the working area of
+ *          a terminated thread inherits its mark, the reported usage is
+ *          pessimistic in this case.
+ *
+ * @param[in] tp        pointer to the thread
+ * @param[in] pass      current pass
+ * @return              The thread entry.
+ * @retval NULL         if the table is full.
+ *
+ * @sclass
+ */
+static stkmon_thread_t *stkmon_get_entry(thread_t *tp, uint32_t pass) {
+  stkmon_thread_t *stp, *freep = NULL;
+
+  for (stp = &stkmon.threads[0];
+       stp < &stkmon.threads[STKMON_CFG_MAX_THREADS];
+       stp++) {
+    if ((stp->tp == tp) && (stp->wabase == tp->wabase)) {
+      stp->name = tp->name;
+      stp->pass = pass;
+      return stp;
+    }
+    if ((freep == NULL) && (stp->tp == NULL)) {
+      freep = stp;
+    }
+  }
+
+  if (freep != NULL) {
+    freep->tp     = tp;
+    freep->name   = tp->name;
+    freep->wabase = tp->wabase;
+    freep->size   = (size_t)((uint8_t *)tp->waend - (uint8_t *)tp->wabase);
+    freep->used   = 0U;
+    freep->pass   = pass;
+  }
+
+  return freep;
+}
+
+/**
+ * @brief   Scans the stack of a thread.
+ *
+ * @param[in] tp        pointer to the thread, a reference is held
+ * @param[in] pass      current pass
+ */
+static void stkmon_scan_thread(thread_t *tp, uint32_t pass) {
+  stkmon_thread_t *stp;
+  uint8_t *p, *limit, *end;
+  uint32_t n;
+
+  chSysLock();
+  if ((tp->state == CH_STATE_FINAL) || (tp->wabase == NULL) ||
+      (tp->waend <= tp->wabase)) {
+    chSysUnlock();
+    return;
+  }
+  stp = stkmon_get_entry(tp, pass);
+  if (stp == NULL) {
+    stkmon.stats.dropped++;
+    chSysUnlock();
+    return;
+  }
+  p     = (uint8_t *)tp->wabase;
+  end   = (uint8_t *)tp->waend;
+  limit = end - stp->used;
+  chSysUnlock();
+
+  /* Scanning upward to the first byte not matching the fill value, one
+     chunk at time.*/
+  n = 0U;
+  while (p < limit) {
+    uint8_t *chunk_end = p + STKMON_CFG_SCAN_CHUNK;
+    bool found;
+
+    if ((chunk_end > limit) || (chunk_end < p)) {
+      chunk_end = limit;
+    }
+    n += (uint32_t)(chunk_end - p);
+
+    chSysLock();
+    if (tp->state == CH_STATE_FINAL) {
+      chSysUnlock();
+      return;
+    }
+    while ((p < chunk_end) && (*p == (uint8_t)CH_DBG_STACK_FILL_VALUE)) {
+      p++;
+    }
+    found = (bool)(p < chunk_end);
+    chSysUnlock();
+
+    if (found) {
+      break;
+    }
+  }
+
+  chSysLock();
+  if ((size_t)(end - p) > stp->used) {
+    stp->used = (size_t)(end - p);
+  }
+  stkmon.stats.scanned += n;
+  chSysUnlock();
+}
+
+/**
+ * @brief   Service thread.
+ */
+static THD_FUNCTION(stkmon_thread, arg) {
+
+  (void)arg;
+
+  chRegSetThreadName("stkmon");
+
+  while (true) {
+    stkmonScan();
+    chThdSleep(STKMON_CFG_PERIOD);
+  }
+}
+
+/*===========================================================================*/
+/* Module exported functions.                                                */
+/*===========================================================================*/
+
+/**
+ * @brief   Starts the stack monitor service thread.
+ * @details The thread performs a scan pass every @p STKMON_CFG_PERIOD.
+ *
+ * @return              The pointer to the service thread.
+ *
+ * @api
+ */
+thread_t *stkmonStart(void) {
+
+  return chThdCreateStatic(stkmon_wa, sizeof (stkmon_wa),
+                           STKMON_CFG_THREAD_PRIO, stkmon_thread, NULL);
+}
+
+/**
+ * @brief   Performs a scan pass over all threads.
+ * @details The registry is walked holding a reference to the current
+ *          thread, the kernel is locked only for the registry operations
+ *          and for the scan of a single chunk.
+ * @note    This function is invoked by the service thread, it can be
+ *          invoked directly when the service thread is not used. Passes
+ *          must not be performed concurrently.
+ *
+ * @api
+ */
+void stkmonScan(void) {
+  stkmon_thread_t *stp;
+  uint32_t pass, threads = 0U;
+  size_t min_margin = (size_t)-1;
+  const char *min_name = NULL;
+  thread_t *tp;
+
+  pass = stkmon.stats.passes + 1U;
+
+  tp = chRegFirstThread();
+  do {
+    stkmon_scan_thread(tp, pass);
+    tp = chRegNextThread(tp);
+  } while (tp != NULL);
+
+  /* Dropping the threads not seen in this pass and updating the
+     statistics.*/
+  for (stp = &stkmon.threads[0];
+       stp < &stkmon.threads[STKMON_CFG_MAX_THREADS];
+       stp++) {
+    chSysLock();
+    if (stp->tp != NULL) {
+      if (stp->pass != pass) {
+        stp->tp = NULL;
+      }
+      else {
+        threads++;
+        if (stp->size - stp->used < min_margin) {
+          min_margin = stp->size - stp->used;
+          min_name   = stp->name;
+        }
+      }
+    }
+    chSysUnlock();
+  }
+
+  chSysLock();
+  stkmon.stats.passes     = pass;
+  stkmon.stats.threads    = threads;
+  stkmon.stats.min_margin = threads > 0U ? min_margin : 0U;
+  stkmon.stats.min_name   = min_name;
+  chSysUnlock();
+}
+
+/**
+ * @brief   Returns the stack usage of the monitored threads.
+ *
+ * @param[out] stp      pointer to an array of entries
+ * @param[in] n         number of entries in the array
+ * @return              The number of entries written.
+ *
+ * @api
+ */
+unsigned stkmonGetReport(stkmon_thread_t *stp, unsigned n) {
+  unsigned i, count = 0U;
+
+  for (i = 0U; (i < STKMON_CFG_MAX_THREADS) && (count < n); i++) {
+    chSysLock();
+    if (stkmon.threads[i].tp != NULL) {
+      stp[count++] = stkmon.threads[i];
+    }
+    chSysUnlock();
+  }
+
+  return count;
+}
+
+/**
+ * @brief   Returns the monitor statistics.
+ *
+ * @param[out] ssp      pointer to a @p stkmon_stats_t structure
+ *
+ * @api
+ */
+void stkmonGetStats(stkmon_stats_t *ssp) {
+
+  chSysLock();
+  *ssp = stkmon.stats;
+  chSysUnlock();
+}
+
+/** @} */
@@ -0,0 +1,198 @@
+/*
+    ChibiOS - Copyright (C) 2006..2018 Giovanni Di Sirio
+
+    Licensed under the Apache License, Version 2.0 (the "License");
+    you may not use this file except in compliance with the License.
+    You may obtain a copy of the License at
+
+        http://www.apache.org/licenses/LICENSE-2.0
+
+    Unless required by applicable law or agreed to in writing, software
+    distributed under the License is distributed on an "AS IS" BASIS,
+    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+    See the License for the specific language governing permissions and
+    limitations under the License.
+*/
+
+/**
+ * @file    stkmon.h
+ * @brief   Stack high-water mark monitor macros and structures.
+ * @note    The monitor statistics are separate from the kernel statistics,
+ *          they are retrieved using @p stkmonGetStats() and are not part
+ *          of @p kernel_stats_t.
+ *
+ * @addtogroup STKMON
+ * @{
+ */
+
+#ifndef STKMON_H
+#define STKMON_H
+
+#include "ch.h"
+
+/*===========================================================================*/
+/* Module constants.                                                         */
+/*===========================================================================*/
+
+/*===========================================================================*/
+/* Module pre-compile time settings.                                         */
+/*===========================================================================*/
+
+/**
+ * @name    Stack monitor configuration options
+ * @{
+ */
+/**
+ * @brief   Maximum number of monitored threads.
+ * @note    Threads exceeding this number are not reported.
+ */
+#if !defined(STKMON_CFG_MAX_THREADS) || defined(__DOXYGEN__)
+#define STKMON_CFG_MAX_THREADS              16U
+#endif
+
+/**
+ * @brief   Number of bytes examined in a single critical zone.
+ * @details This setting bounds the critical zone duration, the lock is
+ *          released between chunks so a stack is never scanned within a
+ *          single critical zone.
+ */
+#if !defined(STKMON_CFG_SCAN_CHUNK) || defined(__DOXYGEN__)
+#define STKMON_CFG_SCAN_CHUNK               64U
+#endif
+
+/**
+ * @brief   Interval between scan passes of the service thread.
+ */
+#if !defined(STKMON_CFG_PERIOD) || defined(__DOXYGEN__)
+#define STKMON_CFG_PERIOD                   TIME_MS2I(500)
+#endif
+
+/**
+ * @brief   Service thread priority.
+ */
+#if !defined(STKMON_CFG_THREAD_PRIO) || defined(__DOXYGEN__)
+#define STKMON_CFG_THREAD_PRIO              LOWPRIO
+#endif
+
+/**
+ * @brief   Service thread stack size.
+ */
+#if !defined(STKMON_CFG_THREAD_STACK_SIZE) || defined(__DOXYGEN__)
+#define STKMON_CFG_THREAD_STACK_SIZE        256
+#endif
+/** @} */
+
+/*===========================================================================*/
+/* Derived constants and error checks.                                       */
+/*===========================================================================*/
+
+#if CH_CFG_USE_REGISTRY == FALSE
+#error "STKMON requires CH_CFG_USE_REGISTRY"
+#endif
+
+#if CH_DBG_FILL_THREADS == FALSE
+#error "STKMON requires CH_DBG_FILL_THREADS"
+#endif
+
+#if (CH_DBG_ENABLE_STACK_CHECK == FALSE) && (CH_CFG_USE_DYNAMIC == FALSE)
+#error "STKMON requires CH_DBG_ENABLE_STACK_CHECK or CH_CFG_USE_DYNAMIC"
+#endif
+
+#if (STKMON_CFG_MAX_THREADS < 1U) || (STKMON_CFG_SCAN_CHUNK < 1U)
+#error "invalid STKMON settings"
+#endif
+
+/*===========================================================================*/
+/* Module data structures and types.                                         */
+/*===========================================================================*/
+
+/**
+ * @brief   Stack usage of a thread.
+ */
+typedef struct {
+  /**
+   * @brief   Monitored thread or @p NULL if the entry is unused.
+   * @note    This is not a reference, the thread could have terminated
+   *          after the last scan pass.
+   */
+  thread_t                  *tp;
+  /**
+   * @brief   Thread name or @p NULL.
+   */
+  const char                *name;
+  /**
+   * @brief   Working area base address.
+   */
+  stkalign_t                *wabase;
+  /**
+   * @brief   Working area size in bytes.
+   */
+  size_t                    size;
+  /**
+   * @brief   Highest stack usage seen in bytes.
+   * @note    This includes the thread structure and anything else placed
+   *          by the kernel at the top of the working area.
+   */
+  size_t                    used;
+  /**
+   * @brief   Last scan pass the thread has been seen in.
+   */
+  uint32_t                  pass;
+} stkmon_thread_t;
+
+/**
+ * @brief   Stack monitor statistics.
+ */
+typedef struct {
+  /**
+   * @brief   Number of completed scan passes.
+   */
+  uint32_t                  passes;
+  /**
+   * @brief   Number of threads seen in the last pass.
+   */
+  uint32_t                  threads;
+  /**
+   * @brief   Threads not monitored because the table is full.
+   */
+  uint32_t                  dropped;
+  /**
+   * @brief   Bytes examined since start.
+   */
+  uint32_t                  scanned;
+  /**
+   * @brief   Smallest unused stack across the monitored threads.
+   */
+  size_t                    min_margin;
+  /**
+   * @brief   Name of the thread with the smallest margin or @p NULL.
+   */
+  const char                *min_name;
+} stkmon_stats_t;
+
+/*===========================================================================*/
+/* Module macros.                                                            */
+/*===========================================================================*/
+
+/*===========================================================================*/
+/* External declarations.                                                    */
+/*===========================================================================*/
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+  thread_t *stkmonStart(void);
+  void stkmonScan(void);
+  unsigned stkmonGetReport(stkmon_thread_t *stp, unsigned n);
+  void stkmonGetStats(stkmon_stats_t *ssp);
+#ifdef __cplusplus
+}
+#endif
+
+/*===========================================================================*/
+/* Module inline functions.                                                  */
+/*===========================================================================*/
+
+#endif /* STKMON_H */
+
+/** @} */
@@ -0,0 +1,8 @@
+# Stack monitor files.
+STKMONSRC = $(CHIBIOS)/os/various/stkmon/stkmon.c
+
+STKMONINC = $(CHIBIOS)/os/various/stkmon
+
+# Shared variables
+ALLCSRC += $(STKMONSRC)
+ALLINC  += $(STKMONINC)
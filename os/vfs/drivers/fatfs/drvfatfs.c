@@ -147,6 +147,8 @@ struct vfs_fatfs_file_node_vmt {
   msg_t (*setpos)(void *ip, vfs_offset_t offset, vfs_seekmode_t whence);
   vfs_offset_t (*getpos)(void *ip);
   sequential_stream_i * (*getstream)(void *ip);
+  ssize_t (*readv)(void *ip, const stm_iovec_t *iov, unsigned iovcnt);
+  ssize_t (*writev)(void *ip, const stm_iovec_t *iov, unsigned iovcnt);
   /* From vfs_fatfs_file_node_c.*/
 };
 
@@ -55,6 +55,14 @@
 #if !defined(DRV_CFG_OVERLAY_DIR_NODES_NUM) || defined(__DOXYGEN__)
 #define DRV_CFG_OVERLAY_DIR_NODES_NUM       1
 #endif
+
+/**
+ * @brief       Number of entries of the path-resolution cache.
+ * @note        It must be a power of two.
+ */
+#if !defined(DRV_CFG_OVERLAY_CACHE_SIZE) || defined(__DOXYGEN__)
+#define DRV_CFG_OVERLAY_CACHE_SIZE          8
+#endif
 /** @} */
 
 /*===========================================================================*/
@@ -62,7 +70,7 @@
 /*===========================================================================*/
 
 /* Checks on DRV_CFG_OVERLAY_DRV_MAX configuration.*/
-#if DRV_CFG_OVERLAY_DRV_MAX < 1
+#if (DRV_CFG_OVERLAY_DRV_MAX < 1) || (DRV_CFG_OVERLAY_DRV_MAX > 255)
 #error "invalid DRV_CFG_OVERLAY_DRV_MAX value"
 #endif
 
@@ -71,6 +79,12 @@
 #error "invalid DRV_CFG_OVERLAY_DIR_NODES_NUM value"
 #endif
 
+/* Checks on DRV_CFG_OVERLAY_CACHE_SIZE configuration.*/
+#if (DRV_CFG_OVERLAY_CACHE_SIZE < 1) ||                                     \
+    ((DRV_CFG_OVERLAY_CACHE_SIZE & (DRV_CFG_OVERLAY_CACHE_SIZE - 1)) != 0)
+#error "invalid DRV_CFG_OVERLAY_CACHE_SIZE value"
+#endif
+
 /*===========================================================================*/
 /* Module macros.                                                            */
 /*===========================================================================*/
@@ -189,6 +203,7 @@ struct vfs_overlay_driver {
   unsigned                  next_driver;
   const char                *names[DRV_CFG_OVERLAY_DRV_MAX];
   vfs_driver_c              *drivers[DRV_CFG_OVERLAY_DRV_MAX];
+  uint32_t                  cache[DRV_CFG_OVERLAY_CACHE_SIZE];
   char                      buf[VFS_CFG_PATHLEN_MAX + 1];
 };
 /** @} */
@@ -55,6 +55,16 @@
 #if !defined(DRV_CFG_STREAMS_FILE_NODES_NUM) || defined(__DOXYGEN__)
 #define DRV_CFG_STREAMS_FILE_NODES_NUM      1
 #endif
+
+/**
+ * @brief       Size of the stack buffer used for vectored transfers.
+ * @note        Scatter-gather transfers not exceeding this size are
+ *              performed with a single stream call, zero disables the
+ *              feature.
+ */
+#if !defined(DRV_CFG_STREAMS_IOV_BUFFER_SIZE) || defined(__DOXYGEN__)
+#define DRV_CFG_STREAMS_IOV_BUFFER_SIZE     256
+#endif
 /** @} */
 
 /*===========================================================================*/
@@ -71,6 +81,11 @@
 #error "invalid DRV_CFG_STREAMS_FILE_NODES_NUM value"
 #endif
 
+/* Checks on DRV_CFG_STREAMS_IOV_BUFFER_SIZE configuration.*/
+#if DRV_CFG_STREAMS_IOV_BUFFER_SIZE < 0
+#error "invalid DRV_CFG_STREAMS_IOV_BUFFER_SIZE value"
+#endif
+
 /*===========================================================================*/
 /* Module macros.                                                            */
 /*===========================================================================*/
@@ -189,6 +204,8 @@ struct vfs_streams_file_node_vmt {
   msg_t (*setpos)(void *ip, vfs_offset_t offset, vfs_seekmode_t whence);
   vfs_offset_t (*getpos)(void *ip);
   sequential_stream_i * (*getstream)(void *ip);
+  ssize_t (*readv)(void *ip, const stm_iovec_t *iov, unsigned iovcnt);
+  ssize_t (*writev)(void *ip, const stm_iovec_t *iov, unsigned iovcnt);
   /* From vfs_streams_file_node_c.*/
 };
 
@@ -292,6 +309,10 @@ extern "C" {
                               vfs_seekmode_t whence);
   vfs_offset_t __stmfile_getpos_impl(void *ip);
   sequential_stream_i *__stmfile_getstream_impl(void *ip);
+  ssize_t __stmfile_readv_impl(void *ip, const stm_iovec_t *iov,
+                               unsigned iovcnt);
+  ssize_t __stmfile_writev_impl(void *ip, const stm_iovec_t *iov,
+                                unsigned iovcnt);
   /* Methods of vfs_streams_driver_c.*/
   void *__stmdrv_objinit_impl(void *ip, const void *vmt,
                               const drv_streams_element_t *streams);
@@ -345,6 +366,101 @@ static inline vfs_streams_dir_node_c *stmdirObjectInit(vfs_streams_dir_node_c *s
 }
 /** @} */
 
+/**
+ * @name        Statically bound methods of vfs_streams_dir_node_c
+ * @{
+ */
+/**
+ * @memberof    vfs_streams_dir_node_c
+ * @public
+ *
+ * @brief       New object reference creation.
+ * @details     The references counter is increased and a new reference pointer
+ *              is returned.
+ *
+ * @param[in,out] self          Pointer to a @p vfs_streams_dir_node_c instance.
+ * @return                      A new reference pointer.
+ */
+CC_FORCE_INLINE
+static inline void *stmdirAddref(vfs_streams_dir_node_c *self) {
+
+  return __ro_addref_impl(self);
+}
+
+/**
+ * @memberof    vfs_streams_dir_node_c
+ * @public
+ *
+ * @brief       Release of an object reference.
+ * @details     The reference counter is decreased, if the counter reaches zero
+ *              then the object is disposed.
+ *
+ * @param[in,out] self          Pointer to a @p vfs_streams_dir_node_c instance.
+ * @return                      The value of the reference counter.
+ */
+CC_FORCE_INLINE
+static inline object_references_t stmdirRelease(vfs_streams_dir_node_c *self) {
+
+  return __ro_release_impl(self);
+}
+
+/**
+ * @memberof    vfs_streams_dir_node_c
+ * @public
+ *
+ * @brief       Returns information about the node.
+ *
+ * @param[in,out] self          Pointer to a @p vfs_streams_dir_node_c instance.
+ * @param[out]    sp            Pointer to a @p vfs_stat_t structure.
+ * @return                      The operation result.
+ *
+ * @api
+ */
+CC_FORCE_INLINE
+static inline msg_t stmdirStat(vfs_streams_dir_node_c *self, vfs_stat_t *sp) {
+
+  return __stmdir_stat_impl(self, sp);
+}
+
+/**
+ * @memberof    vfs_streams_dir_node_c
+ * @public
+ *
+ * @brief       First directory entry.
+ *
+ * @param[in,out] self          Pointer to a @p vfs_streams_dir_node_c instance.
+ * @param[out]    dip           Pointer to a @p vfs_direntry_info_t structure.
+ * @return                      The operation result.
+ *
+ * @api
+ */
+CC_FORCE_INLINE
+static inline msg_t stmdirFirst(vfs_streams_dir_node_c *self,
+                                vfs_direntry_info_t *dip) {
+
+  return __stmdir_first_impl(self, dip);
+}
+
+/**
+ * @memberof    vfs_streams_dir_node_c
+ * @public
+ *
+ * @brief       Next directory entry.
+ *
+ * @param[in,out] self          Pointer to a @p vfs_streams_dir_node_c instance.
+ * @param[out]    dip           Pointer to a @p vfs_direntry_info_t structure.
+ * @return                      The operation result.
+ *
+ * @api
+ */
+CC_FORCE_INLINE
+static inline msg_t stmdirNext(vfs_streams_dir_node_c *self,
+                               vfs_direntry_info_t *dip) {
+
+  return __stmdir_next_impl(self, dip);
+}
+/** @} */
+
 /**
  * @name        Default constructor of vfs_streams_file_node_c
  * @{
@@ -375,6 +491,213 @@ static inline vfs_streams_file_node_c *stmfileObjectInit(vfs_streams_file_node_c
 }
 /** @} */
 
+/**
+ * @name        Statically bound methods of vfs_streams_file_node_c
+ * @{
+ */
+/**
+ * @memberof    vfs_streams_file_node_c
+ * @public
+ *
+ * @brief       New object reference creation.
+ * @details     The references counter is increased and a new reference pointer
+ *              is returned.
+ *
+ * @param[in,out] self          Pointer to a @p vfs_streams_file_node_c
+ *                              instance.
+ * @return                      A new reference pointer.
+ */
+CC_FORCE_INLINE
+static inline void *stmfileAddref(vfs_streams_file_node_c *self) {
+
+  return __ro_addref_impl(self);
+}
+
+/**
+ * @memberof    vfs_streams_file_node_c
+ * @public
+ *
+ * @brief       Release of an object reference.
+ * @details     The reference counter is decreased, if the counter reaches zero
+ *              then the object is disposed.
+ *
+ * @param[in,out] self          Pointer to a @p vfs_streams_file_node_c
+ *                              instance.
+ * @return                      The value of the reference counter.
+ */
+CC_FORCE_INLINE
+static inline object_references_t stmfileRelease(vfs_streams_file_node_c *self) {
+
+  return __ro_release_impl(self);
+}
+
+/**
+ * @memberof    vfs_streams_file_node_c
+ * @public
+ *
+ * @brief       Returns information about the node.
+ *
+ * @param[in,out] self          Pointer to a @p vfs_streams_file_node_c
+ *                              instance.
+ * @param[out]    sp            Pointer to a @p vfs_stat_t structure.
+ * @return                      The operation result.
+ *
+ * @api
+ */
+CC_FORCE_INLINE
+static inline msg_t stmfileStat(vfs_streams_file_node_c *self, vfs_stat_t *sp) {
+
+  return __stmfile_stat_impl(self, sp);
+}
+
+/**
+ * @memberof    vfs_streams_file_node_c
+ * @public
+ *
+ * @brief       File node read.
+ *
+ * @param[in,out] self          Pointer to a @p vfs_streams_file_node_c
+ *                              instance.
+ * @param[out]    buf           Pointer to the data buffer.
+ * @param[in]     n             Maximum amount of data to be transferred.
+ * @return                      The transferred number of bytes or an error.
+ *
+ * @api
+ */
+CC_FORCE_INLINE
+static inline ssize_t stmfileRead(vfs_streams_file_node_c *self, uint8_t *buf,
+                                  size_t n) {
+
+  return __stmfile_read_impl(self, buf, n);
+}
+
+/**
+ * @memberof    vfs_streams_file_node_c
+ * @public
+ *
+ * @brief       File node read.
+ *
+ * @param[in,out] self          Pointer to a @p vfs_streams_file_node_c
+ *                              instance.
+ * @param[in]     buf           Pointer to the data buffer.
+ * @param[in]     n             Maximum amount of data to be transferred.
+ * @return                      The transferred number of bytes or an error.
+ *
+ * @api
+ */
+CC_FORCE_INLINE
+static inline ssize_t stmfileWrite(vfs_streams_file_node_c *self,
+                                   const uint8_t *buf, size_t n) {
+
+  return __stmfile_write_impl(self, buf, n);
+}
+
+/**
+ * @memberof    vfs_streams_file_node_c
+ * @public
+ *
+ * @brief       Changes the current file position.
+ *
+ * @param[in,out] self          Pointer to a @p vfs_streams_file_node_c
+ *                              instance.
+ * @param[in]     offset        Offset to be applied.
+ * @param[in]     whence        Seek mode to be used.
+ * @return                      The operation result.
+ *
+ * @api
+ */
+CC_FORCE_INLINE
+static inline msg_t stmfileSetpos(vfs_streams_file_node_c *self,
+                                  vfs_offset_t offset, vfs_seekmode_t whence) {
+
+  return __stmfile_setpos_impl(self, offset, whence);
+}
+
+/**
+ * @memberof    vfs_streams_file_node_c
+ * @public
+ *
+ * @brief       Returns the current file position.
+ *
+ * @param[in,out] self          Pointer to a @p vfs_streams_file_node_c
+ *                              instance.
+ * @return                      The current file position.
+ *
+ * @api
+ */
+CC_FORCE_INLINE
+static inline vfs_offset_t stmfileGetpos(vfs_streams_file_node_c *self) {
+
+  return __stmfile_getpos_impl(self);
+}
+
+/**
+ * @memberof    vfs_streams_file_node_c
+ * @public
+ *
+ * @brief       Returns the inner HAL stream associated to the file.
+ *
+ * @param[in,out] self          Pointer to a @p vfs_streams_file_node_c
+ *                              instance.
+ * @return                      Pointer to the HAL stream interface.
+ *
+ * @api
+ */
+CC_FORCE_INLINE
+static inline sequential_stream_i *stmfileGetstream(vfs_streams_file_node_c *self) {
+
+  return __stmfile_getstream_impl(self);
+}
+
+/**
+ * @memberof    vfs_streams_file_node_c
+ * @public
+ *
+ * @brief       File node scatter read.
+ * @details     The default implementation reads each segment using @p
+ *              vfsFileRead(), runs of small segments are read with a single
+ *              call.
+ *
+ * @param[in,out] self          Pointer to a @p vfs_streams_file_node_c
+ *                              instance.
+ * @param[in]     iov           Pointer to the array of segments.
+ * @param[in]     iovcnt        Number of segments in the array.
+ * @return                      The transferred number of bytes or an error.
+ *
+ * @api
+ */
+CC_FORCE_INLINE
+static inline ssize_t stmfileReadv(vfs_streams_file_node_c *self,
+                                   const stm_iovec_t *iov, unsigned iovcnt) {
+
+  return __stmfile_readv_impl(self, iov, iovcnt);
+}
+
+/**
+ * @memberof    vfs_streams_file_node_c
+ * @public
+ *
+ * @brief       File node gather write.
+ * @details     The default implementation writes each segment using @p
+ *              vfsFileWrite(), runs of small segments are gathered and
+ *              written with a single call.
+ *
+ * @param[in,out] self          Pointer to a @p vfs_streams_file_node_c
+ *                              instance.
+ * @param[in]     iov           Pointer to the array of segments.
+ * @param[in]     iovcnt        Number of segments in the array.
+ * @return                      The transferred number of bytes or an error.
+ *
+ * @api
+ */
+CC_FORCE_INLINE
+static inline ssize_t stmfileWritev(vfs_streams_file_node_c *self,
+                                    const stm_iovec_t *iov, unsigned iovcnt) {
+
+  return __stmfile_writev_impl(self, iov, iovcnt);
+}
+/** @} */
+
 /**
  * @name        Default constructor of vfs_streams_driver_c
  * @{
@@ -89,6 +89,7 @@
 #include "vfsbuffers.h"
 #include "vfsnodes.h"
 #include "vfsdrivers.h"
+#include "vfsfilebufs.h"
 
 /* File System drivers.*/
 #if VFS_CFG_ENABLE_DRV_OVERLAY == TRUE
@@ -133,6 +134,8 @@ extern "C" {
   msg_t vfsOpen(const char *path, int flags, vfs_node_c **vnpp);
   msg_t vfsOpenDirectory(const char *name, vfs_directory_node_c **vdnpp);
   msg_t vfsOpenFile(const char *name, int flags, vfs_file_node_c **vfnpp);
+  msg_t vfsOpenFileBuffered(const char *name, int flags,
+                            vfs_file_node_c **vfnpp);
   msg_t vfsUnlink(const char *path);
   msg_t vfsRename(const char *oldpath, const char *newpath);
   msg_t vfsMkdir(const char *path, vfs_mode_t mode);
@@ -145,6 +148,10 @@ extern "C" {
                              vfs_direntry_info_t *dip);
   ssize_t vfsReadFile(vfs_file_node_c *vfnp, uint8_t *buf, size_t n);
   ssize_t vfsWriteFile(vfs_file_node_c *vfnp, const uint8_t *buf, size_t n);
+  ssize_t vfsReadFileV(vfs_file_node_c *vfnp, const stm_iovec_t *iov,
+                       unsigned iovcnt);
+  ssize_t vfsWriteFileV(vfs_file_node_c *vfnp, const stm_iovec_t *iov,
+                        unsigned iovcnt);
   msg_t vfsSetFilePosition(vfs_file_node_c *vfnp,
                            vfs_offset_t offset,
                            vfs_seekmode_t whence);
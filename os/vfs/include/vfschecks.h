@@ -73,6 +73,30 @@
 #error "invalid value for VFS_CFG_PATHBUFS_NUM"
 #endif
 
+#if !defined(VFS_CFG_FILEBUFS_NUM)
+#error "VFS_CFG_FILEBUFS_NUM not defined in vfsconf.h"
+#endif
+
+#if VFS_CFG_FILEBUFS_NUM < 0
+#error "invalid value for VFS_CFG_FILEBUFS_NUM"
+#endif
+
+#if !defined(VFS_CFG_FILEBUF_SIZE)
+#error "VFS_CFG_FILEBUF_SIZE not defined in vfsconf.h"
+#endif
+
+#if VFS_CFG_FILEBUF_SIZE < 16
+#error "invalid value for VFS_CFG_FILEBUF_SIZE"
+#endif
+
+#if !defined(VFS_CFG_IOV_GATHER_SIZE)
+#error "VFS_CFG_IOV_GATHER_SIZE not defined in vfsconf.h"
+#endif
+
+#if VFS_CFG_IOV_GATHER_SIZE < 0
+#error "invalid value for VFS_CFG_IOV_GATHER_SIZE"
+#endif
+
 #if !defined(VFS_CFG_ENABLE_DRV_OVERLAY)
 #error "VFS_CFG_ENABLE_DRV_OVERLAY not defined in vfsconf.h"
 #endif
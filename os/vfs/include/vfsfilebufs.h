@@ -0,0 +1,86 @@
+/*
+    ChibiOS - Copyright (C) 2006..2023 Giovanni Di Sirio
+
+    Licensed under the Apache License, Version 2.0 (the "License");
+    you may not use this file except in compliance with the License.
+    You may obtain a copy of the License at
+
+        http://www.apache.org/licenses/LICENSE-2.0
+
+    Unless required by applicable law or agreed to in writing, software
+    distributed under the License is distributed on an "AS IS" BASIS,
+    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+    See the License for the specific language governing permissions and
+    limitations under the License.
+*/
+
+/**
+ * @file        vfsfilebufs.h
+ * @brief       Generated VFS Buffered File Nodes header.
+ * @note        This is a generated file, do not edit directly.
+ *
+ * @addtogroup  VFSFILEBUFS
+ * @brief       Buffered file nodes wrapping file nodes of any driver.
+ * @details     A buffered file node wraps a file node of any driver and
+ *              associates to it a buffer taken from a fixed pool. The buffer
+ *              is used for read-ahead or for coalescing small writes, the
+ *              wrapped node is only accessed when the buffer is exhausted,
+ *              full, or when the file position is moved outside of it.
+ * @note        Pending writes are flushed when the file position is changed,
+ *              when the node is examined and when the last reference to the
+ *              node is released. Data failing the write-back stays buffered,
+ *              the error is reported by the next flush which retries it.
+ *              Errors during the final flush cannot be reported, use
+ *              @p vfsSetFilePosition() before closing if the outcome is
+ *              relevant.
+ * @{
+ */
+
+#ifndef VFSFILEBUFS_H
+#define VFSFILEBUFS_H
+
+#if (VFS_CFG_FILEBUFS_NUM > 0) || defined(__DOXYGEN__)
+
+/*===========================================================================*/
+/* Module constants.                                                         */
+/*===========================================================================*/
+
+/*===========================================================================*/
+/* Module pre-compile time settings.                                         */
+/*===========================================================================*/
+
+/*===========================================================================*/
+/* Derived constants and error checks.                                       */
+/*===========================================================================*/
+
+/*===========================================================================*/
+/* Module macros.                                                            */
+/*===========================================================================*/
+
+/*===========================================================================*/
+/* Module data structures and types.                                         */
+/*===========================================================================*/
+
+/*===========================================================================*/
+/* External declarations.                                                    */
+/*===========================================================================*/
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+  /* Regular functions.*/
+  void __vfs_filebufs_init(void);
+  vfs_file_node_c *vfs_filebuf_wrap(vfs_file_node_c *vfnp, int flags);
+#ifdef __cplusplus
+}
+#endif
+
+/*===========================================================================*/
+/* Module inline functions.                                                  */
+/*===========================================================================*/
+
+#endif /* VFS_CFG_FILEBUFS_NUM > 0 */
+
+#endif /* VFSFILEBUFS_H */
+
+/** @} */
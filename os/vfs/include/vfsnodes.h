@@ -286,6 +286,8 @@ struct vfs_file_node_vmt {
   msg_t (*setpos)(void *ip, vfs_offset_t offset, vfs_seekmode_t whence);
   vfs_offset_t (*getpos)(void *ip);
   sequential_stream_i * (*getstream)(void *ip);
+  ssize_t (*readv)(void *ip, const stm_iovec_t *iov, unsigned iovcnt);
+  ssize_t (*writev)(void *ip, const stm_iovec_t *iov, unsigned iovcnt);
 };
 
 /**
@@ -339,6 +341,10 @@ extern "C" {
                               vfs_seekmode_t whence);
   vfs_offset_t __vfsfile_getpos_impl(void *ip);
   sequential_stream_i *__vfsfile_getstream_impl(void *ip);
+  ssize_t __vfsfile_readv_impl(void *ip, const stm_iovec_t *iov,
+                               unsigned iovcnt);
+  ssize_t __vfsfile_writev_impl(void *ip, const stm_iovec_t *iov,
+                                unsigned iovcnt);
 #ifdef __cplusplus
 }
 #endif
@@ -514,6 +520,54 @@ static inline sequential_stream_i *vfsFileGetStream(void *ip) {
 
   return self->vmt->getstream(ip);
 }
+
+/**
+ * @memberof    vfs_file_node_c
+ * @public
+ *
+ * @brief       File node scatter read.
+ * @details     The default implementation reads each segment using @p
+ *              vfsFileRead(), runs of small segments are read with a single
+ *              call.
+ *
+ * @param[in,out] ip            Pointer to a @p vfs_file_node_c instance.
+ * @param[in]     iov           Pointer to the array of segments.
+ * @param[in]     iovcnt        Number of segments in the array.
+ * @return                      The transferred number of bytes or an error.
+ *
+ * @api
+ */
+CC_FORCE_INLINE
+static inline ssize_t vfsFileReadV(void *ip, const stm_iovec_t *iov,
+                                   unsigned iovcnt) {
+  vfs_file_node_c *self = (vfs_file_node_c *)ip;
+
+  return self->vmt->readv(ip, iov, iovcnt);
+}
+
+/**
+ * @memberof    vfs_file_node_c
+ * @public
+ *
+ * @brief       File node gather write.
+ * @details     The default implementation writes each segment using @p
+ *              vfsFileWrite(), runs of small segments are gathered and
+ *              written with a single call.
+ *
+ * @param[in,out] ip            Pointer to a @p vfs_file_node_c instance.
+ * @param[in]     iov           Pointer to the array of segments.
+ * @param[in]     iovcnt        Number of segments in the array.
+ * @return                      The transferred number of bytes or an error.
+ *
+ * @api
+ */
+CC_FORCE_INLINE
+static inline ssize_t vfsFileWriteV(void *ip, const stm_iovec_t *iov,
+                                    unsigned iovcnt) {
+  vfs_file_node_c *self = (vfs_file_node_c *)ip;
+
+  return self->vmt->writev(ip, iov, iovcnt);
+}
 /** @} */
 
 #endif /* VFSNODES_H */
@@ -61,6 +61,11 @@ void vfsInit(void) {
   /* Shared buffers manager initialization.*/
   __vfs_buffers_init();
 
+#if VFS_CFG_FILEBUFS_NUM > 0
+  /* Buffered file nodes initialization.*/
+  __vfs_filebufs_init();
+#endif
+
 #if VFS_CFG_ENABLE_DRV_OVERLAY == TRUE
   __drv_overlay_init();
 #endif
@@ -162,6 +167,39 @@ msg_t vfsOpenFile(const char *path, int flags, vfs_file_node_c **vfnpp) {
   return vfsDrvOpenFile(vfs_root, path, flags, vfnpp);
 }
 
+/**
+ * @brief   Opens a VFS file with buffering.
+ * @details The file node is wrapped in a buffered file node performing
+ *          read-ahead and write coalescing, small transfers are served
+ *          from the buffer without involving the file system driver.
+ * @note    If buffering is disabled, the file is not a regular file or
+ *          there are no buffered file nodes available then the plain
+ *          file node is returned.
+ * @note    Pending writes are flushed on @p vfsSetFilePosition() and when
+ *          the node is closed.
+ *
+ * @param[in] path      Path of the file to be opened.
+ * @param[in] flags     File open flags.
+ * @param[out] vfnpp    Pointer to the pointer to the instantiated
+ *                      @p vfs_file_node_c object.
+ * @return              The operation result.
+ *
+ * @api
+ */
+msg_t vfsOpenFileBuffered(const char *path, int flags,
+                          vfs_file_node_c **vfnpp) {
+  msg_t ret;
+
+  ret = vfsDrvOpenFile(vfs_root, path, flags, vfnpp);
+#if VFS_CFG_FILEBUFS_NUM > 0
+  if (!CH_RET_IS_ERROR(ret)) {
+    *vfnpp = vfs_filebuf_wrap(*vfnpp, flags);
+  }
+#endif
+
+  return ret;
+}
+
 /**
  * @brief   Unlinks and possibly deletes a file.
  *
@@ -320,6 +358,46 @@ ssize_t vfsWriteFile(vfs_file_node_c *vfnp, const uint8_t *buf, size_t n) {
   return vfsFileWrite((void *)vfnp, buf, n);
 }
 
+/**
+ * @brief   File node scatter read.
+ * @details The function reads data from a file node into an array of
+ *          segments, the segments are filled in order.
+ *
+ * @param[in] vfnp      Pointer to the @p vfs_file_node_c object.
+ * @param[in] iov       Pointer to the array of segments.
+ * @param[in] iovcnt    Number of segments in the array.
+ * @return              The transferred number of bytes or an error.
+ *
+ * @api
+ */
+ssize_t vfsReadFileV(vfs_file_node_c *vfnp, const stm_iovec_t *iov,
+                     unsigned iovcnt) {
+
+  chDbgAssert(vfnp->references > 0U, "zero count");
+
+  return vfsFileReadV((void *)vfnp, iov, iovcnt);
+}
+
+/**
+ * @brief   File node gather write.
+ * @details The function writes data from an array of segments to a file
+ *          node, the segments are written in order.
+ *
+ * @param[in] vfnp      Pointer to the @p vfs_file_node_c object.
+ * @param[in] iov       Pointer to the array of segments.
+ * @param[in] iovcnt    Number of segments in the array.
+ * @return              The transferred number of bytes or an error.
+ *
+ * @api
+ */
+ssize_t vfsWriteFileV(vfs_file_node_c *vfnp, const stm_iovec_t *iov,
+                      unsigned iovcnt) {
+
+  chDbgAssert(vfnp->references > 0U, "zero count");
+
+  return vfsFileWriteV((void *)vfnp, iov, iovcnt);
+}
+
 /**
  * @brief   Changes the current file position.
  *
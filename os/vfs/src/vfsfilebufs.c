@@ -0,0 +1,178 @@
+/*
+    ChibiOS - Copyright (C) 2006..2023 Giovanni Di Sirio
+
+    Licensed under the Apache License, Version 2.0 (the "License");
+    you may not use this file except in compliance with the License.
+    You may obtain a copy of the License at
+
+        http://www.apache.org/licenses/LICENSE-2.0
+
+    Unless required by applicable law or agreed to in writing, software
+    distributed under the License is distributed on an "AS IS" BASIS,
+    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+    See the License for the specific language governing permissions and
+    limitations under the License.
+*/
+
+/**
+ * @file        vfsfilebufs.c
+ * @brief       Generated VFS Buffered File Nodes source.
+ * @note        This is a generated file, do not edit directly.
+ *
+ * @addtogroup  VFSFILEBUFS
+ * @{
+ */
+
+#include "vfs.h"
+
+#if (VFS_CFG_FILEBUFS_NUM > 0) || defined(__DOXYGEN__)
+
+/*===========================================================================*/
+/* Module local definitions.                                                 */
+/*===========================================================================*/
+
+/**
+ * @name    Buffer states
+ * @{
+ */
+#define VFS_FILEBUF_EMPTY                   0U
+#define VFS_FILEBUF_READ                    1U
+#define VFS_FILEBUF_WRITE                   2U
+/** @} */
+
+/*===========================================================================*/
+/* Module local macros.                                                      */
+/*===========================================================================*/
+
+/*===========================================================================*/
+/* Module exported variables.                                                */
+/*===========================================================================*/
+
+/*===========================================================================*/
+/* Module local types.                                                       */
+/*===========================================================================*/
+
+/**
+ * @class       vfs_buffered_file_node_c
+ * @extends     base_object_c, referenced_object_c, vfs_node_c,
+ *              vfs_file_node_c.
+ * @implements  sequential_stream_i
+ *
+ *
+ * @name        Class @p vfs_buffered_file_node_c structures
+ * @{
+ */
+
+/**
+ * @brief       Type of a VFS buffered file node class.
+ */
+typedef struct vfs_buffered_file_node vfs_buffered_file_node_c;
+
+/**
+ * @brief       Class @p vfs_buffered_file_node_c virtual methods table.
+ */
+struct vfs_buffered_file_node_vmt {
+  /* From base_object_c.*/
+  void (*dispose)(void *ip);
+  /* From referenced_object_c.*/
+  void * (*addref)(void *ip);
+  object_references_t (*release)(void *ip);
+  /* From vfs_node_c.*/
+  msg_t (*stat)(void *ip, vfs_stat_t *sp);
+  /* From vfs_file_node_c.*/
+  ssize_t (*read)(void *ip, uint8_t *buf, size_t n);
+  ssize_t (*write)(void *ip, const uint8_t *buf, size_t n);
+  msg_t (*setpos)(void *ip, vfs_offset_t offset, vfs_seekmode_t whence);
+  vfs_offset_t (*getpos)(void *ip);
+  sequential_stream_i * (*getstream)(void *ip);
+  ssize_t (*readv)(void *ip, const stm_iovec_t *iov, unsigned iovcnt);
+  ssize_t (*writev)(void *ip, const stm_iovec_t *iov, unsigned iovcnt);
+  /* From vfs_buffered_file_node_c.*/
+};
+
+/**
+ * @brief       Structure representing a VFS buffered file node class.
+ */
+struct vfs_buffered_file_node {
+  /**
+   * @brief       Virtual Methods Table.
+   */
+  const struct vfs_buffered_file_node_vmt *vmt;
+  /**
+   * @brief       Number of references to the object.
+   */
+  object_references_t       references;
+  /**
+   * @brief       Driver handling this node.
+   */
+  vfs_driver_c              *driver;
+  /**
+   * @brief       Node mode information.
+   */
+  vfs_mode_t                mode;
+  /**
+   * @brief       Implemented interface @p sequential_stream_i.
+   */
+  sequential_stream_i       stm;
+  /**
+   * @brief       Wrapped file node.
+   */
+  vfs_file_node_c           *file;
+  /**
+   * @brief       Open flags of the wrapped file node.
+   */
+  int                       flags;
+  /**
+   * @brief       Buffer state.
+   */
+  unsigned                  state;
+  /**
+   * @brief       Logical file position.
+   */
+  vfs_offset_t              pos;
+  /**
+   * @brief       File position of the first buffered byte.
+   */
+  vfs_offset_t              bufpos;
+  /**
+   * @brief       Number of buffered bytes.
+   */
+  size_t                    bufcnt;
+  /**
+   * @brief       Data buffer.
+   */
+  uint8_t                   buffer[VFS_CFG_FILEBUF_SIZE];
+};
+/** @} */
+
+/**
+ * @brief       Structure representing the global state of @p
+ *              vfs_buffered_file_node_c.
+ */
+struct vfs_filebufs_static_struct {
+  /**
+   * @brief       Pool of buffered file nodes.
+   */
+  memory_pool_t             nodes_pool;
+  /**
+   * @brief       Static storage of buffered file nodes.
+   */
+  vfs_buffered_file_node_c  nodes[VFS_CFG_FILEBUFS_NUM];
+};
+
+/*===========================================================================*/
+/* Module local variables.                                                   */
+/*===========================================================================*/
+
+/**
+ * @brief       Global state of @p vfs_buffered_file_node_c.
+ */
+static struct vfs_filebufs_static_struct vfs_filebufs_static;
+
+/* Module code has been generated into an hand-editable file and included
+   here.*/
+#include "vfsfilebufs_impl.inc"
+
+#endif /* VFS_CFG_FILEBUFS_NUM > 0 */
+
+/** @} */
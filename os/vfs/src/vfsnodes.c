@@ -376,6 +376,143 @@ sequential_stream_i *__vfsfile_getstream_impl(void *ip) {
 
   return NULL;
 }
+
+/**
+ * @memberof    vfs_file_node_c
+ * @protected
+ *
+ * @brief       Implementation of method @p vfsFileReadV().
+ * @note        This function is meant to be used by derived classes.
+ *
+ * @param[in,out] ip            Pointer to a @p vfs_file_node_c instance.
+ * @param[in]     iov           Pointer to the array of segments.
+ * @param[in]     iovcnt        Number of segments in the array.
+ * @return                      The transferred number of bytes or an error.
+ */
+ssize_t __vfsfile_readv_impl(void *ip, const stm_iovec_t *iov,
+                             unsigned iovcnt) {
+  vfs_file_node_c *self = (vfs_file_node_c *)ip;
+  ssize_t total = (ssize_t)0;
+  unsigned i = 0U;
+#if VFS_CFG_IOV_GATHER_SIZE > 0
+  uint8_t buf[VFS_CFG_IOV_GATHER_SIZE];
+#endif
+
+  while (i < iovcnt) {
+    uint8_t *bp = (uint8_t *)iov[i].base;
+    size_t n = iov[i].len;
+#if VFS_CFG_IOV_GATHER_SIZE > 0
+    unsigned first = i;
+#endif
+    ssize_t ret;
+
+    i++;
+#if VFS_CFG_IOV_GATHER_SIZE > 0
+    /* Runs of small segments are read with a single call and scattered.*/
+    if ((n < (size_t)VFS_CFG_IOV_GATHER_SIZE) && (i < iovcnt) &&
+        (iov[i].len <= (size_t)VFS_CFG_IOV_GATHER_SIZE - n)) {
+      do {
+        n += iov[i].len;
+        i++;
+      } while ((i < iovcnt) &&
+               (iov[i].len <= (size_t)VFS_CFG_IOV_GATHER_SIZE - n));
+      bp = buf;
+    }
+#endif
+    if (n == (size_t)0) {
+      continue;
+    }
+
+    ret = self->vmt->read(ip, bp, n);
+    if (CH_RET_IS_ERROR(ret)) {
+      if (total == (ssize_t)0) {
+        total = ret;
+      }
+      break;
+    }
+#if VFS_CFG_IOV_GATHER_SIZE > 0
+    if (bp == buf) {
+      size_t k = (size_t)ret;
+
+      while (k > (size_t)0) {
+        size_t m = iov[first].len < k ? iov[first].len : k;
+
+        memcpy(iov[first].base, bp, m);
+        bp += m;
+        k  -= m;
+        first++;
+      }
+    }
+#endif
+    total += ret;
+    if ((size_t)ret < n) {
+      break;
+    }
+  }
+
+  return total;
+}
+
+/**
+ * @memberof    vfs_file_node_c
+ * @protected
+ *
+ * @brief       Implementation of method @p vfsFileWriteV().
+ * @note        This function is meant to be used by derived classes.
+ *
+ * @param[in,out] ip            Pointer to a @p vfs_file_node_c instance.
+ * @param[in]     iov           Pointer to the array of segments.
+ * @param[in]     iovcnt        Number of segments in the array.
+ * @return                      The transferred number of bytes or an error.
+ */
+ssize_t __vfsfile_writev_impl(void *ip, const stm_iovec_t *iov,
+                              unsigned iovcnt) {
+  vfs_file_node_c *self = (vfs_file_node_c *)ip;
+  ssize_t total = (ssize_t)0;
+  unsigned i = 0U;
+#if VFS_CFG_IOV_GATHER_SIZE > 0
+  uint8_t buf[VFS_CFG_IOV_GATHER_SIZE];
+#endif
+
+  while (i < iovcnt) {
+    const uint8_t *bp = (const uint8_t *)iov[i].base;
+    size_t n = iov[i].len;
+    ssize_t ret;
+
+    i++;
+#if VFS_CFG_IOV_GATHER_SIZE > 0
+    /* Runs of small segments are gathered and written with a single call.*/
+    if ((n < (size_t)VFS_CFG_IOV_GATHER_SIZE) && (i < iovcnt) &&
+        (iov[i].len <= (size_t)VFS_CFG_IOV_GATHER_SIZE - n)) {
+      memcpy(buf, bp, n);
+      do {
+        memcpy(&buf[n], iov[i].base, iov[i].len);
+        n += iov[i].len;
+        i++;
+      } while ((i < iovcnt) &&
+               (iov[i].len <= (size_t)VFS_CFG_IOV_GATHER_SIZE - n));
+      bp = buf;
+    }
+#endif
+    if (n == (size_t)0) {
+      continue;
+    }
+
+    ret = self->vmt->write(ip, bp, n);
+    if (CH_RET_IS_ERROR(ret)) {
+      if (total == (ssize_t)0) {
+        total = ret;
+      }
+      break;
+    }
+    total += ret;
+    if ((size_t)ret < n) {
+      break;
+    }
+  }
+
+  return total;
+}
 /** @} */
 
 /** @} */
@@ -356,8 +356,9 @@ size_t vfs_path_normalize(char *dst, const char *src, size_t size) {
       return n;
     }
 
-    /* Handling special cases of "." and "..".*/
-    if (strncmp(dst, "..", 2U) == 0) {
+    /* Handling special cases of "." and "..", the element length is
+       checked because the buffer is not terminated after the element.*/
+    if ((ret == 2U) && (strncmp(dst, "..", 2U) == 0)) {
       /* Double dot elements require to remove the last element from
          the output path.*/
       if (n > 1U) {
@@ -373,7 +374,7 @@ size_t vfs_path_normalize(char *dst, const char *src, size_t size) {
       }
       continue;
     }
-    else if (strncmp(dst, ".", 1U) == 0) {
+    else if ((ret == 1U) && (*dst == '.')) {
       /* Single dot elements are discarded.*/
       /* Consecutive input separators are consumed.*/
       continue;
@@ -388,4 +389,66 @@ size_t vfs_path_normalize(char *dst, const char *src, size_t size) {
   }
 }
 
+/**
+ * @brief   Checks if an absolute path is already normalized.
+ * @details A normalized path has no empty elements, no "." or ".."
+ *          elements and no final separator, it would be left unchanged
+ *          by @p vfs_path_normalize().
+ *
+ * @param[in] path              The path to be checked.
+ * @param[in] size              Size of the buffers used for paths.
+ * @return                      The check result.
+ * @retval false                If the path requires normalization.
+ * @retval true                 If the path is normalized.
+ */
+bool vfs_path_is_normalized(const char *path, size_t size) {
+  size_t n;
+
+  if (*path++ != '/') {
+    return false;
+  }
+
+  /* The root is normalized.*/
+  if (*path == '\0') {
+    return true;
+  }
+
+  n = 1U;
+  while (true) {
+    const char *ep = path;
+    char c = *path;
+
+    /* Empty elements and final separators.*/
+    if ((c == '/') || (c == '\0')) {
+      return false;
+    }
+
+    /* Scanning the element.*/
+    do {
+      path++;
+      n++;
+      c = *path;
+    } while ((c != '/') && (c != '\0'));
+
+    /* Dot and dot-dot elements.*/
+    if ((ep[0] == '.') &&
+        ((path - ep == 1) || ((path - ep == 2) && (ep[1] == '.')))) {
+      return false;
+    }
+
+    /* Leaving space for the final zero and for a separator.*/
+    if (n >= size - 1U) {
+      return false;
+    }
+
+    if (c == '\0') {
+      return true;
+    }
+
+    /* Skipping the separator.*/
+    path++;
+    n++;
+  }
+}
+
 /** @} */
@@ -4,6 +4,7 @@ VFSSRC := $(CHIBIOS)/os/vfs/src/vfspaths.c \
           $(CHIBIOS)/os/vfs/src/vfsbuffers.c \
           $(CHIBIOS)/os/vfs/src/vfsdrivers.c \
           $(CHIBIOS)/os/vfs/src/vfsnodes.c \
+          $(CHIBIOS)/os/vfs/src/vfsfilebufs.c \
           $(CHIBIOS)/os/vfs/src/vfs.c \
           $(CHIBIOS)/os/vfs/drivers/template/drvtemplate.c \
           $(CHIBIOS)/os/vfs/drivers/sfs/drvsfs.c \
@@ -63,6 +63,26 @@
 #define SPI_SELECT_MODE_LLD                 4
 /** @} */
 
+/**
+ * @name    SPI transfer flags
+ * @{
+ */
+/**
+ * @brief       Slave selected before the transfer.
+ */
+#define SPI_XFER_SELECT                     (1U << 0)
+
+/**
+ * @brief       Slave unselected after the transfer.
+ */
+#define SPI_XFER_UNSELECT                   (1U << 1)
+
+/**
+ * @brief       Slave selected for the transfer only.
+ */
+#define SPI_XFER_CS                         (SPI_XFER_SELECT | SPI_XFER_UNSELECT)
+/** @} */
+
 /*===========================================================================*/
 /* Module pre-compile time settings.                                         */
 /*===========================================================================*/
@@ -84,6 +104,16 @@
 #if !defined(SPI_SELECT_MODE) || defined(__DOXYGEN__)
 #define SPI_SELECT_MODE                     SPI_SELECT_MODE_PAD
 #endif
+
+/**
+ * @brief       Support for the transactions queue API.
+ * @note        The queue does not use the driver mutex, a driver accessed
+ *              through the queue must not be shared with threads using
+ *              @p drvLock() and the synchronous API.
+ */
+#if !defined(SPI_USE_TRANSACTIONS_QUEUE) || defined(__DOXYGEN__)
+#define SPI_USE_TRANSACTIONS_QUEUE          FALSE
+#endif
 /** @} */
 
 /*===========================================================================*/
@@ -100,11 +130,16 @@
 #error "invalid SPI_SELECT_MODE value"
 #endif
 
+/* Checks on SPI_USE_TRANSACTIONS_QUEUE configuration.*/
+#if (SPI_USE_TRANSACTIONS_QUEUE != FALSE) && (SPI_USE_TRANSACTIONS_QUEUE != TRUE)
+#error "invalid SPI_USE_TRANSACTIONS_QUEUE value"
+#endif
+
 /* Some modes have a dependency on the PAL driver, making the required
    checks here.*/
-#if ((SPI_SELECT_MODE != SPI_SELECT_MODE_PAD)  ||                           \
-     (SPI_SELECT_MODE != SPI_SELECT_MODE_PORT) ||                           \
-     (SPI_SELECT_MODE != SPI_SELECT_MODE_LINE)) &&                          \
+#if ((SPI_SELECT_MODE == SPI_SELECT_MODE_PAD)  ||                           \
+     (SPI_SELECT_MODE == SPI_SELECT_MODE_PORT) ||                           \
+     (SPI_SELECT_MODE == SPI_SELECT_MODE_LINE)) &&                          \
     (HAL_USE_PAL != TRUE)
 #error "current SPI_SELECT_MODE requires HAL_USE_PAL"
 #endif
@@ -160,6 +195,23 @@ typedef struct hal_spi_config SPIConfig;
  */
 typedef struct hal_spi_driver SPIDriver;
 
+#if (SPI_USE_TRANSACTIONS_QUEUE == TRUE) || defined (__DOXYGEN__)
+/**
+ * @brief       Type of a SPI transfer descriptor.
+ */
+typedef struct hal_spi_transfer hal_spi_transfer_t;
+
+/**
+ * @brief       Type of a SPI transaction.
+ */
+typedef struct hal_spi_transaction hal_spi_transaction_t;
+
+/**
+ * @brief       Type of a SPI transfer callback.
+ */
+typedef void (*hal_spi_xfer_cb_t)(void *ip, hal_spi_transaction_t *tp);
+#endif /* SPI_USE_TRANSACTIONS_QUEUE == TRUE */
+
 /* Inclusion of LLD header.*/
 #include "hal_spi_lld.h"
 
@@ -227,6 +279,91 @@ struct hal_spi_config {
 #endif /* defined(SPI_CONFIG_EXT_FIELS) */
 };
 
+#if (SPI_USE_TRANSACTIONS_QUEUE == TRUE) || defined (__DOXYGEN__)
+/**
+ * @brief       Structure representing a SPI transfer descriptor.
+ * @details     Descriptors are chained into lists, each list is a transaction
+ *              executed back-to-back by the driver. The descriptors are not
+ *              modified by the driver so lists can be prebuilt and placed in
+ *              constant memory.
+ * @note        If both @p txbuf and @p rxbuf are @p NULL then idle frames are
+ *              transmitted and the received data is ignored.
+ */
+struct hal_spi_transfer {
+  /**
+   * @brief       Next transfer in the transaction, @p NULL for the last one.
+   */
+  const hal_spi_transfer_t  *next;
+  /**
+   * @brief       Configuration applied before the transfer, @p NULL keeps the
+   *              current one.
+   */
+  const hal_spi_config_t    *config;
+  /**
+   * @brief       Transfer flags, @p SPI_XFER_SELECT and @p SPI_XFER_UNSELECT.
+   */
+  uint32_t                  flags;
+  /**
+   * @brief       Number of frames to be transferred.
+   */
+  size_t                    n;
+  /**
+   * @brief       Transmit buffer, @p NULL for a receive only transfer.
+   */
+  const void                *txbuf;
+  /**
+   * @brief       Receive buffer, @p NULL for a transmit only transfer.
+   */
+  void                      *rxbuf;
+  /**
+   * @brief       Callback invoked at the end of the transfer.
+   * @note        Can be @p NULL.
+   */
+  hal_spi_xfer_cb_t         cb;
+};
+
+/**
+ * @brief       Structure representing a SPI transaction.
+ * @details     A transaction is a list of transfers executed back-to-back,
+ *              transactions are queued in priority order and are never
+ *              interleaved on the bus.
+ */
+struct hal_spi_transaction {
+  /**
+   * @brief       Next transaction in the driver queue.
+   */
+  hal_spi_transaction_t     *next;
+  /**
+   * @brief       First transfer of the transaction.
+   */
+  const hal_spi_transfer_t  *xfers;
+  /**
+   * @brief       Transfer being executed.
+   */
+  const hal_spi_transfer_t  *xfer;
+  /**
+   * @brief       Transaction priority, higher values are served first.
+   */
+  uint32_t                  prio;
+  /**
+   * @brief       Transaction argument, not used by the driver.
+   */
+  void                      *arg;
+  /**
+   * @brief       Transaction completed flag.
+   */
+  bool                      done;
+  /**
+   * @brief       Transaction result, valid when @p done is set.
+   */
+  msg_t                     msg;
+  /**
+   * @brief       Thread waiting for the transaction completion.
+   */
+  thread_reference_t        tr;
+};
+#endif /* SPI_USE_TRANSACTIONS_QUEUE == TRUE */
+
 /**
  * @class       hal_spi_driver_c
  * @extends     base_object_c, hal_base_driver_c, hal_cb_driver_c.
@@ -308,6 +445,16 @@ struct hal_spi_driver {
    */
   thread_reference_t        sync_transfer;
 #endif /* SPI_USE_SYNCHRONIZATION == TRUE */
+#if (SPI_USE_TRANSACTIONS_QUEUE == TRUE) || defined (__DOXYGEN__)
+  /**
+   * @brief       Pending transactions, in priority order.
+   */
+  hal_spi_transaction_t     *tqueue;
+  /**
+   * @brief       Transaction being executed.
+   */
+  hal_spi_transaction_t     *tactive;
+#endif /* SPI_USE_TRANSACTIONS_QUEUE == TRUE */
 #if defined(SPI_DRIVER_EXT_FIELS)
   SPI_DRIVER_EXT_FIELDS
 #endif
@@ -347,8 +494,20 @@ extern "C" {
   msg_t spiSend(void *ip, size_t n, const void *txbuf);
   msg_t spiReceive(void *ip, size_t n, void *rxbuf);
 #endif /* SPI_USE_SYNCHRONIZATION == TRUE */
+#if (SPI_USE_TRANSACTIONS_QUEUE == TRUE) || defined (__DOXYGEN__)
+  void spiQueueSubmitI(void *ip, hal_spi_transaction_t *tp);
+  void spiQueueSubmit(void *ip, hal_spi_transaction_t *tp);
+  msg_t spiQueueWaitS(void *ip, hal_spi_transaction_t *tp);
+  msg_t spiQueueExecute(void *ip, hal_spi_transaction_t *tp);
+  void __spi_queue_isr_code(void *ip, msg_t msg);
+#endif /* SPI_USE_TRANSACTIONS_QUEUE == TRUE */
   /* Regular functions.*/
   void spiInit(void);
+#if (SPI_USE_TRANSACTIONS_QUEUE == TRUE) || defined (__DOXYGEN__)
+  void spiTransactionObjectInit(hal_spi_transaction_t *tp,
+                                const hal_spi_transfer_t *xfers,
+                                uint32_t prio, void *arg);
+#endif /* SPI_USE_TRANSACTIONS_QUEUE == TRUE */
 #ifdef __cplusplus
 }
 #endif
@@ -380,6 +539,82 @@ static inline hal_spi_driver_c *spiObjectInit(hal_spi_driver_c *self) {
 }
 /** @} */
 
+/**
+ * @name        Statically bound methods of hal_spi_driver_c
+ * @{
+ */
+/**
+ * @memberof    hal_spi_driver_c
+ * @public
+ *
+ * @brief       Low level driver start.
+ *
+ * @param[in,out] self          Pointer to a @p hal_spi_driver_c instance.
+ * @return                      The operation status.
+ *
+ * @notapi
+ */
+CC_FORCE_INLINE
+static inline msg_t __spi_start(hal_spi_driver_c *self) {
+
+  return __spi_start_impl(self);
+}
+
+/**
+ * @memberof    hal_spi_driver_c
+ * @public
+ *
+ * @brief       Low level driver stop.
+ *
+ * @param[in,out] self          Pointer to a @p hal_spi_driver_c instance.
+ *
+ * @notapi
+ */
+CC_FORCE_INLINE
+static inline void __spi_stop(hal_spi_driver_c *self) {
+
+  __spi_stop_impl(self);
+}
+
+/**
+ * @memberof    hal_spi_driver_c
+ * @public
+ *
+ * @brief       Performs driver configuration.
+ *
+ * @param[in,out] self          Pointer to a @p hal_spi_driver_c instance.
+ * @param[in]     config        New driver configuration.
+ * @return                      The configuration pointer.
+ * @retval NULL                 If the configuration has been rejected.
+ *
+ * @api
+ */
+CC_FORCE_INLINE
+static inline const void *__spi_doconf(hal_spi_driver_c *self,
+                                       const void *config) {
+
+  return __spi_doconf_impl(self, config);
+}
+
+/**
+ * @memberof    hal_spi_driver_c
+ * @public
+ *
+ * @brief       Associates a callback to the driver instance.
+ *
+ * @param[in,out] self          Pointer to a @p hal_spi_driver_c instance.
+ * @param         cb            Callback function to be associated. Passing @p
+ *                              NULL disables the existing callback, if any.
+ *
+ * @xclass
+ */
+CC_FORCE_INLINE
+static inline void spiSetcb(hal_spi_driver_c *self, hal_cb_t cb) {
+
+  __cbdrv_setcb_impl(self, cb);
+}
+/** @} */
+
 /**
  * @name        Inline methods of hal_spi_driver_c
  * @{
@@ -463,6 +698,21 @@ static inline void spiUnselectX(void *ip) {
 
   palSetPad(__spi_getfield(self, ssport), __spi_getfield(self, sspad));
 }
+
+#elif SPI_SELECT_MODE == SPI_SELECT_MODE_NONE
+CC_FORCE_INLINE
+static inline void spiSelectX(void *ip) {
+  hal_spi_driver_c *self = (hal_spi_driver_c *)ip;
+
+  (void)self;
+}
+
+CC_FORCE_INLINE
+static inline void spiUnselectX(void *ip) {
+  hal_spi_driver_c *self = (hal_spi_driver_c *)ip;
+
+  (void)self;
+}
 #endif /* SPI_SELECT_MODE == SPI_SELECT_MODE_LLD */
 
 #if (SPI_USE_SYNCHRONIZATION == TRUE) || defined (__DOXYGEN__)
@@ -520,6 +770,13 @@ CC_FORCE_INLINE
 static inline void __spi_isr_complete_code(void *ip) {
   hal_spi_driver_c *self = (hal_spi_driver_c *)ip;
 
+#if SPI_USE_TRANSACTIONS_QUEUE == TRUE
+  if (self->tactive != NULL) {
+    __spi_queue_isr_code(self, MSG_OK);
+    return;
+  }
+#endif
+
   __cbdrv_invoke_cb_with_transition(self,
                                     HAL_DRV_STATE_COMPLETE,
                                     HAL_DRV_STATE_READY);
@@ -589,6 +846,13 @@ CC_FORCE_INLINE
 static inline void __spi_isr_error_code(void *ip, msg_t msg) {
   hal_spi_driver_c *self = (hal_spi_driver_c *)ip;
 
+#if SPI_USE_TRANSACTIONS_QUEUE == TRUE
+  if (self->tactive != NULL) {
+    __spi_queue_isr_code(self, msg);
+    return;
+  }
+#endif
+
   __cbdrv_invoke_cb_with_transition(self,
                                     HAL_DRV_STATE_ERROR,
                                     HAL_DRV_STATE_READY);
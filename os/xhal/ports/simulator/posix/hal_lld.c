@@ -0,0 +1,297 @@
+/*
+    ChibiOS - Copyright (C) 2006..2018 Giovanni Di Sirio
+
+    Licensed under the Apache License, Version 2.0 (the "License");
+    you may not use this file except in compliance with the License.
+    You may obtain a copy of the License at
+
+        http://www.apache.org/licenses/LICENSE-2.0
+
+    Unless required by applicable law or agreed to in writing, software
+    distributed under the License is distributed on an "AS IS" BASIS,
+    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+    See the License for the specific language governing permissions and
+    limitations under the License.
+*/
+
+/**
+ * @file    simulator/posix/hal_lld.c
+ * @brief   Posix simulator HAL subsystem low level driver code.
+ *
+ * @addtogroup POSIX_HAL
+ * @{
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include "hal.h"
+
+#if SIM_EVENT_DRIVEN == TRUE
+#include <errno.h>
+#include <sys/timerfd.h>
+#endif
+
+/*===========================================================================*/
+/* Driver local definitions.                                                 */
+/*===========================================================================*/
+
+#define NS_PER_SEC                          1000000000U
+
+/* Ports not specifying it use microseconds.*/
+#if !defined(PORT_SIM_RT_FREQUENCY)
+#define PORT_SIM_RT_FREQUENCY               1000000U
+#endif
+
+/*===========================================================================*/
+/* Driver exported variables.                                                */
+/*===========================================================================*/
+
+/*===========================================================================*/
+/* Driver local variables and types.                                         */
+/*===========================================================================*/
+
+#if (SIM_EVENT_DRIVEN == TRUE) || defined(__DOXYGEN__)
+/**
+ * @brief   Timer descriptor armed on the next deadline while idle.
+ */
+static int sim_timer_fd;
+#endif
+
+#if (SIM_VIRTUAL_TIME == TRUE) || defined(__DOXYGEN__)
+/**
+ * @brief   Simulated CPU cycles since startup.
+ */
+static uint64_t sim_cycles;
+#endif
+
+/*===========================================================================*/
+/* Driver local functions.                                                   */
+/*===========================================================================*/
+
+/**
+ * @brief   Serves the pending simulated interrupts.
+ *
+ * @return              The interrupt status.
+ * @retval false        if no interrupt has been served.
+ * @retval true         if at least one interrupt has been served.
+ */
+static bool sim_serve_interrupts(void) {
+  bool int_occurred = false;
+
+
+#if HAL_USE_SPI
+  if (spi_lld_interrupt_pending()) {
+    int_occurred = true;
+  }
+#endif
+
+
+#if OSAL_ST_MODE != OSAL_ST_MODE_NONE
+  if (st_lld_interrupt_pending()) {
+    int_occurred = true;
+  }
+#endif
+
+  if (int_occurred) {
+    __dbg_check_lock();
+    if (chSchIsPreemptionRequired())
+      chSchDoPreemption();
+    __dbg_check_unlock();
+  }
+
+  return int_occurred;
+}
+
+#if (SIM_EVENT_DRIVEN == TRUE) || (SIM_VIRTUAL_TIME == TRUE) ||             \
+    defined(__DOXYGEN__)
+/**
+ * @brief   Returns the earliest deadline of the simulated peripherals.
+ *
+ * @return              The deadline in nanoseconds.
+ * @retval 0            if there is no pending deadline.
+ */
+static uint64_t sim_get_deadline(void) {
+  uint64_t deadline = 0U;
+
+#if OSAL_ST_MODE != OSAL_ST_MODE_NONE
+  deadline = st_lld_get_deadline();
+#endif
+
+#if HAL_USE_SPI
+  {
+    uint64_t t = spi_lld_get_deadline();
+
+    if ((t != 0U) && ((deadline == 0U) || (t < deadline))) {
+      deadline = t;
+    }
+  }
+#endif
+
+
+  return deadline;
+}
+#endif /* (SIM_EVENT_DRIVEN == TRUE) || (SIM_VIRTUAL_TIME == TRUE) */
+
+#if (SIM_EVENT_DRIVEN == TRUE) || defined(__DOXYGEN__)
+/**
+ * @brief   Suspends the host process until a deadline.
+ *
+ * @param[in] deadline  the @p CLOCK_MONOTONIC deadline in nanoseconds or
+ *                      zero for no deadline
+ */
+static void sim_wait_events(uint64_t deadline) {
+  struct pollfd fds[1];
+  struct itimerspec its;
+
+  /* The timer is disarmed if there is no deadline.*/
+  memset(&its, 0, sizeof (its));
+  its.it_value.tv_sec  = (time_t)(deadline / NS_PER_SEC);
+  its.it_value.tv_nsec = (long)(deadline % NS_PER_SEC);
+  (void) timerfd_settime(sim_timer_fd, TFD_TIMER_ABSTIME, &its, NULL);
+
+  fds[0].fd      = sim_timer_fd;
+  fds[0].events  = POLLIN;
+  fds[0].revents = 0;
+
+  if ((poll(fds, 1, -1) > 0) && ((fds[0].revents & POLLIN) != 0)) {
+    uint64_t expirations;
+
+    (void) read(sim_timer_fd, &expirations, sizeof (expirations));
+  }
+}
+#endif /* SIM_EVENT_DRIVEN == TRUE */
+
+/*===========================================================================*/
+/* Driver interrupt handlers.                                                */
+/*===========================================================================*/
+
+/*===========================================================================*/
+/* Driver exported functions.                                                */
+/*===========================================================================*/
+
+/**
+ * @brief Low level HAL driver initialization.
+ */
+void hal_lld_init(void) {
+
+#if defined(__APPLE__)
+  puts("ChibiOS/RT simulator (OS X)\n");
+#else
+  puts("ChibiOS/RT simulator (Linux)\n");
+#endif
+
+#if SIM_EVENT_DRIVEN == TRUE
+  sim_timer_fd = timerfd_create(CLOCK_MONOTONIC, TFD_NONBLOCK | TFD_CLOEXEC);
+  if (sim_timer_fd == -1) {
+    printf("Unable to create the simulator timer (error %d)\n", errno);
+    exit(1);
+  }
+#endif
+
+#if SIM_VIRTUAL_TIME == TRUE
+  sim_cycles = 0U;
+#endif
+}
+
+/**
+ * @brief   Returns the simulator time.
+ * @details This is the time base of all the simulated peripherals, in
+ *          virtual time mode it is derived from the simulated CPU cycles
+ *          else it is the host @p CLOCK_MONOTONIC time.
+ *
+ * @return              The simulator time in nanoseconds.
+ */
+uint64_t _sim_get_time(void) {
+#if SIM_VIRTUAL_TIME == TRUE
+
+  return ((sim_cycles / SIM_VT_FREQUENCY) * NS_PER_SEC) +
+         (((sim_cycles % SIM_VT_FREQUENCY) * NS_PER_SEC) / SIM_VT_FREQUENCY);
+#else
+  struct timespec ts;
+
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return ((uint64_t)ts.tv_sec * NS_PER_SEC) + (uint64_t)ts.tv_nsec;
+#endif
+}
+
+/**
+ * @brief   Returns the realtime counter value.
+ *
+ * @return              The simulated CPU cycles in virtual time mode else
+ *                      the host time at @p PORT_SIM_RT_FREQUENCY.
+ */
+uint64_t _sim_get_rt_counter(void) {
+#if SIM_VIRTUAL_TIME == TRUE
+
+  return sim_cycles;
+#else
+
+  return _sim_get_time() / (NS_PER_SEC / PORT_SIM_RT_FREQUENCY);
+#endif
+}
+
+/**
+ * @brief   Interrupt simulation.
+ * @note    In virtual time mode each call accounts for
+ *          @p SIM_VT_POLL_CYCLES of CPU time.
+ */
+void _sim_check_for_interrupts(void) {
+
+#if SIM_VIRTUAL_TIME == TRUE
+  sim_cycles += SIM_VT_POLL_CYCLES;
+#endif
+
+  (void) sim_serve_interrupts();
+}
+
+/**
+ * @brief   Interrupt simulation while idle.
+ * @details Pending interrupts are served immediately. If there is none then,
+ *          in virtual time mode, time jumps to the earliest peripheral
+ *          deadline else the host process is suspended until the deadline
+ *          expires or activity is detected on the simulated peripherals.
+ * @note    Without @p SIM_EVENT_DRIVEN nor @p SIM_VIRTUAL_TIME this is
+ *          equivalent to @p _sim_check_for_interrupts().
+ */
+void _sim_wait_for_interrupts(void) {
+#if (SIM_EVENT_DRIVEN == TRUE) || (SIM_VIRTUAL_TIME == TRUE)
+  uint64_t deadline;
+
+  if (sim_serve_interrupts()) {
+    return;
+  }
+
+  deadline = sim_get_deadline();
+
+#if SIM_VIRTUAL_TIME == TRUE
+  if (deadline != 0U) {
+    uint64_t cycles;
+
+    /* All threads are idle, skipping the idle time.*/
+    cycles = ((deadline / NS_PER_SEC) * SIM_VT_FREQUENCY) +
+             ((((deadline % NS_PER_SEC) * SIM_VT_FREQUENCY) +
+               NS_PER_SEC - 1U) / NS_PER_SEC);
+    if (cycles > sim_cycles) {
+      sim_cycles = cycles;
+    }
+  }
+#if SIM_EVENT_DRIVEN == TRUE
+  else {
+    /* Nothing scheduled, only external events can wake the system.*/
+    sim_wait_events(0U);
+  }
+#endif
+#else
+  sim_wait_events(deadline);
+#endif
+
+  (void) sim_serve_interrupts();
+#else
+  (void) sim_serve_interrupts();
+#endif
+}
+
+/** @} */
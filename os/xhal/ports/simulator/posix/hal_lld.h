@@ -0,0 +1,129 @@
+/*
+    ChibiOS - Copyright (C) 2006..2018 Giovanni Di Sirio
+
+    Licensed under the Apache License, Version 2.0 (the "License");
+    you may not use this file except in compliance with the License.
+    You may obtain a copy of the License at
+
+        http://www.apache.org/licenses/LICENSE-2.0
+
+    Unless required by applicable law or agreed to in writing, software
+    distributed under the License is distributed on an "AS IS" BASIS,
+    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+    See the License for the specific language governing permissions and
+    limitations under the License.
+*/
+
+/**
+ * @file    simulator/posix/hal_lld.h
+ * @brief   Posix simulator HAL subsystem low level driver header.
+ *
+ * @addtogroup POSIX_HAL
+ * @{
+ */
+
+#ifndef HAL_LLD_H
+#define HAL_LLD_H
+
+#include <sys/types.h>
+#include <unistd.h>
+#include <poll.h>
+#include <stdio.h>
+
+/*===========================================================================*/
+/* Driver constants.                                                         */
+/*===========================================================================*/
+
+/**
+ * @brief   Platform name.
+ */
+#define PLATFORM_NAME   "Posix Simulator"
+
+/*===========================================================================*/
+/* Driver pre-compile time settings.                                         */
+/*===========================================================================*/
+
+/**
+ * @brief   Event-driven simulation switch.
+ * @details If set to @p TRUE the idle loop suspends the host process until
+ *          the next timer or peripheral deadline, else the idle loop keeps
+ *          polling for simulated interrupts.
+ * @note    The default is @p TRUE on Linux hosts.
+ */
+#if !defined(SIM_EVENT_DRIVEN) || defined(__DOXYGEN__)
+#if defined(__linux__) || defined(__DOXYGEN__)
+#define SIM_EVENT_DRIVEN                    TRUE
+#else
+#define SIM_EVENT_DRIVEN                    FALSE
+#endif
+#endif
+
+/**
+ * @brief   Virtual time switch.
+ * @details If set to @p TRUE the simulator time is decoupled from the host
+ *          clock: it advances by @p SIM_VT_POLL_CYCLES on each interrupts
+ *          check performed by a running thread and, when all threads are
+ *          idle, it jumps straight to the next peripheral deadline. The
+ *          realtime counter counts simulated CPU cycles.
+ * @note    Execution becomes deterministic.
+ * @note    Busy loops must call @p _sim_check_for_interrupts() or time
+ *          does not advance.
+ * @note    The default is @p FALSE.
+ */
+#if !defined(SIM_VIRTUAL_TIME) || defined(__DOXYGEN__)
+#define SIM_VIRTUAL_TIME                    FALSE
+#endif
+
+/**
+ * @brief   Simulated CPU clock frequency in virtual time mode.
+ */
+#if !defined(SIM_VT_FREQUENCY) || defined(__DOXYGEN__)
+#define SIM_VT_FREQUENCY                    100000000U
+#endif
+
+/**
+ * @brief   Simulated CPU cycles consumed by each interrupts check.
+ */
+#if !defined(SIM_VT_POLL_CYCLES) || defined(__DOXYGEN__)
+#define SIM_VT_POLL_CYCLES                  100U
+#endif
+
+/*===========================================================================*/
+/* Derived constants and error checks.                                       */
+/*===========================================================================*/
+
+#if (SIM_EVENT_DRIVEN == TRUE) && !defined(__linux__)
+#error "SIM_EVENT_DRIVEN requires a Linux host"
+#endif
+
+#if (SIM_VT_FREQUENCY < 1000000U) || (SIM_VT_FREQUENCY > 1000000000U)
+#error "SIM_VT_FREQUENCY out of range"
+#endif
+
+#if SIM_VT_POLL_CYCLES < 1U
+#error "invalid SIM_VT_POLL_CYCLES value"
+#endif
+
+/*===========================================================================*/
+/* Driver data structures and types.                                         */
+/*===========================================================================*/
+
+/*===========================================================================*/
+/* External declarations.                                                    */
+/*===========================================================================*/
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+  void hal_lld_init(void);
+  void _sim_check_for_interrupts(void);
+  void _sim_wait_for_interrupts(void);
+  uint64_t _sim_get_time(void);
+  uint64_t _sim_get_rt_counter(void);
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* HAL_LLD_H */
+
+/** @} */
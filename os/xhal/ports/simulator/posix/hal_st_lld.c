@@ -0,0 +1,261 @@
+/*
+    ChibiOS - Copyright (C) 2006..2018 Giovanni Di Sirio
+
+    Licensed under the Apache License, Version 2.0 (the "License");
+    you may not use this file except in compliance with the License.
+    You may obtain a copy of the License at
+
+        http://www.apache.org/licenses/LICENSE-2.0
+
+    Unless required by applicable law or agreed to in writing, software
+    distributed under the License is distributed on an "AS IS" BASIS,
+    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+    See the License for the specific language governing permissions and
+    limitations under the License.
+*/
+
+/**
+ * @file    simulator/posix/hal_st_lld.c
+ * @brief   Posix simulator ST subsystem low level driver code.
+ * @details The system time is derived from the simulator time, the driver
+ *          exposes the time of the next pending event so that the simulator
+ *          can sleep or skip until then instead of polling.
+ *
+ * @addtogroup POSIX_ST
+ * @{
+ */
+
+#include "hal.h"
+
+#if (OSAL_ST_MODE != OSAL_ST_MODE_NONE) || defined(__DOXYGEN__)
+
+/*===========================================================================*/
+/* Driver local definitions.                                                 */
+/*===========================================================================*/
+
+#define NS_PER_SEC                          1000000000U
+
+/*===========================================================================*/
+/* Driver exported variables.                                                */
+/*===========================================================================*/
+
+/*===========================================================================*/
+/* Driver local types.                                                       */
+/*===========================================================================*/
+
+/*===========================================================================*/
+/* Driver local variables and types.                                         */
+/*===========================================================================*/
+
+/**
+ * @brief   Simulator time corresponding to the system time zero.
+ */
+static uint64_t st_base;
+
+/**
+ * @brief   Alarm time expanded to 64 bits.
+ */
+static uint64_t st_alarm;
+
+/**
+ * @brief   Alarm enabled.
+ */
+static bool st_active;
+
+/**
+ * @brief   Alarm armed, cleared when the alarm triggers.
+ */
+static bool st_armed;
+
+/*===========================================================================*/
+/* Driver local functions.                                                   */
+/*===========================================================================*/
+
+/**
+ * @brief   Returns the number of ticks elapsed since initialization.
+ */
+static uint64_t st_lld_get_ticks(void) {
+  uint64_t ns = _sim_get_time() - st_base;
+
+  return ((ns / NS_PER_SEC) * OSAL_ST_FREQUENCY) +
+         (((ns % NS_PER_SEC) * OSAL_ST_FREQUENCY) / NS_PER_SEC);
+}
+
+/**
+ * @brief   Simulator time of the beginning of the specified tick.
+ */
+static uint64_t st_lld_ticks_to_ns(uint64_t ticks) {
+
+  return st_base + ((ticks / OSAL_ST_FREQUENCY) * NS_PER_SEC) +
+         ((((ticks % OSAL_ST_FREQUENCY) * NS_PER_SEC) +
+           OSAL_ST_FREQUENCY - 1U) / OSAL_ST_FREQUENCY);
+}
+
+/*===========================================================================*/
+/* Driver interrupt handlers.                                                */
+/*===========================================================================*/
+
+/*===========================================================================*/
+/* Driver exported functions.                                                */
+/*===========================================================================*/
+
+/**
+ * @brief   Low level ST driver initialization.
+ *
+ * @notapi
+ */
+void st_lld_init(void) {
+
+  st_base = _sim_get_time();
+#if OSAL_ST_MODE == OSAL_ST_MODE_PERIODIC
+  /* In periodic mode the alarm is always armed on the next tick.*/
+  st_alarm  = 1U;
+  st_active = true;
+  st_armed  = true;
+#else
+  st_alarm  = 0U;
+  st_active = false;
+  st_armed  = false;
+#endif
+}
+
+#if (OSAL_ST_MODE == OSAL_ST_MODE_FREERUNNING) || defined(__DOXYGEN__)
+/**
+ * @brief   Returns the time counter value.
+ *
+ * @return              The counter value.
+ *
+ * @notapi
+ */
+systime_t st_lld_get_counter(void) {
+
+  return (systime_t)st_lld_get_ticks();
+}
+
+/**
+ * @brief   Starts the alarm.
+ * @note    Makes sure that no spurious alarms are triggered after
+ *          this call.
+ *
+ * @param[in] time      the time to be set for the first alarm
+ *
+ * @notapi
+ */
+void st_lld_start_alarm(systime_t time) {
+
+  st_active = true;
+  st_lld_set_alarm(time);
+}
+
+/**
+ * @brief   Stops the alarm interrupt.
+ *
+ * @notapi
+ */
+void st_lld_stop_alarm(void) {
+
+  st_active = false;
+  st_armed  = false;
+}
+
+/**
+ * @brief   Sets the alarm time.
+ * @note    A time already in the past triggers the alarm immediately, this
+ *          is the only difference from a real compare unit.
+ *
+ * @param[in] time      the time to be set for the next alarm
+ *
+ * @notapi
+ */
+void st_lld_set_alarm(systime_t time) {
+  uint64_t now = st_lld_get_ticks();
+  systime_t delta = (systime_t)(time - (systime_t)now);
+
+  /* Deltas in the upper half of the counter range are in the past.*/
+  if (delta > ((systime_t)-1 / (systime_t)2)) {
+    delta = (systime_t)0;
+  }
+  st_alarm = now + (uint64_t)delta;
+  st_armed = true;
+}
+
+/**
+ * @brief   Returns the current alarm time.
+ *
+ * @return              The currently set alarm time.
+ *
+ * @notapi
+ */
+systime_t st_lld_get_alarm(void) {
+
+  return (systime_t)st_alarm;
+}
+
+/**
+ * @brief   Determines if the alarm is active.
+ *
+ * @return              The alarm status.
+ * @retval false        if the alarm is not active.
+ * @retval true         is the alarm is active
+ *
+ * @notapi
+ */
+bool st_lld_is_alarm_active(void) {
+
+  return st_active;
+}
+#endif /* OSAL_ST_MODE == OSAL_ST_MODE_FREERUNNING */
+
+/**
+ * @brief   Returns the simulator time of the next alarm.
+ *
+ * @return              The time of the next alarm in nanoseconds.
+ * @retval 0            if there is no pending alarm.
+ *
+ * @notapi
+ */
+uint64_t st_lld_get_deadline(void) {
+
+  if (!st_armed) {
+    return 0U;
+  }
+  return st_lld_ticks_to_ns(st_alarm);
+}
+
+/**
+ * @brief   Timer interrupt simulation.
+ *
+ * @return              The interrupt status.
+ * @retval false        if the alarm did not trigger.
+ * @retval true         if the alarm triggered and has been served.
+ *
+ * @notapi
+ */
+bool st_lld_interrupt_pending(void) {
+
+  if (!st_armed || (st_lld_get_ticks() < st_alarm)) {
+    return false;
+  }
+
+#if OSAL_ST_MODE == OSAL_ST_MODE_PERIODIC
+  /* One tick served per call, missed ticks are recovered on the following
+     calls without drifting.*/
+  st_alarm += 1U;
+#else
+  st_armed = false;
+#endif
+
+  OSAL_IRQ_PROLOGUE();
+
+  osalSysLockFromISR();
+  osalOsTimerHandlerI();
+  osalSysUnlockFromISR();
+
+  OSAL_IRQ_EPILOGUE();
+
+  return true;
+}
+
+#endif /* OSAL_ST_MODE != OSAL_ST_MODE_NONE */
+
+/** @} */
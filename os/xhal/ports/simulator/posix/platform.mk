@@ -0,0 +1,11 @@
+# List of all the Posix platform files.
+PLATFORMSRC := ${CHIBIOS}/os/xhal/ports/simulator/posix/hal_lld.c \
+               ${CHIBIOS}/os/xhal/ports/simulator/posix/hal_st_lld.c \
+               ${CHIBIOS}/os/xhal/ports/simulator/posix/hal_spi_lld.c
+
+# Required include directories.
+PLATFORMINC := ${CHIBIOS}/os/xhal/ports/simulator/posix
+
+# Shared variables
+ALLCSRC += $(PLATFORMSRC)
+ALLINC  += $(PLATFORMINC)
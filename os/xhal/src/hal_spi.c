@@ -51,6 +51,81 @@
 /* Module local functions.                                                   */
 /*===========================================================================*/
 
+#if (SPI_USE_TRANSACTIONS_QUEUE == TRUE) || defined (__DOXYGEN__)
+/**
+ * @brief       Starts a transfer of the active transaction.
+ *
+ * @param[in,out] spip          Pointer to the @p hal_spi_driver_c object.
+ * @param[in]     xp            Pointer to the transfer descriptor.
+ * @return                      The operation status.
+ */
+static msg_t spi_xfer_start(hal_spi_driver_c *spip,
+                            const hal_spi_transfer_t *xp) {
+
+  spip->tactive->xfer = xp;
+
+  if (xp->config != NULL) {
+    const void *config = __drv_do_configure(spip, xp->config);
+
+    if (config == NULL) {
+      return HAL_RET_CONFIG_ERROR;
+    }
+    spip->config = config;
+  }
+
+#if SPI_SUPPORTS_CIRCULAR
+  osalDbgAssert(__spi_getfield(spip, circular) == false, "circular mode");
+#endif
+
+  if ((xp->flags & SPI_XFER_SELECT) != 0U) {
+    spiSelectX(spip);
+  }
+
+  spip->state = HAL_DRV_STATE_ACTIVE;
+  if (xp->txbuf == NULL) {
+    if (xp->rxbuf == NULL) {
+      return spi_lld_ignore(spip, xp->n);
+    }
+    return spi_lld_receive(spip, xp->n, xp->rxbuf);
+  }
+  if (xp->rxbuf == NULL) {
+    return spi_lld_send(spip, xp->n, xp->txbuf);
+  }
+  return spi_lld_exchange(spip, xp->n, xp->txbuf, xp->rxbuf);
+}
+
+/**
+ * @brief       Starts the next pending transaction.
+ * @details     Transactions failing to start are completed with an error and
+ *              the next one is tried, the driver returns to
+ *              @p HAL_DRV_STATE_READY state when the queue is empty.
+ *
+ * @param[in,out] spip          Pointer to the @p hal_spi_driver_c object.
+ */
+static void spi_queue_next(hal_spi_driver_c *spip) {
+  hal_spi_transaction_t *tp;
+
+  while ((tp = spip->tqueue) != NULL) {
+    msg_t msg;
+
+    spip->tqueue  = tp->next;
+    spip->tactive = tp;
+    msg = spi_xfer_start(spip, tp->xfers);
+    if (msg == HAL_RET_SUCCESS) {
+      return;
+    }
+
+    spiUnselectX(spip);
+    tp->done = true;
+    tp->msg  = msg;
+    osalThreadResumeI(&tp->tr, msg);
+  }
+
+  spip->tactive = NULL;
+  spip->state   = HAL_DRV_STATE_READY;
+}
+#endif /* SPI_USE_TRANSACTIONS_QUEUE == TRUE */
+
 /*===========================================================================*/
 /* Module exported functions.                                                */
 /*===========================================================================*/
@@ -67,6 +142,33 @@ void spiInit(void) {
   spi_lld_init();
 }
 
+#if (SPI_USE_TRANSACTIONS_QUEUE == TRUE) || defined (__DOXYGEN__)
+/**
+ * @brief       Initializes a SPI transaction object.
+ *
+ * @param[out]    tp            Pointer to the transaction object.
+ * @param[in]     xfers         Pointer to the first transfer descriptor.
+ * @param[in]     prio          Transaction priority, higher values are served
+ *                              first.
+ * @param[in]     arg           Transaction argument.
+ *
+ * @init
+ */
+void spiTransactionObjectInit(hal_spi_transaction_t *tp,
+                              const hal_spi_transfer_t *xfers,
+                              uint32_t prio, void *arg) {
+
+  tp->next  = NULL;
+  tp->xfers = xfers;
+  tp->xfer  = NULL;
+  tp->prio  = prio;
+  tp->arg   = arg;
+  tp->done  = false;
+  tp->msg   = MSG_OK;
+  tp->tr    = NULL;
+}
+#endif /* SPI_USE_TRANSACTIONS_QUEUE == TRUE */
+
 /*===========================================================================*/
 /* Module class "hal_spi_driver_c" methods.                                  */
 /*===========================================================================*/
@@ -94,6 +196,10 @@ void *__spi_objinit_impl(void *ip, const void *vmt) {
   __cbdrv_objinit_impl(self, vmt);
 
   /* Initialization code.*/
+#if SPI_USE_TRANSACTIONS_QUEUE == TRUE
+  self->tqueue  = NULL;
+  self->tactive = NULL;
+#endif
 
   /* Optional, user-defined initializer.*/
 #if defined(SPI_DRIVER_EXT_INIT_HOOK)
@@ -746,6 +852,205 @@ msg_t spiReceive(void *ip, size_t n, void *rxbuf) {
   return msg;
 }
 #endif /* SPI_USE_SYNCHRONIZATION == TRUE */
+
+#if (SPI_USE_TRANSACTIONS_QUEUE == TRUE) || defined (__DOXYGEN__)
+/**
+ * @memberof    hal_spi_driver_c
+ * @public
+ *
+ * @brief       Submits a transaction to the driver queue.
+ * @details     The transaction is inserted in the queue after any other
+ *              pending transaction with equal or higher priority, if the
+ *              driver is idle then its execution is started immediately.
+ *              Transfers are chained from the completion ISR without threads
+ *              involvement.
+ * @note        The queue does not use the driver mutex, queued transactions
+ *              are not serialized with threads owning the driver through
+ *              @p drvLock().
+ * @pre         The driver must be in @p HAL_DRV_STATE_READY state or executing
+ *              queued transactions.
+ * @post        The transaction object must not be modified until its
+ *              completion.
+ *
+ * @param[in,out] ip            Pointer to a @p hal_spi_driver_c instance.
+ * @param[in,out] tp            Pointer to the transaction object.
+ *
+ * @iclass
+ */
+void spiQueueSubmitI(void *ip, hal_spi_transaction_t *tp) {
+  hal_spi_driver_c *self = (hal_spi_driver_c *)ip;
+  hal_spi_transaction_t **tpp;
+
+  osalDbgCheckClassI();
+
+  osalDbgCheck((self != NULL) && (tp != NULL) && (tp->xfers != NULL));
+
+  osalDbgAssert((self->state == HAL_DRV_STATE_READY) ||
+                (self->tactive != NULL), "not ready");
+
+  tp->xfer = NULL;
+  tp->done = false;
+  tp->msg  = MSG_OK;
+  tp->tr   = NULL;
+
+  /* Insertion after the last transaction with equal or higher priority.*/
+  tpp = &self->tqueue;
+  while ((*tpp != NULL) && ((*tpp)->prio >= tp->prio)) {
+    tpp = &(*tpp)->next;
+  }
+  tp->next = *tpp;
+  *tpp = tp;
+
+  /* Starting the queue execution if idle.*/
+  if (self->tactive == NULL) {
+    spi_queue_next(self);
+  }
+}
+
+/**
+ * @memberof    hal_spi_driver_c
+ * @public
+ *
+ * @brief       Submits a transaction to the driver queue.
+ * @details     The transaction is inserted in the queue after any other
+ *              pending transaction with equal or higher priority, if the
+ *              driver is idle then its execution is started immediately.
+ *              Transfers are chained from the completion ISR without threads
+ *              involvement.
+ * @note        The queue does not use the driver mutex, queued transactions
+ *              are not serialized with threads owning the driver through
+ *              @p drvLock().
+ * @pre         The driver must be in @p HAL_DRV_STATE_READY state or executing
+ *              queued transactions.
+ * @post        The transaction object must not be modified until its
+ *              completion.
+ *
+ * @param[in,out] ip            Pointer to a @p hal_spi_driver_c instance.
+ * @param[in,out] tp            Pointer to the transaction object.
+ *
+ * @api
+ */
+void spiQueueSubmit(void *ip, hal_spi_transaction_t *tp) {
+  hal_spi_driver_c *self = (hal_spi_driver_c *)ip;
+
+  osalSysLock();
+  spiQueueSubmitI(self, tp);
+  osalSysUnlock();
+}
+
+/**
+ * @memberof    hal_spi_driver_c
+ * @public
+ *
+ * @brief       Waits for a transaction completion.
+ * @note        Only one thread can wait on a transaction.
+ *
+ * @param[in,out] ip            Pointer to a @p hal_spi_driver_c instance.
+ * @param[in,out] tp            Pointer to a submitted transaction object.
+ * @return                      The transaction result.
+ * @retval MSG_OK               If all transfers have been performed.
+ * @retval HAL_RET_CONFIG_ERROR If a transfer configuration has been rejected.
+ * @retval HAL_RET_HW_FAILURE   If a transfer failed.
+ *
+ * @sclass
+ */
+msg_t spiQueueWaitS(void *ip, hal_spi_transaction_t *tp) {
+  hal_spi_driver_c *self = (hal_spi_driver_c *)ip;
+
+  osalDbgCheckClassS();
+
+  osalDbgCheck((self != NULL) && (tp != NULL));
+
+  if (!tp->done) {
+    (void) osalThreadSuspendS(&tp->tr);
+  }
+
+  return tp->msg;
+}
+
+/**
+ * @memberof    hal_spi_driver_c
+ * @public
+ *
+ * @brief       Submits a transaction and waits for its completion.
+ *
+ * @param[in,out] ip            Pointer to a @p hal_spi_driver_c instance.
+ * @param[in,out] tp            Pointer to the transaction object.
+ * @return                      The transaction result.
+ * @retval MSG_OK               If all transfers have been performed.
+ * @retval HAL_RET_CONFIG_ERROR If a transfer configuration has been rejected.
+ * @retval HAL_RET_HW_FAILURE   If a transfer failed.
+ *
+ * @api
+ */
+msg_t spiQueueExecute(void *ip, hal_spi_transaction_t *tp) {
+  hal_spi_driver_c *self = (hal_spi_driver_c *)ip;
+  msg_t msg;
+
+  osalSysLock();
+  spiQueueSubmitI(self, tp);
+  msg = spiQueueWaitS(self, tp);
+  osalSysUnlock();
+
+  return msg;
+}
+
+/**
+ * @memberof    hal_spi_driver_c
+ * @public
+ *
+ * @brief       Transactions queue ISR code.
+ * @details     This code is invoked at the end of each queued transfer:
+ *                - Slave unselect, if required by the transfer or on error.
+ *                - Transfer callback invocation.
+ *                - Next transfer start or transaction completion.
+ *                - Next transaction start, if any.
+ *                .
+ * @note        This function is meant to be used in the low level drivers
+ *              implementations only.
+ *
+ * @param[in,out] ip            Pointer to a @p hal_spi_driver_c instance.
+ * @param[in]     msg           The transfer result.
+ *
+ * @notapi
+ */
+void __spi_queue_isr_code(void *ip, msg_t msg) {
+  hal_spi_driver_c *self = (hal_spi_driver_c *)ip;
+  hal_spi_transaction_t *tp = self->tactive;
+  const hal_spi_transfer_t *xp = tp->xfer;
+
+  if ((msg != MSG_OK) || ((xp->flags & SPI_XFER_UNSELECT) != 0U)) {
+    spiUnselectX(self);
+  }
+
+  /* The transfer callback is invoked with the driver in the
+     HAL_DRV_STATE_COMPLETE or HAL_DRV_STATE_ERROR state.*/
+  if (xp->cb != NULL) {
+    self->state = msg == MSG_OK ? HAL_DRV_STATE_COMPLETE : HAL_DRV_STATE_ERROR;
+    xp->cb(self, tp);
+  }
+
+  osalSysLockFromISR();
+
+  /* Chaining the next transfer of the same transaction, if any.*/
+  if ((msg == MSG_OK) && (xp->next != NULL)) {
+    msg = spi_xfer_start(self, xp->next);
+    if (msg == HAL_RET_SUCCESS) {
+      osalSysUnlockFromISR();
+      return;
+    }
+    spiUnselectX(self);
+  }
+
+  /* Transaction completed, serving the next one.*/
+  tp->done = true;
+  tp->msg  = msg;
+  osalThreadResumeI(&tp->tr, msg);
+  spi_queue_next(self);
+
+  osalSysUnlockFromISR();
+}
+#endif /* SPI_USE_TRANSACTIONS_QUEUE == TRUE */
 /** @} */
 
 #endif /* HAL_USE_SPI == TRUE */
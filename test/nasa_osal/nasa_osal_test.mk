@@ -5,7 +5,8 @@ TESTSRC += ${CHIBIOS}/test/nasa_osal/source/test/nasa_osal_test_root.c \
            ${CHIBIOS}/test/nasa_osal/source/test/nasa_osal_test_sequence_003.c \
            ${CHIBIOS}/test/nasa_osal/source/test/nasa_osal_test_sequence_004.c \
            ${CHIBIOS}/test/nasa_osal/source/test/nasa_osal_test_sequence_005.c \
-           ${CHIBIOS}/test/nasa_osal/source/test/nasa_osal_test_sequence_006.c
+           ${CHIBIOS}/test/nasa_osal/source/test/nasa_osal_test_sequence_006.c \
+           ${CHIBIOS}/test/nasa_osal/source/test/nasa_osal_test_sequence_007.c
 
 # Required include directories
 TESTINC += ${CHIBIOS}/test/nasa_osal/source/test/
@@ -13,6 +13,7 @@
  * - @subpage nasa_osal_test_sequence_004
  * - @subpage nasa_osal_test_sequence_005
  * - @subpage nasa_osal_test_sequence_006
+ * - @subpage nasa_osal_test_sequence_007
  * .
  */
 
@@ -40,6 +41,7 @@ const testsequence_t * const nasa_osal_test_suite_array[] = {
   &nasa_osal_test_sequence_004,
   &nasa_osal_test_sequence_005,
   &nasa_osal_test_sequence_006,
+  &nasa_osal_test_sequence_007,
   NULL
 };
 
@@ -16,6 +16,7 @@
 #include "nasa_osal_test_sequence_004.h"
 #include "nasa_osal_test_sequence_005.h"
 #include "nasa_osal_test_sequence_006.h"
+#include "nasa_osal_test_sequence_007.h"
 
 #if !defined(__DOXYGEN__)
 
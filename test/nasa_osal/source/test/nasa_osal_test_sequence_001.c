@@ -267,6 +267,9 @@ static void nasa_osal_test_001_001_execute(void) {
     err = OS_TaskWait(tid);
     test_assert(err == OS_SUCCESS, "wait failed");
     test_assert_sequence("A", "task not executed");
+
+    err = OS_TaskGetIdByName(&tid, "running task");
+    test_assert(err == OS_ERR_NAME_NOT_FOUND, "name not released");
   }
   test_end_step(7);
 }
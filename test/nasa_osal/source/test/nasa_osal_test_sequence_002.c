@@ -20,6 +20,7 @@
  * - @subpage nasa_osal_test_002_002
  * - @subpage nasa_osal_test_002_003
  * - @subpage nasa_osal_test_002_004
+ * - @subpage nasa_osal_test_002_005
  * .
  */
 
@@ -48,6 +49,20 @@ static void test_task_writer(void) {
   }
 }
 
+static void test_task_reader(void) {
+  int32 err;
+  char data[MESSAGE_SIZE];
+  uint32 copied;
+
+  do {
+    err = OS_QueueGet(qid, data, MESSAGE_SIZE, &copied, OS_PEND);
+    if (err != OS_SUCCESS) {
+      test_emit_token('*');
+      return;
+    }
+  } while (copied > 0U);
+}
+
 /****************************************************************************
  * Test cases.
  ****************************************************************************/
@@ -383,6 +398,118 @@ static const testcase_t nasa_osal_test_002_004 = {
   nasa_osal_test_002_004_execute
 };
 
+/**
+ * @page nasa_osal_test_002_005 [2.5] OS_QueuePut() and OS_QueueGet() throughput
+ *
+ * <h2>Description</h2>
+ * A task reads from a queue in blocking mode, the number of messages posted
+ * into the queue in a one second time window is measured.
+ *
+ * <h2>Test Steps</h2>
+ * - [2.5.1] Creating a queue with depth 4 and message size 20.
+ * - [2.5.2] Creating the reader task at a priority higher than the current
+ *   task, each message is handed off directly to the blocked reader.
+ * - [2.5.3] The number of messages exchanged is counted in a one second
+ *   time window.
+ * - [2.5.4] Sending an empty message then waiting for task termination and
+ *   checking for errors.
+ * - [2.5.5] Score is printed.
+ * .
+ */
+
+static void nasa_osal_test_002_005_setup(void) {
+  qid = 0;
+  tid = 0;
+}
+
+static void nasa_osal_test_002_005_teardown(void) {
+  if (qid != 0) {
+    (void) OS_QueueDelete(qid);
+  }
+
+  if (tid != 0) {
+    (void) OS_TaskWait(tid);
+  }
+}
+
+static void nasa_osal_test_002_005_execute(void) {
+  uint32 n;
+
+  /* [2.5.1] Creating a queue with depth 4 and message size 20.*/
+  test_set_step(1);
+  {
+    int32 err;
+
+    err = OS_QueueCreate(&qid, "test queue", 4, MESSAGE_SIZE, 0);
+    test_assert(err == OS_SUCCESS, "queue creation failed");
+  }
+  test_end_step(1);
+
+  /* [2.5.2] Creating the reader task at a priority higher than the current
+     task, each message is handed off directly to the blocked reader.*/
+  test_set_step(2);
+  {
+    int32 err;
+
+    err = OS_TaskCreate(&tid,
+                        "reader task",
+                        test_task_reader,
+                        (uint32 *)wa_test1,
+                        sizeof wa_test1,
+                        TASKS_BASE_PRIORITY - 100,
+                        0);
+    test_assert(err == OS_SUCCESS, "reader task creation failed");
+  }
+  test_end_step(2);
+
+  /* [2.5.3] The number of messages exchanged is counted in a one second time
+     window.*/
+  test_set_step(3);
+  {
+    systime_t start, end;
+
+    n = 0;
+    chThdSleep(1);
+    start = chVTGetSystemTime();
+    end = chTimeAddX(start, TIME_MS2I(1000));
+    do {
+      (void) OS_QueuePut(qid, "Hello World", 12, 0);
+      n++;
+    #if defined(SIMULATOR)
+      _sim_check_for_interrupts();
+    #endif
+    } while (chVTIsSystemTimeWithinX(start, end));
+  }
+  test_end_step(3);
+
+  /* [2.5.4] Sending an empty message then waiting for task termination and
+     checking for errors.*/
+  test_set_step(4);
+  {
+    (void) OS_QueuePut(qid, "", 0, 0);
+    (void) OS_TaskWait(tid);
+    tid = 0;
+    test_assert_sequence("", "queue read errors occurred");
+  }
+  test_end_step(4);
+
+  /* [2.5.5] Score is printed.*/
+  test_set_step(5);
+  {
+    test_print("--- Score : ");
+    test_printn(n);
+    test_println(" msgs/S");
+  }
+  test_end_step(5);
+}
+
+static const testcase_t nasa_osal_test_002_005 = {
+  "OS_QueuePut() and OS_QueueGet() throughput",
+  nasa_osal_test_002_005_setup,
+  nasa_osal_test_002_005_teardown,
+  nasa_osal_test_002_005_execute
+};
+
 /****************************************************************************
  * Exported data.
  ****************************************************************************/
@@ -395,6 +522,7 @@ const testcase_t * const nasa_osal_test_sequence_002_array[] = {
   &nasa_osal_test_002_002,
   &nasa_osal_test_002_003,
   &nasa_osal_test_002_004,
+  &nasa_osal_test_002_005,
   NULL
 };
 
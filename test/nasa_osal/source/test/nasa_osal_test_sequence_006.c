@@ -89,14 +89,12 @@ static void nasa_osal_test_006_001_execute(void) {
      an error is expected.*/
   test_set_step(3);
   {
-#if 0 /* Semaphore name currently not implemented.*/
     int32 err;
 
     err = OS_MutSemCreate(&msid,
                          "very very long semaphore name",   /* Error.*/
                          0);
     test_assert(err == OS_ERR_NAME_TOO_LONG, "name limit not detected");
-#endif
   }
   test_end_step(3);
 
@@ -117,15 +115,13 @@ static void nasa_osal_test_006_001_execute(void) {
   test_set_step(5);
   {
     int32 err;
-    uint32 msid1; /*, msid2;*/
+    uint32 msid1, msid2;
 
     err = OS_MutSemCreate(&msid1, "my semaphore", 0);
     test_assert(err == OS_SUCCESS, "semaphore creation failed");
 
-#if 0 /* Semaphore name currently not implemented.*/
     err = OS_MutSemCreate(&msid2, "my semaphore", 0);
     test_assert(err == OS_ERR_NAME_TAKEN, "name conflict not detected");
-#endif
 
     err = OS_MutSemDelete(msid1);
     test_assert(err == OS_SUCCESS, "semaphore deletion failed");
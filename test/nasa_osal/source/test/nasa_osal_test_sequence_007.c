@@ -0,0 +1,276 @@
+/* Copyright statement.*/
+
+#include "hal.h"
+#include "nasa_osal_test_root.h"
+
+/**
+ * @file    nasa_osal_test_sequence_007.c
+ * @brief   Test Sequence 007 code.
+ *
+ * @page nasa_osal_test_sequence_007 [7] Benchmarks
+ *
+ * File: @ref nasa_osal_test_sequence_007.c
+ *
+ * <h2>Description</h2>
+ * This sequence measures the performance of the NASA OSAL over ChibiOS/RT
+ * objects handling.
+ *
+ * <h2>Test Cases</h2>
+ * - @subpage nasa_osal_test_007_001
+ * - @subpage nasa_osal_test_007_002
+ * .
+ */
+
+/****************************************************************************
+ * Shared code.
+ ****************************************************************************/
+
+#include <string.h>
+
+#include "osapi.h"
+
+#define BMK_OBJECTS         16
+
+static uint32 bmk_queues[BMK_OBJECTS];
+static uint32 bmk_binsems[BMK_OBJECTS];
+static uint32 bmk_countsems[BMK_OBJECTS];
+static uint32 bmk_mutexes[BMK_OBJECTS];
+
+static void bmk_name(char *name, unsigned i) {
+
+  memcpy(name, "bmk object ", 11);
+  name[11] = (char)('0' + (i / 10U));
+  name[12] = (char)('0' + (i % 10U));
+  name[13] = '\0';
+}
+
+static bool bmk_create(void) {
+  char name[OS_MAX_API_NAME];
+  unsigned i;
+
+  for (i = 0; i < BMK_OBJECTS; i++) {
+    bmk_name(name, i);
+    if ((OS_QueueCreate(&bmk_queues[i], name, 1, 4, 0) != OS_SUCCESS) ||
+        (OS_BinSemCreate(&bmk_binsems[i], name, 0, 0) != OS_SUCCESS) ||
+        (OS_CountSemCreate(&bmk_countsems[i], name, 0, 0) != OS_SUCCESS) ||
+        (OS_MutSemCreate(&bmk_mutexes[i], name, 0) != OS_SUCCESS)) {
+      return true;
+    }
+  }
+
+  return false;
+}
+
+static bool bmk_lookup(void) {
+  char name[OS_MAX_API_NAME];
+  unsigned i;
+  uint32 id;
+
+  for (i = 0; i < BMK_OBJECTS; i++) {
+    bmk_name(name, i);
+    if ((OS_QueueGetIdByName(&id, name) != OS_SUCCESS) ||
+        (id != bmk_queues[i]) ||
+        (OS_BinSemGetIdByName(&id, name) != OS_SUCCESS) ||
+        (id != bmk_binsems[i]) ||
+        (OS_CountSemGetIdByName(&id, name) != OS_SUCCESS) ||
+        (id != bmk_countsems[i]) ||
+        (OS_MutSemGetIdByName(&id, name) != OS_SUCCESS) ||
+        (id != bmk_mutexes[i])) {
+      return true;
+    }
+  }
+
+  return false;
+}
+
+static void bmk_delete(void) {
+  unsigned i;
+
+  for (i = 0; i < BMK_OBJECTS; i++) {
+    (void) OS_QueueDelete(bmk_queues[i]);
+    (void) OS_BinSemDelete(bmk_binsems[i]);
+    (void) OS_CountSemDelete(bmk_countsems[i]);
+    (void) OS_MutSemDelete(bmk_mutexes[i]);
+  }
+}
+
+static void bmk_task(void) {
+
+  OS_TaskExit();
+}
+
+/****************************************************************************
+ * Test cases.
+ ****************************************************************************/
+
+/**
+ * @page nasa_osal_test_007_001 [7.1] Named objects creation and lookup
+ *
+ * <h2>Description</h2>
+ * A set of named queues, semaphores and mutexes is created, each object is
+ * retrieved by name then all objects are deleted. The number of objects
+ * handled in a one second time window is measured.
+ *
+ * <h2>Test Steps</h2>
+ * - [7.1.1] The objects are created, retrieved by name and deleted in a one
+ *   second time window
+ * - [7.1.2] Score is printed
+ * .
+ */
+
+static void nasa_osal_test_007_001_execute(void) {
+  uint32 n;
+
+  /* [7.1.1] The objects are created, retrieved by name and deleted in a one
+     second time window.*/
+  test_set_step(1);
+  {
+    systime_t start, end;
+
+    n = 0;
+    chThdSleep(1);
+    start = chVTGetSystemTime();
+    end = chTimeAddX(start, TIME_MS2I(1000));
+    do {
+      bool err;
+
+      err = bmk_create();
+      if (!err) {
+        err = bmk_lookup();
+      }
+      bmk_delete();
+      test_assert(!err, "objects handling failed");
+      n += BMK_OBJECTS * 4;
+    #if defined(SIMULATOR)
+      _sim_check_for_interrupts();
+    #endif
+    } while (chVTIsSystemTimeWithinX(start, end));
+  }
+  test_end_step(1);
+
+  /* [7.1.2] Score is printed.*/
+  test_set_step(2);
+  {
+    test_print("--- Score : ");
+    test_printn(n);
+    test_println(" objects/S");
+  }
+  test_end_step(2);
+}
+
+static const testcase_t nasa_osal_test_007_001 = {
+  "Named objects creation and lookup",
+  NULL,
+  NULL,
+  nasa_osal_test_007_001_execute
+};
+
+/**
+ * @page nasa_osal_test_007_002 [7.2] Tasks creation and exit
+ *
+ * <h2>Description</h2>
+ * A task with priority above the test thread is created, the task exits
+ * before OS_TaskCreate() returns, then a task with the same name is
+ * created again. The number of tasks handled in a one second time window
+ * is measured.
+ *
+ * <h2>Test Steps</h2>
+ * - [7.2.1] A task exiting immediately is created, its name is expected to
+ *   be released and reusable
+ * - [7.2.2] Tasks with the same name are created in a one second time
+ *   window
+ * - [7.2.3] Score is printed
+ * .
+ */
+
+static void nasa_osal_test_007_002_execute(void) {
+  uint32 n;
+
+  /* [7.2.1] A task exiting immediately is created, its name is expected
+     to be released and reusable.*/
+  test_set_step(1);
+  {
+    int32 err;
+    uint32 tid;
+
+    err = OS_TaskCreate(&tid,
+                        "exiting task",
+                        bmk_task,
+                        (uint32 *)wa_test1,
+                        sizeof wa_test1,
+                        TASKS_BASE_PRIORITY - 100,
+                        0);
+    test_assert(err == OS_SUCCESS, "task creation failed");
+
+    err = OS_TaskGetIdByName(&tid, "exiting task");
+    test_assert(err == OS_ERR_NAME_NOT_FOUND, "name not released");
+  }
+  test_end_step(1);
+
+  /* [7.2.2] Tasks with the same name are created in a one second time
+     window.*/
+  test_set_step(2);
+  {
+    systime_t start, end;
+
+    n = 0;
+    chThdSleep(1);
+    start = chVTGetSystemTime();
+    end = chTimeAddX(start, TIME_MS2I(1000));
+    do {
+      int32 err;
+      uint32 tid;
+
+      err = OS_TaskCreate(&tid,
+                          "exiting task",
+                          bmk_task,
+                          (uint32 *)wa_test1,
+                          sizeof wa_test1,
+                          TASKS_BASE_PRIORITY - 100,
+                          0);
+      test_assert(err == OS_SUCCESS, "name not reusable");
+      n++;
+    #if defined(SIMULATOR)
+      _sim_check_for_interrupts();
+    #endif
+    } while (chVTIsSystemTimeWithinX(start, end));
+  }
+  test_end_step(2);
+
+  /* [7.2.3] Score is printed.*/
+  test_set_step(3);
+  {
+    test_print("--- Score : ");
+    test_printn(n);
+    test_println(" tasks/S");
+  }
+  test_end_step(3);
+}
+
+static const testcase_t nasa_osal_test_007_002 = {
+  "Tasks creation and exit",
+  NULL,
+  NULL,
+  nasa_osal_test_007_002_execute
+};
+
+/****************************************************************************
+ * Exported data.
+ ****************************************************************************/
+
+/**
+ * @brief   Array of test cases.
+ */
+const testcase_t * const nasa_osal_test_sequence_007_array[] = {
+  &nasa_osal_test_007_001,
+  &nasa_osal_test_007_002,
+  NULL
+};
+
+/**
+ * @brief   Benchmarks.
+ */
+const testsequence_t nasa_osal_test_sequence_007 = {
+  "Benchmarks",
+  nasa_osal_test_sequence_007_array
+};
@@ -0,0 +1,13 @@
+/* Copyright statement.*/
+
+/**
+ * @file    nasa_osal_test_sequence_007.h
+ * @brief   Test Sequence 007 header.
+ */
+
+#ifndef NASA_OSAL_TEST_SEQUENCE_007_H
+#define NASA_OSAL_TEST_SEQUENCE_007_H
+
+extern const testsequence_t nasa_osal_test_sequence_007;
+
+#endif /* NASA_OSAL_TEST_SEQUENCE_007_H */
@@ -0,0 +1,437 @@
+/*
+    ChibiOS - Copyright (C) 2006..2017 Giovanni Di Sirio
+
+    Licensed under the Apache License, Version 2.0 (the "License");
+    you may not use this file except in compliance with the License.
+    You may obtain a copy of the License at
+
+        http://www.apache.org/licenses/LICENSE-2.0
+
+    Unless required by applicable law or agreed to in writing, software
+    distributed under the License is distributed on an "AS IS" BASIS,
+    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+    See the License for the specific language governing permissions and
+    limitations under the License.
+*/
+
+#include "hal.h"
+#include "oslib_test_root.h"
+
+/**
+ * @file    oslib_test_sequence_010.c
+ * @brief   Test Sequence 010 code.
+ *
+ * @page oslib_test_sequence_010 [10] Message Queues
+ *
+ * File: @ref oslib_test_sequence_010.c
+ *
+ * <h2>Description</h2>
+ * This sequence tests the ChibiOS library functionalities related to
+ * message queues.
+ *
+ * <h2>Conditions</h2>
+ * This sequence is only executed if the following preprocessor condition
+ * evaluates to true:
+ * - CH_CFG_USE_MSG_QUEUES == TRUE
+ * .
+ *
+ * <h2>Test Cases</h2>
+ * - @subpage oslib_test_010_001
+ * - @subpage oslib_test_010_002
+ * .
+ */
+
+#if (CH_CFG_USE_MSG_QUEUES == TRUE) || defined(__DOXYGEN__)
+
+/****************************************************************************
+ * Shared code.
+ ****************************************************************************/
+
+#include <string.h>
+
+#define MQ_MSG_SIZE 8
+#define MQ_SLOTS 4
+
+static ALIGNED_VAR(PORT_NATURAL_ALIGN)
+    uint8_t mq_buffer[CH_MQ_BUFFER_SIZE(MQ_MSG_SIZE, MQ_SLOTS)];
+static MSG_QUEUE_DECL(mq1, mq_buffer, MQ_MSG_SIZE, MQ_SLOTS);
+
+static const uint8_t mq_pattern[] = "0123456789ABCDEF";
+
+static THD_WORKING_AREA(waThread1, 256);
+
+static THD_FUNCTION(reader_thread, arg) {
+  uint8_t buf[MQ_MSG_SIZE];
+  size_t n;
+  msg_t msg;
+
+  (void)arg;
+
+  msg = chMQFetchTimeout(&mq1, buf, &n, TIME_INFINITE);
+  if ((msg == MSG_OK) && (n == 3U) && (memcmp(buf, mq_pattern, 3U) == 0)) {
+    test_emit_token('A');
+  }
+  chThdExit(msg);
+}
+
+static THD_FUNCTION(writer_thread, arg) {
+  msg_t msg;
+
+  (void)arg;
+
+  msg = chMQPostTimeout(&mq1, &mq_pattern[8], MQ_MSG_SIZE, TIME_INFINITE);
+  if (msg == MSG_OK) {
+    test_emit_token('B');
+  }
+  chThdExit(msg);
+}
+
+static thread_t *mq_start_thread(tfunc_t funcp) {
+  thread_t *tp;
+  thread_descriptor_t td = {
+    .name  = "mqthread",
+    .wbase = waThread1,
+    .wend  = THD_WORKING_AREA_END(waThread1),
+    .prio  = chThdGetPriorityX() + 1,
+    .funcp = funcp,
+    .arg   = NULL
+  };
+
+  /* Giving the thread the chance to block on the message queue regardless
+     of the priority ordering of the underlying kernel.*/
+  tp = chThdCreate(&td);
+  chThdSleepMilliseconds(10);
+
+  return tp;
+}
+
+/****************************************************************************
+ * Test cases.
+ ****************************************************************************/
+
+/**
+ * @page oslib_test_010_001 [10.1] Message queues normal API, non-blocking tests
+ *
+ * <h2>Description</h2>
+ * The message queue functionality is tested by loading and emptying it, all
+ * conditions are tested.
+ *
+ * <h2>Test Steps</h2>
+ * - [10.1.1] Resetting message queue
+ * - [10.1.2] Posting a message, must fail
+ * - [10.1.3] Fetching a message, must fail
+ * - [10.1.4] Reactivating message queue
+ * - [10.1.5] Filling the whole message queue with messages of increasing
+ *   size
+ * - [10.1.6] Posting into a full message queue, must fail
+ * - [10.1.7] Emptying the message queue, sizes and contents are checked
+ * - [10.1.8] Fetching from an empty message queue, must fail
+ * - [10.1.9] Posting and fetching across the buffer boundary
+ * .
+ */
+
+static void oslib_test_010_001_setup(void) {
+  chMQObjectInit(&mq1, mq_buffer, MQ_MSG_SIZE, MQ_SLOTS);
+}
+
+static void oslib_test_010_001_execute(void) {
+
+  /* [10.1.1] Resetting message queue.*/
+  test_set_step(1);
+  {
+    chMQReset(&mq1);
+
+    test_assert((mq1.rdptr == mq1.buffer) &&
+                (mq1.wrptr == mq1.buffer) &&
+                (mq1.cnt == 0),
+                "invalid message queue state");
+  }
+  test_end_step(1);
+
+  /* [10.1.2] Posting a message, must fail.*/
+  test_set_step(2);
+  {
+    msg_t msg;
+
+    msg = chMQPostTimeout(&mq1, mq_pattern, MQ_MSG_SIZE, TIME_IMMEDIATE);
+    test_assert(msg == MSG_RESET, "not reset");
+    test_assert((mq1.rdptr == mq1.buffer) &&
+                (mq1.wrptr == mq1.buffer) &&
+                (mq1.cnt == 0),
+                "invalid message queue state");
+  }
+  test_end_step(2);
+
+  /* [10.1.3] Fetching a message, must fail.*/
+  test_set_step(3);
+  {
+    msg_t msg;
+    size_t n;
+    uint8_t buf[MQ_MSG_SIZE];
+
+    msg = chMQFetchTimeout(&mq1, buf, &n, TIME_IMMEDIATE);
+    test_assert(msg == MSG_RESET, "not reset");
+    test_assert((mq1.rdptr == mq1.buffer) &&
+                (mq1.wrptr == mq1.buffer) &&
+                (mq1.cnt == 0),
+                "invalid message queue state");
+  }
+  test_end_step(3);
+
+  /* [10.1.4] Reactivating message queue.*/
+  test_set_step(4);
+  {
+    chMQResumeX(&mq1);
+    test_assert((mq1.rdptr == mq1.buffer) &&
+                (mq1.wrptr == mq1.buffer) &&
+                (mq1.cnt == 0),
+                "invalid message queue state");
+  }
+  test_end_step(4);
+
+  /* [10.1.5] Filling the whole message queue with messages of increasing
+     size.*/
+  test_set_step(5);
+  {
+    unsigned i;
+    msg_t msg;
+
+    for (i = 0; i < MQ_SLOTS; i++) {
+      msg = chMQPostTimeout(&mq1, mq_pattern, i + 1U, TIME_IMMEDIATE);
+      test_assert(msg == MSG_OK, "wrong wake-up message");
+    }
+    test_assert((mq1.rdptr == mq1.buffer) &&
+                (mq1.wrptr == mq1.buffer) &&
+                (mq1.cnt == MQ_SLOTS),
+                "invalid message queue state");
+  }
+  test_end_step(5);
+
+  /* [10.1.6] Posting into a full message queue, must fail.*/
+  test_set_step(6);
+  {
+    msg_t msg;
+
+    msg = chMQPostTimeout(&mq1, mq_pattern, MQ_MSG_SIZE, TIME_IMMEDIATE);
+    test_assert(msg == MSG_TIMEOUT, "wrong wake-up message");
+    test_assert(mq1.cnt == MQ_SLOTS, "invalid message queue state");
+  }
+  test_end_step(6);
+
+  /* [10.1.7] Emptying the message queue, sizes and contents are checked.*/
+  test_set_step(7);
+  {
+    unsigned i;
+    msg_t msg;
+    size_t n;
+    uint8_t buf[MQ_MSG_SIZE];
+
+    for (i = 0; i < MQ_SLOTS; i++) {
+      msg = chMQFetchTimeout(&mq1, buf, &n, TIME_IMMEDIATE);
+      test_assert(msg == MSG_OK, "wrong wake-up message");
+      test_assert(n == i + 1U, "wrong size");
+      test_assert(memcmp(mq_pattern, buf, n) == 0, "content mismatch");
+    }
+    test_assert((mq1.rdptr == mq1.buffer) &&
+                (mq1.wrptr == mq1.buffer) &&
+                (mq1.cnt == 0),
+                "invalid message queue state");
+  }
+  test_end_step(7);
+
+  /* [10.1.8] Fetching from an empty message queue, must fail.*/
+  test_set_step(8);
+  {
+    msg_t msg;
+    size_t n;
+    uint8_t buf[MQ_MSG_SIZE];
+
+    msg = chMQFetchTimeout(&mq1, buf, &n, TIME_IMMEDIATE);
+    test_assert(msg == MSG_TIMEOUT, "wrong wake-up message");
+    test_assert((mq1.rdptr == mq1.buffer) &&
+                (mq1.wrptr == mq1.buffer) &&
+                (mq1.cnt == 0),
+                "invalid message queue state");
+  }
+  test_end_step(8);
+
+  /* [10.1.9] Posting and fetching across the buffer boundary.*/
+  test_set_step(9);
+  {
+    unsigned i;
+    msg_t msg;
+    size_t n;
+    uint8_t buf[MQ_MSG_SIZE];
+
+    for (i = 0; i < MQ_SLOTS / 2U; i++) {
+      (void) chMQPostTimeout(&mq1, mq_pattern, MQ_MSG_SIZE, TIME_IMMEDIATE);
+      (void) chMQFetchTimeout(&mq1, buf, &n, TIME_IMMEDIATE);
+    }
+    for (i = 0; i < MQ_SLOTS; i++) {
+      msg = chMQPostTimeout(&mq1, &mq_pattern[i], MQ_MSG_SIZE, TIME_IMMEDIATE);
+      test_assert(msg == MSG_OK, "wrong wake-up message");
+    }
+    for (i = 0; i < MQ_SLOTS; i++) {
+      msg = chMQFetchTimeout(&mq1, buf, &n, TIME_IMMEDIATE);
+      test_assert(msg == MSG_OK, "wrong wake-up message");
+      test_assert(n == MQ_MSG_SIZE, "wrong size");
+      test_assert(memcmp(&mq_pattern[i], buf, n) == 0, "content mismatch");
+    }
+    test_assert((mq1.rdptr == mq1.wrptr) &&
+                (mq1.rdptr != mq1.buffer) &&
+                (mq1.cnt == 0),
+                "invalid message queue state");
+  }
+  test_end_step(9);
+}
+
+static const testcase_t oslib_test_010_001 = {
+  "Message queues normal API, non-blocking tests",
+  oslib_test_010_001_setup,
+  NULL,
+  oslib_test_010_001_execute
+};
+
+/**
+ * @page oslib_test_010_002 [10.2] Message queues direct handoff
+ *
+ * <h2>Description</h2>
+ * Messages are exchanged with threads blocked on the message queue, the
+ * message must be copied directly into the reader buffer or from the writer
+ * buffer without losing ordering.
+ *
+ * <h2>Test Steps</h2>
+ * - [10.2.1] Starting a reader thread, it blocks on the empty message queue
+ * - [10.2.2] Posting a message, it must be handed off to the reader without
+ *   using a slot
+ * - [10.2.3] Filling the message queue then starting a writer thread, it
+ *   blocks on the full message queue
+ * - [10.2.4] Fetching a message, the writer message must be moved into the
+ *   freed slot
+ * - [10.2.5] Emptying the message queue, ordering and tokens are checked
+ * - [10.2.6] Starting a reader thread then resetting the message queue, the
+ *   reader must be released with MSG_RESET
+ * .
+ */
+
+static void oslib_test_010_002_setup(void) {
+  chMQObjectInit(&mq1, mq_buffer, MQ_MSG_SIZE, MQ_SLOTS);
+}
+
+static void oslib_test_010_002_execute(void) {
+  thread_t *tp;
+
+  /* [10.2.1] Starting a reader thread, it blocks on the empty message queue.*/
+  test_set_step(1);
+  {
+    tp = mq_start_thread(reader_thread);
+    test_assert(mq1.qr != NULL, "no waiting reader");
+  }
+  test_end_step(1);
+
+  /* [10.2.2] Posting a message, it must be handed off to the reader without
+     using a slot.*/
+  test_set_step(2);
+  {
+    msg_t msg;
+
+    msg = chMQPostTimeout(&mq1, mq_pattern, 3U, TIME_IMMEDIATE);
+    test_assert(msg == MSG_OK, "wrong wake-up message");
+    test_assert((mq1.qr == NULL) && (mq1.cnt == 0),
+                "invalid message queue state");
+    msg = chThdWait(tp);
+    test_assert(msg == MSG_OK, "wrong exit message");
+  }
+  test_end_step(2);
+
+  /* [10.2.3] Filling the message queue then starting a writer thread, it
+     blocks on the full message queue.*/
+  test_set_step(3);
+  {
+    unsigned i;
+
+    for (i = 0; i < MQ_SLOTS; i++) {
+      (void) chMQPostTimeout(&mq1, &mq_pattern[i], MQ_MSG_SIZE, TIME_IMMEDIATE);
+    }
+    tp = mq_start_thread(writer_thread);
+    test_assert(mq1.qw != NULL, "no waiting writer");
+  }
+  test_end_step(3);
+
+  /* [10.2.4] Fetching a message, the writer message must be moved into the
+     freed slot.*/
+  test_set_step(4);
+  {
+    msg_t msg;
+    size_t n;
+    uint8_t buf[MQ_MSG_SIZE];
+
+    msg = chMQFetchTimeout(&mq1, buf, &n, TIME_IMMEDIATE);
+    test_assert(msg == MSG_OK, "wrong wake-up message");
+    test_assert(memcmp(&mq_pattern[0], buf, n) == 0, "content mismatch");
+    test_assert((mq1.qw == NULL) && (mq1.cnt == MQ_SLOTS),
+                "invalid message queue state");
+    msg = chThdWait(tp);
+    test_assert(msg == MSG_OK, "wrong exit message");
+  }
+  test_end_step(4);
+
+  /* [10.2.5] Emptying the message queue, ordering and tokens are checked.*/
+  test_set_step(5);
+  {
+    unsigned i;
+    size_t n;
+    uint8_t buf[MQ_MSG_SIZE];
+
+    for (i = 1; i <= MQ_SLOTS; i++) {
+      (void) chMQFetchTimeout(&mq1, buf, &n, TIME_IMMEDIATE);
+      test_assert(memcmp(&mq_pattern[i < MQ_SLOTS ? i : 8], buf, n) == 0,
+                  "content mismatch");
+    }
+    test_assert_sequence("AB", "invalid tokens");
+  }
+  test_end_step(5);
+
+  /* [10.2.6] Starting a reader thread then resetting the message queue, the
+     reader must be released with MSG_RESET.*/
+  test_set_step(6);
+  {
+    msg_t msg;
+
+    tp = mq_start_thread(reader_thread);
+    chMQReset(&mq1);
+    msg = chThdWait(tp);
+    test_assert(msg == MSG_RESET, "wrong exit message");
+  }
+  test_end_step(6);
+}
+
+static const testcase_t oslib_test_010_002 = {
+  "Message queues direct handoff",
+  oslib_test_010_002_setup,
+  NULL,
+  oslib_test_010_002_execute
+};
+
+/****************************************************************************
+ * Exported data.
+ ****************************************************************************/
+
+/**
+ * @brief   Array of test cases.
+ */
+const testcase_t * const oslib_test_sequence_010_array[] = {
+  &oslib_test_010_001,
+  &oslib_test_010_002,
+  NULL
+};
+
+/**
+ * @brief   Message Queues.
+ */
+const testsequence_t oslib_test_sequence_010 = {
+  "Message Queues",
+  oslib_test_sequence_010_array
+};
+
+#endif /* CH_CFG_USE_MSG_QUEUES == TRUE */
@@ -5,7 +5,7 @@
 
 # Compiler options here.
 ifeq ($(USE_OPT),)
-  USE_OPT = $(XOPT) -m32
+  USE_OPT = $(XOPT)
 endif
 
 # C specific options here (added to USE_OPT).
@@ -81,7 +81,7 @@ include $(CHIBIOS)/os/hal/ports/simulator/posix/platform.mk
 include $(CHIBIOS)/os/hal/osal/rt-nil/osal.mk
 # RTOS files (optional).
 include $(CHIBIOS)/os/rt/rt.mk
-include $(CHIBIOS)/os/common/ports/SIMIA32/compilers/GCC/port.mk
+include $(CHIBIOS)/os/common/ports/SIMX64/compilers/GCC/port.mk
 # Other files (optional).
 include $(CHIBIOS)/os/test/test.mk
 include $(CHIBIOS)/test/rt/rt_test.mk
@@ -0,0 +1,340 @@
+/*
+    ChibiOS - Copyright (C) 2006..2018 Giovanni Di Sirio
+
+    Licensed under the Apache License, Version 2.0 (the "License");
+    you may not use this file except in compliance with the License.
+    You may obtain a copy of the License at
+
+        http://www.apache.org/licenses/LICENSE-2.0
+
+    Unless required by applicable law or agreed to in writing, software
+    distributed under the License is distributed on an "AS IS" BASIS,
+    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+    See the License for the specific language governing permissions and
+    limitations under the License.
+*/
+
+#include <stdio.h>
+#include <math.h>
+
+#include "ch.h"
+#include "hal.h"
+
+#include "lsm6dsl.h"
+
+/*===========================================================================*/
+/* Benchmark settings.                                                       */
+/*===========================================================================*/
+
+/* Number of samples acquired by each run.*/
+#if !defined(BENCH_SAMPLES)
+#define BENCH_SAMPLES               8192U
+#endif
+
+/* Stream buffer size and size of each cooked read, in samples.*/
+#define STREAM_SAMPLES              512U
+#define READ_SAMPLES                64U
+
+/*
+ * Simulated fast mode bus, the setup time accounts for the per-transaction
+ * overhead (DMA programming and completion interrupt) of a real peripheral.
+ */
+#define I2C_FM_BITRATE              400000U
+#define I2C_FM_SETUP_NS             5000U
+
+/*===========================================================================*/
+/* LSM6DSL model.                                                            */
+/*===========================================================================*/
+
+/*
+ * The model produces an endless deterministic sequence of samples, the
+ * output registers and the FIFO are two independent readers of the same
+ * sequence. The output registers move to the next sample when the last
+ * accelerometer register is read. The FIFO, when enabled, is always filled
+ * up to its capacity.
+ */
+#define DEV_FIFO_WORDS              2046U
+
+static struct {
+  uint8_t       regs[128];
+  uint8_t       ptr;
+  uint32_t      sample;
+  uint32_t      fifo_sample;
+  uint32_t      fifo_word;
+} dev;
+
+static int16_t dev_raw(uint32_t sample, unsigned channel) {
+
+  return (int16_t)(uint16_t)((sample * 37U) + (channel * 9001U));
+}
+
+static uint8_t dev_read(uint8_t reg) {
+  uint16_t w;
+  bool fifo_on;
+
+  fifo_on = (dev.regs[LSM6DSL_AD_FIFO_CTRL5] &
+             LSMDSL_FIFO_CTRL5_FIFO_MODE_MASK) != 0U;
+
+  if ((reg >= LSM6DSL_AD_OUTX_L_G) && (reg <= LSM6DSL_AD_OUTZ_H_XL)) {
+    unsigned offset = (unsigned)(reg - LSM6DSL_AD_OUTX_L_G);
+
+    w = (uint16_t)dev_raw(dev.sample, offset / 2U);
+    if (reg == LSM6DSL_AD_OUTZ_H_XL) {
+      dev.sample++;
+    }
+    return (offset & 1U) == 0U ? (uint8_t)w : (uint8_t)(w >> 8);
+  }
+
+  switch (reg) {
+  case LSM6DSL_AD_FIFO_STATUS1:
+    return fifo_on ? (uint8_t)(DEV_FIFO_WORDS - dev.fifo_word) : 0U;
+  case LSM6DSL_AD_FIFO_STATUS2:
+    return fifo_on ? (uint8_t)((DEV_FIFO_WORDS - dev.fifo_word) >> 8) :
+                     LSMDSL_FIFO_STATUS2_FIFO_EMPTY;
+  case LSM6DSL_AD_FIFO_STATUS3:
+    return (uint8_t)dev.fifo_word;
+  case LSM6DSL_AD_FIFO_STATUS4:
+    return 0U;
+  case LSM6DSL_AD_FIFO_DATA_OUT_L:
+    return (uint8_t)dev_raw(dev.fifo_sample, dev.fifo_word);
+  case LSM6DSL_AD_FIFO_DATA_OUT_H:
+    w = (uint16_t)dev_raw(dev.fifo_sample, dev.fifo_word);
+    if (++dev.fifo_word >= LSM6DSL_FIFO_NUMBER_OF_CHANNELS) {
+      dev.fifo_word = 0U;
+      dev.fifo_sample++;
+    }
+    return (uint8_t)(w >> 8);
+  default:
+    return dev.regs[reg & 0x7FU];
+  }
+}
+
+static void dev_write(uint8_t reg, uint8_t value) {
+
+  dev.regs[reg & 0x7FU] = value;
+  if ((reg == LSM6DSL_AD_FIFO_CTRL5) &&
+      ((value & LSMDSL_FIFO_CTRL5_FIFO_MODE_MASK) ==
+       LSMDSL_FIFO_CTRL5_FIFO_MODE_BYPASS)) {
+    dev.fifo_sample = 0U;
+    dev.fifo_word   = 0U;
+  }
+}
+
+static uint8_t dev_next(uint8_t reg) {
+
+  if ((dev.regs[LSM6DSL_AD_CTRL3_C] & LSMDSL_CTRL3_C_IF_INC) == 0U) {
+    return reg;
+  }
+  if (reg == LSM6DSL_AD_FIFO_DATA_OUT_H) {
+    return LSM6DSL_AD_FIFO_DATA_OUT_L;
+  }
+  return (uint8_t)(reg + 1U);
+}
+
+static bool dev_transfer(void *arg,
+                         const uint8_t *txbuf, size_t txbytes,
+                         uint8_t *rxbuf, size_t rxbytes) {
+  size_t i;
+
+  (void)arg;
+
+  if (txbytes > 0U) {
+    dev.ptr = txbuf[0];
+    for (i = 1U; i < txbytes; i++) {
+      dev_write(dev.ptr, txbuf[i]);
+      dev.ptr = dev_next(dev.ptr);
+    }
+  }
+  for (i = 0U; i < rxbytes; i++) {
+    rxbuf[i] = dev_read(dev.ptr);
+    dev.ptr = dev_next(dev.ptr);
+  }
+
+  return true;
+}
+
+static const SimI2CDevice i2cdev = {
+  .addr             = LSM6DSL_SAD_VCC,
+  .transfer         = dev_transfer,
+  .arg              = NULL
+};
+
+/*===========================================================================*/
+/* Benchmark.                                                                */
+/*===========================================================================*/
+
+static LSM6DSLDriver LSM6DSLD1;
+
+static I2CConfig i2ccfg = {
+  .devices          = &i2cdev,
+  .ndevices         = 1U,
+  .bitrate          = 0U,
+  .setup_time       = 0U
+};
+
+static const LSM6DSLConfig lsm6dslcfg = {
+  .i2cp             = &I2CD1,
+  .i2ccfg           = &i2ccfg,
+  .slaveaddress     = LSM6DSL_SAD_VCC,
+  .accsensitivity   = NULL,
+  .accbias          = NULL,
+  .accfullscale     = LSM6DSL_ACC_FS_4G,
+  .accodr           = LSM6DSL_ACC_ODR_1P66HZ,
+  .gyrosensitivity  = NULL,
+  .gyrobias         = NULL,
+  .gyrofullscale    = LSM6DSL_GYRO_FS_500DPS,
+  .gyroodr          = LSM6DSL_GYRO_ODR_1P66KHZ
+};
+
+static uint8_t stream_buffer[SENSOR_STREAM_BUFFER_SIZE(
+                               LSM6DSL_FIFO_NUMBER_OF_CHANNELS,
+                               STREAM_SAMPLES)];
+static float cooked[READ_SAMPLES * LSM6DSL_FIFO_NUMBER_OF_CHANNELS];
+
+static bool check(const float *dp, uint32_t sample) {
+  unsigned c;
+
+  for (c = 0U; c < LSM6DSL_FIFO_NUMBER_OF_CHANNELS; c++) {
+    float s, b, expected;
+
+    if (c < LSM6DSL_GYRO_NUMBER_OF_AXES) {
+      s = LSM6DSLD1.gyrosensitivity[c];
+      b = LSM6DSLD1.gyrobias[c];
+    }
+    else {
+      s = LSM6DSLD1.accsensitivity[c - LSM6DSL_GYRO_NUMBER_OF_AXES];
+      b = LSM6DSLD1.accbias[c - LSM6DSL_GYRO_NUMBER_OF_AXES];
+    }
+    expected = ((float)dev_raw(sample, c) * s) - b;
+    if (fabsf(dp[c] - expected) > (fabsf(expected) * 1e-6f) + 1e-6f) {
+      return true;
+    }
+  }
+  return false;
+}
+
+static void report(const char *name, rtcnt_t counts,
+                   uint32_t transfers, uint32_t bytes) {
+  uint64_t sps;
+
+  sps = ((uint64_t)BENCH_SAMPLES * (uint64_t)PORT_SIM_RT_FREQUENCY) /
+        (uint64_t)counts;
+  printf("%-7s: %10u samples/s, %5.2f transactions/sample, "
+         "%5.2f bytes/sample\n",
+         name, (unsigned)sps,
+         (double)transfers / (double)BENCH_SAMPLES,
+         (double)bytes / (double)BENCH_SAMPLES);
+}
+
+static bool do_single(void) {
+  uint32_t transfers, bytes, k;
+  rtcnt_t start;
+
+  dev.sample = 0U;
+  transfers  = I2CD1.transfers;
+  bytes      = I2CD1.bytes;
+  start = chSysGetRealtimeCounterX();
+  for (k = 0U; k < BENCH_SAMPLES; k++) {
+    if ((lsm6dslGyroscopeReadCooked(&LSM6DSLD1, &cooked[0]) != MSG_OK) ||
+        (lsm6dslAccelerometerReadCooked(&LSM6DSLD1,
+                                        &cooked[LSM6DSL_GYRO_NUMBER_OF_AXES])
+         != MSG_OK) ||
+        check(cooked, k)) {
+      return true;
+    }
+  }
+  report("Single", chSysGetRealtimeCounterX() - start,
+         I2CD1.transfers - transfers, I2CD1.bytes - bytes);
+
+  return false;
+}
+
+static bool do_fifo(void) {
+  uint32_t transfers, bytes, k, i;
+  rtcnt_t start;
+  size_t n;
+
+  if (lsm6dslFIFOStart(&LSM6DSLD1, stream_buffer, STREAM_SAMPLES) != MSG_OK) {
+    return true;
+  }
+
+  transfers = I2CD1.transfers;
+  bytes     = I2CD1.bytes;
+  start = chSysGetRealtimeCounterX();
+  for (k = 0U; k < BENCH_SAMPLES; k += (uint32_t)n) {
+    if (lsm6dslFIFOGetUsedCount(&LSM6DSLD1) < READ_SAMPLES) {
+      if (lsm6dslFIFOFetch(&LSM6DSLD1) != MSG_OK) {
+        return true;
+      }
+    }
+    n = lsm6dslFIFOReadCooked(&LSM6DSLD1, cooked, READ_SAMPLES);
+    if (n > BENCH_SAMPLES - k) {
+      n = BENCH_SAMPLES - k;
+    }
+    for (i = 0U; i < n; i++) {
+      if (check(&cooked[i * LSM6DSL_FIFO_NUMBER_OF_CHANNELS], k + i)) {
+        return true;
+      }
+    }
+  }
+  report("FIFO", chSysGetRealtimeCounterX() - start,
+         I2CD1.transfers - transfers, I2CD1.bytes - bytes);
+
+  if ((lsm6dslFIFOGetOverruns(&LSM6DSLD1) != 0U) ||
+      (lsm6dslFIFOStop(&LSM6DSLD1) != MSG_OK)) {
+    return true;
+  }
+
+  return false;
+}
+
+static bool do_bench(const char *name, uint32_t bitrate, uint32_t setup) {
+
+  i2ccfg.bitrate    = bitrate;
+  i2ccfg.setup_time = setup;
+
+  printf("%s\n", name);
+  lsm6dslStart(&LSM6DSLD1, &lsm6dslcfg);
+  if (do_single()) {
+    printf("Single : FAILED\n");
+    return true;
+  }
+  if (do_fifo()) {
+    printf("FIFO   : FAILED\n");
+    return true;
+  }
+  lsm6dslStop(&LSM6DSLD1);
+  printf("\n");
+
+  return false;
+}
+
+/*
+ * Application entry point.
+ */
+int main(void) {
+
+  /*
+   * System initializations.
+   * - HAL initialization, this also initializes the configured device drivers
+   *   and performs the board-specific initializations.
+   * - Kernel initialization, the main() function becomes a thread and the
+   *   RTOS is active.
+   */
+  halInit();
+  chSysInit();
+
+  printf("LSM6DSL streaming benchmark, %u samples per run\n\n",
+         (unsigned)BENCH_SAMPLES);
+
+  lsm6dslObjectInit(&LSM6DSLD1);
+
+  if (do_bench("Bus model: none (CPU only)", 0U, 0U)) {
+    return 1;
+  }
+  if (do_bench("Bus model: 400 kHz", I2C_FM_BITRATE, I2C_FM_SETUP_NS)) {
+    return 1;
+  }
+
+  return 0;
+}
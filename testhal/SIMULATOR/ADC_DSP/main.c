@@ -0,0 +1,390 @@
+/*
+    ChibiOS - Copyright (C) 2006..2018 Giovanni Di Sirio
+
+    Licensed under the Apache License, Version 2.0 (the "License");
+    you may not use this file except in compliance with the License.
+    You may obtain a copy of the License at
+
+        http://www.apache.org/licenses/LICENSE-2.0
+
+    Unless required by applicable law or agreed to in writing, software
+    distributed under the License is distributed on an "AS IS" BASIS,
+    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+    See the License for the specific language governing permissions and
+    limitations under the License.
+*/
+
+#include <stdio.h>
+#include <string.h>
+#include <math.h>
+
+#include "ch.h"
+#include "hal.h"
+
+#include "adc_dsp.h"
+
+/*===========================================================================*/
+/* Benchmark settings.                                                       */
+/*===========================================================================*/
+
+/* Synthetic 12 bits ADC, two interleaved channels, the first one is
+   processed.*/
+#define ADC_CHANNELS                2U
+#define ADC_OFFSET                  2048
+#define ADC_SHIFT                   4U
+
+/* Synthetic signal: a sine with a short pulse in each period.*/
+#define SIG_PERIOD                  4096U
+#define SIG_CYCLES                  8U
+#define SIG_AMPLITUDE               1000.0
+#define SIG_PULSE_START             1000U
+#define SIG_PULSE_LEN               64U
+#define SIG_PULSE_LEVEL             4000U
+
+/* Conversions per half buffer.*/
+#define HALF_DEPTH                  256U
+
+/* Blocks processed by each throughput run, the best of BENCH_RUNS runs
+   is reported.*/
+#define BENCH_BLOCKS                20000U
+#define BENCH_RUNS                  5U
+
+/* Real time run, one half buffer every ADC_PERIOD ticks.*/
+#define ADC_PERIOD                  2U
+#define RT_TIME                     TIME_MS2I(1000)
+
+/* Stages settings.*/
+#define CIC_ORDER                   3U
+#define CIC_RATIO                   4U
+#define CIC_SHIFT                   6U
+#define FIR_TAPS                    31U
+#define FIR_RATIO                   2U
+#define RMS_HOP                     512U
+#define RMS_HOPS                    8U
+#define MINMAX_WINDOW               SIG_PERIOD
+#define TH_HIGH                     24000
+#define TH_LOW                      8000
+
+/*===========================================================================*/
+/* Synthetic ADC.                                                            */
+/*===========================================================================*/
+
+/* One period of the signal, interleaved channels.*/
+static dsp_adcsample_t signal[SIG_PERIOD * ADC_CHANNELS];
+
+/* Circular buffer of the real time run.*/
+static dsp_adcsample_t adc_buffer[2U * HALF_DEPTH * ADC_CHANNELS];
+
+static void signal_init(void) {
+  unsigned i;
+
+  for (i = 0U; i < SIG_PERIOD; i++) {
+    double a = (2.0 * M_PI * SIG_CYCLES * i) / SIG_PERIOD;
+    unsigned v = (unsigned)lround(ADC_OFFSET + (SIG_AMPLITUDE * sin(a)));
+
+    if ((i >= SIG_PULSE_START) && (i < SIG_PULSE_START + SIG_PULSE_LEN)) {
+      v = SIG_PULSE_LEVEL;
+    }
+    signal[i * ADC_CHANNELS]      = (dsp_adcsample_t)v;
+    signal[i * ADC_CHANNELS + 1U] = (dsp_adcsample_t)(i & 0xFFFU);
+  }
+}
+
+static int16_t signal_q15(unsigned i) {
+
+  return (int16_t)(((int32_t)signal[i * ADC_CHANNELS] - ADC_OFFSET) *
+                   (1 << ADC_SHIFT));
+}
+
+/*===========================================================================*/
+/* Pipeline.                                                                 */
+/*===========================================================================*/
+
+static jobs_queue_t jobs;
+static job_descriptor_t jobs_buffer[4];
+static msg_t msg_buffer[4];
+
+static int16_t work[HALF_DEPTH];
+
+static const dsp_pipeline_config_t pipeline_cfg = {
+  .jqp          = &jobs,
+  .channels     = ADC_CHANNELS,
+  .channel      = 0U,
+  .offset       = ADC_OFFSET,
+  .shift        = ADC_SHIFT,
+  .work         = work,
+  .worksize     = HALF_DEPTH
+};
+
+static dsp_pipeline_t pipeline;
+static dsp_cic_t cic;
+static dsp_fir_t fir;
+static dsp_rms_t rms;
+static dsp_minmax_t minmax;
+static dsp_threshold_t threshold;
+
+static int16_t fir_coeffs[FIR_TAPS];
+static int16_t fir_history[DSP_FIR_HISTORY_SIZE(FIR_TAPS, HALF_DEPTH)];
+
+/* Windowed sinc low pass, cutoff at a quarter of the input rate, scaled
+   so that the sum of the absolute values does not exceed one.*/
+static void fir_init(void) {
+  double h[FIR_TAPS], sum = 0.0;
+  unsigned i;
+
+  for (i = 0U; i < FIR_TAPS; i++) {
+    double t = (double)i - ((FIR_TAPS - 1U) / 2.0);
+    double w = 0.54 - 0.46 * cos((2.0 * M_PI * i) / (FIR_TAPS - 1U));
+
+    h[i] = (t == 0.0 ? 0.5 : sin(M_PI * 0.5 * t) / (M_PI * t)) * w;
+    sum += fabs(h[i]);
+  }
+  for (i = 0U; i < FIR_TAPS; i++) {
+    fir_coeffs[i] = (int16_t)floor((h[i] / sum) * 32767.0);
+  }
+}
+
+/* Application defined stage, checksum of the pipeline output.*/
+static struct {
+  dsp_stage_t   stage;
+  uint32_t      sum;
+  uint32_t      samples;
+} sink;
+
+static size_t sink_process(dsp_stage_t *sp, int16_t *buf, size_t n) {
+  size_t i;
+
+  (void)sp;
+
+  for (i = 0U; i < n; i++) {
+    sink.sum = (sink.sum * 31U) + (uint16_t)buf[i];
+  }
+  sink.samples += n;
+
+  return n;
+}
+
+static THD_WORKING_AREA(waDispatcher, 4096);
+static THD_FUNCTION(Dispatcher, arg) {
+
+  (void)arg;
+
+  chRegSetThreadName("dsp");
+  while (true) {
+    (void)chJobDispatch(&jobs);
+  }
+}
+
+/*===========================================================================*/
+/* Benchmark.                                                                */
+/*===========================================================================*/
+
+typedef enum {
+  ST_CIC = 1,
+  ST_FIR = 2,
+  ST_RMS = 4,
+  ST_MINMAX = 8,
+  ST_THRESHOLD = 16
+} stages_t;
+
+static void pipeline_setup(unsigned stages) {
+
+  dspPipelineObjectInit(&pipeline, &pipeline_cfg);
+  if ((stages & ST_CIC) != 0U) {
+    dspCICObjectInit(&cic, CIC_ORDER, CIC_RATIO, CIC_SHIFT);
+    dspPipelineAddStage(&pipeline, &cic.stage);
+  }
+  if ((stages & ST_FIR) != 0U) {
+    dspFIRObjectInit(&fir, fir_coeffs, FIR_TAPS, FIR_RATIO,
+                     fir_history, sizeof fir_history / sizeof fir_history[0]);
+    dspPipelineAddStage(&pipeline, &fir.stage);
+  }
+  if ((stages & ST_RMS) != 0U) {
+    dspRMSObjectInit(&rms, RMS_HOP, RMS_HOPS);
+    dspPipelineAddStage(&pipeline, &rms.stage);
+  }
+  if ((stages & ST_MINMAX) != 0U) {
+    dspMinMaxObjectInit(&minmax, MINMAX_WINDOW);
+    dspPipelineAddStage(&pipeline, &minmax.stage);
+  }
+  if ((stages & ST_THRESHOLD) != 0U) {
+    dspThresholdObjectInit(&threshold, TH_HIGH, TH_LOW);
+    dspPipelineAddStage(&pipeline, &threshold.stage);
+  }
+  sink.stage.next    = NULL;
+  sink.stage.process = sink_process;
+  sink.stage.cb      = NULL;
+  sink.stage.arg     = NULL;
+  sink.sum           = 0U;
+  sink.samples       = 0U;
+  dspPipelineAddStage(&pipeline, &sink.stage);
+}
+
+/* Posts blocks as fast as they are processed, the dispatcher has higher
+   priority and processes each block as soon as it is posted.*/
+static bool do_throughput(const char *name, unsigned stages) {
+  uint64_t start, ns, best = UINT64_MAX;
+  unsigned b, r;
+
+  for (r = 0U; r < BENCH_RUNS; r++) {
+    pipeline_setup(stages);
+
+    start = _sim_get_time();
+    for (b = 0U; b < BENCH_BLOCKS; b++) {
+      unsigned blk = b % (SIG_PERIOD / HALF_DEPTH);
+      bool dropped;
+
+      chSysLock();
+      dropped = dspPipelinePostI(&pipeline,
+                                 &signal[blk * HALF_DEPTH * ADC_CHANNELS],
+                                 HALF_DEPTH);
+      chSchRescheduleS();
+      chSysUnlock();
+      if (dropped) {
+        return true;
+      }
+    }
+    ns = _sim_get_time() - start;
+    if (ns < best) {
+      best = ns;
+    }
+    if (pipeline.processed != BENCH_BLOCKS) {
+      return true;
+    }
+  }
+
+  printf("%-12s: %7.2f ns/sample, %7.2f Msps, %6u output samples, "
+         "checksum %08X\n",
+         name, (double)best / (BENCH_BLOCKS * HALF_DEPTH),
+         (1000.0 * BENCH_BLOCKS * HALF_DEPTH) / (double)best,
+         (unsigned)sink.samples, (unsigned)sink.sum);
+
+  return false;
+}
+
+/* Results of the observer stages on the full rate signal, compared with
+   reference values computed on one period.*/
+static bool check_observers(void) {
+  uint64_t sumsq = 0U;
+  int16_t mn = INT16_MAX, mx = INT16_MIN;
+  uint32_t ref_rms;
+  unsigned i;
+
+  for (i = 0U; i < SIG_PERIOD; i++) {
+    int16_t x = signal_q15(i);
+
+    sumsq += (uint64_t)((int32_t)x * x);
+    if (x < mn) {
+      mn = x;
+    }
+    if (x > mx) {
+      mx = x;
+    }
+  }
+  ref_rms = (uint32_t)sqrt((double)(sumsq / SIG_PERIOD));
+
+  printf("\nRMS %u (expected %u), min %d max %d (expected %d %d), "
+         "%u crossings (expected %u)\n",
+         (unsigned)rms.rms, (unsigned)ref_rms, minmax.min, minmax.max,
+         mn, mx, (unsigned)threshold.crossings,
+         (unsigned)(2U * (BENCH_BLOCKS * HALF_DEPTH / SIG_PERIOD)));
+
+  return (rms.rms != ref_rms) || (minmax.min != mn) || (minmax.max != mx) ||
+         (threshold.crossings !=
+          2U * (BENCH_BLOCKS * HALF_DEPTH / SIG_PERIOD));
+}
+
+/* Real time run, the ADC end callback is emulated by a virtual timer
+   filling the next half buffer.*/
+static virtual_timer_t adc_vt;
+static unsigned adc_pos, adc_half;
+
+static void adc_cb(virtual_timer_t *vtp, void *arg) {
+  dsp_adcsample_t *half = &adc_buffer[adc_half * HALF_DEPTH * ADC_CHANNELS];
+
+  (void)arg;
+
+  memcpy(half, &signal[adc_pos * ADC_CHANNELS],
+         HALF_DEPTH * ADC_CHANNELS * sizeof (dsp_adcsample_t));
+  adc_pos  = (adc_pos + HALF_DEPTH) % SIG_PERIOD;
+  adc_half ^= 1U;
+
+  chSysLockFromISR();
+  (void)dspPipelinePostI(&pipeline, half, HALF_DEPTH);
+  chVTSetI(vtp, ADC_PERIOD, adc_cb, NULL);
+  chSysUnlockFromISR();
+}
+
+static bool do_realtime(void) {
+  uint32_t blocks;
+
+  pipeline_setup(ST_CIC | ST_FIR | ST_RMS | ST_MINMAX | ST_THRESHOLD);
+  adc_pos  = 0U;
+  adc_half = 0U;
+
+  chVTSet(&adc_vt, ADC_PERIOD, adc_cb, NULL);
+  chThdSleep(RT_TIME);
+  chVTReset(&adc_vt);
+  chThdSleep(TIME_MS2I(10));
+
+  blocks = pipeline.processed + pipeline.overruns;
+  printf("\nReal time   : %.2f Msps, %u blocks, %u processed, "
+         "%u overruns\n",
+         (double)HALF_DEPTH / (double)TIME_I2US(ADC_PERIOD),
+         (unsigned)blocks, (unsigned)pipeline.processed,
+         (unsigned)pipeline.overruns);
+
+  return (blocks == 0U) || (pipeline.overruns > 0U);
+}
+
+/*
+ * Application entry point.
+ */
+int main(void) {
+
+  /*
+   * System initializations.
+   * - HAL initialization, this also initializes the configured device drivers
+   *   and performs the board-specific initializations.
+   * - Kernel initialization, the main() function becomes a thread and the
+   *   RTOS is active.
+   */
+  halInit();
+  chSysInit();
+
+  signal_init();
+  fir_init();
+  chJobObjectInit(&jobs, 4U, jobs_buffer, msg_buffer);
+  chThdCreateStatic(waDispatcher, sizeof waDispatcher, NORMALPRIO + 1,
+                    Dispatcher, NULL);
+
+  printf("ADC DSP pipeline benchmark, %s kernels, %u samples blocks\n\n",
+#if ADC_DSP_SIMD_SSE2 == TRUE
+         "SSE2",
+#elif ADC_DSP_SIMD_ARM == TRUE
+         "DSP",
+#else
+         "scalar",
+#endif
+         (unsigned)HALF_DEPTH);
+
+  if (do_throughput("Conversion", 0U) ||
+      do_throughput("CIC", ST_CIC) ||
+      do_throughput("FIR", ST_FIR) ||
+      do_throughput("RMS", ST_RMS) ||
+      do_throughput("MinMax", ST_MINMAX) ||
+      do_throughput("Threshold", ST_THRESHOLD) ||
+      do_throughput("Observers", ST_RMS | ST_MINMAX | ST_THRESHOLD) ||
+      check_observers() ||
+      do_throughput("Chain", ST_CIC | ST_FIR | ST_RMS | ST_MINMAX |
+                             ST_THRESHOLD)) {
+    printf("FAILED\n");
+    return 1;
+  }
+  if (do_realtime()) {
+    printf("FAILED\n");
+    return 1;
+  }
+
+  return 0;
+}
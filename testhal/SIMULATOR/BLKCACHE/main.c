@@ -0,0 +1,439 @@
+/*
+    ChibiOS - Copyright (C) 2006..2018 Giovanni Di Sirio
+
+    Licensed under the Apache License, Version 2.0 (the "License");
+    you may not use this file except in compliance with the License.
+    You may obtain a copy of the License at
+
+        http://www.apache.org/licenses/LICENSE-2.0
+
+    Unless required by applicable law or agreed to in writing, software
+    distributed under the License is distributed on an "AS IS" BASIS,
+    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+    See the License for the specific language governing permissions and
+    limitations under the License.
+*/
+
+#include <stdio.h>
+#include <string.h>
+
+#include "ch.h"
+#include "hal.h"
+#include "blkcache.h"
+#include "simblk.h"
+
+/*===========================================================================*/
+/* RAM disk.                                                                 */
+/*===========================================================================*/
+
+/*
+ * RAM disk geometry and simulated media timings, the time spent by the
+ * benchmarks on the media is taken from the device statistics, this makes
+ * the results independent from the host.
+ */
+#define RAMDISK_BLOCK_SIZE          512U
+#define RAMDISK_BLOCKS              4096U
+#define RAMDISK_CMD_US              100U
+#define RAMDISK_BLOCK_US            25U
+
+static const SimBlockConfig ramdisk_config = {
+  NULL,
+  RAMDISK_BLOCK_SIZE,
+  RAMDISK_BLOCKS,
+  RAMDISK_CMD_US,
+  RAMDISK_BLOCK_US,
+  false
+};
+
+static SimBlockDevice ramdisk;
+
+/*===========================================================================*/
+/* Failing device.                                                           */
+/*===========================================================================*/
+
+/*
+ * Device forwarding to the RAM disk, writes fail on request.
+ */
+typedef struct {
+  const struct BaseBlockDeviceVMT   *vmt;
+  _base_block_device_data
+  bool                              fail;
+} FailingBlockDevice;
+
+static bool fail_is_inserted(void *instance) {
+
+  (void)instance;
+
+  return true;
+}
+
+static bool fail_is_protected(void *instance) {
+
+  (void)instance;
+
+  return false;
+}
+
+static bool fail_connect(void *instance) {
+
+  if (blkConnect(&ramdisk)) {
+    return HAL_FAILED;
+  }
+  ((FailingBlockDevice *)instance)->state = BLK_READY;
+
+  return HAL_SUCCESS;
+}
+
+static bool fail_disconnect(void *instance) {
+
+  ((FailingBlockDevice *)instance)->state = BLK_ACTIVE;
+
+  return blkDisconnect(&ramdisk);
+}
+
+static bool fail_read(void *instance, uint32_t startblk,
+                      uint8_t *buffer, uint32_t n) {
+
+  (void)instance;
+
+  return blkRead(&ramdisk, startblk, buffer, n);
+}
+
+static bool fail_write(void *instance, uint32_t startblk,
+                       const uint8_t *buffer, uint32_t n) {
+
+  if (((FailingBlockDevice *)instance)->fail) {
+    return HAL_FAILED;
+  }
+
+  return blkWrite(&ramdisk, startblk, buffer, n);
+}
+
+static bool fail_sync(void *instance) {
+
+  (void)instance;
+
+  return blkSync(&ramdisk);
+}
+
+static bool fail_get_info(void *instance, BlockDeviceInfo *bdip) {
+
+  (void)instance;
+
+  return blkGetInfo(&ramdisk, bdip);
+}
+
+static const struct BaseBlockDeviceVMT fail_vmt = {
+  (size_t)0,
+  fail_is_inserted,
+  fail_is_protected,
+  fail_connect,
+  fail_disconnect,
+  fail_read,
+  fail_write,
+  fail_sync,
+  fail_get_info
+};
+
+static FailingBlockDevice faildisk = {&fail_vmt, BLK_ACTIVE, false};
+
+/*===========================================================================*/
+/* Block cache.                                                              */
+/*===========================================================================*/
+
+#define CACHE_BLOCKS                32U
+#define CACHE_RA_BLOCKS             8U
+
+static oc_hash_header_t cache_hash[CACHE_BLOCKS * 2U];
+static oc_object_t cache_objects[CACHE_BLOCKS];
+static uint8_t cache_buffer[BLKCACHE_BUFFER_SIZE(CACHE_BLOCKS)];
+static uint8_t cache_rabuffer[BLKCACHE_RA_BUFFER_SIZE(CACHE_RA_BLOCKS)];
+
+static const BlockCacheConfig cache_config = {
+  (BaseBlockDevice *)&ramdisk,
+  CACHE_BLOCKS * 2U,
+  cache_hash,
+  CACHE_BLOCKS,
+  cache_objects,
+  cache_buffer,
+  CACHE_RA_BLOCKS,
+  cache_rabuffer,
+  16U
+};
+
+static const BlockCacheConfig failcache_config = {
+  (BaseBlockDevice *)&faildisk,
+  CACHE_BLOCKS * 2U,
+  cache_hash,
+  CACHE_BLOCKS,
+  cache_objects,
+  cache_buffer,
+  CACHE_RA_BLOCKS,
+  cache_rabuffer,
+  16U
+};
+
+static BlockCacheDriver BCD1;
+
+/*===========================================================================*/
+/* Workloads.                                                                */
+/*===========================================================================*/
+
+/* Layout of the simulated file system.*/
+#define FAT_START                   32U
+#define DIR_START                   96U
+#define DIR_BLOCKS                  16U
+#define DATA_START                  512U
+
+static uint8_t blkbuf[16U * RAMDISK_BLOCK_SIZE];
+
+/*
+ * Repeated scans of a directory, one sector at time as FatFs does.
+ */
+static bool wl_dir_scan(BaseBlockDevice *bdp) {
+  unsigned i, j;
+
+  for (i = 0U; i < 64U; i++) {
+    for (j = 0U; j < DIR_BLOCKS; j++) {
+      if (blkRead(bdp, DIR_START + j, blkbuf, 1U)) {
+        return true;
+      }
+    }
+  }
+  return false;
+}
+
+/*
+ * Cluster chain walk, a FAT sector lookup for each data sector.
+ */
+static bool wl_fat_walk(BaseBlockDevice *bdp) {
+  unsigned i;
+
+  for (i = 0U; i < 1024U; i++) {
+    if (blkRead(bdp, FAT_START + (i / 128U), blkbuf, 1U) ||
+        blkRead(bdp, DATA_START + i, blkbuf, 1U)) {
+      return true;
+    }
+  }
+  return false;
+}
+
+/*
+ * Sequential single sector reads.
+ */
+static bool wl_seq_read(BaseBlockDevice *bdp) {
+  unsigned i;
+
+  for (i = 0U; i < 2048U; i++) {
+    if (blkRead(bdp, DATA_START + i, blkbuf, 1U)) {
+      return true;
+    }
+  }
+  return false;
+}
+
+/*
+ * Large multi-sector reads, these bypass the cache.
+ */
+static bool wl_bulk_read(BaseBlockDevice *bdp) {
+  unsigned i;
+
+  for (i = 0U; i < 2048U; i += 16U) {
+    if (blkRead(bdp, DATA_START + i, blkbuf, 16U)) {
+      return true;
+    }
+  }
+  return false;
+}
+
+/*
+ * Appending to a file, each data sector write updates a FAT sector and
+ * the directory entry.
+ */
+static bool wl_append(BaseBlockDevice *bdp) {
+  unsigned i;
+
+  for (i = 0U; i < 512U; i++) {
+    memset(blkbuf, (int)(i & 0xFFU), RAMDISK_BLOCK_SIZE);
+    if (blkWrite(bdp, DATA_START + i, blkbuf, 1U) ||
+        blkWrite(bdp, FAT_START + (i / 128U), blkbuf, 1U) ||
+        blkWrite(bdp, DIR_START, blkbuf, 1U)) {
+      return true;
+    }
+  }
+  return blkSync(bdp);
+}
+
+typedef struct {
+  const char    *name;
+  bool          (*fn)(BaseBlockDevice *bdp);
+} workload_t;
+
+static const workload_t workloads[] = {
+  {"directory scan", wl_dir_scan},
+  {"FAT chain walk", wl_fat_walk},
+  {"sequential read", wl_seq_read},
+  {"bulk read", wl_bulk_read},
+  {"append and sync", wl_append},
+  {NULL, NULL}
+};
+
+/*===========================================================================*/
+/* Benchmark.                                                                */
+/*===========================================================================*/
+
+static uint32_t media_ms(void) {
+
+  return (uint32_t)(sblkGetStats(&ramdisk)->busy_time / 1000U);
+}
+
+static void run(const workload_t *wlp, BaseBlockDevice *bdp) {
+  rtcnt_t start, end;
+
+  sblkResetStats(&ramdisk);
+  bcacheResetStats(&BCD1);
+
+  start = chSysGetRealtimeCounterX();
+  if (wlp->fn(bdp)) {
+    printf("  %-8s: FAILED\n", bdp == (BaseBlockDevice *)&ramdisk ? "direct" : "cached");
+    return;
+  }
+  end = chSysGetRealtimeCounterX();
+
+  printf("  %-8s: %6u commands, %6u blocks, %6u ms media, %8u RT counts\n",
+         bdp == (BaseBlockDevice *)&ramdisk ? "direct" : "cached",
+         (unsigned)(sblkGetStats(&ramdisk)->reads +
+                    sblkGetStats(&ramdisk)->writes),
+         (unsigned)(sblkGetStats(&ramdisk)->blocks_read +
+                    sblkGetStats(&ramdisk)->blocks_written),
+         (unsigned)media_ms(), (unsigned)(end - start));
+}
+
+static bool check_content(void) {
+  unsigned i;
+
+  /* The appended data must have reached the media after the sync.*/
+  for (i = 0U; i < 512U; i++) {
+    if (ramdisk.storage[(DATA_START + i) * RAMDISK_BLOCK_SIZE] !=
+        (uint8_t)(i & 0xFFU)) {
+      return true;
+    }
+  }
+  return false;
+}
+
+/*
+ * Write-back failures happening while blocks are recycled must be reported
+ * by the next synchronization.
+ */
+static bool check_wbfailure(void) {
+  unsigned i;
+
+  bcacheStart(&BCD1, &failcache_config);
+  if (blkConnect(&BCD1)) {
+    return true;
+  }
+
+  /* Filling the cache with modified blocks.*/
+  faildisk.fail = false;
+  memset(blkbuf, 0x55, RAMDISK_BLOCK_SIZE);
+  for (i = 0U; i < CACHE_BLOCKS; i++) {
+    if (blkWrite(&BCD1, DATA_START + i, blkbuf, 1U)) {
+      return true;
+    }
+  }
+
+  /* Recycling them while the device fails.*/
+  faildisk.fail = true;
+  for (i = 0U; i < CACHE_BLOCKS; i++) {
+    if (blkWrite(&BCD1, DATA_START + 1024U + i, blkbuf, 1U)) {
+      return true;
+    }
+  }
+
+  /* The first synchronization reports the failure, the second succeeds.*/
+  faildisk.fail = false;
+  if (!blkSync(&BCD1) || blkSync(&BCD1)) {
+    return true;
+  }
+
+  (void) blkDisconnect(&BCD1);
+  bcacheStop(&BCD1);
+
+  return false;
+}
+
+/*
+ * Application entry point.
+ */
+int main(void) {
+  const workload_t *wlp;
+
+  /*
+   * System initializations.
+   * - HAL initialization, this also initializes the configured device drivers
+   *   and performs the board-specific initializations.
+   * - Kernel initialization, the main() function becomes a thread and the
+   *   RTOS is active.
+   */
+  halInit();
+  chSysInit();
+
+  /*
+   * RAM disk backed by anonymous host memory.
+   */
+  sblkObjectInit(&ramdisk);
+  if (sblkStart(&ramdisk, &ramdisk_config) != HAL_RET_SUCCESS) {
+    printf("RAM disk activation failed\n");
+    return 1;
+  }
+  (void) blkConnect(&ramdisk);
+
+  /*
+   * Block cache on top of the RAM disk.
+   */
+  bcacheObjectInit(&BCD1);
+  bcacheStart(&BCD1, &cache_config);
+  if (blkConnect(&BCD1)) {
+    printf("Block cache connection failed\n");
+    return 1;
+  }
+
+  printf("Block cache benchmark, %u cached blocks, %u read-ahead blocks\n",
+         (unsigned)CACHE_BLOCKS, (unsigned)CACHE_RA_BLOCKS);
+  printf("Simulated media: %u us per command, %u us per block\n\n",
+         (unsigned)RAMDISK_CMD_US, (unsigned)RAMDISK_BLOCK_US);
+
+  for (wlp = workloads; wlp->name != NULL; wlp++) {
+    printf("%s\n", wlp->name);
+    run(wlp, (BaseBlockDevice *)&ramdisk);
+    run(wlp, (BaseBlockDevice *)&BCD1);
+    printf("  hits %u, misses %u, prefetched %u, writebacks %u in %u "
+           "transfers, bypassed %u\n",
+           (unsigned)bcacheGetStats(&BCD1)->hits,
+           (unsigned)bcacheGetStats(&BCD1)->misses,
+           (unsigned)bcacheGetStats(&BCD1)->prefetched,
+           (unsigned)bcacheGetStats(&BCD1)->writebacks,
+           (unsigned)bcacheGetStats(&BCD1)->transfers,
+           (unsigned)bcacheGetStats(&BCD1)->bypassed);
+  }
+
+  if (check_content()) {
+    printf("\nContent check FAILED\n");
+    return 1;
+  }
+  printf("\nContent check passed\n");
+
+  (void) blkDisconnect(&BCD1);
+  bcacheStop(&BCD1);
+
+  if (check_wbfailure()) {
+    printf("Write-back failure check FAILED\n");
+    return 1;
+  }
+  printf("Write-back failure check passed\n");
+  (void) blkDisconnect(&ramdisk);
+  sblkStop(&ramdisk);
+
+  return 0;
+}
@@ -0,0 +1,262 @@
+/*
+    ChibiOS - Copyright (C) 2006..2018 Giovanni Di Sirio
+
+    Licensed under the Apache License, Version 2.0 (the "License");
+    you may not use this file except in compliance with the License.
+    You may obtain a copy of the License at
+
+        http://www.apache.org/licenses/LICENSE-2.0
+
+    Unless required by applicable law or agreed to in writing, software
+    distributed under the License is distributed on an "AS IS" BASIS,
+    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+    See the License for the specific language governing permissions and
+    limitations under the License.
+*/
+
+#include <stdio.h>
+#include <string.h>
+
+#include "ch.h"
+#include "hal.h"
+
+/*===========================================================================*/
+/* Benchmark settings.                                                       */
+/*===========================================================================*/
+
+/* Duration of each run.*/
+#define BENCH_TIME                  TIME_MS2I(1000)
+
+/* Fully loaded 1Mbps bus, the other nodes cycle over BUS_IDS identifiers.*/
+#define BUS_BITRATE                 1000000U
+#define BUS_IDS                     512U
+
+/* The receiver is interested in one identifier every WANTED_STEP.*/
+#define WANTED_STEP                 16U
+#define WANTED_NUM                  (BUS_IDS / WANTED_STEP)
+
+/* A higher priority thread keeps the CPU busy for BURST_US every
+   BURST_PERIOD, interrupts are still served meanwhile.*/
+#define BURST_US                    1000U
+#define BURST_PERIOD                TIME_MS2I(10)
+
+/* RX ring size and size of each batch.*/
+#define RING_FRAMES                 256U
+#define BATCH_FRAMES                32U
+
+/*===========================================================================*/
+/* Bus traffic.                                                              */
+/*===========================================================================*/
+
+static uint32_t bus_seq;
+
+static bool bus_source(void *arg, CANRxFrame *crfp) {
+
+  (void)arg;
+
+  crfp->IDE       = CAN_IDE_STD;
+  crfp->RTR       = CAN_RTR_DATA;
+  crfp->DLC       = 8U;
+  crfp->SID       = bus_seq % BUS_IDS;
+  crfp->data32[0] = bus_seq;
+  crfp->data32[1] = ~bus_seq;
+  bus_seq++;
+
+  return true;
+}
+
+static const CANConfig cancfg = {
+  .bitrate          = BUS_BITRATE,
+  .source           = bus_source,
+  .arg              = NULL
+};
+
+static uint32_t wanted_id(unsigned i) {
+
+  return (uint32_t)((i * WANTED_STEP) + 3U);
+}
+
+/*===========================================================================*/
+/* Benchmark.                                                                */
+/*===========================================================================*/
+
+static struct {
+  uint32_t      received;
+  uint32_t      lost;
+  uint32_t      wakeups;
+  uint32_t      last;
+  bool          first;
+  bool          failed;
+  sysinterval_t latency;
+} stats;
+
+static volatile bool done;
+
+/* Checks the sequence of the wanted frames, gaps are lost frames.*/
+static void account(const CANRxFrame *crfp) {
+  uint32_t seq = crfp->data32[0];
+
+  if ((crfp->data32[1] != ~seq) || ((seq % WANTED_STEP) != 3U)) {
+    stats.failed = true;
+    return;
+  }
+  if (!stats.first) {
+    stats.lost += ((seq - stats.last) / WANTED_STEP) - 1U;
+  }
+  stats.first = false;
+  stats.last  = seq;
+  stats.received++;
+}
+
+static THD_WORKING_AREA(waBurst, 256);
+static THD_FUNCTION(Burst, arg) {
+
+  (void)arg;
+
+  while (!done) {
+    uint64_t end = _sim_get_time() + ((uint64_t)BURST_US * 1000U);
+
+    while (_sim_get_time() < end) {
+      _sim_check_for_interrupts();
+    }
+    chThdSleep(BURST_PERIOD);
+  }
+}
+
+static THD_WORKING_AREA(waReceiver, 4096);
+
+/* Single frame reception, filtering is done by the application.*/
+static THD_FUNCTION(MailboxReceiver, arg) {
+  systime_t start = chVTGetSystemTimeX();
+
+  (void)arg;
+
+  while (chVTTimeElapsedSinceX(start) < BENCH_TIME) {
+    CANRxFrame rxf;
+    unsigned i;
+
+    if (canReceiveTimeout(&CAND1, CAN_ANY_MAILBOX, &rxf,
+                          TIME_MS2I(10)) != MSG_OK) {
+      continue;
+    }
+    stats.wakeups++;
+    for (i = 0U; i < WANTED_NUM; i++) {
+      if ((rxf.IDE == CAN_IDE_STD) && (rxf.SID == wanted_id(i))) {
+        account(&rxf);
+        break;
+      }
+    }
+  }
+}
+
+/* Batched reception from the RX ring, filtering is done by the ISR.*/
+static THD_FUNCTION(RingReceiver, arg) {
+  static CANRxStampedFrame frames[BATCH_FRAMES];
+  systime_t start = chVTGetSystemTimeX();
+
+  (void)arg;
+
+  while (chVTTimeElapsedSinceX(start) < BENCH_TIME) {
+    size_t i, n;
+
+    n = canReceiveMany(&CAND1, frames, BATCH_FRAMES, TIME_MS2I(10));
+    if (n == 0U) {
+      continue;
+    }
+    stats.wakeups++;
+    for (i = 0U; i < n; i++) {
+      sysinterval_t t = chVTTimeElapsedSinceX(frames[i].timestamp);
+
+      if (t > stats.latency) {
+        stats.latency = t;
+      }
+      account(&frames[i].frame);
+    }
+  }
+}
+
+static bool do_bench(const char *name, tfunc_t receiver, bool ring) {
+  static CANRxStampedFrame ring_buffer[RING_FRAMES];
+  uint32_t frames, overruns;
+  thread_t *btp, *rtp;
+  unsigned i;
+
+  memset(&stats, 0, sizeof (stats));
+  stats.first = true;
+  done = false;
+
+  canStart(&CAND1, &cancfg);
+  if (ring) {
+    canRxRingStart(&CAND1, ring_buffer, RING_FRAMES);
+    canRxFilterClear(&CAND1);
+    for (i = 0U; i < WANTED_NUM; i++) {
+      if (canRxFilterAdd(&CAND1, wanted_id(i))) {
+        return true;
+      }
+    }
+  }
+  frames   = CAND1.frames;
+  overruns = CAND1.overruns;
+
+  btp = chThdCreateStatic(waBurst, sizeof waBurst, NORMALPRIO + 2,
+                          Burst, NULL);
+  rtp = chThdCreateStatic(waReceiver, sizeof waReceiver, NORMALPRIO + 1,
+                          receiver, NULL);
+  chThdWait(rtp);
+  done = true;
+  chThdWait(btp);
+
+  frames   = CAND1.frames - frames;
+  overruns = CAND1.overruns - overruns;
+
+  printf("%-8s: %5u frames/s on bus, %4u wanted received, %4u lost\n",
+         name, (unsigned)frames, (unsigned)stats.received,
+         (unsigned)stats.lost);
+  printf("          %5u receiver wakeups, %5u hardware FIFO overruns\n",
+         (unsigned)stats.wakeups, (unsigned)overruns);
+  if (ring) {
+    printf("          %5u filtered in ISR, %5u ring overruns, "
+           "max latency %u us\n",
+           (unsigned)CAND1.rxfilter_rejects, (unsigned)CAND1.rxring_overruns,
+           (unsigned)TIME_I2US(stats.latency));
+  }
+  printf("\n");
+
+  canStop(&CAND1);
+
+  return stats.failed || (stats.received == 0U);
+}
+
+/*
+ * Application entry point.
+ */
+int main(void) {
+
+  /*
+   * System initializations.
+   * - HAL initialization, this also initializes the configured device drivers
+   *   and performs the board-specific initializations.
+   * - Kernel initialization, the main() function becomes a thread and the
+   *   RTOS is active.
+   */
+  halInit();
+  chSysInit();
+
+  printf("CAN reception benchmark, %u kbps fully loaded bus, "
+         "%u of %u IDs wanted\n",
+         (unsigned)(BUS_BITRATE / 1000U), (unsigned)WANTED_NUM,
+         (unsigned)BUS_IDS);
+  printf("Receiver preempted for %u us every %u ms\n\n",
+         (unsigned)BURST_US, (unsigned)TIME_I2MS(BURST_PERIOD));
+
+  if (do_bench("Mailbox", MailboxReceiver, false)) {
+    printf("Mailbox : FAILED\n");
+    return 1;
+  }
+  if (do_bench("Ring", RingReceiver, true)) {
+    printf("Ring    : FAILED\n");
+    return 1;
+  }
+
+  return 0;
+}
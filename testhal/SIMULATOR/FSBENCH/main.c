@@ -0,0 +1,488 @@
+/*
+    ChibiOS - Copyright (C) 2006..2018 Giovanni Di Sirio
+
+    Licensed under the Apache License, Version 2.0 (the "License");
+    you may not use this file except in compliance with the License.
+    You may obtain a copy of the License at
+
+        http://www.apache.org/licenses/LICENSE-2.0
+
+    Unless required by applicable law or agreed to in writing, software
+    distributed under the License is distributed on an "AS IS" BASIS,
+    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+    See the License for the specific language governing permissions and
+    limitations under the License.
+*/
+
+#include <stdio.h>
+#include <string.h>
+
+#include "ch.h"
+#include "hal.h"
+#include "vfs.h"
+#include "ff.h"
+#include "simblk.h"
+
+/*===========================================================================*/
+/* Benchmark settings.                                                       */
+/*===========================================================================*/
+
+/*
+ * Host file backing the disk, NULL for an anonymous RAM disk.
+ */
+#define DISK_PATH                   NULL
+#define DISK_BLOCK_SIZE             512U
+#define DISK_BLOCKS                 65536U
+#define DISK_CMD_US                 50U
+#define DISK_BLOCK_US               5U
+
+#define SEQ_FILE_SIZE               (2U * 1024U * 1024U)
+#define SEQ_IO_SIZE                 4096U
+#define RND_IO_SIZE                 512U
+#define RND_IO_NUM                  512U
+#define DIR_FILES                   64U
+#define DIR_SCANS                   16U
+#define SMALL_FILE_SIZE             (64U * 1024U)
+#define SMALL_IO_SIZE               16U
+
+/*===========================================================================*/
+/* Disk and file system.                                                     */
+/*===========================================================================*/
+
+static const SimBlockConfig disk_config = {
+  DISK_PATH,
+  DISK_BLOCK_SIZE,
+  DISK_BLOCKS,
+  DISK_CMD_US,
+  DISK_BLOCK_US,
+  false
+};
+
+/* Block device accessed by the FatFS bindings.*/
+SimBlockDevice SBD1;
+
+/* VFS FatFS driver object representing the root directory.*/
+static vfs_fatfs_driver_c root_driver;
+
+/* VFS API will use this object as implicit root, defining this
+   symbol is expected.*/
+vfs_driver_c *vfs_root = (vfs_driver_c *)&root_driver;
+
+static uint8_t mkfs_buf[4096];
+static uint8_t io_buf[SEQ_IO_SIZE];
+
+/*===========================================================================*/
+/* Driver calls counting.                                                    */
+/*===========================================================================*/
+
+/*
+ * The FatFS read and write entry points are wrapped at link time, the
+ * counter is the number of data transfers requested to the file system.
+ * Writes can be made to fail in order to check the error paths.
+ */
+static uint32_t drv_calls;
+static bool drv_fail;
+
+FRESULT __real_f_read(FIL *fp, void *buff, UINT btr, UINT *br);
+FRESULT __real_f_write(FIL *fp, const void *buff, UINT btw, UINT *bw);
+
+FRESULT __wrap_f_read(FIL *fp, void *buff, UINT btr, UINT *br) {
+
+  drv_calls++;
+  return __real_f_read(fp, buff, btr, br);
+}
+
+FRESULT __wrap_f_write(FIL *fp, const void *buff, UINT btw, UINT *bw) {
+
+  drv_calls++;
+  if (drv_fail) {
+    *bw = 0U;
+    return FR_DISK_ERR;
+  }
+  return __real_f_write(fp, buff, btw, bw);
+}
+
+/*===========================================================================*/
+/* Workloads.                                                                */
+/*===========================================================================*/
+
+static uint32_t seed;
+
+static uint32_t rnd(void) {
+
+  seed = (seed * 1103515245U) + 12345U;
+  return seed >> 8;
+}
+
+static void fill(uint8_t *p, size_t n, uint32_t tag) {
+  size_t i;
+
+  for (i = 0U; i < n; i++) {
+    p[i] = (uint8_t)(tag + i);
+  }
+}
+
+static bool wl_seq_write(size_t *bytesp) {
+  vfs_file_node_c *fnp;
+  uint32_t i;
+
+  if (CH_RET_IS_ERROR(vfsOpenFile("/seq.bin",
+                                  VO_WRONLY | VO_CREAT, &fnp))) {
+    return true;
+  }
+  for (i = 0U; i < SEQ_FILE_SIZE / SEQ_IO_SIZE; i++) {
+    fill(io_buf, SEQ_IO_SIZE, i);
+    if (vfsWriteFile(fnp, io_buf, SEQ_IO_SIZE) != (ssize_t)SEQ_IO_SIZE) {
+      vfsClose((vfs_node_c *)fnp);
+      return true;
+    }
+  }
+  vfsClose((vfs_node_c *)fnp);
+  *bytesp = SEQ_FILE_SIZE;
+  return false;
+}
+
+static bool wl_seq_read(size_t *bytesp) {
+  vfs_file_node_c *fnp;
+  uint32_t i;
+
+  if (CH_RET_IS_ERROR(vfsOpenFile("/seq.bin", VO_RDONLY, &fnp))) {
+    return true;
+  }
+  for (i = 0U; i < SEQ_FILE_SIZE / SEQ_IO_SIZE; i++) {
+    if ((vfsReadFile(fnp, io_buf, SEQ_IO_SIZE) != (ssize_t)SEQ_IO_SIZE) ||
+        (io_buf[SEQ_IO_SIZE - 1U] != (uint8_t)(i + SEQ_IO_SIZE - 1U))) {
+      vfsClose((vfs_node_c *)fnp);
+      return true;
+    }
+  }
+  vfsClose((vfs_node_c *)fnp);
+  *bytesp = SEQ_FILE_SIZE;
+  return false;
+}
+
+static bool wl_rnd_io(bool write, size_t *bytesp) {
+  vfs_file_node_c *fnp;
+  vfs_offset_t offset;
+  uint32_t i;
+
+  if (CH_RET_IS_ERROR(vfsOpenFile("/seq.bin",
+                                  write ? VO_RDWR : VO_RDONLY, &fnp))) {
+    return true;
+  }
+  seed = 1U;
+  for (i = 0U; i < RND_IO_NUM; i++) {
+    offset = (vfs_offset_t)((rnd() % (SEQ_FILE_SIZE / RND_IO_SIZE)) *
+                            RND_IO_SIZE);
+    if (CH_RET_IS_ERROR(vfsSetFilePosition(fnp, offset, VFS_SEEK_SET))) {
+      vfsClose((vfs_node_c *)fnp);
+      return true;
+    }
+    if (write) {
+      fill(io_buf, RND_IO_SIZE, (uint32_t)offset);
+      if (vfsWriteFile(fnp, io_buf, RND_IO_SIZE) != (ssize_t)RND_IO_SIZE) {
+        vfsClose((vfs_node_c *)fnp);
+        return true;
+      }
+    }
+    else {
+      if (vfsReadFile(fnp, io_buf, RND_IO_SIZE) != (ssize_t)RND_IO_SIZE) {
+        vfsClose((vfs_node_c *)fnp);
+        return true;
+      }
+    }
+  }
+  vfsClose((vfs_node_c *)fnp);
+  *bytesp = RND_IO_NUM * RND_IO_SIZE;
+  return false;
+}
+
+static bool wl_rnd_write(size_t *bytesp) {
+
+  return wl_rnd_io(true, bytesp);
+}
+
+static bool wl_rnd_read(size_t *bytesp) {
+
+  return wl_rnd_io(false, bytesp);
+}
+
+static bool wl_dir_create(size_t *bytesp) {
+  vfs_file_node_c *fnp;
+  char path[32];
+  uint32_t i;
+
+  if (CH_RET_IS_ERROR(vfsMkdir("/dir", 0777))) {
+    return true;
+  }
+  for (i = 0U; i < DIR_FILES; i++) {
+    (void) snprintf(path, sizeof path, "/dir/file%03u.txt", (unsigned)i);
+    if (CH_RET_IS_ERROR(vfsOpenFile(path, VO_WRONLY | VO_CREAT, &fnp))) {
+      return true;
+    }
+    fill(io_buf, 64U, i);
+    if (vfsWriteFile(fnp, io_buf, 64U) != 64) {
+      vfsClose((vfs_node_c *)fnp);
+      return true;
+    }
+    vfsClose((vfs_node_c *)fnp);
+  }
+  *bytesp = DIR_FILES * 64U;
+  return false;
+}
+
+static bool wl_dir_scan(size_t *bytesp) {
+  static vfs_direntry_info_t di;
+  vfs_directory_node_c *dnp;
+  uint32_t i, n;
+  msg_t ret;
+
+  for (i = 0U; i < DIR_SCANS; i++) {
+    if (CH_RET_IS_ERROR(vfsOpenDirectory("/dir", &dnp))) {
+      return true;
+    }
+    n = 0U;
+    ret = vfsReadDirectoryFirst(dnp, &di);
+    while (ret > (msg_t)0) {
+      n++;
+      ret = vfsReadDirectoryNext(dnp, &di);
+    }
+    vfsClose((vfs_node_c *)dnp);
+    if (CH_RET_IS_ERROR(ret) || (n != DIR_FILES)) {
+      return true;
+    }
+  }
+  *bytesp = 0U;
+  return false;
+}
+
+static bool wl_stat(size_t *bytesp) {
+  vfs_stat_t st;
+  char path[32];
+  uint32_t i;
+
+  for (i = 0U; i < DIR_FILES; i++) {
+    (void) snprintf(path, sizeof path, "/dir/file%03u.txt", (unsigned)i);
+    if (CH_RET_IS_ERROR(vfsStat(path, &st)) || (st.size != 64)) {
+      return true;
+    }
+  }
+  *bytesp = 0U;
+  return false;
+}
+
+static bool wl_small_io(bool write, bool buffered, size_t *bytesp) {
+  vfs_file_node_c *fnp;
+  int flags = write ? VO_WRONLY | VO_CREAT : VO_RDONLY;
+  msg_t ret;
+  uint32_t i;
+
+  if (buffered) {
+    ret = vfsOpenFileBuffered("/small.bin", flags, &fnp);
+  }
+  else {
+    ret = vfsOpenFile("/small.bin", flags, &fnp);
+  }
+  if (CH_RET_IS_ERROR(ret)) {
+    return true;
+  }
+  for (i = 0U; i < SMALL_FILE_SIZE / SMALL_IO_SIZE; i++) {
+    if (write) {
+      fill(io_buf, SMALL_IO_SIZE, i);
+      if (vfsWriteFile(fnp, io_buf, SMALL_IO_SIZE) != (ssize_t)SMALL_IO_SIZE) {
+        vfsClose((vfs_node_c *)fnp);
+        return true;
+      }
+    }
+    else {
+      if ((vfsReadFile(fnp, io_buf, SMALL_IO_SIZE) != (ssize_t)SMALL_IO_SIZE) ||
+          (io_buf[0] != (uint8_t)i)) {
+        vfsClose((vfs_node_c *)fnp);
+        return true;
+      }
+    }
+  }
+  vfsClose((vfs_node_c *)fnp);
+  *bytesp = SMALL_FILE_SIZE;
+  return false;
+}
+
+static bool wl_small_write(size_t *bytesp) {
+
+  return wl_small_io(true, false, bytesp);
+}
+
+static bool wl_small_read(size_t *bytesp) {
+
+  return wl_small_io(false, false, bytesp);
+}
+
+static bool wl_small_write_buf(size_t *bytesp) {
+
+  return wl_small_io(true, true, bytesp);
+}
+
+static bool wl_small_read_buf(size_t *bytesp) {
+
+  return wl_small_io(false, true, bytesp);
+}
+
+typedef struct {
+  const char    *name;
+  bool          (*fn)(size_t *bytesp);
+} workload_t;
+
+static const workload_t workloads[] = {
+  {"sequential write", wl_seq_write},
+  {"sequential read", wl_seq_read},
+  {"random write", wl_rnd_write},
+  {"random read", wl_rnd_read},
+  {"directory create", wl_dir_create},
+  {"directory scan", wl_dir_scan},
+  {"stat", wl_stat},
+  {"small write", wl_small_write},
+  {"small read", wl_small_read},
+  {"small write buf", wl_small_write_buf},
+  {"small read buf", wl_small_read_buf},
+  {NULL, NULL}
+};
+
+/*===========================================================================*/
+/* Write-back failure.                                                       */
+/*===========================================================================*/
+
+/*
+ * Buffered data failing the write-back must be kept, the error is reported
+ * by the next flush and a later flush writes the data.
+ */
+static bool check_writeback(void) {
+  vfs_file_node_c *fnp;
+  uint8_t buf[2U * SMALL_IO_SIZE];
+  bool err;
+
+  if (CH_RET_IS_ERROR(vfsOpenFileBuffered("/wbfail.bin",
+                                          VO_WRONLY | VO_CREAT, &fnp))) {
+    return true;
+  }
+  fill(io_buf, sizeof buf, 0U);
+  drv_fail = true;
+  err = (vfsWriteFile(fnp, io_buf, SMALL_IO_SIZE) != (ssize_t)SMALL_IO_SIZE) ||
+        !CH_RET_IS_ERROR(vfsSetFilePosition(fnp, 0, VFS_SEEK_CUR)) ||
+        (vfsWriteFile(fnp, &io_buf[SMALL_IO_SIZE], SMALL_IO_SIZE) !=
+         (ssize_t)SMALL_IO_SIZE) ||
+        !CH_RET_IS_ERROR(vfsSetFilePosition(fnp, 0, VFS_SEEK_CUR));
+  drv_fail = false;
+  err = err || CH_RET_IS_ERROR(vfsSetFilePosition(fnp, 0, VFS_SEEK_CUR)) ||
+        (vfsGetFilePosition(fnp) != (vfs_offset_t)sizeof buf);
+  vfsClose((vfs_node_c *)fnp);
+  if (err) {
+    return true;
+  }
+
+  if (CH_RET_IS_ERROR(vfsOpenFile("/wbfail.bin", VO_RDONLY, &fnp))) {
+    return true;
+  }
+  err = (vfsReadFile(fnp, buf, sizeof buf) != (ssize_t)sizeof buf) ||
+        (memcmp(buf, io_buf, sizeof buf) != 0);
+  vfsClose((vfs_node_c *)fnp);
+
+  return err;
+}
+
+/*===========================================================================*/
+/* Benchmark.                                                                */
+/*===========================================================================*/
+
+static bool run(const workload_t *wlp) {
+  const SimBlockStats *sp = sblkGetStats(&SBD1);
+  rtcnt_t start, end;
+  size_t bytes;
+  uint32_t media_us;
+
+  sblkResetStats(&SBD1);
+  drv_calls = 0U;
+
+  start = chSysGetRealtimeCounterX();
+  if (wlp->fn(&bytes)) {
+    printf("%-18s: FAILED\n", wlp->name);
+    return true;
+  }
+  end = chSysGetRealtimeCounterX();
+
+  media_us = (uint32_t)sp->busy_time;
+  printf("%-18s: %6u calls %6u cmds %7u blks %6u ms media %6u KB/s "
+         "%8u RT counts\n",
+         wlp->name,
+         (unsigned)drv_calls,
+         (unsigned)(sp->reads + sp->writes),
+         (unsigned)(sp->blocks_read + sp->blocks_written),
+         (unsigned)(media_us / 1000U),
+         (unsigned)(media_us > 0U ? ((uint64_t)bytes * 1000U) / media_us : 0U),
+         (unsigned)(end - start));
+  return false;
+}
+
+/*
+ * Application entry point.
+ */
+int main(void) {
+  const workload_t *wlp;
+
+  /*
+   * System initializations.
+   * - HAL initialization, this also initializes the configured device drivers
+   *   and performs the board-specific initializations.
+   * - Kernel initialization, the main() function becomes a thread and the
+   *   RTOS is active.
+   * - Virtual File System initialization.
+   */
+  halInit();
+  chSysInit();
+  vfsInit();
+
+  /*
+   * Simulated disk activation.
+   */
+  sblkObjectInit(&SBD1);
+  if (sblkStart(&SBD1, &disk_config) != HAL_RET_SUCCESS) {
+    printf("Disk activation failed\n");
+    return 1;
+  }
+  (void) blkConnect(&SBD1);
+
+  /*
+   * Formatting and mounting the volume, the root is a FatFS VFS driver.
+   */
+  if (f_mkfs("0:", NULL, mkfs_buf, sizeof mkfs_buf) != FR_OK) {
+    printf("Format failed\n");
+    return 1;
+  }
+  ffdrvObjectInit(&root_driver);
+  if (CH_RET_IS_ERROR(ffdrvMount("0:", true))) {
+    printf("Mount failed\n");
+    return 1;
+  }
+
+  printf("VFS file system benchmark, FatFS on a %u KB simulated disk\n",
+         (unsigned)((DISK_BLOCKS * DISK_BLOCK_SIZE) / 1024U));
+  printf("Simulated media: %u us per command, %u us per block\n\n",
+         (unsigned)DISK_CMD_US, (unsigned)DISK_BLOCK_US);
+
+  for (wlp = workloads; wlp->name != NULL; wlp++) {
+    if (run(wlp)) {
+      return 1;
+    }
+  }
+
+  if (check_writeback()) {
+    printf("\nWrite-back failure check: FAILED\n");
+    return 1;
+  }
+  printf("\nWrite-back failure check: OK\n");
+
+  (void) ffdrvUnmount("0:");
+  (void) blkDisconnect(&SBD1);
+  sblkStop(&SBD1);
+
+  return 0;
+}
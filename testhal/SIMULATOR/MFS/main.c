@@ -0,0 +1,304 @@
+/*
+    ChibiOS - Copyright (C) 2006..2018 Giovanni Di Sirio
+
+    Licensed under the Apache License, Version 2.0 (the "License");
+    you may not use this file except in compliance with the License.
+    You may obtain a copy of the License at
+
+        http://www.apache.org/licenses/LICENSE-2.0
+
+    Unless required by applicable law or agreed to in writing, software
+    distributed under the License is distributed on an "AS IS" BASIS,
+    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+    See the License for the specific language governing permissions and
+    limitations under the License.
+*/
+
+/*
+ * MFS write amplification benchmark on a simulated NOR flash.
+ *
+ * Both layouts use the same 32kB of flash, the layout is selected at build
+ * time:
+ *   make                                       two banks of 16kB.
+ *   make UDEFS="-DSIMULATOR -DMFS_CFG_BANKS_NUM=8"
+ *                                              eight banks of 4kB.
+ * Add -DMFS_CFG_GC_POLICY=MFS_GC_GREEDY in order to compare the policies.
+ */
+
+#include <stdio.h>
+#include <string.h>
+
+#include "ch.h"
+#include "hal.h"
+
+#include "hal_mfs.h"
+
+/*===========================================================================*/
+/* Benchmark settings.                                                       */
+/*===========================================================================*/
+
+/* Number of records and size of each record.*/
+#define RECORDS_NUM                 MFS_CFG_MAX_RECORDS
+#define RECORD_SIZE                 200U
+
+/* The first HOT_RECORDS records receive HOT_PERCENT of the updates.*/
+#define HOT_RECORDS                 4U
+#define HOT_PERCENT                 90U
+
+/* Number of operations, one every ERASE_PERIOD is an erase of a cold record
+   and one every TRANSACTION_PERIOD is a transaction.*/
+#define OPERATIONS                  20000U
+#define ERASE_PERIOD                97U
+#define TRANSACTION_PERIOD          31U
+
+/* Flash partition, same total size for both layouts.*/
+#define PARTITION_SIZE              32768U
+
+/*===========================================================================*/
+/* Partition.                                                                */
+/*===========================================================================*/
+
+#if MFS_CFG_BANKS_NUM == 2
+static const MFSConfig mfscfg = {
+  .flashp           = (BaseFlash *)&EFLD1,
+  .erased           = 0xFFFFFFFFU,
+  .bank_size        = PARTITION_SIZE / 2U,
+  .bank0_start      = 0U,
+  .bank0_sectors    = (PARTITION_SIZE / 2U) / SIM_EFL_SECTOR_SIZE,
+  .bank1_start      = (PARTITION_SIZE / 2U) / SIM_EFL_SECTOR_SIZE,
+  .bank1_sectors    = (PARTITION_SIZE / 2U) / SIM_EFL_SECTOR_SIZE
+};
+#else
+static const MFSConfig mfscfg = {
+  .flashp           = (BaseFlash *)&EFLD1,
+  .erased           = 0xFFFFFFFFU,
+  .bank_size        = PARTITION_SIZE / MFS_CFG_BANKS_NUM,
+  .banks_start      = 0U,
+  .bank_sectors     = (PARTITION_SIZE / MFS_CFG_BANKS_NUM) /
+                      SIM_EFL_SECTOR_SIZE
+};
+#endif
+
+static mfs_nocache_buffer_t mfsbuf;
+static MFSDriver mfs;
+
+/*===========================================================================*/
+/* Workload.                                                                 */
+/*===========================================================================*/
+
+/* Expected content of each record, zero if erased.*/
+static uint32_t expected[RECORDS_NUM];
+static uint8_t buffer[RECORD_SIZE];
+
+static uint32_t rnd_state = 0x12345678U;
+
+static uint32_t rnd(void) {
+
+  rnd_state ^= rnd_state << 13;
+  rnd_state ^= rnd_state >> 17;
+  rnd_state ^= rnd_state << 5;
+
+  return rnd_state;
+}
+
+static void fill(uint32_t seq) {
+  unsigned i;
+
+  for (i = 0U; i < RECORD_SIZE; i++) {
+    buffer[i] = (uint8_t)(seq + (i * 7U));
+  }
+  memcpy(buffer, &seq, sizeof seq);
+}
+
+static mfs_id_t pick(void) {
+
+  if ((rnd() % 100U) < HOT_PERCENT) {
+    return (mfs_id_t)(rnd() % HOT_RECORDS) + 1U;
+  }
+
+  return (mfs_id_t)(HOT_RECORDS + (rnd() % (RECORDS_NUM - HOT_RECORDS))) + 1U;
+}
+
+static bool write_record(mfs_id_t id, uint32_t seq, unsigned *gcp) {
+  mfs_error_t err;
+
+  fill(seq);
+  err = mfsWriteRecord(&mfs, id, RECORD_SIZE, buffer);
+  if (MFS_IS_ERROR(err)) {
+    printf("write error %d on record %u\n", (int)err, (unsigned)id);
+    return true;
+  }
+  if (err == MFS_WARN_GC) {
+    (*gcp)++;
+  }
+  if (mfs.state == MFS_READY) {
+    expected[id - 1U] = seq;
+  }
+
+  return false;
+}
+
+static bool check_records(void) {
+  static uint8_t rdbuf[RECORD_SIZE];
+  mfs_id_t id;
+
+  for (id = 1U; id <= RECORDS_NUM; id++) {
+    size_t n = RECORD_SIZE;
+    mfs_error_t err;
+
+    err = mfsReadRecord(&mfs, id, &n, rdbuf);
+    if (expected[id - 1U] == 0U) {
+      if (err != MFS_ERR_NOT_FOUND) {
+        printf("record %u should be erased\n", (unsigned)id);
+        return true;
+      }
+      continue;
+    }
+    if (err != MFS_NO_ERROR) {
+      printf("read error %d on record %u\n", (int)err, (unsigned)id);
+      return true;
+    }
+    fill(expected[id - 1U]);
+    if ((n != RECORD_SIZE) || (memcmp(rdbuf, buffer, RECORD_SIZE) != 0)) {
+      printf("record %u content mismatch\n", (unsigned)id);
+      return true;
+    }
+  }
+
+  return false;
+}
+
+static bool do_bench(void) {
+  uint64_t programmed, user = 0U;
+  uint32_t erased, max_cycles = 0U, seq = 1U;
+  unsigned i, gcs = 0U;
+  mfs_id_t id;
+
+  /* Filling all the records.*/
+  for (id = 1U; id <= RECORDS_NUM; id++) {
+    if (write_record(id, seq++, &gcs)) {
+      return true;
+    }
+  }
+
+  /* Only the steady state is measured.*/
+  programmed = EFLD1.bytes_programmed;
+  erased     = EFLD1.sectors_erased;
+  gcs        = 0U;
+
+  for (i = 1U; i <= OPERATIONS; i++) {
+    if ((i % ERASE_PERIOD) == 0U) {
+      /* Erasing a cold record, it is written again later.*/
+      id = (mfs_id_t)(HOT_RECORDS + (rnd() % (RECORDS_NUM - HOT_RECORDS))) + 1U;
+      if (expected[id - 1U] != 0U) {
+        if (MFS_IS_ERROR(mfsEraseRecord(&mfs, id))) {
+          printf("erase error on record %u\n", (unsigned)id);
+          return true;
+        }
+        expected[id - 1U] = 0U;
+        continue;
+      }
+    }
+    else if ((i % TRANSACTION_PERIOD) == 0U) {
+      /* Updating two hot records atomically.*/
+      uint32_t seq1 = seq++, seq2 = seq++;
+
+      if (MFS_IS_ERROR(mfsStartTransaction(&mfs,
+                                           2U * (RECORD_SIZE + 32U)))) {
+        printf("transaction start error\n");
+        return true;
+      }
+      if (write_record(1U, seq1, &gcs) || write_record(2U, seq2, &gcs) ||
+          MFS_IS_ERROR(mfsCommitTransaction(&mfs))) {
+        printf("transaction error\n");
+        return true;
+      }
+      expected[0] = seq1;
+      expected[1] = seq2;
+      user += 2U * RECORD_SIZE;
+      continue;
+    }
+
+    id = pick();
+    if (write_record(id, seq++, &gcs)) {
+      return true;
+    }
+    user += RECORD_SIZE;
+  }
+
+  programmed = EFLD1.bytes_programmed - programmed;
+  erased     = EFLD1.sectors_erased - erased;
+  for (i = 0U; i < PARTITION_SIZE / SIM_EFL_SECTOR_SIZE; i++) {
+    if (EFLD1.erase_cycles[i] > max_cycles) {
+      max_cycles = EFLD1.erase_cycles[i];
+    }
+  }
+
+  printf("%u operations, %u bytes of records data written\n",
+         OPERATIONS, (unsigned)user);
+  printf("flash programmed  : %u bytes\n", (unsigned)programmed);
+  printf("write amplif.     : %u.%02u\n",
+         (unsigned)(programmed / user),
+         (unsigned)(((programmed % user) * 100U) / user));
+  printf("garbage collects  : %u\n", gcs);
+  printf("sectors erased    : %u, max %u cycles on a sector\n",
+         (unsigned)erased, (unsigned)max_cycles);
+
+  /* A rolled back transaction must not change anything.*/
+  if (MFS_IS_ERROR(mfsStartTransaction(&mfs, RECORD_SIZE + 32U)) ||
+      write_record(3U, 0xDEADU, &gcs) ||
+      MFS_IS_ERROR(mfsRollbackTransaction(&mfs))) {
+    printf("rollback error\n");
+    return true;
+  }
+
+  /* Remounting and checking the content.*/
+  mfsStop(&mfs);
+  if (mfsStart(&mfs, &mfscfg) != MFS_NO_ERROR) {
+    printf("remount error\n");
+    return true;
+  }
+
+  return check_records();
+}
+
+/*
+ * Application entry point.
+ */
+int main(void) {
+
+  /*
+   * System initializations.
+   * - HAL initialization, this also initializes the configured device drivers
+   *   and performs the board-specific initializations.
+   * - Kernel initialization, the main() function becomes a thread and the
+   *   RTOS is active.
+   */
+  halInit();
+  chSysInit();
+
+  eflStart(&EFLD1, NULL);
+  mfsObjectInit(&mfs, &mfsbuf);
+  if (MFS_IS_ERROR(mfsStart(&mfs, &mfscfg))) {
+    printf("mount error\n");
+    return 1;
+  }
+
+#if MFS_CFG_BANKS_NUM == 2
+  printf("MFS benchmark, 2 banks of %u bytes\n", (unsigned)mfscfg.bank_size);
+#else
+  printf("MFS benchmark, %u banks of %u bytes, %s policy\n",
+         (unsigned)MFS_CFG_BANKS_NUM, (unsigned)mfscfg.bank_size,
+         MFS_CFG_GC_POLICY == MFS_GC_GREEDY ? "greedy" : "cost-benefit");
+#endif
+  printf("%u records of %u bytes, %u%% of the updates on %u records\n\n",
+         (unsigned)RECORDS_NUM, RECORD_SIZE, HOT_PERCENT, HOT_RECORDS);
+
+  if (do_bench()) {
+    printf("FAILED\n");
+    return 1;
+  }
+  printf("\nContent verified after remount\n");
+
+  return 0;
+}
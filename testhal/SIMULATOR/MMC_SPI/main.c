@@ -0,0 +1,502 @@
+/*
+    ChibiOS - Copyright (C) 2006..2018 Giovanni Di Sirio
+
+    Licensed under the Apache License, Version 2.0 (the "License");
+    you may not use this file except in compliance with the License.
+    You may obtain a copy of the License at
+
+        http://www.apache.org/licenses/LICENSE-2.0
+
+    Unless required by applicable law or agreed to in writing, software
+    distributed under the License is distributed on an "AS IS" BASIS,
+    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+    See the License for the specific language governing permissions and
+    limitations under the License.
+*/
+
+#include <stdio.h>
+#include <string.h>
+
+#include "ch.h"
+#include "hal.h"
+
+/*===========================================================================*/
+/* Benchmark settings.                                                       */
+/*===========================================================================*/
+
+/*
+ * Simulated bus, the setup time accounts for the per-transfer overhead
+ * (DMA programming and completion interrupt) of a real SPI peripheral.
+ */
+#define SPI_LS_BITRATE              400000U
+#define SPI_HS_BITRATE              25000000U
+#define SPI_SETUP_NS                2000U
+
+/*
+ * Simulated card, Nac is the number of idle bytes before a data token,
+ * the busy time is the number of busy bytes after a block write.
+ */
+#define CARD_C_SIZE                 3U
+#define CARD_BLOCKS                 (1024U * (CARD_C_SIZE + 1U))
+#define CARD_NAC                    1U
+#define CARD_WRITE_BUSY             4U
+
+#define BENCH_BLOCKS                1024U
+
+/*===========================================================================*/
+/* SD card in SPI mode model.                                                */
+/*===========================================================================*/
+
+typedef enum {
+  CARD_IDLE = 0,
+  CARD_READING,
+  CARD_WRITING,
+  CARD_RECEIVING
+} card_state_t;
+
+static struct {
+  bool          selected;
+  bool          idle;
+  bool          crc_on;
+  bool          multi;
+  bool          corrupt;
+  card_state_t  state;
+  uint32_t      blk;
+  uint8_t       cmd[6];
+  unsigned      cmdn;
+  uint8_t       out[MMCSD_BLOCK_SIZE + 16U];
+  unsigned      outr;
+  unsigned      outn;
+  uint8_t       in[MMCSD_BLOCK_SIZE + 2U];
+  unsigned      inn;
+  unsigned      busy;
+  uint32_t      crc_errors;
+  uint8_t       storage[CARD_BLOCKS][MMCSD_BLOCK_SIZE];
+} card;
+
+/* CSD version 2.0, only the structure and C_SIZE fields are relevant.*/
+static const uint8_t card_csd[16] = {
+  0x40, 0x0E, 0x00, 0x32, 0x5B, 0x59, 0x00, 0x00,
+  0x00, CARD_C_SIZE, 0x7F, 0x80, 0x0A, 0x40, 0x00, 0x01
+};
+
+static const uint8_t card_cid[16] = {
+  0x00, 'C', 'H', 'S', 'I', 'M', 'S', 'D',
+  0x10, 0x00, 0x00, 0x00, 0x01, 0x01, 0x4A, 0x01
+};
+
+static uint8_t card_crc7(const uint8_t *p, size_t n) {
+  uint8_t crc = 0U;
+  unsigned i;
+
+  while (n-- > 0U) {
+    uint8_t b = *p++;
+    for (i = 0U; i < 8U; i++) {
+      uint8_t bit = ((b >> 7) ^ (crc >> 6)) & 1U;
+      crc = (uint8_t)((crc << 1) & 0x7FU);
+      if (bit != 0U) {
+        crc ^= 0x09U;
+      }
+      b <<= 1;
+    }
+  }
+  return crc;
+}
+
+static uint16_t card_crc16(const uint8_t *p, size_t n) {
+  uint16_t crc = 0U;
+  unsigned i;
+
+  while (n-- > 0U) {
+    crc ^= (uint16_t)((uint16_t)*p++ << 8);
+    for (i = 0U; i < 8U; i++) {
+      crc = (crc & 0x8000U) != 0U ? (uint16_t)((crc << 1) ^ 0x1021U) :
+                                    (uint16_t)(crc << 1);
+    }
+  }
+  return crc;
+}
+
+static void card_put(uint8_t b) {
+
+  card.out[card.outn++] = b;
+}
+
+static void card_put_data(const uint8_t *p, size_t n) {
+  uint16_t crc = card_crc16(p, n);
+  unsigned i;
+
+  for (i = 0U; i < CARD_NAC; i++) {
+    card_put(0xFFU);
+  }
+  card_put(0xFEU);
+  memcpy(&card.out[card.outn], p, n);
+  if (card.corrupt) {
+    card.out[card.outn + (n / 2U)] ^= 0x10U;
+    card.corrupt = false;
+  }
+  card.outn += (unsigned)n;
+  card_put((uint8_t)(crc >> 8));
+  card_put((uint8_t)crc);
+}
+
+static void card_put_r1(uint8_t r1) {
+
+  /* One byte of Ncr then the answer.*/
+  card.outr = 0U;
+  card.outn = 0U;
+  card_put(0xFFU);
+  card_put(r1 | (card.idle ? 0x01U : 0x00U));
+}
+
+static void card_command(void) {
+  uint8_t cmd = card.cmd[0] & 0x3FU;
+  uint32_t arg = ((uint32_t)card.cmd[1] << 24) | ((uint32_t)card.cmd[2] << 16) |
+                 ((uint32_t)card.cmd[3] << 8)  | (uint32_t)card.cmd[4];
+
+  if ((card.crc_on || (cmd == MMCSD_CMD_GO_IDLE_STATE) ||
+       (cmd == MMCSD_CMD_SEND_IF_COND)) &&
+      (card.cmd[5] != (uint8_t)((card_crc7(card.cmd, 5U) << 1) | 1U))) {
+    card.crc_errors++;
+    card_put_r1(0x08U);
+    return;
+  }
+
+  switch (cmd) {
+  case MMCSD_CMD_GO_IDLE_STATE:
+    card.idle   = true;
+    card.crc_on = false;
+    card.state  = CARD_IDLE;
+    card_put_r1(0x00U);
+    break;
+  case MMCSD_CMD_SEND_IF_COND:
+    card_put_r1(0x00U);
+    card_put(0x00U);
+    card_put(0x00U);
+    card_put((uint8_t)(arg >> 8));
+    card_put((uint8_t)arg);
+    break;
+  case MMCSD_CMD_APP_CMD:
+  case MMCSD_CMD_SET_BLOCKLEN:
+    card_put_r1(((cmd == MMCSD_CMD_SET_BLOCKLEN) &&
+                 (arg != MMCSD_BLOCK_SIZE)) ? 0x40U : 0x00U);
+    break;
+  case MMCSD_CMD_APP_OP_COND:
+  case MMCSD_CMD_INIT:
+    card.idle = false;
+    card_put_r1(0x00U);
+    break;
+  case MMCSD_CMD_READ_OCR:
+    card_put_r1(0x00U);
+    card_put(0xC0U);
+    card_put(0xFFU);
+    card_put(0x80U);
+    card_put(0x00U);
+    break;
+  case MMCSD_CMD_CRC_ON_OFF:
+    card.crc_on = (arg & 1U) != 0U;
+    card_put_r1(0x00U);
+    break;
+  case MMCSD_CMD_SEND_CSD:
+  case MMCSD_CMD_SEND_CID:
+    card_put_r1(0x00U);
+    card_put_data(cmd == MMCSD_CMD_SEND_CSD ? card_csd : card_cid, 16U);
+    break;
+  case MMCSD_CMD_STOP_TRANSMISSION:
+    card.state = CARD_IDLE;
+    card_put_r1(0x00U);
+    break;
+  case MMCSD_CMD_READ_SINGLE_BLOCK:
+  case MMCSD_CMD_READ_MULTIPLE_BLOCK:
+    if (arg >= CARD_BLOCKS) {
+      card_put_r1(0x40U);
+      break;
+    }
+    card_put_r1(0x00U);
+    card.blk = arg;
+    if (cmd == MMCSD_CMD_READ_SINGLE_BLOCK) {
+      card_put_data(card.storage[card.blk], MMCSD_BLOCK_SIZE);
+    }
+    else {
+      card.state = CARD_READING;
+    }
+    break;
+  case MMCSD_CMD_WRITE_BLOCK:
+  case MMCSD_CMD_WRITE_MULTIPLE_BLOCK:
+    if (arg >= CARD_BLOCKS) {
+      card_put_r1(0x40U);
+      break;
+    }
+    card_put_r1(0x00U);
+    card.blk   = arg;
+    card.multi = cmd == MMCSD_CMD_WRITE_MULTIPLE_BLOCK;
+    card.state = CARD_WRITING;
+    break;
+  default:
+    card_put_r1(0x04U);
+    break;
+  }
+}
+
+static void card_data_received(void) {
+  uint16_t crc = (uint16_t)(((uint16_t)card.in[MMCSD_BLOCK_SIZE] << 8) |
+                            (uint16_t)card.in[MMCSD_BLOCK_SIZE + 1U]);
+
+  card.state = card.multi ? CARD_WRITING : CARD_IDLE;
+  if (card.crc_on && (card_crc16(card.in, MMCSD_BLOCK_SIZE) != crc)) {
+    card.crc_errors++;
+    card_put(0xEBU);
+    return;
+  }
+  if (card.blk >= CARD_BLOCKS) {
+    card_put(0xEDU);
+    return;
+  }
+  memcpy(card.storage[card.blk++], card.in, MMCSD_BLOCK_SIZE);
+  card_put(0xE5U);
+  card.busy = CARD_WRITE_BUSY;
+}
+
+static void card_select(void *arg, bool selected) {
+
+  (void)arg;
+
+  card.selected = selected;
+  card.cmdn     = 0U;
+  card.outr     = 0U;
+  card.outn     = 0U;
+}
+
+static uint8_t card_exchange(void *arg, uint8_t mosi) {
+  uint8_t miso;
+
+  (void)arg;
+
+  if (!card.selected) {
+    return 0xFFU;
+  }
+
+  /* Output side.*/
+  if (card.outr < card.outn) {
+    miso = card.out[card.outr++];
+    if (card.outr >= card.outn) {
+      card.outr = 0U;
+      card.outn = 0U;
+    }
+  }
+  else if (card.busy > 0U) {
+    card.busy--;
+    miso = 0x00U;
+  }
+  else {
+    miso = 0xFFU;
+  }
+
+  /* Input side.*/
+  if (card.state == CARD_RECEIVING) {
+    card.in[card.inn++] = mosi;
+    if (card.inn >= sizeof card.in) {
+      card_data_received();
+    }
+  }
+  else if ((card.cmdn > 0U) || ((mosi & 0xC0U) == 0x40U)) {
+    card.cmd[card.cmdn++] = mosi;
+    if (card.cmdn >= sizeof card.cmd) {
+      card.cmdn = 0U;
+      card_command();
+    }
+  }
+  else if ((card.state == CARD_WRITING) && (card.busy == 0U) &&
+           (card.outn == 0U)) {
+    if (mosi == (card.multi ? 0xFCU : 0xFEU)) {
+      card.state = CARD_RECEIVING;
+      card.inn   = 0U;
+    }
+    else if (card.multi && (mosi == 0xFDU)) {
+      card.state = CARD_IDLE;
+      card.busy  = CARD_WRITE_BUSY;
+    }
+  }
+
+  /* Multiple blocks streaming.*/
+  if ((card.state == CARD_READING) && (card.outn == 0U)) {
+    if (card.blk < CARD_BLOCKS) {
+      card_put_data(card.storage[card.blk++], MMCSD_BLOCK_SIZE);
+    }
+  }
+
+  return miso;
+}
+
+static const SimSPIDevice card_device = {
+  card_select,
+  card_exchange,
+  NULL
+};
+
+/*===========================================================================*/
+/* MMC driver.                                                               */
+/*===========================================================================*/
+
+/* Low speed SPI configuration (400kHz).*/
+static const SPIConfig ls_spicfg = {
+  NULL,
+  &card_device,
+  SPI_LS_BITRATE,
+  SPI_SETUP_NS
+};
+
+/* High speed SPI configuration (25MHz).*/
+static const SPIConfig hs_spicfg = {
+  NULL,
+  &card_device,
+  SPI_HS_BITRATE,
+  SPI_SETUP_NS
+};
+
+/* MMC/SD over SPI driver configuration.*/
+static const MMCConfig mmccfg = {
+  &SPID1,
+  &ls_spicfg,
+  &hs_spicfg
+};
+
+static MMCDriver MMCD1;
+static uint8_t mmc_buffer[16];
+
+bool mmc_lld_is_card_inserted(MMCDriver *mmcp) {
+
+  (void)mmcp;
+  return true;
+}
+
+bool mmc_lld_is_write_protected(MMCDriver *mmcp) {
+
+  (void)mmcp;
+  return false;
+}
+
+/*===========================================================================*/
+/* Benchmark.                                                                */
+/*===========================================================================*/
+
+static uint8_t io_buf[64U * MMCSD_BLOCK_SIZE];
+
+/* Simulator time, it follows the virtual time when enabled.*/
+static uint64_t now_us(void) {
+
+  return _sim_get_time() / 1000U;
+}
+
+static void fill(uint8_t *p, uint32_t blk, uint32_t n) {
+  uint32_t i;
+
+  for (i = 0U; i < n * MMCSD_BLOCK_SIZE; i++) {
+    p[i] = (uint8_t)((blk + (i / MMCSD_BLOCK_SIZE)) * 7U + i);
+  }
+}
+
+static bool run(bool write, uint32_t n) {
+  uint64_t start, elapsed;
+  uint32_t transfers, blk;
+
+  SPID1.transfers = 0U;
+  start = now_us();
+  for (blk = 0U; blk < BENCH_BLOCKS; blk += n) {
+    if (write) {
+      fill(io_buf, blk, n);
+      if (blkWrite(&MMCD1, blk, io_buf, n) != HAL_SUCCESS) {
+        printf("write at %u failed\n", (unsigned)blk);
+        return true;
+      }
+    }
+    else {
+      if (blkRead(&MMCD1, blk, io_buf, n) != HAL_SUCCESS) {
+        printf("read at %u failed\n", (unsigned)blk);
+        return true;
+      }
+    }
+  }
+  elapsed = now_us() - start;
+  transfers = SPID1.transfers;
+
+  /* Content check.*/
+  for (blk = 0U; blk < BENCH_BLOCKS; blk += n) {
+    fill(io_buf, blk, n);
+    if (memcmp(io_buf, card.storage[blk],
+               (size_t)n * MMCSD_BLOCK_SIZE) != 0) {
+      printf("data mismatch at %u\n", (unsigned)blk);
+      return true;
+    }
+  }
+
+  printf("%-5s %2u blocks: %7u us %6u KB/s %5u.%02u transfers/block\n",
+         write ? "write" : "read", (unsigned)n, (unsigned)elapsed,
+         (unsigned)(((uint64_t)BENCH_BLOCKS * MMCSD_BLOCK_SIZE * 1000000U) /
+                    ((elapsed + 1U) * 1024U)),
+         (unsigned)(transfers / BENCH_BLOCKS),
+         (unsigned)(((transfers % BENCH_BLOCKS) * 100U) / BENCH_BLOCKS));
+  return false;
+}
+
+/*
+ * Application entry point.
+ */
+int main(void) {
+  static const uint32_t sizes[] = {1U, 8U, 64U};
+  unsigned i;
+
+  /*
+   * System initializations.
+   * - HAL initialization, this also initializes the configured device drivers
+   *   and performs the board-specific initializations.
+   * - Kernel initialization, the main() function becomes a thread and the
+   *   RTOS is active.
+   */
+  halInit();
+  chSysInit();
+
+  printf("MMC over SPI benchmark, %u KB simulated card\n",
+         (unsigned)((CARD_BLOCKS * MMCSD_BLOCK_SIZE) / 1024U));
+  printf("Bus %u kHz, %u ns per transfer, data CRC %s, pipelining %s\n\n",
+         (unsigned)(SPI_HS_BITRATE / 1000U), (unsigned)SPI_SETUP_NS,
+         MMC_USE_DATA_CRC == TRUE ? "on" : "off",
+         MMC_USE_PIPELINING == TRUE ? "on" : "off");
+
+  mmcObjectInit(&MMCD1, mmc_buffer);
+  (void) mmcStart(&MMCD1, &mmccfg);
+  if (blkConnect(&MMCD1) != HAL_SUCCESS) {
+    printf("Card connection failed\n");
+    return 1;
+  }
+  if (mmcsdGetCardCapacity(&MMCD1) != CARD_BLOCKS) {
+    printf("Wrong card capacity\n");
+    return 1;
+  }
+
+  for (i = 0U; i < sizeof sizes / sizeof sizes[0]; i++) {
+    if (run(true, sizes[i]) || run(false, sizes[i])) {
+      return 1;
+    }
+  }
+
+#if MMC_USE_DATA_CRC == TRUE
+  /* A corrupted block must be detected.*/
+  card.corrupt = true;
+  if (blkRead(&MMCD1, 0U, io_buf, 8U) == HAL_SUCCESS) {
+    printf("\nCorrupted block not detected\n");
+    return 1;
+  }
+  if (blkRead(&MMCD1, 0U, io_buf, 8U) != HAL_SUCCESS) {
+    printf("\nRecovery after CRC error failed\n");
+    return 1;
+  }
+  printf("\nCRC error detection: OK, card CRC errors: %u\n",
+         (unsigned)card.crc_errors);
+#endif
+
+  (void) blkDisconnect(&MMCD1);
+  mmcStop(&MMCD1);
+
+  return 0;
+}
@@ -0,0 +1,256 @@
+/*
+    ChibiOS - Copyright (C) 2006..2018 Giovanni Di Sirio
+
+    Licensed under the Apache License, Version 2.0 (the "License");
+    you may not use this file except in compliance with the License.
+    You may obtain a copy of the License at
+
+        http://www.apache.org/licenses/LICENSE-2.0
+
+    Unless required by applicable law or agreed to in writing, software
+    distributed under the License is distributed on an "AS IS" BASIS,
+    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+    See the License for the specific language governing permissions and
+    limitations under the License.
+*/
+
+/*
+ * Methods call overhead, VMT dispatch against statically bound calls.
+ *
+ * The same methods of final classes are called through the virtual methods
+ * wrappers, using the VMT, and through the statically bound wrappers, the
+ * concrete type is known at compile time. Building with USE_LTO=yes allows
+ * the statically bound calls to be inlined across modules.
+ */
+
+#include <stdio.h>
+
+#include "ch.h"
+#include "hal.h"
+#include "vfs.h"
+
+/*===========================================================================*/
+/* Benchmark settings.                                                       */
+/*===========================================================================*/
+
+/* Calls performed by each run.*/
+#define CALLS                       10000000U
+
+/*===========================================================================*/
+/* Source stream.                                                            */
+/*===========================================================================*/
+
+/* Stream returning a counter, only byte-wise reads are performed.*/
+typedef struct {
+  sequential_stream_i       stm;
+  uint8_t                   cnt;
+} source_stream_c;
+
+static size_t source_write(void *ip, const uint8_t *bp, size_t n) {
+
+  (void)ip;
+  (void)bp;
+  (void)n;
+
+  return 0U;
+}
+
+static size_t source_read(void *ip, uint8_t *bp, size_t n) {
+  source_stream_c *self = oopIfGetOwner(source_stream_c, ip);
+  size_t i;
+
+  for (i = 0U; i < n; i++) {
+    bp[i] = self->cnt++;
+  }
+
+  return n;
+}
+
+static int source_put(void *ip, uint8_t b) {
+
+  (void)ip;
+  (void)b;
+
+  return STM_RESET;
+}
+
+static int source_get(void *ip) {
+  source_stream_c *self = oopIfGetOwner(source_stream_c, ip);
+
+  return (int)self->cnt++;
+}
+
+static int source_unget(void *ip, int b) {
+
+  (void)ip;
+  (void)b;
+
+  return STM_RESET;
+}
+
+static const struct sequential_stream_vmt source_vmt = {
+  .instance_offset      = offsetof(source_stream_c, stm),
+  .write                = source_write,
+  .read                 = source_read,
+  .put                  = source_put,
+  .get                  = source_get,
+  .unget                = source_unget
+};
+
+static source_stream_c source;
+
+/*===========================================================================*/
+/* VFS related.                                                              */
+/*===========================================================================*/
+
+/* VFS streams driver used as root.*/
+static vfs_streams_driver_c root_driver;
+
+/* VFS API will use this object as implicit root, defining this
+   symbol is expected.*/
+vfs_driver_c *vfs_root = (vfs_driver_c *)&root_driver;
+
+static const drv_streams_element_t streams[] = {
+  {"source", (sequential_stream_i *)&source},
+  {NULL, NULL}
+};
+
+/* File node opened on the source stream, the driver is known so the node
+   is known to be a vfs_streams_file_node_c.*/
+static vfs_file_node_c *fnp;
+
+/*===========================================================================*/
+/* Benchmarks.                                                               */
+/*===========================================================================*/
+
+static void spi_cb(void *ip) {
+
+  (void)ip;
+}
+
+static const hal_spi_config_t spicfg = {0};
+
+static bool vfs_read_vmt(uint32_t i) {
+  uint8_t b;
+
+  return (vfsFileRead(fnp, &b, 1U) != 1) || (b != (uint8_t)i);
+}
+
+static bool vfs_read_final(uint32_t i) {
+  uint8_t b;
+
+  return (stmfileRead((vfs_streams_file_node_c *)fnp, &b, 1U) != 1) ||
+         (b != (uint8_t)i);
+}
+
+static bool spi_setcb_vmt(uint32_t i) {
+
+  (void)i;
+
+  drvSetCallbackX(&SPID1, spi_cb);
+
+  return false;
+}
+
+static bool spi_setcb_final(uint32_t i) {
+
+  (void)i;
+
+  spiSetcb(&SPID1, spi_cb);
+
+  return false;
+}
+
+static bool spi_doconf_vmt(uint32_t i) {
+
+  (void)i;
+
+  return __drv_do_configure(&SPID1, &spicfg) == NULL;
+}
+
+static bool spi_doconf_final(uint32_t i) {
+
+  (void)i;
+
+  return __spi_doconf(&SPID1, &spicfg) == NULL;
+}
+
+typedef struct {
+  const char    *name;
+  bool          (*vmt)(uint32_t i);
+  bool          (*final)(uint32_t i);
+} method_t;
+
+static const method_t methods[] = {
+  {"vfsFileRead, 1 byte", vfs_read_vmt,   vfs_read_final},
+  {"drvSetCallbackX",     spi_setcb_vmt,  spi_setcb_final},
+  {"__drv_do_configure",  spi_doconf_vmt, spi_doconf_final},
+  {NULL, NULL, NULL}
+};
+
+/* Runs are interleaved, the source counter is reset before each one.*/
+static bool run(bool (*fn)(uint32_t i), double *nsp) {
+  rtcnt_t start;
+  uint32_t i;
+
+  source.cnt = 0U;
+  start = chSysGetRealtimeCounterX();
+  for (i = 0U; i < CALLS; i++) {
+    if (fn(i)) {
+      return true;
+    }
+  }
+  *nsp = (double)(chSysGetRealtimeCounterX() - start) / (double)CALLS;
+
+  return false;
+}
+
+/*
+ * Application entry point.
+ */
+int main(void) {
+  const method_t *mp;
+
+  /*
+   * System initializations.
+   * - HAL initialization, this also initializes the configured device drivers
+   *   and performs the board-specific initializations.
+   * - Kernel initialization, the main() function becomes a thread and the
+   *   RTOS is active.
+   * - Virtual File System initialization.
+   */
+  halInit();
+  chSysInit();
+  vfsInit();
+
+  oopIfObjectInit(&source.stm, &source_vmt);
+  stmdrvObjectInit(&root_driver, &streams[0]);
+
+  if (drvStart(&SPID1) != HAL_RET_SUCCESS) {
+    printf("SPI start failed\n");
+    return 1;
+  }
+
+  if (CH_RET_IS_ERROR(vfsOpenFile("/source", VO_RDONLY, &fnp))) {
+    printf("Open failed\n");
+    return 1;
+  }
+
+  printf("Methods call overhead, %u calls per run\n", (unsigned)CALLS);
+  printf("Costs in realtime counter ticks per call\n\n");
+  printf("%-20s %10s %10s\n", "", "VMT", "final");
+
+  for (mp = methods; mp->name != NULL; mp++) {
+    double vmt, final;
+
+    if (run(mp->vmt, &vmt) || run(mp->final, &final)) {
+      printf("%s: FAILED\n", mp->name);
+      return 1;
+    }
+    printf("%-20s %10.2f %10.2f\n", mp->name, vmt, final);
+  }
+
+  vfsClose((vfs_node_c *)fnp);
+
+  return 0;
+}
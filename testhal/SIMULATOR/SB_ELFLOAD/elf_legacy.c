@@ -0,0 +1,25 @@
+/*
+    ChibiOS - Copyright (C) 2006..2018 Giovanni Di Sirio
+
+    Licensed under the Apache License, Version 2.0 (the "License");
+    you may not use this file except in compliance with the License.
+    You may obtain a copy of the License at
+
+        http://www.apache.org/licenses/LICENSE-2.0
+
+    Unless required by applicable law or agreed to in writing, software
+    distributed under the License is distributed on an "AS IS" BASIS,
+    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+    See the License for the specific language governing permissions and
+    limitations under the License.
+*/
+
+/*
+ * Second instance of the sandbox ELF loader built in legacy mode, it is
+ * used as reference by the benchmark.
+ */
+#define SB_CFG_ELF_FAST_LOAD        FALSE
+#define sbElfLoad                   sbElfLoadLegacy
+#define sbElfLoadFile               sbElfLoadFileLegacy
+
+#include "sbelf.c"
@@ -0,0 +1,621 @@
+/*
+    ChibiOS - Copyright (C) 2006..2018 Giovanni Di Sirio
+
+    Licensed under the Apache License, Version 2.0 (the "License");
+    you may not use this file except in compliance with the License.
+    You may obtain a copy of the License at
+
+        http://www.apache.org/licenses/LICENSE-2.0
+
+    Unless required by applicable law or agreed to in writing, software
+    distributed under the License is distributed on an "AS IS" BASIS,
+    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+    See the License for the specific language governing permissions and
+    limitations under the License.
+*/
+
+#include <stdio.h>
+#include <string.h>
+#if defined(ELF_CORPUS_DIR)
+#include <dirent.h>
+#endif
+
+#include "ch.h"
+#include "hal.h"
+#include "vfs.h"
+#include "ff.h"
+#include "simblk.h"
+#include "sbelf.h"
+
+/*===========================================================================*/
+/* Benchmark settings.                                                       */
+/*===========================================================================*/
+
+/*
+ * Simulated disk, same media model of the FSBENCH demo.
+ */
+#define DISK_BLOCK_SIZE             512U
+#define DISK_BLOCKS                 65536U
+#define DISK_CMD_US                 50U
+#define DISK_BLOCK_US               5U
+
+/* Number of loads of each file in each mode.*/
+#if !defined(BENCH_LOADS)
+#define BENCH_LOADS                 16U
+#endif
+
+/* Size of the memory area receiving the executables.*/
+#define ARENA_SIZE                  (512U * 1024U)
+
+/* Maximum size of a corpus file.*/
+#define FILE_SIZE_MAX               (512U * 1024U)
+
+/* Maximum number of corpus files.*/
+#define CORPUS_MAX                  16U
+
+/*===========================================================================*/
+/* Loaders.                                                                  */
+/*===========================================================================*/
+
+/*
+ * Second instance of the loader built in legacy mode, see elf_legacy.c.
+ */
+msg_t sbElfLoadFileLegacy(vfs_driver_c *drvp,
+                          const char *path,
+                          const memory_area_t *map);
+
+typedef struct {
+  const char    *name;
+  msg_t         (*load)(vfs_driver_c *drvp,
+                        const char *path,
+                        const memory_area_t *map);
+} loader_t;
+
+static const loader_t loaders[] = {
+  {"legacy", sbElfLoadFileLegacy},
+  {"fast", sbElfLoadFile}
+};
+
+/*===========================================================================*/
+/* Disk and file system.                                                     */
+/*===========================================================================*/
+
+static const SimBlockConfig disk_config = {
+  NULL,
+  DISK_BLOCK_SIZE,
+  DISK_BLOCKS,
+  DISK_CMD_US,
+  DISK_BLOCK_US,
+  false
+};
+
+/* Block device accessed by the FatFS bindings.*/
+SimBlockDevice SBD1;
+
+/* VFS FatFS driver object representing the root directory.*/
+static vfs_fatfs_driver_c root_driver;
+
+/* VFS API will use this object as implicit root, defining this
+   symbol is expected.*/
+vfs_driver_c *vfs_root = (vfs_driver_c *)&root_driver;
+
+static uint8_t mkfs_buf[4096];
+
+/*===========================================================================*/
+/* Corpus generator.                                                         */
+/*===========================================================================*/
+
+/*
+ * Synthetic executables mimic the layout produced by the sandbox linker
+ * scripts with relocations emitted: allocated sections data first, then
+ * relocation tables, non-allocated sections and the section headers
+ * table at the end of the file. Headers of relocation tables follow the
+ * headers of the relocated sections.
+ */
+#define ET_EXEC                     2U
+#define EM_ARM                      40U
+
+#define SHT_PROGBITS                1U
+#define SHT_SYMTAB                  2U
+#define SHT_STRTAB                  3U
+#define SHT_NOBITS                  8U
+#define SHT_REL                     9U
+
+#define SHF_WRITE                   (1U << 0)
+#define SHF_ALLOC                   (1U << 1)
+#define SHF_EXECINSTR               (1U << 2)
+#define SHF_INFO_LINK               (1U << 6)
+
+#define R_ARM_ABS32                 2U
+#define R_ARM_THM_PC22              10U
+#define R_ARM_THM_MOVW_ABS_NC       47U
+#define R_ARM_THM_MOVT_ABS          48U
+
+#define ELF32_R_INFO(s, t)          (((uint32_t)(s) << 8) | (uint32_t)(t))
+
+#define NUM_SYMBOLS                 16U
+
+typedef struct {
+  unsigned char e_ident[16];
+  uint16_t      e_type;
+  uint16_t      e_machine;
+  uint32_t      e_version;
+  uint32_t      e_entry;
+  uint32_t      e_phoff;
+  uint32_t      e_shoff;
+  uint32_t      e_flags;
+  uint16_t      e_ehsize;
+  uint16_t      e_phentsize;
+  uint16_t      e_phnum;
+  uint16_t      e_shentsize;
+  uint16_t      e_shnum;
+  uint16_t      e_shstrndx;
+} gen_header_t;
+
+typedef struct {
+  uint32_t      sh_name;
+  uint32_t      sh_type;
+  uint32_t      sh_flags;
+  uint32_t      sh_addr;
+  uint32_t      sh_offset;
+  uint32_t      sh_size;
+  uint32_t      sh_link;
+  uint32_t      sh_info;
+  uint32_t      sh_addralign;
+  uint32_t      sh_entsize;
+} gen_section_t;
+
+typedef struct {
+  uint32_t      r_offset;
+  uint32_t      r_info;
+} gen_rel_t;
+
+typedef struct {
+  const char    *name;
+  uint32_t      text;
+  uint32_t      rodata;
+  uint32_t      data;
+  uint32_t      bss;
+  uint32_t      text_rels;
+  uint32_t      debug_sections;
+} gen_profile_t;
+
+static const gen_profile_t profiles[] = {
+  {"small",   4096U,   1024U,  256U,  1024U,  96U,   0U},
+  {"medium",  32768U,  8192U,  2048U, 4096U,  1024U, 4U},
+  {"large",   196608U, 32768U, 8192U, 16384U, 8192U, 8U},
+  {"debug",   65536U,  8192U,  2048U, 4096U,  2048U, 24U},
+  {NULL,      0U,      0U,     0U,    0U,     0U,    0U}
+};
+
+typedef struct {
+  char          path[32];
+  const char    *name;
+  uint32_t      size;
+} corpus_file_t;
+
+static corpus_file_t corpus[CORPUS_MAX];
+static unsigned corpus_num;
+
+static uint8_t file_buf[FILE_SIZE_MAX];
+static gen_section_t sections[64];
+static char shstrtab[1024];
+static uint32_t seed;
+
+static uint32_t rnd(void) {
+
+  seed = (seed * 1103515245U) + 12345U;
+  return seed >> 8;
+}
+
+static uint32_t align4(uint32_t v) {
+
+  return (v + 3U) & ~3U;
+}
+
+static uint32_t add_name(uint32_t *lenp, const char *name) {
+  uint32_t idx = *lenp;
+
+  strcpy(&shstrtab[idx], name);
+  *lenp += (uint32_t)strlen(name) + 1U;
+  return idx;
+}
+
+static unsigned add_section(unsigned *np, uint32_t *lenp, const char *name,
+                            uint32_t type, uint32_t flags,
+                            uint32_t addr, uint32_t offset, uint32_t size) {
+  gen_section_t *shp = &sections[*np];
+
+  memset(shp, 0, sizeof *shp);
+  shp->sh_name      = add_name(lenp, name);
+  shp->sh_type      = type;
+  shp->sh_flags     = flags;
+  shp->sh_addr      = addr;
+  shp->sh_offset    = offset;
+  shp->sh_size      = size;
+  shp->sh_addralign = 4U;
+  return (*np)++;
+}
+
+static void fill_random(uint32_t offset, uint32_t size) {
+  uint32_t i;
+
+  for (i = 0U; i < size; i++) {
+    file_buf[offset + i] = (uint8_t)rnd();
+  }
+}
+
+static void put32(uint32_t offset, uint32_t v) {
+
+  memcpy(&file_buf[offset], &v, sizeof v);
+}
+
+static void put16(uint32_t offset, uint16_t v) {
+
+  memcpy(&file_buf[offset], &v, sizeof v);
+}
+
+/*
+ * Relocations are spread over the section, each slot is either an
+ * absolute word or a "movw"/"movt" pair referring to the same symbol.
+ */
+static uint32_t gen_text_rels(uint32_t text_off, uint32_t text_size,
+                              uint32_t rel_off, uint32_t nrels,
+                              uint32_t image_size) {
+  gen_rel_t rel;
+  uint32_t stride, slot, n;
+
+  stride = (text_size / nrels) & ~7U;
+  if (stride < 8U) {
+    stride = 8U;
+  }
+
+  n = 0U;
+  for (slot = 0U; (n < nrels) && (slot + 8U <= text_size); slot += stride) {
+    uint32_t sym = 1U + (rnd() % (NUM_SYMBOLS - 1U));
+
+    if (((rnd() & 1U) == 0U) || (n + 2U > nrels)) {
+      put32(text_off + slot, rnd() % image_size);
+      rel.r_offset = slot;
+      rel.r_info   = ELF32_R_INFO(sym, R_ARM_ABS32);
+      memcpy(&file_buf[rel_off + (n++ * sizeof rel)], &rel, sizeof rel);
+    }
+    else {
+      put16(text_off + slot + 0U, (uint16_t)(0xF240U | (rnd() & 0x040FU)));
+      put16(text_off + slot + 2U, (uint16_t)(rnd() & 0x7FFFU));
+      put16(text_off + slot + 4U, (uint16_t)(0xF2C0U | (rnd() & 0x040FU)));
+      put16(text_off + slot + 6U, (uint16_t)(rnd() & 0x7FFFU));
+      rel.r_offset = slot;
+      rel.r_info   = ELF32_R_INFO(sym, R_ARM_THM_MOVW_ABS_NC);
+      memcpy(&file_buf[rel_off + (n++ * sizeof rel)], &rel, sizeof rel);
+      rel.r_offset = slot + 4U;
+      rel.r_info   = ELF32_R_INFO(sym, R_ARM_THM_MOVT_ABS);
+      memcpy(&file_buf[rel_off + (n++ * sizeof rel)], &rel, sizeof rel);
+    }
+
+    /* Branches are ignored by the loader but still parsed.*/
+    if (n < nrels) {
+      rel.r_offset = slot + (stride > 8U ? 8U : 0U);
+      rel.r_info   = ELF32_R_INFO(sym, R_ARM_THM_PC22);
+      memcpy(&file_buf[rel_off + (n++ * sizeof rel)], &rel, sizeof rel);
+    }
+  }
+
+  return n * (uint32_t)sizeof rel;
+}
+
+static uint32_t gen_elf(const gen_profile_t *pp) {
+  static const uint8_t ident[16] = {
+    0x7f, 0x45, 0x4c, 0x46, 0x01, 0x01, 0x01, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00
+  };
+  gen_header_t h;
+  uint32_t text_addr, rodata_addr, data_addr, bss_addr, image_size;
+  uint32_t base_off, off, rel_text_size, rel_data_size, ndata, i;
+  uint32_t text_rel_off, data_rel_off, shstr_len;
+  unsigned n, text_sec, data_sec;
+
+  shstr_len = 0U;
+  (void) add_name(&shstr_len, "");
+
+  /* Memory layout, sections are aligned to 8 so small gaps are present.*/
+  text_addr   = 0U;
+  rodata_addr = (text_addr + pp->text + 7U) & ~7U;
+  data_addr   = (rodata_addr + pp->rodata + 7U) & ~7U;
+  bss_addr    = (data_addr + pp->data + 7U) & ~7U;
+  image_size  = bss_addr + pp->bss;
+
+  /* File layout of the allocated sections mirrors the memory layout.*/
+  base_off = 0x100U;
+  memset(file_buf, 0, base_off);
+  fill_random(base_off + text_addr, pp->text);
+  fill_random(base_off + rodata_addr, pp->rodata);
+  fill_random(base_off + data_addr, pp->data);
+  off = base_off + data_addr + pp->data;
+
+  /* Relocation tables.*/
+  text_rel_off  = off;
+  rel_text_size = gen_text_rels(base_off + text_addr, pp->text,
+                                text_rel_off, pp->text_rels, image_size);
+  off += rel_text_size;
+
+  /* Pointers table at the start of the data section.*/
+  data_rel_off = off;
+  ndata = pp->data / 16U;
+  for (i = 0U; i < ndata; i++) {
+    gen_rel_t rel = {i * 4U + data_addr, ELF32_R_INFO(1U, R_ARM_ABS32)};
+
+    put32(base_off + data_addr + (i * 4U), rnd() % image_size);
+    memcpy(&file_buf[off], &rel, sizeof rel);
+    off += (uint32_t)sizeof rel;
+  }
+  rel_data_size = off - data_rel_off;
+
+  /* Sections, the order follows the sandbox linker output.*/
+  n = 0U;
+  memset(&sections[n++], 0, sizeof (gen_section_t));
+  text_sec = add_section(&n, &shstr_len, ".text", SHT_PROGBITS,
+                         SHF_ALLOC | SHF_EXECINSTR,
+                         text_addr, base_off + text_addr, pp->text);
+  sections[add_section(&n, &shstr_len, ".rel.text", SHT_REL, SHF_INFO_LINK,
+                       0U, text_rel_off, rel_text_size)].sh_info = text_sec;
+  (void) add_section(&n, &shstr_len, ".rodata", SHT_PROGBITS, SHF_ALLOC,
+                     rodata_addr, base_off + rodata_addr, pp->rodata);
+  data_sec = add_section(&n, &shstr_len, ".data", SHT_PROGBITS,
+                         SHF_ALLOC | SHF_WRITE,
+                         data_addr, base_off + data_addr, pp->data);
+  sections[add_section(&n, &shstr_len, ".rel.data", SHT_REL, SHF_INFO_LINK,
+                       0U, data_rel_off, rel_data_size)].sh_info = data_sec;
+  (void) add_section(&n, &shstr_len, ".bss", SHT_NOBITS,
+                     SHF_ALLOC | SHF_WRITE,
+                     bss_addr, base_off + data_addr + pp->data, pp->bss);
+
+  /* Non allocated sections.*/
+  for (i = 0U; i < pp->debug_sections; i++) {
+    char name[16];
+
+    (void) snprintf(name, sizeof name, ".debug_%u", (unsigned)i);
+    fill_random(off, 512U);
+    (void) add_section(&n, &shstr_len, name, SHT_PROGBITS, 0U,
+                       0U, off, 512U);
+    off += 512U;
+  }
+  fill_random(off, NUM_SYMBOLS * 16U);
+  (void) add_section(&n, &shstr_len, ".symtab", SHT_SYMTAB, 0U,
+                     0U, off, NUM_SYMBOLS * 16U);
+  off += NUM_SYMBOLS * 16U;
+  fill_random(off, 256U);
+  (void) add_section(&n, &shstr_len, ".strtab", SHT_STRTAB, 0U,
+                     0U, off, 256U);
+  off += 256U;
+  i = add_section(&n, &shstr_len, ".shstrtab", SHT_STRTAB, 0U,
+                  0U, off, 0U);
+  sections[i].sh_size = shstr_len;
+  memcpy(&file_buf[off], shstrtab, shstr_len);
+  off = align4(off + shstr_len);
+
+  /* Section headers table.*/
+  memcpy(&file_buf[off], sections, n * sizeof (gen_section_t));
+
+  /* Main header.*/
+  memset(&h, 0, sizeof h);
+  memcpy(h.e_ident, ident, sizeof ident);
+  h.e_type      = ET_EXEC;
+  h.e_machine   = EM_ARM;
+  h.e_version   = 1U;
+  h.e_entry     = text_addr | 1U;
+  h.e_shoff     = off;
+  h.e_ehsize    = (uint16_t)sizeof h;
+  h.e_shentsize = (uint16_t)sizeof (gen_section_t);
+  h.e_shnum     = (uint16_t)n;
+  h.e_shstrndx  = (uint16_t)i;
+  memcpy(file_buf, &h, sizeof h);
+
+  return off + (n * (uint32_t)sizeof (gen_section_t));
+}
+
+static bool write_file(const char *path, uint32_t size) {
+  vfs_file_node_c *fnp;
+  ssize_t n;
+
+  if (CH_RET_IS_ERROR(vfsOpenFile(path, VO_WRONLY | VO_CREAT, &fnp))) {
+    return true;
+  }
+  n = vfsWriteFile(fnp, file_buf, size);
+  vfsClose((vfs_node_c *)fnp);
+
+  return n != (ssize_t)size;
+}
+
+static bool add_file(const char *name, uint32_t size) {
+  corpus_file_t *cfp;
+
+  if (corpus_num >= CORPUS_MAX) {
+    return true;
+  }
+  cfp = &corpus[corpus_num];
+  (void) snprintf(cfp->path, sizeof cfp->path, "/app%u.elf",
+                  (unsigned)corpus_num);
+  cfp->name = name;
+  cfp->size = size;
+  if (write_file(cfp->path, size)) {
+    return true;
+  }
+  corpus_num++;
+
+  return false;
+}
+
+static bool gen_corpus(void) {
+  const gen_profile_t *pp;
+
+  seed = 1U;
+  for (pp = profiles; pp->name != NULL; pp++) {
+    if (add_file(pp->name, gen_elf(pp))) {
+      return true;
+    }
+  }
+
+#if defined(ELF_CORPUS_DIR)
+  /* Executables found in the host directory are added to the corpus.*/
+  {
+    static char names[CORPUS_MAX][32];
+    struct dirent *dep;
+    DIR *dp;
+
+    dp = opendir(ELF_CORPUS_DIR);
+    if (dp == NULL) {
+      return true;
+    }
+    while ((dep = readdir(dp)) != NULL) {
+      char path[512];
+      FILE *fp;
+      size_t size;
+
+      if ((strstr(dep->d_name, ".elf") == NULL) ||
+          (corpus_num >= CORPUS_MAX)) {
+        continue;
+      }
+      (void) snprintf(path, sizeof path, "%s/%s", ELF_CORPUS_DIR, dep->d_name);
+      fp = fopen(path, "rb");
+      if (fp == NULL) {
+        continue;
+      }
+      size = fread(file_buf, 1U, sizeof file_buf, fp);
+      fclose(fp);
+      (void) snprintf(names[corpus_num], sizeof names[0], "%s", dep->d_name);
+      if (add_file(names[corpus_num], (uint32_t)size)) {
+        closedir(dp);
+        return true;
+      }
+    }
+    closedir(dp);
+  }
+#endif
+
+  return false;
+}
+
+/*===========================================================================*/
+/* Benchmark.                                                                */
+/*===========================================================================*/
+
+static CC_ALIGN_DATA(8) uint8_t arena[ARENA_SIZE];
+static uint8_t reference[ARENA_SIZE];
+
+static const memory_area_t arena_area = {arena, ARENA_SIZE};
+
+static msg_t run(const corpus_file_t *cfp, const loader_t *lp) {
+  const SimBlockStats *sp = sblkGetStats(&SBD1);
+  rtcnt_t start, end;
+  unsigned i;
+  msg_t ret;
+
+  sblkResetStats(&SBD1);
+
+  ret = CH_RET_SUCCESS;
+  start = chSysGetRealtimeCounterX();
+  for (i = 0U; i < BENCH_LOADS; i++) {
+    memset(arena, 0, sizeof arena);
+    ret = lp->load(vfs_root, cfp->path, &arena_area);
+    if (CH_RET_IS_ERROR(ret)) {
+      break;
+    }
+  }
+  end = chSysGetRealtimeCounterX();
+
+  printf("%-8s %-6s: %4u cmds %5u blks %6u us media %6u us CPU per load\n",
+         cfp->name, lp->name,
+         (unsigned)((sp->reads + sp->writes) / BENCH_LOADS),
+         (unsigned)((sp->blocks_read + sp->blocks_written) / BENCH_LOADS),
+         (unsigned)(sp->busy_time / BENCH_LOADS),
+         (unsigned)(((uint64_t)(end - start) * 1000000U) /
+                    ((uint64_t)PORT_SIM_RT_FREQUENCY * BENCH_LOADS)));
+
+  return ret;
+}
+
+/*
+ * Application entry point.
+ */
+int main(void) {
+  unsigned i;
+
+  /*
+   * System initializations.
+   * - HAL initialization, this also initializes the configured device drivers
+   *   and performs the board-specific initializations.
+   * - Kernel initialization, the main() function becomes a thread and the
+   *   RTOS is active.
+   * - Virtual File System initialization.
+   */
+  halInit();
+  chSysInit();
+  vfsInit();
+
+  /*
+   * Simulated disk activation.
+   */
+  sblkObjectInit(&SBD1);
+  if (sblkStart(&SBD1, &disk_config) != HAL_RET_SUCCESS) {
+    printf("Disk activation failed\n");
+    return 1;
+  }
+  (void) blkConnect(&SBD1);
+
+  /*
+   * Formatting and mounting the volume, the root is a FatFS VFS driver.
+   */
+  if (f_mkfs("0:", NULL, mkfs_buf, sizeof mkfs_buf) != FR_OK) {
+    printf("Format failed\n");
+    return 1;
+  }
+  ffdrvObjectInit(&root_driver);
+  if (CH_RET_IS_ERROR(ffdrvMount("0:", true))) {
+    printf("Mount failed\n");
+    return 1;
+  }
+
+  if (gen_corpus()) {
+    printf("Corpus creation failed\n");
+    return 1;
+  }
+
+  printf("Sandbox ELF loader benchmark, %u loads per file\n",
+         (unsigned)BENCH_LOADS);
+  printf("Simulated media: %u us per command, %u us per block\n\n",
+         (unsigned)DISK_CMD_US, (unsigned)DISK_BLOCK_US);
+
+  /*
+   * Each file is loaded by both loaders, the resulting images must be
+   * identical.
+   */
+  for (i = 0U; i < corpus_num; i++) {
+    const corpus_file_t *cfp = &corpus[i];
+    msg_t ret;
+
+    ret = run(cfp, &loaders[0]);
+    if (CH_RET_IS_ERROR(ret)) {
+      printf("%-8s: legacy loader failed (%d)\n", cfp->name, (int)ret);
+      continue;
+    }
+    memcpy(reference, arena, sizeof arena);
+
+    ret = run(cfp, &loaders[1]);
+    if (CH_RET_IS_ERROR(ret)) {
+      printf("%-8s: FAILED (%d)\n", cfp->name, (int)ret);
+      return 1;
+    }
+    if (memcmp(reference, arena, sizeof arena) != 0) {
+      printf("%-8s: FAILED (image mismatch)\n", cfp->name);
+      return 1;
+    }
+    printf("%-8s %u bytes: OK\n\n", cfp->name, (unsigned)cfp->size);
+  }
+
+  (void) ffdrvUnmount("0:");
+  (void) blkDisconnect(&SBD1);
+  sblkStop(&SBD1);
+
+  return 0;
+}
@@ -0,0 +1,224 @@
+/*
+    ChibiOS - Copyright (C) 2006..2018 Giovanni Di Sirio
+
+    Licensed under the Apache License, Version 2.0 (the "License");
+    you may not use this file except in compliance with the License.
+    You may obtain a copy of the License at
+
+        http://www.apache.org/licenses/LICENSE-2.0
+
+    Unless required by applicable law or agreed to in writing, software
+    distributed under the License is distributed on an "AS IS" BASIS,
+    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+    See the License for the specific language governing permissions and
+    limitations under the License.
+*/
+
+#include <stdio.h>
+#include <string.h>
+#include <pthread.h>
+#include <sys/socket.h>
+#include <netinet/in.h>
+#include <arpa/inet.h>
+#include <unistd.h>
+
+#include "ch.h"
+#include "hal.h"
+
+/*===========================================================================*/
+/* Benchmark settings.                                                       */
+/*===========================================================================*/
+
+/* Amount of data transferred in each direction.*/
+#if !defined(TRANSFER_SIZE)
+#define TRANSFER_SIZE               (16U * 1024U * 1024U)
+#endif
+
+/* Size of the blocks written and read by the application, the data is
+   a counting pattern so it must be a multiple of 256.*/
+#define BLOCK_SIZE                  4096U
+
+/*===========================================================================*/
+/* Host peer.                                                                */
+/*===========================================================================*/
+
+/*
+ * The peer is a plain host thread connected to the SD1 listen socket, it
+ * never calls into the RTOS. It first sinks and verifies TRANSFER_SIZE
+ * bytes then sources TRANSFER_SIZE bytes, the socket is closed on exit.
+ */
+static void *peer(void *arg) {
+  static uint8_t buf[BLOCK_SIZE];
+  struct sockaddr_in sad;
+  size_t total, i;
+  int fd;
+
+  (void)arg;
+
+  fd = socket(AF_INET, SOCK_STREAM, 0);
+  memset(&sad, 0, sizeof(sad));
+  sad.sin_family      = AF_INET;
+  sad.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+  sad.sin_port        = htons(SIM_SD1_PORT);
+  if ((fd == -1) || (connect(fd, (struct sockaddr *)&sad, sizeof(sad)) != 0)) {
+    printf("Peer connection failed\n");
+    return NULL;
+  }
+
+  for (total = 0U; total < TRANSFER_SIZE; ) {
+    ssize_t n = recv(fd, buf, sizeof(buf), 0);
+    if (n <= 0) {
+      goto done;
+    }
+    for (i = 0U; i < (size_t)n; i++) {
+      if (buf[i] != (uint8_t)(total + i)) {
+        printf("Peer data mismatch at %u\n", (unsigned)(total + i));
+        goto done;
+      }
+    }
+    total += (size_t)n;
+  }
+
+  for (i = 0U; i < sizeof(buf); i++) {
+    buf[i] = (uint8_t)i;
+  }
+  for (total = 0U; total < TRANSFER_SIZE; ) {
+    ssize_t n = send(fd, buf, sizeof(buf), 0);
+    if (n <= 0) {
+      goto done;
+    }
+    total += (size_t)n;
+  }
+
+done:
+  close(fd);
+  return NULL;
+}
+
+/*===========================================================================*/
+/* Benchmark.                                                                */
+/*===========================================================================*/
+
+static uint8_t buffer[BLOCK_SIZE];
+
+static void fill_pattern(void) {
+  unsigned i;
+
+  for (i = 0U; i < BLOCK_SIZE; i++) {
+    buffer[i] = (uint8_t)i;
+  }
+}
+
+static void report(const char *name, rtcnt_t counts) {
+  uint64_t kbps;
+
+  kbps = ((uint64_t)TRANSFER_SIZE * (uint64_t)PORT_SIM_RT_FREQUENCY) /
+         ((uint64_t)counts * 1024U);
+  printf("%-3s: %10u RT counts, %8u KiB/s\n",
+         name, (unsigned)counts, (unsigned)kbps);
+}
+
+static bool do_tx(void) {
+  event_listener_t el;
+  rtcnt_t start;
+  size_t total;
+  bool empty;
+
+  chEvtRegisterMaskWithFlags(chnGetEventSource(&SD1), &el,
+                             EVENT_MASK(1), CHN_OUTPUT_EMPTY);
+  fill_pattern();
+
+  start = chSysGetRealtimeCounterX();
+  for (total = 0U; total < TRANSFER_SIZE; total += BLOCK_SIZE) {
+    if (chnWrite(&SD1, buffer, BLOCK_SIZE) != BLOCK_SIZE) {
+      chEvtUnregister(chnGetEventSource(&SD1), &el);
+      return true;
+    }
+  }
+
+  /* Waiting for the output queue to be drained.*/
+  do {
+    osalSysLock();
+    empty = oqIsEmptyI(&SD1.oqueue);
+    osalSysUnlock();
+    if (!empty) {
+      (void) chEvtWaitAnyTimeout(EVENT_MASK(1), TIME_MS2I(10));
+    }
+  } while (!empty);
+  report("TX", chSysGetRealtimeCounterX() - start);
+
+  chEvtUnregister(chnGetEventSource(&SD1), &el);
+  return false;
+}
+
+static bool do_rx(void) {
+  rtcnt_t start, end;
+  size_t total, i;
+
+  start = chSysGetRealtimeCounterX();
+  for (total = 0U; total < TRANSFER_SIZE; ) {
+    size_t n = chnReadTimeout(&SD1, buffer, BLOCK_SIZE, TIME_S2I(5));
+    if (n == 0U) {
+      return true;
+    }
+    for (i = 0U; i < n; i++) {
+      if (buffer[i] != (uint8_t)(total + i)) {
+        return true;
+      }
+    }
+    total += n;
+  }
+  end = chSysGetRealtimeCounterX();
+  report("RX", end - start);
+
+  return false;
+}
+
+/*
+ * Application entry point.
+ */
+int main(void) {
+  event_listener_t el;
+  pthread_t tid;
+
+  /*
+   * System initializations.
+   * - HAL initialization, this also initializes the configured device drivers
+   *   and performs the board-specific initializations.
+   * - Kernel initialization, the main() function becomes a thread and the
+   *   RTOS is active.
+   */
+  halInit();
+  chSysInit();
+
+  /*
+   * SD1 is started and the host peer connects to it.
+   */
+  sdStart(&SD1, NULL);
+  chEvtRegisterMaskWithFlags(chnGetEventSource(&SD1), &el,
+                             EVENT_MASK(0), CHN_CONNECTED);
+  if (pthread_create(&tid, NULL, peer, NULL) != 0) {
+    printf("Peer creation failed\n");
+    return 1;
+  }
+  if (chEvtWaitAnyTimeout(EVENT_MASK(0), TIME_S2I(5)) == (eventmask_t)0) {
+    printf("Peer not connected\n");
+    return 1;
+  }
+  chEvtUnregister(chnGetEventSource(&SD1), &el);
+
+  printf("Serial throughput benchmark, %u bytes per direction\n",
+         (unsigned)TRANSFER_SIZE);
+  printf("Serial buffers size: %u\n\n", (unsigned)SERIAL_BUFFERS_SIZE);
+
+  if (do_tx()) {
+    printf("TX : FAILED\n");
+    return 1;
+  }
+  if (do_rx()) {
+    printf("RX : FAILED\n");
+    return 1;
+  }
+
+  return 0;
+}
@@ -0,0 +1,422 @@
+/*
+    ChibiOS - Copyright (C) 2006..2018 Giovanni Di Sirio
+
+    Licensed under the Apache License, Version 2.0 (the "License");
+    you may not use this file except in compliance with the License.
+    You may obtain a copy of the License at
+
+        http://www.apache.org/licenses/LICENSE-2.0
+
+    Unless required by applicable law or agreed to in writing, software
+    distributed under the License is distributed on an "AS IS" BASIS,
+    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+    See the License for the specific language governing permissions and
+    limitations under the License.
+*/
+
+#include <stdio.h>
+#include <string.h>
+
+#include "ch.h"
+#include "hal.h"
+
+#include "hal_serial_nor.h"
+
+/*===========================================================================*/
+/* Benchmark settings.                                                       */
+/*===========================================================================*/
+
+/*
+ * Simulated bus, the setup time accounts for the per-transfer overhead
+ * (DMA programming and completion interrupt) of a real SPI peripheral.
+ */
+#define SPI_BITRATE                 50000000U
+#define SPI_SETUP_NS                1000U
+
+/*
+ * Simulated N25Q device timings, the sector erase time is shorter than the
+ * datasheet typical value in order to keep runs short.
+ */
+#define NOR_CAPACITY_ID             0x16U
+#define NOR_SIZE                    (1U << NOR_CAPACITY_ID)
+#define NOR_PAGE_SIZE               256U
+#define NOR_SECTOR_SIZE             0x10000U
+#define NOR_T_PP_NS                 500000U
+#define NOR_T_SE_NS                 100000000U
+#define NOR_T_SUS_NS                20000U
+
+/* Number of erased sectors and reader settings.*/
+#define BENCH_ERASES                8U
+#define BENCH_READ_SIZE             256U
+#define BENCH_READ_PERIOD           TIME_US2I(2000)
+
+/*===========================================================================*/
+/* N25Q model.                                                               */
+/*===========================================================================*/
+
+static struct {
+  bool          selected;
+  uint8_t       cmd;
+  unsigned      cnt;
+  uint32_t      addr;
+  bool          wel;
+  uint64_t      busy_until;
+  bool          erasing;
+  bool          suspended;
+  uint64_t      erase_end;
+  uint64_t      erase_left;
+  uint32_t      erase_addr;
+  uint32_t      status_reads;
+  uint32_t      suspends;
+  uint32_t      violations;
+  uint8_t       mem[NOR_SIZE];
+} nor;
+
+static void nor_update(uint64_t now) {
+
+  if (nor.erasing && !nor.suspended && (now >= nor.erase_end)) {
+    memset(&nor.mem[nor.erase_addr], 0xFF, NOR_SECTOR_SIZE);
+    nor.erasing = false;
+  }
+}
+
+static bool nor_is_ready(void) {
+  uint64_t now = _sim_get_time();
+
+  nor_update(now);
+  return (now >= nor.busy_until) && (!nor.erasing || nor.suspended);
+}
+
+static bool nor_is_erasing(uint32_t addr) {
+
+  return nor.erasing && ((addr & ~(NOR_SECTOR_SIZE - 1U)) == nor.erase_addr);
+}
+
+static void nor_deselected(void) {
+  uint64_t now = _sim_get_time();
+
+  nor_update(now);
+  switch (nor.cmd) {
+  case N25Q_CMD_WRITE_ENABLE:
+    nor.wel = true;
+    break;
+  case N25Q_CMD_WRITE_DISABLE:
+    nor.wel = false;
+    break;
+  case N25Q_CMD_PAGE_PROGRAM:
+    nor.busy_until = now + NOR_T_PP_NS;
+    nor.wel        = false;
+    break;
+  case N25Q_CMD_SECTOR_ERASE:
+    if (!nor.wel || !nor_is_ready() || nor.erasing) {
+      nor.violations++;
+      break;
+    }
+    nor.erasing    = true;
+    nor.suspended  = false;
+    nor.erase_addr = nor.addr & ~(NOR_SECTOR_SIZE - 1U);
+    nor.erase_end  = now + NOR_T_SE_NS;
+    nor.wel        = false;
+    break;
+  case N25Q_CMD_PROGRAM_ERASE_SUSPEND:
+    if (nor.erasing && !nor.suspended) {
+      nor.erase_left = nor.erase_end - now;
+      nor.suspended  = true;
+      nor.busy_until = now + NOR_T_SUS_NS;
+      nor.suspends++;
+    }
+    break;
+  case N25Q_CMD_PROGRAM_ERASE_RESUME:
+    if (nor.suspended) {
+      if (now < nor.busy_until) {
+        nor.violations++;
+      }
+      nor.suspended = false;
+      nor.erase_end = now + nor.erase_left;
+    }
+    break;
+  default:
+    break;
+  }
+}
+
+static void nor_select(void *arg, bool selected) {
+
+  (void)arg;
+
+  if (!selected && nor.selected && (nor.cnt > 0U)) {
+    nor_deselected();
+  }
+  nor.selected = selected;
+  nor.cnt      = 0U;
+}
+
+static uint8_t nor_exchange(void *arg, uint8_t frame) {
+  static const uint8_t id[3] = {0x20U, 0xBAU, NOR_CAPACITY_ID};
+  unsigned i = nor.cnt++;
+
+  (void)arg;
+
+  if (i == 0U) {
+    nor.cmd  = frame;
+    nor.addr = 0U;
+    if (nor.cmd == N25Q_CMD_READ_FLAG_STATUS_REGISTER) {
+      nor.status_reads++;
+    }
+    else if ((nor.cmd != N25Q_CMD_PROGRAM_ERASE_SUSPEND) && !nor_is_ready()) {
+      /* Only status reads and suspend are allowed while busy.*/
+      nor.violations++;
+    }
+    return 0xFFU;
+  }
+
+  switch (nor.cmd) {
+  case N25Q_CMD_READ_ID:
+    return i <= 3U ? id[i - 1U] : 0x00U;
+  case N25Q_CMD_READ_FLAG_STATUS_REGISTER:
+    return (nor_is_ready() ? N25Q_FLAGS_PROGRAM_ERASE : 0U) |
+           (nor.suspended ? N25Q_FLAGS_ERASE_SUSPEND : 0U);
+  case N25Q_CMD_READ:
+  case N25Q_CMD_PAGE_PROGRAM:
+  case N25Q_CMD_SECTOR_ERASE:
+    if (i <= 3U) {
+      nor.addr = (nor.addr << 8) | frame;
+      return 0xFFU;
+    }
+    if (nor.cmd == N25Q_CMD_READ) {
+      uint32_t addr = (nor.addr + (uint32_t)(i - 4U)) & (NOR_SIZE - 1U);
+
+      if (nor_is_erasing(addr)) {
+        nor.violations++;
+      }
+      return nor.mem[addr];
+    }
+    if (nor.cmd == N25Q_CMD_PAGE_PROGRAM) {
+      uint32_t addr = (nor.addr & ~(NOR_PAGE_SIZE - 1U)) |
+                      ((nor.addr + (uint32_t)(i - 4U)) & (NOR_PAGE_SIZE - 1U));
+
+      if (!nor.wel || nor_is_erasing(addr)) {
+        nor.violations++;
+      }
+      nor.mem[addr] &= frame;
+    }
+    return 0xFFU;
+  default:
+    return 0xFFU;
+  }
+}
+
+static const SimSPIDevice nor_device = {
+  .select           = nor_select,
+  .exchange         = nor_exchange,
+  .arg              = NULL
+};
+
+/*===========================================================================*/
+/* Benchmark.                                                                */
+/*===========================================================================*/
+
+static const SPIConfig spicfg = {
+  NULL,
+  &nor_device,
+  SPI_BITRATE,
+  SPI_SETUP_NS
+};
+
+static const SNORConfig snorcfg = {
+  .busp             = &SPID1,
+  .buscfg           = &spicfg
+};
+
+static snor_nocache_buffer_t snor_buffer;
+static SNORDriver SNOR1;
+
+static uint8_t pattern(uint32_t offset) {
+
+  return (uint8_t)((offset * 7U) + (offset >> 8));
+}
+
+static volatile bool erasing;
+static volatile bool done;
+
+static struct {
+  uint32_t      reads;
+  uint32_t      retries;
+  rtcnt_t       min;
+  rtcnt_t       max;
+  uint64_t      total;
+  bool          failed;
+} rstats;
+
+static THD_WORKING_AREA(waReader, 1024);
+static THD_FUNCTION(Reader, arg) {
+  static uint8_t buf[BENCH_READ_SIZE];
+  uint32_t offset = 0U;
+
+  (void)arg;
+
+  while (!done) {
+    bool during_erase = erasing;
+    rtcnt_t start = chSysGetRealtimeCounterX();
+    flash_error_t err;
+    uint32_t i;
+
+    /* Reads failing because an erase are retried after a sleep, this is
+       what any flash user has to do when erase suspend is not available.*/
+    while (true) {
+      flashAcquireExclusive(&SNOR1);
+      err = flashRead(&SNOR1, offset, BENCH_READ_SIZE, buf);
+      flashReleaseExclusive(&SNOR1);
+      if (err != FLASH_BUSY_ERASING) {
+        break;
+      }
+      rstats.retries++;
+      chThdSleepMilliseconds(1);
+    }
+
+    if (during_erase) {
+      rtcnt_t t = chSysGetRealtimeCounterX() - start;
+
+      if ((rstats.reads == 0U) || (t < rstats.min)) {
+        rstats.min = t;
+      }
+      if (t > rstats.max) {
+        rstats.max = t;
+      }
+      rstats.total += t;
+      rstats.reads++;
+    }
+
+    for (i = 0U; i < BENCH_READ_SIZE; i++) {
+      if ((err != FLASH_NO_ERROR) || (buf[i] != pattern(offset + i))) {
+        rstats.failed = true;
+      }
+    }
+
+    offset = (offset + BENCH_READ_SIZE) & (NOR_SECTOR_SIZE - 1U);
+    chThdSleep(BENCH_READ_PERIOD);
+  }
+}
+
+static bool do_program(void) {
+  static uint8_t page[NOR_PAGE_SIZE];
+  uint32_t offset, i, polls;
+  rtcnt_t start, t;
+
+  polls = nor.status_reads;
+  start = chSysGetRealtimeCounterX();
+  for (offset = 0U; offset < NOR_SECTOR_SIZE; offset += NOR_PAGE_SIZE) {
+    for (i = 0U; i < NOR_PAGE_SIZE; i++) {
+      page[i] = pattern(offset + i);
+    }
+    if (flashProgram(&SNOR1, offset, NOR_PAGE_SIZE, page) != FLASH_NO_ERROR) {
+      return true;
+    }
+  }
+  t = chSysGetRealtimeCounterX() - start;
+  polls = nor.status_reads - polls;
+
+  printf("Program: %6u us/page, %5.2f status polls/page\n",
+         (unsigned)((t / (NOR_SECTOR_SIZE / NOR_PAGE_SIZE)) / 1000U),
+         (double)polls / (double)(NOR_SECTOR_SIZE / NOR_PAGE_SIZE));
+
+  return false;
+}
+
+static bool do_erase(void) {
+  flash_sector_t sector;
+  rtcnt_t start, total;
+  thread_t *tp;
+
+  memset(&rstats, 0, sizeof (rstats));
+  done  = false;
+  total = 0U;
+  tp = chThdCreateStatic(waReader, sizeof waReader, NORMALPRIO + 1,
+                         Reader, NULL);
+
+  for (sector = 1U; sector <= BENCH_ERASES; sector++) {
+    flash_error_t err;
+    uint32_t msec;
+
+    start = chSysGetRealtimeCounterX();
+    flashAcquireExclusive(&SNOR1);
+    err = flashStartEraseSector(&SNOR1, sector);
+    erasing = true;
+    flashReleaseExclusive(&SNOR1);
+    if (err != FLASH_NO_ERROR) {
+      return true;
+    }
+
+    do {
+      chThdSleepMilliseconds(1);
+      flashAcquireExclusive(&SNOR1);
+      err = flashQueryErase(&SNOR1, &msec);
+      flashReleaseExclusive(&SNOR1);
+    } while (err == FLASH_BUSY_ERASING);
+    erasing = false;
+    if (err != FLASH_NO_ERROR) {
+      return true;
+    }
+    total += chSysGetRealtimeCounterX() - start;
+  }
+
+  done = true;
+  chThdWait(tp);
+
+  if (rstats.failed || (rstats.reads == 0U)) {
+    return true;
+  }
+
+  printf("Erase  : %6u us/sector, %u suspends\n",
+         (unsigned)((total / BENCH_ERASES) / 1000U), (unsigned)nor.suspends);
+  printf("Reads during erase: %u, retries %u\n",
+         (unsigned)rstats.reads, (unsigned)rstats.retries);
+  printf("Read latency: min %u us, avg %u us, max %u us\n",
+         (unsigned)(rstats.min / 1000U),
+         (unsigned)((rstats.total / rstats.reads) / 1000U),
+         (unsigned)(rstats.max / 1000U));
+
+  return false;
+}
+
+/*
+ * Application entry point.
+ */
+int main(void) {
+
+  /*
+   * System initializations.
+   * - HAL initialization, this also initializes the configured device drivers
+   *   and performs the board-specific initializations.
+   * - Kernel initialization, the main() function becomes a thread and the
+   *   RTOS is active.
+   */
+  halInit();
+  chSysInit();
+
+  memset(nor.mem, 0xFF, sizeof (nor.mem));
+
+  printf("Serial NOR benchmark, erase suspend %s, %s polling\n\n",
+         SNOR_USE_ERASE_SUSPEND == TRUE ? "enabled" : "disabled",
+         N25Q_NICE_WAITING == TRUE ? "sleep" : "busy");
+
+  snorObjectInit(&SNOR1, &snor_buffer);
+  snorStart(&SNOR1, &snorcfg);
+
+  if (do_program()) {
+    printf("Program: FAILED\n");
+    return 1;
+  }
+  if (do_erase()) {
+    printf("Erase  : FAILED\n");
+    return 1;
+  }
+  if (nor.violations != 0U) {
+    printf("Device protocol violations: %u\n", (unsigned)nor.violations);
+    return 1;
+  }
+
+  snorStop(&SNOR1);
+
+  return 0;
+}
@@ -0,0 +1,275 @@
+/*
+    ChibiOS - Copyright (C) 2006..2018 Giovanni Di Sirio
+
+    Licensed under the Apache License, Version 2.0 (the "License");
+    you may not use this file except in compliance with the License.
+    You may obtain a copy of the License at
+
+        http://www.apache.org/licenses/LICENSE-2.0
+
+    Unless required by applicable law or agreed to in writing, software
+    distributed under the License is distributed on an "AS IS" BASIS,
+    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+    See the License for the specific language governing permissions and
+    limitations under the License.
+*/
+
+/*
+ * Serial over USB throughput on the simulated loopback host.
+ *
+ * A thread writes a pattern on the bulk IN endpoint, the host sends it back
+ * on the bulk OUT endpoint where it is read and verified. The transfer is
+ * performed using the channel interface and using the zero-copy API.
+ * The buffers size is SERIAL_USB_BUFFERS_SIZE, building with
+ * UDEFS="-DSIMULATOR -DSERIAL_USB_BUFFERS_SIZE=512" measures buffers of a
+ * single packet.
+ */
+
+#include <stdio.h>
+
+#include "ch.h"
+#include "hal.h"
+
+/*===========================================================================*/
+/* Benchmark settings.                                                       */
+/*===========================================================================*/
+
+/* Bytes transferred by each run.*/
+#define TOTAL_BYTES                 (4U * 1024U * 1024U)
+
+/* Size of the blocks moved through the channel interface.*/
+#define BLOCK_SIZE                  1024U
+
+/*===========================================================================*/
+/* USB configuration.                                                        */
+/*===========================================================================*/
+
+#define USB_DATA_EP                 1U
+
+static SerialUSBDriver SDU1;
+
+static USBInEndpointState ep1instate;
+static USBOutEndpointState ep1outstate;
+
+static const USBEndpointConfig ep1config = {
+  USB_EP_MODE_TYPE_BULK,
+  NULL,
+  sduDataTransmitted,
+  sduDataReceived,
+  SIM_USB_MAX_PACKET_SIZE,
+  SIM_USB_MAX_PACKET_SIZE,
+  &ep1instate,
+  &ep1outstate
+};
+
+/* The simulated host does not ask for descriptors.*/
+static const USBDescriptor *get_descriptor(USBDriver *usbp,
+                                           uint8_t dtype,
+                                           uint8_t dindex,
+                                           uint16_t lang) {
+
+  (void)usbp;
+  (void)dtype;
+  (void)dindex;
+  (void)lang;
+
+  return NULL;
+}
+
+static void usb_event(USBDriver *usbp, usbevent_t event) {
+
+  switch (event) {
+  case USB_EVENT_CONFIGURED:
+    osalSysLockFromISR();
+    usbInitEndpointI(usbp, USB_DATA_EP, &ep1config);
+    sduConfigureHookI(&SDU1);
+    osalSysUnlockFromISR();
+    return;
+  case USB_EVENT_RESET:
+    /* Falls into.*/
+  case USB_EVENT_UNCONFIGURED:
+    /* Falls into.*/
+  case USB_EVENT_SUSPEND:
+    osalSysLockFromISR();
+    sduSuspendHookI(&SDU1);
+    osalSysUnlockFromISR();
+    return;
+  case USB_EVENT_WAKEUP:
+    osalSysLockFromISR();
+    sduWakeupHookI(&SDU1);
+    osalSysUnlockFromISR();
+    return;
+  default:
+    return;
+  }
+}
+
+static void sof_handler(USBDriver *usbp) {
+
+  (void)usbp;
+
+  osalSysLockFromISR();
+  sduSOFHookI(&SDU1);
+  osalSysUnlockFromISR();
+}
+
+static const USBConfig usbcfg = {
+  usb_event,
+  get_descriptor,
+  sduRequestsHook,
+  sof_handler
+};
+
+static const SerialUSBConfig serusbcfg = {
+  &USBD1,
+  USB_DATA_EP,
+  USB_DATA_EP,
+  0U
+};
+
+/*===========================================================================*/
+/* Benchmarks.                                                               */
+/*===========================================================================*/
+
+static bool zerocopy;
+static volatile bool failed;
+
+static uint8_t pattern(uint32_t offset) {
+
+  return (uint8_t)(offset % 251U);
+}
+
+static THD_WORKING_AREA(waWriter, 2048);
+static THD_FUNCTION(Writer, arg) {
+  static uint8_t block[BLOCK_SIZE];
+  uint32_t i, n = 0U;
+
+  (void)arg;
+
+  while (n < TOTAL_BYTES) {
+    uint8_t *bp;
+    size_t size;
+
+    if (zerocopy) {
+      bp = sduGetTransmitAreaTimeout(&SDU1, &size, TIME_INFINITE);
+      if (bp == NULL) {
+        failed = true;
+        return;
+      }
+    }
+    else {
+      bp   = block;
+      size = BLOCK_SIZE;
+    }
+    if (size > TOTAL_BYTES - n) {
+      size = TOTAL_BYTES - n;
+    }
+
+    for (i = 0U; i < size; i++) {
+      bp[i] = pattern(n + i);
+    }
+
+    if (zerocopy) {
+      sduCommitTransmitArea(&SDU1, size);
+    }
+    else if (chnWriteTimeout(&SDU1, bp, size, TIME_INFINITE) != size) {
+      failed = true;
+      return;
+    }
+    n += (uint32_t)size;
+  }
+}
+
+static void bench(const char *name, bool zc) {
+  static uint8_t block[BLOCK_SIZE];
+  uint32_t i, n = 0U, packets, transfers;
+  systime_t start;
+  sysinterval_t elapsed;
+  thread_t *wtp;
+
+  zerocopy  = zc;
+  packets   = USBD1.packets;
+  transfers = USBD1.transfers;
+  start     = chVTGetSystemTime();
+  wtp = chThdCreateStatic(waWriter, sizeof waWriter, NORMALPRIO,
+                          Writer, NULL);
+
+  while (!failed && (n < TOTAL_BYTES)) {
+    const uint8_t *bp;
+    size_t size;
+
+    if (zc) {
+      bp = sduGetReceiveAreaTimeout(&SDU1, &size, TIME_MS2I(1000));
+    }
+    else {
+      size = chnReadTimeout(&SDU1, block, BLOCK_SIZE, TIME_MS2I(1000));
+      bp = block;
+    }
+    if ((bp == NULL) || (size == 0U)) {
+      failed = true;
+      break;
+    }
+
+    for (i = 0U; i < size; i++) {
+      if (bp[i] != pattern(n + i)) {
+        failed = true;
+      }
+    }
+
+    if (zc) {
+      sduReleaseReceiveArea(&SDU1, size);
+    }
+    n += (uint32_t)size;
+  }
+
+  elapsed = chVTTimeElapsedSinceX(start);
+  chThdWait(wtp);
+
+  if (failed) {
+    printf("%-12s FAILED at byte %u\n", name, (unsigned)n);
+    return;
+  }
+
+  transfers = USBD1.transfers - transfers;
+  printf("%-12s %8.2f MB/s %8u bytes/packet %8u bytes/transfer\n", name,
+         ((double)TOTAL_BYTES * (double)CH_CFG_ST_FREQUENCY) /
+         ((double)elapsed * 1000000.0),
+         (unsigned)((2U * TOTAL_BYTES) / (USBD1.packets - packets)),
+         (unsigned)((2U * TOTAL_BYTES) / transfers));
+}
+
+/*
+ * Application entry point.
+ */
+int main(void) {
+
+  /*
+   * System initializations.
+   * - HAL initialization, this also initializes the configured device drivers
+   *   and performs the board-specific initializations.
+   * - Kernel initialization, the main() function becomes a thread and the
+   *   RTOS is active.
+   */
+  halInit();
+  chSysInit();
+
+  sduObjectInit(&SDU1);
+  sduStart(&SDU1, &serusbcfg);
+  usbStart(serusbcfg.usbp, &usbcfg);
+  usbConnectBus(serusbcfg.usbp);
+
+  while (usbGetDriverStateI(serusbcfg.usbp) != USB_ACTIVE) {
+    chThdSleepMilliseconds(1);
+  }
+
+  printf("Serial over USB loopback, %s speed, %u bytes buffers, "
+         "%u bytes transferred\n\n",
+         SIM_USB_HIGH_SPEED == TRUE ? "high" : "full",
+         (unsigned)SERIAL_USB_BUFFERS_SIZE, (unsigned)TOTAL_BYTES);
+
+  failed = false;
+  bench("Channel", false);
+  bench("Zero-copy", true);
+
+  return failed ? 1 : 0;
+}
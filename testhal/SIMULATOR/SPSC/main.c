@@ -0,0 +1,250 @@
+/*
+    ChibiOS - Copyright (C) 2006..2018 Giovanni Di Sirio
+
+    Licensed under the Apache License, Version 2.0 (the "License");
+    you may not use this file except in compliance with the License.
+    You may obtain a copy of the License at
+
+        http://www.apache.org/licenses/LICENSE-2.0
+
+    Unless required by applicable law or agreed to in writing, software
+    distributed under the License is distributed on an "AS IS" BASIS,
+    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+    See the License for the specific language governing permissions and
+    limitations under the License.
+*/
+
+/*
+ * SPSC ring benchmark against input queues and pipes.
+ *
+ * Costs are in realtime counter ticks, nanoseconds on the simulator and
+ * clock cycles on ARMv7-M targets. The benchmark code only uses portable
+ * APIs, the output goes through printf().
+ */
+
+#include <stdio.h>
+
+#include "ch.h"
+#include "hal.h"
+
+/*===========================================================================*/
+/* Benchmark settings.                                                       */
+/*===========================================================================*/
+
+/* Buffers size.*/
+#define BUFFER_SIZE                 256U
+
+/* Bytes transferred by each run.*/
+#define TOTAL_BYTES                 200000U
+
+/* The producer emulates an interrupt handler receiving one byte at time,
+   the consumer reads blocks.*/
+#define BLOCK_SIZE                  64U
+
+/*===========================================================================*/
+/* Transports.                                                               */
+/*===========================================================================*/
+
+static uint8_t buffer[BUFFER_SIZE];
+
+static input_queue_t iq;
+static pipe_t pp;
+static spsc_ring_t ring;
+
+typedef struct {
+  const char        *name;
+  void              (*init)(void);
+  bool              (*put)(uint8_t b);
+  int               (*get)(void);
+  size_t            (*read)(uint8_t *bp, size_t n);
+} transport_t;
+
+static void iq_init(void) {
+
+  iqObjectInit(&iq, buffer, BUFFER_SIZE, NULL, NULL);
+}
+
+static bool iq_put(uint8_t b) {
+  msg_t msg;
+
+  /* Same as done by an interrupt handler.*/
+  osalSysLock();
+  msg = iqPutI(&iq, b);
+  osalOsRescheduleS();
+  osalSysUnlock();
+
+  return msg == MSG_OK;
+}
+
+static int iq_get(void) {
+  msg_t msg;
+
+  osalSysLock();
+  msg = iqGetI(&iq);
+  osalSysUnlock();
+
+  return (int)msg;
+}
+
+static size_t iq_read(uint8_t *bp, size_t n) {
+
+  return iqReadTimeout(&iq, bp, n, TIME_INFINITE);
+}
+
+static void pipe_init(void) {
+
+  chPipeObjectInit(&pp, buffer, BUFFER_SIZE);
+}
+
+static bool pipe_put(uint8_t b) {
+
+  /* Pipes cannot be used from interrupt handlers, a thread is assumed.*/
+  return chPipeWriteTimeout(&pp, &b, 1U, TIME_INFINITE) == 1U;
+}
+
+static int pipe_get(void) {
+  uint8_t b;
+
+  if (chPipeReadTimeout(&pp, &b, 1U, TIME_IMMEDIATE) == 0U) {
+    return -1;
+  }
+
+  return (int)b;
+}
+
+static size_t pipe_read(uint8_t *bp, size_t n) {
+
+  return chPipeReadTimeout(&pp, bp, n, TIME_INFINITE);
+}
+
+static void ring_init(void) {
+
+  spscObjectInit(&ring, buffer, 1U, BUFFER_SIZE);
+}
+
+static bool ring_put(uint8_t b) {
+
+  return spscPutX(&ring, b) == MSG_OK;
+}
+
+static int ring_get(void) {
+
+  return (int)spscGetX(&ring);
+}
+
+static size_t ring_read(uint8_t *bp, size_t n) {
+
+  return spscReadTimeout(&ring, bp, n, TIME_INFINITE);
+}
+
+static const transport_t transports[] = {
+  {"Input queue", iq_init,   iq_put,   iq_get,   iq_read},
+  {"Pipe",        pipe_init, pipe_put, pipe_get, pipe_read},
+  {"SPSC ring",   ring_init, ring_put, ring_get, ring_read}
+};
+
+/*===========================================================================*/
+/* Benchmarks.                                                               */
+/*===========================================================================*/
+
+static const transport_t *current;
+static volatile bool failed;
+
+/* Cost of a put and a get without contention or waiting.*/
+static rtcnt_t bench_ops(const transport_t *tp) {
+  rtcnt_t start;
+  uint32_t i;
+
+  tp->init();
+  start = chSysGetRealtimeCounterX();
+  for (i = 0U; i < TOTAL_BYTES; i++) {
+    if (!tp->put((uint8_t)i) || (tp->get() != (int)(uint8_t)i)) {
+      failed = true;
+      break;
+    }
+  }
+
+  return (chSysGetRealtimeCounterX() - start) / TOTAL_BYTES;
+}
+
+static THD_WORKING_AREA(waConsumer, 1024);
+static THD_FUNCTION(Consumer, arg) {
+  uint8_t block[BLOCK_SIZE];
+  uint32_t i, n = 0U;
+
+  (void)arg;
+
+  while (n < TOTAL_BYTES) {
+    if (current->read(block, BLOCK_SIZE) != BLOCK_SIZE) {
+      failed = true;
+      return;
+    }
+    for (i = 0U; i < BLOCK_SIZE; i++) {
+      if (block[i] != (uint8_t)(n + i)) {
+        failed = true;
+      }
+    }
+    n += BLOCK_SIZE;
+  }
+}
+
+/* Streaming from a producer writing single bytes to a higher priority
+   consumer reading blocks.*/
+static rtcnt_t bench_stream(const transport_t *tp) {
+  thread_t *ctp;
+  rtcnt_t start;
+  uint32_t i;
+
+  tp->init();
+  current = tp;
+  ctp = chThdCreateStatic(waConsumer, sizeof waConsumer, NORMALPRIO + 1,
+                          Consumer, NULL);
+
+  start = chSysGetRealtimeCounterX();
+  for (i = 0U; i < TOTAL_BYTES; i++) {
+    while (!tp->put((uint8_t)i)) {
+      chThdYield();
+    }
+  }
+  chThdWait(ctp);
+
+  return (chSysGetRealtimeCounterX() - start) / TOTAL_BYTES;
+}
+
+/*
+ * Application entry point.
+ */
+int main(void) {
+  unsigned i;
+
+  /*
+   * System initializations.
+   * - HAL initialization, this also initializes the configured device drivers
+   *   and performs the board-specific initializations.
+   * - Kernel initialization, the main() function becomes a thread and the
+   *   RTOS is active.
+   */
+  halInit();
+  chSysInit();
+
+  printf("SPSC ring benchmark, %u bytes buffers, %u bytes transferred\n",
+         BUFFER_SIZE, TOTAL_BYTES);
+  printf("Costs in realtime counter ticks per byte\n\n");
+  printf("%-12s %10s %10s\n", "", "put+get", "stream");
+
+  for (i = 0U; i < sizeof transports / sizeof transports[0]; i++) {
+    rtcnt_t ops, stream;
+
+    failed = false;
+    ops    = bench_ops(&transports[i]);
+    stream = bench_stream(&transports[i]);
+    if (failed) {
+      printf("%s: FAILED\n", transports[i].name);
+      return 1;
+    }
+    printf("%-12s %10u %10u\n", transports[i].name,
+           (unsigned)ops, (unsigned)stream);
+  }
+
+  return 0;
+}
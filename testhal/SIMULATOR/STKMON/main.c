@@ -0,0 +1,178 @@
+/*
+    ChibiOS - Copyright (C) 2006..2018 Giovanni Di Sirio
+
+    Licensed under the Apache License, Version 2.0 (the "License");
+    you may not use this file except in compliance with the License.
+    You may obtain a copy of the License at
+
+        http://www.apache.org/licenses/LICENSE-2.0
+
+    Unless required by applicable law or agreed to in writing, software
+    distributed under the License is distributed on an "AS IS" BASIS,
+    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+    See the License for the specific language governing permissions and
+    limitations under the License.
+*/
+
+/*
+ * Stack monitor demo, worker threads use known amounts of stack and the
+ * monitor has to find at least those amounts. A worker deepens its usage
+ * after the first report, the following passes must notice it.
+ */
+
+#include <stdio.h>
+
+#include "ch.h"
+#include "hal.h"
+
+#include "stkmon.h"
+
+/*===========================================================================*/
+/* Workers.                                                                  */
+/*===========================================================================*/
+
+#define WORKERS_NUM                 3U
+#define WORKER_STACK_SIZE           4096U
+
+static THD_WORKING_AREA(waWorker1, WORKER_STACK_SIZE);
+static THD_WORKING_AREA(waWorker2, WORKER_STACK_SIZE);
+static THD_WORKING_AREA(waWorker3, WORKER_STACK_SIZE);
+
+static struct {
+  const char        *name;
+  stkalign_t        *wa;
+  size_t            depth;
+  thread_t          *tp;
+} workers[WORKERS_NUM] = {
+  {"shallow", waWorker1, 256U,  NULL},
+  {"medium",  waWorker2, 1024U, NULL},
+  {"deep",    waWorker3, 2048U, NULL}
+};
+
+/* Touches "depth" bytes of stack.*/
+static uint8_t __attribute__((noinline)) use_stack(size_t depth) {
+  volatile uint8_t buf[depth];
+  size_t i;
+
+  for (i = 0U; i < depth; i++) {
+    buf[i] = (uint8_t)i;
+  }
+
+  return buf[0];
+}
+
+static THD_FUNCTION(Worker, arg) {
+  unsigned i = (unsigned)(uintptr_t)arg;
+
+  chRegSetThreadName(workers[i].name);
+
+  while (!chThdShouldTerminateX()) {
+    (void)use_stack(workers[i].depth);
+    chThdSleepMilliseconds(10);
+  }
+}
+
+/*===========================================================================*/
+/* Report.                                                                   */
+/*===========================================================================*/
+
+static void report(void) {
+  static stkmon_thread_t threads[STKMON_CFG_MAX_THREADS];
+  stkmon_stats_t stats;
+  unsigned i, n;
+
+  n = stkmonGetReport(threads, STKMON_CFG_MAX_THREADS);
+  stkmonGetStats(&stats);
+
+  printf("    size     used   margin name\n");
+  for (i = 0U; i < n; i++) {
+    printf("%8u %8u %8u %s\n",
+           (unsigned)threads[i].size, (unsigned)threads[i].used,
+           (unsigned)(threads[i].size - threads[i].used),
+           threads[i].name == NULL ? "" : threads[i].name);
+  }
+  printf("%u passes, %u bytes scanned, min margin %u (%s)\n\n",
+         (unsigned)stats.passes, (unsigned)stats.scanned,
+         (unsigned)stats.min_margin,
+         stats.min_name == NULL ? "" : stats.min_name);
+}
+
+static bool check(void) {
+  static stkmon_thread_t threads[STKMON_CFG_MAX_THREADS];
+  unsigned i, j, n;
+
+  n = stkmonGetReport(threads, STKMON_CFG_MAX_THREADS);
+  for (i = 0U; i < WORKERS_NUM; i++) {
+    for (j = 0U; j < n; j++) {
+      if (threads[j].tp == workers[i].tp) {
+        break;
+      }
+    }
+    if ((j == n) || (threads[j].used < workers[i].depth) ||
+        (threads[j].used > workers[i].depth + 1024U)) {
+      printf("wrong usage for %s\n", workers[i].name);
+      return true;
+    }
+  }
+
+  return false;
+}
+
+/*
+ * Application entry point.
+ */
+int main(void) {
+  uint32_t scanned;
+  stkmon_stats_t stats;
+  unsigned i;
+
+  /*
+   * System initializations.
+   * - HAL initialization, this also initializes the configured device drivers
+   *   and performs the board-specific initializations.
+   * - Kernel initialization, the main() function becomes a thread and the
+   *   RTOS is active.
+   */
+  halInit();
+  chSysInit();
+
+  for (i = 0U; i < WORKERS_NUM; i++) {
+    workers[i].tp = chThdCreateStatic(workers[i].wa,
+                                      THD_WORKING_AREA_SIZE(WORKER_STACK_SIZE),
+                                      NORMALPRIO + 1, Worker,
+                                      (void *)(uintptr_t)i);
+  }
+  stkmonStart();
+
+  printf("Stack monitor, %u bytes per critical zone, pass every %u ms\n\n",
+         (unsigned)STKMON_CFG_SCAN_CHUNK,
+         (unsigned)TIME_I2MS(STKMON_CFG_PERIOD));
+
+  chThdSleep(STKMON_CFG_PERIOD / 2U);
+  report();
+  if (check()) {
+    printf("FAILED\n");
+    return 1;
+  }
+
+  /* Following passes only examine the unused part of the stacks.*/
+  stkmonGetStats(&stats);
+  scanned = stats.scanned;
+  workers[0].depth = 3072U;
+  chThdSleep(STKMON_CFG_PERIOD);
+  report();
+  stkmonGetStats(&stats);
+  printf("%u bytes scanned by the last pass\n",
+         (unsigned)(stats.scanned - scanned));
+  if (check()) {
+    printf("FAILED\n");
+    return 1;
+  }
+
+  for (i = 0U; i < WORKERS_NUM; i++) {
+    chThdTerminate(workers[i].tp);
+    chThdWait(workers[i].tp);
+  }
+
+  return 0;
+}
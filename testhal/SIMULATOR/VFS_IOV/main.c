@@ -0,0 +1,303 @@
+/*
+    ChibiOS - Copyright (C) 2006..2018 Giovanni Di Sirio
+
+    Licensed under the Apache License, Version 2.0 (the "License");
+    you may not use this file except in compliance with the License.
+    You may obtain a copy of the License at
+
+        http://www.apache.org/licenses/LICENSE-2.0
+
+    Unless required by applicable law or agreed to in writing, software
+    distributed under the License is distributed on an "AS IS" BASIS,
+    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+    See the License for the specific language governing permissions and
+    limitations under the License.
+*/
+
+/*
+ * Scatter-gather records benchmark.
+ *
+ * Records made of a header and a payload are written to a stream exposed
+ * by the VFS streams driver. The stream is a shared sink taking a mutex on
+ * each call, as a log or console stream would do. Records are written
+ * with two calls, with stmWriteV() and with vfsWriteFileV(), the lock
+ * round-trips per record are counted.
+ * stmWriteV() is a loop over the stream write method, it is expected to
+ * perform like two calls. The streams driver gathers vectored transfers
+ * up to DRV_CFG_STREAMS_IOV_BUFFER_SIZE bytes into a single stream call,
+ * building with UDEFS="-DSIMULATOR -DDRV_CFG_STREAMS_IOV_BUFFER_SIZE=0"
+ * falls back to the generic implementation, gathering only runs of
+ * segments smaller than VFS_CFG_IOV_GATHER_SIZE.
+ */
+
+#include <stdio.h>
+#include <string.h>
+
+#include "ch.h"
+#include "hal.h"
+#include "vfs.h"
+#include "memstreams.h"
+
+/*===========================================================================*/
+/* Benchmark settings.                                                       */
+/*===========================================================================*/
+
+/* Records written by each run.*/
+#define RECORDS                     100000U
+
+/* Header size, the payload size is specified for each run.*/
+#define HEADER_SIZE                 8U
+
+/* Larger payload used by the runs.*/
+#define MAX_PAYLOAD_SIZE            256U
+
+/* Records written and read back for the scatter read check.*/
+#define CHECK_RECORDS               64U
+
+/*===========================================================================*/
+/* Shared sink stream.                                                       */
+/*===========================================================================*/
+
+typedef struct {
+  sequential_stream_i       stm;
+  mutex_t                   mtx;
+  uint32_t                  locks;
+  uint32_t                  sum;
+} sink_stream_c;
+
+static size_t sink_write(void *ip, const uint8_t *bp, size_t n) {
+  sink_stream_c *self = oopIfGetOwner(sink_stream_c, ip);
+  size_t i;
+
+  chMtxLock(&self->mtx);
+  self->locks++;
+  for (i = 0U; i < n; i++) {
+    self->sum += bp[i];
+  }
+  chMtxUnlock(&self->mtx);
+
+  return n;
+}
+
+static size_t sink_read(void *ip, uint8_t *bp, size_t n) {
+
+  (void)ip;
+  (void)bp;
+  (void)n;
+
+  return 0U;
+}
+
+static int sink_put(void *ip, uint8_t b) {
+
+  return sink_write(ip, &b, 1U) == 1U ? STM_OK : STM_RESET;
+}
+
+static int sink_get(void *ip) {
+
+  (void)ip;
+
+  return STM_RESET;
+}
+
+static int sink_unget(void *ip, int b) {
+
+  (void)ip;
+  (void)b;
+
+  return STM_RESET;
+}
+
+static const struct sequential_stream_vmt sink_vmt = {
+  .instance_offset      = offsetof(sink_stream_c, stm),
+  .write                = sink_write,
+  .read                 = sink_read,
+  .put                  = sink_put,
+  .get                  = sink_get,
+  .unget                = sink_unget
+};
+
+static sink_stream_c sink;
+
+/*===========================================================================*/
+/* VFS related.                                                              */
+/*===========================================================================*/
+
+/* VFS streams driver used as root.*/
+static vfs_streams_driver_c root_driver;
+
+/* VFS API will use this object as implicit root, defining this
+   symbol is expected.*/
+vfs_driver_c *vfs_root = (vfs_driver_c *)&root_driver;
+
+/* Memory stream used for the scatter read check.*/
+static MemoryStream memstream;
+static uint8_t membuf[CHECK_RECORDS * (HEADER_SIZE + MAX_PAYLOAD_SIZE)];
+
+static const drv_streams_element_t streams[] = {
+  {"sink", (sequential_stream_i *)&sink},
+  {"mem", (sequential_stream_i *)&memstream},
+  {NULL, NULL}
+};
+
+/*===========================================================================*/
+/* Benchmark.                                                                */
+/*===========================================================================*/
+
+static uint8_t header[HEADER_SIZE];
+static uint8_t payload[MAX_PAYLOAD_SIZE];
+
+static void make_record(uint32_t seq, size_t size) {
+  uint32_t len = (uint32_t)size;
+  size_t i;
+
+  memcpy(&header[0], &seq, sizeof (seq));
+  memcpy(&header[4], &len, sizeof (len));
+  for (i = 0U; i < size; i++) {
+    payload[i] = (uint8_t)(seq + i);
+  }
+}
+
+static bool write_calls(vfs_file_node_c *fnp, size_t size) {
+
+  return (vfsWriteFile(fnp, header, HEADER_SIZE) != (ssize_t)HEADER_SIZE) ||
+         (vfsWriteFile(fnp, payload, size) != (ssize_t)size);
+}
+
+static bool write_stmv(vfs_file_node_c *fnp, size_t size) {
+  stm_iovec_t iov[2] = {{header, HEADER_SIZE}, {payload, size}};
+
+  return stmWriteV(vfsGetFileStream(fnp), iov, 2U) != HEADER_SIZE + size;
+}
+
+static bool write_vfsv(vfs_file_node_c *fnp, size_t size) {
+  stm_iovec_t iov[2] = {{header, HEADER_SIZE}, {payload, size}};
+
+  return vfsWriteFileV(fnp, iov, 2U) != (ssize_t)(HEADER_SIZE + size);
+}
+
+typedef struct {
+  const char    *name;
+  bool          (*fn)(vfs_file_node_c *fnp, size_t size);
+} method_t;
+
+static const method_t methods[] = {
+  {"vfsWriteFile x2", write_calls},
+  {"stmWriteV", write_stmv},
+  {"vfsWriteFileV", write_vfsv},
+  {NULL, NULL}
+};
+
+static bool run(vfs_file_node_c *fnp, const method_t *mp, size_t size) {
+  rtcnt_t start, end;
+  uint32_t i;
+
+  sink.locks = 0U;
+  start = chSysGetRealtimeCounterX();
+  for (i = 0U; i < RECORDS; i++) {
+    make_record(i, size);
+    if (mp->fn(fnp, size)) {
+      printf("%-16s: FAILED\n", mp->name);
+      return true;
+    }
+  }
+  end = chSysGetRealtimeCounterX();
+
+  printf("%-16s %4u bytes: %6.2f locks/record, %6u RT counts/record\n",
+         mp->name, (unsigned)size, (double)sink.locks / (double)RECORDS,
+         (unsigned)((end - start) / RECORDS));
+  return false;
+}
+
+/* Records written with gather writes are read back with scatter reads.*/
+static bool check_readv(void) {
+  vfs_file_node_c *fnp;
+  uint8_t rdheader[HEADER_SIZE];
+  uint8_t rdpayload[MAX_PAYLOAD_SIZE];
+  stm_iovec_t iov[2] = {{rdheader, HEADER_SIZE}, {rdpayload, 0U}};
+  uint32_t i;
+
+  if (CH_RET_IS_ERROR(vfsOpenFile("/mem", VO_RDWR, &fnp))) {
+    return true;
+  }
+
+  for (i = 0U; i < CHECK_RECORDS; i++) {
+    size_t size = (i * 37U) % MAX_PAYLOAD_SIZE;
+    make_record(i, size);
+    if (write_vfsv(fnp, size)) {
+      vfsClose((vfs_node_c *)fnp);
+      return true;
+    }
+  }
+
+  for (i = 0U; i < CHECK_RECORDS; i++) {
+    size_t size = (i * 37U) % MAX_PAYLOAD_SIZE;
+    make_record(i, size);
+    iov[1].len = size;
+    if ((vfsReadFileV(fnp, iov, 2U) != (ssize_t)(HEADER_SIZE + size)) ||
+        (memcmp(rdheader, header, HEADER_SIZE) != 0) ||
+        (memcmp(rdpayload, payload, size) != 0)) {
+      vfsClose((vfs_node_c *)fnp);
+      return true;
+    }
+  }
+
+  vfsClose((vfs_node_c *)fnp);
+  return false;
+}
+
+/*
+ * Application entry point.
+ */
+int main(void) {
+  static const size_t sizes[] = {24U, MAX_PAYLOAD_SIZE};
+  vfs_file_node_c *fnp;
+  const method_t *mp;
+  unsigned i;
+
+  /*
+   * System initializations.
+   * - HAL initialization, this also initializes the configured device drivers
+   *   and performs the board-specific initializations.
+   * - Kernel initialization, the main() function becomes a thread and the
+   *   RTOS is active.
+   * - Virtual File System initialization.
+   */
+  halInit();
+  chSysInit();
+  vfsInit();
+
+  oopIfObjectInit(&sink.stm, &sink_vmt);
+  chMtxObjectInit(&sink.mtx);
+  msObjectInit(&memstream, membuf, sizeof membuf, 0U);
+  stmdrvObjectInit(&root_driver, &streams[0]);
+
+  printf("Scatter-gather benchmark, %u records per run, "
+         "%u bytes headers\n", (unsigned)RECORDS, (unsigned)HEADER_SIZE);
+  printf("Gathering buffers: %u bytes streams driver, %u bytes generic\n\n",
+         (unsigned)DRV_CFG_STREAMS_IOV_BUFFER_SIZE,
+         (unsigned)VFS_CFG_IOV_GATHER_SIZE);
+
+  if (check_readv()) {
+    printf("Scatter read check: FAILED\n");
+    return 1;
+  }
+  printf("Scatter read check: OK\n\n");
+
+  if (CH_RET_IS_ERROR(vfsOpenFile("/sink", VO_WRONLY, &fnp))) {
+    printf("Open failed\n");
+    return 1;
+  }
+
+  for (i = 0U; i < sizeof sizes / sizeof sizes[0]; i++) {
+    for (mp = methods; mp->name != NULL; mp++) {
+      if (run(fnp, mp, sizes[i])) {
+        return 1;
+      }
+    }
+  }
+
+  vfsClose((vfs_node_c *)fnp);
+
+  return 0;
+}
@@ -0,0 +1,183 @@
+/*
+    ChibiOS - Copyright (C) 2006..2018 Giovanni Di Sirio
+
+    Licensed under the Apache License, Version 2.0 (the "License");
+    you may not use this file except in compliance with the License.
+    You may obtain a copy of the License at
+
+        http://www.apache.org/licenses/LICENSE-2.0
+
+    Unless required by applicable law or agreed to in writing, software
+    distributed under the License is distributed on an "AS IS" BASIS,
+    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+    See the License for the specific language governing permissions and
+    limitations under the License.
+*/
+
+#include <stdio.h>
+#include <string.h>
+
+#include "ch.h"
+#include "hal.h"
+#include "vfs.h"
+#include "nullstreams.h"
+
+/*===========================================================================*/
+/* Benchmark settings.                                                       */
+/*===========================================================================*/
+
+#define MOUNTS_NUM                  DRV_CFG_OVERLAY_DRV_MAX
+#define ITERATIONS                  100000U
+
+/*===========================================================================*/
+/* VFS related.                                                              */
+/*===========================================================================*/
+
+/* VFS overlay driver object representing the root directory.*/
+static vfs_overlay_driver_c root_overlay_driver;
+
+/* VFS streams drivers mounted on the overlay.*/
+static vfs_streams_driver_c mount_drivers[MOUNTS_NUM];
+static char mount_names[MOUNTS_NUM][8];
+
+/* VFS API will use this object as implicit root, defining this
+   symbol is expected.*/
+vfs_driver_c *vfs_root = (vfs_driver_c *)&root_overlay_driver;
+
+static NullStream nullstream;
+
+/* Stream exposed as a file under each mount point.*/
+static const drv_streams_element_t streams[] = {
+  {"null", (sequential_stream_i *)&nullstream},
+  {NULL, NULL}
+};
+
+/*===========================================================================*/
+/* Workloads.                                                                */
+/*===========================================================================*/
+
+/* Paths used by the workloads, one per mount point.*/
+static char paths[MOUNTS_NUM][VFS_CFG_PATHLEN_MAX + 1];
+
+static void make_paths(const char *fmt) {
+  unsigned i;
+
+  for (i = 0U; i < MOUNTS_NUM; i++) {
+    (void) snprintf(paths[i], sizeof paths[i], fmt, mount_names[i],
+                    mount_names[i]);
+  }
+}
+
+static bool do_open(void) {
+  vfs_file_node_c *fnp;
+  uint32_t i;
+
+  for (i = 0U; i < ITERATIONS; i++) {
+    if (CH_RET_IS_ERROR(vfsOpenFile(paths[i % MOUNTS_NUM], VO_RDWR, &fnp))) {
+      return true;
+    }
+    vfsClose((vfs_node_c *)fnp);
+  }
+  return false;
+}
+
+static bool do_stat(void) {
+  vfs_stat_t st;
+  uint32_t i;
+
+  for (i = 0U; i < ITERATIONS; i++) {
+    if (CH_RET_IS_ERROR(vfsStat(paths[i % MOUNTS_NUM], &st)) ||
+        !VFS_MODE_S_ISDIR(st.mode)) {
+      return true;
+    }
+  }
+  return false;
+}
+
+typedef struct {
+  const char    *name;
+  const char    *fmt;
+  bool          (*fn)(void);
+} workload_t;
+
+static const workload_t workloads[] = {
+  {"open normalized", "/%s/null", do_open},
+  {"open relative", "%s/null", do_open},
+  {"open unnormalized", "//%s/./null", do_open},
+  {"stat normalized", "/%s", do_stat},
+  {"stat relative", "%s", do_stat},
+  {"stat unnormalized", "/%s/../%s", do_stat},
+  {NULL, NULL, NULL}
+};
+
+/*===========================================================================*/
+/* Benchmark.                                                                */
+/*===========================================================================*/
+
+static bool run(const workload_t *wlp) {
+  rtcnt_t start, end;
+
+  make_paths(wlp->fmt);
+
+  start = chSysGetRealtimeCounterX();
+  if (wlp->fn()) {
+    printf("%-18s: FAILED\n", wlp->name);
+    return true;
+  }
+  end = chSysGetRealtimeCounterX();
+
+  printf("%-18s: %8u RT counts, %6u RT counts per 1000 operations\n",
+         wlp->name,
+         (unsigned)(end - start),
+         (unsigned)(((uint64_t)(end - start) * 1000U) / ITERATIONS));
+  return false;
+}
+
+/*
+ * Application entry point.
+ */
+int main(void) {
+  const workload_t *wlp;
+  unsigned i;
+
+  /*
+   * System initializations.
+   * - HAL initialization, this also initializes the configured device drivers
+   *   and performs the board-specific initializations.
+   * - Kernel initialization, the main() function becomes a thread and the
+   *   RTOS is active.
+   * - Virtual File System initialization.
+   */
+  halInit();
+  chSysInit();
+  vfsInit();
+
+  /*
+   * Root overlay with a streams driver mounted on each mount point.
+   */
+  nullObjectInit(&nullstream);
+  ovldrvObjectInit(&root_overlay_driver, NULL, NULL);
+  for (i = 0U; i < MOUNTS_NUM; i++) {
+    (void) snprintf(mount_names[i], sizeof mount_names[i], "mnt%02u", i);
+    stmdrvObjectInit(&mount_drivers[i], &streams[0]);
+    if (CH_RET_IS_ERROR(ovldrvRegisterDriver(&root_overlay_driver,
+                                             (vfs_driver_c *)&mount_drivers[i],
+                                             mount_names[i]))) {
+      printf("Mount failed\n");
+      return 1;
+    }
+  }
+
+  printf("VFS overlay benchmark, %u mount points, %u operations per test\n",
+         (unsigned)MOUNTS_NUM, (unsigned)ITERATIONS);
+  printf("Path-resolution cache entries: %u\n\n",
+         (unsigned)DRV_CFG_OVERLAY_CACHE_SIZE);
+
+  for (wlp = workloads; wlp->name != NULL; wlp++) {
+    if (run(wlp)) {
+      return 1;
+    }
+  }
+
+  return 0;
+}
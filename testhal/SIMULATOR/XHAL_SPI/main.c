@@ -0,0 +1,370 @@
+/*
+    ChibiOS - Copyright (C) 2006..2018 Giovanni Di Sirio
+
+    Licensed under the Apache License, Version 2.0 (the "License");
+    you may not use this file except in compliance with the License.
+    You may obtain a copy of the License at
+
+        http://www.apache.org/licenses/LICENSE-2.0
+
+    Unless required by applicable law or agreed to in writing, software
+    distributed under the License is distributed on an "AS IS" BASIS,
+    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+    See the License for the specific language governing permissions and
+    limitations under the License.
+*/
+
+#include <stdio.h>
+#include <string.h>
+
+#include "ch.h"
+#include "hal.h"
+
+/*===========================================================================*/
+/* Benchmark settings.                                                       */
+/*===========================================================================*/
+
+/* Number of transactions performed by each client in each run.*/
+#if !defined(BENCH_TRANSACTIONS)
+#define BENCH_TRANSACTIONS          20000U
+#endif
+
+/* Each transaction is a command phase followed by a data phase.*/
+#define CMD_SIZE                    4U
+#define DATA_SIZE                   16U
+
+/*
+ * Simulated 20MHz bus, the setup time accounts for the per-transfer
+ * overhead (DMA programming and completion interrupt) of a real peripheral.
+ */
+#define SPI_BITRATE                 20000000U
+#define SPI_SETUP_NS                1000U
+
+/* Number of clients sharing the bus.*/
+#define NUM_CLIENTS                 3U
+
+/*===========================================================================*/
+/* Loopback devices.                                                         */
+/*===========================================================================*/
+
+/*
+ * Each device echoes the frames it receives, frames exchanged while the
+ * device is not selected and overlapping selections are counted as errors.
+ */
+typedef struct {
+  bool                      selected;
+  uint32_t                  errors;
+} loopdev_t;
+
+static loopdev_t devs[NUM_CLIENTS];
+static unsigned nselected;
+
+static void dev_select(void *arg, bool selected) {
+  loopdev_t *dp = (loopdev_t *)arg;
+
+  if (selected == dp->selected) {
+    dp->errors++;
+  }
+  dp->selected = selected;
+  if (selected) {
+    if (nselected++ != 0U) {
+      dp->errors++;
+    }
+  }
+  else {
+    nselected--;
+  }
+}
+
+static uint8_t dev_exchange(void *arg, uint8_t frame) {
+  loopdev_t *dp = (loopdev_t *)arg;
+
+  if (!dp->selected) {
+    dp->errors++;
+  }
+
+  return frame;
+}
+
+static const SimSPIDevice simdevs[NUM_CLIENTS] = {
+  {dev_select, dev_exchange, &devs[0]},
+  {dev_select, dev_exchange, &devs[1]},
+  {dev_select, dev_exchange, &devs[2]}
+};
+
+/* One configuration for each device, timings are set by each run.*/
+static hal_spi_config_t spicfgs[NUM_CLIENTS] = {
+  {.device = &simdevs[0]},
+  {.device = &simdevs[1]},
+  {.device = &simdevs[2]}
+};
+
+static void set_bus_model(uint32_t bitrate, uint32_t setup) {
+  unsigned i;
+
+  for (i = 0U; i < NUM_CLIENTS; i++) {
+    spicfgs[i].bitrate    = bitrate;
+    spicfgs[i].setup_time = setup;
+  }
+}
+
+static bool devs_check(void) {
+  unsigned i;
+
+  for (i = 0U; i < NUM_CLIENTS; i++) {
+    if ((devs[i].errors != 0U) || devs[i].selected) {
+      return true;
+    }
+  }
+  return false;
+}
+
+/*===========================================================================*/
+/* Clients.                                                                  */
+/*===========================================================================*/
+
+/*
+ * A client owns a device and performs BENCH_TRANSACTIONS transactions on
+ * it, either as synchronous transfers or as a queued transaction.
+ */
+typedef struct {
+  unsigned                  id;
+  bool                      queued;
+  bool                      failed;
+  uint8_t                   cmd[CMD_SIZE];
+  uint8_t                   txdata[DATA_SIZE];
+  uint8_t                   rxcmd[CMD_SIZE];
+  uint8_t                   rxdata[DATA_SIZE];
+  hal_spi_transfer_t        xfers[2];
+  hal_spi_transaction_t     transaction;
+} client_t;
+
+static client_t clients[NUM_CLIENTS];
+static MUTEX_DECL(bus_mtx);
+
+static void client_init(client_t *cp, unsigned id, bool queued) {
+  unsigned i;
+
+  cp->id     = id;
+  cp->queued = queued;
+  cp->failed = false;
+  for (i = 0U; i < CMD_SIZE; i++) {
+    cp->cmd[i] = (uint8_t)(0xC0U + (id * 16U) + i);
+  }
+  for (i = 0U; i < DATA_SIZE; i++) {
+    cp->txdata[i] = (uint8_t)((id * 64U) + i);
+  }
+
+  /* Prebuilt descriptors, the device is selected by the configuration.*/
+  cp->xfers[0].next   = &cp->xfers[1];
+  cp->xfers[0].config = &spicfgs[id];
+  cp->xfers[0].flags  = SPI_XFER_SELECT;
+  cp->xfers[0].n      = CMD_SIZE;
+  cp->xfers[0].txbuf  = cp->cmd;
+  cp->xfers[0].rxbuf  = cp->rxcmd;
+  cp->xfers[0].cb     = NULL;
+  cp->xfers[1].next   = NULL;
+  cp->xfers[1].config = NULL;
+  cp->xfers[1].flags  = SPI_XFER_UNSELECT;
+  cp->xfers[1].n      = DATA_SIZE;
+  cp->xfers[1].txbuf  = cp->txdata;
+  cp->xfers[1].rxbuf  = cp->rxdata;
+  cp->xfers[1].cb     = NULL;
+  spiTransactionObjectInit(&cp->transaction, &cp->xfers[0],
+                           (uint32_t)(NUM_CLIENTS - id), cp);
+}
+
+static bool client_transaction(client_t *cp) {
+  msg_t msg;
+
+  memset(cp->rxcmd, 0, CMD_SIZE);
+  memset(cp->rxdata, 0, DATA_SIZE);
+
+  if (cp->queued) {
+    msg = spiQueueExecute(&SPID1, &cp->transaction);
+  }
+  else {
+    chMtxLock(&bus_mtx);
+    msg = drvConfigureX(&SPID1, &spicfgs[cp->id]);
+    if (msg == MSG_OK) {
+      spiSelectX(&SPID1);
+      msg = spiExchange(&SPID1, CMD_SIZE, cp->cmd, cp->rxcmd);
+      if (msg == MSG_OK) {
+        msg = spiExchange(&SPID1, DATA_SIZE, cp->txdata, cp->rxdata);
+      }
+      spiUnselectX(&SPID1);
+    }
+    chMtxUnlock(&bus_mtx);
+  }
+
+  return (msg != MSG_OK) ||
+         (memcmp(cp->rxcmd, cp->cmd, CMD_SIZE) != 0) ||
+         (memcmp(cp->rxdata, cp->txdata, DATA_SIZE) != 0);
+}
+
+static THD_WORKING_AREA(waClients[NUM_CLIENTS], 1024);
+
+static THD_FUNCTION(ClientThread, arg) {
+  client_t *cp = (client_t *)arg;
+  uint32_t k;
+
+  for (k = 0U; k < BENCH_TRANSACTIONS; k++) {
+    if (client_transaction(cp)) {
+      cp->failed = true;
+      break;
+    }
+  }
+}
+
+/*===========================================================================*/
+/* Benchmark.                                                                */
+/*===========================================================================*/
+
+static bool do_run(const char *name, unsigned nclients, bool queued) {
+  thread_t *tps[NUM_CLIENTS];
+  uint32_t transfers, total;
+  ucnt_t ctxswc;
+  uint64_t tps_rate;
+  rtcnt_t start, counts;
+  unsigned i;
+  bool failed = false;
+
+  for (i = 0U; i < nclients; i++) {
+    client_init(&clients[i], i, queued);
+  }
+
+  transfers = SPID1.transfers;
+  ctxswc    = ch0.kernel_stats.n_ctxswc;
+  start = chSysGetRealtimeCounterX();
+  for (i = 0U; i < nclients; i++) {
+    tps[i] = chThdCreateStatic(waClients[i], sizeof (waClients[i]),
+                               NORMALPRIO + 1 + (tprio_t)(NUM_CLIENTS - i),
+                               ClientThread, &clients[i]);
+  }
+  for (i = 0U; i < nclients; i++) {
+    chThdWait(tps[i]);
+    failed = failed || clients[i].failed;
+  }
+  counts = chSysGetRealtimeCounterX() - start;
+  ctxswc = ch0.kernel_stats.n_ctxswc - ctxswc;
+
+  if (failed || devs_check()) {
+    printf("%-24s: FAILED\n", name);
+    return true;
+  }
+
+  total    = (uint32_t)nclients * BENCH_TRANSACTIONS;
+  tps_rate = ((uint64_t)total * (uint64_t)PORT_SIM_RT_FREQUENCY) /
+             (uint64_t)counts;
+  printf("%-24s: %9u transactions/s, %4.2f transfers and "
+         "%4.2f context switches per transaction\n",
+         name, (unsigned)tps_rate,
+         (double)(SPID1.transfers - transfers) / (double)total,
+         (double)ctxswc / (double)total);
+
+  return false;
+}
+
+/*
+ * Priority check, with the bus busy on a low priority transaction more
+ * low priority transactions are queued then a high priority one, the
+ * high priority transaction must be the first served after the active one.
+ */
+#define ORDER_TRANSACTIONS          5U
+
+static unsigned order[ORDER_TRANSACTIONS];
+static unsigned norder;
+
+static void order_cb(void *ip, hal_spi_transaction_t *tp) {
+
+  (void)ip;
+
+  order[norder++] = ((client_t *)tp->arg)->id;
+}
+
+static bool do_order(void) {
+  static client_t ocs[ORDER_TRANSACTIONS];
+  static const unsigned expected[ORDER_TRANSACTIONS] = {0U, 4U, 1U, 2U, 3U};
+  unsigned i;
+  msg_t msg;
+
+  norder = 0U;
+  for (i = 0U; i < ORDER_TRANSACTIONS; i++) {
+    client_init(&ocs[i], i % NUM_CLIENTS, true);
+    ocs[i].id = i;
+    ocs[i].xfers[1].cb = order_cb;
+    ocs[i].transaction.prio = i < ORDER_TRANSACTIONS - 1U ? 1U : 2U;
+  }
+
+  chSysLock();
+  for (i = 0U; i < ORDER_TRANSACTIONS; i++) {
+    spiQueueSubmitI(&SPID1, &ocs[i].transaction);
+  }
+  msg = MSG_OK;
+  for (i = 0U; i < ORDER_TRANSACTIONS; i++) {
+    if (spiQueueWaitS(&SPID1, &ocs[i].transaction) != MSG_OK) {
+      msg = MSG_RESET;
+    }
+  }
+  chSysUnlock();
+
+  if ((msg != MSG_OK) || (norder != ORDER_TRANSACTIONS) ||
+      (memcmp(order, expected, sizeof (order)) != 0) || devs_check()) {
+    printf("Priority ordering       : FAILED\n");
+    return true;
+  }
+  printf("Priority ordering       : OK\n");
+
+  return false;
+}
+
+static bool do_bench(const char *name, uint32_t bitrate, uint32_t setup) {
+
+  printf("%s\n", name);
+  set_bus_model(bitrate, setup);
+  if (do_run("1 client, synchronous", 1U, false) ||
+      do_run("1 client, queued", 1U, true) ||
+      do_run("3 clients, synchronous", NUM_CLIENTS, false) ||
+      do_run("3 clients, queued", NUM_CLIENTS, true) ||
+      do_order()) {
+    return true;
+  }
+  printf("\n");
+
+  return false;
+}
+
+/*
+ * Application entry point.
+ */
+int main(void) {
+
+  /*
+   * System initializations.
+   * - HAL initialization, this also initializes the configured device drivers
+   *   and performs the board-specific initializations.
+   * - Kernel initialization, the main() function becomes a thread and the
+   *   RTOS is active.
+   */
+  halInit();
+  chSysInit();
+
+  printf("SPI transactions benchmark, %u transactions per client\n",
+         (unsigned)BENCH_TRANSACTIONS);
+  printf("Transaction: %u bytes command, %u bytes data\n\n",
+         (unsigned)CMD_SIZE, (unsigned)DATA_SIZE);
+
+  if (drvStart(&SPID1) != HAL_RET_SUCCESS) {
+    printf("SPI start failed\n");
+    return 1;
+  }
+
+  if (do_bench("Bus model: none (CPU only)", 0U, 0U)) {
+    return 1;
+  }
+  if (do_bench("Bus model: 20 MHz", SPI_BITRATE, SPI_SETUP_NS)) {
+    return 1;
+  }
+
+  return 0;
+}
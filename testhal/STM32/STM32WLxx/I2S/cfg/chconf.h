@@ -456,6 +456,17 @@
 #define CH_CFG_USE_PIPES                    TRUE
 #endif
 
+/**
+ * @brief   Message queues APIs.
+ * @details If enabled then the message queues APIs are included
+ *          in the kernel.
+ *
+ * @note    The default is @p TRUE.
+ */
+#if !defined(CH_CFG_USE_MSG_QUEUES)
+#define CH_CFG_USE_MSG_QUEUES               TRUE
+#endif
+
 /**
  * @brief   Objects Caches APIs.
  * @details If enabled then the objects caches APIs are included
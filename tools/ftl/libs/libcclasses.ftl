@@ -190,6 +190,14 @@
   [#return classtype]
 [/#function]
 
+[#--
+  -- Returns true if the class is declared final from an XML node.
+  --]
+[#function IsClassFinal node=[]]
+  [#local class = node]
+  [#return (class.@final[0]!"false")?trim == "true"]
+[/#function]
+
 [#--
   -- Returns the method short name from an XML node.
   --]
@@ -366,6 +374,20 @@
   [#return "NULL"]
 [/#function]
 
+[#--
+  -- Returns the name of the statically bound wrapper of a virtual method in
+  -- a final class. Methods with reserved names become "__<namespace>_<short>",
+  -- the others "<namespace><Short>".
+  --]
+[#function GetMethodFinalName method=[] namespace="no-namespace"]
+  [#local methodname  = GetNodeName(method)
+          methodsname = GetMethodShortName(method)]
+  [#if methodname?starts_with("__")]
+    [#return "__" + namespace + "_" + methodsname]
+  [/#if]
+  [#return namespace + methodsname?cap_first]
+[/#function]
+
 [#--
   -- Returns the class in the sequence of ancestors owning the specified
   -- virtual method. Fails if the method is not defined anywere in the
@@ -832,6 +854,57 @@ CC_FORCE_INLINE
                          namespace = classnamespace /]
 [/#macro]
 
+[#--
+  -- This macro generates, for final classes, statically bound inline
+  -- wrappers of all the virtual methods from an XML node. The wrappers call
+  -- the nearest implementation directly, the VMT is not used and the calls
+  -- can be inlined, the VMT path remains available for polymorphic use.
+  -- The dispose method is excluded, it is only reachable through the
+  -- object life cycle.
+  --]
+[#macro GenerateClassFinalMethods node=[]]
+  [#local class = node]
+  [#local classnamespace = GetNodeNamespace(class)
+          classtype      = GetClassType(class)
+          classctype     = GetClassCType(class) /]
+  [#if (classtype == "regular") && IsClassFinal(class)]
+    [#assign generated = true]
+    [#local classes = GetClassAncestorsSequence(class) + [class]]
+/**
+[@doxygen.EmitTagVerbatim "" "name" "Statically bound methods of " + classctype /]
+ * @{
+ */
+    [#list GetClassVirtualMethodsSequence(class) as method]
+      [#if GetMethodShortName(method) != "dispose"]
+        [#local methodretctype = GetMethodCType(method)
+                methodimpl     = GetMethodNearestImplementation(classes, method) /]
+[@doxygen.EmitFullCommentFromNode indent="" node=method
+                                  extraname="self" extradir="both"
+                                  extratext="Pointer to a @p " + classctype + " instance."
+                                  memberof=classctype /]
+CC_FORCE_INLINE
+[@ccode.GeneratePrototypeFromNode name      = GetMethodFinalName(method, classnamespace)
+                                  modifiers = ["static", "inline"]
+                                  params    = [classctype + " *self"]
+                                  node      = method /] {
+
+        [#local callparams = ccode.MakeCallParamsSequence(["self"] method)]
+        [#if methodretctype == "void"]
+[@ccode.GenerateFunctionCall ccode.indentation "" methodimpl callparams /]
+        [#else]
+[@ccode.GenerateFunctionCall ccode.indentation "return " methodimpl callparams /]
+        [/#if]
+}
+        [#if method?has_next]
+
+        [/#if]
+      [/#if]
+    [/#list]
+/** @} */
+
+  [/#if]
+[/#macro]
+
 [#--
   -- Generates extern prototypes for constructor, destructor, overidden
   -- virtual methods, virtual methods and regular methods.
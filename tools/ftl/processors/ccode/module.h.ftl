@@ -133,6 +133,7 @@ extern "C" {
   [#list module.public.types.class as class]
 [@cclasses.GenerateClassPublicConstructor class /]
 [@cclasses.GenerateClassVirtualMethods node=class /]
+[@cclasses.GenerateClassFinalMethods node=class /]
 [@cclasses.GenerateClassInlineMethods node=class /]
   [/#list]
   [#if module_condition?length > 0]